@@ -233,6 +233,30 @@ public:
         m_bit_count -= count;
     }
 
+    /// Reads as many whole bytes from the underlying stream as fit into the bit buffer. Unlike peek_bits(), this
+    /// does not fail at the end of the stream, so that buffered_bit_count() tells how many bits are left.
+    ErrorOr<void> fill_bit_buffer()
+    {
+        while (m_bit_count + bits_per_byte <= bit_buffer_size && !m_stream->is_eof()) {
+            size_t bytes_to_read = (bit_buffer_size - m_bit_count) / bits_per_byte;
+
+            BufferType buffer = 0;
+            auto bytes = TRY(m_stream->read_some({ &buffer, bytes_to_read }));
+            if (bytes.is_empty())
+                break;
+
+            m_bit_buffer |= (buffer << m_bit_count);
+            m_bit_count += bytes.size() * bits_per_byte;
+        }
+
+        return {};
+    }
+
+    /// Gives direct access to the bit buffer, for decoders that check buffered_bit_count() themselves.
+    /// Bits beyond buffered_bit_count() are zero.
+    ALWAYS_INLINE BufferType buffered_bits() const { return m_bit_buffer; }
+    ALWAYS_INLINE size_t buffered_bit_count() const { return m_bit_count; }
+
     /// Discards any sub-byte stream positioning the input stream may be keeping track of.
     /// Non-bitwise reads will implicitly call this.
     u8 align_to_byte_boundary()
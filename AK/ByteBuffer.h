@@ -41,7 +41,7 @@ public:
     ByteBuffer& operator=(ByteBuffer&& other)
     {
         if (this != &other) {
-            if (!m_inline)
+            if (!m_inline && !m_external)
                 kfree_sized(m_outline_buffer, m_outline_capacity);
             move_from(move(other));
         }
@@ -77,6 +77,18 @@ public:
         return { move(buffer) };
     }
 
+    // Wraps memory that is owned by someone else and has to outlive the buffer. The buffer never reallocates or frees
+    // it, so it can't grow past the size of the storage.
+    [[nodiscard]] static ByteBuffer create_with_external_storage(Bytes storage)
+    {
+        ByteBuffer buffer;
+        buffer.m_outline_buffer = storage.data();
+        buffer.m_outline_capacity = storage.size();
+        buffer.m_inline = false;
+        buffer.m_external = true;
+        return buffer;
+    }
+
     [[nodiscard]] static ErrorOr<ByteBuffer> copy(void const* data, size_t size)
     {
         auto buffer = TRY(create_uninitialized(size));
@@ -172,8 +184,10 @@ public:
     void clear()
     {
         if (!m_inline) {
-            kfree_sized(m_outline_buffer, m_outline_capacity);
+            if (!m_external)
+                kfree_sized(m_outline_buffer, m_outline_capacity);
             m_inline = true;
+            m_external = false;
         }
         m_size = 0;
     }
@@ -191,7 +205,7 @@ public:
     void trim(size_t size, bool may_discard_existing_data)
     {
         VERIFY(size <= m_size);
-        if (!m_inline && size <= inline_capacity)
+        if (!m_inline && !m_external && size <= inline_capacity)
             shrink_into_inline_buffer(size, may_discard_existing_data);
         m_size = size;
     }
@@ -304,6 +318,7 @@ private:
     {
         m_size = other.m_size;
         m_inline = other.m_inline;
+        m_external = other.m_external;
         if (!other.m_inline) {
             m_outline_buffer = other.m_outline_buffer;
             m_outline_capacity = other.m_outline_capacity;
@@ -313,6 +328,7 @@ private:
         }
         other.m_size = 0;
         other.m_inline = true;
+        other.m_external = false;
     }
 
     NEVER_INLINE void shrink_into_inline_buffer(size_t size, bool may_discard_existing_data)
@@ -328,6 +344,9 @@ private:
 
     NEVER_INLINE ErrorOr<void> try_ensure_capacity_slowpath(size_t new_capacity)
     {
+        if (m_external)
+            return Error::from_errno(ENOMEM);
+
         // When we are asked to raise the capacity by very small amounts,
         // the caller is perhaps appending very little data in many calls.
         // To avoid copying the entire ByteBuffer every single time,
@@ -361,6 +380,7 @@ private:
     };
     size_t m_size { 0 };
     bool m_inline { true };
+    bool m_external { false };
 };
 
 }
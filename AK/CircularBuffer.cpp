@@ -352,17 +352,24 @@ Optional<SearchableCircularBuffer::Match> SearchableCircularBuffer::find_copy_in
 
         if (maybe_starting_offset.has_value()) {
             Optional<size_t> previous_buffer_offset;
+            size_t previous_search_offset = 0;
             auto current_buffer_offset = maybe_starting_offset.value();
 
             while (true) {
                 auto current_search_offset = (capacity() + m_reading_head - current_buffer_offset) % capacity();
 
+                // Locations that are no longer in the searchable area have been overwritten since they were hashed, and so
+                // has everything older. The same goes for locations that aren't further away than the previous one, since
+                // they have been overwritten and hashed again, and now loop back to the start of the chain.
+                bool const is_stale_location = current_search_offset < HASH_CHUNK_SIZE || current_search_offset > search_limit() || current_search_offset <= previous_search_offset;
+
                 // Validate the hash. In case it is invalid, we can discard the rest of the chain, as the data (and everything older) got updated.
                 Array<u8, HASH_CHUNK_SIZE> hash_chunk_at_offset;
-                auto hash_chunk_at_offset_span = MUST(read_with_seekback(hash_chunk_at_offset, current_search_offset + used_space()));
-                VERIFY(hash_chunk_at_offset_span.size() == HASH_CHUNK_SIZE);
-                auto found_chunk_hash = StringView { hash_chunk_at_offset }.hash();
-                if (needle_hash != found_chunk_hash) {
+                if (!is_stale_location) {
+                    auto hash_chunk_at_offset_span = MUST(read_with_seekback(hash_chunk_at_offset, current_search_offset + used_space()));
+                    VERIFY(hash_chunk_at_offset_span.size() == HASH_CHUNK_SIZE);
+                }
+                if (is_stale_location || needle_hash != StringView { hash_chunk_at_offset }.hash()) {
                     if (!previous_buffer_offset.has_value())
                         m_hash_location_map.remove(needle_hash);
                     else
@@ -395,6 +402,7 @@ Optional<SearchableCircularBuffer::Match> SearchableCircularBuffer::find_copy_in
                     break;
 
                 previous_buffer_offset = current_buffer_offset;
+                previous_search_offset = current_search_offset;
                 current_buffer_offset = maybe_next_buffer_offset.release_value();
             }
 
@@ -548,7 +556,8 @@ ErrorOr<void> SearchableCircularBuffer::hash_last_bytes(size_t count)
 
         // If the span is smaller than a hash chunk, we need to manually craft some consecutive data to do the hashing.
         if (recalculation_span.size() < HASH_CHUNK_SIZE) {
-            auto auxiliary_span = next_seekback_span(remaining_recalculations);
+            // The data continues at the start of the buffer, up to the read head.
+            auto auxiliary_span = m_buffer.span().trim(m_reading_head);
 
             // Ensure that our math is correct and that both spans are "adjacent".
             VERIFY(recalculation_span.data() + recalculation_span.size() == m_buffer.data() + m_buffer.size());
@@ -560,7 +569,7 @@ ErrorOr<void> SearchableCircularBuffer::hash_last_bytes(size_t count)
                 auto copied_from_recalculation_span = recalculation_span.copy_to(temporary_hash_chunk);
                 VERIFY(copied_from_recalculation_span == recalculation_span.size());
 
-                auto copied_from_auxiliary_span = auxiliary_span.copy_to(temporary_hash_chunk.span().slice(copied_from_recalculation_span));
+                auto copied_from_auxiliary_span = auxiliary_span.copy_trimmed_to(temporary_hash_chunk.span().slice(copied_from_recalculation_span));
                 VERIFY(copied_from_recalculation_span + copied_from_auxiliary_span == HASH_CHUNK_SIZE);
 
                 TRY(insert_location_hash(temporary_hash_chunk, recalculation_span.data() - m_buffer.data()));
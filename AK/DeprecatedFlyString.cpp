@@ -24,6 +24,23 @@ struct DeprecatedFlyStringImplTraits : public Traits<StringImpl const*> {
 
 static Singleton<HashTable<StringImpl const*, DeprecatedFlyStringImplTraits>> s_table;
 
+// The table is shared by all threads, so that the same string interned on any of them compares equal.
+static Atomic<bool> s_table_lock { false };
+
+class FlyImplsLocker {
+public:
+    FlyImplsLocker()
+    {
+        while (s_table_lock.exchange(true, AK::memory_order_acquire))
+            sched_yield();
+    }
+
+    ~FlyImplsLocker()
+    {
+        s_table_lock.store(false, AK::memory_order_release);
+    }
+};
+
 static HashTable<StringImpl const*, DeprecatedFlyStringImplTraits>& fly_impls()
 {
     return *s_table;
@@ -31,7 +48,24 @@ static HashTable<StringImpl const*, DeprecatedFlyStringImplTraits>& fly_impls()
 
 void DeprecatedFlyString::did_destroy_impl(Badge<StringImpl>, StringImpl& impl)
 {
-    fly_impls().remove(&impl);
+    FlyImplsLocker locker;
+
+    // NOTE: Another thread may have interned an equal string while this impl was being destroyed, in which case the entry is no longer ours.
+    auto it = fly_impls().find(&impl);
+    if (it != fly_impls().end() && *it == &impl)
+        fly_impls().remove(it);
+}
+
+// Returns a new reference to the impl the table holds for the string, unless there is none or it is being destroyed.
+template<typename Iterator>
+static RefPtr<StringImpl const> ref_fly_impl(Iterator it)
+{
+    if (it == fly_impls().end())
+        return nullptr;
+    VERIFY((*it)->is_fly());
+    if (!(*it)->try_ref())
+        return nullptr;
+    return adopt_ref(**it);
 }
 
 DeprecatedFlyString::DeprecatedFlyString(ByteString const& string)
@@ -40,15 +74,13 @@ DeprecatedFlyString::DeprecatedFlyString(ByteString const& string)
     if (string.impl()->is_fly())
         return;
 
-    auto it = fly_impls().find(string.impl());
-    if (it == fly_impls().end()) {
-        fly_impls().set(string.impl());
-        string.impl()->set_fly({}, true);
-        m_impl = string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = **it;
+    FlyImplsLocker locker;
+    if (auto impl = ref_fly_impl(fly_impls().find(string.impl()))) {
+        m_impl = impl.release_nonnull();
+        return;
     }
+    fly_impls().set(string.impl());
+    string.impl()->set_fly({}, true);
 }
 
 DeprecatedFlyString::DeprecatedFlyString(StringView string)
@@ -56,18 +88,16 @@ DeprecatedFlyString::DeprecatedFlyString(StringView string)
 {
     if (string.is_null())
         return;
-    auto it = fly_impls().find(string.hash(), [&](auto& candidate) {
-        return string == *candidate;
-    });
-    if (it == fly_impls().end()) {
-        auto new_string = string.to_byte_string();
-        fly_impls().set(new_string.impl());
-        new_string.impl()->set_fly({}, true);
-        m_impl = new_string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = **it;
+
+    FlyImplsLocker locker;
+    if (auto impl = ref_fly_impl(fly_impls().find(string.hash(), [&](auto& candidate) { return string == *candidate; }))) {
+        m_impl = impl.release_nonnull();
+        return;
     }
+    auto new_string = string.to_byte_string();
+    fly_impls().set(new_string.impl());
+    new_string.impl()->set_fly({}, true);
+    m_impl = new_string.impl();
 }
 
 bool DeprecatedFlyString::equals_ignoring_ascii_case(StringView other) const
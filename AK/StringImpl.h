@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/AtomicRefCounted.h>
 #include <AK/Badge.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
@@ -22,7 +23,7 @@ enum ShouldChomp {
 
 size_t allocation_size_for_stringimpl(size_t length);
 
-class StringImpl : public RefCounted<StringImpl> {
+class StringImpl : public AtomicRefCounted<StringImpl> {
 public:
     static NonnullRefPtr<StringImpl const> create_uninitialized(size_t length, char*& buffer);
     static RefPtr<StringImpl const> create(char const* cstring, ShouldChomp = NoChomp);
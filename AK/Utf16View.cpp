@@ -5,7 +5,6 @@
  */
 
 #include <AK/CharacterTypes.h>
-#include <AK/Concepts.h>
 #include <AK/StringBuilder.h>
 #include <AK/StringView.h>
 #include <AK/Utf16View.h>
@@ -21,31 +20,49 @@ static constexpr u16 low_surrogate_max = 0xdfff;
 static constexpr u32 replacement_code_point = 0xfffd;
 static constexpr u32 first_supplementary_plane_code_point = 0x10000;
 
-template<OneOf<Utf8View, Utf32View> UtfViewType>
-static ErrorOr<Utf16Data> to_utf16_impl(UtfViewType const& view)
-{
-    Utf16Data utf16_data;
-    TRY(utf16_data.try_ensure_capacity(view.length()));
-
-    for (auto code_point : view)
-        TRY(code_point_to_utf16(utf16_data, code_point));
-
-    return utf16_data;
-}
-
 ErrorOr<Utf16Data> utf8_to_utf16(StringView utf8_view)
 {
-    return to_utf16_impl(Utf8View { utf8_view });
+    return utf8_to_utf16(Utf8View { utf8_view });
 }
 
 ErrorOr<Utf16Data> utf8_to_utf16(Utf8View const& utf8_view)
 {
-    return to_utf16_impl(utf8_view);
+    Utf16Data utf16_data;
+    TRY(utf16_data.try_ensure_capacity(utf8_view.length()));
+
+    for (size_t byte_offset = 0; byte_offset < utf8_view.byte_length();) {
+        // OPTIMIZATION: Widen runs of ASCII characters in bulk, and only decode the remaining code points one at a time.
+        if (auto ascii_length = utf8_view.length_of_ascii_run(byte_offset); ascii_length > 0) {
+            auto const* ascii_bytes = utf8_view.bytes() + byte_offset;
+            auto old_size = utf16_data.size();
+            TRY(utf16_data.try_resize_and_keep_capacity(old_size + ascii_length));
+
+            auto* code_units = utf16_data.data() + old_size;
+            for (size_t i = 0; i < ascii_length; ++i)
+                code_units[i] = ascii_bytes[i];
+
+            byte_offset += ascii_length;
+            if (byte_offset == utf8_view.byte_length())
+                break;
+        }
+
+        auto iterator = utf8_view.iterator_at_byte_offset_without_validation(byte_offset);
+        TRY(code_point_to_utf16(utf16_data, *iterator));
+        byte_offset += iterator.underlying_code_point_length_in_bytes();
+    }
+
+    return utf16_data;
 }
 
 ErrorOr<Utf16Data> utf32_to_utf16(Utf32View const& utf32_view)
 {
-    return to_utf16_impl(utf32_view);
+    Utf16Data utf16_data;
+    TRY(utf16_data.try_ensure_capacity(utf32_view.length()));
+
+    for (auto code_point : utf32_view)
+        TRY(code_point_to_utf16(utf16_data, code_point));
+
+    return utf16_data;
 }
 
 ErrorOr<void> code_point_to_utf16(Utf16Data& string, u32 code_point)
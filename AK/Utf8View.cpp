@@ -6,12 +6,46 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/BitCast.h>
 #include <AK/Debug.h>
 #include <AK/Format.h>
+#include <AK/SIMD.h>
 #include <AK/Utf8View.h>
 
 namespace AK {
 
+static size_t count_ascii_bytes(u8 const* bytes, size_t length)
+{
+    size_t offset = 0;
+
+    // OPTIMIZATION: Check 32 bytes per iteration using vector types. This lowers to SSE2/AVX2 on x86-64 and NEON on AArch64,
+    //               and falls back to scalar code on targets without a vector unit.
+    for (; offset + 32 <= length; offset += 32) {
+        SIMD::u8x16 low;
+        SIMD::u8x16 high;
+        __builtin_memcpy(&low, bytes + offset, sizeof(low));
+        __builtin_memcpy(&high, bytes + offset + sizeof(low), sizeof(high));
+
+        auto combined = bit_cast<SIMD::u64x2>(low | high);
+        if (((combined[0] | combined[1]) & 0x8080808080808080ull) != 0)
+            break;
+    }
+
+    for (; offset + sizeof(u64) <= length; offset += sizeof(u64)) {
+        u64 word;
+        __builtin_memcpy(&word, bytes + offset, sizeof(word));
+        if ((word & 0x8080808080808080ull) != 0)
+            break;
+    }
+
+    for (; offset < length; ++offset) {
+        if (bytes[offset] > 0x7F)
+            break;
+    }
+
+    return offset;
+}
+
 Utf8CodePointIterator Utf8View::iterator_at_byte_offset(size_t byte_offset) const
 {
     size_t current_offset = 0;
@@ -70,11 +104,25 @@ Utf8View Utf8View::unicode_substring_view(size_t code_point_offset, size_t code_
     VERIFY_NOT_REACHED();
 }
 
+size_t Utf8View::length_of_ascii_run(size_t byte_offset) const
+{
+    VERIFY(byte_offset <= byte_length());
+    return count_ascii_bytes(begin_ptr() + byte_offset, byte_length() - byte_offset);
+}
+
 size_t Utf8View::calculate_length() const
 {
     size_t length = 0;
 
     for (size_t i = 0; i < m_string.length(); ++length) {
+        // OPTIMIZATION: Every byte of an ASCII run is a code point of its own.
+        if (static_cast<u8>(m_string[i]) <= 0x7F) {
+            auto ascii_length = count_ascii_bytes(begin_ptr() + i, m_string.length() - i);
+            i += ascii_length;
+            length += ascii_length - 1;
+            continue;
+        }
+
         auto [byte_length, code_point, is_valid] = decode_leading_byte(static_cast<u8>(m_string[i]));
 
         // Similar to Utf8CodePointIterator::operator++, if the byte is invalid, try the next byte.
@@ -107,6 +107,10 @@ public:
 
     Utf8View trim(Utf8View const& characters, TrimMode mode = TrimMode::Both) const;
 
+    // Returns the number of consecutive ASCII bytes starting at the given byte offset.
+    size_t length_of_ascii_run(size_t byte_offset = 0) const;
+    bool is_ascii() const { return length_of_ascii_run() == byte_length(); }
+
     size_t iterator_offset(Utf8CodePointIterator const& it) const
     {
         return byte_offset_of(it);
@@ -132,6 +136,14 @@ public:
         valid_bytes = 0;
 
         for (auto it = m_string.begin(); it != m_string.end(); ++it) {
+            // OPTIMIZATION: Skip over runs of ASCII characters in bulk.
+            if (!is_constant_evaluated() && static_cast<u8>(*it) <= 0x7F) {
+                auto ascii_length = length_of_ascii_run(valid_bytes);
+                valid_bytes += ascii_length;
+                it = m_string.begin() + (valid_bytes - 1);
+                continue;
+            }
+
             auto [byte_length, code_point, is_valid] = decode_leading_byte(static_cast<u8>(*it));
             if (!is_valid)
                 return false;
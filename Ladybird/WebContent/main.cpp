@@ -14,10 +14,12 @@
 #include <LibCore/LocalServer.h>
 #include <LibCore/Process.h>
 #include <LibCore/Resource.h>
+#include <LibCore/StandardPaths.h>
 #include <LibCore/System.h>
 #include <LibCore/SystemServerTakeover.h>
 #include <LibIPC/ConnectionFromClient.h>
 #include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/BytecodeCache.h>
 #include <LibMain/Main.h>
 #include <LibProtocol/RequestClient.h>
 #include <LibWeb/Bindings/MainThreadVM.h>
@@ -149,6 +151,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     TRY(Web::Bindings::initialize_main_thread_vm());
 
+    // NOTE: Layout tests should run the same code every time, rather than whatever an earlier run left on disk.
+    if (!is_layout_test_mode) {
+        if (auto result = JS::BytecodeCache::enable(ByteString::formatted("{}/Ladybird/bytecode-cache", Core::StandardPaths::data_directory())); result.is_error())
+            dbgln("Failed to enable the bytecode cache: {}", result.error());
+    }
+
     if (log_all_js_exceptions) {
         JS::g_log_all_js_exceptions = true;
     }
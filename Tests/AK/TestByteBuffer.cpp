@@ -6,6 +6,7 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/Array.h>
 #include <AK/ByteBuffer.h>
 #include <AK/Vector.h>
 
@@ -63,6 +64,30 @@ TEST_CASE(zero_fill_new_elements_on_growth)
     EXPECT_EQ(buffer.span(), (Array<u8, 10> { 2, 2, 2, 2, 2, 2, 2, 2, 0, 0 }));
 }
 
+TEST_CASE(external_storage)
+{
+    Array<u8, 8> storage { 1, 2, 3, 4, 5, 6, 7, 8 };
+    {
+        auto buffer = ByteBuffer::create_with_external_storage(storage);
+        EXPECT(buffer.is_empty());
+        EXPECT_EQ(buffer.capacity(), 8u);
+
+        buffer.resize(4);
+        EXPECT_EQ(buffer.data(), storage.data());
+        EXPECT_EQ(buffer.span(), (Array<u8, 4> { 1, 2, 3, 4 }));
+
+        buffer[0] = 42;
+        EXPECT(buffer.try_resize(9).is_error());
+
+        // Moving it around doesn't copy the storage, and shrinking doesn't give it up.
+        auto moved = move(buffer);
+        moved.resize(1);
+        moved.resize(8);
+        EXPECT_EQ(moved.data(), storage.data());
+    }
+    EXPECT_EQ(storage[0], 42);
+}
+
 BENCHMARK_CASE(append)
 {
     ByteBuffer bb;
@@ -441,3 +441,32 @@ BENCHMARK_CASE(looping_copy_from_seekback)
         EXPECT_EQ(copied_bytes, 15 * MiB);
     }
 }
+
+TEST_CASE(find_copy_in_seekback_after_wrapping_around)
+{
+    // Keep a few bytes of lookahead around while the buffer wraps around many times, like a compressor does.
+    auto buffer = MUST(SearchableCircularBuffer::create_empty(64));
+    auto data = "The quick brown fox jumps over the lazy dog, and then it jumps again. "sv.bytes();
+    constexpr size_t lookahead_size = 5;
+
+    size_t written_bytes = 0;
+    for (size_t i = 0; i < 50 * data.size(); i++) {
+        written_bytes += buffer.write(data.slice(written_bytes % data.size(), 1));
+        if (buffer.used_space() < lookahead_size)
+            continue;
+
+        auto match = buffer.find_copy_in_seekback(lookahead_size, 3);
+        if (match.has_value()) {
+            EXPECT(match->distance <= buffer.search_limit());
+            EXPECT(match->length >= 3ul);
+        }
+
+        // Alternate between both ways of advancing the read head, which both hash the data that they skip over.
+        if (i % 2 == 0) {
+            u8 byte;
+            MUST(buffer.read({ &byte, 1 }));
+        } else {
+            MUST(buffer.discard(1));
+        }
+    }
+}
@@ -7,6 +7,8 @@
 #include <LibTest/TestCase.h>
 
 #include <AK/ByteBuffer.h>
+#include <AK/StringBuilder.h>
+#include <AK/Utf16View.h>
 #include <AK/Utf8View.h>
 
 TEST_CASE(decode_ascii)
@@ -295,3 +297,83 @@ TEST_CASE(trim)
         EXPECT_EQ(view.trim(whitespace, TrimMode::Right).as_string(), "\u180E");
     }
 }
+
+TEST_CASE(ascii_runs)
+{
+    // Exercise the bulk ASCII paths across vector and word boundaries, with non-ASCII code points at every position.
+    for (size_t prefix_length = 0; prefix_length < 70; ++prefix_length) {
+        StringBuilder builder;
+        for (size_t i = 0; i < prefix_length; ++i)
+            builder.append('a' + (i % 26));
+        builder.append("π"sv);
+        for (size_t i = 0; i < prefix_length; ++i)
+            builder.append('A' + (i % 26));
+
+        auto string = builder.to_byte_string();
+        Utf8View view { string };
+
+        EXPECT(view.validate());
+        EXPECT(!view.is_ascii());
+        EXPECT_EQ(view.length(), prefix_length * 2 + 1);
+        EXPECT_EQ(view.length_of_ascii_run(), prefix_length);
+        EXPECT_EQ(view.length_of_ascii_run(prefix_length + 2), prefix_length);
+
+        auto utf16 = MUST(AK::utf8_to_utf16(view));
+        EXPECT_EQ(utf16.size(), prefix_length * 2 + 1);
+
+        size_t i = 0;
+        for (auto code_point : view)
+            EXPECT_EQ(utf16[i++], code_point);
+    }
+}
+
+TEST_CASE(ascii_runs_with_invalid_bytes)
+{
+    auto string = ByteString::formatted("{}\xE0{}\xFF{}", ByteString::repeated('x', 40), ByteString::repeated('y', 33), ByteString::repeated('z', 7));
+    Utf8View view { string };
+
+    size_t valid_bytes = 0;
+    EXPECT(!view.validate(valid_bytes));
+    EXPECT_EQ(valid_bytes, 40u);
+
+    auto utf16 = MUST(AK::utf8_to_utf16(view));
+    Vector<u32> code_points;
+    for (auto code_point : view)
+        code_points.append(code_point);
+
+    EXPECT_EQ(utf16.size(), code_points.size());
+    for (size_t i = 0; i < code_points.size(); ++i)
+        EXPECT_EQ(utf16[i], code_points[i]);
+}
+
+static ByteString make_web_corpus(StringView text)
+{
+    StringBuilder builder;
+    while (builder.length() < 4 * MiB)
+        builder.appendff("<div class=\"article-body\"><p data-index=\"{}\">{}</p></div>\n", builder.length(), text);
+    return builder.to_byte_string();
+}
+
+static void run_utf8_benchmark(StringView text)
+{
+    auto corpus = make_web_corpus(text);
+
+    for (size_t i = 0; i < 10; ++i) {
+        Utf8View view { corpus };
+        EXPECT(view.validate());
+        EXPECT(view.length() > 0);
+
+        auto utf16 = MUST(AK::utf8_to_utf16(view));
+        EXPECT(utf16.size() > 0);
+    }
+}
+
+BENCHMARK_CASE(ascii_web_corpus)
+{
+    run_utf8_benchmark("The quick brown fox jumps over the lazy dog, then writes some markup and a bit of <em>inline</em> script."sv);
+}
+
+BENCHMARK_CASE(mixed_web_corpus)
+{
+    run_utf8_benchmark("Привет, мир! γειά σου κόσμος. The café served crème brûlée; こんにちは世界 😀"sv);
+}
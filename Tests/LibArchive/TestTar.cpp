@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/MemoryStream.h>
+#include <LibArchive/TarIndex.h>
+#include <LibArchive/TarStream.h>
+
+static ByteBuffer make_archive(Archive::TarIndex& index)
+{
+    auto stream = make<AllocatingMemoryStream>();
+    Archive::TarOutputStream tar_stream(MaybeOwned<Stream> { *stream });
+
+    // The second file spans multiple blocks, so the offsets of the members after it depend on its size.
+    auto long_contents = ByteString::repeated('x', 1300);
+    MUST(index.add("first.txt", tar_stream.offset()));
+    MUST(tar_stream.add_file("first.txt"sv, 0644, "first"sv.bytes()));
+    MUST(index.add("long.txt", tar_stream.offset()));
+    MUST(tar_stream.add_file("long.txt"sv, 0644, long_contents.bytes()));
+    MUST(index.add("directory/", tar_stream.offset()));
+    MUST(tar_stream.add_directory("directory"sv, 0755));
+    MUST(index.add("directory/third.txt", tar_stream.offset()));
+    MUST(tar_stream.add_file("directory/third.txt"sv, 0644, "third member"sv.bytes()));
+    MUST(tar_stream.finish());
+
+    return MUST(stream->read_until_eof());
+}
+
+static ByteString read_contents(Archive::TarInputStream& tar_stream)
+{
+    auto contents = tar_stream.file_contents();
+    return ByteString { MUST(contents.read_until_eof()).bytes() };
+}
+
+TEST_CASE(tar_header_offsets_match_the_written_offsets)
+{
+    Archive::TarIndex index;
+    auto archive = make_archive(index);
+
+    auto tar_stream = MUST(Archive::TarInputStream::construct(make<FixedMemoryStream>(archive.bytes())));
+    EXPECT(tar_stream->is_seekable());
+
+    Vector<ByteString> paths;
+    for (; !tar_stream->finished(); MUST(tar_stream->advance())) {
+        EXPECT(MUST(tar_stream->valid()));
+        auto path = ByteString { tar_stream->header().filename() };
+        EXPECT_EQ(index.find(path), tar_stream->header_offset());
+        paths.append(move(path));
+    }
+    EXPECT_EQ(paths, (Vector<ByteString> { "first.txt", "long.txt", "directory/", "directory/third.txt" }));
+}
+
+TEST_CASE(tar_seek_to_member_through_index)
+{
+    Archive::TarIndex written_index;
+    auto archive = make_archive(written_index);
+
+    // Go through the sidecar format, like tar does with -I.
+    AllocatingMemoryStream index_stream;
+    MUST(written_index.write_to_stream(index_stream));
+    auto index = MUST(Archive::TarIndex::read_from_stream(index_stream));
+    EXPECT_EQ(index.entries().size(), 4u);
+
+    auto tar_stream = MUST(Archive::TarInputStream::construct(make<FixedMemoryStream>(archive.bytes())));
+
+    auto third_offset = index.find("directory/third.txt"sv);
+    EXPECT(third_offset.has_value());
+    EXPECT_EQ(*third_offset, 4u * 512 + 1536);
+    MUST(tar_stream->seek_to_header(*third_offset));
+    EXPECT(MUST(tar_stream->valid()));
+    EXPECT_EQ(tar_stream->header().filename(), "directory/third.txt"sv);
+    EXPECT_EQ(MUST(tar_stream->header().size()), 12u);
+    EXPECT_EQ(tar_stream->header_offset(), *third_offset);
+    EXPECT_EQ(read_contents(*tar_stream), "third member"sv);
+
+    // Members before the current one can be reached again too.
+    MUST(tar_stream->seek_to_header(*index.find("long.txt"sv)));
+    EXPECT_EQ(tar_stream->header().filename(), "long.txt"sv);
+    EXPECT_EQ(read_contents(*tar_stream), ByteString::repeated('x', 1300));
+
+    // Reading continues normally from the member that was seeked to.
+    MUST(tar_stream->advance());
+    EXPECT_EQ(tar_stream->header().filename(), "directory/"sv);
+    MUST(tar_stream->advance());
+    EXPECT_EQ(tar_stream->header().filename(), "directory/third.txt"sv);
+    MUST(tar_stream->advance());
+    EXPECT(tar_stream->finished());
+
+    EXPECT(!index.find("missing.txt"sv).has_value());
+}
+
+TEST_CASE(tar_seek_to_header_errors)
+{
+    Archive::TarIndex index;
+    auto archive = make_archive(index);
+
+    auto tar_stream = MUST(Archive::TarInputStream::construct(make<FixedMemoryStream>(archive.bytes())));
+    EXPECT(tar_stream->seek_to_header(100).is_error());
+
+    auto sequential_stream = make<AllocatingMemoryStream>();
+    MUST(sequential_stream->write_until_depleted(archive.bytes()));
+    auto sequential_tar_stream = MUST(Archive::TarInputStream::construct(move(sequential_stream)));
+    EXPECT(!sequential_tar_stream->is_seekable());
+    EXPECT(sequential_tar_stream->seek_to_header(*index.find("long.txt"sv)).is_error());
+}
+
+TEST_CASE(tar_index_rejects_malformed_sidecars)
+{
+    auto read = [](StringView contents) {
+        FixedMemoryStream stream { contents.bytes() };
+        return Archive::TarIndex::read_from_stream(stream);
+    };
+
+    EXPECT(!read("0 first.txt\n1024 second.txt\n"sv).is_error());
+    EXPECT(read("0 first.txt"sv).is_error());
+    EXPECT(read("first.txt\n"sv).is_error());
+
+    Archive::TarIndex index;
+    EXPECT(index.add("", 0).is_error());
+    EXPECT(index.add("a\nb", 0).is_error());
+}
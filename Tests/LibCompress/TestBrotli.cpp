@@ -9,6 +9,7 @@
 #include <AK/BitStream.h>
 #include <AK/MaybeOwned.h>
 #include <AK/MemoryStream.h>
+#include <AK/Random.h>
 #include <LibCompress/Brotli.h>
 #include <LibCore/File.h>
 
@@ -177,3 +178,186 @@ TEST_CASE(brotli_decompress_zero_one_bin)
     EXPECT(bytes_read == 32 * MiB);
     EXPECT(brotli_stream.is_eof());
 }
+
+static ByteBuffer brotli_decompress_all(ReadonlyBytes compressed)
+{
+    auto stream = FixedMemoryStream { compressed };
+    auto brotli_stream = Compress::BrotliDecompressionStream { MaybeOwned<Stream> { stream } };
+    return MUST(brotli_stream.read_until_eof());
+}
+
+static ByteBuffer read_test_file(StringView file_name)
+{
+#ifdef AK_OS_SERENITY
+    ByteString path = ByteString::formatted("/usr/Tests/LibCompress/brotli-test-files/{}", file_name);
+#else
+    ByteString path = ByteString::formatted("brotli-test-files/{}", file_name);
+#endif
+
+    auto file = MUST(Core::File::open(path, Core::File::OpenMode::Read));
+    return MUST(file->read_until_eof());
+}
+
+static void run_round_trip_test(StringView const file_name)
+{
+    auto original = read_test_file(file_name);
+
+    for (u8 quality : { 0, 4, 5, 9, 11 }) {
+        auto compressed = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(original, quality));
+        EXPECT_EQ(brotli_decompress_all(compressed), original);
+    }
+}
+
+TEST_CASE(brotli_round_trip_lorem)
+{
+    run_round_trip_test("lorem.txt"sv);
+}
+
+TEST_CASE(brotli_round_trip_serenityos_html)
+{
+    run_round_trip_test("serenityos.html"sv);
+}
+
+TEST_CASE(brotli_round_trip_katica_regular_10_font)
+{
+    run_round_trip_test("KaticaRegular10.font"sv);
+}
+
+TEST_CASE(brotli_compress_compared_to_reference)
+{
+    // The test files come with the output of the reference encoder, which we should stay reasonably close to.
+    for (auto file_name : { "lorem.txt"sv, "transform.txt"sv, "serenityos.html"sv, "happy3rd.html"sv, "KaticaRegular10.font"sv }) {
+        auto original = read_test_file(file_name);
+        auto reference = read_test_file(ByteString::formatted("{}.br", file_name));
+        auto compressed = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(original, Compress::BrotliCompressor::max_quality));
+        EXPECT_EQ(brotli_decompress_all(compressed), original);
+        EXPECT(compressed.size() <= reference.size() * 6 / 5);
+    }
+}
+
+static ByteBuffer brotli_compress(ReadonlyBytes input, u8 quality, u8 window_bits)
+{
+    auto output_stream = make<AllocatingMemoryStream>();
+    auto brotli_stream = MUST(Compress::BrotliCompressor::construct(MaybeOwned<Stream>(*output_stream), quality, window_bits));
+    MUST(brotli_stream->write_until_depleted(input));
+    MUST(brotli_stream->final_flush());
+
+    auto compressed = MUST(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+    MUST(output_stream->read_until_filled(compressed));
+    return compressed;
+}
+
+// RFC 7932 section 9.1
+static u8 read_window_bits(LittleEndianInputBitStream& stream)
+{
+    if (MUST(stream.read_bit()) == 0)
+        return 16;
+    if (auto n = MUST(stream.read_bits(3)); n != 0)
+        return 17 + n;
+    auto n = MUST(stream.read_bits(3));
+    VERIFY(n != 1);
+    return n == 0 ? 17 : 8 + n;
+}
+
+TEST_CASE(brotli_compress_window_bits)
+{
+    // Random data that repeats once with a distance just past the end of the window, which must not be referenced, and
+    // then once more just inside of it.
+    for (u8 window_bits = Compress::BrotliCompressor::min_window_bits; window_bits <= 16; ++window_bits) {
+        size_t window_size = (1u << window_bits) - 16;
+        auto pattern = MUST(ByteBuffer::create_uninitialized(window_size + 1));
+        fill_with_random(pattern);
+        auto original = MUST(ByteBuffer::copy(pattern));
+        original.append(pattern);
+        original.append(pattern.bytes().slice(1));
+
+        auto compressed = brotli_compress(original, 5, window_bits);
+        FixedMemoryStream stream { compressed.bytes() };
+        LittleEndianInputBitStream bit_stream { MaybeOwned<Stream>(stream) };
+        EXPECT_EQ(read_window_bits(bit_stream), window_bits);
+        EXPECT_EQ(brotli_decompress_all(compressed), original);
+        EXPECT(compressed.size() < window_size * 2 + window_size / 2);
+    }
+
+    // Large windows only differ in their header.
+    auto input = "window window window"sv;
+    for (u8 window_bits = 17; window_bits <= Compress::BrotliCompressor::max_window_bits; ++window_bits) {
+        auto compressed = brotli_compress(input.bytes(), 5, window_bits);
+        FixedMemoryStream stream { compressed.bytes() };
+        LittleEndianInputBitStream bit_stream { MaybeOwned<Stream>(stream) };
+        EXPECT_EQ(read_window_bits(bit_stream), window_bits);
+        EXPECT_EQ(brotli_decompress_all(compressed).bytes(), input.bytes());
+    }
+}
+
+TEST_CASE(brotli_compress_all_picks_smallest_window)
+{
+    auto window_bits_for_size = [](size_t size) -> u8 {
+        auto original = MUST(ByteBuffer::create_zeroed(size));
+        auto compressed = MUST(Compress::BrotliCompressor::compress_all(original, 0));
+        EXPECT_EQ(brotli_decompress_all(compressed), original);
+
+        FixedMemoryStream stream { compressed.bytes() };
+        LittleEndianInputBitStream bit_stream { MaybeOwned<Stream>(stream) };
+        return read_window_bits(bit_stream);
+    };
+
+    EXPECT_EQ(window_bits_for_size(0), Compress::BrotliCompressor::min_window_bits);
+    EXPECT_EQ(window_bits_for_size((1 << 10) - 16), 10);
+    EXPECT_EQ(window_bits_for_size((1 << 10) - 15), 11);
+    EXPECT_EQ(window_bits_for_size((1 << 16) - 16), 16);
+    EXPECT_EQ(window_bits_for_size((1 << 16) - 15), 17);
+    EXPECT_EQ(window_bits_for_size(5 * MiB), Compress::BrotliCompressor::default_window_bits);
+}
+
+TEST_CASE(brotli_compress_uncompressed_meta_block)
+{
+    // Random data doesn't compress, so it should be stored in an uncompressed meta-block at any quality.
+    auto original = MUST(ByteBuffer::create_uninitialized(100 * KiB));
+    fill_with_random(original);
+
+    for (u8 quality : { Compress::BrotliCompressor::min_quality, Compress::BrotliCompressor::max_quality }) {
+        auto compressed = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(original, quality));
+        EXPECT_EQ(brotli_decompress_all(compressed), original);
+
+        // RFC 7932 section 9.2
+        FixedMemoryStream stream { compressed.bytes() };
+        LittleEndianInputBitStream bit_stream { MaybeOwned<Stream>(stream) };
+        EXPECT_EQ(read_window_bits(bit_stream), 17);
+        EXPECT_EQ(MUST(bit_stream.read_bit()), false);            // ISLAST
+        EXPECT_EQ(MUST(bit_stream.read_bits(2)), 1u);             // MNIBBLES = 5
+        EXPECT_EQ(MUST(bit_stream.read_bits(20)), 100 * KiB - 1); // MLEN - 1
+        EXPECT_EQ(MUST(bit_stream.read_bit()), true);             // ISUNCOMPRESSED
+        bit_stream.align_to_byte_boundary();
+
+        auto stored = MUST(ByteBuffer::create_uninitialized(original.size()));
+        MUST(bit_stream.read_until_filled(stored));
+        EXPECT_EQ(stored, original);
+        EXPECT_EQ(MUST(bit_stream.read_bit()), true); // ISLAST
+        EXPECT_EQ(MUST(bit_stream.read_bit()), true); // ISLASTEMPTY
+    }
+}
+
+TEST_CASE(brotli_compress_references_into_uncompressed_meta_block)
+{
+    // The first meta-block is random and stored as is, the second one repeats it. Stored data is part of the window
+    // just like compressed data, so the second meta-block should compress to next to nothing.
+    auto random = MUST(ByteBuffer::create_uninitialized(Compress::BrotliCompressor::meta_block_size));
+    fill_with_random(random);
+    auto original = MUST(ByteBuffer::copy(random));
+    original.append(random);
+
+    auto compressed = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(original, 5));
+    EXPECT_EQ(brotli_decompress_all(compressed), original);
+    EXPECT(compressed.size() < random.size() + 1 * KiB);
+}
+
+TEST_CASE(brotli_compress_dictionary_words)
+{
+    // There are no repetitions in this text, so it can only get this small by referencing the built-in dictionary.
+    auto input = "The quick brown fox jumps over the lazy dog. Everything else happened afterwards, according to history."sv;
+    auto compressed = TRY_OR_FAIL(Compress::BrotliCompressor::compress_all(input.bytes()));
+    auto uncompressed = brotli_decompress_all(compressed);
+    EXPECT_EQ(uncompressed.bytes(), input.bytes());
+    EXPECT(compressed.size() < input.length() * 2 / 3);
+}
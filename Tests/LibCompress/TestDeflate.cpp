@@ -156,6 +156,106 @@ TEST_CASE(deflate_round_trip_compress_large)
     EXPECT(uncompressed == original);
 }
 
+static ByteBuffer make_test_data_with_back_references(size_t size)
+{
+    // Short runs of literals alternating with copies of earlier data, with lengths and distances anywhere in the range that
+    // deflate can encode.
+    auto buffer = MUST(ByteBuffer::create_uninitialized(size));
+    size_t offset = 0;
+    while (offset < size) {
+        auto literal_count = min<size_t>(size - offset, 1 + get_random_uniform(16));
+        for (size_t i = 0; i < literal_count; ++i)
+            buffer[offset++] = 'a' + get_random_uniform(26);
+
+        auto distance = 1 + get_random_uniform(min(offset, Compress::DeflateCompressor::max_back_reference_distance));
+        auto length = min<size_t>(size - offset, Compress::DeflateCompressor::min_match_length + get_random_uniform(Compress::DeflateCompressor::max_match_length - Compress::DeflateCompressor::min_match_length + 1));
+        for (size_t i = 0; i < length; ++i, ++offset)
+            buffer[offset] = buffer[offset - distance];
+    }
+    return buffer;
+}
+
+TEST_CASE(deflate_round_trip_parallel)
+{
+    auto original = make_test_data_with_back_references(Compress::DeflateCompressor::parallel_chunk_size * 5 + 1234);
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all_in_parallel(original, 4));
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+
+    // The output must not depend on how the chunks were distributed between threads.
+    auto compressed_on_one_thread = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all_in_parallel(original, 1));
+    EXPECT(compressed_on_one_thread == compressed);
+}
+
+TEST_CASE(deflate_round_trip_parallel_small)
+{
+    for (size_t size : { 0, 1, 1000 }) {
+        auto original = make_test_data_with_back_references(size);
+        auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all_in_parallel(original, 4));
+        auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+        EXPECT(uncompressed == original);
+    }
+}
+
+TEST_CASE(deflate_parallel_chunks_end_with_sync_flush)
+{
+    auto const chunk_size = Compress::DeflateCompressor::parallel_chunk_size;
+    auto original = make_test_data_with_back_references(chunk_size * 3 + 100);
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all_in_parallel(original, 4));
+
+    // Every chunk but the last ends with an empty stored block (BFINAL = 0, BTYPE = 00, LEN = 0x0000, NLEN = 0xffff).
+    // Decoding the stream up to the end of one has to produce exactly the chunks before it, and then run out of input
+    // instead of finding a final block. The same bytes can also show up in Huffman coded data, those are skipped.
+    Array<u8, 4> const empty_stored_block { 0x00, 0x00, 0xff, 0xff };
+    Vector<size_t> chunk_boundaries;
+    for (size_t offset = 0; offset + empty_stored_block.size() <= compressed.size(); ++offset) {
+        if (compressed.bytes().slice(offset, empty_stored_block.size()) != empty_stored_block.span())
+            continue;
+
+        FixedMemoryStream memory_stream { compressed.bytes().trim(offset + empty_stored_block.size()) };
+        LittleEndianInputBitStream bit_stream { MaybeOwned<Stream>(memory_stream) };
+        auto decompressor = TRY_OR_FAIL(Compress::DeflateDecompressor::construct(MaybeOwned<LittleEndianInputBitStream>(bit_stream)));
+
+        // Read one byte at a time, so that nothing that was decoded before running out of input gets lost.
+        ByteBuffer uncompressed;
+        Array<u8, 1> byte;
+        while (true) {
+            auto read_or_error = decompressor->read_some(byte);
+            if (read_or_error.is_error())
+                break;
+            EXPECT(!read_or_error.value().is_empty());
+            if (read_or_error.value().is_empty())
+                break;
+            uncompressed.append(byte[0]);
+        }
+
+        if (uncompressed.size() % chunk_size != 0)
+            continue;
+        EXPECT(uncompressed.bytes() == original.bytes().trim(uncompressed.size()));
+        chunk_boundaries.append(uncompressed.size());
+    }
+
+    EXPECT_EQ(chunk_boundaries, (Vector<size_t> { chunk_size, chunk_size * 2, chunk_size * 3 }));
+}
+
+TEST_CASE(deflate_parallel_chunks_reference_previous_chunk)
+{
+    // Random data that repeats with a period as long as the dictionary only compresses if every chunk can refer back into
+    // the one before it. Without the dictionary, the start of every chunk would have to be stored as literals.
+    auto const period = Compress::DeflateCompressor::block_size;
+    auto pattern = MUST(ByteBuffer::create_uninitialized(period));
+    fill_with_random(pattern);
+
+    auto original = MUST(ByteBuffer::create_uninitialized(Compress::DeflateCompressor::parallel_chunk_size * 4 + 1234));
+    for (size_t offset = 0; offset < original.size(); offset += period)
+        pattern.bytes().copy_trimmed_to(original.bytes().slice(offset));
+
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all_in_parallel(original, 4));
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+    EXPECT(compressed.size() < period + 16 * KiB);
+}
+
 TEST_CASE(deflate_compress_literals)
 {
     // This byte array is known to not produce any back references with our lz77 implementation even at the highest compression settings
@@ -163,6 +263,27 @@ TEST_CASE(deflate_compress_literals)
     auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(test, Compress::DeflateCompressor::CompressionLevel::GOOD));
 }
 
+TEST_CASE(deflate_round_trip_long_matches)
+{
+    // Short-distance matches overlap their own output, which the decompressor has to copy byte by byte.
+    auto original = MUST(ByteBuffer::create_uninitialized(100000));
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = "abcabcabcdxxxxxxxxxxxxyyyy"[(i / 3) % 26] + ((i / 5000) % 3);
+    for (auto level : { Compress::DeflateCompressor::CompressionLevel::FAST, Compress::DeflateCompressor::CompressionLevel::GOOD }) {
+        auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, level));
+        auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+        EXPECT(uncompressed == original);
+    }
+}
+
+TEST_CASE(deflate_decompress_truncated)
+{
+    auto original = make_test_data_with_back_references(100000);
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original));
+    for (size_t size : { compressed.size() - 1, compressed.size() / 2, static_cast<size_t>(1) })
+        EXPECT(Compress::DeflateDecompressor::decompress_all(compressed.bytes().trim(size)).is_error());
+}
+
 TEST_CASE(ossfuzz_63183)
 {
     auto path = TEST_INPUT("clusterfuzz-testcase-minimized-FuzzDeflateCompression-6163230961303552.fuzz"sv);
@@ -180,3 +301,35 @@ TEST_CASE(ossfuzz_58046)
     auto test_data = TRY_OR_FAIL(test_file->read_until_eof());
     EXPECT(Compress::DeflateDecompressor::decompress_all(test_data).is_error());
 }
+
+static ByteBuffer make_literal_heavy_test_data(size_t size)
+{
+    // Random bytes with a skewed distribution, which compress well with Huffman codes but contain few matches.
+    auto buffer = MUST(ByteBuffer::create_uninitialized(size));
+    u32 state = 0x87654321;
+    for (auto& byte : buffer.bytes()) {
+        state = state * 1103515245 + 12345;
+        byte = 'a' + count_trailing_zeroes(state >> 8 | 0x10000) + ((state >> 28) & 3);
+    }
+    return buffer;
+}
+
+BENCHMARK_CASE(benchmark_deflate_decompression_text)
+{
+    auto original = make_test_data_with_back_references(8 * MiB);
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST));
+    for (size_t i = 0; i < 8; ++i) {
+        auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+        EXPECT_EQ(uncompressed.size(), original.size());
+    }
+}
+
+BENCHMARK_CASE(benchmark_deflate_decompression_literals)
+{
+    auto original = make_literal_heavy_test_data(8 * MiB);
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST));
+    for (size_t i = 0; i < 8; ++i) {
+        auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+        EXPECT_EQ(uncompressed.size(), original.size());
+    }
+}
@@ -94,6 +94,15 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed == original);
 }
 
+TEST_CASE(gzip_round_trip_parallel)
+{
+    auto original = ByteBuffer::create_zeroed(Compress::DeflateCompressor::parallel_chunk_size * 3 + 100).release_value();
+    fill_with_random(original.bytes().trim(original.size() / 2));
+    auto compressed = TRY_OR_FAIL(Compress::GzipCompressor::compress_all(original, 4));
+    auto uncompressed = TRY_OR_FAIL(Compress::GzipDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
 TEST_CASE(gzip_truncated_uncompressed_block)
 {
     Array<u8, 38> const compressed {
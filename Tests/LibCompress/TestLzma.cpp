@@ -6,8 +6,11 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/CircularBuffer.h>
 #include <AK/MemoryStream.h>
 #include <LibCompress/Lzma.h>
+#include <LibCompress/LzmaMatchFinder.h>
+#include <LibCore/File.h>
 
 TEST_CASE(repetition_length_beyond_distance)
 {
@@ -75,6 +78,38 @@ TEST_CASE(compress_decompress_roundtrip_with_unknown_size)
     EXPECT_EQ(uncompressed, result.span());
 }
 
+TEST_CASE(compress_does_not_reference_data_beyond_dictionary_size)
+{
+    // The compressor's buffer has some extra room for lookahead, but data that is further away than the dictionary
+    // size must not be referenced, since decoders only keep that much around.
+    auto uncompressed = MUST(ByteBuffer::create_uninitialized(4 * KiB + 50));
+    u32 state = 1;
+    for (auto& byte : uncompressed.bytes()) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = static_cast<u8>(state);
+    }
+    uncompressed.append(uncompressed.span().trim(100));
+
+    auto stream = MUST(try_make<AllocatingMemoryStream>());
+
+    Compress::LzmaCompressorOptions const compressor_options {
+        .literal_context_bits = 3,
+        .literal_position_bits = 0,
+        .position_bits = 2,
+        .dictionary_size = 4 * KiB,
+        .uncompressed_size = uncompressed.size(),
+    };
+    auto compressor = TRY_OR_FAIL(Compress::LzmaCompressor::create_container(MaybeOwned<Stream> { *stream }, compressor_options));
+    TRY_OR_FAIL(compressor->write_until_depleted(uncompressed));
+
+    auto decompressor = TRY_OR_FAIL(Compress::LzmaDecompressor::create_from_container(MaybeOwned<Stream> { *stream }));
+    auto result = TRY_OR_FAIL(decompressor->read_until_eof());
+
+    EXPECT_EQ(uncompressed.span(), result.span());
+}
+
 TEST_CASE(compress_long_overflow_chain)
 {
     // Encoding 0xFF followed by the end-of-stream marker results in a chain of bytes that doesn't fit into 64 bits,
@@ -95,6 +130,195 @@ TEST_CASE(compress_long_overflow_chain)
     EXPECT_EQ(uncompressed, result.span());
 }
 
+static ByteBuffer read_test_file(StringView file_name)
+{
+    // The Brotli test files are real-world text and binary data, which is all that these tests need.
+#ifdef AK_OS_SERENITY
+    ByteString path = ByteString::formatted("/usr/Tests/LibCompress/brotli-test-files/{}", file_name);
+#else
+    ByteString path = ByteString::formatted("brotli-test-files/{}", file_name);
+#endif
+
+    auto file = MUST(Core::File::open(path, Core::File::OpenMode::Read));
+    return MUST(file->read_until_eof());
+}
+
+static ByteBuffer read_test_data(size_t size)
+{
+    // An HTML page followed by a bitmap font, for both short and long matches at all kinds of distances.
+    auto data = read_test_file("happy3rd.html"sv);
+    data.append(read_test_file("KaticaRegular10.font"sv));
+    VERIFY(data.size() >= size);
+    data.resize(size);
+    return data;
+}
+
+static ByteBuffer compress_and_decompress(ReadonlyBytes uncompressed, Compress::LzmaCompressorOptions const& options, size_t& compressed_size, size_t write_size = NumericLimits<size_t>::max())
+{
+    auto stream = MUST(try_make<AllocatingMemoryStream>());
+    auto compressor = MUST(Compress::LzmaCompressor::create_container(MaybeOwned<Stream> { *stream }, options));
+    for (size_t offset = 0; offset < uncompressed.size(); offset += write_size)
+        MUST(compressor->write_until_depleted(uncompressed.slice(offset, min(write_size, uncompressed.size() - offset))));
+    MUST(compressor->flush());
+    compressed_size = stream->used_buffer_size();
+
+    auto decompressor = MUST(Compress::LzmaDecompressor::create_from_container(MaybeOwned<Stream> { *stream }));
+    return MUST(decompressor->read_until_eof());
+}
+
+TEST_CASE(compress_decompress_roundtrip_with_match_finders)
+{
+    auto const uncompressed = read_test_data(300 * KiB);
+
+    for (auto match_finder : { Compress::LzmaMatchFinderType::HashChain4, Compress::LzmaMatchFinderType::BinaryTree4 }) {
+        for (u16 nice_match_length : { 4, 16, 64, 273 }) {
+            for (u32 depth : { 0, 1, 1000 }) {
+                Compress::LzmaCompressorOptions const compressor_options {
+                    .dictionary_size = 64 * KiB,
+                    .match_finder = match_finder,
+                    .nice_match_length = nice_match_length,
+                    .match_finder_depth = depth,
+                };
+                size_t compressed_size = 0;
+                auto result = compress_and_decompress(uncompressed, compressor_options, compressed_size);
+                EXPECT_EQ(uncompressed.span(), result.span());
+                EXPECT(compressed_size < uncompressed.size() / 4);
+            }
+        }
+    }
+}
+
+TEST_CASE(compress_decompress_roundtrip_with_presets)
+{
+    auto const uncompressed = read_test_data(300 * KiB);
+
+    size_t fastest_size = 0;
+    size_t default_size = 0;
+    for (u8 preset = Compress::LzmaCompressorOptions::min_preset; preset <= Compress::LzmaCompressorOptions::max_preset; preset++) {
+        // Keep the memory usage of the larger presets down, the data doesn't need more than that anyway.
+        auto compressor_options = Compress::LzmaCompressorOptions::for_preset(preset);
+        compressor_options.dictionary_size = min(compressor_options.dictionary_size, 512 * KiB);
+
+        size_t compressed_size = 0;
+        auto result = compress_and_decompress(uncompressed, compressor_options, compressed_size);
+        EXPECT_EQ(uncompressed.span(), result.span());
+
+        if (preset == Compress::LzmaCompressorOptions::min_preset)
+            fastest_size = compressed_size;
+        if (preset == Compress::LzmaCompressorOptions::default_preset)
+            default_size = compressed_size;
+    }
+
+    EXPECT(default_size < fastest_size);
+}
+
+// The longest match of at least 4 bytes at every position, or an empty one. Shorter matches are only looked up at
+// their most recent occurrence, so they depend on the search structures rather than the data.
+static Vector<Compress::LzmaMatch> find_longest_matches(Compress::LzmaMatchFinderType type, u32 depth, ReadonlyBytes data, u32 dictionary_size)
+{
+    auto match_finder = MUST(Compress::LzmaMatchFinder::create(type, dictionary_size, 273, depth, 273));
+
+    Vector<Compress::LzmaMatch> longest_matches;
+    size_t written = 0;
+    for (size_t position = 0; position < data.size(); position++) {
+        written += match_finder->write(data.slice(written));
+
+        Compress::LzmaMatch longest {};
+        for (auto match : match_finder->matches()) {
+            EXPECT(match.length > longest.length);
+            EXPECT(match.distance > 0 && match.distance <= min<size_t>(position, dictionary_size));
+            EXPECT_EQ(data.slice(position - match.distance, match.length), data.slice(position, match.length));
+            longest = match;
+        }
+        MUST(longest_matches.try_append(longest.length >= 4 ? longest : Compress::LzmaMatch {}));
+
+        match_finder->advance(1);
+    }
+    return longest_matches;
+}
+
+TEST_CASE(match_finders_agree_on_longest_matches)
+{
+    // A dictionary that is smaller than the data, so matches that are just out of reach get tested as well.
+    auto const data = read_test_data(48 * KiB);
+    u32 const dictionary_size = 8 * KiB;
+    u32 const unlimited_depth = NumericLimits<u32>::max();
+
+    // Without a limit on the search depth, both search structures have to find the longest match everywhere.
+    auto const hash_chain = find_longest_matches(Compress::LzmaMatchFinderType::HashChain4, unlimited_depth, data, dictionary_size);
+    auto const binary_tree = find_longest_matches(Compress::LzmaMatchFinderType::BinaryTree4, unlimited_depth, data, dictionary_size);
+    for (size_t position = 0; position < data.size(); position++)
+        EXPECT_EQ(hash_chain[position].length, binary_tree[position].length);
+
+    // The SearchableCircularBuffer that the compressor used before searches its whole history as well, but it doesn't
+    // find matches that overlap the current position. Its history is only limited to the dictionary size while the
+    // lookahead is full, which is everywhere but at the end.
+    auto buffer = MUST(SearchableCircularBuffer::create_empty(dictionary_size + 273));
+    size_t written = 0;
+    size_t longer_match_count = 0;
+    for (size_t position = 0; position + 273 <= data.size(); position++) {
+        written += buffer.write(data.bytes().slice(written, 273 - buffer.used_space()));
+        VERIFY(buffer.used_space() == 273);
+
+        auto const old_match = buffer.find_copy_in_seekback(273, 4);
+        size_t const old_length = old_match.has_value() && old_match->length >= 4 ? old_match->length : 0;
+        auto const new_match = hash_chain[position];
+        EXPECT(new_match.length >= old_length);
+        if (new_match.length > old_length) {
+            EXPECT(new_match.length > new_match.distance);
+            longer_match_count++;
+        }
+
+        MUST(buffer.discard(1));
+    }
+    EXPECT(longer_match_count > 0);
+}
+
+TEST_CASE(match_finders_with_limited_depth)
+{
+    auto const data = read_test_data(48 * KiB);
+    u32 const dictionary_size = 8 * KiB;
+    auto const longest = find_longest_matches(Compress::LzmaMatchFinderType::BinaryTree4, NumericLimits<u32>::max(), data, dictionary_size);
+
+    // A limited search finds nothing that a full one doesn't, but the tree visits far fewer candidates than the chain
+    // to get to the longest matches.
+    auto const hash_chain = find_longest_matches(Compress::LzmaMatchFinderType::HashChain4, 4, data, dictionary_size);
+    auto const binary_tree = find_longest_matches(Compress::LzmaMatchFinderType::BinaryTree4, 4, data, dictionary_size);
+
+    size_t hash_chain_longest_count = 0;
+    size_t binary_tree_longest_count = 0;
+    for (size_t position = 0; position < data.size(); position++) {
+        EXPECT(hash_chain[position].length <= longest[position].length);
+        EXPECT(binary_tree[position].length <= longest[position].length);
+        hash_chain_longest_count += hash_chain[position].length == longest[position].length;
+        binary_tree_longest_count += binary_tree[position].length == longest[position].length;
+    }
+    EXPECT(binary_tree_longest_count > hash_chain_longest_count);
+}
+
+TEST_CASE(compress_output_does_not_depend_on_write_sizes)
+{
+    auto const uncompressed = read_test_data(100 * KiB);
+
+    for (auto match_finder : { Compress::LzmaMatchFinderType::HashChain4, Compress::LzmaMatchFinderType::BinaryTree4 }) {
+        Compress::LzmaCompressorOptions const compressor_options {
+            .dictionary_size = 16 * KiB,
+            .match_finder = match_finder,
+        };
+
+        size_t expected_size = 0;
+        auto expected = compress_and_decompress(uncompressed, compressor_options, expected_size);
+        EXPECT_EQ(uncompressed.span(), expected.span());
+
+        for (size_t write_size : { 1, 7, 300, 5000 }) {
+            size_t compressed_size = 0;
+            auto result = compress_and_decompress(uncompressed, compressor_options, compressed_size, write_size);
+            EXPECT_EQ(uncompressed.span(), result.span());
+            EXPECT_EQ(compressed_size, expected_size);
+        }
+    }
+}
+
 // The following tests are based on test files from the LZMA specification, which has been placed in the public domain.
 // LZMA Specification Draft (2015): https://www.7-zip.org/a/lzma-specification.7z
 
@@ -6,6 +6,7 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/Endian.h>
 #include <AK/MemoryStream.h>
 #include <LibCompress/Xz.h>
 
@@ -446,6 +447,9 @@ TEST_CASE(xz_utils_bad_1_check_crc32)
     auto decompressor = MUST(Compress::XzDecompressor::create(move(stream)));
     // TODO: We currently don't check the uncompressed data against the check value.
     (void)decompressor->read_until_eof(PAGE_SIZE);
+
+    auto parallel_decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, 1));
+    EXPECT(parallel_decompressor->read_until_eof(PAGE_SIZE).is_error());
 }
 
 TEST_CASE(xz_utils_bad_1_check_crc32_2)
@@ -464,6 +468,9 @@ TEST_CASE(xz_utils_bad_1_check_crc32_2)
     auto decompressor = MUST(Compress::XzDecompressor::create(move(stream)));
     // TODO: We currently don't check the uncompressed data against the check value.
     (void)decompressor->read_until_eof(PAGE_SIZE);
+
+    auto parallel_decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, 1));
+    EXPECT(parallel_decompressor->read_until_eof(PAGE_SIZE).is_error());
 }
 
 TEST_CASE(xz_utils_bad_1_check_crc64)
@@ -481,6 +488,9 @@ TEST_CASE(xz_utils_bad_1_check_crc64)
     auto decompressor = MUST(Compress::XzDecompressor::create(move(stream)));
     // TODO: We currently don't check the uncompressed data against the check value.
     (void)decompressor->read_until_eof(PAGE_SIZE);
+
+    auto parallel_decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, 1));
+    EXPECT(parallel_decompressor->read_until_eof(PAGE_SIZE).is_error());
 }
 
 TEST_CASE(xz_utils_bad_1_check_sha256)
@@ -499,6 +509,9 @@ TEST_CASE(xz_utils_bad_1_check_sha256)
     auto decompressor = MUST(Compress::XzDecompressor::create(move(stream)));
     // TODO: We currently don't check the uncompressed data against the check value.
     (void)decompressor->read_until_eof(PAGE_SIZE);
+
+    auto parallel_decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, 1));
+    EXPECT(parallel_decompressor->read_until_eof(PAGE_SIZE).is_error());
 }
 
 TEST_CASE(xz_utils_bad_1_lzma2_1)
@@ -1553,6 +1566,10 @@ TEST_CASE(xz_utils_good_1_check_crc32)
     auto decompressor = MUST(Compress::XzDecompressor::create(move(stream)));
     auto buffer = TRY_OR_FAIL(decompressor->read_until_eof(PAGE_SIZE));
     EXPECT_EQ(buffer.span(), xz_utils_hello_world.bytes());
+
+    auto parallel_decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, 1));
+    auto parallel_buffer = TRY_OR_FAIL(parallel_decompressor->read_until_eof(PAGE_SIZE));
+    EXPECT_EQ(parallel_buffer.span(), xz_utils_hello_world.bytes());
 }
 
 TEST_CASE(xz_utils_good_1_check_crc64)
@@ -1570,6 +1587,10 @@ TEST_CASE(xz_utils_good_1_check_crc64)
     auto decompressor = MUST(Compress::XzDecompressor::create(move(stream)));
     auto buffer = TRY_OR_FAIL(decompressor->read_until_eof(PAGE_SIZE));
     EXPECT_EQ(buffer.span(), xz_utils_hello_world.bytes());
+
+    auto parallel_decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, 1));
+    auto parallel_buffer = TRY_OR_FAIL(parallel_decompressor->read_until_eof(PAGE_SIZE));
+    EXPECT_EQ(parallel_buffer.span(), xz_utils_hello_world.bytes());
 }
 
 TEST_CASE(xz_utils_good_1_check_none)
@@ -1587,6 +1608,10 @@ TEST_CASE(xz_utils_good_1_check_none)
     auto decompressor = MUST(Compress::XzDecompressor::create(move(stream)));
     auto buffer = TRY_OR_FAIL(decompressor->read_until_eof(PAGE_SIZE));
     EXPECT_EQ(buffer.span(), xz_utils_hello_world.bytes());
+
+    auto parallel_decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, 1));
+    auto parallel_buffer = TRY_OR_FAIL(parallel_decompressor->read_until_eof(PAGE_SIZE));
+    EXPECT_EQ(parallel_buffer.span(), xz_utils_hello_world.bytes());
 }
 
 TEST_CASE(xz_utils_good_1_check_sha256)
@@ -1606,6 +1631,10 @@ TEST_CASE(xz_utils_good_1_check_sha256)
     auto decompressor = MUST(Compress::XzDecompressor::create(move(stream)));
     auto buffer = TRY_OR_FAIL(decompressor->read_until_eof(PAGE_SIZE));
     EXPECT_EQ(buffer.span(), xz_utils_hello_world.bytes());
+
+    auto parallel_decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, 1));
+    auto parallel_buffer = TRY_OR_FAIL(parallel_decompressor->read_until_eof(PAGE_SIZE));
+    EXPECT_EQ(parallel_buffer.span(), xz_utils_hello_world.bytes());
 }
 
 // "good-1-delta-lzma2.tiff.xz is an image file that compresses
@@ -2057,3 +2086,203 @@ TEST_CASE(xz_utils_unsupported_filter_flags_3)
     auto buffer_or_error = decompressor->read_until_eof(PAGE_SIZE);
     EXPECT(buffer_or_error.is_error());
 }
+
+static ByteBuffer xz_test_data(size_t size)
+{
+    // A mix of repetitive text and noise, so that both compressed and uncompressed LZMA2 chunks show up.
+    auto data = MUST(ByteBuffer::create_uninitialized(size));
+    u32 state = 0x12345678;
+    for (size_t i = 0; i < size; i++) {
+        state = state * 1103515245 + 12345;
+        bool const in_noise = (i / 20000) % 3 == 2;
+        data[i] = in_noise ? static_cast<u8>(state >> 16) : "The quick brown fox jumps over the lazy dog. "[(i + (state >> 28)) % 45];
+    }
+    return data;
+}
+
+static ByteBuffer xz_decompress_sequentially(ReadonlyBytes compressed)
+{
+    auto stream = MUST(try_make<FixedMemoryStream>(compressed));
+    auto decompressor = MUST(Compress::XzDecompressor::create(move(stream)));
+    return MUST(decompressor->read_until_eof(PAGE_SIZE));
+}
+
+static ByteBuffer xz_decompress_in_parallel(ReadonlyBytes compressed, size_t thread_count)
+{
+    auto decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, thread_count));
+    auto result = MUST(decompressor->read_until_eof(PAGE_SIZE));
+    EXPECT(decompressor->is_eof());
+    return result;
+}
+
+TEST_CASE(xz_compressor_round_trip)
+{
+    auto const uncompressed = xz_test_data(32 * KiB);
+
+    auto const compressed = MUST(Compress::XzCompressor::compress_all(uncompressed));
+    EXPECT(compressed.size() < uncompressed.size());
+
+    EXPECT_EQ(xz_decompress_sequentially(compressed), uncompressed);
+    EXPECT_EQ(xz_decompress_in_parallel(compressed, 1), uncompressed);
+}
+
+TEST_CASE(xz_compressor_empty_input)
+{
+    auto const compressed = MUST(Compress::XzCompressor::compress_all({}));
+
+    // Stream Header, an Index without Records, and the Stream Footer.
+    EXPECT_EQ(compressed.size(), 12u + 8u + 12u);
+    EXPECT(xz_decompress_sequentially(compressed).is_empty());
+    EXPECT(xz_decompress_in_parallel(compressed, 4).is_empty());
+}
+
+TEST_CASE(xz_compressor_multiple_blocks)
+{
+    auto const uncompressed = xz_test_data(200 * KiB);
+
+    Compress::XzCompressorOptions options {
+        .dictionary_size = 8 * KiB,
+        .block_size = 48 * KiB,
+        .thread_count = 1,
+    };
+    auto const single_threaded = MUST(Compress::XzCompressor::compress_all(uncompressed, options));
+
+    // The blocks don't depend on each other, so neither does the output depend on the number of threads.
+    options.thread_count = 4;
+    auto const multi_threaded = MUST(Compress::XzCompressor::compress_all(uncompressed, options));
+    EXPECT_EQ(single_threaded, multi_threaded);
+
+    EXPECT_EQ(xz_decompress_sequentially(multi_threaded), uncompressed);
+    EXPECT_EQ(xz_decompress_in_parallel(multi_threaded, 1), uncompressed);
+    EXPECT_EQ(xz_decompress_in_parallel(multi_threaded, 3), uncompressed);
+}
+
+TEST_CASE(xz_compressor_incompressible_data)
+{
+    auto uncompressed = MUST(ByteBuffer::create_uninitialized(64 * KiB));
+    u32 state = 1;
+    for (auto& byte : uncompressed.bytes()) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = static_cast<u8>(state);
+    }
+
+    // Stored LZMA2 chunks only add a few bytes of overhead.
+    auto const compressed = MUST(Compress::XzCompressor::compress_all(uncompressed, { .dictionary_size = 16 * KiB }));
+    EXPECT(compressed.size() < uncompressed.size() + 100);
+    EXPECT_EQ(xz_decompress_sequentially(compressed), uncompressed);
+}
+
+TEST_CASE(xz_parallel_decompressor_multiple_streams)
+{
+    // Concatenated streams with Stream Padding in between, as created by the XZ utils test file good-1-check-crc32.xz.
+    auto const first_stream = MUST(Compress::XzCompressor::compress_all("Hello\n"sv.bytes()));
+    auto const second_stream = MUST(Compress::XzCompressor::compress_all("World!\n"sv.bytes()));
+
+    ByteBuffer compressed;
+    compressed.append(first_stream);
+    compressed.append(Array<u8, 8> {}.span());
+    compressed.append(second_stream);
+
+    auto const expected = "Hello\nWorld!\n"sv.bytes();
+    EXPECT_EQ(xz_decompress_sequentially(compressed).bytes(), expected);
+    EXPECT_EQ(xz_decompress_in_parallel(compressed, 2).bytes(), expected);
+}
+
+TEST_CASE(xz_parallel_decompressor_seeking)
+{
+    auto const uncompressed = xz_test_data(40 * KiB);
+
+    Compress::XzCompressorOptions options;
+    options.dictionary_size = 4 * KiB;
+    options.block_size = 8 * KiB;
+    auto const compressed = MUST(Compress::XzCompressor::compress_all(uncompressed, options));
+
+    for (size_t thread_count : { 1, 2 }) {
+        auto decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, thread_count));
+        EXPECT_EQ(MUST(decompressor->size()), uncompressed.size());
+
+        Array<u8, 100> buffer;
+        for (size_t offset : { 30000, 100, 8190, 8192, 8100, 40860, 0 }) {
+            EXPECT_EQ(MUST(decompressor->seek(offset, SeekMode::SetPosition)), offset);
+            EXPECT_EQ(MUST(decompressor->tell()), offset);
+            auto expected_size = min(buffer.size(), uncompressed.size() - offset);
+            MUST(decompressor->read_until_filled(buffer.span().trim(expected_size)));
+            EXPECT_EQ(buffer.span().trim(expected_size), uncompressed.bytes().slice(offset, expected_size));
+            EXPECT_EQ(MUST(decompressor->tell()), offset + expected_size);
+        }
+
+        MUST(decompressor->discard(20000));
+        EXPECT_EQ(MUST(decompressor->tell()), 20100u);
+        auto const rest = MUST(decompressor->read_until_eof(PAGE_SIZE));
+        EXPECT_EQ(rest.bytes(), uncompressed.bytes().slice(20100));
+        EXPECT(decompressor->is_eof());
+        EXPECT(decompressor->seek(1, SeekMode::FromEndPosition).is_error());
+    }
+}
+
+TEST_CASE(xz_parallel_decompressor_rejects_corrupted_check)
+{
+    auto compressed = MUST(Compress::XzCompressor::compress_all("Hello, World!\n"sv.bytes()));
+
+    // The CRC32 of the uncompressed data immediately precedes the Index, which is 8 bytes for a single Block.
+    compressed[compressed.size() - 12 - 8 - 1] ^= 0xFF;
+
+    auto decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, 1));
+    EXPECT(decompressor->read_until_eof(PAGE_SIZE).is_error());
+}
+
+// The CRC32 that XZ uses for its headers and the Index, computed bit by bit.
+static u32 xz_crc32(ReadonlyBytes data)
+{
+    u32 crc = ~0u;
+    for (auto byte : data) {
+        crc ^= byte;
+        for (size_t i = 0; i < 8; i++)
+            crc = (crc >> 1) ^ ((crc & 1) * 0xEDB88320);
+    }
+    return ~crc;
+}
+
+TEST_CASE(xz_parallel_decompressor_rejects_oversized_index_record)
+{
+    // The Stream Header and the only Block of good-1-check-crc64.xz, whose Block Header doesn't store any sizes.
+    Array<u8, 52> const header_and_block {
+        0xFD, 0x37, 0x7A, 0x58, 0x5A, 0x00, 0x00, 0x04, 0xE6, 0xD6, 0xB4, 0x46, 0x02, 0x00, 0x21, 0x01,
+        0x08, 0x00, 0x00, 0x00, 0xD8, 0x0F, 0x23, 0x13, 0x01, 0x00, 0x05, 0x48, 0x65, 0x6C, 0x6C, 0x6F,
+        0x0A, 0x02, 0x00, 0x06, 0x57, 0x6F, 0x72, 0x6C, 0x64, 0x21, 0x0A, 0x00, 0xEF, 0x2E, 0x88, 0x11,
+        0x9D, 0x3F, 0x96, 0xCA
+    };
+
+    // A valid Index that claims the Block decompresses to 1 TiB instead of 13 bytes.
+    ByteBuffer index;
+    index.append(Array<u8, 3> { 0x00, 0x01, 0x28 }.span());
+    u64 value = 1 * TiB;
+    for (; value >= 0x80; value >>= 7)
+        index.append(static_cast<u8>(value | 0x80));
+    index.append(static_cast<u8>(value));
+    while (index.size() % 4 != 0)
+        index.append(0x00);
+    LittleEndian<u32> const index_crc32 = xz_crc32(index);
+    index.append({ &index_crc32, sizeof(index_crc32) });
+
+    LittleEndian<u32> const backward_size = index.size() / 4 - 1;
+    Array<u8, 2> const stream_flags { 0x00, 0x04 };
+    Array<u8, 6> footer_crc32_input;
+    ReadonlyBytes { &backward_size, sizeof(backward_size) }.copy_to(footer_crc32_input);
+    stream_flags.span().copy_to(footer_crc32_input.span().slice(4));
+    LittleEndian<u32> const footer_crc32 = xz_crc32(footer_crc32_input);
+
+    ByteBuffer compressed;
+    compressed.append(header_and_block.span());
+    compressed.append(index);
+    compressed.append({ &footer_crc32, sizeof(footer_crc32) });
+    compressed.append({ &backward_size, sizeof(backward_size) });
+    compressed.append(stream_flags.span());
+    compressed.append("YZ"sv.bytes());
+
+    auto decompressor = MUST(Compress::XzParallelDecompressor::create(compressed, 1));
+    EXPECT_EQ(MUST(decompressor->size()), 1 * TiB);
+    EXPECT(decompressor->read_until_eof(PAGE_SIZE).is_error());
+}
@@ -8,6 +8,8 @@
 
 #include <AK/Array.h>
 #include <AK/MemoryStream.h>
+#include <AK/Random.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
 
 TEST_CASE(zlib_decompress_simple)
@@ -81,3 +83,17 @@ TEST_CASE(zlib_decompress_with_missing_end_bits)
     auto decompressed = TRY_OR_FAIL(decompressor->read_until_eof());
     EXPECT_EQ(decompressed.span(), uncompressed.span());
 }
+
+TEST_CASE(zlib_round_trip_parallel)
+{
+    auto original = ByteBuffer::create_zeroed(Compress::DeflateCompressor::parallel_chunk_size * 3 + 100).release_value();
+    fill_with_random(original.bytes().trim(original.size() / 2));
+    auto compressed = TRY_OR_FAIL(Compress::ZlibCompressor::compress_all(original, Compress::ZlibCompressionLevel::Default, 4));
+    auto decompressor = TRY_OR_FAIL(Compress::ZlibDecompressor::create(make<FixedMemoryStream>(compressed.bytes())));
+    auto uncompressed = TRY_OR_FAIL(decompressor->read_until_eof());
+    EXPECT(uncompressed == original);
+
+    // The Adler-32 checksum, which is combined from the checksums of the chunks, must match that of the whole input.
+    auto compressed_serially = TRY_OR_FAIL(Compress::ZlibCompressor::compress_all(original, Compress::ZlibCompressionLevel::Default));
+    EXPECT_EQ(compressed.bytes().slice(compressed.size() - 4), compressed_serially.bytes().slice(compressed_serially.size() - 4));
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/MemoryStream.h>
+#include <AK/Random.h>
+#include <LibCompress/Zstd.h>
+#include <LibCore/File.h>
+
+static ByteBuffer read_test_file(StringView file_name)
+{
+    // This makes sure that the tests will run both on target and in Lagom.
+#ifdef AK_OS_SERENITY
+    ByteString path = ByteString::formatted("/usr/Tests/LibCompress/zstd-test-files/{}", file_name);
+#else
+    ByteString path = ByteString::formatted("zstd-test-files/{}", file_name);
+#endif
+
+    auto file = MUST(Core::File::open(path, Core::File::OpenMode::Read));
+    return MUST(file->read_until_eof());
+}
+
+static void run_test(StringView file_name)
+{
+    auto original = read_test_file(file_name);
+    auto compressed = read_test_file(ByteString::formatted("{}.zst", file_name));
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed));
+    EXPECT_EQ(decompressed, original);
+}
+
+// "Hello, Zstandard!", as a single raw block with a content checksum.
+static constexpr Array<u8, 30> hello_frame {
+    0x28, 0xB5, 0x2F, 0xFD, // Magic_Number
+    0x04,                   // Frame_Header_Descriptor (Content_Checksum_flag)
+    0x58,                   // Window_Descriptor
+    0x89, 0x00, 0x00,       // Block_Header (Last_Block, Raw_Block, Block_Size 17)
+    0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x2C, 0x20, 0x5A, 0x73, 0x74, 0x61, 0x6E, 0x64, 0x61, 0x72, 0x64, 0x21,
+    0xAC, 0xE5, 0xE4, 0xBF, // Content_Checksum
+};
+
+TEST_CASE(zstd_decompress_raw_block)
+{
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(hello_frame));
+    EXPECT_EQ(decompressed.bytes(), "Hello, Zstandard!"sv.bytes());
+}
+
+TEST_CASE(zstd_decompress_huffman_literals_and_sequences)
+{
+    run_test("lorem.txt"sv);
+    run_test("serenityos.html"sv);
+}
+
+TEST_CASE(zstd_decompress_skippable_and_concatenated_frames)
+{
+    Array<u8, 11> const skippable_frame { 0x5A, 0x2A, 0x4D, 0x18, 0x03, 0x00, 0x00, 0x00, 'x', 'y', 'z' };
+
+    ByteBuffer input;
+    input.append(skippable_frame);
+    input.append(hello_frame);
+    input.append(skippable_frame);
+    input.append(hello_frame);
+    input.append(skippable_frame);
+
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(input));
+    EXPECT_EQ(decompressed.bytes(), "Hello, Zstandard!Hello, Zstandard!"sv.bytes());
+}
+
+TEST_CASE(zstd_decompress_checksum_mismatch)
+{
+    auto input = MUST(ByteBuffer::copy(hello_frame));
+    input[input.size() - 1] ^= 1;
+    EXPECT(Compress::ZstdDecompressor::decompress_all(input).is_error());
+}
+
+TEST_CASE(zstd_decompress_truncated_frame)
+{
+    for (size_t size = 1; size < hello_frame.size(); ++size)
+        EXPECT(Compress::ZstdDecompressor::decompress_all(hello_frame.span().trim(size)).is_error());
+}
+
+TEST_CASE(zstd_decompress_with_raw_content_dictionary)
+{
+    // "consectetur adipiscing elit, Lorem ipsum dolor sit amet", which is made up of two matches into the dictionary.
+    Array<u8, 27> const compressed {
+        0x28, 0xB5, 0x2F, 0xFD, 0x24, 0x37, 0x75, 0x00, 0x00, 0x28, 0x63, 0x2C, 0x20, 0x4C,
+        0x6F, 0x02, 0x00, 0x57, 0x00, 0xC9, 0xED, 0x79, 0x05, 0x17, 0x2D, 0x02, 0xA5
+    };
+    auto dictionary = "Lorem ipsum dolor sit amet, consectetur adipiscing elit"sv;
+
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed, dictionary.bytes()));
+    EXPECT_EQ(decompressed.bytes(), "consectetur adipiscing elit, Lorem ipsum dolor sit amet"sv.bytes());
+
+    EXPECT(Compress::ZstdDecompressor::decompress_all(compressed).is_error());
+}
+
+TEST_CASE(zstd_decompress_with_formatted_dictionary)
+{
+    auto dictionary = read_test_file("js-headers.dict"sv);
+    auto original = read_test_file("Array.h"sv);
+    auto compressed = read_test_file("Array.h.zst"sv);
+
+    auto decompressed = TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed, dictionary));
+    EXPECT_EQ(decompressed, original);
+
+    // The frame names the dictionary it was compressed with.
+    EXPECT(Compress::ZstdDecompressor::decompress_all(compressed).is_error());
+}
+
+TEST_CASE(zstd_round_trip_levels)
+{
+    auto original = read_test_file("serenityos.html"sv);
+    for (u8 level : { 1, 3, 5, 9, 19 }) {
+        auto compressed = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(original, level));
+        EXPECT(compressed.size() < original.size() / 2);
+        EXPECT_EQ(TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed)), original);
+    }
+}
+
+TEST_CASE(zstd_round_trip_rle)
+{
+    // A run of the same byte that spans several blocks is stored as RLE blocks of a few bytes each.
+    auto original = MUST(ByteBuffer::create_uninitialized(3 * Compress::ZstdCompressor::max_block_size + 17));
+    original.bytes().fill('z');
+    auto compressed = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(original));
+    EXPECT(compressed.size() < 32);
+    EXPECT_EQ(TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed)), original);
+}
+
+// lorem.txt 300 times over, each copy prefixed with its five-digit index. At 251 KiB, that is more than one block.
+static ByteBuffer numbered_lorem()
+{
+    auto lorem = read_test_file("lorem.txt"sv);
+    ByteBuffer result;
+    for (size_t i = 0; i < 300; ++i) {
+        auto prefix = ByteString::formatted("{:05} ", i);
+        result.append(prefix.bytes());
+        result.append(lorem);
+    }
+    return result;
+}
+
+static ByteBuffer decompress_in_small_reads(ReadonlyBytes compressed)
+{
+    // Small reads exercise the decompressor's history compaction between reads.
+    auto input_stream = make<FixedMemoryStream>(compressed);
+    auto decompressor = MUST(Compress::ZstdDecompressor::create(MaybeOwned<Stream>(move(input_stream))));
+    ByteBuffer decompressed;
+    Array<u8, 1000> buffer;
+    while (!decompressor->is_eof())
+        decompressed.append(MUST(decompressor->read_some(buffer)));
+    return decompressed;
+}
+
+TEST_CASE(zstd_decompress_reference_multiple_blocks)
+{
+    // Created with `zstd -1 --no-check`, `zstd -19` and `zstd --no-content-size` respectively. The first two are
+    // single-segment frames with a content size, the last one has a Window_Descriptor instead.
+    auto original = numbered_lorem();
+    for (auto file_name : { "numbered-lorem-level-1-no-check.zst"sv, "numbered-lorem-level-19.zst"sv, "numbered-lorem-no-content-size.zst"sv }) {
+        auto compressed = read_test_file(file_name);
+        EXPECT_EQ(TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed)), original);
+        EXPECT_EQ(decompress_in_small_reads(compressed), original);
+    }
+}
+
+TEST_CASE(zstd_compress_frame_structure)
+{
+    auto original = numbered_lorem();
+    for (u8 window_log : { 10, 17, 20 }) {
+        auto output_stream = make<AllocatingMemoryStream>();
+        auto zstd_stream = TRY_OR_FAIL(Compress::ZstdCompressor::construct(MaybeOwned<Stream>(*output_stream), 6, window_log));
+        TRY_OR_FAIL(zstd_stream->write_until_depleted(original));
+        TRY_OR_FAIL(zstd_stream->final_flush());
+        auto compressed = MUST(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+        TRY_OR_FAIL(output_stream->read_until_filled(compressed));
+
+        FixedMemoryStream stream { compressed.bytes() };
+        EXPECT_EQ(MUST(stream.read_value<LittleEndian<u32>>()), 0xFD2FB528u);
+
+        // Frame_Header_Descriptor: only the Content_Checksum_flag, so there is a Window_Descriptor and no content
+        // size or dictionary ID.
+        EXPECT_EQ(MUST(stream.read_value<u8>()), 0x04);
+        EXPECT_EQ(MUST(stream.read_value<u8>()), (window_log - 10) << 3);
+
+        // "Block_Size is limited by Block_Maximum_Size, which is the smallest of Window_Size and 128 KiB."
+        size_t const block_maximum_size = min(1u << window_log, Compress::ZstdCompressor::max_block_size);
+        size_t block_count = 0;
+        for (bool last_block = false; !last_block; ++block_count) {
+            u8 header_bytes[3];
+            MUST(stream.read_until_filled({ header_bytes, sizeof(header_bytes) }));
+            u32 header = header_bytes[0] | header_bytes[1] << 8 | header_bytes[2] << 16;
+            last_block = header & 1;
+            auto block_type = (header >> 1) & 3;
+            size_t block_size = header >> 3;
+
+            EXPECT_NE(block_type, 3u);
+            EXPECT(block_size <= block_maximum_size);
+            MUST(stream.discard(block_type == 1 ? 1 : block_size));
+        }
+        EXPECT(block_count >= original.size() / block_maximum_size);
+
+        // Content_Checksum: the same as the one that the zstd CLI wrote for the same content.
+        auto reference = read_test_file("numbered-lorem-level-19.zst"sv);
+        EXPECT_EQ(MUST(stream.read_value<LittleEndian<u32>>()), MUST(FixedMemoryStream { reference.bytes().slice(reference.size() - 4) }.read_value<LittleEndian<u32>>()));
+        EXPECT(stream.is_eof());
+
+        EXPECT_EQ(TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(compressed)), original);
+    }
+}
+
+TEST_CASE(zstd_compress_compared_to_reference)
+{
+    // The reference files were created by the zstd CLI at level 19, with content size and checksum. Our frames have
+    // a checksum but no content size, which evens out with the single byte Window_Descriptor.
+    for (auto file_name : { "lorem.txt"sv, "serenityos.html"sv }) {
+        auto original = read_test_file(file_name);
+        auto reference = read_test_file(ByteString::formatted("{}.zst", file_name));
+        auto compressed = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(original, Compress::ZstdCompressor::max_level));
+        EXPECT(compressed.size() <= reference.size() * 6 / 5);
+    }
+
+    auto original = numbered_lorem();
+    auto reference = read_test_file("numbered-lorem-level-19.zst"sv);
+    auto compressed = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(original, Compress::ZstdCompressor::max_level));
+    EXPECT(compressed.size() <= reference.size() * 6 / 5);
+}
+
+TEST_CASE(zstd_compress_between_skippable_frames)
+{
+    auto first = read_test_file("lorem.txt"sv);
+    auto second = read_test_file("serenityos.html"sv);
+
+    // "Skippable frames [...] Magic_Number: 0x184D2A5?, which means any value from 0x184D2A50 to 0x184D2A5F."
+    ByteBuffer input;
+    for (u8 nibble = 0; nibble < 16; ++nibble) {
+        input.append(Array<u8, 4> { static_cast<u8>(0x50 | nibble), 0x2A, 0x4D, 0x18 }.span());
+        input.append(Array<u8, 4> { nibble, 0, 0, 0 }.span());
+        for (u8 i = 0; i < nibble; ++i)
+            input.append(0xFF);
+
+        if (nibble == 3)
+            input.append(TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(first)));
+        if (nibble == 11)
+            input.append(TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(second, 1)));
+    }
+
+    ByteBuffer expected;
+    expected.append(first);
+    expected.append(second);
+    EXPECT_EQ(TRY_OR_FAIL(Compress::ZstdDecompressor::decompress_all(input)), expected);
+    EXPECT_EQ(decompress_in_small_reads(input), expected);
+
+    // A skippable frame that claims to be larger than what is left is truncated.
+    input.append(Array<u8, 9> { 0x50, 0x2A, 0x4D, 0x18, 0x02, 0x00, 0x00, 0x00, 0xFF }.span());
+    EXPECT(Compress::ZstdDecompressor::decompress_all(input).is_error());
+}
+
+TEST_CASE(zstd_compress_checksum_covers_every_block)
+{
+    // The checksum covers the content of all blocks, so damaging any of them has to be noticed. Raw blocks are the
+    // easiest to damage without also breaking the block structure.
+    auto original = MUST(ByteBuffer::create_uninitialized(2 * Compress::ZstdCompressor::max_block_size + 100));
+    fill_with_random(original);
+    auto compressed = TRY_OR_FAIL(Compress::ZstdCompressor::compress_all(original));
+
+    // Magic_Number, Frame_Header_Descriptor and Window_Descriptor, then three raw blocks.
+    size_t const frame_header_size = 4 + 1 + 1;
+    EXPECT_EQ(compressed.size(), frame_header_size + 3 * 3 + original.size() + 4);
+
+    for (size_t block = 0; block < 3; ++block) {
+        auto damaged = MUST(ByteBuffer::copy(compressed));
+        damaged[frame_header_size + (block + 1) * 3 + block * Compress::ZstdCompressor::max_block_size + 50] ^= 1;
+        EXPECT(Compress::ZstdDecompressor::decompress_all(damaged).is_error());
+    }
+
+    for (size_t byte = 1; byte <= 4; ++byte) {
+        auto damaged = MUST(ByteBuffer::copy(compressed));
+        damaged[damaged.size() - byte] ^= 0x80;
+        EXPECT(Compress::ZstdDecompressor::decompress_all(damaged).is_error());
+    }
+}
@@ -5,6 +5,7 @@
  */
 
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
+#include <LibCrypto/Authentication/GHash.h>
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Cipher/AES.h>
 #include <LibTest/TestCase.h>
@@ -454,3 +455,122 @@ TEST_CASE(test_AES_GCM_128bit_decrypt_multiple_blocks_with_aad)
     EXPECT(memcmp(result_pt, out.data(), out.size()) == 0);
     EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
 }
+
+static ByteBuffer make_test_data(size_t size)
+{
+    auto buffer = ByteBuffer::create_uninitialized(size).release_value();
+    for (size_t i = 0; i < size; ++i)
+        buffer[i] = static_cast<u8>((i * 131) ^ (i >> 8));
+    return buffer;
+}
+
+TEST_CASE(test_AES_CTR_matches_single_block_encryption)
+{
+    // The counter mode encrypts batches of blocks at once; make sure that agrees with encrypting the counter one block at a time.
+    auto key = "\x2b\x7e\x15\x16\x28\xae\xd2\xa6\xab\xf7\x15\x88\x09\xcf\x4f\x3c"_b;
+    Crypto::Cipher::AESCipher::CTRMode cipher(key, 128, Crypto::Cipher::Intent::Encryption);
+    Crypto::Cipher::AESCipher block_cipher(key, 128);
+
+    auto in = make_test_data(16 * 21 + 5);
+    auto out = ByteBuffer::create_uninitialized(in.size()).release_value();
+    auto out_bytes = out.bytes();
+    u8 iv[16] { 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe };
+    cipher.encrypt(in, out_bytes, { iv, 16 });
+
+    Crypto::Cipher::IncrementInplace increment;
+    Bytes counter { iv, 16 };
+    for (size_t offset = 0; offset < in.size(); offset += 16) {
+        Crypto::Cipher::AESCipherBlock block(counter.data(), 16);
+        block_cipher.encrypt_block(block, block);
+        for (size_t i = 0; i < 16 && offset + i < in.size(); ++i)
+            EXPECT_EQ(out[offset + i], in[offset + i] ^ block.bytes()[i]);
+        increment(counter);
+    }
+}
+
+TEST_CASE(test_GHash_matches_generic_implementation)
+{
+    auto key = "\x66\xe9\x4b\xd4\xef\x8a\x2c\x3b\x88\x4c\xfa\x59\xca\x34\x2b\x2e"_b;
+    u32 key_words[4];
+    for (size_t i = 0; i < 4; ++i)
+        key_words[i] = AK::convert_between_host_and_big_endian(ByteReader::load32(key.offset(i * 4)));
+
+    auto data = make_test_data(300);
+
+    for (size_t aad_size : { 0, 13, 64 }) {
+        for (size_t size = 0; size <= 200; size += 7) {
+            auto aad = data.bytes().slice(100, aad_size);
+            auto message = data.bytes().slice(0, size);
+
+            u32 expected[4] { 0, 0, 0, 0 };
+            auto update = [&](ReadonlyBytes bytes) {
+                for (size_t offset = 0; offset < bytes.size(); offset += 16) {
+                    u8 block[16] {};
+                    bytes.slice(offset, min<size_t>(16, bytes.size() - offset)).copy_to(Bytes { block, 16 });
+                    for (size_t i = 0; i < 4; ++i)
+                        expected[i] ^= AK::convert_between_host_and_big_endian(ByteReader::load32(block + i * 4));
+                    Crypto::Authentication::galois_multiply(expected, key_words, expected);
+                }
+            };
+            update(aad);
+            update(message);
+            u64 aad_bits = aad.size() * 8;
+            u64 message_bits = message.size() * 8;
+            expected[0] ^= aad_bits >> 32;
+            expected[1] ^= aad_bits & 0xffffffff;
+            expected[2] ^= message_bits >> 32;
+            expected[3] ^= message_bits & 0xffffffff;
+            Crypto::Authentication::galois_multiply(expected, key_words, expected);
+
+            auto tag = Crypto::Authentication::GHash(key).process(aad, message);
+            for (size_t i = 0; i < 4; ++i)
+                EXPECT_EQ(AK::convert_between_host_and_big_endian(ByteReader::load32(tag.data + i * 4)), expected[i]);
+        }
+    }
+}
+
+TEST_CASE(test_AES_GCM_long_message_roundtrip)
+{
+    Crypto::Cipher::AESCipher::GCMMode cipher("\xfe\xff\xe9\x92\x86\x65\x73\x1c\x6d\x6a\x8f\x94\x67\x30\x83\x08\xfe\xff\xe9\x92\x86\x65\x73\x1c"_b, 192, Crypto::Cipher::Intent::Encryption);
+    auto iv = "\xca\xfe\xba\xbe\xfa\xce\xdb\xad\xde\xca\xf8\x88\x00\x00\x00\x00"_b;
+    auto aad = "\xde\xad\xbe\xef\xfa\xaf\x11\xcc"_b;
+
+    auto plaintext = make_test_data(4099);
+    auto ciphertext = ByteBuffer::create_uninitialized(plaintext.size()).release_value();
+    auto tag = ByteBuffer::create_uninitialized(16).release_value();
+    cipher.encrypt(plaintext, ciphertext.bytes(), iv, aad, tag);
+
+    auto decrypted = ByteBuffer::create_uninitialized(plaintext.size()).release_value();
+    auto consistency = cipher.decrypt(ciphertext, decrypted.bytes(), iv, aad, tag);
+    EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
+    EXPECT_EQ(decrypted, plaintext);
+
+    ciphertext[1234] ^= 1;
+    consistency = cipher.decrypt(ciphertext, decrypted.bytes(), iv, aad, tag);
+    EXPECT_EQ(consistency, Crypto::VerificationConsistency::Inconsistent);
+}
+
+BENCHMARK_CASE(benchmark_AES_CTR_throughput)
+{
+    Crypto::Cipher::AESCipher::CTRMode cipher("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
+    auto in = make_test_data(1 * MiB);
+    auto out = ByteBuffer::create_uninitialized(in.size()).release_value();
+    auto out_bytes = out.bytes();
+    auto iv = ByteBuffer::create_zeroed(16).release_value();
+
+    for (size_t i = 0; i < 32; ++i)
+        cipher.encrypt(in, out_bytes, iv);
+}
+
+BENCHMARK_CASE(benchmark_AES_GCM_throughput)
+{
+    Crypto::Cipher::AESCipher::GCMMode cipher("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
+    auto in = make_test_data(16 * KiB);
+    auto out = ByteBuffer::create_uninitialized(in.size()).release_value();
+    auto tag = ByteBuffer::create_uninitialized(16).release_value();
+    auto iv = ByteBuffer::create_zeroed(16).release_value();
+
+    // Roughly 32 MiB worth of maximum-size TLS records.
+    for (size_t i = 0; i < 2048; ++i)
+        cipher.encrypt(in, out.bytes(), iv, {}, tag);
+}
@@ -35,6 +35,16 @@ static Crypto::SignedBigInteger bigint_signed_fibonacci(size_t n)
     return num1;
 }
 
+static Crypto::UnsignedBigInteger bigint_from_seed(size_t word_count, u32 seed)
+{
+    Vector<u32, Crypto::STARTING_WORD_SIZE> words;
+    for (size_t i = 0; i < word_count; ++i) {
+        seed = seed * 1664525 + 1013904223;
+        words.append(seed);
+    }
+    return Crypto::UnsignedBigInteger { move(words) };
+}
+
 TEST_CASE(test_bigint_fib500)
 {
     Vector<u32> result {
@@ -201,6 +211,36 @@ TEST_CASE(test_unsigned_bigint_multiplication_with_big_numbers2)
     EXPECT_EQ(result.words(), expected_result);
 }
 
+TEST_CASE(test_unsigned_bigint_karatsuba_multiplication)
+{
+    // Multiply one word at a time, which never takes the Karatsuba path, and compare against the full product.
+    auto multiply_by_words = [](Crypto::UnsignedBigInteger const& left, Crypto::UnsignedBigInteger const& right) {
+        Crypto::UnsignedBigInteger result { 0 };
+        for (size_t i = 0; i < right.length(); ++i) {
+            auto partial_product = left.multiplied_by(Crypto::UnsignedBigInteger { right.words()[i] });
+            result = result.plus(partial_product.shift_left(i * Crypto::UnsignedBigInteger::BITS_IN_WORD));
+        }
+        return result;
+    };
+
+    struct {
+        size_t left_size;
+        size_t right_size;
+    } sizes[] = { { 39, 39 }, { 40, 40 }, { 64, 64 }, { 97, 97 }, { 256, 256 }, { 300, 41 }, { 200, 130 }, { 1000, 333 } };
+
+    for (auto [left_size, right_size] : sizes) {
+        auto left = bigint_from_seed(left_size, left_size);
+        auto right = bigint_from_seed(right_size, right_size + 1);
+        auto expected = multiply_by_words(left, right);
+        EXPECT_EQ(left.multiplied_by(right), expected);
+        EXPECT_EQ(right.multiplied_by(left), expected);
+    }
+
+    // All-ones words produce the largest possible carries everywhere.
+    auto all_ones = Crypto::UnsignedBigInteger { 1 }.shift_left(150 * Crypto::UnsignedBigInteger::BITS_IN_WORD).minus(1);
+    EXPECT_EQ(all_ones.multiplied_by(all_ones), multiply_by_words(all_ones, all_ones));
+}
+
 TEST_CASE(test_unsigned_bigint_simple_division)
 {
     Crypto::UnsignedBigInteger num1(27194);
@@ -335,6 +375,60 @@ TEST_CASE(test_bigint_modular_power_extra_tests)
     }
 }
 
+TEST_CASE(test_bigint_montgomery_modular_power_matches_generic_algorithm)
+{
+    struct {
+        size_t modulo_size;
+        size_t exponent_size;
+    } sizes[] = { { 2, 1 }, { 4, 3 }, { 16, 8 }, { 32, 32 }, { 64, 64 } };
+
+    for (auto [modulo_size, exponent_size] : sizes) {
+        auto base = bigint_from_seed(modulo_size + 1, 1);
+        auto exponent = bigint_from_seed(exponent_size, 2);
+        auto modulo = bigint_from_seed(modulo_size, 3);
+        modulo.set_bit_inplace(0);
+
+        auto actual = Crypto::NumberTheory::ModularPower(base, exponent, modulo);
+
+        auto ep = exponent;
+        auto reduced_base = base;
+        Crypto::UnsignedBigInteger temp_1, temp_multiply, temp_quotient, temp_remainder, expected;
+        Crypto::UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(ep, reduced_base, modulo, temp_1, temp_multiply, temp_quotient, temp_remainder, expected);
+
+        EXPECT_EQ(actual, expected);
+    }
+}
+
+TEST_CASE(test_bigint_modular_power_fermat_little_theorem)
+{
+    // 2^521 - 1 is prime, so a^(p - 1) = 1 (mod p) for any a that's not a multiple of p.
+    auto prime = Crypto::UnsignedBigInteger { 1 }.shift_left(521).minus(1);
+    auto exponent = prime.minus(1);
+    for (u32 seed : { 1, 2, 3 }) {
+        auto base = bigint_from_seed(10, seed);
+        EXPECT_EQ(Crypto::NumberTheory::ModularPower(base, exponent, prime), 1);
+        EXPECT_EQ(Crypto::NumberTheory::ModularPower(base, prime, prime), base);
+    }
+}
+
+BENCHMARK_CASE(benchmark_bigint_modular_power_2048)
+{
+    auto base = bigint_from_seed(64, 1);
+    auto exponent = bigint_from_seed(64, 2);
+    auto modulo = bigint_from_seed(64, 3);
+    modulo.set_bit_inplace(0);
+    for (size_t i = 0; i < 10; ++i)
+        (void)Crypto::NumberTheory::ModularPower(base, exponent, modulo);
+}
+
+BENCHMARK_CASE(benchmark_bigint_multiplication_large)
+{
+    auto left = bigint_from_seed(2000, 1);
+    auto right = bigint_from_seed(2000, 2);
+    for (size_t i = 0; i < 20; ++i)
+        (void)left.multiplied_by(right);
+}
+
 TEST_CASE(test_bigint_primality_test)
 {
     struct {
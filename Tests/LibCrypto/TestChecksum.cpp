@@ -6,6 +6,8 @@
 
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
+#include <LibCrypto/Checksum/CRC64.h>
+#include <LibCrypto/Checksum/XXHash64.h>
 #include <LibCrypto/Checksum/cksum.h>
 #include <LibTest/TestCase.h>
 
@@ -63,3 +65,175 @@ TEST_CASE(test_crc32)
     do_test("The quick brown fox jumps over the lazy dog"sv.bytes(), 0x414FA339);
     do_test("various CRC algorithms input data"sv.bytes(), 0x9BD366AE);
 }
+
+static ByteBuffer make_checksum_test_data(size_t size)
+{
+    auto buffer = MUST(ByteBuffer::create_uninitialized(size));
+    u32 state = 0x12345678;
+    for (auto& byte : buffer.bytes()) {
+        state = state * 1103515245 + 12345;
+        byte = static_cast<u8>(state >> 16);
+    }
+    return buffer;
+}
+
+TEST_CASE(test_crc32_matches_bitwise_implementation)
+{
+    auto reference_crc32 = [](ReadonlyBytes input) {
+        u32 state = ~0u;
+        for (auto byte : input) {
+            state ^= byte;
+            for (size_t i = 0; i < 8; ++i)
+                state = (state >> 1) ^ ((state & 1) * 0xEDB88320);
+        }
+        return ~state;
+    };
+
+    auto data = make_checksum_test_data(5000);
+    for (size_t offset : { 0, 1, 3, 7 }) {
+        for (size_t length : { 0, 1, 15, 16, 17, 63, 64, 65, 127, 128, 129, 255, 1000, 4096 }) {
+            auto input = data.bytes().slice(offset, length);
+            EXPECT_EQ(Crypto::Checksum::CRC32(input).digest(), reference_crc32(input));
+        }
+    }
+
+    // Splitting the input must not change the result, whichever implementation handles each piece.
+    Crypto::Checksum::CRC32 crc32;
+    crc32.update(data.bytes().slice(0, 100));
+    crc32.update(data.bytes().slice(100, 3));
+    crc32.update(data.bytes().slice(103));
+    EXPECT_EQ(crc32.digest(), reference_crc32(data.bytes()));
+}
+
+TEST_CASE(test_crc32_combine)
+{
+    auto data = make_checksum_test_data(5000);
+    for (size_t split : { 0, 1, 17, 64, 2500, 4999, 5000 }) {
+        auto first = Crypto::Checksum::CRC32(data.bytes().trim(split)).digest();
+        auto second = Crypto::Checksum::CRC32(data.bytes().slice(split)).digest();
+        EXPECT_EQ(Crypto::Checksum::CRC32::combine(first, second, data.size() - split), Crypto::Checksum::CRC32(data.bytes()).digest());
+    }
+}
+
+TEST_CASE(test_crc64)
+{
+    auto do_test = [](ReadonlyBytes input, u64 expected_result) {
+        auto digest = Crypto::Checksum::CRC64(input).digest();
+        EXPECT_EQ(digest, expected_result);
+    };
+
+    do_test(""sv.bytes(), 0x0);
+    do_test("123456789"sv.bytes(), 0x995DC9BBDF1939FA);
+    do_test("The quick brown fox jumps over the lazy dog"sv.bytes(), 0x5B5EB8C2E54AA1C4);
+}
+
+TEST_CASE(test_crc64_matches_bitwise_implementation)
+{
+    auto reference_crc64 = [](ReadonlyBytes input) {
+        u64 state = ~0ull;
+        for (auto byte : input) {
+            state ^= byte;
+            for (size_t i = 0; i < 8; ++i)
+                state = (state >> 1) ^ ((state & 1) * 0xC96C5795D7870F42);
+        }
+        return ~state;
+    };
+
+    auto data = make_checksum_test_data(5000);
+    for (size_t offset : { 0, 1, 3, 7 }) {
+        for (size_t length : { 0, 1, 7, 8, 9, 15, 16, 17, 1000, 4096 }) {
+            auto input = data.bytes().slice(offset, length);
+            EXPECT_EQ(Crypto::Checksum::CRC64(input).digest(), reference_crc64(input));
+        }
+    }
+
+    Crypto::Checksum::CRC64 crc64;
+    crc64.update(data.bytes().slice(0, 100));
+    crc64.update(data.bytes().slice(100, 3));
+    crc64.update(data.bytes().slice(103));
+    EXPECT_EQ(crc64.digest(), reference_crc64(data.bytes()));
+}
+
+TEST_CASE(test_adler32_matches_bytewise_implementation)
+{
+    auto reference_adler32 = [](ReadonlyBytes input) {
+        u32 a = 1;
+        u32 b = 0;
+        for (auto byte : input) {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        return (b << 16) | a;
+    };
+
+    auto data = make_checksum_test_data(20000);
+    for (size_t offset : { 0, 1, 5 }) {
+        for (size_t length : { 0, 1, 31, 32, 33, 100, 5551, 5552, 5553, 5600, 11104, 19000 }) {
+            auto input = data.bytes().slice(offset, length);
+            EXPECT_EQ(Crypto::Checksum::Adler32(input).digest(), reference_adler32(input));
+        }
+    }
+
+    // Make sure the deferred reductions cannot overflow with the worst-case input.
+    auto all_ones = MUST(ByteBuffer::create_uninitialized(100000));
+    all_ones.bytes().fill(0xff);
+    EXPECT_EQ(Crypto::Checksum::Adler32(all_ones).digest(), reference_adler32(all_ones));
+
+    Crypto::Checksum::Adler32 adler32;
+    adler32.update(data.bytes().slice(0, 7000));
+    adler32.update(data.bytes().slice(7000, 1));
+    adler32.update(data.bytes().slice(7001));
+    EXPECT_EQ(adler32.digest(), reference_adler32(data.bytes()));
+}
+
+TEST_CASE(test_adler32_combine)
+{
+    auto data = make_checksum_test_data(20000);
+    for (size_t split : { 0, 1, 5552, 10000, 19999, 20000 }) {
+        auto first = Crypto::Checksum::Adler32(data.bytes().trim(split)).digest();
+        auto second = Crypto::Checksum::Adler32(data.bytes().slice(split)).digest();
+        EXPECT_EQ(Crypto::Checksum::Adler32::combine(first, second, data.size() - split), Crypto::Checksum::Adler32(data.bytes()).digest());
+    }
+}
+
+TEST_CASE(test_xxhash64)
+{
+    auto do_test = [](ReadonlyBytes input, u64 expected_result) {
+        auto digest = Crypto::Checksum::XXHash64(input).digest();
+        EXPECT_EQ(digest, expected_result);
+    };
+
+    do_test(""sv.bytes(), 0xEF46DB3751D8E999);
+    do_test("a"sv.bytes(), 0xD24EC4F1A98C6E5B);
+    do_test("abc"sv.bytes(), 0x44BC2CF5AD770999);
+}
+
+TEST_CASE(test_xxhash64_incremental_update)
+{
+    auto data = make_checksum_test_data(1000);
+    auto expected = Crypto::Checksum::XXHash64(data.bytes()).digest();
+    for (size_t chunk_size : { 1, 7, 31, 32, 33, 100 }) {
+        Crypto::Checksum::XXHash64 xxhash64;
+        for (size_t offset = 0; offset < data.size(); offset += chunk_size)
+            xxhash64.update(data.bytes().slice(offset, min(chunk_size, data.size() - offset)));
+        EXPECT_EQ(xxhash64.digest(), expected);
+    }
+}
+
+BENCHMARK_CASE(benchmark_crc32)
+{
+    auto data = make_checksum_test_data(1 * MiB);
+    Crypto::Checksum::CRC32 crc32;
+    for (size_t i = 0; i < 256; ++i)
+        crc32.update(data);
+    EXPECT_NE(crc32.digest(), 0u);
+}
+
+BENCHMARK_CASE(benchmark_adler32)
+{
+    auto data = make_checksum_test_data(1 * MiB);
+    Crypto::Checksum::Adler32 adler32;
+    for (size_t i = 0; i < 256; ++i)
+        adler32.update(data);
+    EXPECT_NE(adler32.digest(), 0u);
+}
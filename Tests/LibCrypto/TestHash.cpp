@@ -208,6 +208,27 @@ TEST_CASE(test_SHA1_hash_split_into_blocks)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA1_hash_million_a)
+{
+    u8 result[] {
+        0x34, 0xaa, 0x97, 0x3c, 0xd4, 0xc4, 0xda, 0xa4, 0xf6, 0x1e, 0xeb, 0x2b, 0xdb, 0xad, 0x27, 0x31, 0x65, 0x34, 0x01, 0x6f
+    };
+    auto input = MUST(ByteBuffer::create_uninitialized(1'000'000));
+    input.bytes().fill('a');
+
+    auto digest = Crypto::Hash::SHA1::hash(input);
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
+
+    // Feed odd-sized pieces so that both the buffered and the bulk block paths are exercised.
+    Crypto::Hash::SHA1 sha1;
+    for (size_t offset = 0; offset < input.size(); offset += 1000) {
+        sha1.update(input.bytes().slice(offset, 7));
+        sha1.update(input.bytes().slice(offset + 7, 993));
+    }
+    digest = sha1.digest();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
+}
+
 TEST_CASE(test_SHA256_name)
 {
     Crypto::Hash::SHA256 sha;
@@ -241,6 +262,71 @@ TEST_CASE(test_SHA256_hash_split_into_blocks)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA256_hash_million_a)
+{
+    u8 result[] {
+        0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67, 0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+    };
+    auto input = MUST(ByteBuffer::create_uninitialized(1'000'000));
+    input.bytes().fill('a');
+
+    auto digest = Crypto::Hash::SHA256::hash(input);
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+
+    Crypto::Hash::SHA256 sha256;
+    for (size_t offset = 0; offset < input.size(); offset += 1000) {
+        sha256.update(input.bytes().slice(offset, 7));
+        sha256.update(input.bytes().slice(offset + 7, 993));
+    }
+    digest = sha256.digest();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA256_hash_many)
+{
+    Vector<ByteBuffer> buffers;
+    for (size_t length : { 0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 1000, 3, 4096, 17, 64, 200, 5000, 56, 0 }) {
+        auto buffer = MUST(ByteBuffer::create_uninitialized(length));
+        for (size_t i = 0; i < length; ++i)
+            buffer[i] = static_cast<u8>(i * 31 + length);
+        buffers.append(move(buffer));
+    }
+
+    Vector<ReadonlyBytes> messages;
+    for (auto& buffer : buffers)
+        messages.append(buffer.bytes());
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(messages.size());
+
+    Crypto::Hash::SHA256::hash_many(messages, digests);
+
+    for (size_t i = 0; i < messages.size(); ++i) {
+        auto expected = Crypto::Hash::SHA256::hash(messages[i].data(), messages[i].size());
+        EXPECT(memcmp(expected.data, digests[i].data, Crypto::Hash::SHA256::digest_size()) == 0);
+    }
+}
+
+BENCHMARK_CASE(benchmark_SHA256_throughput)
+{
+    auto input = MUST(ByteBuffer::create_zeroed(64 * MiB));
+    auto digest = Crypto::Hash::SHA256::hash(input);
+    EXPECT_NE(digest.data[0] | digest.data[1], 0);
+}
+
+BENCHMARK_CASE(benchmark_SHA256_hash_many)
+{
+    Vector<ByteBuffer> buffers;
+    Vector<ReadonlyBytes> messages;
+    for (size_t i = 0; i < 64 * KiB; ++i)
+        buffers.append(MUST(ByteBuffer::create_zeroed(256 + i % 64)));
+    for (auto& buffer : buffers)
+        messages.append(buffer.bytes());
+
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(messages.size());
+    Crypto::Hash::SHA256::hash_many(messages, digests);
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
@@ -266,6 +352,26 @@ TEST_CASE(test_SHA384_hash_bug)
     EXPECT_EQ(result_bytes, digest.bytes());
 }
 
+TEST_CASE(test_SHA384_hash_million_a)
+{
+    u8 result[] {
+        0x9d, 0x0e, 0x18, 0x09, 0x71, 0x64, 0x74, 0xcb, 0x08, 0x6e, 0x83, 0x4e, 0x31, 0x0a, 0x4a, 0x1c, 0xed, 0x14, 0x9e, 0x9c, 0x00, 0xf2, 0x48, 0x52, 0x79, 0x72, 0xce, 0xc5, 0x70, 0x4c, 0x2a, 0x5b, 0x07, 0xb8, 0xb3, 0xdc, 0x38, 0xec, 0xc4, 0xeb, 0xae, 0x97, 0xdd, 0xd8, 0x7f, 0x3d, 0x89, 0x85
+    };
+    auto input = MUST(ByteBuffer::create_uninitialized(1'000'000));
+    input.bytes().fill('a');
+
+    auto digest = Crypto::Hash::SHA384::hash(input);
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA384::digest_size()) == 0);
+
+    Crypto::Hash::SHA384 sha;
+    for (size_t offset = 0; offset < input.size(); offset += 1000) {
+        sha.update(input.bytes().slice(offset, 7));
+        sha.update(input.bytes().slice(offset + 7, 993));
+    }
+    digest = sha.digest();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA384::digest_size()) == 0);
+}
+
 TEST_CASE(test_SHA512_name)
 {
     Crypto::Hash::SHA512 sha;
@@ -300,6 +406,26 @@ TEST_CASE(test_SHA512_hash_empty_string)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA512::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA512_hash_million_a)
+{
+    u8 result[] {
+        0xe7, 0x18, 0x48, 0x3d, 0x0c, 0xe7, 0x69, 0x64, 0x4e, 0x2e, 0x42, 0xc7, 0xbc, 0x15, 0xb4, 0x63, 0x8e, 0x1f, 0x98, 0xb1, 0x3b, 0x20, 0x44, 0x28, 0x56, 0x32, 0xa8, 0x03, 0xaf, 0xa9, 0x73, 0xeb, 0xde, 0x0f, 0xf2, 0x44, 0x87, 0x7e, 0xa6, 0x0a, 0x4c, 0xb0, 0x43, 0x2c, 0xe5, 0x77, 0xc3, 0x1b, 0xeb, 0x00, 0x9c, 0x5c, 0x2c, 0x49, 0xaa, 0x2e, 0x4e, 0xad, 0xb2, 0x17, 0xad, 0x8c, 0xc0, 0x9b
+    };
+    auto input = MUST(ByteBuffer::create_uninitialized(1'000'000));
+    input.bytes().fill('a');
+
+    auto digest = Crypto::Hash::SHA512::hash(input);
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA512::digest_size()) == 0);
+
+    Crypto::Hash::SHA512 sha;
+    for (size_t offset = 0; offset < input.size(); offset += 1000) {
+        sha.update(input.bytes().slice(offset, 7));
+        sha.update(input.bytes().slice(offset + 7, 993));
+    }
+    digest = sha.digest();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA512::digest_size()) == 0);
+}
+
 TEST_CASE(test_ghash_test_name)
 {
     Crypto::Authentication::GHash ghash("WellHelloFriends");
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Heap/Heap.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+static JS::Value run(JS::Realm& realm, StringView source)
+{
+    auto script = MUST(JS::Script::parse(source, realm));
+    return MUST(realm.vm().bytecode_interpreter().run(script));
+}
+
+// Fills the cells that the last collection freed with something else, so that reading a cell that shouldn't have been
+// collected doesn't find what was there before.
+static void reuse_freed_cells(JS::Realm& realm)
+{
+    run(realm, "for (let i = 0; i < 10000; ++i) ({ value: -i, other: [i] });"sv);
+}
+
+TEST_CASE(minor_collections_promote_young_cells)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+    auto& heap = vm->heap();
+
+    run(realm, "globalThis.survivor = { value: 1 };"sv);
+    auto survivor = MUST(realm.global_object().get("survivor"));
+    EXPECT(!survivor.as_object().is_old());
+
+    auto minor_collections = heap.statistics().minor_collections;
+    heap.collect_young_garbage();
+    EXPECT_EQ(heap.statistics().minor_collections, minor_collections + 1);
+    EXPECT(survivor.as_object().is_old());
+    EXPECT(survivor.as_object().has_write_barriers());
+    EXPECT(!realm.global_object().has_write_barriers());
+}
+
+TEST_CASE(old_cells_keep_young_cells_alive_through_write_barriers)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+    auto& heap = vm->heap();
+
+    run(realm, "globalThis.object = {}; globalThis.array = []; globalThis.getter = Object.defineProperty({}, 'value', { get() {}, configurable: true });"sv);
+    heap.collect_young_garbage();
+
+    // Each of these only stores a young cell into an old one.
+    run(realm, R"(
+        object.child = { value: 1 };
+        array.push({ value: 2 });
+        array[1] = { value: 3 };
+        Object.defineProperty(getter, "value", { get() { return 4; } });
+        Object.setPrototypeOf(object, { value: 5 });
+    )"sv);
+    heap.collect_young_garbage();
+    reuse_freed_cells(realm);
+    heap.collect_young_garbage();
+
+    EXPECT_EQ(run(realm, "object.child.value + array[0].value + array[1].value + getter.value + Object.getPrototypeOf(object).value"sv), JS::Value(15));
+}
+
+TEST_CASE(incremental_marking)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+    auto& heap = vm->heap();
+
+    run(realm, "globalThis.first = { next: { value: 0 } }; globalThis.second = {};"sv);
+    heap.collect_young_garbage();
+
+    auto collections = heap.statistics().collections;
+    heap.start_incremental_marking();
+    EXPECT(heap.is_marking_incrementally());
+
+    // Moving the only reference to a cell from one that marking hasn't gotten to yet into one that it already has is
+    // what the write barrier has to tell the end of marking about.
+    size_t steps = 0;
+    while (heap.is_marking_incrementally()) {
+        heap.perform_incremental_marking_step(Duration::zero());
+        run(realm, R"(
+            var next = first.next ?? second.next;
+            first.next = second.next = undefined;
+            (next.value % 2 ? first : second).next = { value: next.value + 1 };
+        )"sv);
+        ++steps;
+    }
+    EXPECT(steps > 1);
+    EXPECT_EQ(heap.statistics().collections, collections + 1);
+
+    reuse_freed_cells(realm);
+    heap.collect_young_garbage();
+    EXPECT_EQ(run(realm, "(first.next ?? second.next).value"sv), JS::Value(static_cast<i32>(steps)));
+}
+
+TEST_CASE(full_collection_during_incremental_marking)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+    auto& heap = vm->heap();
+
+    run(realm, "globalThis.object = { value: 1 };"sv);
+    heap.collect_young_garbage();
+    heap.start_incremental_marking();
+    heap.perform_incremental_marking_step(Duration::zero());
+    run(realm, "object.child = { value: 2 };"sv);
+
+    heap.collect_garbage();
+    EXPECT(!heap.is_marking_incrementally());
+    reuse_freed_cells(realm);
+    EXPECT_EQ(run(realm, "object.value + object.child.value"sv), JS::Value(3));
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <LibCore/System.h>
+#include <LibFileSystem/FileSystem.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/BytecodeCache.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibJS/SourceTextModule.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/Thread.h>
+
+static constexpr auto source = R"(
+    var counter = (globalThis.counter ?? 0) + 1;
+    function twice(value) { return value * 2; }
+    twice(counter);
+)"sv;
+
+TEST_CASE(same_source_text_shares_the_program)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+
+    auto first = MUST(JS::Script::parse(source, realm, "file.js"sv));
+    auto second = MUST(JS::Script::parse(source, realm, "file.js"sv));
+    EXPECT_EQ(&first->parse_node(), &second->parse_node());
+
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(first)), JS::Value(2));
+    EXPECT(first->parse_node().bytecode_executable());
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(second)), JS::Value(4));
+
+    // Anything that shows up in the program's source code or positions needs its own program.
+    auto other_filename = MUST(JS::Script::parse(source, realm, "other.js"sv));
+    EXPECT_NE(&first->parse_node(), &other_filename->parse_node());
+    auto other_line_number = MUST(JS::Script::parse(source, realm, "file.js"sv, nullptr, 10));
+    EXPECT_NE(&first->parse_node(), &other_line_number->parse_node());
+    auto module = MUST(JS::SourceTextModule::parse(source, realm, "file.js"sv));
+    EXPECT_NE(&first->parse_node(), &module->parse_node());
+    auto module_with_other_line_number = MUST(JS::SourceTextModule::parse(source, realm, "file.js"sv, nullptr, 10));
+    EXPECT_NE(&module->parse_node(), &module_with_other_line_number->parse_node());
+}
+
+TEST_CASE(shared_programs_in_different_realms)
+{
+    auto vm = MUST(JS::VM::create());
+    auto first_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto first = MUST(JS::Script::parse(source, *first_execution_context->realm));
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(first)), JS::Value(2));
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(first)), JS::Value(4));
+
+    auto second_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto second = MUST(JS::Script::parse(source, *second_execution_context->realm));
+    EXPECT_EQ(&first->parse_node(), &second->parse_node());
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(second)), JS::Value(2));
+}
+
+TEST_CASE(syntax_errors_are_not_cached)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+
+    EXPECT(JS::Script::parse("let let = 1;"sv, realm).is_error());
+    EXPECT(JS::Script::parse("let let = 1;"sv, realm).is_error());
+
+    // Errors are reported at the position in the surrounding document, such as an inline module script in HTML.
+    auto errors = JS::SourceTextModule::parse("\nlet let = 1;"sv, realm, "file.js"sv, nullptr, 10).release_error();
+    EXPECT_EQ(errors.first().position->line, 11u);
+}
+
+TEST_CASE(parsing_ahead_of_creating_records)
+{
+    auto vm = MUST(JS::VM::create());
+
+    // The program holds on to its bytecode once it has run, so it can't outlive the VM.
+    auto program = MUST(JS::Script::parse_program(source, "ahead.js"sv));
+    EXPECT(JS::SourceTextModule::parse_program("export let let = 1;"sv).is_error());
+
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+
+    auto script = JS::Script::create(realm, "ahead.js"sv, program);
+    EXPECT_EQ(&script->parse_node(), program.ptr());
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(script)), JS::Value(2));
+
+    auto module = JS::SourceTextModule::create(realm, "ahead.mjs"sv, MUST(JS::SourceTextModule::parse_program("export default 1;"sv)));
+    EXPECT(module->parse_node().has_top_level_await() == false);
+}
+
+TEST_CASE(parsing_on_another_thread)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+
+    // The parser interns every identifier, so have the main thread intern (and drop) the same names while it runs.
+    RefPtr<JS::Program> program;
+    size_t failures = 0;
+    auto thread = Threading::Thread::construct([&]() -> intptr_t {
+        for (size_t i = 0; i < 200; ++i) {
+            auto result = JS::Script::parse_program(source, "worker.js"sv);
+            if (result.is_error() || !JS::SourceTextModule::parse_program("export let let = 1;"sv).is_error()) {
+                ++failures;
+                continue;
+            }
+            program = result.release_value();
+        }
+        return 0;
+    });
+    thread->start();
+
+    for (size_t i = 0; i < 20000; ++i) {
+        DeprecatedFlyString counter = ByteString("counter"sv);
+        DeprecatedFlyString value = "value"sv;
+        EXPECT(counter != value);
+    }
+
+    MUST(thread->join());
+    EXPECT_EQ(failures, 0u);
+
+    // Only creating the record and running it has to happen on the thread that owns the realm.
+    auto script = JS::Script::create(realm, "worker.js"sv, program.release_nonnull());
+    EXPECT_EQ(MUST(vm->bytecode_interpreter().run(script)), JS::Value(2));
+}
+
+static constexpr auto cached_source = R"(
+    function makeCounter(start) {
+        let count = start;
+        return {
+            next() { return ++count; },
+            get value() { return count; },
+        };
+    }
+    class Point {
+        #x;
+        constructor(x, y) { this.#x = x; this.y = y; }
+        sum() { return this.#x + this.y; }
+        static origin() { return new Point(0, 0); }
+    }
+    function* range(n) { for (let i = 0; i < n; ++i) yield i; }
+    function classify(value) {
+        switch (typeof value) {
+        case "number": { let kind = "n"; return kind; }
+        default: let other = "x"; return other;
+        }
+    }
+    let results = [];
+    { let scoped = makeCounter(10); scoped.next(); results.push(scoped.value); }
+    results.push(new Point(1, 2).sum(), Point.origin().sum());
+    results.push([...range(4)].join(""), classify(1) + classify("s"));
+    results.push(/a(b+)c/g.exec("xabbbc")[1], (2n ** 70n).toString());
+    try { throw new Error("boom"); } catch (e) { results.push(e.message); } finally { results.push("done"); }
+    results.join();
+)"sv;
+
+TEST_CASE(bytecode_cache_between_vms)
+{
+    char directory_template[] = "/tmp/test-program-cache-js.XXXXXX";
+    auto directory = MUST(Core::System::mkdtemp(directory_template));
+    MUST(JS::BytecodeCache::enable(directory.to_byte_string()));
+    ScopeGuard clean_up = [&] {
+        JS::BytecodeCache::disable();
+        (void)FileSystem::remove(directory, FileSystem::RecursionMode::Allowed);
+    };
+
+    // Each VM parses the source again, as programs are only shared within a VM.
+    auto run = [] {
+        auto vm = MUST(JS::VM::create());
+        auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+        auto script = MUST(JS::Script::parse(cached_source, *root_execution_context->realm, "cached.js"sv));
+        return MUST(vm->bytecode_interpreter().run(script)).as_string().byte_string();
+    };
+    static constexpr auto expected = "11,3,0,0123,nx,bbb,1180591620717411303424,boom,done"sv;
+
+    auto& statistics = JS::BytecodeCache::statistics();
+    statistics = {};
+    EXPECT_EQ(run(), expected);
+    EXPECT_EQ(statistics.hits, 0u);
+    EXPECT(statistics.records_written > 0);
+
+    auto records_written = statistics.records_written;
+    statistics = {};
+    EXPECT_EQ(run(), expected);
+    EXPECT_EQ(statistics.hits, records_written);
+    EXPECT_EQ(statistics.misses, 0u);
+    EXPECT_EQ(statistics.records_written, 0u);
+}
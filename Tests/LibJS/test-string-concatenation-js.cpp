@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/PrimitiveString.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+static ByteString run_script(StringView source)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto script = MUST(JS::Script::parse(source, *root_execution_context->realm));
+    auto result = MUST(vm->bytecode_interpreter().run(script));
+    return result.as_string().byte_string();
+}
+
+TEST_CASE(appending_in_a_loop)
+{
+    EXPECT_EQ(run_script(R"(
+        let s = "";
+        for (let i = 0; i < 5; ++i)
+            s += i;
+        s;
+    )"sv),
+        "01234"sv);
+}
+
+TEST_CASE(looking_at_the_string_while_appending)
+{
+    // Every resolved string is the first piece of the next rope here, which may append to its code units in place.
+    EXPECT_EQ(run_script(R"(
+        let s = "";
+        const snapshots = [];
+        for (let i = 0; i < 5; ++i) {
+            s += i;
+            if (s[s.length - 1] !== String(i))
+                throw new Error();
+            snapshots.push(s);
+        }
+        snapshots.join(",") + "|" + (snapshots[1] + "x") + (snapshots[1] + "y") + "|" + s;
+    )"sv),
+        "0,01,012,0123,01234|01x01y|01234"sv);
+}
+
+TEST_CASE(surrogate_pairs_across_pieces)
+{
+    EXPECT_EQ(run_script(R"(
+        let s = "\ud83d";
+        s.length;
+        s += "\ude00";
+        s.length + s;
+    )"sv),
+        "2😀"sv);
+}
+
+BENCHMARK_CASE(append_in_a_loop)
+{
+    run_script(R"(
+        let s = "";
+        for (let i = 0; i < 200000; ++i)
+            s += "<li>" + i + "</li>";
+        s.length;
+        s;
+    )"sv);
+}
+
+BENCHMARK_CASE(append_and_look_at_the_string_in_a_loop)
+{
+    run_script(R"(
+        let s = "";
+        for (let i = 0; i < 100000; ++i) {
+            s += "ab";
+            if (s.charCodeAt(s.length - 1) !== 98)
+                throw new Error();
+        }
+        s;
+    )"sv);
+}
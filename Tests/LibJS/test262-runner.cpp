@@ -17,6 +17,7 @@
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Contrib/Test262/GlobalObject.h>
+#include <LibJS/JIT/Compiler.h>
 #include <LibJS/Parser.h>
 #include <LibJS/Runtime/Agent.h>
 #include <LibJS/Runtime/VM.h>
@@ -576,6 +577,7 @@ int main(int argc, char** argv)
     int timeout = 10;
     bool enable_debug_printing = false;
     bool disable_core_dumping = false;
+    bool disable_jit = false;
 
     Core::ArgsParser args_parser;
     args_parser.set_general_help("LibJS test262 runner for streaming tests");
@@ -584,8 +586,12 @@ int main(int argc, char** argv)
     args_parser.add_option(timeout, "Seconds before test should timeout", "timeout", 't', "seconds");
     args_parser.add_option(enable_debug_printing, "Enable debug printing", "debug", 'd');
     args_parser.add_option(disable_core_dumping, "Disable core dumping", "disable-core-dump");
+    args_parser.add_option(disable_jit, "Disable the JIT compiler", "disable-jit");
     args_parser.parse(arguments);
 
+    if (disable_jit)
+        JS::JIT::Compiler::set_enabled(false);
+
 #ifdef AK_OS_GNU_HURD
     if (disable_core_dumping)
         setenv("CRASHSERVER", "/servers/crash-kill", true);
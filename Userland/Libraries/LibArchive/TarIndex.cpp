@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibArchive/TarIndex.h>
+
+namespace Archive {
+
+ErrorOr<TarIndex> TarIndex::read_from_stream(Stream& stream)
+{
+    auto contents = TRY(stream.read_until_eof());
+
+    TarIndex index;
+    StringView remaining { contents };
+    while (!remaining.is_empty()) {
+        auto line_end = remaining.find('\n');
+        if (!line_end.has_value())
+            return Error::from_string_literal("Tar index does not end with a newline");
+
+        auto line = remaining.substring_view(0, *line_end);
+        remaining = remaining.substring_view(*line_end + 1);
+
+        auto separator = line.find(' ');
+        if (!separator.has_value())
+            return Error::from_string_literal("Tar index entry has no path");
+
+        auto header_offset = line.substring_view(0, *separator).to_number<u64>();
+        if (!header_offset.has_value())
+            return Error::from_string_literal("Tar index entry has an invalid offset");
+
+        TRY(index.add(line.substring_view(*separator + 1), *header_offset));
+    }
+
+    return index;
+}
+
+ErrorOr<void> TarIndex::write_to_stream(Stream& stream) const
+{
+    for (auto const& entry : m_entries)
+        TRY(stream.write_formatted("{} {}\n", entry.header_offset, entry.path));
+    return {};
+}
+
+ErrorOr<void> TarIndex::add(ByteString path, u64 header_offset)
+{
+    if (path.is_empty() || path.contains('\n'))
+        return Error::from_string_literal("Tar index paths must not be empty or contain newlines");
+
+    TRY(m_header_offsets_by_path.try_set(path, header_offset));
+    TRY(m_entries.try_append({ header_offset, move(path) }));
+    return {};
+}
+
+Optional<u64> TarIndex::find(StringView path) const
+{
+    return m_header_offsets_by_path.get(path);
+}
+
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/Stream.h>
+#include <AK/Vector.h>
+
+namespace Archive {
+
+// A sidecar file that maps the paths of tar archive members to the offsets of their headers within the (uncompressed)
+// archive, so that single members can be found without reading everything in front of them. Combined with a seekable
+// archive stream (an uncompressed file, or an XZ file with multiple blocks), this makes listing and extracting
+// individual members independent of the archive size.
+//
+// The format is plain text, with one "<offset> <path>" line per member, in archive order.
+class TarIndex {
+public:
+    struct Entry {
+        u64 header_offset { 0 };
+        ByteString path;
+    };
+
+    static ErrorOr<TarIndex> read_from_stream(Stream&);
+    ErrorOr<void> write_to_stream(Stream&) const;
+
+    ErrorOr<void> add(ByteString path, u64 header_offset);
+
+    // If the archive contains multiple members with the same path, the last one is returned, since that is also the
+    // one that ends up on disk when extracting everything.
+    Optional<u64> find(StringView path) const;
+
+    Vector<Entry> const& entries() const { return m_entries; }
+
+private:
+    Vector<Entry> m_entries;
+    HashMap<ByteString, u64> m_header_offsets_by_path;
+};
+
+}
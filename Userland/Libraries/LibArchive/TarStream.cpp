@@ -8,6 +8,7 @@
 
 #include <AK/Array.h>
 #include <AK/OwnPtr.h>
+#include <AK/TypeCasts.h>
 #include <LibArchive/TarStream.h>
 #include <string.h>
 
@@ -82,6 +83,31 @@ ErrorOr<void> TarInputStream::advance()
     auto file_size = TRY(m_header.size());
     TRY(m_stream->discard(block_ceiling(file_size) - m_file_offset));
     m_file_offset = 0;
+    m_header_offset += block_size + block_ceiling(file_size);
+
+    TRY(load_next_header());
+
+    return {};
+}
+
+bool TarInputStream::is_seekable() const
+{
+    return is<SeekableStream>(*m_stream);
+}
+
+ErrorOr<void> TarInputStream::seek_to_header(u64 offset)
+{
+    if (!is_seekable())
+        return Error::from_string_literal("Tar archive stream is not seekable");
+    if (offset % block_size != 0)
+        return Error::from_string_literal("Tar header offset is not aligned to a block");
+
+    m_generation++;
+
+    TRY(static_cast<SeekableStream&>(*m_stream).seek(offset, SeekMode::SetPosition));
+    m_file_offset = 0;
+    m_header_offset = offset;
+    m_found_end_of_archive = false;
 
     TRY(load_next_header());
 
@@ -101,6 +127,7 @@ ErrorOr<void> TarInputStream::load_next_header()
             break;
 
         number_of_consecutive_zero_blocks++;
+        m_header_offset += block_size;
 
         // Two zero blocks in a row marks the end of the archive.
         if (number_of_consecutive_zero_blocks >= 2) {
@@ -140,6 +167,13 @@ TarOutputStream::TarOutputStream(MaybeOwned<Stream> stream)
 {
 }
 
+ErrorOr<void> TarOutputStream::write(ReadonlyBytes bytes)
+{
+    TRY(m_stream->write_until_depleted(bytes));
+    m_offset += bytes.size();
+    return {};
+}
+
 ErrorOr<void> TarOutputStream::add_directory(StringView path, mode_t mode)
 {
     VERIFY(!m_finished);
@@ -151,9 +185,9 @@ ErrorOr<void> TarOutputStream::add_directory(StringView path, mode_t mode)
     header.set_magic(gnu_magic);
     header.set_version(gnu_version);
     TRY(header.calculate_checksum());
-    TRY(m_stream->write_until_depleted(Bytes { &header, sizeof(header) }));
+    TRY(write(Bytes { &header, sizeof(header) }));
     u8 padding[block_size] = { 0 };
-    TRY(m_stream->write_until_depleted(Bytes { &padding, block_size - sizeof(header) }));
+    TRY(write(Bytes { &padding, block_size - sizeof(header) }));
     return {};
 }
 
@@ -168,14 +202,11 @@ ErrorOr<void> TarOutputStream::add_file(StringView path, mode_t mode, ReadonlyBy
     header.set_magic(gnu_magic);
     header.set_version(gnu_version);
     TRY(header.calculate_checksum());
-    TRY(m_stream->write_until_depleted(ReadonlyBytes { &header, sizeof(header) }));
+    TRY(write(ReadonlyBytes { &header, sizeof(header) }));
     constexpr Array<u8, block_size> padding { 0 };
-    TRY(m_stream->write_until_depleted(ReadonlyBytes { &padding, block_size - sizeof(header) }));
-    size_t n_written = 0;
-    while (n_written < bytes.size()) {
-        n_written += MUST(m_stream->write_some(bytes.slice(n_written, min(bytes.size() - n_written, block_size))));
-    }
-    TRY(m_stream->write_until_depleted(ReadonlyBytes { &padding, block_size - (n_written % block_size) }));
+    TRY(write(ReadonlyBytes { &padding, block_size - sizeof(header) }));
+    TRY(write(bytes));
+    TRY(write(ReadonlyBytes { &padding, block_size - (bytes.size() % block_size) }));
     return {};
 }
 
@@ -191,9 +222,9 @@ ErrorOr<void> TarOutputStream::add_link(StringView path, mode_t mode, StringView
     header.set_version(gnu_version);
     header.set_link_name(link_name);
     TRY(header.calculate_checksum());
-    TRY(m_stream->write_until_depleted(Bytes { &header, sizeof(header) }));
+    TRY(write(Bytes { &header, sizeof(header) }));
     u8 padding[block_size] = { 0 };
-    TRY(m_stream->write_until_depleted(Bytes { &padding, block_size - sizeof(header) }));
+    TRY(write(Bytes { &padding, block_size - sizeof(header) }));
     return {};
 }
 
@@ -202,8 +233,8 @@ ErrorOr<void> TarOutputStream::finish()
     VERIFY(!m_finished);
     constexpr Array<u8, block_size> padding { 0 };
     // 2 empty records that are used to signify the end of the archive.
-    TRY(m_stream->write_until_depleted(ReadonlyBytes { &padding, block_size }));
-    TRY(m_stream->write_until_depleted(ReadonlyBytes { &padding, block_size }));
+    TRY(write(ReadonlyBytes { &padding, block_size }));
+    TRY(write(ReadonlyBytes { &padding, block_size }));
     m_finished = true;
     return {};
 }
@@ -41,6 +41,12 @@ public:
     TarFileHeader const& header() const { return m_header; }
     TarFileStream file_contents();
 
+    // The offset of the current header within the archive, which can later be passed to seek_to_header() if the
+    // underlying stream is seekable. This allows skipping over members without reading (or decompressing) them.
+    u64 header_offset() const { return m_header_offset; }
+    bool is_seekable() const;
+    ErrorOr<void> seek_to_header(u64 offset);
+
     template<VoidFunction<StringView, StringView> F>
     ErrorOr<void> for_each_extended_header(F func);
 
@@ -51,6 +57,7 @@ private:
     TarFileHeader m_header;
     NonnullOwnPtr<Stream> m_stream;
     unsigned long m_file_offset { 0 };
+    u64 m_header_offset { 0 };
     int m_generation { 0 };
     bool m_found_end_of_archive { false };
 
@@ -65,8 +72,14 @@ public:
     ErrorOr<void> add_directory(StringView path, mode_t);
     ErrorOr<void> finish();
 
+    // The number of bytes written so far, which is where the header of the next member will start.
+    u64 offset() const { return m_offset; }
+
 private:
+    ErrorOr<void> write(ReadonlyBytes);
+
     MaybeOwned<Stream> m_stream;
+    u64 m_offset { 0 };
     bool m_finished { false };
 
     friend class TarFileStream;
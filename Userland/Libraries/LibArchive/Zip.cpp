@@ -41,6 +41,15 @@ Optional<Zip> Zip::try_create(ReadonlyBytes buffer)
     if (end_of_central_directory.disk_number != 0 || end_of_central_directory.central_directory_start_disk != 0 || end_of_central_directory.disk_records_count != end_of_central_directory.total_records_count)
         return {}; // TODO: support multi-volume zip archives
 
+    // Remember where every central directory record starts, so that members can be looked up without walking the
+    // central directory again. The path index refers to names in the input buffer instead of copying them.
+    Vector<size_t> central_directory_record_offsets;
+    HashMap<StringView, size_t> member_indices_by_path;
+    if (central_directory_record_offsets.try_ensure_capacity(end_of_central_directory.total_records_count).is_error())
+        return {};
+    if (member_indices_by_path.try_ensure_capacity(end_of_central_directory.total_records_count).is_error())
+        return {};
+
     size_t member_offset = end_of_central_directory.central_directory_offset;
     for (size_t i = 0; i < end_of_central_directory.total_records_count; i++) {
         CentralDirectoryRecord central_directory_record {};
@@ -67,39 +76,50 @@ Optional<Zip> Zip::try_create(ReadonlyBytes buffer)
             return {};
         if (buffer.size() - (local_file_header.compressed_data - buffer.data()) < central_directory_record.compressed_size)
             return {};
+        central_directory_record_offsets.unchecked_append(member_offset);
+        member_indices_by_path.set(StringView { central_directory_record.name, central_directory_record.name_length }, i);
         member_offset += central_directory_record.size();
     }
 
     return Zip {
-        end_of_central_directory.total_records_count,
-        end_of_central_directory.central_directory_offset,
+        move(central_directory_record_offsets),
+        move(member_indices_by_path),
         buffer,
     };
 }
 
+ErrorOr<ZipMember> Zip::member_at(size_t index) const
+{
+    CentralDirectoryRecord central_directory_record {};
+    VERIFY(central_directory_record.read(m_input_data.slice(m_central_directory_record_offsets[index])));
+    LocalFileHeader local_file_header {};
+    VERIFY(local_file_header.read(m_input_data.slice(central_directory_record.local_file_header_offset)));
+
+    ZipMember member;
+    member.name = TRY(String::from_utf8({ central_directory_record.name, central_directory_record.name_length }));
+    member.compressed_data = { local_file_header.compressed_data, central_directory_record.compressed_size };
+    member.compression_method = central_directory_record.compression_method;
+    member.uncompressed_size = central_directory_record.uncompressed_size;
+    member.crc32 = central_directory_record.crc32;
+    member.modification_time = central_directory_record.modification_time;
+    member.modification_date = central_directory_record.modification_date;
+    member.is_directory = central_directory_record.external_attributes & zip_directory_external_attribute || member.name.bytes_as_string_view().ends_with('/'); // FIXME: better directory detection
+    return member;
+}
+
+ErrorOr<Optional<ZipMember>> Zip::find_member(StringView path) const
+{
+    auto index = m_member_indices_by_path.get(path);
+    if (!index.has_value())
+        return OptionalNone {};
+    return TRY(member_at(*index));
+}
+
 ErrorOr<bool> Zip::for_each_member(Function<ErrorOr<IterationDecision>(ZipMember const&)> callback) const
 {
-    size_t member_offset = m_members_start_offset;
-    for (size_t i = 0; i < m_member_count; i++) {
-        CentralDirectoryRecord central_directory_record {};
-        VERIFY(central_directory_record.read(m_input_data.slice(member_offset)));
-        LocalFileHeader local_file_header {};
-        VERIFY(local_file_header.read(m_input_data.slice(central_directory_record.local_file_header_offset)));
-
-        ZipMember member;
-        member.name = TRY(String::from_utf8({ central_directory_record.name, central_directory_record.name_length }));
-        member.compressed_data = { local_file_header.compressed_data, central_directory_record.compressed_size };
-        member.compression_method = central_directory_record.compression_method;
-        member.uncompressed_size = central_directory_record.uncompressed_size;
-        member.crc32 = central_directory_record.crc32;
-        member.modification_time = central_directory_record.modification_time;
-        member.modification_date = central_directory_record.modification_date;
-        member.is_directory = central_directory_record.external_attributes & zip_directory_external_attribute || member.name.bytes_as_string_view().ends_with('/'); // FIXME: better directory detection
-
-        if (TRY(callback(member)) == IterationDecision::Break)
+    for (size_t i = 0; i < member_count(); i++) {
+        if (TRY(callback(TRY(member_at(i)))) == IterationDecision::Break)
             return false;
-
-        member_offset += central_directory_record.size();
     }
     return true;
 }
@@ -158,7 +178,7 @@ ErrorOr<void> ZipOutputStream::add_member(ZipMember const& member)
     return local_file_header.write(*m_stream);
 }
 
-ErrorOr<ZipOutputStream::MemberInformation> ZipOutputStream::add_member_from_stream(StringView path, Stream& stream, Optional<Core::DateTime> const& modification_time)
+ErrorOr<ZipOutputStream::MemberInformation> ZipOutputStream::add_member_from_stream(StringView path, Stream& stream, Optional<Core::DateTime> const& modification_time, size_t compression_thread_count)
 {
     auto buffer = TRY(stream.read_until_eof());
 
@@ -170,7 +190,9 @@ ErrorOr<ZipOutputStream::MemberInformation> ZipOutputStream::add_member_from_str
         member.modification_time = to_packed_dos_time(modification_time->hour(), modification_time->minute(), modification_time->second());
     }
 
-    auto deflate_buffer = Compress::DeflateCompressor::compress_all(buffer);
+    auto deflate_buffer = compression_thread_count > 1
+        ? Compress::DeflateCompressor::compress_all_in_parallel(buffer, compression_thread_count)
+        : Compress::DeflateCompressor::compress_all(buffer);
     auto compression_ratio = 1.f;
     auto compressed_size = buffer.size();
 
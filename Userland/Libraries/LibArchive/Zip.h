@@ -10,6 +10,7 @@
 #include <AK/Array.h>
 #include <AK/DOSPackedTime.h>
 #include <AK/Function.h>
+#include <AK/HashMap.h>
 #include <AK/IterationDecision.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Stream.h>
@@ -252,23 +253,32 @@ struct ZipMember {
     DOSPackedDate modification_date;
 };
 
+// NOTE: Members refer directly to the bytes passed to try_create(), which usually come from a Core::MappedFile.
+//       The buffer has to outlive the Zip and all members obtained from it.
 class Zip {
 public:
     static Optional<Zip> try_create(ReadonlyBytes buffer);
     ErrorOr<bool> for_each_member(Function<ErrorOr<IterationDecision>(ZipMember const&)>) const;
     ErrorOr<Statistics> calculate_statistics() const;
 
+    size_t member_count() const { return m_central_directory_record_offsets.size(); }
+    ErrorOr<ZipMember> member_at(size_t index) const;
+
+    // If the archive contains multiple members with the same path, the last one is returned.
+    ErrorOr<Optional<ZipMember>> find_member(StringView path) const;
+
 private:
     static bool find_end_of_central_directory_offset(ReadonlyBytes, size_t& offset);
 
-    Zip(u16 member_count, size_t members_start_offset, ReadonlyBytes input_data)
-        : m_member_count { member_count }
-        , m_members_start_offset { members_start_offset }
+    Zip(Vector<size_t> central_directory_record_offsets, HashMap<StringView, size_t> member_indices_by_path, ReadonlyBytes input_data)
+        : m_central_directory_record_offsets { move(central_directory_record_offsets) }
+        , m_member_indices_by_path { move(member_indices_by_path) }
         , m_input_data { input_data }
     {
     }
-    u16 m_member_count { 0 };
-    size_t m_members_start_offset { 0 };
+
+    Vector<size_t> m_central_directory_record_offsets;
+    HashMap<StringView, size_t> m_member_indices_by_path;
     ReadonlyBytes m_input_data;
 };
 
@@ -282,7 +292,7 @@ public:
     ZipOutputStream(NonnullOwnPtr<Stream>);
 
     ErrorOr<void> add_member(ZipMember const&);
-    ErrorOr<MemberInformation> add_member_from_stream(StringView, Stream&, Optional<Core::DateTime> const& = {});
+    ErrorOr<MemberInformation> add_member_from_stream(StringView, Stream&, Optional<Core::DateTime> const& = {}, size_t compression_thread_count = 1);
 
     // NOTE: This does not add any of the files within the directory,
     //       it just adds an entry for it.
@@ -5,12 +5,23 @@
  */
 
 #include <AK/BinarySearch.h>
+#include <AK/IntegralMath.h>
+#include <AK/Math.h>
+#include <AK/MemoryStream.h>
 #include <AK/QuickSort.h>
 #include <LibCompress/Brotli.h>
 #include <LibCompress/BrotliDictionary.h>
+#include <LibCompress/Deflate.h>
+#include <LibCompress/Huffman.h>
 
 namespace Compress {
 
+// RFC 7932 section 5: insert and copy length codes.
+static constexpr u32 insert_length_base[24] { 0, 1, 2, 3, 4, 5, 6, 8, 10, 14, 18, 26, 34, 50, 66, 98, 130, 194, 322, 578, 1090, 2114, 6210, 22594 };
+static constexpr u8 insert_length_extra[24] { 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 12, 14, 24 };
+static constexpr u32 copy_length_base[24] { 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 14, 18, 22, 30, 38, 54, 70, 102, 134, 198, 326, 582, 1094, 2118 };
+static constexpr u8 copy_length_extra[24] { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 24 };
+
 ErrorOr<size_t> Brotli::CanonicalCode::read_symbol(LittleEndianInputBitStream& input_stream) const
 {
     size_t code_bits = 1;
@@ -489,81 +500,82 @@ ErrorOr<void> BrotliDecompressionStream::block_read_new_state(Block& block)
     return {};
 }
 
-size_t BrotliDecompressionStream::literal_code_index_from_context()
+static constexpr u8 context_id_lut0[256] {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 0, 0, 4, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    8, 12, 16, 12, 12, 20, 12, 16, 24, 28, 12, 12, 32, 12, 36, 12,
+    44, 44, 44, 44, 44, 44, 44, 44, 44, 44, 32, 32, 24, 40, 28, 12,
+    12, 48, 52, 52, 52, 48, 52, 52, 52, 48, 52, 52, 52, 52, 52, 48,
+    52, 52, 52, 52, 52, 48, 52, 52, 52, 52, 52, 24, 12, 28, 12, 12,
+    12, 56, 60, 60, 60, 56, 60, 60, 60, 56, 60, 60, 60, 60, 60, 56,
+    60, 60, 60, 60, 60, 56, 60, 60, 60, 60, 60, 24, 12, 28, 12, 0,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3
+};
+static constexpr u8 context_id_lut1[256] {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1,
+    1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1,
+    1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 1, 1, 1, 1, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2
+};
+static constexpr u8 context_id_lut2[256] {
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7
+};
+
+// RFC 7932 section 7.1: the context ID of a literal, given the two preceding bytes.
+static u8 literal_context_id(size_t context_mode, u8 previous_byte, u8 second_previous_byte)
 {
-    size_t const context_id_lut0[256] {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 0, 0, 4, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        8, 12, 16, 12, 12, 20, 12, 16, 24, 28, 12, 12, 32, 12, 36, 12,
-        44, 44, 44, 44, 44, 44, 44, 44, 44, 44, 32, 32, 24, 40, 28, 12,
-        12, 48, 52, 52, 52, 48, 52, 52, 52, 48, 52, 52, 52, 52, 52, 48,
-        52, 52, 52, 52, 52, 48, 52, 52, 52, 52, 52, 24, 12, 28, 12, 12,
-        12, 56, 60, 60, 60, 56, 60, 60, 60, 56, 60, 60, 60, 60, 60, 56,
-        60, 60, 60, 60, 60, 56, 60, 60, 60, 60, 60, 24, 12, 28, 12, 0,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3
-    };
-    size_t const context_id_lut1[256] {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1,
-        1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1,
-        1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 1, 1, 1, 1, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2
-    };
-    size_t const context_id_lut2[256] {
-        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-        5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-        5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7
-    };
-
-    size_t context_mode = m_literal_context_modes[m_literal_block.type];
-    size_t context_id;
     switch (context_mode) {
     case 0:
-        context_id = m_lookback_buffer.value().lookback(1, 0) & 0x3f;
-        break;
+        return previous_byte & 0x3f;
     case 1:
-        context_id = m_lookback_buffer.value().lookback(1, 0) >> 2;
-        break;
+        return previous_byte >> 2;
     case 2:
-        context_id = context_id_lut0[m_lookback_buffer.value().lookback(1, 0)] | context_id_lut1[m_lookback_buffer.value().lookback(2, 0)];
-        break;
+        return context_id_lut0[previous_byte] | context_id_lut1[second_previous_byte];
     case 3:
-        context_id = (context_id_lut2[m_lookback_buffer.value().lookback(1, 0)] << 3) | context_id_lut2[m_lookback_buffer.value().lookback(2, 0)];
-        break;
+        return (context_id_lut2[previous_byte] << 3) | context_id_lut2[second_previous_byte];
     default:
         VERIFY_NOT_REACHED();
     }
+}
+
+size_t BrotliDecompressionStream::literal_code_index_from_context()
+{
+    auto context_mode = m_literal_context_modes[m_literal_block.type];
+    auto context_id = literal_context_id(context_mode, m_lookback_buffer.value().lookback(1, 0), m_lookback_buffer.value().lookback(2, 0));
 
     size_t literal_code_index = m_context_mapping_literal[64 * m_literal_block.type + context_id];
     return literal_code_index;
@@ -766,11 +778,6 @@ ErrorOr<Bytes> BrotliDecompressionStream::read_some(Bytes output_buffer)
 
             m_implicit_zero_distance = implicit_zero_distance[insert_and_copy_index];
 
-            size_t const insert_length_base[24] { 0, 1, 2, 3, 4, 5, 6, 8, 10, 14, 18, 26, 34, 50, 66, 98, 130, 194, 322, 578, 1090, 2114, 6210, 22594 };
-            size_t const insert_length_extra[24] { 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 12, 14, 24 };
-            size_t const copy_length_base[24] { 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 14, 18, 22, 30, 38, 54, 70, 102, 134, 198, 326, 582, 1094, 2118 };
-            size_t const copy_length_extra[24] { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 24 };
-
             m_insert_length = insert_length_base[insert_length_code] + TRY(m_input_stream.read_bits(insert_length_extra[insert_length_code]));
             m_copy_length = copy_length_base[copy_length_code] + TRY(m_input_stream.read_bits(copy_length_extra[copy_length_code]));
 
@@ -943,4 +950,942 @@ bool BrotliDecompressionStream::is_eof() const
     return m_read_final_block && m_current_state == State::Idle;
 }
 
+// Scores from the reference encoder, which weigh the bytes a match covers against the bits its distance costs.
+static constexpr size_t literal_byte_score = 135;
+static constexpr size_t distance_bit_penalty = 30;
+static constexpr size_t score_base = distance_bit_penalty * 8 * sizeof(size_t);
+static constexpr size_t min_score = score_base + 100;
+static constexpr size_t lazy_match_score_margin = 175;
+static constexpr size_t max_lazy_match_deferrals = 4;
+
+static size_t backward_reference_score(size_t length, size_t distance)
+{
+    return score_base + literal_byte_score * length - distance_bit_penalty * AK::log2(distance);
+}
+
+static size_t last_distance_score(size_t length, size_t distance_index)
+{
+    // These distances take no extra bits, and the most recent one can even be encoded as part of the command.
+    auto score = score_base + literal_byte_score * length;
+    return distance_index == 0 ? score + 15 : score - 39;
+}
+
+static u32 hash_four_bytes(u8 const* bytes, size_t hash_bits)
+{
+    u32 value = bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<u32>(bytes[3]) << 24;
+    return (value * 0x1e35a7bd) >> (32 - hash_bits);
+}
+
+static u8 insert_length_code(size_t length)
+{
+    u8 code = array_size(insert_length_base) - 1;
+    while (insert_length_base[code] > length)
+        code--;
+    return code;
+}
+
+static u8 copy_length_code(size_t length)
+{
+    u8 code = array_size(copy_length_base) - 1;
+    while (copy_length_base[code] > length)
+        code--;
+    return code;
+}
+
+// RFC 7932 section 5: the insert-and-copy symbol for an insert and a copy length code.
+static u16 insert_and_copy_symbol(u8 insert_code, u8 copy_code, bool implicit_zero_distance)
+{
+    u16 cell;
+    if (implicit_zero_distance) {
+        VERIFY(insert_code < 8 && copy_code < 16);
+        cell = copy_code < 8 ? 0 : 1;
+    } else {
+        static constexpr u8 cells_by_range[3][3] { { 2, 3, 6 }, { 4, 5, 8 }, { 7, 9, 10 } };
+        cell = cells_by_range[insert_code / 8][copy_code / 8];
+    }
+    return (cell << 6) | ((insert_code & 0b111) << 3) | (copy_code & 0b111);
+}
+
+// RFC 7932 section 4: the distance codes that refer to the last distances, possibly with a small adjustment.
+static Optional<u16> short_distance_code(size_t distance, Array<size_t, 4> const& distances)
+{
+    for (u16 i = 0; i < distances.size(); i++) {
+        if (distance == distances[i])
+            return i;
+    }
+
+    static constexpr i64 adjustments[6] { -1, 1, -2, 2, -3, 3 };
+    for (u16 i = 0; i < 12; i++) {
+        if (static_cast<i64>(distances[i / 6]) + adjustments[i % 6] == static_cast<i64>(distance))
+            return 4 + i;
+    }
+
+    return {};
+}
+
+namespace {
+
+// A prefix code built from symbol frequencies, in the form the compressor needs for writing it out.
+struct EncodingPrefixCode {
+    Vector<u8> lengths;
+    Vector<u16, 4> used_symbols; // Only filled in for codes with up to four symbols, which are written as simple prefix codes
+    size_t used_symbol_count { 0 };
+    CanonicalCode code;
+
+    ErrorOr<void> write_symbol(LittleEndianOutputBitStream& stream, u32 symbol) const
+    {
+        // A code with only one symbol doesn't take any bits at all.
+        if (used_symbol_count > 1)
+            TRY(code.write_symbol(stream, symbol));
+        return {};
+    }
+};
+
+}
+
+template<size_t Size>
+static ErrorOr<EncodingPrefixCode> build_prefix_code(Array<u32, Size> const& histogram, size_t max_bit_length)
+{
+    EncodingPrefixCode prefix_code;
+
+    // generate_huffman_lengths() works on 16-bit frequencies that also have to add up to at most 16 bits, so larger
+    // histograms are scaled down, keeping every used symbol.
+    u64 total = 0;
+    for (auto count : histogram)
+        total += count;
+    constexpr u64 max_scaled_total = NumericLimits<u16>::max() - Size;
+
+    Array<u16, Size> frequencies {};
+    for (size_t i = 0; i < Size; i++) {
+        if (histogram[i] == 0)
+            continue;
+        frequencies[i] = total <= NumericLimits<u16>::max() ? histogram[i] : max(histogram[i] * max_scaled_total / total, 1u);
+        prefix_code.used_symbol_count++;
+    }
+
+    Array<u8, Size> lengths {};
+    if (prefix_code.used_symbol_count == 0) {
+        // An unused alphabet still needs a code; a single symbol costs the least to describe.
+        frequencies[0] = 1;
+        prefix_code.used_symbol_count = 1;
+    }
+    generate_huffman_lengths(lengths, frequencies, max_bit_length);
+    TRY(prefix_code.lengths.try_append(lengths.data(), lengths.size()));
+
+    if (prefix_code.used_symbol_count > 1)
+        prefix_code.code = TRY(CanonicalCode::from_bytes(lengths));
+
+    if (prefix_code.used_symbol_count <= 4) {
+        // Simple prefix codes list their symbols from the shortest to the longest code.
+        for (u8 length = 1; length <= max_bit_length; length++) {
+            for (size_t symbol = 0; symbol < Size; symbol++) {
+                if (lengths[symbol] == length)
+                    prefix_code.used_symbols.append(symbol);
+            }
+        }
+    }
+
+    return prefix_code;
+}
+
+// RFC 7932 section 3.4: simple prefix codes, and section 3.5: complex prefix codes.
+static ErrorOr<void> write_prefix_code(LittleEndianOutputBitStream& stream, EncodingPrefixCode const& prefix_code, size_t alphabet_size)
+{
+    if (prefix_code.used_symbol_count <= 4) {
+        TRY(stream.write_bits(1u, 2));                                 // HSKIP = 1
+        TRY(stream.write_bits(prefix_code.used_symbol_count - 1, 2)); // NSYM - 1
+        auto symbol_bits = AK::ceil_log2(alphabet_size);
+        for (auto symbol : prefix_code.used_symbols)
+            TRY(stream.write_bits(symbol, symbol_bits));
+        if (prefix_code.used_symbol_count == 4)
+            TRY(stream.write_bits(prefix_code.lengths[prefix_code.used_symbols[0]] == 1 ? 1u : 0u, 1)); // tree-select
+        return {};
+    }
+
+    // Run-length encode the code lengths, the same way the reference encoder does: 16 repeats the previous non-zero
+    // length and 17 repeats zero, where consecutive repeat codes multiply their repeat counts.
+    static constexpr u8 repeat_previous_code_length = 16;
+    static constexpr u8 repeat_zero_code_length = 17;
+    Vector<u8> symbols;
+    Vector<u8> extra_bits;
+
+    auto emit = [&](u8 symbol, u8 extra) -> ErrorOr<void> {
+        TRY(symbols.try_append(symbol));
+        TRY(extra_bits.try_append(extra));
+        return {};
+    };
+    auto emit_repeats = [&](u8 repeat_symbol, size_t repetitions) -> ErrorOr<void> {
+        auto bits = repeat_symbol == repeat_previous_code_length ? 2 : 3;
+        auto start = symbols.size();
+        repetitions -= 3;
+        while (true) {
+            TRY(emit(repeat_symbol, repetitions & ((1 << bits) - 1)));
+            repetitions >>= bits;
+            if (repetitions == 0)
+                break;
+            repetitions--;
+        }
+        symbols.span().slice(start).reverse();
+        extra_bits.span().slice(start).reverse();
+        return {};
+    };
+
+    auto const& lengths = prefix_code.lengths;
+    size_t end = lengths.size();
+    while (lengths[end - 1] == 0)
+        end--;
+
+    u8 previous_length = 8;
+    for (size_t i = 0; i < end;) {
+        auto length = lengths[i];
+        size_t repetitions = 1;
+        while (i + repetitions < end && lengths[i + repetitions] == length)
+            repetitions++;
+        i += repetitions;
+
+        if (length == 0) {
+            if (repetitions == 11) {
+                TRY(emit(0, 0));
+                repetitions--;
+            }
+            if (repetitions < 3) {
+                for (size_t j = 0; j < repetitions; j++)
+                    TRY(emit(0, 0));
+            } else {
+                TRY(emit_repeats(repeat_zero_code_length, repetitions));
+            }
+            continue;
+        }
+
+        if (length != previous_length) {
+            TRY(emit(length, 0));
+            repetitions--;
+        }
+        if (repetitions == 7) {
+            TRY(emit(length, 0));
+            repetitions--;
+        }
+        if (repetitions < 3) {
+            for (size_t j = 0; j < repetitions; j++)
+                TRY(emit(length, 0));
+        } else {
+            TRY(emit_repeats(repeat_previous_code_length, repetitions));
+        }
+        previous_length = length;
+    }
+
+    Array<u32, 18> code_length_histogram {};
+    for (auto symbol : symbols)
+        code_length_histogram[symbol]++;
+    auto code_length_code = TRY(build_prefix_code(code_length_histogram, 5));
+
+    // The code length code lengths are written in this order, and the leading ones can be skipped if they are zero.
+    static constexpr u8 code_length_order[18] { 1, 2, 3, 4, 0, 5, 17, 6, 16, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+    // The code length code lengths themselves are written with a fixed code.
+    struct FixedCode {
+        u8 bits;
+        u8 bit_count;
+    };
+    static constexpr FixedCode code_length_code_length_codes[6] { { 0b00, 2 }, { 0b0111, 4 }, { 0b011, 3 }, { 0b10, 2 }, { 0b01, 2 }, { 0b1111, 4 } };
+
+    auto const& code_length_lengths = code_length_code.lengths;
+    size_t skip = 0;
+    if (code_length_lengths[1] == 0 && code_length_lengths[2] == 0)
+        skip = code_length_lengths[3] == 0 ? 3 : 2;
+
+    // With more than one symbol, the decompressor stops reading as soon as the code is complete.
+    size_t last = array_size(code_length_order) - 1;
+    if (code_length_code.used_symbol_count > 1) {
+        while (code_length_lengths[code_length_order[last]] == 0)
+            last--;
+    }
+
+    TRY(stream.write_bits(skip, 2)); // HSKIP
+    for (size_t i = skip; i <= last; i++) {
+        auto code = code_length_code_length_codes[code_length_lengths[code_length_order[i]]];
+        TRY(stream.write_bits(code.bits, code.bit_count));
+    }
+
+    for (size_t i = 0; i < symbols.size(); i++) {
+        TRY(code_length_code.write_symbol(stream, symbols[i]));
+        if (symbols[i] == repeat_previous_code_length)
+            TRY(stream.write_bits(extra_bits[i], 2));
+        else if (symbols[i] == repeat_zero_code_length)
+            TRY(stream.write_bits(extra_bits[i], 3));
+    }
+
+    return {};
+}
+
+// RFC 7932 section 9.2: the encoding of the block type and tree counts.
+static ErrorOr<void> write_variable_length(LittleEndianOutputBitStream& stream, size_t value)
+{
+    VERIFY(value >= 1 && value <= 256);
+    if (value == 1)
+        return stream.write_bits(0u, 1);
+
+    auto bits = AK::log2(value - 1);
+    TRY(stream.write_bits(1u, 1));
+    TRY(stream.write_bits(bits, 3));
+    TRY(stream.write_bits(value - 1 - (1u << bits), bits));
+    return {};
+}
+
+// RFC 7932 section 7.3: context maps, written with a move-to-front transform and run-length encoded zeros.
+static ErrorOr<void> write_context_map(LittleEndianOutputBitStream& stream, ReadonlySpan<u8> context_map, size_t tree_count)
+{
+    static constexpr size_t max_run_length_code = 16;
+
+    Vector<u8> values;
+    u8 move_to_front[256];
+    for (size_t i = 0; i < 256; i++)
+        move_to_front[i] = i;
+    for (auto tree : context_map) {
+        u8 index = 0;
+        while (move_to_front[index] != tree)
+            index++;
+        TRY(values.try_append(index));
+        for (; index > 0; index--)
+            move_to_front[index] = move_to_front[index - 1];
+        move_to_front[0] = tree;
+    }
+
+    size_t longest_zero_run = 0;
+    for (size_t i = 0; i < values.size();) {
+        size_t run = 0;
+        while (i + run < values.size() && values[i + run] == 0)
+            run++;
+        longest_zero_run = max(longest_zero_run, run);
+        i += max(run, 1u);
+    }
+    size_t run_length_code_count = longest_zero_run >= 2 ? min<size_t>(AK::log2(longest_zero_run), max_run_length_code) : 0;
+
+    struct Symbol {
+        u16 value;
+        u8 extra_bit_count;
+        u32 extra_bits;
+    };
+    Vector<Symbol> symbols;
+    Array<u32, 256 + max_run_length_code> histogram {};
+    for (size_t i = 0; i < values.size();) {
+        if (values[i] != 0) {
+            TRY(symbols.try_append({ static_cast<u16>(values[i] + run_length_code_count), 0, 0 }));
+            i++;
+            continue;
+        }
+
+        size_t run = 0;
+        while (i + run < values.size() && values[i + run] == 0)
+            run++;
+        i += run;
+
+        while (run > 0) {
+            // Run length code k stands for 2^k to 2^(k + 1) - 1 zeros, and zero itself for a single zero.
+            u8 code = min<size_t>(AK::log2(run), run_length_code_count);
+            auto length = min(run, (2u << code) - 1);
+            TRY(symbols.try_append({ code, code, static_cast<u32>(length - (1u << code)) }));
+            run -= length;
+        }
+    }
+    for (auto const& symbol : symbols)
+        histogram[symbol.value]++;
+
+    TRY(stream.write_bits(run_length_code_count > 0 ? 1u : 0u, 1));
+    if (run_length_code_count > 0)
+        TRY(stream.write_bits(run_length_code_count - 1, 4));
+
+    auto code = TRY(build_prefix_code(histogram, 15));
+    TRY(write_prefix_code(stream, code, tree_count + run_length_code_count));
+    for (auto const& symbol : symbols) {
+        TRY(code.write_symbol(stream, symbol.value));
+        TRY(stream.write_bits(symbol.extra_bits, symbol.extra_bit_count));
+    }
+
+    TRY(stream.write_bits(1u, 1)); // IMTF
+    return {};
+}
+
+using LiteralHistogram = Array<u32, 256>;
+
+// An estimate of the bits needed for the symbols of a histogram and for its prefix code.
+static double literal_histogram_cost(LiteralHistogram const& histogram)
+{
+    u64 total = 0;
+    size_t used_symbol_count = 0;
+    double sum = 0;
+    for (auto count : histogram) {
+        if (count == 0)
+            continue;
+        total += count;
+        used_symbol_count++;
+        sum += count * AK::log2(static_cast<double>(count));
+    }
+    if (used_symbol_count <= 1)
+        return 12;
+    return total * AK::log2(static_cast<double>(total)) - sum + 12 + 4 * used_symbol_count;
+}
+
+namespace {
+
+struct LiteralClustering {
+    Array<u8, 64> context_map {};
+    Vector<LiteralHistogram> histograms;
+    double cost { 0 };
+};
+
+}
+
+// Greedily merges the per-context literal histograms for as long as sharing a prefix code is cheaper than keeping them apart.
+static ErrorOr<LiteralClustering> cluster_literal_histograms(Vector<LiteralHistogram> const& context_histograms)
+{
+    static constexpr size_t context_count = 64;
+    VERIFY(context_histograms.size() == context_count);
+
+    Vector<LiteralHistogram> clusters;
+    Vector<double> costs;
+    Array<u8, context_count> cluster_for_context {};
+    for (size_t context = 0; context < context_count; context++) {
+        auto const& histogram = context_histograms[context];
+        if (all_of(histogram, [](auto count) { return count == 0; }))
+            continue;
+        cluster_for_context[context] = clusters.size();
+        TRY(clusters.try_append(histogram));
+        TRY(costs.try_append(literal_histogram_cost(histogram)));
+    }
+    if (clusters.is_empty()) {
+        TRY(clusters.try_append({}));
+        TRY(costs.try_append(literal_histogram_cost({})));
+    }
+
+    auto merge = [](LiteralHistogram const& a, LiteralHistogram const& b) {
+        LiteralHistogram merged;
+        for (size_t i = 0; i < merged.size(); i++)
+            merged[i] = a[i] + b[i];
+        return merged;
+    };
+
+    auto cluster_count = clusters.size();
+    Vector<bool> is_active;
+    TRY(is_active.try_resize(cluster_count));
+    is_active.span().fill(true);
+
+    // The cost change of merging each pair of clusters.
+    Vector<double> merge_costs;
+    TRY(merge_costs.try_resize(cluster_count * cluster_count));
+    auto update_merge_costs = [&](size_t a) {
+        for (size_t b = 0; b < cluster_count; b++) {
+            if (b == a || !is_active[b])
+                continue;
+            auto merge_cost = literal_histogram_cost(merge(clusters[a], clusters[b])) - costs[a] - costs[b];
+            merge_costs[a * cluster_count + b] = merge_cost;
+            merge_costs[b * cluster_count + a] = merge_cost;
+        }
+    };
+    for (size_t a = 0; a < cluster_count; a++)
+        update_merge_costs(a);
+
+    while (true) {
+        Optional<size_t> best_a;
+        size_t best_b = 0;
+        for (size_t a = 0; a < cluster_count; a++) {
+            for (size_t b = a + 1; b < cluster_count; b++) {
+                if (!is_active[a] || !is_active[b])
+                    continue;
+                if (!best_a.has_value() || merge_costs[a * cluster_count + b] < merge_costs[*best_a * cluster_count + best_b]) {
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+        if (!best_a.has_value() || merge_costs[*best_a * cluster_count + best_b] >= 0)
+            break;
+
+        auto a = *best_a;
+        clusters[a] = merge(clusters[a], clusters[best_b]);
+        costs[a] = literal_histogram_cost(clusters[a]);
+        is_active[best_b] = false;
+        for (auto& cluster : cluster_for_context) {
+            if (cluster == best_b)
+                cluster = a;
+        }
+        update_merge_costs(a);
+    }
+
+    // Number the remaining clusters in the order they're first used, which the move-to-front transform likes best.
+    LiteralClustering clustering;
+    Array<Optional<u8>, context_count> renumbered {};
+    for (size_t context = 0; context < context_count; context++) {
+        auto cluster = cluster_for_context[context];
+        if (!renumbered[cluster].has_value()) {
+            renumbered[cluster] = clustering.histograms.size();
+            TRY(clustering.histograms.try_append(clusters[cluster]));
+            clustering.cost += costs[cluster];
+        }
+        clustering.context_map[context] = *renumbered[cluster];
+    }
+
+    return clustering;
+}
+
+// RFC 7932 section 9.2: the meta-block header, for a meta-block that isn't the last one.
+static ErrorOr<void> write_meta_block_header(LittleEndianOutputBitStream& stream, size_t length, bool is_uncompressed)
+{
+    VERIFY(length >= 1 && length <= 1 << 24);
+    size_t nibbles = length - 1 < (1 << 16) ? 4 : (length - 1 < (1 << 20) ? 5 : 6);
+
+    TRY(stream.write_bits(0u, 1));           // ISLAST
+    TRY(stream.write_bits(nibbles - 4, 2));  // MNIBBLES
+    TRY(stream.write_bits(length - 1, nibbles * 4)); // MLEN - 1
+    TRY(stream.write_bits(is_uncompressed ? 1u : 0u, 1)); // ISUNCOMPRESSED
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<BrotliCompressor>> BrotliCompressor::construct(MaybeOwned<Stream> stream, u8 quality, u8 window_bits)
+{
+    VERIFY(quality <= max_quality);
+    VERIFY(window_bits >= min_window_bits && window_bits <= max_window_bits);
+
+    auto bit_stream = TRY(try_make<LittleEndianOutputBitStream>(move(stream)));
+    auto hash_head = TRY(FixedArray<u32>::create(1 << hash_bits));
+    auto hash_chain = TRY(FixedArray<u32>::create(1 << window_bits));
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) BrotliCompressor(move(bit_stream), quality, window_bits, move(hash_head), move(hash_chain))));
+
+    // RFC 7932 section 9.1: WBITS
+    auto& output_stream = *compressor->m_output_stream;
+    if (window_bits == 16) {
+        TRY(output_stream.write_bits(0u, 1));
+    } else if (window_bits > 17) {
+        TRY(output_stream.write_bits(1u, 1));
+        TRY(output_stream.write_bits(window_bits - 17u, 3));
+    } else {
+        TRY(output_stream.write_bits(1u, 1));
+        TRY(output_stream.write_bits(0u, 3));
+        TRY(output_stream.write_bits(window_bits == 17 ? 0u : window_bits - 8u, 3));
+    }
+
+    return compressor;
+}
+
+BrotliCompressor::BrotliCompressor(NonnullOwnPtr<LittleEndianOutputBitStream> stream, u8 quality, u8 window_bits, FixedArray<u32> hash_head, FixedArray<u32> hash_chain)
+    : m_parameters(quality_parameters[quality])
+    , m_window_bits(window_bits)
+    , m_window_size((1u << window_bits) - 16)
+    , m_output_stream(move(stream))
+    , m_hash_head(move(hash_head))
+    , m_hash_chain(move(hash_chain))
+{
+}
+
+BrotliCompressor::~BrotliCompressor()
+{
+    VERIFY(m_finished);
+}
+
+ErrorOr<Bytes> BrotliCompressor::read_some(Bytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+ErrorOr<size_t> BrotliCompressor::write_some(ReadonlyBytes bytes)
+{
+    VERIFY(!m_finished);
+
+    size_t total_written = 0;
+    while (!bytes.is_empty()) {
+        auto pending_size = m_buffer.size() - m_pending_offset;
+        auto n_written = min(bytes.size(), meta_block_size - pending_size);
+        TRY(m_buffer.try_append(bytes.trim(n_written)));
+
+        if (pending_size + n_written == meta_block_size)
+            TRY(compress_meta_block());
+
+        bytes = bytes.slice(n_written);
+        total_written += n_written;
+    }
+    return total_written;
+}
+
+bool BrotliCompressor::is_eof() const
+{
+    return true;
+}
+
+bool BrotliCompressor::is_open() const
+{
+    return m_output_stream->is_open();
+}
+
+void BrotliCompressor::close()
+{
+}
+
+void BrotliCompressor::insert_hash(size_t position)
+{
+    auto stream_position = static_cast<u32>(m_buffer_offset + position);
+    auto hash = hash_four_bytes(m_buffer.data() + position, hash_bits);
+    m_hash_chain[stream_position & (m_hash_chain.size() - 1)] = m_hash_head[hash];
+    m_hash_head[hash] = stream_position;
+}
+
+size_t BrotliCompressor::match_length_at(size_t position, size_t distance, size_t max_length) const
+{
+    auto const* current = m_buffer.data() + position;
+    auto const* reference = current - distance;
+
+    size_t length = 0;
+    while (length + sizeof(u64) <= max_length) {
+        u64 current_word;
+        u64 reference_word;
+        __builtin_memcpy(&current_word, current + length, sizeof(u64));
+        __builtin_memcpy(&reference_word, reference + length, sizeof(u64));
+        if (current_word != reference_word)
+            return length + count_trailing_zeroes(current_word ^ reference_word) / 8;
+        length += sizeof(u64);
+    }
+    while (length < max_length && current[length] == reference[length])
+        length++;
+    return length;
+}
+
+BrotliCompressor::Match BrotliCompressor::find_best_match(size_t position, size_t max_length, Array<size_t, 4> const& distances) const
+{
+    Match best_match;
+    auto stream_position = m_buffer_offset + position;
+    size_t max_distance = min<u64>(stream_position, m_window_size);
+    auto nice_length = min(m_parameters.nice_match_length, max_length);
+
+    for (size_t i = 0; i < distances.size(); i++) {
+        auto distance = distances[i];
+        if (distance > max_distance)
+            continue;
+        auto length = match_length_at(position, distance, max_length);
+        if (length < min_match_length)
+            continue;
+        auto score = last_distance_score(length, i);
+        if (score > best_match.score)
+            best_match = { length, distance, length, score, false };
+    }
+
+    auto candidate = m_hash_head[hash_four_bytes(m_buffer.data() + position, hash_bits)];
+    size_t previous_distance = 0;
+    for (size_t chain = 0; chain < m_parameters.max_chain_length && best_match.length < nice_length; chain++) {
+        size_t distance = static_cast<u32>(static_cast<u32>(stream_position) - candidate);
+        if (distance <= previous_distance || distance > max_distance)
+            break;
+        previous_distance = distance;
+
+        // A candidate can only be better if it also matches the byte just past the current best match.
+        if (m_buffer[position + best_match.length] == m_buffer[position - distance + best_match.length]) {
+            auto length = match_length_at(position, distance, max_length);
+            if (length >= min_match_length) {
+                auto score = backward_reference_score(length, distance);
+                if (score > best_match.score)
+                    best_match = { length, distance, length, score, false };
+            }
+        }
+
+        candidate = m_hash_chain[candidate & (m_hash_chain.size() - 1)];
+    }
+
+    if (m_parameters.static_dictionary && best_match.length < nice_length) {
+        if (auto word = BrotliDictionary::find_longest_match(m_buffer.bytes().slice(position, max_length)); word.has_value()) {
+            // Dictionary words are referenced with the distances just beyond the window.
+            auto distance = max_distance + 1 + word->index;
+            auto score = backward_reference_score(word->output_length, distance);
+            if (score > best_match.score)
+                best_match = { word->output_length, distance, word->length, score, true };
+        }
+    }
+
+    if (best_match.score < min_score)
+        return {};
+    return best_match;
+}
+
+BrotliCompressor::Command BrotliCompressor::make_command(size_t insert_length, Match const& match, Array<size_t, 4>& distances) const
+{
+    Command command {};
+    command.insert_length = insert_length;
+    auto insert_code = insert_length_code(insert_length);
+    command.insert_extra_bits = insert_length - insert_length_base[insert_code];
+    command.insert_extra_bit_count = insert_length_extra[insert_code];
+
+    if (match.length == 0) {
+        // A command at the end of a meta-block may only insert literals, the decompressor stops before the copy.
+        command.symbol = insert_and_copy_symbol(insert_code, 0, insert_code < 8);
+        return command;
+    }
+
+    command.output_length = match.length;
+    auto copy_code = copy_length_code(match.copy_length);
+    command.copy_extra_bits = match.copy_length - copy_length_base[copy_code];
+    command.copy_extra_bit_count = copy_length_extra[copy_code];
+
+    Optional<u16> distance_code;
+    if (!match.is_dictionary_word)
+        distance_code = short_distance_code(match.distance, distances);
+
+    if (distance_code.has_value()) {
+        command.distance_symbol = *distance_code;
+    } else {
+        // With NPOSTFIX and NDIRECT both zero, distance + 3 lies in [2 << n, 4 << n) for a code with n extra bits.
+        auto value = match.distance + 3;
+        auto extra_bit_count = AK::log2(value) - 1;
+        command.distance_symbol = 16 + 2 * (extra_bit_count - 1) + ((value >> extra_bit_count) & 1);
+        command.distance_extra_bits = value & ((1u << extra_bit_count) - 1);
+        command.distance_extra_bit_count = extra_bit_count;
+    }
+
+    // The most recent distance doesn't need a distance symbol at all when the lengths are short enough.
+    auto implicit_zero_distance = command.distance_symbol == 0 && insert_code < 8 && copy_code < 16;
+    command.symbol = insert_and_copy_symbol(insert_code, copy_code, implicit_zero_distance);
+    command.has_distance_symbol = !implicit_zero_distance;
+
+    // Dictionary references and repeats of the most recent distance don't enter the last distances.
+    if (!match.is_dictionary_word && command.distance_symbol != 0) {
+        distances[3] = distances[2];
+        distances[2] = distances[1];
+        distances[1] = distances[0];
+        distances[0] = match.distance;
+    }
+
+    return command;
+}
+
+ErrorOr<Vector<BrotliCompressor::Command>> BrotliCompressor::find_commands(size_t start, size_t length, Array<size_t, 4>& distances)
+{
+    Vector<Command> commands;
+    auto end = start + length;
+    auto literal_start = start;
+    auto position = start;
+
+    while (position + min_match_length <= end) {
+        auto match = find_best_match(position, end - position, distances);
+        insert_hash(position);
+        if (match.length == 0) {
+            position++;
+            continue;
+        }
+
+        if (m_parameters.lazy_matching) {
+            for (size_t deferrals = 0; deferrals < max_lazy_match_deferrals && match.length < m_parameters.nice_match_length && position + 1 + min_match_length <= end; deferrals++) {
+                auto next_match = find_best_match(position + 1, end - position - 1, distances);
+                if (next_match.score < match.score + lazy_match_score_margin)
+                    break;
+                position++;
+                insert_hash(position);
+                match = next_match;
+            }
+        }
+
+        TRY(commands.try_append(make_command(position - literal_start, match, distances)));
+
+        auto match_end = position + match.length;
+        for (position++; position < match_end && position + min_match_length <= end; position++)
+            insert_hash(position);
+        position = match_end;
+        literal_start = position;
+    }
+
+    if (literal_start < end)
+        TRY(commands.try_append(make_command(end - literal_start, {}, distances)));
+
+    return commands;
+}
+
+u8 BrotliCompressor::literal_context_at(u8 context_mode, size_t position) const
+{
+    auto stream_position = m_buffer_offset + position;
+    u8 previous_byte = stream_position >= 1 ? m_buffer[position - 1] : 0;
+    u8 second_previous_byte = stream_position >= 2 ? m_buffer[position - 2] : 0;
+    return literal_context_id(context_mode, previous_byte, second_previous_byte);
+}
+
+ErrorOr<void> BrotliCompressor::write_compressed_meta_block(LittleEndianOutputBitStream& stream, size_t start, size_t length, Vector<Command> const& commands)
+{
+    static constexpr size_t literal_alphabet_size = 256;
+    static constexpr size_t insert_and_copy_alphabet_size = 704;
+    static constexpr size_t distance_alphabet_size = 16 + 48; // NPOSTFIX = 0, NDIRECT = 0
+    static constexpr size_t context_count = 64;
+
+    Array<u32, insert_and_copy_alphabet_size> insert_and_copy_histogram {};
+    Array<u32, distance_alphabet_size> distance_histogram {};
+    for (auto const& command : commands) {
+        insert_and_copy_histogram[command.symbol]++;
+        if (command.has_distance_symbol)
+            distance_histogram[command.distance_symbol]++;
+    }
+
+    auto for_each_literal = [&](auto callback) {
+        auto position = start;
+        for (auto const& command : commands) {
+            for (size_t i = 0; i < command.insert_length; i++, position++)
+                callback(position);
+            position += command.output_length;
+        }
+    };
+
+    // With context modeling, the literal contexts are clustered for both the UTF-8 and the signed context modes,
+    // and the cheaper of the two is used, unless a single prefix code for all literals is cheaper still.
+    u8 context_mode = 0;
+    LiteralClustering clustering;
+    LiteralHistogram histogram {};
+    for_each_literal([&](size_t position) { histogram[m_buffer[position]]++; });
+    TRY(clustering.histograms.try_append(histogram));
+    clustering.cost = literal_histogram_cost(histogram);
+
+    if (m_parameters.context_modeling) {
+        for (u8 candidate_mode : { 2, 3 }) {
+            Vector<LiteralHistogram> context_histograms;
+            TRY(context_histograms.try_resize(context_count));
+            for_each_literal([&](size_t position) {
+                context_histograms[literal_context_at(candidate_mode, position)][m_buffer[position]]++;
+            });
+            auto candidate = TRY(cluster_literal_histograms(context_histograms));
+            // A rough estimate of the size of the context map, which is only written for more than one cluster.
+            if (candidate.histograms.size() > 1)
+                candidate.cost += 4 * context_count;
+            if (candidate.cost < clustering.cost) {
+                clustering = move(candidate);
+                context_mode = candidate_mode;
+            }
+        }
+    }
+
+    Vector<EncodingPrefixCode> literal_codes;
+    for (auto const& histogram : clustering.histograms)
+        TRY(literal_codes.try_append(TRY(build_prefix_code(histogram, 15))));
+    auto insert_and_copy_code = TRY(build_prefix_code(insert_and_copy_histogram, 15));
+    auto distance_code = TRY(build_prefix_code(distance_histogram, 15));
+
+    TRY(write_meta_block_header(stream, length, false));
+    TRY(write_variable_length(stream, 1)); // NBLTYPESL
+    TRY(write_variable_length(stream, 1)); // NBLTYPESI
+    TRY(write_variable_length(stream, 1)); // NBLTYPESD
+    TRY(stream.write_bits(0u, 2));         // NPOSTFIX
+    TRY(stream.write_bits(0u, 4));         // NDIRECT >> NPOSTFIX
+    TRY(stream.write_bits(context_mode, 2));
+    TRY(write_variable_length(stream, literal_codes.size())); // NTREESL
+    if (literal_codes.size() > 1)
+        TRY(write_context_map(stream, clustering.context_map, literal_codes.size()));
+    TRY(write_variable_length(stream, 1)); // NTREESD
+
+    for (auto const& literal_code : literal_codes)
+        TRY(write_prefix_code(stream, literal_code, literal_alphabet_size));
+    TRY(write_prefix_code(stream, insert_and_copy_code, insert_and_copy_alphabet_size));
+    TRY(write_prefix_code(stream, distance_code, distance_alphabet_size));
+
+    auto position = start;
+    for (auto const& command : commands) {
+        TRY(insert_and_copy_code.write_symbol(stream, command.symbol));
+        TRY(stream.write_bits(command.insert_extra_bits, command.insert_extra_bit_count));
+        TRY(stream.write_bits(command.copy_extra_bits, command.copy_extra_bit_count));
+
+        for (size_t i = 0; i < command.insert_length; i++, position++) {
+            auto tree = literal_codes.size() > 1 ? clustering.context_map[literal_context_at(context_mode, position)] : 0;
+            TRY(literal_codes[tree].write_symbol(stream, m_buffer[position]));
+        }
+
+        if (command.has_distance_symbol && command.output_length != 0) {
+            TRY(distance_code.write_symbol(stream, command.distance_symbol));
+            TRY(stream.write_bits(command.distance_extra_bits, command.distance_extra_bit_count));
+        }
+        position += command.output_length;
+    }
+
+    return {};
+}
+
+ErrorOr<void> BrotliCompressor::compress_meta_block()
+{
+    auto start = m_pending_offset;
+    auto length = m_buffer.size() - start;
+    if (length == 0)
+        return {};
+
+    auto distances = m_distances;
+    auto commands = TRY(find_commands(start, length, distances));
+
+    // The meta-block is compressed on the side, so that it can be stored uncompressed instead if that's smaller.
+    AllocatingMemoryStream compressed_stream;
+    size_t compressed_bit_count;
+    {
+        LittleEndianOutputBitStream bit_stream { MaybeOwned<Stream>(compressed_stream) };
+        TRY(write_compressed_meta_block(bit_stream, start, length, commands));
+        compressed_bit_count = compressed_stream.used_buffer_size() * 8 + bit_stream.bit_offset();
+        TRY(bit_stream.align_to_byte_boundary());
+        TRY(bit_stream.flush_buffer_to_stream());
+    }
+
+    // An uncompressed meta-block has the same header, but without the prefix codes, and is padded to a byte boundary.
+    size_t nibbles = length - 1 < (1 << 16) ? 4 : (length - 1 < (1 << 20) ? 5 : 6);
+    auto header_bit_count = 4 + nibbles * 4;
+    auto padding_bit_count = (8 - (m_output_stream->bit_offset() + header_bit_count) % 8) % 8;
+
+    if (compressed_bit_count < header_bit_count + padding_bit_count + length * 8) {
+        auto compressed = TRY(ByteBuffer::create_uninitialized(compressed_stream.used_buffer_size()));
+        TRY(compressed_stream.read_until_filled(compressed));
+
+        auto full_byte_count = compressed_bit_count / 8;
+        if (m_output_stream->bit_offset() % 8 == 0) {
+            TRY(m_output_stream->write_until_depleted(compressed.bytes().trim(full_byte_count)));
+        } else {
+            for (size_t i = 0; i < full_byte_count; i++)
+                TRY(m_output_stream->write_bits(compressed[i], 8));
+        }
+        if (auto remaining_bit_count = compressed_bit_count % 8; remaining_bit_count != 0)
+            TRY(m_output_stream->write_bits(compressed[full_byte_count], remaining_bit_count));
+
+        m_distances = distances;
+    } else {
+        TRY(write_meta_block_header(*m_output_stream, length, true));
+        TRY(m_output_stream->align_to_byte_boundary());
+        TRY(m_output_stream->write_until_depleted(m_buffer.bytes().slice(start, length)));
+    }
+
+    // Only keep as much history as the window can reach.
+    m_pending_offset = m_buffer.size();
+    if (m_pending_offset > m_window_size) {
+        auto discarded_size = m_pending_offset - m_window_size;
+        __builtin_memmove(m_buffer.data(), m_buffer.data() + discarded_size, m_window_size);
+        m_buffer.resize(m_window_size);
+        m_buffer_offset += discarded_size;
+        m_pending_offset = m_window_size;
+    }
+
+    return {};
+}
+
+ErrorOr<void> BrotliCompressor::final_flush()
+{
+    VERIFY(!m_finished);
+    m_finished = true;
+    TRY(compress_meta_block());
+
+    // RFC 7932 section 9.2: an empty last meta-block
+    TRY(m_output_stream->write_bits(1u, 1)); // ISLAST
+    TRY(m_output_stream->write_bits(1u, 1)); // ISLASTEMPTY
+    TRY(m_output_stream->align_to_byte_boundary());
+    TRY(m_output_stream->flush_buffer_to_stream());
+    return {};
+}
+
+ErrorOr<ByteBuffer> BrotliCompressor::compress_all(ReadonlyBytes bytes, u8 quality)
+{
+    u8 window_bits = min_window_bits;
+    while (window_bits < default_window_bits && (1u << window_bits) - 16 < bytes.size())
+        window_bits++;
+
+    auto output_stream = TRY(try_make<AllocatingMemoryStream>());
+    auto brotli_stream = TRY(BrotliCompressor::construct(MaybeOwned<Stream>(*output_stream), quality, window_bits));
+
+    TRY(brotli_stream->write_until_depleted(bytes));
+    TRY(brotli_stream->final_flush());
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+    TRY(output_stream->read_until_filled(buffer));
+
+    return buffer;
+}
+
 }
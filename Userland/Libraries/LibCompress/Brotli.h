@@ -6,9 +6,13 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/BitStream.h>
+#include <AK/ByteBuffer.h>
 #include <AK/CircularQueue.h>
 #include <AK/FixedArray.h>
+#include <AK/MaybeOwned.h>
+#include <AK/NonnullOwnPtr.h>
 #include <AK/Vector.h>
 
 namespace Compress {
@@ -162,4 +166,112 @@ private:
     Vector<CanonicalCode> m_distance_codes;
 };
 
+class BrotliCompressor final : public Stream {
+public:
+    static constexpr u8 min_quality = 0;
+    static constexpr u8 max_quality = 11;
+    static constexpr u8 default_quality = 11;
+
+    static constexpr u8 min_window_bits = 10;
+    static constexpr u8 max_window_bits = 24;
+    static constexpr u8 default_window_bits = 22;
+
+    // Input is compressed in meta-blocks of this size, each with its own prefix codes.
+    static constexpr size_t meta_block_size = 256 * KiB;
+
+    static ErrorOr<NonnullOwnPtr<BrotliCompressor>> construct(MaybeOwned<Stream>, u8 quality = default_quality, u8 window_bits = default_window_bits);
+    ~BrotliCompressor();
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+    ErrorOr<void> final_flush();
+
+    // Uses the smallest window that covers the input, so that decompressors can get away with less memory.
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes, u8 quality = default_quality);
+
+private:
+    struct QualityParameters {
+        size_t max_chain_length;  // We only check the max_chain_length closest matches with the same hash
+        size_t nice_match_length; // Once we find a match at least this long, we stop looking for longer ones
+        bool lazy_matching;       // Whether to defer a match when the next position has a better one
+        bool context_modeling;    // Whether literals are coded with separate prefix codes depending on the preceding bytes
+        bool static_dictionary;   // Whether to look for matches in the built-in dictionary as well
+    };
+
+    static constexpr QualityParameters quality_parameters[] = {
+        { 1, 16, false, false, false },
+        { 2, 32, false, false, false },
+        { 4, 32, false, false, false },
+        { 8, 64, false, false, false },
+        { 16, 64, true, false, false },
+        { 16, 128, true, true, false },
+        { 32, 128, true, true, false },
+        { 64, 256, true, true, false },
+        { 128, 256, true, true, false },
+        { 256, 512, true, true, true },
+        { 1024, 1024, true, true, true },
+        { 4096, 4096, true, true, true },
+    };
+    static_assert(array_size(quality_parameters) == max_quality + 1);
+
+    static constexpr size_t hash_bits = 17;
+    static constexpr size_t min_match_length = 4;
+
+    struct Match {
+        size_t length { 0 };        // The number of bytes the match produces
+        size_t distance { 0 };      // Either a backward distance, or the distance that refers to a dictionary word
+        size_t copy_length { 0 };   // The copy length to encode, which differs from `length` for dictionary words
+        size_t score { 0 };
+        bool is_dictionary_word { false };
+    };
+
+    struct Command {
+        u32 insert_length;
+        u32 output_length; // The number of bytes produced by the copy, zero for a final command that only inserts literals
+        u16 symbol;
+        u16 distance_symbol;
+        bool has_distance_symbol;
+        u32 insert_extra_bits;
+        u8 insert_extra_bit_count;
+        u32 copy_extra_bits;
+        u8 copy_extra_bit_count;
+        u32 distance_extra_bits;
+        u8 distance_extra_bit_count;
+    };
+
+    BrotliCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>, u8 quality, u8 window_bits, FixedArray<u32> hash_head, FixedArray<u32> hash_chain);
+
+    void insert_hash(size_t position);
+    size_t match_length_at(size_t position, size_t distance, size_t max_length) const;
+    Match find_best_match(size_t position, size_t max_length, Array<size_t, 4> const& distances) const;
+    Command make_command(size_t insert_length, Match const&, Array<size_t, 4>& distances) const;
+    ErrorOr<Vector<Command>> find_commands(size_t start, size_t length, Array<size_t, 4>& distances);
+
+    u8 literal_context_at(u8 context_mode, size_t position) const;
+    ErrorOr<void> write_compressed_meta_block(LittleEndianOutputBitStream&, size_t start, size_t length, Vector<Command> const&);
+    ErrorOr<void> compress_meta_block();
+
+    bool m_finished { false };
+    QualityParameters m_parameters;
+    u8 m_window_bits;
+    size_t m_window_size;
+    NonnullOwnPtr<LittleEndianOutputBitStream> m_output_stream;
+
+    // Holds up to m_window_size bytes of already compressed history, followed by the pending input.
+    ByteBuffer m_buffer;
+    u64 m_buffer_offset { 0 }; // The position of the start of m_buffer in the uncompressed stream
+    size_t m_pending_offset { 0 };
+
+    // Hash chains of stream positions, truncated to 32 bits. Candidates are always verified against the data,
+    // so a stale or wrapped-around position can only cost time.
+    FixedArray<u32> m_hash_head;
+    FixedArray<u32> m_hash_chain;
+
+    // The four most recently used distances, as tracked by the decompressor.
+    Array<size_t, 4> m_distances { 4, 11, 15, 16 };
+};
+
 }
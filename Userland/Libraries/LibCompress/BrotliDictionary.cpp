@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/CharacterTypes.h>
 #include <AK/Types.h>
+#include <AK/Vector.h>
 #include <LibCompress/BrotliDictionary.h>
 
 // Include the 119.9 KiB of dictionary data from a binary file
@@ -249,4 +251,140 @@ ErrorOr<ByteBuffer> BrotliDictionary::lookup_word(size_t index, size_t length)
     return bb;
 }
 
+static constexpr size_t min_word_length = 4;
+static constexpr size_t max_word_length = 24;
+
+static ReadonlyBytes base_word(size_t length, size_t word_index)
+{
+    return { brotli_dictionary_data + offset_by_length[length] + (word_index * length), length };
+}
+
+static constexpr size_t word_hash_bits = 14;
+
+static u32 hash_word_start(u8 const* bytes)
+{
+    u32 value = bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<u32>(bytes[3]) << 24;
+    return (value * 0x1e35a7bd) >> (32 - word_hash_bits);
+}
+
+namespace {
+
+struct WordTable {
+    // All words, bucketed by the hash of their first four bytes, as (length << 11) | word index.
+    Vector<u16> words;
+    Vector<u32> bucket_offsets;
+};
+
+struct TransformationGroup {
+    StringView prefix;
+    Vector<u8> transformation_ids;
+};
+
+}
+
+static WordTable const& word_table()
+{
+    static WordTable const table = [] {
+        WordTable table;
+        table.bucket_offsets.resize((1 << word_hash_bits) + 1);
+
+        for (size_t length = min_word_length; length <= max_word_length; length++) {
+            for (size_t word_index = 0; word_index < (1u << bits_by_length[length]); word_index++)
+                table.bucket_offsets[hash_word_start(base_word(length, word_index).data()) + 1]++;
+        }
+        for (size_t i = 1; i < table.bucket_offsets.size(); i++)
+            table.bucket_offsets[i] += table.bucket_offsets[i - 1];
+
+        table.words.resize(table.bucket_offsets.last());
+        auto next_offsets = table.bucket_offsets;
+        for (size_t length = min_word_length; length <= max_word_length; length++) {
+            for (size_t word_index = 0; word_index < (1u << bits_by_length[length]); word_index++) {
+                auto hash = hash_word_start(base_word(length, word_index).data());
+                table.words[next_offsets[hash]++] = (length << 11) | word_index;
+            }
+        }
+
+        return table;
+    }();
+    return table;
+}
+
+static Vector<TransformationGroup> const& searchable_transformation_groups()
+{
+    static Vector<TransformationGroup> const groups = [] {
+        Vector<TransformationGroup> groups;
+        for (size_t id = 0; id < array_size(transformations); id++) {
+            auto const& transformation = transformations[id];
+            if (transformation.operation != Identity && transformation.operation != FermentFirst)
+                continue;
+
+            auto group = groups.find_if([&](auto const& group) { return group.prefix == transformation.prefix; });
+            if (group.is_end()) {
+                groups.append({ transformation.prefix, {} });
+                groups.last().transformation_ids.append(id);
+            } else {
+                group->transformation_ids.append(id);
+            }
+        }
+        return groups;
+    }();
+    return groups;
+}
+
+Optional<BrotliDictionary::Match> BrotliDictionary::find_longest_match(ReadonlyBytes data)
+{
+    auto const& table = word_table();
+    Optional<Match> best_match;
+
+    for (auto const& group : searchable_transformation_groups()) {
+        if (!data.starts_with(group.prefix.bytes()))
+            continue;
+
+        auto word_data = data.slice(group.prefix.length());
+        if (word_data.size() < min_word_length)
+            continue;
+
+        // A capitalized word is found by looking up its lowercase form and is then encoded with FermentFirst.
+        for (auto capitalized : { false, true }) {
+            u8 word_start[4] { word_data[0], word_data[1], word_data[2], word_data[3] };
+            if (capitalized) {
+                if (!is_ascii_upper_alpha(word_start[0]))
+                    continue;
+                word_start[0] = to_ascii_lowercase(word_start[0]);
+            }
+
+            auto hash = hash_word_start(word_start);
+            for (auto i = table.bucket_offsets[hash]; i < table.bucket_offsets[hash + 1]; i++) {
+                size_t length = table.words[i] >> 11;
+                size_t word_index = table.words[i] & 0x7ff;
+                if (length > word_data.size())
+                    continue;
+
+                auto word = base_word(length, word_index);
+                if (word[0] != word_start[0] || word.slice(1) != word_data.slice(1, length - 1))
+                    continue;
+
+                auto operation = capitalized ? FermentFirst : Identity;
+                auto remaining_data = word_data.slice(length);
+                for (auto id : group.transformation_ids) {
+                    auto const& transformation = transformations[id];
+                    if (transformation.operation != operation || !remaining_data.starts_with(transformation.suffix.bytes()))
+                        continue;
+
+                    Match match {
+                        .index = (static_cast<size_t>(id) << bits_by_length[length]) | word_index,
+                        .length = length,
+                        .output_length = group.prefix.length() + length + transformation.suffix.length(),
+                    };
+                    if (!best_match.has_value() || match.output_length > best_match->output_length
+                        || (match.output_length == best_match->output_length && match.index < best_match->index))
+                        best_match = match;
+                }
+            }
+        }
+    }
+
+    return best_match;
+}
+
 }
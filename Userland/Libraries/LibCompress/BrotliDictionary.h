@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
 
 namespace Compress {
 
@@ -26,7 +27,18 @@ public:
         StringView suffix;
     };
 
+    struct Match {
+        size_t index;         // The word index and transformation ID, as passed to lookup_word()
+        size_t length;        // The length of the untransformed word, which is what a copy command encodes
+        size_t output_length; // The length of the transformed word
+    };
+
     static ErrorOr<ByteBuffer> lookup_word(size_t index, size_t length);
+
+    // Finds the transformed word that matches the longest prefix of `data`. Only the transformations that leave the
+    // word itself intact or capitalize its first letter are searched, as those are the ones that can be looked up
+    // by the word's first bytes.
+    static Optional<Match> find_longest_match(ReadonlyBytes data);
 };
 
 }
@@ -7,13 +7,16 @@
 
 #include <AK/Array.h>
 #include <AK/Assertions.h>
-#include <AK/BinaryHeap.h>
+#include <AK/Atomic.h>
 #include <AK/BinarySearch.h>
 #include <AK/BitStream.h>
 #include <AK/MemoryStream.h>
+#include <AK/ScopeGuard.h>
 #include <string.h>
 
 #include <LibCompress/Deflate.h>
+#include <LibCompress/Huffman.h>
+#include <LibThreading/Thread.h>
 
 namespace Compress {
 
@@ -174,176 +177,361 @@ ErrorOr<void> CanonicalCode::write_symbol(LittleEndianOutputBitStream& stream, u
     return {};
 }
 
-DeflateDecompressor::CompressedBlock::CompressedBlock(DeflateDecompressor& decompressor, CanonicalCode literal_codes, Optional<CanonicalCode> distance_codes)
-    : m_decompressor(decompressor)
-    , m_literal_codes(literal_codes)
-    , m_distance_codes(distance_codes)
+// The number of bits that index the primary tables; longer codes continue in subtables.
+static constexpr size_t literal_length_table_bits = 10;
+static constexpr size_t distance_table_bits = 8;
+static constexpr size_t max_huffman_symbols = 288;
+
+DeflateDecompressor::DecodeTable::DecodeTable()
 {
+    // Without any codes, every lookup yields an invalid entry.
+    m_entries.append({});
 }
 
-ErrorOr<bool> DeflateDecompressor::CompressedBlock::try_read_more()
+ErrorOr<DeflateDecompressor::DecodeTable> DeflateDecompressor::DecodeTable::create(ReadonlyBytes code_lengths, Alphabet alphabet)
 {
-    if (m_eof == true)
-        return false;
+    auto make_entry = [](Kind kind, u16 value, u8 code_length, u8 extra_bits = 0) {
+        return Entry { value, code_length, static_cast<u8>(to_underlying(kind) << 5 | extra_bits) };
+    };
+
+    auto entry_for_symbol = [&](size_t symbol, u8 code_length) {
+        if (alphabet == Alphabet::Distance) {
+            if (symbol >= 30)
+                return make_entry(Kind::Invalid, 0, code_length);
+            return make_entry(Kind::Distance, packed_distances[symbol].base_distance, code_length, packed_distances[symbol].extra_bits);
+        }
+
+        if (symbol < 256)
+            return make_entry(Kind::Literal, symbol, code_length);
+        if (symbol == 256)
+            return make_entry(Kind::EndOfBlock, 0, code_length);
+        if (symbol >= 286)
+            return make_entry(Kind::Invalid, 0, code_length);
+        auto const& length_symbol = packed_length_symbols[symbol - 257];
+        return make_entry(Kind::Length, length_symbol.base_length, code_length, length_symbol.extra_bits);
+    };
 
-    auto const symbol = TRY(m_literal_codes.read_symbol(*m_decompressor.m_input_stream));
+    VERIFY(code_lengths.size() <= max_huffman_symbols);
 
-    if (symbol >= 286)
-        return Error::from_string_literal("Invalid deflate literal/length symbol");
+    DecodeTable table;
+    table.m_primary_bits = alphabet == Alphabet::LiteralLength ? literal_length_table_bits : distance_table_bits;
 
-    if (symbol < 256) {
-        u8 byte_symbol = symbol;
-        m_decompressor.m_output_buffer.write({ &byte_symbol, sizeof(byte_symbol) });
-        return true;
+    Array<u16, 16> length_counts {};
+    size_t non_zero_symbols = 0;
+    size_t last_non_zero = 0;
+    for (size_t symbol = 0; symbol < code_lengths.size(); ++symbol) {
+        if (code_lengths[symbol] > 15)
+            return Error::from_string_literal("Failed to decode code lengths");
+        if (code_lengths[symbol] == 0)
+            continue;
+        length_counts[code_lengths[symbol]]++;
+        non_zero_symbols++;
+        last_non_zero = symbol;
+    }
+
+    if (non_zero_symbols == 1) { // special case - only 1 symbol, which is encoded with a single bit
+        table.m_primary_bits = 1;
+        TRY(table.m_entries.try_resize(2));
+        table.m_entries[0] = entry_for_symbol(last_non_zero, 1);
+        table.m_entries[1] = table.m_entries[0];
+        return table;
+    }
+
+    // The code must be neither over-subscribed nor incomplete.
+    i32 remaining_codes = 1;
+    for (size_t code_length = 1; code_length <= 15; ++code_length) {
+        remaining_codes = remaining_codes * 2 - length_counts[code_length];
+        if (remaining_codes < 0)
+            return Error::from_string_literal("Failed to decode code lengths");
     }
+    if (remaining_codes != 0)
+        return Error::from_string_literal("Failed to decode code lengths");
+
+    // Assign the canonical codes, bit-reversed since DEFLATE reads Huffman codes starting from their most significant bit.
+    Array<u16, 16> next_code {};
+    for (size_t code_length = 1; code_length <= 15; ++code_length)
+        next_code[code_length] = (next_code[code_length - 1] + length_counts[code_length - 1]) << 1;
 
-    if (symbol == 256) {
-        m_eof = true;
-        return false;
+    Array<u16, max_huffman_symbols> reversed_codes {};
+    for (size_t symbol = 0; symbol < code_lengths.size(); ++symbol) {
+        if (auto code_length = code_lengths[symbol]; code_length != 0)
+            reversed_codes[symbol] = fast_reverse16(next_code[code_length]++, code_length);
     }
 
-    if (!m_distance_codes.has_value())
-        return Error::from_string_literal("Distance codes have not been initialized");
+    // Every group of codes longer than the primary table that share their first bits gets a subtable, which is large
+    // enough for the longest of them.
+    auto primary_size = 1u << table.m_primary_bits;
+    auto primary_mask = primary_size - 1;
+    Array<u8, 1 << literal_length_table_bits> subtable_code_lengths {};
+    for (size_t symbol = 0; symbol < code_lengths.size(); ++symbol) {
+        if (code_lengths[symbol] > table.m_primary_bits) {
+            auto& subtable_code_length = subtable_code_lengths[reversed_codes[symbol] & primary_mask];
+            subtable_code_length = max(subtable_code_length, code_lengths[symbol]);
+        }
+    }
 
-    auto const length = TRY(m_decompressor.decode_length(symbol));
-    auto const distance_symbol = TRY(m_distance_codes.value().read_symbol(*m_decompressor.m_input_stream));
-    if (distance_symbol >= 30)
-        return Error::from_string_literal("Invalid deflate distance symbol");
+    size_t table_size = primary_size;
+    for (size_t prefix = 0; prefix < primary_size; ++prefix) {
+        if (subtable_code_lengths[prefix] != 0)
+            table_size += 1u << (subtable_code_lengths[prefix] - table.m_primary_bits);
+    }
+    TRY(table.m_entries.try_resize(table_size));
 
-    auto const distance = TRY(m_decompressor.decode_distance(distance_symbol));
+    size_t subtable_offset = primary_size;
+    for (size_t prefix = 0; prefix < primary_size; ++prefix) {
+        if (subtable_code_lengths[prefix] == 0)
+            continue;
+        auto subtable_bits = subtable_code_lengths[prefix] - table.m_primary_bits;
+        table.m_entries[prefix] = make_entry(Kind::Subtable, subtable_offset, table.m_primary_bits, subtable_bits);
+        subtable_offset += 1u << subtable_bits;
+    }
 
-    auto copied_length = TRY(m_decompressor.m_output_buffer.copy_from_seekback(distance, length));
+    // Fill in all entries whose index starts with each code.
+    for (size_t symbol = 0; symbol < code_lengths.size(); ++symbol) {
+        auto code_length = code_lengths[symbol];
+        if (code_length == 0)
+            continue;
 
-    // TODO: What should we do if the output buffer is full?
-    VERIFY(copied_length == length);
+        auto entry = entry_for_symbol(symbol, code_length);
+        auto code = reversed_codes[symbol];
+        if (code_length <= table.m_primary_bits) {
+            for (size_t index = code; index < primary_size; index += 1u << code_length)
+                table.m_entries[index] = entry;
+        } else {
+            auto subtable = table.m_entries[code & primary_mask];
+            auto subtable_size = 1u << subtable.extra_bits();
+            for (size_t index = code >> table.m_primary_bits; index < subtable_size; index += 1u << (code_length - table.m_primary_bits))
+                table.m_entries[subtable.value + index] = entry;
+        }
+    }
 
-    return true;
+    // If the bits after a short literal code already determine the next literal, decode both with one lookup.
+    if (alphabet == Alphabet::LiteralLength) {
+        Array<Entry, 1 << literal_length_table_bits> single_entries;
+        for (size_t index = 0; index < primary_size; ++index)
+            single_entries[index] = table.m_entries[index];
+
+        for (size_t index = 0; index < primary_size; ++index) {
+            auto first = single_entries[index];
+            if (first.kind() != Kind::Literal)
+                continue;
+            auto second = single_entries[index >> first.code_length];
+            if (second.kind() != Kind::Literal || first.code_length + second.code_length > table.m_primary_bits)
+                continue;
+            table.m_entries[index] = make_entry(Kind::TwoLiterals, first.value | second.value << 8, first.code_length + second.code_length);
+        }
+    }
+
+    return table;
 }
 
-DeflateDecompressor::UncompressedBlock::UncompressedBlock(DeflateDecompressor& decompressor, size_t length)
-    : m_decompressor(decompressor)
-    , m_bytes_remaining(length)
+DeflateDecompressor::DecodeTable const& DeflateDecompressor::DecodeTable::fixed_literal_table()
 {
+    static DecodeTable const table = MUST(create(fixed_literal_bit_lengths, Alphabet::LiteralLength));
+    return table;
 }
 
-ErrorOr<bool> DeflateDecompressor::UncompressedBlock::try_read_more()
+DeflateDecompressor::DecodeTable const& DeflateDecompressor::DecodeTable::fixed_distance_table()
 {
-    if (m_bytes_remaining == 0)
-        return false;
-
-    if (m_decompressor.m_input_stream->is_eof())
-        return Error::from_string_literal("Input data ends in the middle of an uncompressed DEFLATE block");
-
-    Array<u8, 4096> temporary_buffer;
-    auto readable_bytes = temporary_buffer.span().trim(min(m_bytes_remaining, m_decompressor.m_output_buffer.empty_space()));
-    auto read_bytes = TRY(m_decompressor.m_input_stream->read_some(readable_bytes));
-    auto written_bytes = m_decompressor.m_output_buffer.write(read_bytes);
-    VERIFY(read_bytes.size() == written_bytes);
-
-    m_bytes_remaining -= written_bytes;
-    return true;
+    static DecodeTable const table = MUST(create(fixed_distance_bit_lengths, Alphabet::Distance));
+    return table;
 }
 
 ErrorOr<NonnullOwnPtr<DeflateDecompressor>> DeflateDecompressor::construct(MaybeOwned<LittleEndianInputBitStream> stream)
 {
-    auto output_buffer = TRY(CircularBuffer::create_empty(32 * KiB));
+    auto output_buffer = TRY(ByteBuffer::create_uninitialized(output_buffer_size + output_buffer_slack));
     return TRY(adopt_nonnull_own_or_enomem(new (nothrow) DeflateDecompressor(move(stream), move(output_buffer))));
 }
 
-DeflateDecompressor::DeflateDecompressor(MaybeOwned<LittleEndianInputBitStream> stream, CircularBuffer output_buffer)
+DeflateDecompressor::DeflateDecompressor(MaybeOwned<LittleEndianInputBitStream> stream, ByteBuffer output_buffer)
     : m_input_stream(move(stream))
     , m_output_buffer(move(output_buffer))
 {
 }
 
-DeflateDecompressor::~DeflateDecompressor()
-{
-    if (m_state == State::ReadingCompressedBlock)
-        m_compressed_block.~CompressedBlock();
-    if (m_state == State::ReadingUncompressedBlock)
-        m_uncompressed_block.~UncompressedBlock();
-}
+DeflateDecompressor::~DeflateDecompressor() = default;
 
-ErrorOr<Bytes> DeflateDecompressor::read_some(Bytes bytes)
+ErrorOr<void> DeflateDecompressor::read_block_header()
 {
-    size_t total_read = 0;
-    while (total_read < bytes.size()) {
-        auto slice = bytes.slice(total_read);
+    m_read_final_block = TRY(m_input_stream->read_bit());
+    auto const block_type = TRY(m_input_stream->read_bits(2));
 
-        if (m_state == State::Idle) {
-            if (m_read_final_block)
-                break;
+    if (block_type == 0b00) {
+        m_input_stream->align_to_byte_boundary();
 
-            m_read_final_block = TRY(m_input_stream->read_bit());
-            auto const block_type = TRY(m_input_stream->read_bits(2));
+        u16 length = TRY(m_input_stream->read_value<LittleEndian<u16>>());
+        u16 negated_length = TRY(m_input_stream->read_value<LittleEndian<u16>>());
 
-            if (block_type == 0b00) {
-                m_input_stream->align_to_byte_boundary();
+        if ((length ^ 0xffff) != negated_length)
+            return Error::from_string_literal("Calculated negated length does not equal stored negated length");
 
-                u16 length = TRY(m_input_stream->read_value<LittleEndian<u16>>());
-                u16 negated_length = TRY(m_input_stream->read_value<LittleEndian<u16>>());
+        m_state = State::ReadingUncompressedBlock;
+        m_uncompressed_bytes_remaining = length;
+        return {};
+    }
 
-                if ((length ^ 0xffff) != negated_length)
-                    return Error::from_string_literal("Calculated negated length does not equal stored negated length");
+    if (block_type == 0b01) {
+        m_state = State::ReadingCompressedBlock;
+        m_literal_table = DecodeTable::fixed_literal_table();
+        m_distance_table = DecodeTable::fixed_distance_table();
+        return {};
+    }
 
-                m_state = State::ReadingUncompressedBlock;
-                new (&m_uncompressed_block) UncompressedBlock(*this, length);
+    if (block_type == 0b10) {
+        TRY(decode_codes(m_literal_table, m_distance_table));
+        m_state = State::ReadingCompressedBlock;
+        return {};
+    }
 
-                continue;
-            }
+    return Error::from_string_literal("Unhandled block type for Idle state");
+}
 
-            if (block_type == 0b01) {
-                m_state = State::ReadingCompressedBlock;
-                new (&m_compressed_block) CompressedBlock(*this, CanonicalCode::fixed_literal_codes(), CanonicalCode::fixed_distance_codes());
+static ALWAYS_INLINE void copy_back_reference(u8* destination, size_t distance, size_t length)
+{
+    u8 const* source = destination - distance;
+
+    if (distance >= sizeof(u64)) {
+        // Even if the back reference overlaps its own output, every word we read has already been written by the
+        // time we read it. This may write up to 7 bytes past the end, which the output buffer has room for.
+        for (size_t i = 0; i < length; i += sizeof(u64)) {
+            u64 word;
+            __builtin_memcpy(&word, source + i, sizeof(word));
+            __builtin_memcpy(destination + i, &word, sizeof(word));
+        }
+        return;
+    }
 
-                continue;
-            }
+    if (distance == 1) {
+        __builtin_memset(destination, *source, length);
+        return;
+    }
 
-            if (block_type == 0b10) {
-                CanonicalCode literal_codes;
-                Optional<CanonicalCode> distance_codes;
-                TRY(decode_codes(literal_codes, distance_codes));
+    for (size_t i = 0; i < length; ++i)
+        destination[i] = source[i];
+}
 
-                m_state = State::ReadingCompressedBlock;
-                new (&m_compressed_block) CompressedBlock(*this, literal_codes, distance_codes);
+ErrorOr<void> DeflateDecompressor::decode_compressed_data()
+{
+    auto& stream = *m_input_stream;
+    auto* output = m_output_buffer.data();
+    auto write_offset = m_output_write_offset;
+    ScopeGuard update_write_offset = [&] { m_output_write_offset = write_offset; };
+
+    while (write_offset + max_back_reference_length <= output_buffer_size) {
+        if (stream.buffered_bit_count() < max_bits_per_symbol)
+            TRY(stream.fill_bit_buffer());
+
+        u64 bits = stream.buffered_bits();
+        size_t available_bits = stream.buffered_bit_count();
+
+        auto entry = m_literal_table.lookup(bits);
+        if (entry.code_length > available_bits)
+            return Error::from_string_literal("Reached end-of-stream without collecting the required number of bits");
+
+        switch (entry.kind()) {
+        case DecodeTable::Kind::Literal:
+            output[write_offset++] = entry.value;
+            stream.discard_previously_peeked_bits(entry.code_length);
+            continue;
+        case DecodeTable::Kind::TwoLiterals:
+            output[write_offset++] = entry.value & 0xff;
+            output[write_offset++] = entry.value >> 8;
+            stream.discard_previously_peeked_bits(entry.code_length);
+            continue;
+        case DecodeTable::Kind::EndOfBlock:
+            stream.discard_previously_peeked_bits(entry.code_length);
+            m_state = State::Idle;
+            return {};
+        case DecodeTable::Kind::Length:
+            break;
+        default:
+            return Error::from_string_literal("Invalid deflate literal/length symbol");
+        }
 
-                continue;
-            }
+        size_t used_bits = entry.code_length + entry.extra_bits();
+        size_t length = entry.value + ((bits >> entry.code_length) & ((1u << entry.extra_bits()) - 1));
+        bits >>= used_bits;
 
-            return Error::from_string_literal("Unhandled block type for Idle state");
-        }
+        auto distance_entry = m_distance_table.lookup(bits);
+        if (distance_entry.kind() != DecodeTable::Kind::Distance)
+            return Error::from_string_literal("Invalid deflate distance symbol");
 
-        if (m_state == State::ReadingCompressedBlock) {
-            auto nread = m_output_buffer.read(slice).size();
+        used_bits += distance_entry.code_length + distance_entry.extra_bits();
+        if (used_bits > available_bits)
+            return Error::from_string_literal("Reached end-of-stream without collecting the required number of bits");
+        size_t distance = distance_entry.value + ((bits >> distance_entry.code_length) & ((1u << distance_entry.extra_bits()) - 1));
+        stream.discard_previously_peeked_bits(used_bits);
 
-            while (nread < slice.size() && TRY(m_compressed_block.try_read_more())) {
-                nread += m_output_buffer.read(slice.slice(nread)).size();
-            }
+        if (distance > write_offset)
+            return Error::from_string_literal("Tried a seekback copy beyond the seekback limit");
 
-            total_read += nread;
-            if (nread == slice.size())
-                break;
+        copy_back_reference(output + write_offset, distance, length);
+        write_offset += length;
+    }
 
-            m_compressed_block.~CompressedBlock();
-            m_state = State::Idle;
+    return {};
+}
 
-            continue;
-        }
+ErrorOr<void> DeflateDecompressor::read_uncompressed_data()
+{
+    if (m_uncompressed_bytes_remaining == 0) {
+        m_state = State::Idle;
+        return {};
+    }
 
-        if (m_state == State::ReadingUncompressedBlock) {
-            auto nread = m_output_buffer.read(slice).size();
+    if (m_input_stream->is_eof())
+        return Error::from_string_literal("Input data ends in the middle of an uncompressed DEFLATE block");
 
-            while (nread < slice.size() && TRY(m_uncompressed_block.try_read_more())) {
-                nread += m_output_buffer.read(slice.slice(nread)).size();
-            }
+    auto free_space = m_output_buffer.bytes().slice(m_output_write_offset, output_buffer_size - m_output_write_offset);
+    auto read_bytes = TRY(m_input_stream->read_some(free_space.trim(m_uncompressed_bytes_remaining)));
+    m_output_write_offset += read_bytes.size();
+    m_uncompressed_bytes_remaining -= read_bytes.size();
+    return {};
+}
 
+void DeflateDecompressor::slide_output_window()
+{
+    // Only the data that back references can still refer to is kept.
+    VERIFY(m_output_read_offset == m_output_write_offset);
+    if (m_output_write_offset <= max_back_reference_distance)
+        return;
+
+    auto discarded_size = m_output_write_offset - max_back_reference_distance;
+    memmove(m_output_buffer.data(), m_output_buffer.data() + discarded_size, max_back_reference_distance);
+    m_output_read_offset -= discarded_size;
+    m_output_write_offset -= discarded_size;
+}
+
+ErrorOr<Bytes> DeflateDecompressor::read_some(Bytes bytes)
+{
+    size_t total_read = 0;
+    while (total_read < bytes.size()) {
+        if (m_output_read_offset < m_output_write_offset) {
+            auto decoded_bytes = m_output_buffer.bytes().slice(m_output_read_offset, m_output_write_offset - m_output_read_offset);
+            auto nread = decoded_bytes.copy_trimmed_to(bytes.slice(total_read));
+            m_output_read_offset += nread;
             total_read += nread;
-            if (nread == slice.size())
+            continue;
+        }
+
+        if (m_state == State::Idle) {
+            if (m_read_final_block)
                 break;
 
-            m_uncompressed_block.~UncompressedBlock();
-            m_state = State::Idle;
+            TRY(read_block_header());
+            continue;
+        }
+
+        // All decoded data has been read at this point, so we can make room for more.
+        slide_output_window();
 
+        if (m_state == State::ReadingCompressedBlock) {
+            TRY(decode_compressed_data());
+            continue;
+        }
+
+        if (m_state == State::ReadingUncompressedBlock) {
+            TRY(read_uncompressed_data());
             continue;
         }
 
@@ -353,7 +541,7 @@ ErrorOr<Bytes> DeflateDecompressor::read_some(Bytes bytes)
     return bytes.slice(0, total_read);
 }
 
-bool DeflateDecompressor::is_eof() const { return m_state == State::Idle && m_read_final_block; }
+bool DeflateDecompressor::is_eof() const { return m_state == State::Idle && m_read_final_block && m_output_read_offset == m_output_write_offset; }
 
 ErrorOr<size_t> DeflateDecompressor::write_some(ReadonlyBytes)
 {
@@ -377,36 +565,7 @@ ErrorOr<ByteBuffer> DeflateDecompressor::decompress_all(ReadonlyBytes bytes)
     return deflate_stream->read_until_eof(4096);
 }
 
-ErrorOr<u32> DeflateDecompressor::decode_length(u32 symbol)
-{
-    if (symbol <= 264)
-        return symbol - 254;
-
-    if (symbol <= 284) {
-        auto extra_bits = (symbol - 261) / 4;
-        return (((symbol - 265) % 4 + 4) << extra_bits) + 3 + TRY(m_input_stream->read_bits(extra_bits));
-    }
-
-    if (symbol == 285)
-        return DeflateDecompressor::max_back_reference_length;
-
-    VERIFY_NOT_REACHED();
-}
-
-ErrorOr<u32> DeflateDecompressor::decode_distance(u32 symbol)
-{
-    if (symbol <= 3)
-        return symbol + 1;
-
-    if (symbol <= 29) {
-        auto extra_bits = (symbol / 2) - 1;
-        return ((symbol % 2 + 2) << extra_bits) + 1 + TRY(m_input_stream->read_bits(extra_bits));
-    }
-
-    VERIFY_NOT_REACHED();
-}
-
-ErrorOr<void> DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code)
+ErrorOr<void> DeflateDecompressor::decode_codes(DecodeTable& literal_table, DecodeTable& distance_table)
 {
     auto literal_code_count = TRY(m_input_stream->read_bits(5)) + 257;
     auto distance_code_count = TRY(m_input_stream->read_bits(5)) + 1;
@@ -453,20 +612,22 @@ ErrorOr<void> DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Opt
         return Error::from_string_literal("Number of code lengths does not match the sum of codes");
 
     // Now we extract the code that was used to encode literals and lengths in the block.
-    literal_code = TRY(CanonicalCode::from_bytes(code_lengths.span().trim(literal_code_count)));
+    literal_table = TRY(DecodeTable::create(code_lengths.span().trim(literal_code_count), DecodeTable::Alphabet::LiteralLength));
 
     // Now we extract the code that was used to encode distances in the block.
 
     if (distance_code_count == 1) {
         auto length = code_lengths[literal_code_count];
 
-        if (length == 0)
+        if (length == 0) {
+            distance_table = {};
             return {};
-        else if (length != 1)
+        } else if (length != 1) {
             return Error::from_string_literal("Length for a single distance code is longer than 1");
+        }
     }
 
-    distance_code = TRY(CanonicalCode::from_bytes(code_lengths.span().slice(literal_code_count)));
+    distance_table = TRY(DecodeTable::create(code_lengths.span().slice(literal_code_count), DecodeTable::Alphabet::Distance));
 
     return {};
 }
@@ -489,7 +650,7 @@ DeflateCompressor::DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>
 
 DeflateCompressor::~DeflateCompressor()
 {
-    VERIFY(m_finished);
+    VERIFY(m_finished || m_synced);
 }
 
 ErrorOr<Bytes> DeflateCompressor::read_some(Bytes)
@@ -500,6 +661,8 @@ ErrorOr<Bytes> DeflateCompressor::read_some(Bytes)
 ErrorOr<size_t> DeflateCompressor::write_some(ReadonlyBytes bytes)
 {
     VERIFY(!m_finished);
+    if (!bytes.is_empty())
+        m_synced = false;
 
     size_t total_written = 0;
     while (!bytes.is_empty()) {
@@ -576,7 +739,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_back_reference_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -602,78 +765,6 @@ ALWAYS_INLINE u8 DeflateCompressor::distance_to_base(u16 distance)
     return (distance <= 256) ? distance_to_base_lo[distance - 1] : distance_to_base_hi[(distance - 1) >> 7];
 }
 
-template<size_t Size>
-void DeflateCompressor::generate_huffman_lengths(Array<u8, Size>& lengths, Array<u16, Size> const& frequencies, size_t max_bit_length, u16 frequency_cap)
-{
-    VERIFY((1u << max_bit_length) >= Size);
-    u16 heap_keys[Size]; // Used for O(n) heap construction
-    u16 heap_values[Size];
-
-    u16 huffman_links[Size * 2] = { 0 };
-    size_t non_zero_freqs = 0;
-    for (size_t i = 0; i < Size; i++) {
-        auto frequency = frequencies[i];
-        if (frequency == 0)
-            continue;
-
-        if (frequency > frequency_cap) {
-            frequency = frequency_cap;
-        }
-
-        heap_keys[non_zero_freqs] = frequency;               // sort symbols by frequency
-        heap_values[non_zero_freqs] = Size + non_zero_freqs; // huffman_links "links"
-        non_zero_freqs++;
-    }
-
-    // special case for only 1 used symbol
-    if (non_zero_freqs < 2) {
-        for (size_t i = 0; i < Size; i++)
-            lengths[i] = (frequencies[i] == 0) ? 0 : 1;
-        return;
-    }
-
-    BinaryHeap<u16, u16, Size> heap { heap_keys, heap_values, non_zero_freqs };
-
-    // build the huffman tree - binary heap is used for efficient frequency comparisons
-    while (heap.size() > 1) {
-        u16 lowest_frequency = heap.peek_min_key();
-        u16 lowest_link = heap.pop_min();
-        u16 second_lowest_frequency = heap.peek_min_key();
-        u16 second_lowest_link = heap.pop_min();
-
-        u16 new_link = heap.size() + 1;
-
-        heap.insert(lowest_frequency + second_lowest_frequency, new_link);
-
-        huffman_links[lowest_link] = new_link;
-        huffman_links[second_lowest_link] = new_link;
-    }
-
-    non_zero_freqs = 0;
-    for (size_t i = 0; i < Size; i++) {
-        if (frequencies[i] == 0) {
-            lengths[i] = 0;
-            continue;
-        }
-
-        u16 link = huffman_links[Size + non_zero_freqs];
-        non_zero_freqs++;
-
-        size_t bit_length = 1;
-        while (link != 1) {
-            bit_length++;
-            link = huffman_links[link];
-        }
-
-        if (bit_length > max_bit_length) {
-            VERIFY(frequency_cap != 1);
-            return generate_huffman_lengths(lengths, frequencies, max_bit_length, frequency_cap / 2);
-        }
-
-        lengths[i] = bit_length;
-    }
-}
-
 void DeflateCompressor::lz77_compress_block()
 {
     for (auto& slot : m_hash_head) { // initialize chained hash table
@@ -686,6 +777,11 @@ void DeflateCompressor::lz77_compress_block()
         m_hash_head[hash] = window_pos;
     };
 
+    // seed the hash chains with the data preceding the block, so that matches can reach across the block boundary
+    for (size_t position = block_size - m_history_size; position < block_size; position++) {
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
+    }
+
     auto emit_literal = [&](auto literal) {
         VERIFY(m_pending_symbol_size <= block_size + 1);
         auto index = m_pending_symbol_size++;
@@ -1021,13 +1117,16 @@ ErrorOr<void> DeflateCompressor::flush()
     if (m_finished)
         TRY(m_output_stream->align_to_byte_boundary());
 
+    // slide the window, so that the end of this block becomes the history for the next one
+    auto history_size = min(m_history_size + m_pending_block_size, block_size);
+    memmove(m_rolling_window + block_size - history_size, m_rolling_window + block_size + m_pending_block_size - history_size, history_size);
+    m_history_size = history_size;
+
     // reset all block specific members
     m_pending_block_size = 0;
     m_pending_symbol_size = 0;
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
-    // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
-    pending_block().copy_trimmed_to({ m_rolling_window, block_size });
 
     return {};
 }
@@ -1041,6 +1140,35 @@ ErrorOr<void> DeflateCompressor::final_flush()
     return {};
 }
 
+ErrorOr<void> DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        TRY(flush());
+
+    // an empty stored block, which ends on a byte boundary
+    TRY(m_output_stream->write_bits(0b0u, 1));  // not the final block
+    TRY(m_output_stream->write_bits(0b00u, 2)); // no compression
+    TRY(m_output_stream->align_to_byte_boundary());
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0));
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0xffff));
+    TRY(m_output_stream->flush_buffer_to_stream());
+
+    m_synced = true;
+    return {};
+}
+
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(!m_finished);
+    VERIFY(m_pending_block_size == 0);
+
+    if (dictionary.size() > block_size)
+        dictionary = dictionary.slice(dictionary.size() - block_size);
+    dictionary.copy_to({ m_rolling_window + block_size - dictionary.size(), dictionary.size() });
+    m_history_size = dictionary.size();
+}
+
 ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
@@ -1055,4 +1183,91 @@ ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, Compres
     return buffer;
 }
 
+size_t DeflateCompressor::parallel_chunk_count(size_t input_size)
+{
+    return max(ceil_div(input_size, parallel_chunk_size), static_cast<size_t>(1));
+}
+
+ErrorOr<ByteBuffer> DeflateCompressor::compress_all_in_parallel(ReadonlyBytes bytes, size_t thread_count, CompressionLevel compression_level, ChunkCallback const& chunk_callback)
+{
+    // This works like pigz: every chunk is compressed by its own compressor, primed with the window preceding the
+    // chunk. All but the last chunk end with a sync flush instead of a final block, so the compressed chunks are
+    // byte aligned and can simply be concatenated.
+    struct Chunk {
+        ReadonlyBytes dictionary;
+        ReadonlyBytes input;
+        ByteBuffer output;
+        Optional<Error> error;
+    };
+
+    auto chunk_count = parallel_chunk_count(bytes.size());
+    Vector<Chunk> chunks;
+    TRY(chunks.try_resize(chunk_count));
+    for (size_t i = 0; i < chunk_count; ++i) {
+        auto offset = i * parallel_chunk_size;
+        auto dictionary_offset = offset - min(offset, block_size);
+        chunks[i].dictionary = bytes.slice(dictionary_offset, offset - dictionary_offset);
+        chunks[i].input = bytes.slice(offset, min(parallel_chunk_size, bytes.size() - offset));
+    }
+
+    auto compress_chunk = [&](Chunk const& chunk, bool is_last_chunk) -> ErrorOr<ByteBuffer> {
+        AllocatingMemoryStream output_stream;
+        auto compressor = TRY(DeflateCompressor::construct(MaybeOwned<Stream>(output_stream), compression_level));
+        compressor->set_dictionary(chunk.dictionary);
+        TRY(compressor->write_until_depleted(chunk.input));
+        if (is_last_chunk)
+            TRY(compressor->final_flush());
+        else
+            TRY(compressor->sync_flush());
+
+        auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+        TRY(output_stream.read_until_filled(buffer));
+        return buffer;
+    };
+
+    Atomic<size_t> next_chunk_index { 0 };
+    auto compress_remaining_chunks = [&]() -> intptr_t {
+        for (auto index = next_chunk_index.fetch_add(1); index < chunk_count; index = next_chunk_index.fetch_add(1)) {
+            auto& chunk = chunks[index];
+            if (chunk_callback)
+                chunk_callback(index, chunk.input);
+
+            auto result = compress_chunk(chunk, index == chunk_count - 1);
+            if (result.is_error())
+                chunk.error = result.release_error();
+            else
+                chunk.output = result.release_value();
+        }
+        return 0;
+    };
+
+    // The calling thread takes part in the work as well, and simply does more of it if we fail to create a thread.
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    for (size_t i = 1; i < min(thread_count, chunk_count); ++i) {
+        auto thread_or_error = Threading::Thread::try_create([&] { return compress_remaining_chunks(); }, "Deflate"sv);
+        if (thread_or_error.is_error() || threads.try_append(thread_or_error.value()).is_error())
+            break;
+        threads.last()->start();
+    }
+
+    compress_remaining_chunks();
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    size_t output_size = 0;
+    for (auto& chunk : chunks) {
+        if (chunk.error.has_value())
+            return chunk.error.release_value();
+        output_size += chunk.output.size();
+    }
+
+    auto output = TRY(ByteBuffer::create_uninitialized(output_size));
+    size_t output_offset = 0;
+    for (auto const& chunk : chunks) {
+        chunk.output.bytes().copy_to(output.bytes().slice(output_offset));
+        output_offset += chunk.output.size();
+    }
+    return output;
+}
+
 }
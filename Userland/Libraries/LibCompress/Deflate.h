@@ -11,6 +11,7 @@
 #include <AK/CircularBuffer.h>
 #include <AK/Endian.h>
 #include <AK/Forward.h>
+#include <AK/Function.h>
 #include <AK/MaybeOwned.h>
 #include <AK/Stream.h>
 #include <AK/Vector.h>
@@ -53,29 +54,53 @@ private:
 
 class DeflateDecompressor final : public Stream {
 private:
-    class CompressedBlock {
+    // A lookup table for the literal/length or distance code of a block. Most symbols are decoded with a single
+    // lookup into the primary table, which also yields the base value and number of extra bits of length and
+    // distance symbols, and may contain two literals at once. Longer codes continue in a subtable.
+    class DecodeTable {
     public:
-        CompressedBlock(DeflateDecompressor&, CanonicalCode literal_codes, Optional<CanonicalCode> distance_codes);
+        enum class Alphabet {
+            LiteralLength,
+            Distance,
+        };
 
-        ErrorOr<bool> try_read_more();
+        enum class Kind : u8 {
+            Invalid,
+            Literal,
+            TwoLiterals,
+            Length,
+            Distance,
+            EndOfBlock,
+            Subtable,
+        };
 
-    private:
-        bool m_eof { false };
+        struct Entry {
+            u16 value { 0 };     // the literal(s), the base length or distance, or the offset of the subtable
+            u8 code_length { 0 }; // the total number of bits of the code(s) of this entry
+            u8 info { 0 };        // the kind in the upper three bits, the number of extra bits (or subtable bits) in the lower five
 
-        DeflateDecompressor& m_decompressor;
-        CanonicalCode m_literal_codes;
-        Optional<CanonicalCode> m_distance_codes;
-    };
+            Kind kind() const { return static_cast<Kind>(info >> 5); }
+            u8 extra_bits() const { return info & 0x1f; }
+        };
+        static_assert(sizeof(Entry) == 4);
 
-    class UncompressedBlock {
-    public:
-        UncompressedBlock(DeflateDecompressor&, size_t);
+        DecodeTable();
+        static ErrorOr<DecodeTable> create(ReadonlyBytes code_lengths, Alphabet);
+
+        static DecodeTable const& fixed_literal_table();
+        static DecodeTable const& fixed_distance_table();
 
-        ErrorOr<bool> try_read_more();
+        ALWAYS_INLINE Entry lookup(u64 bits) const
+        {
+            auto entry = m_entries[bits & ((1u << m_primary_bits) - 1)];
+            if (entry.kind() == Kind::Subtable) [[unlikely]]
+                entry = m_entries[entry.value + ((bits >> m_primary_bits) & ((1u << entry.extra_bits()) - 1))];
+            return entry;
+        }
 
     private:
-        DeflateDecompressor& m_decompressor;
-        size_t m_bytes_remaining;
+        size_t m_primary_bits { 0 };
+        Vector<Entry> m_entries;
     };
 
     enum class State {
@@ -85,9 +110,6 @@ private:
     };
 
 public:
-    friend CompressedBlock;
-    friend UncompressedBlock;
-
     static ErrorOr<NonnullOwnPtr<DeflateDecompressor>> construct(MaybeOwned<LittleEndianInputBitStream> stream);
     ~DeflateDecompressor();
 
@@ -100,24 +122,37 @@ public:
     static ErrorOr<ByteBuffer> decompress_all(ReadonlyBytes);
 
 private:
-    DeflateDecompressor(MaybeOwned<LittleEndianInputBitStream> stream, CircularBuffer buffer);
+    DeflateDecompressor(MaybeOwned<LittleEndianInputBitStream> stream, ByteBuffer output_buffer);
 
-    ErrorOr<u32> decode_length(u32);
-    ErrorOr<u32> decode_distance(u32);
-    ErrorOr<void> decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code);
+    ErrorOr<void> read_block_header();
+    ErrorOr<void> decode_codes(DecodeTable& literal_table, DecodeTable& distance_table);
+    ErrorOr<void> decode_compressed_data();
+    ErrorOr<void> read_uncompressed_data();
+    void slide_output_window();
 
     static constexpr u16 max_back_reference_length = 258;
+    static constexpr size_t max_back_reference_distance = 32 * KiB;
+
+    // The most bits a single length/distance pair can take up: a 15-bit code and 5 extra bits for the length,
+    // and a 15-bit code and 13 extra bits for the distance.
+    static constexpr size_t max_bits_per_symbol = 48;
+
+    // Decoded data is appended to a flat buffer, which keeps the last 32 KiB of output for back references when it is
+    // slid back. There is some slack at the end, since back references are copied in whole words.
+    static constexpr size_t output_buffer_size = max_back_reference_distance + 64 * KiB;
+    static constexpr size_t output_buffer_slack = sizeof(u64);
 
     bool m_read_final_block { false };
 
     State m_state { State::Idle };
-    union {
-        CompressedBlock m_compressed_block;
-        UncompressedBlock m_uncompressed_block;
-    };
+    DecodeTable m_literal_table;
+    DecodeTable m_distance_table;
+    size_t m_uncompressed_bytes_remaining { 0 };
 
     MaybeOwned<LittleEndianInputBitStream> m_input_stream;
-    CircularBuffer m_output_buffer;
+    ByteBuffer m_output_buffer;
+    size_t m_output_read_offset { 0 };
+    size_t m_output_write_offset { 0 };
 };
 
 class DeflateCompressor final : public Stream {
@@ -129,7 +164,9 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_back_reference_distance = 32 * KiB;
     static constexpr u16 empty_slot = UINT16_MAX;
+    static constexpr size_t parallel_chunk_size = 128 * KiB;
 
     struct CompressionConstants {
         size_t good_match_length;  // Once we find a match of at least this length (a good enough match) we reduce max_chain to lower processing time
@@ -165,8 +202,24 @@ public:
     virtual void close() override;
     ErrorOr<void> final_flush();
 
+    // Ends the current block without ending the deflate stream, and pads the output to a byte boundary with an empty
+    // stored block, so that more deflate data can be appended to it.
+    ErrorOr<void> sync_flush();
+
+    // Uses the given bytes as the data preceding the input, so that back references can reach into them.
+    // Only the last window's worth of bytes is used. Must be called before any data is written.
+    void set_dictionary(ReadonlyBytes);
+
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
+    // Compresses the input in chunks of parallel_chunk_size bytes on up to thread_count threads, and concatenates
+    // them into a single deflate stream. Each chunk is primed with the data that precedes it, so the compression
+    // ratio is close to that of compress_all(). The output does not depend on the thread count.
+    // If given, chunk_callback is invoked (from any of the threads) with the index and contents of every chunk.
+    using ChunkCallback = Function<void(size_t chunk_index, ReadonlyBytes chunk)>;
+    static ErrorOr<ByteBuffer> compress_all_in_parallel(ReadonlyBytes bytes, size_t thread_count, CompressionLevel = CompressionLevel::GOOD, ChunkCallback const& chunk_callback = {});
+    static size_t parallel_chunk_count(size_t input_size);
+
 private:
     DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>, CompressionLevel = CompressionLevel::GOOD);
 
@@ -184,8 +237,6 @@ private:
         u8 count; // used for special symbols 16-18
     };
     static u8 distance_to_base(u16 distance);
-    template<size_t Size>
-    static void generate_huffman_lengths(Array<u8, Size>& lengths, Array<u16, Size> const& frequencies, size_t max_bit_length, u16 frequency_cap = UINT16_MAX);
     size_t huffman_block_length(Array<u8, max_huffman_literals> const& literal_bit_lengths, Array<u8, max_huffman_distances> const& distance_bit_lengths);
     ErrorOr<void> write_huffman(CanonicalCode const& literal_code, Optional<CanonicalCode> const& distance_code);
     static size_t encode_huffman_lengths(Array<u8, max_huffman_literals + max_huffman_distances> const& lengths, size_t lengths_count, Array<code_length_symbol, max_huffman_literals + max_huffman_distances>& encoded_lengths);
@@ -198,11 +249,14 @@ private:
     ErrorOr<void> flush();
 
     bool m_finished { false };
+    bool m_synced { false };
     CompressionLevel m_compression_level;
     CompressionConstants m_compression_constants;
     NonnullOwnPtr<LittleEndianOutputBitStream> m_output_stream;
 
+    // The first half holds the most recent m_history_size bytes before the pending block, which occupies the second half.
     u8 m_rolling_window[window_size];
+    size_t m_history_size { 0 };
     size_t m_pending_block_size { 0 };
 
     struct [[gnu::packed]] {
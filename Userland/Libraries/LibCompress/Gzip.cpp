@@ -215,7 +215,7 @@ ErrorOr<Bytes> GzipCompressor::read_some(Bytes)
     return Error::from_errno(EBADF);
 }
 
-ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
+static ErrorOr<void> write_member_header(Stream& stream)
 {
     BlockHeader header;
     header.identification_1 = 0x1f;
@@ -225,7 +225,12 @@ ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
     header.modification_time = 0;
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
-    TRY(m_output_stream->write_until_depleted({ &header, sizeof(header) }));
+    return stream.write_until_depleted({ &header, sizeof(header) });
+}
+
+ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
+{
+    TRY(write_member_header(*m_output_stream));
     auto compressed_stream = TRY(DeflateCompressor::construct(MaybeOwned(*m_output_stream)));
     TRY(compressed_stream->write_until_depleted(bytes));
     TRY(compressed_stream->final_flush());
@@ -250,8 +255,11 @@ void GzipCompressor::close()
 {
 }
 
-ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
+ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes, size_t thread_count)
 {
+    if (thread_count > 1)
+        return compress_all_in_parallel(bytes, thread_count);
+
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
     GzipCompressor gzip_stream { MaybeOwned<Stream>(*output_stream) };
 
@@ -262,7 +270,36 @@ ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
     return buffer;
 }
 
-ErrorOr<void> GzipCompressor::compress_file(StringView input_filename, NonnullOwnPtr<Stream> output_stream)
+ErrorOr<ByteBuffer> GzipCompressor::compress_all_in_parallel(ReadonlyBytes bytes, size_t thread_count)
+{
+    // The checksum of each chunk is computed by the thread that compresses it, and combined afterwards.
+    struct ChunkChecksum {
+        u32 crc32 { 0 };
+        size_t size { 0 };
+    };
+    Vector<ChunkChecksum> chunk_checksums;
+    TRY(chunk_checksums.try_resize(DeflateCompressor::parallel_chunk_count(bytes.size())));
+
+    auto compressed_bytes = TRY(DeflateCompressor::compress_all_in_parallel(bytes, thread_count, DeflateCompressor::CompressionLevel::GOOD, [&](size_t chunk_index, ReadonlyBytes chunk) {
+        chunk_checksums[chunk_index] = { Crypto::Checksum::CRC32 { chunk }.digest(), chunk.size() };
+    }));
+
+    u32 crc32 = Crypto::Checksum::CRC32 {}.digest();
+    for (auto const& chunk_checksum : chunk_checksums)
+        crc32 = Crypto::Checksum::CRC32::combine(crc32, chunk_checksum.crc32, chunk_checksum.size);
+
+    AllocatingMemoryStream output_stream;
+    TRY(write_member_header(output_stream));
+    TRY(output_stream.write_until_depleted(compressed_bytes));
+    TRY(output_stream.write_value<LittleEndian<u32>>(crc32));
+    TRY(output_stream.write_value<LittleEndian<u32>>(bytes.size()));
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+    TRY(output_stream.read_until_filled(buffer.bytes()));
+    return buffer;
+}
+
+ErrorOr<void> GzipCompressor::compress_file(StringView input_filename, NonnullOwnPtr<Stream> output_stream, size_t thread_count)
 {
     // We map the whole file instead of streaming to reduce size overhead (gzip header) and increase the deflate block size (better compression)
     // TODO: automatically fallback to buffered streaming for very large files
@@ -274,7 +311,7 @@ ErrorOr<void> GzipCompressor::compress_file(StringView input_filename, NonnullOw
         input_bytes = file->bytes();
     }
 
-    auto output_bytes = TRY(Compress::GzipCompressor::compress_all(input_bytes));
+    auto output_bytes = TRY(Compress::GzipCompressor::compress_all(input_bytes, thread_count));
     TRY(output_stream->write_until_depleted(output_bytes));
 
     return {};
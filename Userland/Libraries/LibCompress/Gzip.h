@@ -92,10 +92,13 @@ public:
     virtual bool is_open() const override;
     virtual void close() override;
 
-    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes);
-    static ErrorOr<void> compress_file(StringView input_file, NonnullOwnPtr<Stream> output_stream);
+    // With more than one thread, the input is compressed with DeflateCompressor::compress_all_in_parallel().
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, size_t thread_count = 1);
+    static ErrorOr<void> compress_file(StringView input_file, NonnullOwnPtr<Stream> output_stream, size_t thread_count = 1);
 
 private:
+    static ErrorOr<ByteBuffer> compress_all_in_parallel(ReadonlyBytes bytes, size_t thread_count);
+
     MaybeOwned<Stream> m_output_stream;
 };
 
@@ -116,6 +116,37 @@ ErrorOr<LzmaHeader> LzmaHeader::from_compressor_options(LzmaCompressorOptions co
     };
 }
 
+LzmaCompressorOptions LzmaCompressorOptions::for_preset(u8 preset)
+{
+    struct Preset {
+        u8 dictionary_size_bits;
+        LzmaMatchFinderType match_finder;
+        u16 nice_match_length;
+        u32 match_finder_depth;
+    };
+
+    static constexpr Array<Preset, max_preset + 1> presets { {
+        { 18, LzmaMatchFinderType::HashChain4, 128, 4 },
+        { 20, LzmaMatchFinderType::HashChain4, 128, 8 },
+        { 21, LzmaMatchFinderType::HashChain4, 273, 24 },
+        { 22, LzmaMatchFinderType::HashChain4, 273, 48 },
+        { 22, LzmaMatchFinderType::BinaryTree4, 16, 0 },
+        { 23, LzmaMatchFinderType::BinaryTree4, 32, 0 },
+        { 23, LzmaMatchFinderType::BinaryTree4, 64, 0 },
+        { 24, LzmaMatchFinderType::BinaryTree4, 64, 0 },
+        { 25, LzmaMatchFinderType::BinaryTree4, 64, 0 },
+        { 26, LzmaMatchFinderType::BinaryTree4, 64, 0 },
+    } };
+
+    auto const& selected_preset = presets[min(preset, max_preset)];
+    return {
+        .dictionary_size = static_cast<u32>(1) << selected_preset.dictionary_size_bits,
+        .match_finder = selected_preset.match_finder,
+        .nice_match_length = selected_preset.nice_match_length,
+        .match_finder_depth = selected_preset.match_finder_depth,
+    };
+}
+
 void LzmaState::initialize_to_default_probability(Span<Probability> span)
 {
     for (auto& entry : span)
@@ -521,18 +552,16 @@ ErrorOr<void> LzmaDecompressor::decode_literal_to_output_buffer()
     return {};
 }
 
-ErrorOr<void> LzmaCompressor::encode_literal(u8 literal)
+ErrorOr<void> LzmaCompressor::encode_literal()
 {
     // This function largely mirrors `decode_literal_to_output_buffer`, so specification comments have been omitted.
 
     TRY(encode_match_type(MatchType::Literal));
 
-    // Note: We have already read the next byte from the input buffer, so it's now in the seekback buffer, shifting all seekback offsets by one.
+    u8 literal = m_match_finder->lookahead()[0];
     u8 previous_byte = 0;
-    if (m_dictionary->seekback_limit() - m_dictionary->used_space() > 1) {
-        auto read_bytes = MUST(m_dictionary->read_with_seekback({ &previous_byte, sizeof(previous_byte) }, 2 + m_dictionary->used_space()));
-        VERIFY(read_bytes.size() == sizeof(previous_byte));
-    }
+    if (m_match_finder->history_size() > 0)
+        previous_byte = m_match_finder->byte_at_distance(1);
     u16 const literal_state_bits_from_position = m_total_processed_bytes & ((1 << m_options.literal_position_bits) - 1);
     u16 const literal_state_bits_from_output = previous_byte >> (8 - m_options.literal_context_bits);
     u16 const literal_state = literal_state_bits_from_position << m_options.literal_context_bits | literal_state_bits_from_output;
@@ -543,9 +572,7 @@ ErrorOr<void> LzmaCompressor::encode_literal(u8 literal)
     u16 result = 1;
 
     if (m_state >= 7) {
-        u8 matched_byte = 0;
-        auto read_bytes = TRY(m_dictionary->read_with_seekback({ &matched_byte, sizeof(matched_byte) }, current_repetition_offset() + m_dictionary->used_space() + 1));
-        VERIFY(read_bytes.size() == sizeof(matched_byte));
+        u8 matched_byte = m_match_finder->byte_at_distance(current_repetition_offset());
 
         dbgln_if(LZMA_DEBUG, "Encoding literal using match byte {:#x}", matched_byte);
 
@@ -573,6 +600,7 @@ ErrorOr<void> LzmaCompressor::encode_literal(u8 literal)
         result = (result << 1) | encoded_bit;
     }
 
+    m_match_finder->advance(sizeof(literal));
     m_total_processed_bytes += sizeof(literal);
 
     dbgln_if(LZMA_DEBUG, "Encoded literal {:#x} in state {} using literal state {:#x} (previous byte is {:#x})", original_literal, m_state, literal_state, previous_byte);
@@ -619,7 +647,7 @@ ErrorOr<void> LzmaCompressor::encode_existing_match(size_t real_distance, size_t
 
     TRY(encode_normalized_match_length(m_rep_length_coder, normalized_length));
     update_state_after_rep();
-    MUST(m_dictionary->discard(real_length));
+    m_match_finder->advance(real_length);
     m_total_processed_bytes += real_length;
 
     return {};
@@ -635,7 +663,7 @@ ErrorOr<void> LzmaCompressor::encode_new_match(size_t real_distance, size_t real
 
     TRY(encode_normalized_simple_match(normalized_distance, normalized_length));
 
-    MUST(m_dictionary->discard(real_length));
+    m_match_finder->advance(real_length);
     m_total_processed_bytes += real_length;
 
     return {};
@@ -991,35 +1019,86 @@ ErrorOr<void> LzmaCompressor::encode_match_type(MatchType match_type)
 
 ErrorOr<void> LzmaCompressor::encode_once()
 {
-    // Check if any of our existing match distances are currently usable.
-    Vector<size_t> const existing_distances {
-        m_rep0 + normalized_to_real_match_distance_offset,
-        m_rep1 + normalized_to_real_match_distance_offset,
-        m_rep2 + normalized_to_real_match_distance_offset,
-        m_rep3 + normalized_to_real_match_distance_offset,
+    // This follows the "fast" mode of XZ Utils: we take the longest match, unless a repeated distance or a match at the
+    // next position is about as long, instead of searching for the cheapest way to encode a whole stretch of data.
+    auto const lookahead_size = m_match_finder->lookahead_size();
+    VERIFY(lookahead_size > 0);
+
+    // A match is not worth it if its distance takes a lot more bits than the other one's, which is roughly the case
+    // if it is more than 2^7 times as large.
+    auto const is_much_closer = [](size_t distance, size_t other_distance) {
+        return distance < (other_distance >> 7);
     };
-    auto existing_distance_result = m_dictionary->find_copy_in_seekback(existing_distances, m_dictionary->used_space(), normalized_to_real_match_length_offset);
 
-    if (existing_distance_result.has_value()) {
-        auto selected_match = existing_distance_result.release_value();
-        TRY(encode_existing_match(selected_match.distance, selected_match.length));
-        return {};
+    auto matches = m_match_finder->matches();
+    if (lookahead_size < normalized_to_real_match_length_offset)
+        return encode_literal();
+
+    // Check if any of our existing match distances are currently usable.
+    size_t existing_distance { 0 };
+    u16 existing_length { 0 };
+    for (u32 normalized_distance : { m_rep0, m_rep1, m_rep2, m_rep3 }) {
+        size_t const distance = normalized_distance + normalized_to_real_match_distance_offset;
+        if (distance > m_match_finder->history_size())
+            continue;
+
+        auto const length = m_match_finder->match_length(0, distance, largest_real_match_length);
+        if (length >= m_options.nice_match_length)
+            return encode_existing_match(distance, length);
+
+        if (length > existing_length) {
+            existing_distance = distance;
+            existing_length = length;
+        }
     }
 
-    // If we weren't able to find any viable existing offsets, we now have to search the rest of the dictionary for possible new offsets.
-    auto new_distance_result = m_dictionary->find_copy_in_seekback(m_dictionary->used_space(), normalized_to_real_match_length_offset);
+    LzmaMatch new_match;
+    if (!matches.is_empty()) {
+        new_match = matches.last();
+        if (new_match.length >= m_options.nice_match_length)
+            return encode_new_match(new_match.distance, new_match.length);
 
-    if (new_distance_result.has_value()) {
-        auto selected_match = new_distance_result.release_value();
-        TRY(encode_new_match(selected_match.distance, selected_match.length));
-        return {};
+        // A match that is one byte shorter but much closer is usually cheaper to encode.
+        while (matches.size() > 1 && new_match.length == matches[matches.size() - 2].length + 1 && is_much_closer(matches[matches.size() - 2].distance, new_match.distance)) {
+            matches = matches.trim(matches.size() - 1);
+            new_match = matches.last();
+        }
+
+        // Two literals are cheaper than a short match from far away.
+        if (new_match.length == normalized_to_real_match_length_offset && new_match.distance > 0x80)
+            new_match = {};
     }
 
-    // If we weren't able to find any matches, we don't have any other choice than to encode the next byte as a literal.
-    u8 next_byte { 0 };
-    TRY(m_dictionary->read({ &next_byte, sizeof(next_byte) }));
-    TRY(encode_literal(next_byte));
-    return {};
+    if (existing_length >= normalized_to_real_match_length_offset) {
+        if (existing_length + 1 >= new_match.length
+            || (existing_length + 2 >= new_match.length && new_match.distance > (1 << 9))
+            || (existing_length + 3 >= new_match.length && new_match.distance > (1 << 15)))
+            return encode_existing_match(existing_distance, existing_length);
+    }
+
+    if (new_match.length < normalized_to_real_match_length_offset || lookahead_size <= normalized_to_real_match_length_offset)
+        return encode_literal();
+
+    // If the next position has a better match, encode a literal now and take that one instead.
+    if (auto next_matches = m_match_finder->next_matches(); !next_matches.is_empty()) {
+        auto const next_match = next_matches.last();
+        if ((next_match.length >= new_match.length && next_match.distance < new_match.distance)
+            || (next_match.length == new_match.length + 1 && !is_much_closer(new_match.distance, next_match.distance))
+            || next_match.length > new_match.length + 1
+            || (next_match.length + 1 >= new_match.length && new_match.length >= 3 && is_much_closer(next_match.distance, new_match.distance)))
+            return encode_literal();
+    }
+
+    // The same goes for an existing distance that covers the rest of our match from the next position.
+    u16 const remaining_length = max(new_match.length - 1, normalized_to_real_match_length_offset);
+    size_t const next_history_size = min(m_match_finder->history_size() + 1, static_cast<size_t>(m_options.dictionary_size));
+    for (u32 normalized_distance : { m_rep0, m_rep1, m_rep2, m_rep3 }) {
+        size_t const distance = normalized_distance + normalized_to_real_match_distance_offset;
+        if (distance <= next_history_size && m_match_finder->match_length(1, distance, remaining_length) == remaining_length)
+            return encode_literal();
+    }
+
+    return encode_new_match(new_match.distance, new_match.length);
 }
 
 ErrorOr<Bytes> LzmaDecompressor::read_some(Bytes bytes)
@@ -1212,9 +1291,14 @@ void LzmaDecompressor::close()
 {
 }
 
+ErrorOr<NonnullOwnPtr<LzmaMatchFinder>> LzmaCompressor::create_match_finder(LzmaCompressorOptions const& options)
+{
+    return LzmaMatchFinder::create(options.match_finder, options.dictionary_size, options.nice_match_length, options.match_finder_depth, largest_real_match_length);
+}
+
 ErrorOr<NonnullOwnPtr<LzmaCompressor>> LzmaCompressor::create_container(MaybeOwned<Stream> stream, LzmaCompressorOptions const& options)
 {
-    auto dictionary = TRY(try_make<SearchableCircularBuffer>(TRY(SearchableCircularBuffer::create_empty(options.dictionary_size + largest_real_match_length))));
+    auto match_finder = TRY(create_match_finder(options));
 
     // "The LZMA Decoder uses (1 << (lc + lp)) tables with CProb values, where each table contains 0x300 CProb values."
     auto literal_probabilities = TRY(FixedArray<Probability>::create(literal_probability_table_size * (1 << (options.literal_context_bits + options.literal_position_bits))));
@@ -1222,16 +1306,31 @@ ErrorOr<NonnullOwnPtr<LzmaCompressor>> LzmaCompressor::create_container(MaybeOwn
     auto header = TRY(LzmaHeader::from_compressor_options(options));
     TRY(stream->write_value(header));
 
-    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) LzmaCompressor(move(stream), options, move(dictionary), move(literal_probabilities))));
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) LzmaCompressor(move(stream), options, move(match_finder), move(literal_probabilities))));
 
     return compressor;
 }
 
-LzmaCompressor::LzmaCompressor(MaybeOwned<AK::Stream> stream, Compress::LzmaCompressorOptions options, MaybeOwned<SearchableCircularBuffer> dictionary, FixedArray<Compress::LzmaState::Probability> literal_probabilities)
+ErrorOr<NonnullOwnPtr<LzmaCompressor>> LzmaCompressor::create_raw_stream(MaybeOwned<Stream> stream, LzmaCompressorOptions const& options, Optional<MaybeOwned<LzmaMatchFinder>> match_finder)
+{
+    if (!match_finder.has_value())
+        match_finder = TRY(create_match_finder(options));
+
+    VERIFY((*match_finder)->max_lookahead_size() == largest_real_match_length);
+
+    // "The LZMA Decoder uses (1 << (lc + lp)) tables with CProb values, where each table contains 0x300 CProb values."
+    auto literal_probabilities = TRY(FixedArray<Probability>::create(literal_probability_table_size * (1 << (options.literal_context_bits + options.literal_position_bits))));
+
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) LzmaCompressor(move(stream), options, match_finder.release_value(), move(literal_probabilities))));
+
+    return compressor;
+}
+
+LzmaCompressor::LzmaCompressor(MaybeOwned<AK::Stream> stream, Compress::LzmaCompressorOptions options, MaybeOwned<LzmaMatchFinder> match_finder, FixedArray<Compress::LzmaState::Probability> literal_probabilities)
     : LzmaState(move(literal_probabilities))
     , m_stream(move(stream))
     , m_options(move(options))
-    , m_dictionary(move(dictionary))
+    , m_match_finder(move(match_finder))
 {
 }
 
@@ -1243,24 +1342,18 @@ ErrorOr<Bytes> LzmaCompressor::read_some(Bytes)
 ErrorOr<size_t> LzmaCompressor::write_some(ReadonlyBytes bytes)
 {
     // Fill the input buffer until it's full or until we can't read any more data.
-    size_t processed_bytes = min(bytes.size(), largest_real_match_length - m_dictionary->used_space());
-    bytes = bytes.trim(processed_bytes);
-
-    while (bytes.size() > 0) {
-        auto const written_bytes = m_dictionary->write(bytes);
-        bytes = bytes.slice(written_bytes);
-    }
-
-    VERIFY(m_dictionary->used_space() <= largest_real_match_length);
+    size_t processed_bytes = m_match_finder->write(bytes);
 
-    if (m_options.uncompressed_size.has_value() && m_total_processed_bytes + m_dictionary->used_space() > m_options.uncompressed_size.value())
+    if (m_options.uncompressed_size.has_value() && m_total_processed_bytes + m_match_finder->lookahead_size() > m_options.uncompressed_size.value())
         return Error::from_string_literal("Tried to compress more LZMA data than announced");
 
-    TRY(encode_once());
+    // Only encode once the lookahead is full, so that how the data is split into writes doesn't limit the match lengths.
+    if (m_match_finder->lookahead_size() == largest_real_match_length)
+        TRY(encode_once());
 
     // If we read enough data to reach the final uncompressed size, flush automatically.
     // Flushing will handle encoding the remaining data for us and finalize the stream.
-    if (m_options.uncompressed_size.has_value() && m_total_processed_bytes + m_dictionary->used_space() >= m_options.uncompressed_size.value())
+    if (m_options.uncompressed_size.has_value() && m_total_processed_bytes + m_match_finder->lookahead_size() >= m_options.uncompressed_size.value())
         TRY(flush());
 
     return processed_bytes;
@@ -1271,7 +1364,7 @@ ErrorOr<void> LzmaCompressor::flush()
     if (m_has_flushed_data)
         return Error::from_string_literal("Flushed an LZMA stream twice");
 
-    while (m_dictionary->used_space() > 0)
+    while (m_match_finder->lookahead_size() > 0)
         TRY(encode_once());
 
     if (m_options.uncompressed_size.has_value() && m_total_processed_bytes < m_options.uncompressed_size.value())
@@ -1282,6 +1375,14 @@ ErrorOr<void> LzmaCompressor::flush()
     if (!m_options.uncompressed_size.has_value())
         TRY(encode_normalized_simple_match(end_of_stream_marker, 0));
 
+    TRY(finish_range_encoder());
+
+    m_has_flushed_data = true;
+    return {};
+}
+
+ErrorOr<void> LzmaCompressor::finish_range_encoder()
+{
     // Shifting the range encoder using the normal operation handles any pending overflows.
     TRY(shift_range_encoder());
 
@@ -1295,10 +1396,23 @@ ErrorOr<void> LzmaCompressor::flush()
     TRY(m_stream->write_value<u8>(m_range_encoder_code >> 16));
     TRY(m_stream->write_value<u8>(m_range_encoder_code >> 8));
 
-    m_has_flushed_data = true;
     return {};
 }
 
+void LzmaCompressor::reset_range_encoder()
+{
+    m_range_encoder_range = 0xFFFFFFFF;
+    m_range_encoder_code = 0;
+    m_range_encoder_cached_byte = 0x00;
+    m_range_encoder_ff_chain_length = 0;
+}
+
+size_t LzmaCompressor::range_encoder_pending_size() const
+{
+    // The number of bytes that finish_range_encoder() would write right now.
+    return 1 + m_range_encoder_ff_chain_length + 4;
+}
+
 bool LzmaCompressor::is_eof() const
 {
     return true;
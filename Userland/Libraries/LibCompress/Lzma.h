@@ -11,6 +11,7 @@
 #include <AK/MaybeOwned.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Stream.h>
+#include <LibCompress/LzmaMatchFinder.h>
 
 namespace Compress {
 
@@ -39,6 +40,21 @@ struct LzmaCompressorOptions {
     u8 position_bits { 2 };
     u32 dictionary_size { 8 * MiB };
     Optional<u64> uncompressed_size {};
+
+    LzmaMatchFinderType match_finder { LzmaMatchFinderType::BinaryTree4 };
+
+    // Once a match is at least this long, we stop looking for longer ones.
+    u16 nice_match_length { 64 };
+
+    // How many earlier positions the match finder checks at most, or 0 for a default that suits the match finder.
+    u32 match_finder_depth { 0 };
+
+    // The presets range from 0 (fastest) to 9 (smallest) and pick the dictionary sizes of XZ Utils, with similar match
+    // finder settings. The fast ones up to 3 use hash chains, the others binary trees.
+    static constexpr u8 min_preset = 0;
+    static constexpr u8 max_preset = 9;
+    static constexpr u8 default_preset = 6;
+    static LzmaCompressorOptions for_preset(u8 preset);
 };
 
 // Described in section "lzma file format".
@@ -217,6 +233,9 @@ public:
     /// Creates a compressor for a standalone LZMA container (.lzma file extension, occasionally known as an LZMA 'archive').
     static ErrorOr<NonnullOwnPtr<LzmaCompressor>> create_container(MaybeOwned<Stream>, LzmaCompressorOptions const&);
 
+    /// Creates a compressor for a raw stream of LZMA-compressed data (to be embedded in other file formats).
+    static ErrorOr<NonnullOwnPtr<LzmaCompressor>> create_raw_stream(MaybeOwned<Stream>, LzmaCompressorOptions const&, Optional<MaybeOwned<LzmaMatchFinder>> match_finder = {});
+
     /// Finishes the archive by writing out the remaining data from the range coder.
     ErrorOr<void> flush();
 
@@ -229,7 +248,16 @@ public:
     virtual ~LzmaCompressor();
 
 private:
-    LzmaCompressor(MaybeOwned<Stream>, LzmaCompressorOptions, MaybeOwned<SearchableCircularBuffer>, FixedArray<Probability> literal_probabilities);
+    // LZMA2 splits the LZMA data into chunks, each of which has its own range encoder.
+    friend class Lzma2Compressor;
+
+    LzmaCompressor(MaybeOwned<Stream>, LzmaCompressorOptions, MaybeOwned<LzmaMatchFinder>, FixedArray<Probability> literal_probabilities);
+
+    static ErrorOr<NonnullOwnPtr<LzmaMatchFinder>> create_match_finder(LzmaCompressorOptions const&);
+
+    ErrorOr<void> finish_range_encoder();
+    void reset_range_encoder();
+    size_t range_encoder_pending_size() const;
 
     ErrorOr<void> shift_range_encoder();
     ErrorOr<void> normalize_range_encoder();
@@ -241,7 +269,7 @@ private:
     ErrorOr<void> encode_normalized_match_distance(u16 normalized_match_length, u32 normalized_match_distance);
 
     ErrorOr<void> encode_match_type(MatchType);
-    ErrorOr<void> encode_literal(u8 literal);
+    ErrorOr<void> encode_literal();
     ErrorOr<void> encode_existing_match(size_t real_distance, size_t real_length);
     ErrorOr<void> encode_new_match(size_t real_distance, size_t real_length);
     ErrorOr<void> encode_normalized_simple_match(u32 normalized_distance, u16 normalized_length);
@@ -253,9 +281,8 @@ private:
     MaybeOwned<Stream> m_stream;
     LzmaCompressorOptions m_options;
 
-    // This doubles as an input buffer, which is appended at the very front of the buffer.
-    // Therefore, the size of this should at least be the dictionary size + the largest possible repetition length.
-    MaybeOwned<SearchableCircularBuffer> m_dictionary;
+    // This holds the dictionary, followed by up to the largest possible repetition length of input that is yet to be encoded.
+    MaybeOwned<LzmaMatchFinder> m_match_finder;
 
     // Range encoder state.
     u32 m_range_encoder_range { 0xFFFFFFFF };
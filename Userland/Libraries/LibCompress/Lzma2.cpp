@@ -186,4 +186,182 @@ void Lzma2Decompressor::close()
 {
 }
 
+ErrorOr<NonnullOwnPtr<Lzma2Compressor>> Lzma2Compressor::create_raw_stream(MaybeOwned<Stream> stream, LzmaCompressorOptions const& lzma_options)
+{
+    // The chunks carry their own sizes, and the end of the data is marked by the LZMA2 stream itself.
+    auto options = lzma_options;
+    options.uncompressed_size = {};
+
+    auto match_finder = TRY(LzmaCompressor::create_match_finder(options));
+    auto chunk_stream = TRY(try_make<AllocatingMemoryStream>());
+    auto lzma_compressor = TRY(LzmaCompressor::create_raw_stream(MaybeOwned<Stream> { *chunk_stream }, options, MaybeOwned<LzmaMatchFinder> { *match_finder }));
+
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Lzma2Compressor(move(stream), options, move(match_finder), move(chunk_stream), move(lzma_compressor))));
+    return compressor;
+}
+
+Lzma2Compressor::Lzma2Compressor(MaybeOwned<Stream> stream, LzmaCompressorOptions options, NonnullOwnPtr<LzmaMatchFinder> match_finder, NonnullOwnPtr<AllocatingMemoryStream> chunk_stream, NonnullOwnPtr<LzmaCompressor> lzma_compressor)
+    : m_stream(move(stream))
+    , m_options(move(options))
+    , m_match_finder(move(match_finder))
+    , m_chunk_stream(move(chunk_stream))
+    , m_lzma_compressor(move(lzma_compressor))
+{
+    // The chunks are terminated by us instead of by an end-of-stream marker.
+    m_lzma_compressor->m_has_flushed_data = true;
+}
+
+Lzma2Compressor::~Lzma2Compressor()
+{
+    if (!m_has_flushed_data) {
+        // Note: We need a better API for specifying things like this.
+        flush().release_value_but_fixme_should_propagate_errors();
+    }
+}
+
+ErrorOr<Bytes> Lzma2Compressor::read_some(Bytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+ErrorOr<size_t> Lzma2Compressor::write_some(ReadonlyBytes bytes)
+{
+    if (m_has_flushed_data)
+        return Error::from_string_literal("Tried to write to a flushed LZMA2 stream");
+
+    auto const written_bytes = m_match_finder->write(bytes);
+
+    // Only encode once the lookahead is full, so that how the data is split into writes doesn't limit the match lengths.
+    // The LZMA compressor encodes exactly one literal or match for every call, so the chunk can't overflow in between.
+    if (m_match_finder->lookahead_size() == LzmaCompressor::largest_real_match_length) {
+        TRY(finish_chunk_if_full());
+        TRY(m_lzma_compressor->encode_once());
+    }
+
+    return written_bytes;
+}
+
+ErrorOr<void> Lzma2Compressor::flush()
+{
+    if (m_has_flushed_data)
+        return Error::from_string_literal("Flushed an LZMA2 stream twice");
+
+    while (m_match_finder->lookahead_size() > 0) {
+        TRY(finish_chunk_if_full());
+
+        // Aligning the end of the chunk might have used up the remaining data.
+        if (m_match_finder->lookahead_size() > 0)
+            TRY(m_lzma_compressor->encode_once());
+    }
+
+    TRY(finish_chunk());
+
+    // "0 denotes the end of the file"
+    TRY(m_stream->write_value<u8>(0));
+
+    m_has_flushed_data = true;
+    return {};
+}
+
+ErrorOr<void> Lzma2Compressor::finish_chunk_if_full()
+{
+    // Leave enough room for encoding a match and up to 15 literals afterwards, as well as for flushing the range encoder.
+    static constexpr size_t compressed_size_margin = 256;
+    static constexpr size_t uncompressed_size_margin = LzmaCompressor::largest_real_match_length + 16;
+
+    auto compressed_size = m_chunk_stream->used_buffer_size() + m_lzma_compressor->range_encoder_pending_size();
+    auto uncompressed_size = m_lzma_compressor->m_total_processed_bytes - m_chunk_start_offset;
+    auto maximum_uncompressed_size = min(maximum_uncompressed_chunk_size, m_options.dictionary_size);
+
+    if (compressed_size + compressed_size_margin <= maximum_compressed_chunk_size && uncompressed_size + uncompressed_size_margin <= maximum_uncompressed_size)
+        return {};
+
+    // A chunk that is stored uncompressed forces a state reset for the next one. The LZMA decoder of XZ utils derives
+    // the position state from the absolute position in the dictionary, while ours counts from the last state reset,
+    // so only ever end chunks at positions where both agree. Literals only advance by one byte, which gets us there.
+    // This can only fall short at the end of the data, where there is no next chunk to worry about.
+    static constexpr size_t position_alignment = 1 << LzmaCompressor::maximum_number_of_position_bits;
+    while (m_lzma_compressor->m_total_processed_bytes % position_alignment != 0 && m_match_finder->lookahead_size() > 0)
+        TRY(m_lzma_compressor->encode_literal());
+
+    return finish_chunk();
+}
+
+ErrorOr<void> Lzma2Compressor::finish_chunk()
+{
+    VERIFY(m_lzma_compressor->m_total_processed_bytes >= m_chunk_start_offset);
+    size_t const uncompressed_size = m_lzma_compressor->m_total_processed_bytes - m_chunk_start_offset;
+    if (uncompressed_size == 0)
+        return {};
+
+    TRY(m_lzma_compressor->finish_range_encoder());
+    m_lzma_compressor->reset_range_encoder();
+
+    size_t const compressed_size = m_chunk_stream->used_buffer_size();
+    VERIFY(compressed_size <= maximum_compressed_chunk_size);
+    VERIFY(uncompressed_size <= maximum_uncompressed_chunk_size);
+
+    if (compressed_size < uncompressed_size) {
+        // " - 0x80-0xff denotes an LZMA chunk, where the lowest 5 bits are used as bit 16-20
+        //     of the uncompressed size minus one, and bit 5-6 indicates what should be reset."
+        u8 const control_byte = 0x80 | (to_underlying(m_next_reset) << 5) | ((uncompressed_size - 1) >> 16);
+        TRY(m_stream->write_value<u8>(control_byte));
+        TRY(m_stream->write_value<BigEndian<u16>>((uncompressed_size - 1) & 0xFFFF));
+        TRY(m_stream->write_value<BigEndian<u16>>(compressed_size - 1));
+
+        if (to_underlying(m_next_reset) >= to_underlying(Reset::StateAndProperties)) {
+            auto encoded_properties = TRY(LzmaHeader::encode_model_properties({
+                .literal_context_bits = m_options.literal_context_bits,
+                .literal_position_bits = m_options.literal_position_bits,
+                .position_bits = m_options.position_bits,
+            }));
+            TRY(m_stream->write_value<u8>(encoded_properties));
+        }
+
+        auto compressed_data = TRY(ByteBuffer::create_uninitialized(compressed_size));
+        TRY(m_chunk_stream->read_until_filled(compressed_data));
+        TRY(m_stream->write_until_depleted(compressed_data));
+
+        m_next_reset = Reset::Nothing;
+        m_chunk_start_offset = m_lzma_compressor->m_total_processed_bytes;
+        return {};
+    }
+
+    // The data didn't compress, so store it as-is. The encoded bytes are still in the dictionary, right behind the lookahead.
+    TRY(m_chunk_stream->discard(compressed_size));
+
+    auto const uncompressed_data = m_match_finder->history(uncompressed_size);
+
+    // " - 1 denotes a dictionary reset followed by an uncompressed chunk"
+    // " - 2 denotes an uncompressed chunk without a dictionary reset"
+    TRY(m_stream->write_value<u8>(m_next_reset == Reset::Everything ? 1 : 2));
+    TRY(m_stream->write_value<BigEndian<u16>>(uncompressed_size - 1));
+    TRY(m_stream->write_until_depleted(uncompressed_data));
+
+    // A dictionary reset also invalidates the properties, and the probabilities we just used for the discarded LZMA data are unknown to the decoder.
+    if (m_next_reset == Reset::Everything)
+        m_next_reset = Reset::StateAndProperties;
+    else if (m_next_reset == Reset::Nothing)
+        m_next_reset = Reset::State;
+
+    m_lzma_compressor = TRY(LzmaCompressor::create_raw_stream(MaybeOwned<Stream> { *m_chunk_stream }, m_options, MaybeOwned<LzmaMatchFinder> { *m_match_finder }));
+    m_lzma_compressor->m_has_flushed_data = true;
+    m_chunk_start_offset = 0;
+    return {};
+}
+
+bool Lzma2Compressor::is_eof() const
+{
+    return true;
+}
+
+bool Lzma2Compressor::is_open() const
+{
+    return !m_has_flushed_data;
+}
+
+void Lzma2Compressor::close()
+{
+}
+
 }
@@ -8,6 +8,7 @@
 
 #include <AK/CircularBuffer.h>
 #include <AK/MaybeOwned.h>
+#include <AK/MemoryStream.h>
 #include <AK/Stream.h>
 #include <LibCompress/Lzma.h>
 
@@ -43,4 +44,53 @@ private:
     Optional<LzmaDecompressorOptions> m_last_lzma_options;
 };
 
+class Lzma2Compressor : public Stream {
+public:
+    /// Creates a compressor that does not write the leading byte indicating the dictionary size.
+    static ErrorOr<NonnullOwnPtr<Lzma2Compressor>> create_raw_stream(MaybeOwned<Stream>, LzmaCompressorOptions const&);
+
+    /// Finishes the stream by writing out the remaining data and the end marker.
+    ErrorOr<void> flush();
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+
+    virtual ~Lzma2Compressor();
+
+private:
+    // "LZMA chunks consist of: [...] A 16-bit big-endian value encoding the compressed size minus one", and the
+    // uncompressed size minus one has 21 bits.
+    static constexpr size_t maximum_compressed_chunk_size = 64 * KiB;
+    static constexpr size_t maximum_uncompressed_chunk_size = 2 * MiB;
+
+    // What gets reset at the start of the next chunk, as encoded in bits 5-6 of the control byte of an LZMA chunk.
+    enum class Reset : u8 {
+        Nothing = 0,
+        State = 1,
+        StateAndProperties = 2,
+        Everything = 3,
+    };
+
+    Lzma2Compressor(MaybeOwned<Stream>, LzmaCompressorOptions, NonnullOwnPtr<LzmaMatchFinder>, NonnullOwnPtr<AllocatingMemoryStream> chunk_stream, NonnullOwnPtr<LzmaCompressor>);
+
+    ErrorOr<void> finish_chunk_if_full();
+    ErrorOr<void> finish_chunk();
+
+    MaybeOwned<Stream> m_stream;
+    LzmaCompressorOptions m_options;
+    bool m_has_flushed_data { false };
+
+    NonnullOwnPtr<LzmaMatchFinder> m_match_finder;
+
+    // The LZMA compressor writes the current chunk into this buffer, since we only know the header of a chunk once it is complete.
+    NonnullOwnPtr<AllocatingMemoryStream> m_chunk_stream;
+    NonnullOwnPtr<LzmaCompressor> m_lzma_compressor;
+    u64 m_chunk_start_offset { 0 };
+
+    Reset m_next_reset { Reset::Everything };
+};
+
 }
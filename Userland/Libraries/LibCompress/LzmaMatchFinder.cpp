@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/Endian.h>
+#include <AK/IntegralMath.h>
+#include <LibCompress/LzmaMatchFinder.h>
+
+namespace Compress {
+
+static u32 common_length(u8 const* a, u8 const* b, u32 length, u32 limit)
+{
+    while (length + sizeof(u64) <= limit) {
+        u64 a_value;
+        u64 b_value;
+        __builtin_memcpy(&a_value, a + length, sizeof(u64));
+        __builtin_memcpy(&b_value, b + length, sizeof(u64));
+        if (auto difference = AK::convert_between_host_and_little_endian(a_value ^ b_value); difference != 0)
+            return length + count_trailing_zeroes(difference) / 8;
+        length += sizeof(u64);
+    }
+
+    while (length < limit && a[length] == b[length])
+        length++;
+    return length;
+}
+
+static constexpr u32 hash_multiplier = 2654435761u;
+
+static u32 read_hash_value(u8 const* data)
+{
+    u32 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return AK::convert_between_host_and_little_endian(value);
+}
+
+ErrorOr<NonnullOwnPtr<LzmaMatchFinder>> LzmaMatchFinder::create(LzmaMatchFinderType type, u32 dictionary_size, u16 nice_length, u32 depth, u16 max_lookahead_size)
+{
+    VERIFY(dictionary_size > 0 && dictionary_size < NumericLimits<u32>::max() / 2);
+    VERIFY(max_lookahead_size <= max_match_length);
+
+    nice_length = clamp<u16>(nice_length, 4, max_lookahead_size);
+
+    // The defaults of XZ Utils: the tree usually finds the longest match in the first few steps, a chain doesn't.
+    if (depth == 0)
+        depth = type == LzmaMatchFinderType::BinaryTree4 ? 16 + nice_length / 2 : 4 + nice_length / 4;
+
+    // Half as many buckets as positions keeps the chains short without wasting memory on small dictionaries.
+    u8 const hash_4_bits = clamp<u32>(AK::ceil_log2(dictionary_size) - 1, 16, 24);
+    auto hash_table = TRY(FixedArray<u32>::create(hash_2_size + hash_3_size + (static_cast<size_t>(1) << hash_4_bits)));
+
+    u32 const cyclic_size = dictionary_size + 1;
+    auto son = TRY(FixedArray<u32>::create(type == LzmaMatchFinderType::BinaryTree4 ? 2 * static_cast<size_t>(cyclic_size) : cyclic_size));
+
+    // Leaving room for another dictionary's worth of data means that we only have to move the data every so often.
+    auto buffer = TRY(ByteBuffer::create_uninitialized(dictionary_size + max(dictionary_size, 64 * KiB) + max_lookahead_size));
+
+    return adopt_nonnull_own_or_enomem(new (nothrow) LzmaMatchFinder(type, dictionary_size, nice_length, depth, max_lookahead_size, move(buffer), move(hash_table), hash_4_bits, move(son)));
+}
+
+LzmaMatchFinder::LzmaMatchFinder(LzmaMatchFinderType type, u32 dictionary_size, u16 nice_length, u32 depth, u16 max_lookahead_size, ByteBuffer buffer, FixedArray<u32> hash_table, u8 hash_4_bits, FixedArray<u32> son)
+    : m_type(type)
+    , m_dictionary_size(dictionary_size)
+    , m_nice_length(nice_length)
+    , m_depth(depth)
+    , m_max_lookahead_size(max_lookahead_size)
+    , m_buffer(move(buffer))
+    , m_hashed_position_offset(0 - static_cast<u64>(dictionary_size + 1))
+    , m_cyclic_size(dictionary_size + 1)
+    , m_hash_table(move(hash_table))
+    , m_hash_4_bits(hash_4_bits)
+    , m_son(move(son))
+{
+}
+
+size_t LzmaMatchFinder::write(ReadonlyBytes bytes)
+{
+    auto const count = min(bytes.size(), m_max_lookahead_size - lookahead_size());
+
+    if (m_end_position + count - m_buffer_position > m_buffer.size()) {
+        // Positions that are still waiting to be inserted need their dictionary as well.
+        auto const oldest_position = min(m_position, m_search_position);
+        auto const new_buffer_position = oldest_position - min(oldest_position, static_cast<u64>(m_dictionary_size));
+        auto const offset = new_buffer_position - m_buffer_position;
+        __builtin_memmove(m_buffer.data(), m_buffer.data() + offset, m_end_position - new_buffer_position);
+        m_buffer_position = new_buffer_position;
+    }
+
+    bytes.trim(count).copy_to(m_buffer.span().slice(m_end_position - m_buffer_position));
+    m_end_position += count;
+    insert_pending_positions();
+    return count;
+}
+
+u8 LzmaMatchFinder::byte_at_distance(size_t distance) const
+{
+    VERIFY(distance > 0 && distance <= m_position - m_buffer_position);
+    return *(data_at(m_position) - distance);
+}
+
+ReadonlyBytes LzmaMatchFinder::history(size_t size) const
+{
+    VERIFY(size <= m_position - m_buffer_position);
+    return { data_at(m_position) - size, size };
+}
+
+u16 LzmaMatchFinder::match_length(size_t lookahead_offset, size_t distance, u16 max_length) const
+{
+    VERIFY(lookahead_offset <= lookahead_size());
+    VERIFY(distance > 0 && distance <= m_position + lookahead_offset - m_buffer_position);
+
+    auto const* current = data_at(m_position + lookahead_offset);
+    auto const limit = min<size_t>(max_length, lookahead_size() - lookahead_offset);
+    return common_length(current - distance, current, 0, limit);
+}
+
+ReadonlySpan<LzmaMatch> LzmaMatchFinder::matches()
+{
+    return matches_at(m_position);
+}
+
+ReadonlySpan<LzmaMatch> LzmaMatchFinder::next_matches()
+{
+    VERIFY(lookahead_size() > 1);
+    return matches_at(m_position + 1);
+}
+
+void LzmaMatchFinder::advance(size_t count)
+{
+    VERIFY(count <= lookahead_size());
+    m_position += count;
+    insert_pending_positions();
+}
+
+void LzmaMatchFinder::insert_pending_positions()
+{
+    // A position is only sorted into the tree once the nice length of data follows it, otherwise it would be sorted by
+    // fewer bytes than the rest. This can leave the search position behind until the next write.
+    while (m_search_position < m_position && m_end_position - m_search_position >= m_nice_length)
+        insert_without_search();
+}
+
+ReadonlySpan<LzmaMatch> LzmaMatchFinder::matches_at(u64 position)
+{
+    auto& cache = m_cached_matches[position % m_cached_matches.size()];
+    if (cache.position == position)
+        return cache.matches.span().trim(cache.count);
+
+    while (m_search_position < position)
+        insert_without_search();
+    VERIFY(m_search_position == position);
+
+    cache.position = position;
+    cache.count = find_and_insert(cache.matches.data());
+
+    // The search stops at the nice length, but a longer match is always better, and costs nothing to find.
+    if (cache.count > 0 && cache.matches[cache.count - 1].length == m_nice_length) {
+        auto& longest = cache.matches[cache.count - 1];
+        auto const* current = data_at(position);
+        longest.length = common_length(current - longest.distance, current, longest.length, min<u64>(m_end_position - position, m_max_lookahead_size));
+    }
+
+    return cache.matches.span().trim(cache.count);
+}
+
+size_t LzmaMatchFinder::find_and_insert(LzmaMatch* matches)
+{
+    auto const* current = data_at(m_search_position);
+    auto const available = m_end_position - m_search_position;
+
+    // There is too little data left to hash, which only ever happens at the end of the input.
+    if (available < 4) {
+        move_search_position();
+        return 0;
+    }
+
+    u32 const length_limit = min<u64>(available, m_nice_length);
+    u32 const position = hashed_position(m_search_position);
+
+    u32 const value = read_hash_value(current);
+    auto* hash_2_table = m_hash_table.data();
+    auto* hash_3_table = hash_2_table + hash_2_size;
+    auto* hash_4_table = hash_3_table + hash_3_size;
+    auto& hash_2_entry = hash_2_table[((value & 0xFFFF) * hash_multiplier) >> (32 - 10)];
+    auto& hash_3_entry = hash_3_table[((value & 0xFFFFFF) * hash_multiplier) >> (32 - 16)];
+    auto& hash_4_entry = hash_4_table[(value * hash_multiplier) >> (32 - m_hash_4_bits)];
+
+    u32 const delta_2 = position - hash_2_entry;
+    u32 const delta_3 = position - hash_3_entry;
+    u32 const current_match = hash_4_entry;
+    hash_2_entry = position;
+    hash_3_entry = position;
+    hash_4_entry = position;
+
+    // The small tables catch short matches that are close by, which the larger ones would miss due to their stricter hash.
+    auto* next_match = matches;
+    u32 best_length = 1;
+    auto const check_short_match = [&](u32 delta) {
+        if (delta >= m_cyclic_size)
+            return;
+        u32 const length = common_length(current - delta, current, 0, length_limit);
+        if (length > best_length) {
+            best_length = length;
+            *next_match++ = { delta, static_cast<u16>(length) };
+        }
+    };
+    check_short_match(delta_2);
+    if (delta_3 != delta_2)
+        check_short_match(delta_3);
+
+    if (best_length == length_limit) {
+        if (m_type == LzmaMatchFinderType::BinaryTree4)
+            binary_tree_skip(length_limit, current_match);
+        else
+            m_son[m_cyclic_position] = current_match;
+    } else if (m_type == LzmaMatchFinderType::BinaryTree4) {
+        binary_tree_find(length_limit, current_match, max(best_length, 3u), next_match);
+    } else {
+        hash_chain_find(length_limit, current_match, max(best_length, 3u), next_match);
+    }
+
+    move_search_position();
+    return next_match - matches;
+}
+
+void LzmaMatchFinder::insert_without_search()
+{
+    auto const* current = data_at(m_search_position);
+    auto const available = m_end_position - m_search_position;
+    if (available < 4) {
+        move_search_position();
+        return;
+    }
+
+    u32 const position = hashed_position(m_search_position);
+    u32 const value = read_hash_value(current);
+    auto* hash_2_table = m_hash_table.data();
+    auto* hash_3_table = hash_2_table + hash_2_size;
+    auto* hash_4_table = hash_3_table + hash_3_size;
+    hash_2_table[((value & 0xFFFF) * hash_multiplier) >> (32 - 10)] = position;
+    hash_3_table[((value & 0xFFFFFF) * hash_multiplier) >> (32 - 16)] = position;
+    auto& hash_4_entry = hash_4_table[(value * hash_multiplier) >> (32 - m_hash_4_bits)];
+    u32 const current_match = hash_4_entry;
+    hash_4_entry = position;
+
+    if (m_type == LzmaMatchFinderType::BinaryTree4)
+        binary_tree_skip(min<u64>(available, m_nice_length), current_match);
+    else
+        m_son[m_cyclic_position] = current_match;
+
+    move_search_position();
+}
+
+void LzmaMatchFinder::hash_chain_find(u32 length_limit, u32 current_match, u32 best_length, LzmaMatch*& matches)
+{
+    auto const* current = data_at(m_search_position);
+    u32 const position = hashed_position(m_search_position);
+
+    m_son[m_cyclic_position] = current_match;
+
+    for (u32 depth = m_depth; depth > 0; depth--) {
+        u32 const delta = position - current_match;
+        if (delta >= m_cyclic_size)
+            return;
+
+        auto const* candidate = current - delta;
+        current_match = m_son[m_cyclic_position - delta + (delta > m_cyclic_position ? m_cyclic_size : 0)];
+
+        if (candidate[best_length] != current[best_length] || candidate[0] != current[0])
+            continue;
+
+        u32 const length = common_length(candidate, current, 1, length_limit);
+        if (length > best_length) {
+            best_length = length;
+            *matches++ = { delta, static_cast<u16>(length) };
+            if (length == length_limit)
+                return;
+        }
+    }
+}
+
+// Every node has the positions with smaller data as its left child and the ones with larger data as its right child.
+// The new position becomes the root, and the old tree gets split into its two subtrees along the way down, just like
+// inserting into a splay tree. The data at both sides agrees with the new position in at least as many bytes as the
+// closest node on that side, so comparisons can start from there.
+void LzmaMatchFinder::binary_tree_find(u32 length_limit, u32 current_match, u32 best_length, LzmaMatch*& matches)
+{
+    auto const* current = data_at(m_search_position);
+    u32 const position = hashed_position(m_search_position);
+
+    u32* larger_slot = &m_son[2 * m_cyclic_position + 1];
+    u32* smaller_slot = &m_son[2 * m_cyclic_position];
+    u32 larger_length = 0;
+    u32 smaller_length = 0;
+
+    for (u32 depth = m_depth;; depth--) {
+        u32 const delta = position - current_match;
+        if (depth == 0 || delta >= m_cyclic_size) {
+            *larger_slot = 0;
+            *smaller_slot = 0;
+            return;
+        }
+
+        u32* pair = &m_son[2 * (m_cyclic_position - delta + (delta > m_cyclic_position ? m_cyclic_size : 0))];
+        auto const* candidate = current - delta;
+        u32 length = min(larger_length, smaller_length);
+
+        if (candidate[length] == current[length]) {
+            length = common_length(candidate, current, length + 1, length_limit);
+            if (length > best_length) {
+                best_length = length;
+                *matches++ = { delta, static_cast<u16>(length) };
+                if (length == length_limit) {
+                    replace_node(length_limit, pair, smaller_slot, larger_slot);
+                    return;
+                }
+            }
+        }
+
+        if (candidate[length] < current[length]) {
+            *smaller_slot = current_match;
+            smaller_slot = pair + 1;
+            current_match = *smaller_slot;
+            smaller_length = length;
+        } else {
+            *larger_slot = current_match;
+            larger_slot = pair;
+            current_match = *larger_slot;
+            larger_length = length;
+        }
+    }
+}
+
+// The new position replaces a candidate that is equal as far as the tree is concerned. Near the end of the data, they
+// were only compared up to a shorter limit, so the candidate's children might not be sorted correctly relative to the
+// new position. Dropping them keeps the tree sorted, at the cost of some matches for the last few positions.
+void LzmaMatchFinder::replace_node(u32 length_limit, u32 const* pair, u32* smaller_slot, u32* larger_slot) const
+{
+    bool const is_equal = length_limit == m_nice_length;
+    *smaller_slot = is_equal ? pair[0] : 0;
+    *larger_slot = is_equal ? pair[1] : 0;
+}
+
+void LzmaMatchFinder::binary_tree_skip(u32 length_limit, u32 current_match)
+{
+    auto const* current = data_at(m_search_position);
+    u32 const position = hashed_position(m_search_position);
+
+    u32* larger_slot = &m_son[2 * m_cyclic_position + 1];
+    u32* smaller_slot = &m_son[2 * m_cyclic_position];
+    u32 larger_length = 0;
+    u32 smaller_length = 0;
+
+    for (u32 depth = m_depth;; depth--) {
+        u32 const delta = position - current_match;
+        if (depth == 0 || delta >= m_cyclic_size) {
+            *larger_slot = 0;
+            *smaller_slot = 0;
+            return;
+        }
+
+        u32* pair = &m_son[2 * (m_cyclic_position - delta + (delta > m_cyclic_position ? m_cyclic_size : 0))];
+        auto const* candidate = current - delta;
+        u32 length = min(larger_length, smaller_length);
+
+        if (candidate[length] == current[length]) {
+            length = common_length(candidate, current, length + 1, length_limit);
+            if (length == length_limit) {
+                replace_node(length_limit, pair, smaller_slot, larger_slot);
+                return;
+            }
+        }
+
+        if (candidate[length] < current[length]) {
+            *smaller_slot = current_match;
+            smaller_slot = pair + 1;
+            current_match = *smaller_slot;
+            smaller_length = length;
+        } else {
+            *larger_slot = current_match;
+            larger_slot = pair;
+            current_match = *larger_slot;
+            larger_length = length;
+        }
+    }
+}
+
+void LzmaMatchFinder::move_search_position()
+{
+    m_search_position++;
+    if (++m_cyclic_position == m_cyclic_size)
+        m_cyclic_position = 0;
+
+    if (hashed_position(m_search_position) == NumericLimits<u32>::max())
+        normalize();
+}
+
+void LzmaMatchFinder::normalize()
+{
+    // Everything that is further away than the dictionary size becomes empty, and everything else moves down so that
+    // the current position is at the cyclic size again.
+    u32 const subtrahend = hashed_position(m_search_position) - m_cyclic_size;
+    auto const normalize_entries = [&](Span<u32> entries) {
+        for (auto& entry : entries)
+            entry = entry <= subtrahend ? 0 : entry - subtrahend;
+    };
+    normalize_entries(m_hash_table.span());
+    normalize_entries(m_son.span());
+    m_hashed_position_offset += subtrahend;
+}
+
+}
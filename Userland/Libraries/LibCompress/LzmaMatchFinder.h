@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/FixedArray.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Span.h>
+
+namespace Compress {
+
+enum class LzmaMatchFinderType : u8 {
+    // Every hash bucket is a list of earlier positions, newest first. Cheap to update, so it is the fast choice.
+    HashChain4,
+
+    // Every hash bucket is a binary search tree of earlier positions, sorted by the data that follows them. Updating it
+    // costs about as much as a search, but a search visits far fewer candidates to find the longest matches.
+    BinaryTree4,
+};
+
+struct LzmaMatch {
+    u32 distance { 0 }; // 1 refers to the byte right before the current one
+    u16 length { 0 };
+};
+
+// Holds the dictionary and the lookahead of an LZMA encoder, and finds earlier occurrences of the data at the current
+// position in it. The search structures follow those of XZ Utils: the first bytes are looked up in small hash tables
+// for 2 and 3 bytes, and longer matches come from a hash chain or a binary tree keyed by the first 4 bytes.
+class LzmaMatchFinder {
+public:
+    static ErrorOr<NonnullOwnPtr<LzmaMatchFinder>> create(LzmaMatchFinderType, u32 dictionary_size, u16 nice_length, u32 depth, u16 max_lookahead_size);
+
+    // Appends as much data to the lookahead as fits into it.
+    size_t write(ReadonlyBytes);
+
+    size_t lookahead_size() const { return m_end_position - m_position; }
+    size_t max_lookahead_size() const { return m_max_lookahead_size; }
+    ReadonlyBytes lookahead() const { return { data_at(m_position), lookahead_size() }; }
+
+    // The number of bytes in front of the current position that matches can refer to.
+    size_t history_size() const { return min(m_position, static_cast<u64>(m_dictionary_size)); }
+    u8 byte_at_distance(size_t distance) const;
+    ReadonlyBytes history(size_t size) const;
+
+    // The length of the match at the given distance, in bytes of the lookahead starting at the given offset.
+    u16 match_length(size_t lookahead_offset, size_t distance, u16 max_length) const;
+
+    // Matches at the current position (or the next one), sorted by length. Every match is longer than the previous one,
+    // and the longest one is extended beyond the nice length as far as the lookahead allows.
+    ReadonlySpan<LzmaMatch> matches();
+    ReadonlySpan<LzmaMatch> next_matches();
+
+    void advance(size_t count);
+
+private:
+    static constexpr size_t hash_2_size = 1 << 10;
+    static constexpr size_t hash_3_size = 1 << 16;
+    static constexpr u64 invalid_position = NumericLimits<u64>::max();
+
+    // The longest match that LZMA can encode.
+    static constexpr u16 max_match_length = 273;
+
+    struct CachedMatches {
+        u64 position { invalid_position };
+        size_t count { 0 };
+        // Every match is longer than the one before, and the shortest one has 2 bytes.
+        Array<LzmaMatch, max_match_length - 1> matches;
+    };
+
+    LzmaMatchFinder(LzmaMatchFinderType, u32 dictionary_size, u16 nice_length, u32 depth, u16 max_lookahead_size, ByteBuffer, FixedArray<u32> hash_table, u8 hash_4_bits, FixedArray<u32> son);
+
+    u8 const* data_at(u64 position) const { return m_buffer.data() + (position - m_buffer_position); }
+    u32 hashed_position(u64 position) const { return static_cast<u32>(position - m_hashed_position_offset); }
+
+    ReadonlySpan<LzmaMatch> matches_at(u64 position);
+    size_t find_and_insert(LzmaMatch* matches);
+    void insert_without_search();
+    void hash_chain_find(u32 length_limit, u32 current_match, u32 best_length, LzmaMatch*& matches);
+    void binary_tree_find(u32 length_limit, u32 current_match, u32 best_length, LzmaMatch*& matches);
+    void binary_tree_skip(u32 length_limit, u32 current_match);
+    void replace_node(u32 length_limit, u32 const* pair, u32* smaller_slot, u32* larger_slot) const;
+    void insert_pending_positions();
+    void move_search_position();
+    void normalize();
+
+    LzmaMatchFinderType m_type;
+    u32 m_dictionary_size;
+    u16 m_nice_length;
+    u32 m_depth;
+    u16 m_max_lookahead_size;
+
+    // Keeps at least the dictionary in front of the current position, followed by the lookahead.
+    ByteBuffer m_buffer;
+    u64 m_buffer_position { 0 }; // The stream position of the start of m_buffer
+    u64 m_position { 0 };
+    u64 m_end_position { 0 };
+
+    // The next position that still has to be inserted into the search structures, which is ahead of the current
+    // position after looking at the next matches, and behind it while waiting for more data.
+    u64 m_search_position { 0 };
+
+    // Positions are stored in 32 bits, with 0 meaning "empty". Every stored position is at least as large as the
+    // cyclic size, so that empty entries are always out of reach, and they are moved down once they get close to
+    // overflowing.
+    u64 m_hashed_position_offset { 0 };
+    u32 m_cyclic_size { 0 };
+    u32 m_cyclic_position { 0 };
+
+    // The tables for 2, 3 and 4 bytes, back to back.
+    FixedArray<u32> m_hash_table;
+    u8 m_hash_4_bits { 0 };
+
+    // One entry per position in the dictionary for hash chains, or two for the children in a binary tree.
+    FixedArray<u32> m_son;
+
+    Array<CachedMatches, 2> m_cached_matches;
+};
+
+}
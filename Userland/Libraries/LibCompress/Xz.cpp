@@ -4,11 +4,18 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
+#include <AK/Atomic.h>
 #include <AK/ByteBuffer.h>
+#include <AK/Checked.h>
+#include <AK/Function.h>
 #include <AK/MemoryStream.h>
 #include <LibCompress/Lzma2.h>
 #include <LibCompress/Xz.h>
 #include <LibCrypto/Checksum/CRC32.h>
+#include <LibCrypto/Checksum/CRC64.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibThreading/Thread.h>
 
 namespace Compress {
 
@@ -44,6 +51,19 @@ ErrorOr<XzMultibyteInteger> XzMultibyteInteger::read_from_stream(Stream& stream)
     return XzMultibyteInteger { result };
 }
 
+ErrorOr<void> XzMultibyteInteger::write_to_stream(Stream& stream) const
+{
+    u64 remaining_value = m_value;
+
+    while (remaining_value >= 0x80) {
+        TRY(stream.write_value<u8>((remaining_value & 0x7F) | 0x80));
+        remaining_value >>= 7;
+    }
+
+    TRY(stream.write_value<u8>(remaining_value));
+    return {};
+}
+
 ErrorOr<void> XzStreamHeader::validate() const
 {
     // 2.1.1.1. Header Magic Bytes:
@@ -161,6 +181,14 @@ u32 XzFilterLzma2Properties::dictionary_size() const
     return dictionary_size;
 }
 
+XzFilterLzma2Properties XzFilterLzma2Properties::for_dictionary_size(u32 dictionary_size)
+{
+    XzFilterLzma2Properties properties {};
+    while (properties.encoded_dictionary_size < 40 && properties.dictionary_size() < dictionary_size)
+        properties.encoded_dictionary_size++;
+    return properties;
+}
+
 u32 XzFilterDeltaProperties::distance() const
 {
     // "The Properties byte indicates the delta distance, which can be
@@ -430,30 +458,11 @@ ErrorOr<bool> XzDecompressor::load_next_stream()
     return true;
 }
 
-ErrorOr<void> XzDecompressor::load_next_block(u8 encoded_block_header_size)
+// Parses a whole Block Header (including the Block Header Size byte) and wraps the Compressed Data into the filters it lists.
+static ErrorOr<MaybeOwned<Stream>> create_block_stream(ReadonlyBytes header, MaybeOwned<Stream> compressed_stream, Optional<u64>& expected_uncompressed_size)
 {
-    // We already read the encoded Block Header size (one byte) to determine that this is not an Index.
-    m_current_block_start_offset = m_stream->read_bytes() - 1;
-
-    // Ensure that the start of the block is aligned to a multiple of four (in theory, everything in XZ is).
-    VERIFY(m_current_block_start_offset % 4 == 0);
-
-    // 3.1.1. Block Header Size:
-    // "This field contains the size of the Block Header field,
-    //  including the Block Header Size field itself. Valid values are
-    //  in the range [0x01, 0xFF], which indicate the size of the Block
-    //  Header as multiples of four bytes, minimum size being eight
-    //  bytes:
-    //
-    //      real_header_size = (encoded_header_size + 1) * 4;"
-    u64 const block_header_size = (encoded_block_header_size + 1) * 4;
-
-    // Read the whole header into a buffer to allow calculating the CRC32 later (3.1.7. CRC32).
-    auto header = TRY(ByteBuffer::create_uninitialized(block_header_size));
-    header[0] = encoded_block_header_size;
-    TRY(m_stream->read_until_filled(header.span().slice(1)));
-
-    FixedMemoryStream header_stream { header.span().slice(1) };
+    auto const block_header_size = header.size();
+    FixedMemoryStream header_stream { header.slice(1) };
 
     // 3.1.2. Block Flags:
     // "If any reserved bit is set, the decoder MUST indicate an error.
@@ -465,7 +474,7 @@ ErrorOr<void> XzDecompressor::load_next_block(u8 encoded_block_header_size)
     if (flags.reserved != 0)
         return Error::from_string_literal("XZ block header has reserved non-null block flag bits");
 
-    MaybeOwned<Stream> new_block_stream { *m_stream };
+    MaybeOwned<Stream> new_block_stream = move(compressed_stream);
 
     // 3.1.3. Compressed Size:
     // "This field is present only if the appropriate bit is set in
@@ -489,9 +498,9 @@ ErrorOr<void> XzDecompressor::load_next_block(u8 encoded_block_header_size)
         // "Uncompressed Size is stored using the encoding described in Section 1.2."
         u64 const uncompressed_size = TRY(header_stream.read_value<XzMultibyteInteger>());
 
-        m_current_block_expected_uncompressed_size = uncompressed_size;
+        expected_uncompressed_size = uncompressed_size;
     } else {
-        m_current_block_expected_uncompressed_size.clear();
+        expected_uncompressed_size.clear();
     }
 
     // We need to process the filters in reverse order, since they are listed in the order that they have been applied in.
@@ -590,7 +599,7 @@ ErrorOr<void> XzDecompressor::load_next_block(u8 encoded_block_header_size)
     // 3.1.7. CRC32:
     // "The CRC32 is calculated over everything in the Block Header
     //  field except the CRC32 field itself.
-    Crypto::Checksum::CRC32 calculated_header_crc32 { header.span().trim(block_header_size - size_of_crc32) };
+    Crypto::Checksum::CRC32 calculated_header_crc32 { header.trim(block_header_size - size_of_crc32) };
     //  It is stored as an unsigned 32-bit little endian integer.
     u32 const stored_header_crc32 = TRY(header_stream.read_value<LittleEndian<u32>>());
     //  If the calculated value does not match the stored one, the decoder MUST indicate
@@ -598,7 +607,33 @@ ErrorOr<void> XzDecompressor::load_next_block(u8 encoded_block_header_size)
     if (calculated_header_crc32.digest() != stored_header_crc32)
         return Error::from_string_literal("Stored XZ block header CRC32 does not match the stored CRC32");
 
-    m_current_block_stream = move(new_block_stream);
+    return new_block_stream;
+}
+
+ErrorOr<void> XzDecompressor::load_next_block(u8 encoded_block_header_size)
+{
+    // We already read the encoded Block Header size (one byte) to determine that this is not an Index.
+    m_current_block_start_offset = m_stream->read_bytes() - 1;
+
+    // Ensure that the start of the block is aligned to a multiple of four (in theory, everything in XZ is).
+    VERIFY(m_current_block_start_offset % 4 == 0);
+
+    // 3.1.1. Block Header Size:
+    // "This field contains the size of the Block Header field,
+    //  including the Block Header Size field itself. Valid values are
+    //  in the range [0x01, 0xFF], which indicate the size of the Block
+    //  Header as multiples of four bytes, minimum size being eight
+    //  bytes:
+    //
+    //      real_header_size = (encoded_header_size + 1) * 4;"
+    u64 const block_header_size = (encoded_block_header_size + 1) * 4;
+
+    // Read the whole header into a buffer to allow calculating the CRC32 later (3.1.7. CRC32).
+    auto header = TRY(ByteBuffer::create_uninitialized(block_header_size));
+    header[0] = encoded_block_header_size;
+    TRY(m_stream->read_until_filled(header.span().slice(1)));
+
+    m_current_block_stream = TRY(create_block_stream(header, MaybeOwned<Stream> { *m_stream }, m_current_block_expected_uncompressed_size));
     m_current_block_uncompressed_size = 0;
 
     return {};
@@ -780,6 +815,7 @@ ErrorOr<Bytes> XzDecompressor::read_some(Bytes bytes)
             // Another XZ Stream might follow, so we just unset the current information and continue on the next read.
             m_stream_flags.clear();
             m_processed_blocks.clear();
+            m_current_block_stream.clear();
             return bytes.trim(0);
         }
 
@@ -812,4 +848,645 @@ void XzDecompressor::close()
 {
 }
 
+// Runs the task for every index below task_count, on up to thread_count threads.
+static void run_in_parallel(size_t task_count, size_t thread_count, Function<void(size_t)> const& task)
+{
+    Atomic<size_t> next_task_index { 0 };
+    auto run_remaining_tasks = [&]() -> intptr_t {
+        for (auto index = next_task_index.fetch_add(1); index < task_count; index = next_task_index.fetch_add(1))
+            task(index);
+        return 0;
+    };
+
+    // The calling thread takes part in the work as well, and simply does more of it if we fail to create a thread.
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    for (size_t i = 1; i < min(thread_count, task_count); ++i) {
+        auto thread_or_error = Threading::Thread::try_create([&] { return run_remaining_tasks(); }, "XZ"sv);
+        if (thread_or_error.is_error() || threads.try_append(thread_or_error.value()).is_error())
+            break;
+        threads.last()->start();
+    }
+
+    run_remaining_tasks();
+    for (auto& thread : threads)
+        (void)thread->join();
+}
+
+ErrorOr<NonnullOwnPtr<XzParallelDecompressor>> XzParallelDecompressor::create(ReadonlyBytes bytes, size_t thread_count)
+{
+    auto blocks = TRY(find_blocks(bytes));
+
+    u64 uncompressed_offset = 0;
+    for (auto& block : blocks) {
+        block.uncompressed_offset = uncompressed_offset;
+        if (Checked<u64>::addition_would_overflow(uncompressed_offset, block.uncompressed_size))
+            return Error::from_string_literal("XZ file is too large");
+        uncompressed_offset += block.uncompressed_size;
+    }
+
+    auto decompressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) XzParallelDecompressor(move(blocks), max(thread_count, static_cast<size_t>(1)))));
+    return decompressor;
+}
+
+XzParallelDecompressor::XzParallelDecompressor(Vector<Block> blocks, size_t thread_count)
+    : m_blocks(move(blocks))
+    , m_thread_count(thread_count)
+{
+}
+
+ErrorOr<Vector<XzParallelDecompressor::Block>> XzParallelDecompressor::find_blocks(ReadonlyBytes bytes)
+{
+    // 2.1. Stream:
+    // "Stream Header and Stream Footer contain the same Stream Flags, and the Index stores the sizes of all Blocks.
+    //  [...] This makes it possible to parse the Stream backwards", which is the only way to find the Blocks of
+    // a Stream without decompressing all of them in order.
+    Vector<Block> blocks;
+
+    if (bytes.is_empty())
+        return Error::from_string_literal("XZ file does not contain any streams");
+
+    size_t end_of_stream = bytes.size();
+    while (end_of_stream > 0) {
+        // 2.2. Stream Padding:
+        // "To preserve the four-byte alignment of consecutive Streams, the size of Stream Padding MUST be a multiple
+        //  of four bytes." Stream Footers end with non-null magic bytes, so nulls can't be part of one.
+        if (end_of_stream % 4 != 0)
+            return Error::from_string_literal("XZ Stream Padding is not aligned to 4 bytes");
+
+        while (end_of_stream >= 4 && all_of(bytes.slice(end_of_stream - 4, 4), [](u8 byte) { return byte == 0; }))
+            end_of_stream -= 4;
+
+        if (end_of_stream == 0)
+            return Error::from_string_literal("XZ file starts with Stream Padding");
+
+        if (end_of_stream < sizeof(XzStreamHeader) + sizeof(XzStreamFooter))
+            return Error::from_string_literal("XZ stream is too small to contain a header and a footer");
+
+        XzStreamFooter stream_footer {};
+        bytes.slice(end_of_stream - sizeof(XzStreamFooter), sizeof(XzStreamFooter)).copy_to({ &stream_footer, sizeof(stream_footer) });
+        TRY(stream_footer.validate());
+
+        auto const size_of_index = stream_footer.backward_size();
+        if (size_of_index > end_of_stream - sizeof(XzStreamHeader) - sizeof(XzStreamFooter))
+            return Error::from_string_literal("XZ index size in the stream footer is larger than the stream");
+
+        auto const start_of_index = end_of_stream - sizeof(XzStreamFooter) - size_of_index;
+        auto const index = bytes.slice(start_of_index, size_of_index);
+
+        // 4.5. CRC32:
+        // "The CRC32 is calculated over everything in the Index field except the CRC32 field itself."
+        LittleEndian<u32> stored_index_crc32;
+        index.slice(size_of_index - sizeof(stored_index_crc32)).copy_to({ &stored_index_crc32, sizeof(stored_index_crc32) });
+        if (Crypto::Checksum::CRC32 { index.trim(size_of_index - sizeof(stored_index_crc32)) }.digest() != stored_index_crc32)
+            return Error::from_string_literal("XZ index has an invalid CRC32 checksum");
+
+        FixedMemoryStream index_stream { index.trim(size_of_index - sizeof(stored_index_crc32)) };
+
+        // 4.1. Index Indicator:
+        // "The first byte of the Index is always 0x00."
+        if (TRY(index_stream.read_value<u8>()) != 0x00)
+            return Error::from_string_literal("XZ index does not start with an Index Indicator");
+
+        struct Record {
+            u64 unpadded_size;
+            u64 uncompressed_size;
+        };
+        Vector<Record> records;
+        u64 size_of_blocks = 0;
+
+        u64 const number_of_records = TRY(index_stream.read_value<XzMultibyteInteger>());
+        for (u64 i = 0; i < number_of_records; i++) {
+            u64 const unpadded_size = TRY(index_stream.read_value<XzMultibyteInteger>());
+            u64 const uncompressed_size = TRY(index_stream.read_value<XzMultibyteInteger>());
+
+            if (unpadded_size < 5)
+                return Error::from_string_literal("XZ index contains a record with an unpadded size of less than five");
+
+            size_of_blocks += align_up_to(unpadded_size, 4);
+            if (size_of_blocks > start_of_index - sizeof(XzStreamHeader))
+                return Error::from_string_literal("XZ index describes more blocks than fit into the stream");
+
+            TRY(records.try_append({ unpadded_size, uncompressed_size }));
+        }
+
+        // 4.4. Index Padding
+        while (MUST(index_stream.tell()) % 4 != 0) {
+            if (TRY(index_stream.read_value<u8>()) != 0)
+                return Error::from_string_literal("XZ index contains a non-null padding byte");
+        }
+
+        if (!index_stream.is_eof())
+            return Error::from_string_literal("XZ index size does not match the stored size in the stream footer");
+
+        auto const start_of_stream = start_of_index - size_of_blocks - sizeof(XzStreamHeader);
+
+        XzStreamHeader stream_header {};
+        bytes.slice(start_of_stream, sizeof(XzStreamHeader)).copy_to({ &stream_header, sizeof(stream_header) });
+        TRY(stream_header.validate());
+
+        // 2.1.2.3. Stream Flags:
+        // "The decoder MUST compare the Stream Flags fields in both Stream Header and Stream Footer, and indicate
+        //  an error if they are not identical."
+        if (ReadonlyBytes { &stream_header.flags, sizeof(XzStreamFlags) } != ReadonlyBytes { &stream_footer.flags, sizeof(XzStreamFlags) })
+            return Error::from_string_literal("XZ stream header flags don't match the stream footer");
+
+        if (!size_for_check_type(stream_header.flags.check_type).has_value())
+            return Error::from_string_literal("XZ stream has an unknown check type");
+
+        Vector<Block> stream_blocks;
+        TRY(stream_blocks.try_ensure_capacity(records.size()));
+
+        auto start_of_block = start_of_stream + sizeof(XzStreamHeader);
+        for (auto const& record : records) {
+            auto const padded_size = align_up_to(record.unpadded_size, 4);
+            stream_blocks.unchecked_append({
+                .data = bytes.slice(start_of_block, padded_size),
+                .unpadded_size = record.unpadded_size,
+                .check_type = stream_header.flags.check_type,
+                .uncompressed_size = record.uncompressed_size,
+            });
+            start_of_block += padded_size;
+        }
+
+        TRY(blocks.try_prepend(move(stream_blocks)));
+        end_of_stream = start_of_stream;
+    }
+
+    return blocks;
+}
+
+// The output of a Block starts out at this size and then at most doubles with every read.
+static constexpr size_t minimum_block_output_chunk_size = 64 * KiB;
+
+ErrorOr<ByteBuffer> XzParallelDecompressor::decompress_block(Block const& block)
+{
+    auto const check_size = size_for_check_type(block.check_type).value();
+
+    // 3.1.1. Block Header Size:
+    // "real_header_size = (encoded_header_size + 1) * 4;"
+    // The Index Indicator can't show up here, since the Index told us where the Blocks are.
+    if (block.data[0] == 0x00)
+        return Error::from_string_literal("XZ index points to an Index instead of a block");
+
+    size_t const block_header_size = (block.data[0] + 1) * 4;
+    if (block_header_size + check_size >= block.unpadded_size)
+        return Error::from_string_literal("XZ block is too small for its header and check");
+
+    auto const header = block.data.trim(block_header_size);
+    auto const compressed_data = block.data.slice(block_header_size, block.unpadded_size - block_header_size - check_size);
+    auto const padding = block.data.slice(block.unpadded_size - check_size, block.data.size() - block.unpadded_size);
+    auto const check = block.data.slice(block.data.size() - check_size);
+
+    // 3.3. Block Padding:
+    // "If any of the bytes in Block Padding are not null bytes, the decoder MUST indicate an error."
+    if (!all_of(padding, [](u8 byte) { return byte == 0; }))
+        return Error::from_string_literal("XZ block contains a non-null padding byte");
+
+    FixedMemoryStream compressed_stream { compressed_data };
+    Optional<u64> expected_uncompressed_size;
+    auto block_stream = TRY(create_block_stream(header, MaybeOwned<Stream> { compressed_stream }, expected_uncompressed_size));
+
+    if (expected_uncompressed_size.has_value() && *expected_uncompressed_size != block.uncompressed_size)
+        return Error::from_string_literal("Uncompressed size of XZ Block does not match the Index");
+
+    // The Index is only covered by its own CRC32, so a tiny file can claim an arbitrarily large Block. Grow the
+    // output along with the data that actually comes out of the Block instead of allocating all of it up front.
+    ByteBuffer output;
+    while (output.size() < block.uncompressed_size) {
+        auto const previous_size = output.size();
+        auto const chunk_size = static_cast<size_t>(min<u64>(block.uncompressed_size - previous_size, max(previous_size, minimum_block_output_chunk_size)));
+        auto const chunk = TRY(output.get_bytes_for_writing(chunk_size));
+        auto const read_bytes = TRY(block_stream->read_some(chunk));
+        if (read_bytes.is_empty())
+            return Error::from_string_literal("Size of XZ Block does not match the Index");
+        output.resize(previous_size + read_bytes.size());
+    }
+
+    // The block has to end exactly where the Index says it does, both before and after decompression.
+    u8 trailing_byte { 0 };
+    if (!TRY(block_stream->read_some({ &trailing_byte, sizeof(trailing_byte) })).is_empty() || !block_stream->is_eof() || !compressed_stream.is_eof())
+        return Error::from_string_literal("Size of XZ Block does not match the Index");
+
+    // 3.4. Check:
+    // "The Check, when used, is calculated from the original uncompressed data. If the calculated Check does not
+    //  match the stored one, the decoder MUST indicate an error."
+    switch (block.check_type) {
+    case XzStreamCheckType::None:
+        break;
+    case XzStreamCheckType::CRC32: {
+        LittleEndian<u32> stored_crc32;
+        check.copy_to({ &stored_crc32, sizeof(stored_crc32) });
+        if (Crypto::Checksum::CRC32 { output }.digest() != stored_crc32)
+            return Error::from_string_literal("XZ block has an invalid CRC32 checksum");
+        break;
+    }
+    case XzStreamCheckType::CRC64: {
+        LittleEndian<u64> stored_crc64;
+        check.copy_to({ &stored_crc64, sizeof(stored_crc64) });
+        if (Crypto::Checksum::CRC64 { output }.digest() != stored_crc64)
+            return Error::from_string_literal("XZ block has an invalid CRC64 checksum");
+        break;
+    }
+    case XzStreamCheckType::SHA256: {
+        auto const digest = Crypto::Hash::SHA256::hash(output);
+        if (digest.bytes() != check)
+            return Error::from_string_literal("XZ block has an invalid SHA-256 checksum");
+        break;
+    }
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    return output;
+}
+
+ErrorOr<void> XzParallelDecompressor::decompress_next_batch()
+{
+    struct BatchEntry {
+        ByteBuffer output;
+        Optional<Error> error;
+    };
+
+    auto const batch_size = min(m_thread_count, m_blocks.size() - m_next_block_index);
+    Vector<BatchEntry> batch;
+    TRY(batch.try_resize(batch_size));
+
+    run_in_parallel(batch_size, m_thread_count, [&](size_t index) {
+        auto result = decompress_block(m_blocks[m_next_block_index + index]);
+        if (result.is_error())
+            batch[index].error = result.release_error();
+        else
+            batch[index].output = result.release_value();
+    });
+
+    m_current_batch.clear();
+    TRY(m_current_batch.try_ensure_capacity(batch_size));
+    for (auto& entry : batch) {
+        if (entry.error.has_value())
+            return entry.error.release_value();
+        m_current_batch.unchecked_append(move(entry.output));
+    }
+
+    m_next_block_index += batch_size;
+    m_current_batch_index = 0;
+    m_current_batch_offset = m_next_batch_offset;
+    m_next_batch_offset = 0;
+    return {};
+}
+
+ErrorOr<Bytes> XzParallelDecompressor::read_some(Bytes bytes)
+{
+    while (true) {
+        while (m_current_batch_index < m_current_batch.size() && m_current_batch_offset == m_current_batch[m_current_batch_index].size()) {
+            m_current_batch_index++;
+            m_current_batch_offset = 0;
+        }
+
+        if (m_current_batch_index < m_current_batch.size())
+            break;
+
+        if (m_next_block_index == m_blocks.size())
+            return bytes.trim(0);
+
+        TRY(decompress_next_batch());
+    }
+
+    auto const& current_block = m_current_batch[m_current_batch_index];
+    auto const copied_size = current_block.bytes().slice(m_current_batch_offset).copy_trimmed_to(bytes);
+    m_current_batch_offset += copied_size;
+    return bytes.trim(copied_size);
+}
+
+ErrorOr<size_t> XzParallelDecompressor::write_some(ReadonlyBytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+bool XzParallelDecompressor::is_eof() const
+{
+    if (m_next_block_index < m_blocks.size())
+        return false;
+
+    for (size_t i = m_current_batch_index; i < m_current_batch.size(); i++) {
+        auto const consumed_size = i == m_current_batch_index ? m_current_batch_offset : 0;
+        if (m_current_batch[i].size() > consumed_size)
+            return false;
+    }
+
+    return true;
+}
+
+bool XzParallelDecompressor::is_open() const
+{
+    return true;
+}
+
+void XzParallelDecompressor::close()
+{
+}
+
+ErrorOr<size_t> XzParallelDecompressor::seek(i64 offset, SeekMode mode)
+{
+    auto const total_size = TRY(size());
+
+    i64 target;
+    switch (mode) {
+    case SeekMode::SetPosition:
+        target = offset;
+        break;
+    case SeekMode::FromCurrentPosition:
+        target = static_cast<i64>(TRY(tell())) + offset;
+        break;
+    case SeekMode::FromEndPosition:
+        target = static_cast<i64>(total_size) + offset;
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    if (target < 0 || static_cast<u64>(target) > total_size)
+        return Error::from_errno(EINVAL);
+
+    // Find the last non-empty Block that starts at or before the target, or the end of the file.
+    auto const position = static_cast<u64>(target);
+    size_t block_index = m_blocks.size();
+    for (size_t low = 0, high = m_blocks.size(); low < high;) {
+        auto middle = low + (high - low) / 2;
+        if (m_blocks[middle].uncompressed_offset + m_blocks[middle].uncompressed_size <= position) {
+            low = middle + 1;
+        } else {
+            block_index = middle;
+            high = middle;
+        }
+    }
+
+    // Stay within the current batch if it already contains the target, and only decompress again otherwise.
+    auto const current_batch_start = m_next_block_index - m_current_batch.size();
+    if (block_index >= current_batch_start && block_index < m_next_block_index) {
+        m_current_batch_index = block_index - current_batch_start;
+        m_current_batch_offset = position - m_blocks[block_index].uncompressed_offset;
+        m_next_batch_offset = 0;
+        return position;
+    }
+
+    m_current_batch.clear();
+    m_current_batch_index = 0;
+    m_current_batch_offset = 0;
+    m_next_block_index = block_index;
+    m_next_batch_offset = block_index < m_blocks.size() ? position - m_blocks[block_index].uncompressed_offset : 0;
+    return position;
+}
+
+ErrorOr<void> XzParallelDecompressor::truncate(size_t)
+{
+    return Error::from_errno(EBADF);
+}
+
+ErrorOr<size_t> XzParallelDecompressor::tell() const
+{
+    auto const current_batch_start = m_next_block_index - m_current_batch.size();
+    if (m_current_batch_index < m_current_batch.size())
+        return m_blocks[current_batch_start + m_current_batch_index].uncompressed_offset + m_current_batch_offset;
+
+    if (m_next_block_index < m_blocks.size())
+        return m_blocks[m_next_block_index].uncompressed_offset + m_next_batch_offset;
+
+    if (m_blocks.is_empty())
+        return 0;
+    return m_blocks.last().uncompressed_offset + m_blocks.last().uncompressed_size;
+}
+
+ErrorOr<size_t> XzParallelDecompressor::size()
+{
+    if (m_blocks.is_empty())
+        return 0;
+    return m_blocks.last().uncompressed_offset + m_blocks.last().uncompressed_size;
+}
+
+static constexpr XzStreamFlags compressor_stream_flags {
+    .reserved = 0,
+    .check_type = XzStreamCheckType::CRC32,
+    .reserved_bits = 0,
+};
+
+ErrorOr<NonnullOwnPtr<XzCompressor>> XzCompressor::create(MaybeOwned<Stream> stream, XzCompressorOptions const& options)
+{
+    if (options.block_size == 0)
+        return Error::from_string_literal("XZ block size must not be zero");
+
+    // 2.1.1. Stream Header
+    XzStreamHeader stream_header {
+        .magic = { 0xFD, '7', 'z', 'X', 'Z', 0x00 },
+        .flags = compressor_stream_flags,
+        .flags_crc32 = Crypto::Checksum::CRC32({ &compressor_stream_flags, sizeof(compressor_stream_flags) }).digest(),
+    };
+    TRY(stream->write_value(stream_header));
+
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) XzCompressor(move(stream), options)));
+    return compressor;
+}
+
+ErrorOr<ByteBuffer> XzCompressor::compress_all(ReadonlyBytes bytes, XzCompressorOptions const& options)
+{
+    AllocatingMemoryStream output_stream;
+
+    auto compressor = TRY(XzCompressor::create(MaybeOwned<Stream> { output_stream }, options));
+    TRY(compressor->write_until_depleted(bytes));
+    TRY(compressor->finish());
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+    TRY(output_stream.read_until_filled(buffer));
+    return buffer;
+}
+
+XzCompressor::XzCompressor(MaybeOwned<Stream> stream, XzCompressorOptions options)
+    : m_stream(move(stream))
+    , m_options(move(options))
+{
+    m_options.thread_count = max(m_options.thread_count, static_cast<size_t>(1));
+}
+
+XzCompressor::~XzCompressor()
+{
+    if (!m_has_finished) {
+        // Note: We need a better API for specifying things like this.
+        finish().release_value_but_fixme_should_propagate_errors();
+    }
+}
+
+ErrorOr<XzCompressor::CompressedBlock> XzCompressor::compress_block(ReadonlyBytes bytes, LzmaCompressorOptions const& lzma_options)
+{
+    // There is no point in a dictionary that is larger than the data, which saves a lot of memory for small blocks.
+    auto const lzma2_properties = XzFilterLzma2Properties::for_dictionary_size(min(static_cast<u64>(lzma_options.dictionary_size), bytes.size()));
+    auto block_lzma_options = lzma_options;
+    block_lzma_options.dictionary_size = lzma2_properties.dictionary_size();
+
+    AllocatingMemoryStream compressed_stream;
+    {
+        auto lzma2_compressor = TRY(Lzma2Compressor::create_raw_stream(MaybeOwned<Stream> { compressed_stream }, block_lzma_options));
+        TRY(lzma2_compressor->write_until_depleted(bytes));
+        TRY(lzma2_compressor->flush());
+    }
+    auto const compressed_size = compressed_stream.used_buffer_size();
+
+    // 3.1. Block Header
+    AllocatingMemoryStream header_stream;
+    TRY(header_stream.write_value<u8>(0)); // Block Header Size, filled in below.
+    TRY(header_stream.write_value(XzBlockFlags {
+        .encoded_number_of_filters = 0,
+        .reserved = 0,
+        .compressed_size_present = true,
+        .uncompressed_size_present = true,
+    }));
+    TRY(header_stream.write_value(XzMultibyteInteger { compressed_size }));
+    TRY(header_stream.write_value(XzMultibyteInteger { bytes.size() }));
+
+    // 3.1.5. List of Filter Flags, containing only 5.3.1. LZMA2
+    TRY(header_stream.write_value(XzMultibyteInteger { 0x21 }));
+    TRY(header_stream.write_value(XzMultibyteInteger { sizeof(lzma2_properties) }));
+    TRY(header_stream.write_until_depleted({ &lzma2_properties, sizeof(lzma2_properties) }));
+
+    // 3.1.6. Header Padding
+    constexpr size_t size_of_crc32 = 4;
+    while ((header_stream.used_buffer_size() + size_of_crc32) % 4 != 0)
+        TRY(header_stream.write_value<u8>(0));
+
+    auto const block_header_size = header_stream.used_buffer_size() + size_of_crc32;
+    auto const unpadded_size = block_header_size + compressed_size + size_of_crc32;
+    auto block = TRY(ByteBuffer::create_zeroed(align_up_to(unpadded_size - size_of_crc32, 4) + size_of_crc32));
+    auto block_bytes = block.bytes();
+
+    // 3.1.1. Block Header Size: "real_header_size = (encoded_header_size + 1) * 4;"
+    TRY(header_stream.read_until_filled(block_bytes.trim(block_header_size - size_of_crc32)));
+    block_bytes[0] = block_header_size / 4 - 1;
+
+    // 3.1.7. CRC32
+    LittleEndian<u32> const header_crc32 = Crypto::Checksum::CRC32 { block_bytes.trim(block_header_size - size_of_crc32) }.digest();
+    ReadonlyBytes { &header_crc32, sizeof(header_crc32) }.copy_to(block_bytes.slice(block_header_size - size_of_crc32));
+
+    // 3.2. Compressed Data
+    TRY(compressed_stream.read_until_filled(block_bytes.slice(block_header_size, compressed_size)));
+
+    // 3.3. Block Padding is already zeroed, and 3.4. Check follows it.
+    LittleEndian<u32> const check = Crypto::Checksum::CRC32 { bytes }.digest();
+    ReadonlyBytes { &check, sizeof(check) }.copy_to(block_bytes.slice(block_bytes.size() - size_of_crc32));
+
+    return CompressedBlock { move(block), unpadded_size };
+}
+
+ErrorOr<void> XzCompressor::compress_buffered_blocks()
+{
+    struct BatchEntry {
+        ReadonlyBytes input;
+        CompressedBlock output;
+        Optional<Error> error;
+    };
+
+    Vector<BatchEntry> batch;
+    for (size_t offset = 0; offset < m_input_buffer.size(); offset += m_options.block_size)
+        TRY(batch.try_append({ m_input_buffer.bytes().slice(offset, min(m_options.block_size, m_input_buffer.size() - offset)), {}, {} }));
+
+    auto lzma_options = LzmaCompressorOptions::for_preset(m_options.preset);
+    if (m_options.dictionary_size.has_value())
+        lzma_options.dictionary_size = m_options.dictionary_size.value();
+
+    run_in_parallel(batch.size(), m_options.thread_count, [&](size_t index) {
+        auto result = compress_block(batch[index].input, lzma_options);
+        if (result.is_error())
+            batch[index].error = result.release_error();
+        else
+            batch[index].output = result.release_value();
+    });
+
+    for (auto& entry : batch) {
+        if (entry.error.has_value())
+            return entry.error.release_value();
+
+        TRY(m_stream->write_until_depleted(entry.output.data));
+        TRY(m_written_blocks.try_append({
+            .uncompressed_size = entry.input.size(),
+            .unpadded_size = entry.output.unpadded_size,
+        }));
+    }
+
+    // Shrinking the buffer keeps its capacity around for the next batch.
+    m_input_buffer.resize(0);
+    return {};
+}
+
+ErrorOr<void> XzCompressor::finish()
+{
+    if (m_has_finished)
+        return Error::from_string_literal("Finished an XZ stream twice");
+
+    if (!m_input_buffer.is_empty())
+        TRY(compress_buffered_blocks());
+
+    // 4. Index
+    AllocatingMemoryStream index_stream;
+    TRY(index_stream.write_value<u8>(0x00));
+    TRY(index_stream.write_value(XzMultibyteInteger { m_written_blocks.size() }));
+    for (auto const& block : m_written_blocks) {
+        TRY(index_stream.write_value(XzMultibyteInteger { block.unpadded_size }));
+        TRY(index_stream.write_value(XzMultibyteInteger { block.uncompressed_size }));
+    }
+    while (index_stream.used_buffer_size() % 4 != 0)
+        TRY(index_stream.write_value<u8>(0));
+
+    auto index = TRY(ByteBuffer::create_uninitialized(index_stream.used_buffer_size()));
+    TRY(index_stream.read_until_filled(index));
+    TRY(m_stream->write_until_depleted(index));
+    TRY(m_stream->write_value<LittleEndian<u32>>(Crypto::Checksum::CRC32 { index }.digest()));
+
+    // 2.1.2. Stream Footer
+    XzStreamFooter stream_footer {
+        .size_and_flags_crc32 = 0,
+        .encoded_backward_size = static_cast<u32>((index.size() + sizeof(u32)) / 4 - 1),
+        .flags = compressor_stream_flags,
+        .magic = { 'Y', 'Z' },
+    };
+    Crypto::Checksum::CRC32 footer_crc32;
+    footer_crc32.update({ &stream_footer.encoded_backward_size, sizeof(stream_footer.encoded_backward_size) });
+    footer_crc32.update({ &stream_footer.flags, sizeof(stream_footer.flags) });
+    stream_footer.size_and_flags_crc32 = footer_crc32.digest();
+    TRY(m_stream->write_value(stream_footer));
+
+    m_has_finished = true;
+    return {};
+}
+
+ErrorOr<Bytes> XzCompressor::read_some(Bytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+ErrorOr<size_t> XzCompressor::write_some(ReadonlyBytes bytes)
+{
+    if (m_has_finished)
+        return Error::from_string_literal("Tried to write to a finished XZ stream");
+
+    auto const batch_size = m_options.block_size * m_options.thread_count;
+    auto const buffered_size = min(bytes.size(), batch_size - m_input_buffer.size());
+    TRY(m_input_buffer.try_append(bytes.trim(buffered_size)));
+
+    if (m_input_buffer.size() == batch_size)
+        TRY(compress_buffered_blocks());
+
+    return buffered_size;
+}
+
+bool XzCompressor::is_eof() const
+{
+    return true;
+}
+
+bool XzCompressor::is_open() const
+{
+    return !m_has_finished;
+}
+
+void XzCompressor::close()
+{
+}
+
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <AK/CircularBuffer.h>
 #include <AK/ConstrainedStream.h>
 #include <AK/CountingStream.h>
@@ -16,6 +17,7 @@
 #include <AK/OwnPtr.h>
 #include <AK/Stream.h>
 #include <AK/Vector.h>
+#include <LibCompress/Lzma.h>
 
 namespace Compress {
 
@@ -35,6 +37,7 @@ public:
     constexpr operator u64() const { return m_value; }
 
     static ErrorOr<XzMultibyteInteger> read_from_stream(Stream& stream);
+    ErrorOr<void> write_to_stream(Stream& stream) const;
 
 private:
     u64 m_value { 0 };
@@ -96,6 +99,9 @@ struct [[gnu::packed]] XzFilterLzma2Properties {
 
     ErrorOr<void> validate() const;
     u32 dictionary_size() const;
+
+    // Returns the properties for the smallest dictionary size that is at least as large as the given one.
+    static XzFilterLzma2Properties for_dictionary_size(u32);
 };
 static_assert(sizeof(XzFilterLzma2Properties) == 1);
 
@@ -187,6 +193,106 @@ private:
     Vector<BlockMetadata> m_processed_blocks;
 };
 
+// Decompresses an XZ file that is entirely in memory. The Index at the end of every Stream tells where each Block
+// starts and how large its contents are, so batches of Blocks are decompressed on up to thread_count threads at once.
+// Files with only a single Block (which XZ utils writes unless it is running multi-threaded) gain nothing from this.
+// The same information makes the decompressed data seekable: seeking only decompresses the Blocks that are read from.
+class XzParallelDecompressor : public SeekableStream {
+public:
+    static ErrorOr<NonnullOwnPtr<XzParallelDecompressor>> create(ReadonlyBytes, size_t thread_count);
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+
+    virtual ErrorOr<size_t> seek(i64 offset, SeekMode) override;
+    virtual ErrorOr<void> truncate(size_t) override;
+    virtual ErrorOr<size_t> tell() const override;
+    virtual ErrorOr<size_t> size() override;
+
+private:
+    struct Block {
+        // This includes the Block Padding, which sits between the Compressed Data and the Check.
+        ReadonlyBytes data;
+        u64 unpadded_size {};
+        XzStreamCheckType check_type {};
+        u64 uncompressed_size {};
+        u64 uncompressed_offset {};
+    };
+
+    XzParallelDecompressor(Vector<Block>, size_t thread_count);
+
+    static ErrorOr<Vector<Block>> find_blocks(ReadonlyBytes);
+    static ErrorOr<ByteBuffer> decompress_block(Block const&);
+    ErrorOr<void> decompress_next_batch();
+
+    Vector<Block> m_blocks;
+    size_t m_thread_count { 1 };
+    size_t m_next_block_index { 0 };
+
+    Vector<ByteBuffer> m_current_batch;
+    size_t m_current_batch_index { 0 };
+    size_t m_current_batch_offset { 0 };
+
+    // Where to start reading in the first Block of the next batch, after seeking past the current batch.
+    size_t m_next_batch_offset { 0 };
+};
+
+struct XzCompressorOptions {
+    // The preset picks the match finder settings, and the dictionary size unless one is given.
+    u8 preset { LzmaCompressorOptions::default_preset };
+    Optional<u32> dictionary_size {};
+
+    // Blocks are compressed independently of each other, which is what allows them to be compressed and decompressed
+    // in parallel. Smaller blocks scale better, but every block starts with an empty dictionary.
+    size_t block_size { 3 * 8 * MiB };
+
+    size_t thread_count { 1 };
+};
+
+class XzCompressor : public Stream {
+public:
+    static ErrorOr<NonnullOwnPtr<XzCompressor>> create(MaybeOwned<Stream>, XzCompressorOptions const& = {});
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes, XzCompressorOptions const& = {});
+
+    /// Compresses the remaining data and writes the Index and the Stream Footer.
+    ErrorOr<void> finish();
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+
+    virtual ~XzCompressor();
+
+private:
+    XzCompressor(MaybeOwned<Stream>, XzCompressorOptions);
+
+    struct CompressedBlock {
+        ByteBuffer data;
+        u64 unpadded_size {};
+    };
+
+    ErrorOr<void> compress_buffered_blocks();
+    static ErrorOr<CompressedBlock> compress_block(ReadonlyBytes, LzmaCompressorOptions const&);
+
+    MaybeOwned<Stream> m_stream;
+    XzCompressorOptions m_options;
+    bool m_has_finished { false };
+
+    // Input is collected until there is a block for every thread.
+    ByteBuffer m_input_buffer;
+
+    struct BlockMetadata {
+        u64 uncompressed_size {};
+        u64 unpadded_size {};
+    };
+    Vector<BlockMetadata> m_written_blocks;
+};
+
 }
 
 template<>
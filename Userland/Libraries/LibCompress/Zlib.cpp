@@ -73,7 +73,7 @@ ErrorOr<NonnullOwnPtr<ZlibCompressor>> ZlibCompressor::construct(MaybeOwned<Stre
     auto compressor_stream = TRY(DeflateCompressor::construct(MaybeOwned(*stream), static_cast<DeflateCompressor::CompressionLevel>(compression_level)));
 
     auto zlib_compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) ZlibCompressor(move(stream), move(compressor_stream))));
-    TRY(zlib_compressor->write_header(compression_method, compression_level));
+    TRY(write_header(*zlib_compressor->m_output_stream, compression_method, compression_level));
 
     return zlib_compressor;
 }
@@ -89,7 +89,7 @@ ZlibCompressor::~ZlibCompressor()
     VERIFY(m_finished);
 }
 
-ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
+ErrorOr<void> ZlibCompressor::write_header(Stream& stream, ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
 {
     u8 compression_info = 0;
     if (compression_method == ZlibCompressionMethod::Deflate) {
@@ -108,7 +108,7 @@ ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_met
 
     // FIXME: Support pre-defined dictionaries.
 
-    TRY(m_output_stream->write_value(header.as_u16));
+    TRY(stream.write_value(header.as_u16));
 
     return {};
 }
@@ -156,8 +156,11 @@ ErrorOr<void> ZlibCompressor::finish()
     return {};
 }
 
-ErrorOr<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, ZlibCompressionLevel compression_level)
+ErrorOr<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, ZlibCompressionLevel compression_level, size_t thread_count)
 {
+    if (thread_count > 1)
+        return compress_all_in_parallel(bytes, compression_level, thread_count);
+
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
     auto zlib_stream = TRY(ZlibCompressor::construct(MaybeOwned<Stream>(*output_stream), compression_level));
 
@@ -171,4 +174,33 @@ ErrorOr<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, ZlibCompre
     return buffer;
 }
 
+ErrorOr<ByteBuffer> ZlibCompressor::compress_all_in_parallel(ReadonlyBytes bytes, ZlibCompressionLevel compression_level, size_t thread_count)
+{
+    // The checksum of each chunk is computed by the thread that compresses it, and combined afterwards.
+    struct ChunkChecksum {
+        u32 adler32 { 0 };
+        size_t size { 0 };
+    };
+    Vector<ChunkChecksum> chunk_checksums;
+    TRY(chunk_checksums.try_resize(DeflateCompressor::parallel_chunk_count(bytes.size())));
+
+    auto deflate_compression_level = static_cast<DeflateCompressor::CompressionLevel>(compression_level);
+    auto compressed_bytes = TRY(DeflateCompressor::compress_all_in_parallel(bytes, thread_count, deflate_compression_level, [&](size_t chunk_index, ReadonlyBytes chunk) {
+        chunk_checksums[chunk_index] = { Crypto::Checksum::Adler32 { chunk }.digest(), chunk.size() };
+    }));
+
+    u32 adler32 = Crypto::Checksum::Adler32 {}.digest();
+    for (auto const& chunk_checksum : chunk_checksums)
+        adler32 = Crypto::Checksum::Adler32::combine(adler32, chunk_checksum.adler32, chunk_checksum.size);
+
+    AllocatingMemoryStream output_stream;
+    TRY(write_header(output_stream, ZlibCompressionMethod::Deflate, compression_level));
+    TRY(output_stream.write_until_depleted(compressed_bytes));
+    TRY(output_stream.write_value<NetworkOrdered<u32>>(adler32));
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+    TRY(output_stream.read_until_filled(buffer.bytes()));
+    return buffer;
+}
+
 }
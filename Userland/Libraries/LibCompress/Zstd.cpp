@@ -0,0 +1,1916 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/Endian.h>
+#include <AK/MemoryStream.h>
+#include <LibCompress/Huffman.h>
+#include <LibCompress/Zstd.h>
+
+namespace Compress {
+
+// 3.1.1. Zstandard Frames
+static constexpr u32 frame_magic = 0xFD2FB528;
+
+// 3.1.2. Skippable Frames, whose magic number has four bits that are free for the application to use.
+static constexpr u32 skippable_frame_magic = 0x184D2A50;
+static constexpr u32 skippable_frame_magic_mask = 0xFFFFFFF0;
+
+// 3.1.1.2.2. Block_Type
+enum class BlockType : u8 {
+    Raw = 0,
+    RLE = 1,
+    Compressed = 2,
+    Reserved = 3,
+};
+
+// 3.1.1.3.1.1. Literals_Section_Header
+enum class LiteralsBlockType : u8 {
+    Raw = 0,
+    RLE = 1,
+    Compressed = 2,
+    Treeless = 3,
+};
+
+// 3.1.1.3.2.1. Sequences_Section_Header
+enum class SymbolCompressionMode : u8 {
+    Predefined = 0,
+    RLE = 1,
+    FSECompressed = 2,
+    Repeat = 3,
+};
+
+static constexpr u8 max_literal_length_code = 35;
+static constexpr u8 max_match_length_code = 52;
+static constexpr u8 max_offset_code = 31;
+
+static constexpr u8 max_literal_length_accuracy_log = 9;
+static constexpr u8 max_match_length_accuracy_log = 9;
+static constexpr u8 max_offset_accuracy_log = 8;
+static constexpr u8 max_huffman_weight_accuracy_log = 6;
+
+// 3.1.1.3.2.1.1. Sequence Codes for Lengths and Offsets
+static constexpr Array<u32, max_literal_length_code + 1> literal_length_baselines {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096,
+    8192, 16384, 32768, 65536
+};
+
+static constexpr Array<u8, max_literal_length_code + 1> literal_length_extra_bits {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+    13, 14, 15, 16
+};
+
+static constexpr Array<u32, max_match_length_code + 1> match_length_baselines {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+    19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+    35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051,
+    4099, 8195, 16387, 32771, 65539
+};
+
+static constexpr Array<u8, max_match_length_code + 1> match_length_extra_bits {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+    12, 13, 14, 15, 16
+};
+
+// 3.1.1.3.2.2. Default Distributions
+static constexpr i16 predefined_literal_length_probabilities[] {
+    4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+    -1, -1, -1, -1
+};
+static constexpr u8 predefined_literal_length_accuracy_log = 6;
+
+static constexpr i16 predefined_match_length_probabilities[] {
+    1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+    -1, -1, -1, -1, -1
+};
+static constexpr u8 predefined_match_length_accuracy_log = 6;
+
+static constexpr i16 predefined_offset_probabilities[] {
+    1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+};
+static constexpr u8 predefined_offset_accuracy_log = 5;
+
+static ALWAYS_INLINE u8 highest_set_bit(u32 value)
+{
+    VERIFY(value != 0);
+    return 31 - count_leading_zeroes(value);
+}
+
+static u32 read_little_endian(ReadonlyBytes bytes)
+{
+    VERIFY(bytes.size() <= sizeof(u32));
+    u32 value = 0;
+    for (size_t i = 0; i < bytes.size(); ++i)
+        value |= static_cast<u32>(bytes[i]) << (8 * i);
+    return value;
+}
+
+// 4.1. FSE: a distribution of probabilities that add up to 1 << accuracy_log, where -1 marks a "less than 1" probability.
+struct FseDistribution {
+    u8 accuracy_log { 0 };
+    size_t symbol_count { 0 };
+    Array<i16, max_match_length_code + 1> probabilities {};
+};
+
+static FseDistribution predefined_distribution(ReadonlySpan<i16> probabilities, u8 accuracy_log)
+{
+    FseDistribution distribution;
+    distribution.accuracy_log = accuracy_log;
+    distribution.symbol_count = probabilities.size();
+    for (size_t i = 0; i < probabilities.size(); ++i)
+        distribution.probabilities[i] = probabilities[i];
+    return distribution;
+}
+
+// 4.1.1. FSE Table Description
+static ErrorOr<size_t> read_fse_distribution(ReadonlyBytes data, u8 max_accuracy_log, u8 max_symbol, FseDistribution& distribution)
+{
+    size_t bit_offset = 0;
+    auto read_bits = [&](u8 count) -> ErrorOr<u32> {
+        if (bit_offset + count > data.size() * 8)
+            return Error::from_string_literal("Zstd FSE table description is truncated");
+        u32 value = 0;
+        for (u8 i = 0; i < count; ++i, ++bit_offset)
+            value |= static_cast<u32>((data[bit_offset / 8] >> (bit_offset % 8)) & 1) << i;
+        return value;
+    };
+
+    distribution.accuracy_log = TRY(read_bits(4)) + 5;
+    if (distribution.accuracy_log > max_accuracy_log)
+        return Error::from_string_literal("Zstd FSE table has a too large accuracy log");
+    distribution.probabilities.fill(0);
+
+    // The remaining probability (plus one) determines how many bits the next value can take.
+    i32 remaining = (1 << distribution.accuracy_log) + 1;
+    i32 threshold = 1 << distribution.accuracy_log;
+    u8 bit_count = distribution.accuracy_log + 1;
+    size_t symbol = 0;
+
+    while (remaining > 1) {
+        if (symbol > max_symbol)
+            return Error::from_string_literal("Zstd FSE table has too many symbols");
+
+        // Small values take one bit less than large ones.
+        i32 max_short_value = (2 * threshold - 1) - remaining;
+        i32 value = TRY(read_bits(bit_count - 1));
+        if (value >= max_short_value) {
+            value += TRY(read_bits(1)) << (bit_count - 1);
+            if (value >= threshold)
+                value -= max_short_value;
+        }
+
+        i16 probability = value - 1;
+        distribution.probabilities[symbol++] = probability;
+        remaining -= probability < 0 ? -probability : probability;
+        if (remaining < 1)
+            return Error::from_string_literal("Zstd FSE table probabilities add up to too much");
+
+        if (probability == 0) {
+            // A zero probability is followed by 2-bit repeat flags for more zero probabilities.
+            for (;;) {
+                auto repeat = TRY(read_bits(2));
+                symbol += repeat;
+                if (repeat != 3)
+                    break;
+            }
+        }
+
+        while (remaining < threshold) {
+            bit_count--;
+            threshold >>= 1;
+        }
+    }
+
+    if (symbol > static_cast<size_t>(max_symbol) + 1)
+        return Error::from_string_literal("Zstd FSE table has too many symbols");
+    distribution.symbol_count = symbol;
+
+    return (bit_offset + 7) / 8;
+}
+
+static u16 fse_table_spread_step(size_t table_size)
+{
+    return (table_size >> 1) + (table_size >> 3) + 3;
+}
+
+// 4.1.1. FSE Table Description: symbols are spread over the table, and each state then gets its baseline and bit count.
+static ErrorOr<void> build_fse_decoding_table(FseDistribution const& distribution, ZstdFseDecodingTable& table)
+{
+    size_t table_size = 1u << distribution.accuracy_log;
+    size_t high_threshold = table_size - 1;
+    Array<u16, max_match_length_code + 1> next_states {};
+
+    // "Less than 1" probabilities take a single state each, from the end of the table.
+    for (size_t symbol = 0; symbol < distribution.symbol_count; ++symbol) {
+        if (distribution.probabilities[symbol] == -1) {
+            table.entries[high_threshold--].symbol = symbol;
+            next_states[symbol] = 1;
+        } else {
+            next_states[symbol] = distribution.probabilities[symbol];
+        }
+    }
+
+    auto step = fse_table_spread_step(table_size);
+    auto mask = table_size - 1;
+    size_t position = 0;
+    for (size_t symbol = 0; symbol < distribution.symbol_count; ++symbol) {
+        for (i16 i = 0; i < distribution.probabilities[symbol]; ++i) {
+            table.entries[position].symbol = symbol;
+            do {
+                position = (position + step) & mask;
+            } while (position > high_threshold);
+        }
+    }
+    if (position != 0)
+        return Error::from_string_literal("Zstd FSE table has an invalid distribution");
+
+    for (size_t i = 0; i < table_size; ++i) {
+        auto& entry = table.entries[i];
+        auto next_state = next_states[entry.symbol]++;
+        entry.bit_count = distribution.accuracy_log - highest_set_bit(next_state);
+        entry.baseline = (next_state << entry.bit_count) - table_size;
+    }
+
+    table.accuracy_log = distribution.accuracy_log;
+    table.is_valid = true;
+    return {};
+}
+
+static void build_rle_decoding_table(u8 symbol, ZstdFseDecodingTable& table)
+{
+    table.accuracy_log = 0;
+    table.entries[0] = { 0, symbol, 0 };
+    table.is_valid = true;
+}
+
+// 4.1. Bitstreams are read backwards: the highest set bit of the last byte marks the end of the stream, and the bits
+// before it are read from the most significant end. Reading past the start yields zeros, so that callers can check for
+// overreads once they are done.
+class ReverseBitStream {
+public:
+    static ErrorOr<ReverseBitStream> create(ReadonlyBytes data)
+    {
+        if (data.is_empty() || data.last() == 0)
+            return Error::from_string_literal("Zstd bitstream is missing its end marker");
+        return ReverseBitStream { data, static_cast<i64>(data.size() * 8 - 8 + highest_set_bit(data.last())) };
+    }
+
+    // Returns the next `count` bits, with the first bit to be read as the most significant one.
+    ALWAYS_INLINE u64 peek(u8 count) const
+    {
+        if (count == 0)
+            return 0;
+        auto position = m_remaining_bit_count - count;
+        if (position >= 0)
+            return bits_at(position, count);
+        if (m_remaining_bit_count <= 0)
+            return 0;
+        return bits_at(0, m_remaining_bit_count) << -position;
+    }
+
+    ALWAYS_INLINE void consume(u8 count) { m_remaining_bit_count -= count; }
+
+    ALWAYS_INLINE u64 read(u8 count)
+    {
+        auto value = peek(count);
+        consume(count);
+        return value;
+    }
+
+    bool has_overflowed() const { return m_remaining_bit_count < 0; }
+    bool is_fully_consumed() const { return m_remaining_bit_count == 0; }
+
+private:
+    ReverseBitStream(ReadonlyBytes data, i64 bit_count)
+        : m_data(data)
+        , m_remaining_bit_count(bit_count)
+    {
+    }
+
+    ALWAYS_INLINE u64 bits_at(i64 position, u8 count) const
+    {
+        VERIFY(count <= 56);
+        size_t byte_offset = position / 8;
+        u64 word = 0;
+        __builtin_memcpy(&word, m_data.data() + byte_offset, min(sizeof(word), m_data.size() - byte_offset));
+        word = AK::convert_between_host_and_little_endian(word);
+        return (word >> (position % 8)) & ((1ull << count) - 1);
+    }
+
+    ReadonlyBytes m_data;
+    i64 m_remaining_bit_count { 0 };
+};
+
+// 4.2.1. Huffman Tree Description: the weights of all symbols but the last one.
+static ErrorOr<size_t> read_huffman_weights(ReadonlyBytes data, Array<u8, 256>& weights, size_t& weight_count)
+{
+    if (data.is_empty())
+        return Error::from_string_literal("Zstd Huffman tree description is truncated");
+
+    weight_count = 0;
+    size_t consumed_size = 0;
+
+    auto header = data[0];
+    if (header < 128) {
+        // 4.2.1.2. FSE Compression of Huffman Weights, with two interleaved states.
+        auto compressed_size = header;
+        if (1u + compressed_size > data.size())
+            return Error::from_string_literal("Zstd Huffman tree description is truncated");
+        auto compressed = data.slice(1, compressed_size);
+
+        FseDistribution distribution;
+        auto distribution_size = TRY(read_fse_distribution(compressed, max_huffman_weight_accuracy_log, ZstdHuffmanDecodingTable::max_bit_count, distribution));
+        ZstdFseDecodingTable fse_table;
+        TRY(build_fse_decoding_table(distribution, fse_table));
+
+        auto stream = TRY(ReverseBitStream::create(compressed.slice(distribution_size)));
+        auto first_state = stream.read(fse_table.accuracy_log);
+        auto second_state = stream.read(fse_table.accuracy_log);
+        auto decode_symbol = [&](u64& state) {
+            auto const& entry = fse_table.entries[state];
+            state = entry.baseline + stream.read(entry.bit_count);
+            return entry.symbol;
+        };
+
+        // The weight count isn't stored, the stream ends once a state update reads past its start.
+        for (;;) {
+            if (weight_count > 253)
+                return Error::from_string_literal("Zstd Huffman tree description has too many weights");
+            weights[weight_count++] = decode_symbol(first_state);
+            if (stream.has_overflowed()) {
+                weights[weight_count++] = fse_table.entries[second_state].symbol;
+                break;
+            }
+
+            if (weight_count > 253)
+                return Error::from_string_literal("Zstd Huffman tree description has too many weights");
+            weights[weight_count++] = decode_symbol(second_state);
+            if (stream.has_overflowed()) {
+                weights[weight_count++] = fse_table.entries[first_state].symbol;
+                break;
+            }
+        }
+
+        consumed_size = 1 + compressed_size;
+    } else {
+        // 4.2.1.1. Huffman Tree Header: weights stored directly as 4-bit values.
+        weight_count = header - 127;
+        auto byte_count = (weight_count + 1) / 2;
+        if (1 + byte_count > data.size())
+            return Error::from_string_literal("Zstd Huffman tree description is truncated");
+        for (size_t i = 0; i < weight_count; ++i)
+            weights[i] = i % 2 == 0 ? data[1 + i / 2] >> 4 : data[1 + i / 2] & 0xf;
+        consumed_size = 1 + byte_count;
+    }
+
+    return consumed_size;
+}
+
+static ErrorOr<size_t> read_huffman_table(ReadonlyBytes data, ZstdHuffmanDecodingTable& table)
+{
+    Array<u8, 256> weights {};
+    size_t weight_count = 0;
+    auto consumed_size = TRY(read_huffman_weights(data, weights, weight_count));
+
+    // The weight of the last symbol isn't stored, as the weights have to add up to a power of two.
+    u32 weight_sum = 0;
+    for (size_t i = 0; i < weight_count; ++i) {
+        if (weights[i] > ZstdHuffmanDecodingTable::max_bit_count)
+            return Error::from_string_literal("Zstd Huffman tree description has a too large weight");
+        if (weights[i] > 0)
+            weight_sum += 1u << (weights[i] - 1);
+    }
+    if (weight_sum == 0)
+        return Error::from_string_literal("Zstd Huffman tree description has no weights");
+
+    auto bit_count = highest_set_bit(weight_sum) + 1;
+    if (bit_count > ZstdHuffmanDecodingTable::max_bit_count)
+        return Error::from_string_literal("Zstd Huffman tree description has too long codes");
+    auto last_weight = (1u << bit_count) - weight_sum;
+    if ((last_weight & (last_weight - 1)) != 0)
+        return Error::from_string_literal("Zstd Huffman tree description doesn't describe a complete code");
+    weights[weight_count] = highest_set_bit(last_weight) + 1;
+    auto symbol_count = weight_count + 1;
+
+    // 4.2.2. Huffman-Coded Streams: symbols get table ranges by increasing weight, and by value within a weight.
+    size_t position = 0;
+    for (u8 weight = 1; weight <= bit_count; ++weight) {
+        for (size_t symbol = 0; symbol < symbol_count; ++symbol) {
+            if (weights[symbol] != weight)
+                continue;
+            auto entry_count = 1u << (weight - 1);
+            for (size_t i = 0; i < entry_count; ++i)
+                table.entries[position + i] = { static_cast<u8>(symbol), static_cast<u8>(bit_count + 1 - weight) };
+            position += entry_count;
+        }
+    }
+    VERIFY(position == 1u << bit_count);
+
+    table.bit_count = bit_count;
+    table.is_valid = true;
+    return consumed_size;
+}
+
+static ErrorOr<void> decode_huffman_stream(ReadonlyBytes data, ZstdHuffmanDecodingTable const& table, Bytes output)
+{
+    auto stream = TRY(ReverseBitStream::create(data));
+    for (auto& byte : output) {
+        auto const& entry = table.entries[stream.peek(table.bit_count)];
+        byte = entry.symbol;
+        stream.consume(entry.bit_count);
+    }
+    if (!stream.is_fully_consumed())
+        return Error::from_string_literal("Zstd Huffman-coded stream doesn't end with its last literal");
+    return {};
+}
+
+static ErrorOr<void> read_sequence_table(SymbolCompressionMode mode, ReadonlyBytes& data, FseDistribution const& predefined_distribution, u8 max_accuracy_log, u8 max_symbol, ZstdFseDecodingTable& table)
+{
+    switch (mode) {
+    case SymbolCompressionMode::Predefined:
+        return build_fse_decoding_table(predefined_distribution, table);
+    case SymbolCompressionMode::RLE:
+        if (data.is_empty())
+            return Error::from_string_literal("Zstd sequences section is truncated");
+        if (data[0] > max_symbol)
+            return Error::from_string_literal("Zstd sequences section has an invalid RLE symbol");
+        build_rle_decoding_table(data[0], table);
+        data = data.slice(1);
+        return {};
+    case SymbolCompressionMode::FSECompressed: {
+        FseDistribution distribution;
+        auto size = TRY(read_fse_distribution(data, max_accuracy_log, max_symbol, distribution));
+        data = data.slice(size);
+        return build_fse_decoding_table(distribution, table);
+    }
+    case SymbolCompressionMode::Repeat:
+        if (!table.is_valid)
+            return Error::from_string_literal("Zstd sequences section repeats a table that doesn't exist");
+        return {};
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// 3.1.2.5. Repeat Offsets: without literals, the repeat offsets are shifted by one, and the most recent one is only
+// available minus one.
+static u32 repeat_offset(Array<u32, 3> const& repeat_offsets, u32 offset_value, u32 literal_length)
+{
+    VERIFY(offset_value >= 1 && offset_value <= 3);
+    auto index = literal_length == 0 ? offset_value : offset_value - 1;
+    return index == 3 ? repeat_offsets[0] - 1 : repeat_offsets[index];
+}
+
+static ErrorOr<u32> resolve_offset(Array<u32, 3>& repeat_offsets, u32 offset_value, u32 literal_length)
+{
+    if (offset_value > 3) {
+        auto offset = offset_value - 3;
+        repeat_offsets = { offset, repeat_offsets[0], repeat_offsets[1] };
+        return offset;
+    }
+
+    auto index = literal_length == 0 ? offset_value : offset_value - 1;
+    auto offset = repeat_offset(repeat_offsets, offset_value, literal_length);
+    if (index == 0)
+        return offset;
+    if (offset == 0)
+        return Error::from_string_literal("Zstd sequence has a zero offset");
+
+    if (index != 1)
+        repeat_offsets[2] = repeat_offsets[1];
+    repeat_offsets[1] = repeat_offsets[0];
+    repeat_offsets[0] = offset;
+    return offset;
+}
+
+ErrorOr<NonnullOwnPtr<ZstdDecompressor>> ZstdDecompressor::create(MaybeOwned<Stream> stream, ReadonlyBytes dictionary)
+{
+    auto dictionary_tables = TRY(try_make<ZstdEntropyTables>());
+    auto tables = TRY(try_make<ZstdEntropyTables>());
+    auto decompressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) ZstdDecompressor(move(stream), move(dictionary_tables), move(tables))));
+    TRY(decompressor->load_dictionary(dictionary));
+    decompressor->m_block = TRY(ByteBuffer::create_uninitialized(ZstdCompressor::max_block_size));
+    decompressor->m_literals = TRY(ByteBuffer::create_uninitialized(ZstdCompressor::max_block_size));
+    return decompressor;
+}
+
+ZstdDecompressor::ZstdDecompressor(MaybeOwned<Stream> stream, NonnullOwnPtr<ZstdEntropyTables> dictionary_tables, NonnullOwnPtr<ZstdEntropyTables> tables)
+    : m_stream(move(stream))
+    , m_dictionary_tables(move(dictionary_tables))
+    , m_tables(move(tables))
+{
+}
+
+ErrorOr<ByteBuffer> ZstdDecompressor::decompress_all(ReadonlyBytes bytes, ReadonlyBytes dictionary)
+{
+    auto input_stream = TRY(try_make<FixedMemoryStream>(bytes));
+    auto zstd_stream = TRY(ZstdDecompressor::create(MaybeOwned<Stream>(move(input_stream)), dictionary));
+    return zstd_stream->read_until_eof();
+}
+
+// 5. Dictionary Format
+ErrorOr<void> ZstdDecompressor::load_dictionary(ReadonlyBytes dictionary)
+{
+    // Anything without the magic number is used as raw content.
+    if (dictionary.size() < 8 || read_little_endian(dictionary.trim(4)) != dictionary_magic) {
+        m_dictionary_content = TRY(ByteBuffer::copy(dictionary));
+        return {};
+    }
+
+    m_dictionary_id = read_little_endian(dictionary.slice(4, 4));
+    auto data = dictionary.slice(8);
+
+    data = data.slice(TRY(read_huffman_table(data, m_dictionary_tables->literals)));
+
+    auto read_table = [&](u8 max_accuracy_log, u8 max_symbol, ZstdFseDecodingTable& table) -> ErrorOr<void> {
+        FseDistribution distribution;
+        data = data.slice(TRY(read_fse_distribution(data, max_accuracy_log, max_symbol, distribution)));
+        return build_fse_decoding_table(distribution, table);
+    };
+    TRY(read_table(max_offset_accuracy_log, max_offset_code, m_dictionary_tables->offsets));
+    TRY(read_table(max_match_length_accuracy_log, max_match_length_code, m_dictionary_tables->match_lengths));
+    TRY(read_table(max_literal_length_accuracy_log, max_literal_length_code, m_dictionary_tables->literal_lengths));
+
+    if (data.size() < 12)
+        return Error::from_string_literal("Zstd dictionary is truncated");
+    for (size_t i = 0; i < 3; ++i)
+        m_dictionary_tables->repeat_offsets[i] = read_little_endian(data.slice(4 * i, 4));
+    data = data.slice(12);
+
+    for (auto offset : m_dictionary_tables->repeat_offsets) {
+        if (offset == 0 || offset > data.size())
+            return Error::from_string_literal("Zstd dictionary has an invalid repeat offset");
+    }
+
+    m_dictionary_content = TRY(ByteBuffer::copy(data));
+    return {};
+}
+
+ErrorOr<Bytes> ZstdDecompressor::read_some(Bytes bytes)
+{
+    while (m_output_offset == m_history_size) {
+        if (!m_in_frame) {
+            if (!TRY(read_frame_header()))
+                return bytes.trim(0);
+            continue;
+        }
+        TRY(read_block());
+    }
+
+    auto size = min(bytes.size(), m_history_size - m_output_offset);
+    __builtin_memcpy(bytes.data(), m_history.data() + m_output_offset, size);
+    m_output_offset += size;
+    return bytes.trim(size);
+}
+
+ErrorOr<size_t> ZstdDecompressor::write_some(ReadonlyBytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+bool ZstdDecompressor::is_eof() const
+{
+    return m_reached_end && m_output_offset == m_history_size;
+}
+
+bool ZstdDecompressor::is_open() const
+{
+    return m_stream->is_open();
+}
+
+void ZstdDecompressor::close()
+{
+}
+
+// 3.1.1.1. Frame_Header
+ErrorOr<bool> ZstdDecompressor::read_frame_header()
+{
+    for (;;) {
+        // The stream may end cleanly between frames.
+        Array<u8, 4> magic_bytes;
+        size_t magic_size = 0;
+        while (magic_size < magic_bytes.size()) {
+            auto read = TRY(m_stream->read_some(magic_bytes.span().slice(magic_size)));
+            if (read.is_empty())
+                break;
+            magic_size += read.size();
+        }
+        if (magic_size == 0 && m_stream->is_eof()) {
+            m_reached_end = true;
+            return false;
+        }
+        if (magic_size < magic_bytes.size())
+            return Error::from_string_literal("Zstd frame is truncated");
+
+        auto magic = read_little_endian(magic_bytes);
+        if ((magic & skippable_frame_magic_mask) == skippable_frame_magic) {
+            auto size = TRY(m_stream->read_value<LittleEndian<u32>>());
+            TRY(m_stream->discard(size));
+            continue;
+        }
+        if (magic != frame_magic)
+            return Error::from_string_literal("Zstd frame has an invalid magic number");
+        break;
+    }
+
+    // 3.1.1.1.1. Frame_Header_Descriptor
+    auto descriptor = TRY(m_stream->read_value<u8>());
+    auto content_size_flag = descriptor >> 6;
+    bool single_segment = (descriptor >> 5) & 1;
+    if ((descriptor >> 3) & 1)
+        return Error::from_string_literal("Zstd frame header has the reserved bit set");
+    FrameHeader header;
+    header.has_checksum = (descriptor >> 2) & 1;
+    auto dictionary_id_flag = descriptor & 3;
+
+    // 3.1.1.1.2. Window_Descriptor
+    if (!single_segment) {
+        auto window_descriptor = TRY(m_stream->read_value<u8>());
+        auto window_log = 10 + (window_descriptor >> 3);
+        u64 window_base = 1ull << window_log;
+        header.window_size = window_base + (window_base / 8) * (window_descriptor & 7);
+    }
+
+    // 3.1.1.1.3. Dictionary_ID
+    static constexpr Array<u8, 4> dictionary_id_sizes { 0, 1, 2, 4 };
+    Array<u8, 4> dictionary_id_bytes;
+    auto dictionary_id_size = dictionary_id_sizes[dictionary_id_flag];
+    TRY(m_stream->read_until_filled(dictionary_id_bytes.span().trim(dictionary_id_size)));
+    header.dictionary_id = read_little_endian(dictionary_id_bytes.span().trim(dictionary_id_size));
+
+    // 3.1.1.1.4. Frame_Content_Size
+    static constexpr Array<u8, 4> content_size_sizes { 0, 2, 4, 8 };
+    size_t content_size_size = content_size_flag == 0 && single_segment ? 1 : content_size_sizes[content_size_flag];
+    if (content_size_size > 0) {
+        Array<u8, 8> content_size_bytes;
+        TRY(m_stream->read_until_filled(content_size_bytes.span().trim(content_size_size)));
+        u64 content_size = 0;
+        for (size_t i = 0; i < content_size_size; ++i)
+            content_size |= static_cast<u64>(content_size_bytes[i]) << (8 * i);
+        if (content_size_size == 2)
+            content_size += 256;
+        header.content_size = content_size;
+    }
+
+    if (single_segment)
+        header.window_size = header.content_size.value();
+
+    if (header.window_size > max_window_size)
+        return Error::from_string_literal("Zstd frame needs a larger window than we support");
+    if (header.dictionary_id != 0 && header.dictionary_id != m_dictionary_id)
+        return Error::from_string_literal("Zstd frame needs a dictionary that wasn't provided");
+
+    m_frame_header = header;
+    m_max_block_size = min<u64>(header.window_size, ZstdCompressor::max_block_size);
+    m_frame_output_size = 0;
+    m_checksum = {};
+    *m_tables = *m_dictionary_tables;
+
+    // Only compacting every so often keeps the cost of moving the history down to about one copy per output byte.
+    auto kept_size = header.window_size + m_dictionary_content.size();
+    auto capacity = kept_size + max(kept_size, 4 * m_max_block_size);
+    if (m_history.size() < capacity)
+        TRY(m_history.try_resize(capacity));
+
+    m_dictionary_content.span().copy_to(m_history);
+    m_history_size = m_dictionary_content.size();
+    m_output_offset = m_history_size;
+    m_in_frame = true;
+    return true;
+}
+
+ErrorOr<void> ZstdDecompressor::make_room_for_block()
+{
+    if (m_history_size + m_max_block_size <= m_history.size())
+        return {};
+
+    VERIFY(m_output_offset == m_history_size);
+    auto kept_size = m_frame_header.window_size + m_dictionary_content.size();
+    auto discarded_size = m_history_size - kept_size;
+    __builtin_memmove(m_history.data(), m_history.data() + discarded_size, kept_size);
+    m_history_size = kept_size;
+    m_output_offset = kept_size;
+    return {};
+}
+
+// 3.1.1.2. Blocks
+ErrorOr<void> ZstdDecompressor::read_block()
+{
+    Array<u8, 3> header_bytes;
+    TRY(m_stream->read_until_filled(header_bytes));
+    u32 header = header_bytes[0] | header_bytes[1] << 8 | header_bytes[2] << 16;
+    bool is_last_block = header & 1;
+    auto block_type = static_cast<BlockType>((header >> 1) & 3);
+    size_t block_size = header >> 3;
+
+    if (block_size > m_max_block_size)
+        return Error::from_string_literal("Zstd block is larger than the maximum block size");
+
+    TRY(make_room_for_block());
+    auto block_start = m_history_size;
+
+    switch (block_type) {
+    case BlockType::Raw:
+        TRY(m_stream->read_until_filled(m_history.bytes().slice(m_history_size, block_size)));
+        m_history_size += block_size;
+        break;
+    case BlockType::RLE: {
+        auto byte = TRY(m_stream->read_value<u8>());
+        __builtin_memset(m_history.data() + m_history_size, byte, block_size);
+        m_history_size += block_size;
+        break;
+    }
+    case BlockType::Compressed: {
+        auto block = m_block.bytes().trim(block_size);
+        TRY(m_stream->read_until_filled(block));
+        TRY(decompress_block(block));
+        break;
+    }
+    case BlockType::Reserved:
+        return Error::from_string_literal("Zstd block has the reserved block type");
+    }
+
+    auto output = m_history.bytes().slice(block_start, m_history_size - block_start);
+    m_checksum.update(output);
+    m_frame_output_size += output.size();
+    if (m_frame_header.content_size.has_value() && m_frame_output_size > *m_frame_header.content_size)
+        return Error::from_string_literal("Zstd frame is larger than its declared content size");
+
+    if (is_last_block)
+        TRY(finish_frame());
+    return {};
+}
+
+ErrorOr<void> ZstdDecompressor::finish_frame()
+{
+    if (m_frame_header.content_size.has_value() && m_frame_output_size != *m_frame_header.content_size)
+        return Error::from_string_literal("Zstd frame is smaller than its declared content size");
+
+    // 3.1.1. Content_Checksum: the lowest 32 bits of the XXH64 digest.
+    if (m_frame_header.has_checksum) {
+        u32 checksum = TRY(m_stream->read_value<LittleEndian<u32>>());
+        if (checksum != static_cast<u32>(m_checksum.digest()))
+            return Error::from_string_literal("Zstd frame checksum doesn't match its content");
+    }
+
+    m_in_frame = false;
+    return {};
+}
+
+// 3.1.1.3. Compressed Blocks
+ErrorOr<void> ZstdDecompressor::decompress_block(ReadonlyBytes block)
+{
+    auto literals = TRY(decode_literals_section(block));
+    return decode_sequences_section(block, literals);
+}
+
+// 3.1.1.3.1. Literals_Section
+ErrorOr<ReadonlyBytes> ZstdDecompressor::decode_literals_section(ReadonlyBytes& block)
+{
+    if (block.is_empty())
+        return Error::from_string_literal("Zstd literals section is truncated");
+
+    auto type = static_cast<LiteralsBlockType>(block[0] & 3);
+    auto size_format = (block[0] >> 2) & 3;
+
+    if (type == LiteralsBlockType::Raw || type == LiteralsBlockType::RLE) {
+        size_t header_size = size_format == 1 ? 2 : (size_format == 3 ? 3 : 1);
+        if (header_size > block.size())
+            return Error::from_string_literal("Zstd literals section is truncated");
+
+        auto header = read_little_endian(block.trim(header_size));
+        size_t regenerated_size = header >> (header_size == 1 ? 3 : 4);
+        if (regenerated_size > m_max_block_size)
+            return Error::from_string_literal("Zstd literals section is larger than the maximum block size");
+
+        if (type == LiteralsBlockType::Raw) {
+            if (header_size + regenerated_size > block.size())
+                return Error::from_string_literal("Zstd literals section is truncated");
+            auto literals = block.slice(header_size, regenerated_size);
+            block = block.slice(header_size + regenerated_size);
+            return literals;
+        }
+
+        if (header_size + 1 > block.size())
+            return Error::from_string_literal("Zstd literals section is truncated");
+        __builtin_memset(m_literals.data(), block[header_size], regenerated_size);
+        block = block.slice(header_size + 1);
+        return m_literals.bytes().trim(regenerated_size);
+    }
+
+    // Huffman-coded literals, in one stream with 10-bit sizes, or in four streams with 10, 14 or 18-bit sizes.
+    bool has_four_streams = size_format != 0;
+    size_t header_size = size_format <= 1 ? 3 : size_format + 2;
+    size_t size_bit_count = size_format <= 1 ? 10 : 4 * size_format + 6;
+    if (header_size > block.size())
+        return Error::from_string_literal("Zstd literals section is truncated");
+
+    u64 header = 0;
+    for (size_t i = 0; i < header_size; ++i)
+        header |= static_cast<u64>(block[i]) << (8 * i);
+    size_t regenerated_size = (header >> 4) & ((1u << size_bit_count) - 1);
+    size_t compressed_size = (header >> (4 + size_bit_count)) & ((1u << size_bit_count) - 1);
+    if (regenerated_size > m_max_block_size)
+        return Error::from_string_literal("Zstd literals section is larger than the maximum block size");
+    if (header_size + compressed_size > block.size())
+        return Error::from_string_literal("Zstd literals section is truncated");
+
+    auto data = block.slice(header_size, compressed_size);
+    block = block.slice(header_size + compressed_size);
+
+    if (type == LiteralsBlockType::Compressed)
+        data = data.slice(TRY(read_huffman_table(data, m_tables->literals)));
+    else if (!m_tables->literals.is_valid)
+        return Error::from_string_literal("Zstd literals section reuses a Huffman table that doesn't exist");
+
+    auto literals = m_literals.bytes().trim(regenerated_size);
+    if (!has_four_streams) {
+        TRY(decode_huffman_stream(data, m_tables->literals, literals));
+        return literals;
+    }
+
+    // 3.1.1.3.1.6. Jump_Table
+    if (data.size() < 6)
+        return Error::from_string_literal("Zstd literals jump table is truncated");
+    Array<size_t, 4> stream_sizes;
+    size_t total_stream_size = 0;
+    for (size_t i = 0; i < 3; ++i) {
+        stream_sizes[i] = data[2 * i] | data[2 * i + 1] << 8;
+        total_stream_size += stream_sizes[i];
+    }
+    data = data.slice(6);
+    if (total_stream_size > data.size())
+        return Error::from_string_literal("Zstd literals jump table is invalid");
+    stream_sizes[3] = data.size() - total_stream_size;
+
+    auto segment_size = (regenerated_size + 3) / 4;
+    if (3 * segment_size > regenerated_size)
+        return Error::from_string_literal("Zstd literals section is too small for four streams");
+
+    size_t data_offset = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        auto output_size = i < 3 ? segment_size : regenerated_size - 3 * segment_size;
+        TRY(decode_huffman_stream(data.slice(data_offset, stream_sizes[i]), m_tables->literals, literals.slice(i * segment_size, output_size)));
+        data_offset += stream_sizes[i];
+    }
+
+    return literals;
+}
+
+ErrorOr<void> ZstdDecompressor::copy_match(size_t offset, size_t length)
+{
+    if (offset > m_history_size)
+        return Error::from_string_literal("Zstd match reaches back further than the window");
+
+    auto* destination = m_history.data() + m_history_size;
+    auto const* source = destination - offset;
+    m_history_size += length;
+
+    if (offset >= length) {
+        __builtin_memcpy(destination, source, length);
+    } else if (offset == 1) {
+        __builtin_memset(destination, *source, length);
+    } else {
+        // The match overlaps its own output, so copy it in pieces that have already been written.
+        while (length > 0) {
+            auto piece_size = min(length, offset);
+            __builtin_memcpy(destination, source, piece_size);
+            destination += piece_size;
+            source += piece_size;
+            length -= piece_size;
+        }
+    }
+    return {};
+}
+
+// 3.1.1.3.2. Sequences_Section
+ErrorOr<void> ZstdDecompressor::decode_sequences_section(ReadonlyBytes data, ReadonlyBytes literals)
+{
+    auto block_start = m_history_size;
+    auto append_literals = [&](ReadonlyBytes bytes) -> ErrorOr<void> {
+        if (m_history_size - block_start + bytes.size() > m_max_block_size)
+            return Error::from_string_literal("Zstd block decompresses to more than the maximum block size");
+        __builtin_memcpy(m_history.data() + m_history_size, bytes.data(), bytes.size());
+        m_history_size += bytes.size();
+        return {};
+    };
+
+    if (data.is_empty())
+        return Error::from_string_literal("Zstd sequences section is truncated");
+
+    size_t sequence_count = data[0];
+    if (sequence_count == 0) {
+        if (data.size() != 1)
+            return Error::from_string_literal("Zstd block has data after an empty sequences section");
+        return append_literals(literals);
+    }
+    if (sequence_count < 128) {
+        data = data.slice(1);
+    } else if (sequence_count < 255) {
+        if (data.size() < 2)
+            return Error::from_string_literal("Zstd sequences section is truncated");
+        sequence_count = ((sequence_count - 128) << 8) + data[1];
+        data = data.slice(2);
+    } else {
+        if (data.size() < 3)
+            return Error::from_string_literal("Zstd sequences section is truncated");
+        sequence_count = data[1] + (data[2] << 8) + 0x7F00;
+        data = data.slice(3);
+    }
+
+    if (data.is_empty())
+        return Error::from_string_literal("Zstd sequences section is truncated");
+    auto modes = data[0];
+    if ((modes & 3) != 0)
+        return Error::from_string_literal("Zstd sequences section has reserved bits set");
+    data = data.slice(1);
+
+    static auto const predefined_literal_lengths = predefined_distribution(predefined_literal_length_probabilities, predefined_literal_length_accuracy_log);
+    static auto const predefined_offsets = predefined_distribution(predefined_offset_probabilities, predefined_offset_accuracy_log);
+    static auto const predefined_match_lengths = predefined_distribution(predefined_match_length_probabilities, predefined_match_length_accuracy_log);
+
+    auto& literal_length_table = m_tables->literal_lengths;
+    auto& offset_table = m_tables->offsets;
+    auto& match_length_table = m_tables->match_lengths;
+    TRY(read_sequence_table(static_cast<SymbolCompressionMode>(modes >> 6), data, predefined_literal_lengths, max_literal_length_accuracy_log, max_literal_length_code, literal_length_table));
+    TRY(read_sequence_table(static_cast<SymbolCompressionMode>((modes >> 4) & 3), data, predefined_offsets, max_offset_accuracy_log, max_offset_code, offset_table));
+    TRY(read_sequence_table(static_cast<SymbolCompressionMode>((modes >> 2) & 3), data, predefined_match_lengths, max_match_length_accuracy_log, max_match_length_code, match_length_table));
+
+    // 3.1.1.3.2.2. Sequence Execution, interleaved with the decoding so that no sequence buffer is needed.
+    auto stream = TRY(ReverseBitStream::create(data));
+    auto literal_length_state = stream.read(literal_length_table.accuracy_log);
+    auto offset_state = stream.read(offset_table.accuracy_log);
+    auto match_length_state = stream.read(match_length_table.accuracy_log);
+
+    auto& repeat_offsets = m_tables->repeat_offsets;
+    size_t literal_offset = 0;
+    for (size_t i = 0; i < sequence_count; ++i) {
+        auto const& literal_length_entry = literal_length_table.entries[literal_length_state];
+        auto const& offset_entry = offset_table.entries[offset_state];
+        auto const& match_length_entry = match_length_table.entries[match_length_state];
+
+        auto offset_code = offset_entry.symbol;
+        u32 offset_value = (1u << offset_code) + stream.read(offset_code);
+        u32 match_length = match_length_baselines[match_length_entry.symbol] + stream.read(match_length_extra_bits[match_length_entry.symbol]);
+        u32 literal_length = literal_length_baselines[literal_length_entry.symbol] + stream.read(literal_length_extra_bits[literal_length_entry.symbol]);
+
+        if (i + 1 < sequence_count) {
+            literal_length_state = literal_length_entry.baseline + stream.read(literal_length_entry.bit_count);
+            match_length_state = match_length_entry.baseline + stream.read(match_length_entry.bit_count);
+            offset_state = offset_entry.baseline + stream.read(offset_entry.bit_count);
+        }
+
+        auto offset = TRY(resolve_offset(repeat_offsets, offset_value, literal_length));
+
+        if (literal_length > literals.size() - literal_offset)
+            return Error::from_string_literal("Zstd sequence uses more literals than there are");
+        TRY(append_literals(literals.slice(literal_offset, literal_length)));
+        literal_offset += literal_length;
+
+        if (m_history_size - block_start + match_length > m_max_block_size)
+            return Error::from_string_literal("Zstd block decompresses to more than the maximum block size");
+        TRY(copy_match(offset, match_length));
+    }
+
+    if (!stream.is_fully_consumed())
+        return Error::from_string_literal("Zstd sequences bitstream doesn't end with its last sequence");
+
+    return append_literals(literals.slice(literal_offset));
+}
+
+// Writes a bitstream for ReverseBitStream to read, which means that the last bits written are the first ones read.
+// The output has to be large enough for everything that is written.
+class BitStreamWriter {
+public:
+    explicit BitStreamWriter(Bytes output)
+        : m_output(output)
+    {
+    }
+
+    ALWAYS_INLINE void write(u64 value, u8 count)
+    {
+        VERIFY(count <= 32);
+        m_bits |= (value & ((1ull << count) - 1)) << m_bit_count;
+        m_bit_count += count;
+        if (m_bit_count >= 32) {
+            VERIFY(m_offset + 4 <= m_output.size());
+            auto word = AK::convert_between_host_and_little_endian(static_cast<u32>(m_bits));
+            __builtin_memcpy(m_output.data() + m_offset, &word, sizeof(word));
+            m_offset += 4;
+            m_bits >>= 32;
+            m_bit_count -= 32;
+        }
+    }
+
+    // Pads the last byte with zeros and returns the number of bytes written.
+    size_t align()
+    {
+        while (m_bit_count > 0) {
+            VERIFY(m_offset < m_output.size());
+            m_output[m_offset++] = static_cast<u8>(m_bits);
+            m_bits >>= 8;
+            m_bit_count = m_bit_count > 8 ? m_bit_count - 8 : 0;
+        }
+        return m_offset;
+    }
+
+    // Appends the end marker that ReverseBitStream starts from, and returns the number of bytes written.
+    size_t finish()
+    {
+        write(1, 1);
+        return align();
+    }
+
+private:
+    Bytes m_output;
+    size_t m_offset { 0 };
+    u64 m_bits { 0 };
+    u8 m_bit_count { 0 };
+};
+
+// 4.1.1. FSE Table Description
+static size_t write_fse_distribution(FseDistribution const& distribution, Bytes output)
+{
+    BitStreamWriter writer { output };
+    writer.write(distribution.accuracy_log - 5, 4);
+
+    i32 remaining = (1 << distribution.accuracy_log) + 1;
+    i32 threshold = 1 << distribution.accuracy_log;
+    u8 bit_count = distribution.accuracy_log + 1;
+    bool previous_was_zero = false;
+
+    for (size_t symbol = 0; symbol < distribution.symbol_count && remaining > 1;) {
+        if (previous_was_zero) {
+            auto start = symbol;
+            while (distribution.probabilities[symbol] == 0)
+                symbol++;
+            for (; symbol >= start + 3; start += 3)
+                writer.write(3, 2);
+            writer.write(symbol - start, 2);
+        }
+
+        i32 probability = distribution.probabilities[symbol++];
+        i32 max_short_value = (2 * threshold - 1) - remaining;
+        remaining -= probability < 0 ? -probability : probability;
+
+        i32 value = probability + 1;
+        if (value >= threshold)
+            value += max_short_value;
+        writer.write(value, value < max_short_value ? bit_count - 1 : bit_count);
+        previous_was_zero = probability == 0;
+
+        while (remaining < threshold) {
+            bit_count--;
+            threshold >>= 1;
+        }
+    }
+    VERIFY(remaining == 1);
+
+    return writer.align();
+}
+
+// As in the reference encoder: no more states than the input can make good use of, but enough for every symbol.
+static u8 optimal_accuracy_log(u8 max_accuracy_log, size_t input_size, size_t max_symbol)
+{
+    i32 accuracy_log = max_accuracy_log;
+    if (input_size > 1)
+        accuracy_log = min<i32>(accuracy_log, highest_set_bit(input_size - 1) - 2);
+    auto min_accuracy_log = min(highest_set_bit(input_size) + 1, highest_set_bit(max<size_t>(max_symbol, 1)) + 2);
+    accuracy_log = max<i32>(accuracy_log, min_accuracy_log);
+    return clamp<i32>(accuracy_log, 5, max_accuracy_log);
+}
+
+// Scales the symbol counts to probabilities that add up to the table size, keeping every used symbol.
+static void normalize_counts(ReadonlySpan<u32> counts, size_t total, u8 accuracy_log, FseDistribution& distribution)
+{
+    i32 table_size = 1 << accuracy_log;
+    i32 sum = 0;
+    size_t largest_symbol = 0;
+
+    distribution.accuracy_log = accuracy_log;
+    distribution.symbol_count = 0;
+    distribution.probabilities.fill(0);
+    for (size_t symbol = 0; symbol < counts.size(); ++symbol) {
+        if (counts[symbol] == 0)
+            continue;
+        auto probability = max<i32>(1, (static_cast<u64>(counts[symbol]) * table_size + total / 2) / total);
+        distribution.probabilities[symbol] = probability;
+        sum += probability;
+        distribution.symbol_count = symbol + 1;
+        if (counts[symbol] > counts[largest_symbol])
+            largest_symbol = symbol;
+    }
+
+    if (sum <= table_size || distribution.probabilities[largest_symbol] - (sum - table_size) >= 1) {
+        distribution.probabilities[largest_symbol] += table_size - sum;
+        return;
+    }
+
+    // Rounding up the rare symbols overshot by more than the most common one can make up for.
+    while (sum > table_size) {
+        size_t symbol_to_shrink = 0;
+        for (size_t symbol = 1; symbol < distribution.symbol_count; ++symbol) {
+            if (distribution.probabilities[symbol] > distribution.probabilities[symbol_to_shrink])
+                symbol_to_shrink = symbol;
+        }
+        VERIFY(distribution.probabilities[symbol_to_shrink] > 1);
+        distribution.probabilities[symbol_to_shrink]--;
+        sum--;
+    }
+}
+
+// Estimates the cost in 1/256th bits of coding the given symbol counts with a distribution, or returns nothing if the
+// distribution can't code some of them.
+static Optional<u64> estimate_fse_cost(ReadonlySpan<u32> counts, FseDistribution const& distribution)
+{
+    u64 cost = 0;
+    for (size_t symbol = 0; symbol < counts.size(); ++symbol) {
+        if (counts[symbol] == 0)
+            continue;
+        if (symbol >= distribution.symbol_count || distribution.probabilities[symbol] == 0)
+            return {};
+        u32 probability = distribution.probabilities[symbol] < 0 ? 1 : distribution.probabilities[symbol];
+        auto bit_count = highest_set_bit(probability);
+        auto fixed_point_log2 = (bit_count << 8) + ((probability << 8) >> bit_count) - 256;
+        cost += static_cast<u64>(counts[symbol]) * ((distribution.accuracy_log << 8) - fixed_point_log2);
+    }
+    return cost;
+}
+
+// The encoder's view of an FSE table, as in the reference encoder: for every symbol, the number of bits to write for a
+// state and the position of the symbol's next states.
+struct FseEncodingTable {
+    struct SymbolTransform {
+        i32 delta_find_state { 0 };
+        u32 delta_bit_count { 0 };
+    };
+
+    u8 accuracy_log { 0 };
+    Array<u16, 1 << ZstdFseDecodingTable::max_accuracy_log> state_table;
+    Array<SymbolTransform, max_match_length_code + 1> symbol_transforms;
+};
+
+static void build_fse_encoding_table(FseDistribution const& distribution, FseEncodingTable& table)
+{
+    u32 table_size = 1u << distribution.accuracy_log;
+    u32 high_threshold = table_size - 1;
+    Array<u8, 1 << ZstdFseDecodingTable::max_accuracy_log> table_symbols;
+    Array<u32, max_match_length_code + 2> cumulative_probabilities {};
+
+    for (size_t symbol = 0; symbol < distribution.symbol_count; ++symbol) {
+        auto probability = distribution.probabilities[symbol];
+        if (probability == -1) {
+            cumulative_probabilities[symbol + 1] = cumulative_probabilities[symbol] + 1;
+            table_symbols[high_threshold--] = symbol;
+        } else {
+            cumulative_probabilities[symbol + 1] = cumulative_probabilities[symbol] + probability;
+        }
+    }
+
+    // This has to spread the symbols exactly like build_fse_decoding_table().
+    auto step = fse_table_spread_step(table_size);
+    auto mask = table_size - 1;
+    u32 position = 0;
+    for (size_t symbol = 0; symbol < distribution.symbol_count; ++symbol) {
+        for (i16 i = 0; i < distribution.probabilities[symbol]; ++i) {
+            table_symbols[position] = symbol;
+            do {
+                position = (position + step) & mask;
+            } while (position > high_threshold);
+        }
+    }
+    VERIFY(position == 0);
+
+    for (u32 i = 0; i < table_size; ++i)
+        table.state_table[cumulative_probabilities[table_symbols[i]]++] = table_size + i;
+
+    i32 total = 0;
+    for (size_t symbol = 0; symbol < distribution.symbol_count; ++symbol) {
+        auto& transform = table.symbol_transforms[symbol];
+        auto probability = distribution.probabilities[symbol];
+        if (probability == 0) {
+            transform.delta_bit_count = ((distribution.accuracy_log + 1) << 16) - table_size;
+        } else if (probability == -1 || probability == 1) {
+            transform.delta_bit_count = (distribution.accuracy_log << 16) - table_size;
+            transform.delta_find_state = total - 1;
+            total++;
+        } else {
+            u32 max_bits_out = distribution.accuracy_log - highest_set_bit(probability - 1);
+            u32 min_state_plus = static_cast<u32>(probability) << max_bits_out;
+            transform.delta_bit_count = (max_bits_out << 16) - min_state_plus;
+            transform.delta_find_state = total - probability;
+            total += probability;
+        }
+    }
+
+    table.accuracy_log = distribution.accuracy_log;
+}
+
+class FseEncoderState {
+public:
+    // The first state is picked so that it writes as few bits as possible for the given symbol.
+    FseEncoderState(FseEncodingTable const& table, u8 symbol)
+        : m_table(table)
+    {
+        auto const& transform = m_table.symbol_transforms[symbol];
+        u32 bit_count = (transform.delta_bit_count + (1 << 15)) >> 16;
+        u32 value = (bit_count << 16) - transform.delta_bit_count;
+        m_value = m_table.state_table[(value >> bit_count) + transform.delta_find_state];
+    }
+
+    ALWAYS_INLINE void encode(BitStreamWriter& writer, u8 symbol)
+    {
+        auto const& transform = m_table.symbol_transforms[symbol];
+        u32 bit_count = (m_value + transform.delta_bit_count) >> 16;
+        writer.write(m_value, bit_count);
+        m_value = m_table.state_table[(m_value >> bit_count) + transform.delta_find_state];
+    }
+
+    void flush(BitStreamWriter& writer)
+    {
+        writer.write(m_value, m_table.accuracy_log);
+    }
+
+private:
+    FseEncodingTable const& m_table;
+    u32 m_value { 0 };
+};
+
+// 4.2.1.2. FSE Compression of Huffman Weights. Returns the compressed size, or nothing if it can't be compressed.
+static Optional<size_t> compress_huffman_weights(ReadonlyBytes weights, Bytes output)
+{
+    Array<u32, ZstdHuffmanDecodingTable::max_bit_count + 1> counts {};
+    u8 max_weight = 0;
+    for (auto weight : weights) {
+        counts[weight]++;
+        max_weight = max(max_weight, weight);
+    }
+    for (auto count : counts) {
+        if (count == weights.size())
+            return {};
+    }
+
+    FseDistribution distribution;
+    auto accuracy_log = optimal_accuracy_log(max_huffman_weight_accuracy_log, weights.size(), max_weight);
+    normalize_counts(ReadonlySpan<u32> { counts.data(), max_weight + 1u }, weights.size(), accuracy_log, distribution);
+    auto distribution_size = write_fse_distribution(distribution, output);
+
+    FseEncodingTable table;
+    build_fse_encoding_table(distribution, table);
+
+    // Weights at even indices go through the first state and odd ones through the second, starting from the end.
+    BitStreamWriter writer { output.slice(distribution_size) };
+    Optional<FseEncoderState> states[2];
+    for (size_t i = weights.size(); i-- > 0;) {
+        auto& state = states[i % 2];
+        if (state.has_value())
+            state->encode(writer, weights[i]);
+        else
+            state.emplace(table, weights[i]);
+    }
+    states[1]->flush(writer);
+    states[0]->flush(writer);
+
+    return distribution_size + writer.finish();
+}
+
+ErrorOr<NonnullOwnPtr<ZstdCompressor>> ZstdCompressor::construct(MaybeOwned<Stream> stream, u8 level, Optional<u8> window_log)
+{
+    VERIFY(level >= min_level && level <= max_level);
+    auto parameters = level_parameters[level - min_level];
+    auto effective_window_log = window_log.value_or(parameters.window_log);
+    VERIFY(effective_window_log >= min_window_log && effective_window_log <= max_window_log);
+
+    auto hash_head = TRY(FixedArray<u32>::create(1 << hash_bits));
+    auto hash_chain = TRY(FixedArray<u32>::create(1 << effective_window_log));
+    auto compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) ZstdCompressor(move(stream), parameters, effective_window_log, move(hash_head), move(hash_chain))));
+
+    // 3.1.1.1. Frame_Header: a window descriptor without a mantissa, no dictionary, no content size, and a checksum.
+    auto& output_stream = *compressor->m_output_stream;
+    TRY(output_stream.write_value<LittleEndian<u32>>(frame_magic));
+    TRY(output_stream.write_value<u8>(1 << 2));
+    TRY(output_stream.write_value<u8>((effective_window_log - 10) << 3));
+
+    return compressor;
+}
+
+ZstdCompressor::ZstdCompressor(MaybeOwned<Stream> stream, LevelParameters parameters, u8 window_log, FixedArray<u32> hash_head, FixedArray<u32> hash_chain)
+    : m_parameters(parameters)
+    , m_window_log(window_log)
+    , m_window_size(1u << window_log)
+    , m_block_size(min(m_window_size, max_block_size))
+    , m_output_stream(move(stream))
+    , m_hash_head(move(hash_head))
+    , m_hash_chain(move(hash_chain))
+{
+}
+
+ZstdCompressor::~ZstdCompressor()
+{
+    if (!m_finished) {
+        // Note: We need a better API for specifying things like this.
+        final_flush().release_value_but_fixme_should_propagate_errors();
+    }
+}
+
+ErrorOr<Bytes> ZstdCompressor::read_some(Bytes)
+{
+    return Error::from_errno(EBADF);
+}
+
+ErrorOr<size_t> ZstdCompressor::write_some(ReadonlyBytes bytes)
+{
+    VERIFY(!m_finished);
+
+    size_t total_written = 0;
+    while (!bytes.is_empty()) {
+        auto pending_size = m_buffer.size() - m_pending_offset;
+        auto n_written = min(bytes.size(), m_block_size - pending_size);
+        TRY(m_buffer.try_append(bytes.trim(n_written)));
+
+        // The last block is only compressed in final_flush(), since it has to be marked as such.
+        if (pending_size + n_written == m_block_size && n_written < bytes.size())
+            TRY(compress_block(false));
+
+        bytes = bytes.slice(n_written);
+        total_written += n_written;
+    }
+    return total_written;
+}
+
+bool ZstdCompressor::is_eof() const
+{
+    return true;
+}
+
+bool ZstdCompressor::is_open() const
+{
+    return m_output_stream->is_open();
+}
+
+void ZstdCompressor::close()
+{
+}
+
+static u32 hash_four_bytes(u8 const* bytes, size_t hash_bits)
+{
+    u32 value = bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<u32>(bytes[3]) << 24;
+    return (value * 0x1e35a7bd) >> (32 - hash_bits);
+}
+
+void ZstdCompressor::insert_hash(size_t position)
+{
+    auto stream_position = static_cast<u32>(m_buffer_offset + position);
+    auto hash = hash_four_bytes(m_buffer.data() + position, hash_bits);
+    m_hash_chain[stream_position & (m_hash_chain.size() - 1)] = m_hash_head[hash];
+    m_hash_head[hash] = stream_position;
+}
+
+size_t ZstdCompressor::match_length_at(size_t position, size_t offset, size_t max_length) const
+{
+    auto const* current = m_buffer.data() + position;
+    auto const* reference = current - offset;
+
+    size_t length = 0;
+    while (length + sizeof(u64) <= max_length) {
+        u64 current_word;
+        u64 reference_word;
+        __builtin_memcpy(&current_word, current + length, sizeof(u64));
+        __builtin_memcpy(&reference_word, reference + length, sizeof(u64));
+        if (current_word != reference_word)
+            return length + count_trailing_zeroes(current_word ^ reference_word) / 8;
+        length += sizeof(u64);
+    }
+    while (length < max_length && current[length] == reference[length])
+        length++;
+    return length;
+}
+
+// Weighs the bytes a match covers against the bits its offset costs, like the Brotli compressor does.
+static constexpr size_t literal_byte_score = 135;
+static constexpr size_t offset_bit_penalty = 30;
+static constexpr size_t score_base = offset_bit_penalty * 8 * sizeof(size_t);
+static constexpr size_t min_score = score_base + 100;
+static constexpr size_t lazy_match_score_margin = 175;
+static constexpr size_t max_lazy_match_deferrals = 4;
+
+static size_t match_score(size_t length, u32 offset_value)
+{
+    return score_base + literal_byte_score * length - offset_bit_penalty * highest_set_bit(offset_value);
+}
+
+ZstdCompressor::Match ZstdCompressor::find_best_match(size_t position, size_t max_length, size_t literal_length, Array<u32, 3> const& repeat_offsets) const
+{
+    Match best_match;
+    auto stream_position = m_buffer_offset + position;
+    size_t max_offset = min<u64>(stream_position, m_window_size);
+    auto nice_length = min(m_parameters.nice_match_length, max_length);
+
+    for (u32 offset_value = 1; offset_value <= 3; ++offset_value) {
+        auto offset = repeat_offset(repeat_offsets, offset_value, literal_length);
+        if (offset == 0 || offset > max_offset)
+            continue;
+        auto length = match_length_at(position, offset, max_length);
+        if (length < min_match_length)
+            continue;
+        auto score = match_score(length, offset_value);
+        if (score > best_match.score)
+            best_match = { length, offset, score };
+    }
+
+    auto candidate = m_hash_head[hash_four_bytes(m_buffer.data() + position, hash_bits)];
+    size_t previous_offset = 0;
+    for (size_t chain = 0; chain < m_parameters.max_chain_length && best_match.length < nice_length; chain++) {
+        size_t offset = static_cast<u32>(static_cast<u32>(stream_position) - candidate);
+        if (offset <= previous_offset || offset > max_offset)
+            break;
+        previous_offset = offset;
+
+        // A candidate can only be better if it also matches the byte just past the current best match.
+        if (best_match.length >= max_length || m_buffer[position + best_match.length] == m_buffer[position - offset + best_match.length]) {
+            auto length = match_length_at(position, offset, max_length);
+            if (length >= min_match_length) {
+                auto score = match_score(length, offset + 3);
+                if (score > best_match.score)
+                    best_match = { length, offset, score };
+            }
+        }
+
+        candidate = m_hash_chain[candidate & (m_hash_chain.size() - 1)];
+    }
+
+    if (best_match.score < min_score)
+        return {};
+    return best_match;
+}
+
+ErrorOr<void> ZstdCompressor::find_sequences(size_t start, size_t length, Array<u32, 3>& repeat_offsets)
+{
+    auto end = start + length;
+    auto literal_start = start;
+    auto position = start;
+
+    while (position + min_match_length <= end) {
+        auto match = find_best_match(position, end - position, position - literal_start, repeat_offsets);
+        insert_hash(position);
+        if (match.length == 0) {
+            position++;
+            continue;
+        }
+
+        if (m_parameters.lazy_matching) {
+            for (size_t deferrals = 0; deferrals < max_lazy_match_deferrals && match.length < m_parameters.nice_match_length && position + 1 + min_match_length <= end; deferrals++) {
+                auto next_match = find_best_match(position + 1, end - position - 1, position + 1 - literal_start, repeat_offsets);
+                if (next_match.score < match.score + lazy_match_score_margin)
+                    break;
+                position++;
+                insert_hash(position);
+                match = next_match;
+            }
+        }
+
+        u32 literal_length = position - literal_start;
+        TRY(m_literals.try_append(m_buffer.bytes().slice(literal_start, literal_length)));
+
+        // Prefer a repeat offset, which tracks the same state as the decompressor.
+        u32 offset_value = match.offset + 3;
+        for (u32 repeat = 1; repeat <= 3; ++repeat) {
+            if (repeat_offset(repeat_offsets, repeat, literal_length) == match.offset) {
+                offset_value = repeat;
+                break;
+            }
+        }
+        auto offset = MUST(resolve_offset(repeat_offsets, offset_value, literal_length));
+        VERIFY(offset == match.offset);
+        TRY(m_sequences.try_append({ literal_length, static_cast<u32>(match.length), offset_value }));
+
+        auto match_end = position + match.length;
+        for (position++; position < match_end && position + min_match_length <= end; position++)
+            insert_hash(position);
+        position = match_end;
+        literal_start = position;
+    }
+
+    return m_literals.try_append(m_buffer.bytes().slice(literal_start, end - literal_start));
+}
+
+static ErrorOr<void> write_raw_literals_header(ByteBuffer& output, LiteralsBlockType type, size_t size)
+{
+    auto type_bits = to_underlying(type);
+    if (size < 32)
+        return output.try_append(static_cast<u8>(type_bits | size << 3));
+    if (size < 4096) {
+        Array<u8, 2> header { static_cast<u8>(type_bits | 1 << 2 | (size & 0xf) << 4), static_cast<u8>(size >> 4) };
+        return output.try_append(header.data(), header.size());
+    }
+    Array<u8, 3> header { static_cast<u8>(type_bits | 3 << 2 | (size & 0xf) << 4), static_cast<u8>(size >> 4), static_cast<u8>(size >> 12) };
+    return output.try_append(header.data(), header.size());
+}
+
+// 3.1.1.3.1. Literals_Section
+ErrorOr<void> ZstdCompressor::encode_literals_section(ReadonlyBytes literals)
+{
+    // Huffman coding doesn't pay off for a handful of literals.
+    static constexpr size_t min_huffman_literals_size = 64;
+    // One stream is limited to 10-bit sizes, so longer literals are split into four.
+    static constexpr size_t min_four_streams_literals_size = 256;
+
+    Array<u32, 256> histogram {};
+    for (auto byte : literals)
+        histogram[byte]++;
+
+    size_t used_symbol_count = 0;
+    size_t last_symbol = 0;
+    for (size_t symbol = 0; symbol < histogram.size(); ++symbol) {
+        if (histogram[symbol] != 0) {
+            used_symbol_count++;
+            last_symbol = symbol;
+        }
+    }
+
+    if (used_symbol_count == 1 && literals.size() > 1) {
+        TRY(write_raw_literals_header(m_compressed_block, LiteralsBlockType::RLE, literals.size()));
+        return m_compressed_block.try_append(literals[0]);
+    }
+
+    auto write_raw_literals = [&]() -> ErrorOr<void> {
+        TRY(write_raw_literals_header(m_compressed_block, LiteralsBlockType::Raw, literals.size()));
+        return m_compressed_block.try_append(literals);
+    };
+
+    if (literals.size() < min_huffman_literals_size || used_symbol_count < 2)
+        return write_raw_literals();
+
+    // generate_huffman_lengths() works on 16-bit frequencies that also have to add up to at most 16 bits.
+    constexpr u64 max_scaled_total = NumericLimits<u16>::max() - 256;
+    Array<u16, 256> frequencies {};
+    for (size_t symbol = 0; symbol < histogram.size(); ++symbol) {
+        if (histogram[symbol] != 0)
+            frequencies[symbol] = literals.size() <= NumericLimits<u16>::max() ? histogram[symbol] : max<u64>(histogram[symbol] * max_scaled_total / literals.size(), 1);
+    }
+    Array<u8, 256> lengths {};
+    generate_huffman_lengths(lengths, frequencies, ZstdHuffmanDecodingTable::max_bit_count);
+
+    u8 max_length = 0;
+    for (auto length : lengths)
+        max_length = max(max_length, length);
+
+    // 4.2.1. Huffman Tree Description: weights count from the longest code up, and the last one is implied.
+    Array<u8, 256> weights {};
+    for (size_t symbol = 0; symbol <= last_symbol; ++symbol)
+        weights[symbol] = lengths[symbol] == 0 ? 0 : max_length + 1 - lengths[symbol];
+
+    Array<u16, 256> codes {};
+    size_t position = 0;
+    for (u8 weight = 1; weight <= max_length; ++weight) {
+        for (size_t symbol = 0; symbol <= last_symbol; ++symbol) {
+            if (weights[symbol] != weight)
+                continue;
+            codes[symbol] = position >> (weight - 1);
+            position += 1u << (weight - 1);
+        }
+    }
+    VERIFY(position == 1u << max_length);
+
+    Array<u8, 512> tree_description;
+    size_t tree_description_size = 0;
+    auto described_weights = ReadonlyBytes { weights.data(), last_symbol };
+    auto direct_size = 1 + (last_symbol + 1) / 2;
+    auto compressed_weights_size = compress_huffman_weights(described_weights, tree_description.span().slice(1));
+    if (compressed_weights_size.has_value() && *compressed_weights_size < 128 && *compressed_weights_size + 1 < direct_size) {
+        tree_description[0] = *compressed_weights_size;
+        tree_description_size = 1 + *compressed_weights_size;
+
+        // The decompressor finds the end of the weights by reading past the start of the bitstream, which a state
+        // that needs no bits for its last weight doesn't do. Make sure that the weights come back as they were.
+        Array<u8, 256> decoded_weights {};
+        size_t decoded_weight_count = 0;
+        auto result = read_huffman_weights(tree_description.span().trim(tree_description_size), decoded_weights, decoded_weight_count);
+        if (result.is_error() || ReadonlyBytes { decoded_weights.data(), decoded_weight_count } != described_weights)
+            tree_description_size = 0;
+    }
+
+    if (tree_description_size == 0) {
+        if (last_symbol > 128)
+            return write_raw_literals();
+        tree_description[0] = 127 + last_symbol;
+        tree_description.span().slice(1, direct_size - 1).fill(0);
+        for (size_t i = 0; i < last_symbol; ++i)
+            tree_description[1 + i / 2] |= i % 2 == 0 ? weights[i] << 4 : weights[i];
+        tree_description_size = direct_size;
+    }
+
+    bool has_four_streams = literals.size() >= min_four_streams_literals_size;
+    size_t header_size = 3;
+    if (has_four_streams && literals.size() >= 1024)
+        header_size = literals.size() < 16384 ? 4 : 5;
+
+    // Leave room for the largest possible header, which gets moved into place once the compressed size is known.
+    static constexpr size_t max_header_size = 5;
+    auto output_start = m_compressed_block.size();
+    auto max_stream_size = literals.size() * ZstdHuffmanDecodingTable::max_bit_count / 8 + 8;
+    auto output = TRY(m_compressed_block.get_bytes_for_writing(max_header_size + tree_description_size + 6 + 4 * max_stream_size));
+
+    size_t offset = max_header_size;
+    tree_description.span().trim(tree_description_size).copy_to(output.slice(offset));
+    offset += tree_description_size;
+
+    auto encode_stream = [&](ReadonlyBytes stream_literals, Bytes stream_output) {
+        BitStreamWriter writer { stream_output };
+        for (size_t i = stream_literals.size(); i-- > 0;) {
+            auto symbol = stream_literals[i];
+            writer.write(codes[symbol], max_length + 1 - weights[symbol]);
+        }
+        return writer.finish();
+    };
+
+    if (!has_four_streams) {
+        offset += encode_stream(literals, output.slice(offset, max_stream_size));
+    } else {
+        auto jump_table_offset = offset;
+        offset += 6;
+        auto segment_size = (literals.size() + 3) / 4;
+        for (size_t i = 0; i < 4; ++i) {
+            auto segment = literals.slice(i * segment_size, i < 3 ? segment_size : literals.size() - 3 * segment_size);
+            auto stream_size = encode_stream(segment, output.slice(offset, max_stream_size));
+            if (i < 3) {
+                VERIFY(stream_size <= NumericLimits<u16>::max());
+                output[jump_table_offset + 2 * i] = stream_size;
+                output[jump_table_offset + 2 * i + 1] = stream_size >> 8;
+            }
+            offset += stream_size;
+        }
+    }
+
+    auto compressed_size = offset - max_header_size;
+    if (header_size + compressed_size >= literals.size() + (literals.size() < 4096 ? 2 : 3)) {
+        m_compressed_block.resize(output_start);
+        return write_raw_literals();
+    }
+
+    // 3.1.1.3.1.1. Literals_Section_Header
+    u64 size_format = header_size == 3 ? (has_four_streams ? 1 : 0) : header_size - 2;
+    auto size_bit_count = header_size == 3 ? 10 : 4 * size_format + 6;
+    u64 header = to_underlying(LiteralsBlockType::Compressed) | size_format << 2 | literals.size() << 4 | compressed_size << (4 + size_bit_count);
+    for (size_t i = 0; i < header_size; ++i)
+        output[max_header_size - header_size + i] = header >> (8 * i);
+
+    __builtin_memmove(output.data(), output.data() + max_header_size - header_size, header_size + compressed_size);
+    m_compressed_block.resize(output_start + header_size + compressed_size);
+    return {};
+}
+
+static u8 literal_length_code(u32 literal_length)
+{
+    if (literal_length < 16)
+        return literal_length;
+    if (literal_length >= 64)
+        return highest_set_bit(literal_length) + 19;
+    u8 code = 16;
+    while (literal_length_baselines[code + 1] <= literal_length)
+        code++;
+    return code;
+}
+
+static u8 match_length_code(u32 match_length)
+{
+    auto value = match_length - 3;
+    if (value < 32)
+        return value;
+    if (value >= 128)
+        return highest_set_bit(value) + 36;
+    u8 code = 32;
+    while (match_length_baselines[code + 1] <= match_length)
+        code++;
+    return code;
+}
+
+// 3.1.1.3.2. Sequences_Section
+ErrorOr<void> ZstdCompressor::encode_sequences_section()
+{
+    // Custom tables only pay for their description with enough sequences.
+    static constexpr size_t min_custom_table_sequence_count = 32;
+
+    auto sequence_count = m_sequences.size();
+    if (sequence_count < 128) {
+        TRY(m_compressed_block.try_append(static_cast<u8>(sequence_count)));
+    } else if (sequence_count < 0x7F00) {
+        TRY(m_compressed_block.try_append(static_cast<u8>((sequence_count >> 8) + 128)));
+        TRY(m_compressed_block.try_append(static_cast<u8>(sequence_count)));
+    } else {
+        TRY(m_compressed_block.try_append(255));
+        TRY(m_compressed_block.try_append(static_cast<u8>(sequence_count - 0x7F00)));
+        TRY(m_compressed_block.try_append(static_cast<u8>((sequence_count - 0x7F00) >> 8)));
+    }
+    if (sequence_count == 0)
+        return {};
+
+    struct SequenceCodes {
+        u8 literal_length;
+        u8 offset;
+        u8 match_length;
+    };
+    Vector<SequenceCodes> codes;
+    TRY(codes.try_ensure_capacity(sequence_count));
+    Array<u32, max_literal_length_code + 1> literal_length_counts {};
+    Array<u32, max_offset_code + 1> offset_counts {};
+    Array<u32, max_match_length_code + 1> match_length_counts {};
+    for (auto const& sequence : m_sequences) {
+        SequenceCodes sequence_codes { literal_length_code(sequence.literal_length), highest_set_bit(sequence.offset_value), match_length_code(sequence.match_length) };
+        literal_length_counts[sequence_codes.literal_length]++;
+        offset_counts[sequence_codes.offset]++;
+        match_length_counts[sequence_codes.match_length]++;
+        codes.unchecked_append(sequence_codes);
+    }
+
+    auto modes_offset = m_compressed_block.size();
+    TRY(m_compressed_block.try_append(0));
+
+    // Picks the cheapest of the predefined table, a single repeated symbol, and a table of our own.
+    auto choose_table = [&](ReadonlySpan<u32> counts, ReadonlySpan<i16> predefined_probabilities, u8 predefined_accuracy_log, u8 max_accuracy_log, Optional<FseEncodingTable>& table) -> ErrorOr<SymbolCompressionMode> {
+        size_t max_symbol = 0;
+        size_t used_symbol_count = 0;
+        for (size_t symbol = 0; symbol < counts.size(); ++symbol) {
+            if (counts[symbol] != 0) {
+                max_symbol = symbol;
+                used_symbol_count++;
+            }
+        }
+
+        if (used_symbol_count == 1 && sequence_count > 1) {
+            TRY(m_compressed_block.try_append(static_cast<u8>(max_symbol)));
+            return SymbolCompressionMode::RLE;
+        }
+
+        auto predefined = predefined_distribution(predefined_probabilities, predefined_accuracy_log);
+        auto predefined_cost = estimate_fse_cost(counts, predefined);
+
+        if (sequence_count >= min_custom_table_sequence_count || !predefined_cost.has_value()) {
+            FseDistribution distribution;
+            auto accuracy_log = optimal_accuracy_log(max_accuracy_log, sequence_count, max_symbol);
+            normalize_counts(counts.trim(max_symbol + 1), sequence_count, accuracy_log, distribution);
+
+            Array<u8, 128> description;
+            auto description_size = write_fse_distribution(distribution, description);
+            auto custom_cost = estimate_fse_cost(counts, distribution).value() + description_size * 8 * 256;
+            if (!predefined_cost.has_value() || custom_cost < *predefined_cost) {
+                TRY(m_compressed_block.try_append(description.data(), description_size));
+                table.emplace();
+                build_fse_encoding_table(distribution, *table);
+                return SymbolCompressionMode::FSECompressed;
+            }
+        }
+
+        table.emplace();
+        build_fse_encoding_table(predefined, *table);
+        return SymbolCompressionMode::Predefined;
+    };
+
+    Optional<FseEncodingTable> literal_length_table;
+    Optional<FseEncodingTable> offset_table;
+    Optional<FseEncodingTable> match_length_table;
+    auto literal_length_mode = TRY(choose_table(literal_length_counts, predefined_literal_length_probabilities, predefined_literal_length_accuracy_log, max_literal_length_accuracy_log, literal_length_table));
+    auto offset_mode = TRY(choose_table(offset_counts, predefined_offset_probabilities, predefined_offset_accuracy_log, max_offset_accuracy_log, offset_table));
+    auto match_length_mode = TRY(choose_table(match_length_counts, predefined_match_length_probabilities, predefined_match_length_accuracy_log, max_match_length_accuracy_log, match_length_table));
+    m_compressed_block[modes_offset] = to_underlying(literal_length_mode) << 6 | to_underlying(offset_mode) << 4 | to_underlying(match_length_mode) << 2;
+
+    // A sequence takes at most 9 + 8 + 9 state bits and 16 + 31 + 16 extra bits.
+    auto output_start = m_compressed_block.size();
+    auto output = TRY(m_compressed_block.get_bytes_for_writing(sequence_count * 12 + 16));
+    BitStreamWriter writer { output };
+
+    auto write_extra_bits = [&](size_t index) {
+        auto const& sequence = m_sequences[index];
+        auto const& sequence_codes = codes[index];
+        writer.write(sequence.literal_length - literal_length_baselines[sequence_codes.literal_length], literal_length_extra_bits[sequence_codes.literal_length]);
+        writer.write(sequence.match_length - match_length_baselines[sequence_codes.match_length], match_length_extra_bits[sequence_codes.match_length]);
+        writer.write(sequence.offset_value - (1u << sequence_codes.offset), sequence_codes.offset);
+    };
+
+    // The sequences are written back to front, so that the decompressor reads them front to back. States for RLE
+    // tables don't write any bits.
+    Optional<FseEncoderState> literal_length_state;
+    Optional<FseEncoderState> offset_state;
+    Optional<FseEncoderState> match_length_state;
+    auto const& last_codes = codes.last();
+    if (match_length_table.has_value())
+        match_length_state.emplace(*match_length_table, last_codes.match_length);
+    if (offset_table.has_value())
+        offset_state.emplace(*offset_table, last_codes.offset);
+    if (literal_length_table.has_value())
+        literal_length_state.emplace(*literal_length_table, last_codes.literal_length);
+    write_extra_bits(sequence_count - 1);
+
+    for (size_t i = sequence_count - 1; i-- > 0;) {
+        if (offset_state.has_value())
+            offset_state->encode(writer, codes[i].offset);
+        if (match_length_state.has_value())
+            match_length_state->encode(writer, codes[i].match_length);
+        if (literal_length_state.has_value())
+            literal_length_state->encode(writer, codes[i].literal_length);
+        write_extra_bits(i);
+    }
+
+    if (match_length_state.has_value())
+        match_length_state->flush(writer);
+    if (offset_state.has_value())
+        offset_state->flush(writer);
+    if (literal_length_state.has_value())
+        literal_length_state->flush(writer);
+
+    m_compressed_block.resize(output_start + writer.finish());
+    return {};
+}
+
+// 3.1.1.2. Blocks
+ErrorOr<void> ZstdCompressor::write_block_header(bool is_last_block, u8 block_type, size_t block_size)
+{
+    u32 header = (is_last_block ? 1 : 0) | block_type << 1 | block_size << 3;
+    Array<u8, 3> header_bytes { static_cast<u8>(header), static_cast<u8>(header >> 8), static_cast<u8>(header >> 16) };
+    return m_output_stream->write_until_depleted(header_bytes);
+}
+
+ErrorOr<void> ZstdCompressor::compress_block(bool is_last_block)
+{
+    auto start = m_pending_offset;
+    auto length = m_buffer.size() - start;
+    auto block = m_buffer.bytes().slice(start, length);
+    m_checksum.update(block);
+
+    bool is_single_byte = length > 0 && all_of(block, [&](auto byte) { return byte == block[0]; });
+    if (is_single_byte) {
+        TRY(write_block_header(is_last_block, to_underlying(BlockType::RLE), length));
+        TRY(m_output_stream->write_value<u8>(block[0]));
+    } else {
+        // The block is compressed on the side, so that it can be stored uncompressed instead if that's smaller.
+        auto repeat_offsets = m_repeat_offsets;
+        m_sequences.clear_with_capacity();
+        m_literals.clear();
+        m_compressed_block.clear();
+        TRY(find_sequences(start, length, repeat_offsets));
+        TRY(encode_literals_section(m_literals));
+        TRY(encode_sequences_section());
+
+        if (m_compressed_block.size() < length) {
+            TRY(write_block_header(is_last_block, to_underlying(BlockType::Compressed), m_compressed_block.size()));
+            TRY(m_output_stream->write_until_depleted(m_compressed_block));
+            m_repeat_offsets = repeat_offsets;
+        } else {
+            TRY(write_block_header(is_last_block, to_underlying(BlockType::Raw), length));
+            TRY(m_output_stream->write_until_depleted(block));
+        }
+    }
+
+    // Only keep as much history as the window can reach, but move it down only every so often.
+    m_pending_offset = m_buffer.size();
+    if (m_pending_offset > 2 * m_window_size) {
+        auto discarded_size = m_pending_offset - m_window_size;
+        __builtin_memmove(m_buffer.data(), m_buffer.data() + discarded_size, m_window_size);
+        m_buffer.resize(m_window_size);
+        m_buffer_offset += discarded_size;
+        m_pending_offset = m_window_size;
+    }
+
+    return {};
+}
+
+ErrorOr<void> ZstdCompressor::final_flush()
+{
+    VERIFY(!m_finished);
+    m_finished = true;
+    TRY(compress_block(true));
+
+    // 3.1.1. Content_Checksum
+    TRY(m_output_stream->write_value<LittleEndian<u32>>(static_cast<u32>(m_checksum.digest())));
+    return {};
+}
+
+ErrorOr<ByteBuffer> ZstdCompressor::compress_all(ReadonlyBytes bytes, u8 level)
+{
+    u8 window_log = level_parameters[level - min_level].window_log;
+    while (window_log > min_window_log && (1u << (window_log - 1)) >= bytes.size())
+        window_log--;
+
+    auto output_stream = TRY(try_make<AllocatingMemoryStream>());
+    auto zstd_stream = TRY(ZstdCompressor::construct(MaybeOwned<Stream>(*output_stream), level, window_log));
+
+    TRY(zstd_stream->write_until_depleted(bytes));
+    TRY(zstd_stream->final_flush());
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(output_stream->used_buffer_size()));
+    TRY(output_stream->read_until_filled(buffer));
+
+    return buffer;
+}
+
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/FixedArray.h>
+#include <AK/MaybeOwned.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Stream.h>
+#include <AK/Vector.h>
+#include <LibCrypto/Checksum/XXHash64.h>
+
+namespace Compress {
+
+// This implementation is based on RFC 8878, "Zstandard Compression and the 'application/zstd' Media Type":
+// https://datatracker.ietf.org/doc/html/rfc8878
+
+// 3.1.1.3.2.1.1. Sequence Codes for Lengths and Offsets, and 4.1. FSE
+struct ZstdFseDecodingTable {
+    struct Entry {
+        u16 baseline { 0 }; // Added to the bits read for the next state
+        u8 symbol { 0 };
+        u8 bit_count { 0 };
+    };
+
+    // The largest accuracy log used anywhere in the format is 9, for the literal and match length tables.
+    static constexpr u8 max_accuracy_log = 9;
+
+    bool is_valid { false };
+    u8 accuracy_log { 0 };
+    Array<Entry, 1 << max_accuracy_log> entries;
+};
+
+// 4.2. Huffman Coding
+struct ZstdHuffmanDecodingTable {
+    struct Entry {
+        u8 symbol { 0 };
+        u8 bit_count { 0 };
+    };
+
+    static constexpr u8 max_bit_count = 11;
+
+    bool is_valid { false };
+    u8 bit_count { 0 }; // The length of the longest code, which is also the number of bits that index the table
+    Array<Entry, 1 << max_bit_count> entries;
+};
+
+// The entropy tables that carry over from one compressed block to the next, or that a dictionary starts a frame with.
+struct ZstdEntropyTables {
+    ZstdHuffmanDecodingTable literals;
+    ZstdFseDecodingTable literal_lengths;
+    ZstdFseDecodingTable offsets;
+    ZstdFseDecodingTable match_lengths;
+    Array<u32, 3> repeat_offsets { 1, 4, 8 };
+};
+
+class ZstdDecompressor final : public Stream {
+public:
+    // The reference decoder refuses frames that need a larger window by default, and so do we.
+    static constexpr u64 max_window_size = 128 * MiB;
+
+    // 5. Dictionary Format
+    static constexpr u32 dictionary_magic = 0xEC30A437;
+
+    // The dictionary is either a formatted dictionary with entropy tables, or raw content to back-reference.
+    static ErrorOr<NonnullOwnPtr<ZstdDecompressor>> create(MaybeOwned<Stream>, ReadonlyBytes dictionary = {});
+    static ErrorOr<ByteBuffer> decompress_all(ReadonlyBytes, ReadonlyBytes dictionary = {});
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+
+private:
+    // 3.1.1.1. Frame Header
+    struct FrameHeader {
+        u64 window_size { 0 };
+        Optional<u64> content_size;
+        u32 dictionary_id { 0 };
+        bool has_checksum { false };
+    };
+
+    ZstdDecompressor(MaybeOwned<Stream>, NonnullOwnPtr<ZstdEntropyTables> dictionary_tables, NonnullOwnPtr<ZstdEntropyTables> tables);
+
+    ErrorOr<void> load_dictionary(ReadonlyBytes);
+
+    // Returns false if the stream ended cleanly before a frame.
+    ErrorOr<bool> read_frame_header();
+    ErrorOr<void> read_block();
+    ErrorOr<void> finish_frame();
+
+    ErrorOr<void> make_room_for_block();
+    ErrorOr<void> decompress_block(ReadonlyBytes);
+    ErrorOr<ReadonlyBytes> decode_literals_section(ReadonlyBytes&);
+    ErrorOr<void> decode_sequences_section(ReadonlyBytes, ReadonlyBytes literals);
+    ErrorOr<void> copy_match(size_t offset, size_t length);
+
+    MaybeOwned<Stream> m_stream;
+    bool m_reached_end { false };
+
+    u32 m_dictionary_id { 0 };
+    ByteBuffer m_dictionary_content;
+    NonnullOwnPtr<ZstdEntropyTables> m_dictionary_tables;
+
+    bool m_in_frame { false };
+    FrameHeader m_frame_header;
+    size_t m_max_block_size { 0 };
+    u64 m_frame_output_size { 0 };
+    Crypto::Checksum::XXHash64 m_checksum;
+    NonnullOwnPtr<ZstdEntropyTables> m_tables;
+
+    ByteBuffer m_block;
+    ByteBuffer m_literals;
+
+    // Holds the dictionary content and the back-referencable output of the current frame, followed by output
+    // that hasn't been read yet. It is only compacted between blocks, so that matches are plain memory copies.
+    ByteBuffer m_history;
+    size_t m_history_size { 0 };
+    size_t m_output_offset { 0 };
+};
+
+class ZstdCompressor final : public Stream {
+public:
+    static constexpr u8 min_level = 1;
+    static constexpr u8 max_level = 19;
+    static constexpr u8 default_level = 3;
+
+    static constexpr u8 min_window_log = 10;
+    static constexpr u8 max_window_log = 27;
+
+    // 3.1.1.2.3. Block_Content and Block_Maximum_Size
+    static constexpr size_t max_block_size = 128 * KiB;
+
+    // Without a window size, the one for the compression level is used.
+    static ErrorOr<NonnullOwnPtr<ZstdCompressor>> construct(MaybeOwned<Stream>, u8 level = default_level, Optional<u8> window_log = {});
+    ~ZstdCompressor();
+
+    virtual ErrorOr<Bytes> read_some(Bytes) override;
+    virtual ErrorOr<size_t> write_some(ReadonlyBytes) override;
+    virtual bool is_eof() const override;
+    virtual bool is_open() const override;
+    virtual void close() override;
+    ErrorOr<void> final_flush();
+
+    // Uses the smallest window that covers the input, so that decompressors can get away with less memory.
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes, u8 level = default_level);
+
+private:
+    struct LevelParameters {
+        u8 window_log;
+        size_t max_chain_length;  // We only check the max_chain_length closest matches with the same hash
+        size_t nice_match_length; // Once we find a match at least this long, we stop looking for longer ones
+        bool lazy_matching;       // Whether to defer a match when the next position has a better one
+    };
+
+    static constexpr LevelParameters level_parameters[] = {
+        { 19, 1, 16, false },
+        { 20, 2, 24, false },
+        { 21, 4, 32, false },
+        { 21, 8, 32, false },
+        { 21, 8, 48, true },
+        { 21, 16, 64, true },
+        { 22, 16, 64, true },
+        { 22, 32, 96, true },
+        { 22, 48, 128, true },
+        { 22, 64, 128, true },
+        { 22, 96, 192, true },
+        { 23, 128, 256, true },
+        { 23, 192, 256, true },
+        { 23, 256, 384, true },
+        { 23, 384, 512, true },
+        { 23, 512, 768, true },
+        { 23, 1024, 1024, true },
+        { 23, 2048, 2048, true },
+        { 23, 4096, 4096, true },
+    };
+    static_assert(array_size(level_parameters) == max_level - min_level + 1);
+
+    static constexpr size_t hash_bits = 17;
+    static constexpr size_t min_match_length = 4;
+
+    struct Match {
+        size_t length { 0 };
+        size_t offset { 0 };
+        size_t score { 0 };
+    };
+
+    struct Sequence {
+        u32 literal_length;
+        u32 match_length;
+        u32 offset_value; // The offset plus 3, or 1 to 3 for a repeat offset
+    };
+
+    ZstdCompressor(MaybeOwned<Stream>, LevelParameters, u8 window_log, FixedArray<u32> hash_head, FixedArray<u32> hash_chain);
+
+    void insert_hash(size_t position);
+    size_t match_length_at(size_t position, size_t offset, size_t max_length) const;
+    Match find_best_match(size_t position, size_t max_length, size_t literal_length, Array<u32, 3> const& repeat_offsets) const;
+    ErrorOr<void> find_sequences(size_t start, size_t length, Array<u32, 3>& repeat_offsets);
+
+    ErrorOr<void> encode_literals_section(ReadonlyBytes literals);
+    ErrorOr<void> encode_sequences_section();
+    ErrorOr<void> compress_block(bool is_last_block);
+    ErrorOr<void> write_block_header(bool is_last_block, u8 block_type, size_t block_size);
+
+    bool m_finished { false };
+    LevelParameters m_parameters;
+    u8 m_window_log;
+    size_t m_window_size;
+    size_t m_block_size; // "Block_Maximum_Size is the smallest of Window_Size and 128 KiB."
+    MaybeOwned<Stream> m_output_stream;
+    Crypto::Checksum::XXHash64 m_checksum;
+
+    // Holds up to m_window_size bytes of already compressed history, followed by the pending input.
+    ByteBuffer m_buffer;
+    u64 m_buffer_offset { 0 }; // The position of the start of m_buffer in the uncompressed stream
+    size_t m_pending_offset { 0 };
+
+    // Hash chains of stream positions, truncated to 32 bits. Candidates are always verified against the data,
+    // so a stale or wrapped-around position can only cost time.
+    FixedArray<u32> m_hash_head;
+    FixedArray<u32> m_hash_chain;
+
+    // The repeat offsets, as tracked by the decompressor.
+    Array<u32, 3> m_repeat_offsets { 1, 4, 8 };
+
+    // Scratch space for the block that is currently being compressed.
+    Vector<Sequence> m_sequences;
+    ByteBuffer m_literals;
+    ByteBuffer m_compressed_block;
+};
+
+}
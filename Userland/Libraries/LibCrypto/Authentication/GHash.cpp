@@ -9,6 +9,12 @@
 #include <AK/Types.h>
 #include <LibCrypto/Authentication/GHash.h>
 
+#if ARCH(X86_64)
+#    define GHASH_HAS_PCLMULQDQ_IMPLEMENTATION
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace {
 
 static u32 to_u32(u8 const* b)
@@ -23,35 +29,155 @@ static void to_u8s(u8* b, u32 const* w)
     }
 }
 
+static void ghash_update(u32 (&tag)[4], u32 const (&key)[4], ReadonlyBytes buf)
+{
+    size_t i = 0;
+    for (; i < buf.size(); i += 16) {
+        if (i + 16 <= buf.size()) {
+            for (auto j = 0; j < 4; ++j) {
+                tag[j] ^= to_u32(buf.offset(i + j * 4));
+            }
+            Crypto::Authentication::galois_multiply(tag, key, tag);
+        }
+    }
+
+    if (i > buf.size()) {
+        u8 buffer[16] = {};
+        Bytes buffer_bytes { buffer, 16 };
+        buf.slice(i - 16).copy_to(buffer_bytes);
+
+        for (auto j = 0; j < 4; ++j) {
+            tag[j] ^= to_u32(buffer_bytes.offset(j * 4));
+        }
+        Crypto::Authentication::galois_multiply(tag, key, tag);
+    }
 }
 
-namespace Crypto::Authentication {
+#ifdef GHASH_HAS_PCLMULQDQ_IMPLEMENTATION
+// Carry-less multiplication in GF(2^128), following Intel's "Carry-Less Multiplication and Its Usage for Computing the GCM Mode".
+// All values are kept byte-reflected, i.e. the first byte of a block is the most significant byte of the 128-bit lane.
 
-GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
+// Computes the unreduced 256-bit product of a and b, accumulating it into low and high.
+[[gnu::target("pclmul,ssse3")]] ALWAYS_INLINE void clmul_accumulate(__m128i a, __m128i b, __m128i& low, __m128i& high)
 {
-    u32 tag[4] { 0, 0, 0, 0 };
+    auto lo = _mm_clmulepi64_si128(a, b, 0x00);
+    auto hi = _mm_clmulepi64_si128(a, b, 0x11);
+    auto mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
 
-    auto transform_one = [&](auto& buf) {
-        size_t i = 0;
-        for (; i < buf.size(); i += 16) {
-            if (i + 16 <= buf.size()) {
-                for (auto j = 0; j < 4; ++j) {
-                    tag[j] ^= to_u32(buf.offset(i + j * 4));
-                }
-                galois_multiply(tag, m_key, tag);
-            }
+    low = _mm_xor_si128(low, _mm_xor_si128(lo, _mm_slli_si128(mid, 8)));
+    high = _mm_xor_si128(high, _mm_xor_si128(hi, _mm_srli_si128(mid, 8)));
+}
+
+// Reduces a 256-bit product modulo x^128 + x^7 + x^2 + x + 1, taking the bit-reflection of GCM into account.
+[[gnu::target("pclmul,ssse3")]] ALWAYS_INLINE __m128i reduce(__m128i low, __m128i high)
+{
+    // Shift the 256-bit product left by one bit.
+    auto low_carry = _mm_srli_epi32(low, 31);
+    auto high_carry = _mm_srli_epi32(high, 31);
+    low = _mm_slli_epi32(low, 1);
+    high = _mm_slli_epi32(high, 1);
+
+    auto carry_into_high = _mm_srli_si128(low_carry, 12);
+    high_carry = _mm_slli_si128(high_carry, 4);
+    low_carry = _mm_slli_si128(low_carry, 4);
+    low = _mm_or_si128(low, low_carry);
+    high = _mm_or_si128(high, high_carry);
+    high = _mm_or_si128(high, carry_into_high);
+
+    // First phase of the reduction.
+    auto a = _mm_slli_epi32(low, 31);
+    auto b = _mm_slli_epi32(low, 30);
+    auto c = _mm_slli_epi32(low, 25);
+    a = _mm_xor_si128(a, b);
+    a = _mm_xor_si128(a, c);
+    b = _mm_srli_si128(a, 4);
+    a = _mm_slli_si128(a, 12);
+    low = _mm_xor_si128(low, a);
+
+    // Second phase of the reduction.
+    auto d = _mm_srli_epi32(low, 1);
+    auto e = _mm_srli_epi32(low, 2);
+    auto f = _mm_srli_epi32(low, 7);
+    d = _mm_xor_si128(d, e);
+    d = _mm_xor_si128(d, f);
+    d = _mm_xor_si128(d, b);
+    low = _mm_xor_si128(low, d);
+
+    return _mm_xor_si128(high, low);
+}
+
+[[gnu::target("pclmul,ssse3")]] ALWAYS_INLINE __m128i multiply(__m128i a, __m128i b)
+{
+    auto low = _mm_setzero_si128();
+    auto high = _mm_setzero_si128();
+    clmul_accumulate(a, b, low, high);
+    return reduce(low, high);
+}
+
+[[gnu::target("pclmul,ssse3")]] ALWAYS_INLINE __m128i load_block(u8 const* data)
+{
+    auto const byte_reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data)), byte_reverse);
+}
+
+[[gnu::target("pclmul,ssse3")]] void ghash_update_pclmulqdq(u32 (&tag)[4], u32 const (&key)[4], ReadonlyBytes buf)
+{
+    auto h = _mm_set_epi32(key[0], key[1], key[2], key[3]);
+    auto y = _mm_set_epi32(tag[0], tag[1], tag[2], tag[3]);
+
+    size_t offset = 0;
+
+    // Aggregated reduction: Y' = (Y ^ X1) * H^4 ^ X2 * H^3 ^ X3 * H^2 ^ X4 * H, which needs only one reduction per four blocks.
+    if (buf.size() >= 4 * 16) {
+        auto h2 = multiply(h, h);
+        auto h3 = multiply(h2, h);
+        auto h4 = multiply(h3, h);
+
+        for (; offset + 4 * 16 <= buf.size(); offset += 4 * 16) {
+            auto low = _mm_setzero_si128();
+            auto high = _mm_setzero_si128();
+            clmul_accumulate(_mm_xor_si128(y, load_block(buf.offset(offset))), h4, low, high);
+            clmul_accumulate(load_block(buf.offset(offset + 16)), h3, low, high);
+            clmul_accumulate(load_block(buf.offset(offset + 32)), h2, low, high);
+            clmul_accumulate(load_block(buf.offset(offset + 48)), h, low, high);
+            y = reduce(low, high);
         }
+    }
 
-        if (i > buf.size()) {
-            u8 buffer[16] = {};
-            Bytes buffer_bytes { buffer, 16 };
-            buf.slice(i - 16).copy_to(buffer_bytes);
+    for (; offset + 16 <= buf.size(); offset += 16)
+        y = multiply(_mm_xor_si128(y, load_block(buf.offset(offset))), h);
 
-            for (auto j = 0; j < 4; ++j) {
-                tag[j] ^= to_u32(buffer_bytes.offset(j * 4));
-            }
-            galois_multiply(tag, m_key, tag);
+    if (offset < buf.size()) {
+        u8 buffer[16] = {};
+        buf.slice(offset).copy_to(Bytes { buffer, 16 });
+        y = multiply(_mm_xor_si128(y, load_block(buffer)), h);
+    }
+
+    alignas(16) u32 words[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(words), y);
+    tag[0] = words[3];
+    tag[1] = words[2];
+    tag[2] = words[1];
+    tag[3] = words[0];
+}
+#endif
+
+}
+
+namespace Crypto::Authentication {
+
+GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
+{
+    u32 tag[4] { 0, 0, 0, 0 };
+
+    auto transform_one = [&](ReadonlyBytes buf) {
+#ifdef GHASH_HAS_PCLMULQDQ_IMPLEMENTATION
+        if (cpu_features().has_pclmulqdq && cpu_features().has_ssse3) {
+            ghash_update_pclmulqdq(tag, m_key, buf);
+            return;
         }
+#endif
+        ghash_update(tag, m_key, buf);
     };
 
     transform_one(aad);
@@ -69,14 +195,10 @@ GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
         dbgln("Tag bits: {} : {} : {} : {}", tag[0], tag[1], tag[2], tag[3]);
     }
 
-    tag[0] ^= high(aad_bits);
-    tag[1] ^= low(aad_bits);
-    tag[2] ^= high(cipher_bits);
-    tag[3] ^= low(cipher_bits);
-
-    dbgln_if(GHASH_PROCESS_DEBUG, "Tag bits: {} : {} : {} : {}", tag[0], tag[1], tag[2], tag[3]);
-
-    galois_multiply(tag, m_key, tag);
+    u8 length_block[16];
+    ByteReader::store(length_block, AK::convert_between_host_and_big_endian(aad_bits));
+    ByteReader::store(length_block + 8, AK::convert_between_host_and_big_endian(cipher_bits));
+    transform_one({ length_block, sizeof(length_block) });
 
     TagType digest;
     to_u8s(digest.data, tag);
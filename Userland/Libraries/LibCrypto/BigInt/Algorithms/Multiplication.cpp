@@ -9,38 +9,202 @@
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = u64;
+static_assert(sizeof(DoubleWord) == 2 * sizeof(Word));
+
+// Below this many words, the O(N^2) schoolbook multiplication beats Karatsuba's extra additions.
+static constexpr size_t karatsuba_threshold = 40;
+
+/**
+ * Computes result = left * right, where result has room for left_size + right_size words.
+ */
+static void schoolbook_multiply(Word const* left, size_t left_size, Word const* right, size_t right_size, Word* result)
+{
+    __builtin_memset(result, 0, (left_size + right_size) * sizeof(Word));
+    for (size_t i = 0; i < left_size; ++i) {
+        DoubleWord left_word = left[i];
+        DoubleWord carry = 0;
+        for (size_t j = 0; j < right_size; ++j) {
+            carry += left_word * right[j] + result[i + j];
+            result[i + j] = static_cast<Word>(carry);
+            carry >>= UnsignedBigInteger::BITS_IN_WORD;
+        }
+        result[i + right_size] = static_cast<Word>(carry);
+    }
+}
+
+/**
+ * Computes accumulator += value, where value_size <= accumulator_size, and returns the carry out of the accumulator.
+ */
+static Word add_in_place(Word* accumulator, size_t accumulator_size, Word const* value, size_t value_size)
+{
+    DoubleWord carry = 0;
+    size_t i = 0;
+    for (; i < value_size; ++i) {
+        carry += static_cast<DoubleWord>(accumulator[i]) + value[i];
+        accumulator[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    for (; carry != 0 && i < accumulator_size; ++i) {
+        carry += accumulator[i];
+        accumulator[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    return static_cast<Word>(carry);
+}
+
+/**
+ * Computes accumulator -= value, where value_size <= accumulator_size, and returns the borrow out of the accumulator.
+ */
+static Word subtract_in_place(Word* accumulator, size_t accumulator_size, Word const* value, size_t value_size)
+{
+    Word borrow = 0;
+    size_t i = 0;
+    for (; i < value_size; ++i) {
+        auto difference = static_cast<DoubleWord>(accumulator[i]) - value[i] - borrow;
+        accumulator[i] = static_cast<Word>(difference);
+        borrow = static_cast<Word>(difference >> (2 * UnsignedBigInteger::BITS_IN_WORD - 1));
+    }
+    for (; borrow != 0 && i < accumulator_size; ++i) {
+        borrow = accumulator[i] == 0 ? 1 : 0;
+        --accumulator[i];
+    }
+    return borrow;
+}
+
+static size_t karatsuba_scratch_size(size_t size)
+{
+    size_t scratch_size = 0;
+    while (size >= karatsuba_threshold) {
+        auto high_size = size - size / 2;
+        scratch_size += 4 * (high_size + 1);
+        size = high_size + 1;
+    }
+    return scratch_size;
+}
+
+/**
+ * Computes result = left * right for two numbers of the same size, where result has room for 2 * size words.
+ * Splitting each operand into halves, left = l1 * B + l0 and right = r1 * B + r0, the product is
+ *     l1 * r1 * B^2 + ((l0 + l1) * (r0 + r1) - l0 * r0 - l1 * r1) * B + l0 * r0,
+ * which only needs three half-sized multiplications instead of four.
+ * `scratch` must have room for karatsuba_scratch_size(size) words.
+ */
+static void karatsuba_multiply(Word const* left, Word const* right, size_t size, Word* result, Word* scratch)
+{
+    if (size < karatsuba_threshold) {
+        schoolbook_multiply(left, size, right, size, result);
+        return;
+    }
+
+    auto low_size = size / 2;
+    auto high_size = size - low_size;
+    auto sum_size = high_size + 1;
+
+    // result = (l1 * r1) * B^2 + l0 * r0
+    karatsuba_multiply(left, right, low_size, result, scratch);
+    karatsuba_multiply(left + low_size, right + low_size, high_size, result + 2 * low_size, scratch);
+
+    auto* left_sum = scratch;
+    auto* right_sum = left_sum + sum_size;
+    auto* middle = right_sum + sum_size;
+    auto* next_scratch = middle + 2 * sum_size;
+
+    __builtin_memcpy(left_sum, left + low_size, high_size * sizeof(Word));
+    left_sum[high_size] = add_in_place(left_sum, high_size, left, low_size);
+    __builtin_memcpy(right_sum, right + low_size, high_size * sizeof(Word));
+    right_sum[high_size] = add_in_place(right_sum, high_size, right, low_size);
+
+    karatsuba_multiply(left_sum, right_sum, sum_size, middle, next_scratch);
+    subtract_in_place(middle, 2 * sum_size, result, 2 * low_size);
+    subtract_in_place(middle, 2 * sum_size, result + 2 * low_size, 2 * high_size);
+
+    // What is left in `middle` is l0 * r1 + l1 * r0, which is short enough that its top words are zero.
+    auto carry = add_in_place(result + low_size, 2 * size - low_size, middle, min(2 * sum_size, 2 * size - low_size));
+    VERIFY(carry == 0);
+}
+
+static size_t multiplication_scratch_size(size_t longer_size, size_t shorter_size)
+{
+    if (shorter_size < karatsuba_threshold)
+        return 0;
+    if (longer_size == shorter_size)
+        return karatsuba_scratch_size(shorter_size);
+
+    auto nested_size = karatsuba_scratch_size(shorter_size);
+    if (auto remainder_size = longer_size % shorter_size; remainder_size != 0)
+        nested_size = max(nested_size, multiplication_scratch_size(shorter_size, remainder_size));
+    return 2 * shorter_size + nested_size;
+}
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Computes result = longer * shorter, where result has room for longer_size + shorter_size words.
+ * If the operands differ in size, the longer one is cut into pieces the size of the shorter one.
+ * `scratch` must have room for multiplication_scratch_size(longer_size, shorter_size) words.
+ */
+static void multiply(Word const* longer, size_t longer_size, Word const* shorter, size_t shorter_size, Word* result, Word* scratch)
+{
+    if (shorter_size < karatsuba_threshold) {
+        schoolbook_multiply(longer, longer_size, shorter, shorter_size, result);
+        return;
+    }
+
+    if (longer_size == shorter_size) {
+        karatsuba_multiply(longer, shorter, shorter_size, result, scratch);
+        return;
+    }
+
+    auto* piece_product = scratch;
+    auto* nested_scratch = scratch + 2 * shorter_size;
+    auto result_size = longer_size + shorter_size;
+    __builtin_memset(result, 0, result_size * sizeof(Word));
+
+    size_t offset = 0;
+    for (; offset + shorter_size <= longer_size; offset += shorter_size) {
+        karatsuba_multiply(longer + offset, shorter, shorter_size, piece_product, nested_scratch);
+        add_in_place(result + offset, result_size - offset, piece_product, 2 * shorter_size);
+    }
+
+    if (auto remainder_size = longer_size - offset; remainder_size != 0) {
+        multiply(shorter, shorter_size, longer + offset, remainder_size, piece_product, nested_scratch);
+        add_in_place(result + offset, result_size - offset, piece_product, shorter_size + remainder_size);
+    }
+}
+
+/**
+ * Complexity: O(N^2) where N is the number of words in the larger number, and O(N^log2(3)) once both numbers are
+ * longer than karatsuba_threshold words.
  * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indices of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * Word-by-word schoolbook multiplication for small numbers, Karatsuba multiplication for large ones.
+ * temp_scratch is used as scratch space for the Karatsuba multiplication.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger const& left,
     UnsignedBigInteger const& right,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
+    UnsignedBigInteger& temp_scratch,
     UnsignedBigInteger& output)
 {
-    output.set_to_0();
+    VERIFY(&output != &left && &output != &right);
 
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
+    auto const* longer = &left;
+    auto const* shorter = &right;
+    if (longer->trimmed_length() < shorter->trimmed_length())
+        swap(longer, shorter);
 
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
+    auto longer_size = longer->trimmed_length();
+    auto shorter_size = shorter->trimmed_length();
 
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_into_accumulator_without_allocation(output, temp_shift);
-        }
-    }
+    output.set_to_0();
+    if (shorter_size == 0)
+        return;
+
+    output.m_words.resize_and_keep_capacity(longer_size + shorter_size);
+    temp_scratch.set_to_0();
+    temp_scratch.m_words.resize_and_keep_capacity(multiplication_scratch_size(longer_size, shorter_size));
+
+    multiply(longer->m_words.data(), longer_size, shorter->m_words.data(), shorter_size, output.m_words.data(), temp_scratch.m_words.data());
+    output.clamp_to_trimmed_length();
 }
 
 }
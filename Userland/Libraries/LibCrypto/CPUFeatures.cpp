@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
+
+#if ARCH(X86_64)
+#    include <cpuid.h>
+#endif
+
+namespace Crypto {
+
+#if ARCH(X86_64)
+// cpuid[eax = 1].ecx
+constexpr u32 cpuid_1_ecx_bit_pclmulqdq = 1 << 1;
+constexpr u32 cpuid_1_ecx_bit_ssse3 = 1 << 9;
+constexpr u32 cpuid_1_ecx_bit_sse41 = 1 << 19;
+constexpr u32 cpuid_1_ecx_bit_aes = 1 << 25;
+constexpr u32 cpuid_1_ecx_bit_osxsave = 1 << 27;
+constexpr u32 cpuid_1_ecx_bit_avx = 1 << 28;
+
+// cpuid[eax = 7].ebx
+constexpr u32 cpuid_7_ebx_bit_avx2 = 1 << 5;
+constexpr u32 cpuid_7_ebx_bit_sha = 1 << 29;
+
+// XCR0 bits that have to be set for the OS to save the YMM registers on context switches.
+constexpr u32 xcr0_sse_and_avx_state = 0b110;
+
+static CPUFeatures detect_cpu_features()
+{
+    CPUFeatures features;
+    u32 eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return features;
+
+    features.has_pclmulqdq = ecx & cpuid_1_ecx_bit_pclmulqdq;
+    features.has_ssse3 = ecx & cpuid_1_ecx_bit_ssse3;
+    features.has_sse41 = ecx & cpuid_1_ecx_bit_sse41;
+    features.has_aes = ecx & cpuid_1_ecx_bit_aes;
+
+    bool os_saves_avx_state = false;
+    if ((ecx & cpuid_1_ecx_bit_osxsave) && (ecx & cpuid_1_ecx_bit_avx)) {
+        u32 xcr0_low, xcr0_high;
+        asm volatile("xgetbv"
+                     : "=a"(xcr0_low), "=d"(xcr0_high)
+                     : "c"(0));
+        os_saves_avx_state = (xcr0_low & xcr0_sse_and_avx_state) == xcr0_sse_and_avx_state;
+    }
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        features.has_avx2 = os_saves_avx_state && (ebx & cpuid_7_ebx_bit_avx2);
+        features.has_sha = ebx & cpuid_7_ebx_bit_sha;
+    }
+
+    return features;
+}
+#else
+static CPUFeatures detect_cpu_features()
+{
+    return {};
+}
+#endif
+
+CPUFeatures const& cpu_features()
+{
+    static CPUFeatures const s_features = detect_cpu_features();
+    return s_features;
+}
+
+}
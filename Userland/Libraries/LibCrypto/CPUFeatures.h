@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Platform.h>
+
+namespace Crypto {
+
+// Instruction set extensions that the hardware-accelerated primitives in LibCrypto can make use of.
+// These are queried once at runtime, so the same binary runs on CPUs that lack them.
+struct CPUFeatures {
+    bool has_ssse3 { false };
+    bool has_sse41 { false };
+    bool has_avx2 { false };
+    bool has_aes { false };
+    bool has_pclmulqdq { false };
+    bool has_sha { false };
+};
+
+CPUFeatures const& cpu_features();
+
+}
@@ -8,14 +8,116 @@
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
+#if ARCH(X86_64)
+#    define ADLER32_HAS_SSSE3_IMPLEMENTATION
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Checksum {
 
+static constexpr u32 adler_modulus = 65521;
+
+// The largest number of bytes that can be summed before the 32-bit `b` accumulator could overflow,
+// i.e. the largest n such that 255 * n * (n + 1) / 2 + (n + 1) * (adler_modulus - 1) fits into a u32.
+static constexpr size_t max_bytes_between_reductions = 5552;
+
+static void update_scalar(u32& a, u32& b, u8 const* data, size_t size)
+{
+    while (size > 0) {
+        auto chunk_size = min(size, max_bytes_between_reductions);
+        size -= chunk_size;
+
+        for (; chunk_size >= 8; chunk_size -= 8, data += 8) {
+            a += data[0];
+            b += a;
+            a += data[1];
+            b += a;
+            a += data[2];
+            b += a;
+            a += data[3];
+            b += a;
+            a += data[4];
+            b += a;
+            a += data[5];
+            b += a;
+            a += data[6];
+            b += a;
+            a += data[7];
+            b += a;
+        }
+        for (; chunk_size > 0; --chunk_size, ++data) {
+            a += *data;
+            b += a;
+        }
+
+        a %= adler_modulus;
+        b %= adler_modulus;
+    }
+}
+
+#ifdef ADLER32_HAS_SSSE3_IMPLEMENTATION
+static constexpr size_t ssse3_block_size = 32;
+
+[[gnu::target("ssse3")]] ALWAYS_INLINE static u32 horizontal_sum(__m128i value)
+{
+    value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+    value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<u32>(_mm_cvtsi128_si32(value));
+}
+
+// Consumes a multiple of 32 bytes. Per block, `a` grows by the byte sum (computed with PSADBW) and `b` grows by
+// 32 times the previous `a` plus the byte sum weighted 32, 31, ..., 1 (computed with PMADDUBSW).
+[[gnu::target("ssse3")]] static void update_ssse3(u32& a, u32& b, u8 const* data, size_t block_count)
+{
+    auto const weights_low = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    auto const weights_high = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    auto const ones = _mm_set1_epi16(1);
+    auto const zero = _mm_setzero_si128();
+
+    while (block_count > 0) {
+        auto chunk_block_count = min(block_count, max_bytes_between_reductions / ssse3_block_size);
+        block_count -= chunk_block_count;
+
+        // Sum of the `a` values at the start of each block; multiplied by the block size at the end.
+        auto previous_a_sum = _mm_cvtsi32_si128(static_cast<int>(a * chunk_block_count));
+        auto a_sum = _mm_setzero_si128();
+        auto b_sum = _mm_cvtsi32_si128(static_cast<int>(b));
+
+        for (size_t i = 0; i < chunk_block_count; ++i, data += ssse3_block_size) {
+            auto low = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data));
+            auto high = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16));
+
+            previous_a_sum = _mm_add_epi32(previous_a_sum, a_sum);
+            a_sum = _mm_add_epi32(a_sum, _mm_sad_epu8(low, zero));
+            a_sum = _mm_add_epi32(a_sum, _mm_sad_epu8(high, zero));
+            b_sum = _mm_add_epi32(b_sum, _mm_madd_epi16(_mm_maddubs_epi16(low, weights_low), ones));
+            b_sum = _mm_add_epi32(b_sum, _mm_madd_epi16(_mm_maddubs_epi16(high, weights_high), ones));
+        }
+
+        b_sum = _mm_add_epi32(b_sum, _mm_slli_epi32(previous_a_sum, 5));
+
+        a = (a + horizontal_sum(a_sum)) % adler_modulus;
+        b = horizontal_sum(b_sum) % adler_modulus;
+    }
+}
+#endif
+
 void Adler32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state_a = (m_state_a + data.at(i)) % 65521;
-        m_state_b = (m_state_b + m_state_a) % 65521;
+    auto const* bytes = data.data();
+    auto size = data.size();
+
+#ifdef ADLER32_HAS_SSSE3_IMPLEMENTATION
+    if (size >= ssse3_block_size && cpu_features().has_ssse3) {
+        auto block_count = size / ssse3_block_size;
+        update_ssse3(m_state_a, m_state_b, bytes, block_count);
+        bytes += block_count * ssse3_block_size;
+        size -= block_count * ssse3_block_size;
     }
+#endif
+
+    update_scalar(m_state_a, m_state_b, bytes, size);
 }
 
 u32 Adler32::digest()
@@ -23,4 +125,19 @@ u32 Adler32::digest()
     return (m_state_b << 16) | m_state_a;
 }
 
+u32 Adler32::combine(u32 first_digest, u32 second_digest, u64 second_length)
+{
+    // Appending n bytes to a sequence whose sum is a1 adds n * a1 to the second sum, so both sums can be combined
+    // directly: a = a1 + a2 - 1 and b = b1 + b2 + n * (a1 - 1), all modulo adler_modulus.
+    u64 length = second_length % adler_modulus;
+    u64 first_a = first_digest & 0xffff;
+    u64 first_b = first_digest >> 16;
+    u64 second_a = second_digest & 0xffff;
+    u64 second_b = second_digest >> 16;
+
+    auto a = (first_a + second_a + adler_modulus - 1) % adler_modulus;
+    auto b = (first_b + second_b + length * first_a + adler_modulus - length) % adler_modulus;
+    return static_cast<u32>((b << 16) | a);
+}
+
 }
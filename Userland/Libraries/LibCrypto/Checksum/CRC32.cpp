@@ -10,8 +10,16 @@
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
+#if ARCH(X86_64)
+#    define CRC32_HAS_PCLMULQDQ_IMPLEMENTATION
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Checksum {
 
+static constexpr u32 ethernet_polynomial = 0xEDB88320;
+
 #if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
 
 void CRC32::update(ReadonlyBytes span)
@@ -28,7 +36,17 @@ void CRC32::update(ReadonlyBytes span)
         --size;
     }
 
+    // Unroll so that the loop overhead doesn't dominate the CRC instructions themselves.
     auto* data64 = reinterpret_cast<u64 const*>(data);
+    while (size >= 32) {
+        m_state = __builtin_arm_crc32d(m_state, data64[0]);
+        m_state = __builtin_arm_crc32d(m_state, data64[1]);
+        m_state = __builtin_arm_crc32d(m_state, data64[2]);
+        m_state = __builtin_arm_crc32d(m_state, data64[3]);
+        data64 += 4;
+        size -= 32;
+    }
+
     while (size >= 8) {
         m_state = __builtin_arm_crc32d(m_state, *data64);
         ++data64;
@@ -43,20 +61,18 @@ void CRC32::update(ReadonlyBytes span)
     }
 }
 
-// FIXME: On Intel, use _mm_crc32_u8 / _mm_crc32_u64 if available (SSE 4.2).
-
 #else
 
-static constexpr size_t ethernet_polynomial = 0xEDB88320;
-
 #    if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
 
-// This implements Intel's slicing-by-8 algorithm. Their original paper is no longer on their website,
-// but their source code is still available for reference:
+// This implements the slicing-by-16 extension of Intel's slicing-by-8 algorithm. Their original paper is no
+// longer on their website, but their source code is still available for reference:
 // https://sourceforge.net/projects/slicing-by-8/
+static constexpr size_t slice_count = 16;
+
 static constexpr auto generate_table()
 {
-    Array<Array<u32, 256>, 8> data {};
+    Array<Array<u32, 256>, slice_count> data {};
 
     for (u32 i = 0; i < 256; ++i) {
         auto value = i;
@@ -68,7 +84,7 @@ static constexpr auto generate_table()
     }
 
     for (u32 i = 0; i < 256; ++i) {
-        for (size_t j = 1; j < 8; ++j)
+        for (size_t j = 1; j < slice_count; ++j)
             data[j][i] = (data[j - 1][i] >> 8) ^ data[0][data[j - 1][i] & 0xff];
     }
 
@@ -77,64 +93,138 @@ static constexpr auto generate_table()
 
 static constexpr auto table = generate_table();
 
-struct AlignmentData {
-    ReadonlyBytes misaligned;
-    ReadonlyBytes aligned;
-};
+static constexpr u32 single_byte_crc(u32 crc, u8 byte)
+{
+    return (crc >> 8) ^ table[0][(crc & 0xff) ^ byte];
+}
 
-static AlignmentData split_bytes_for_alignment(ReadonlyBytes data, size_t alignment)
+static ALWAYS_INLINE u32 load_u32(u8 const* data)
 {
-    auto address = reinterpret_cast<uintptr_t>(data.data());
-    auto offset = alignment - address % alignment;
+    u32 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return value;
+}
 
-    if (offset == alignment)
-        return { {}, data };
+static u32 update_with_tables(u32 state, ReadonlyBytes data)
+{
+    auto const* bytes = data.data();
+    auto size = data.size();
+
+    while (size >= slice_count) {
+        auto word0 = load_u32(bytes) ^ state;
+        auto word1 = load_u32(bytes + 4);
+        auto word2 = load_u32(bytes + 8);
+        auto word3 = load_u32(bytes + 12);
+
+        state = table[15][word0 & 0xff]
+            ^ table[14][(word0 >> 8) & 0xff]
+            ^ table[13][(word0 >> 16) & 0xff]
+            ^ table[12][word0 >> 24]
+            ^ table[11][word1 & 0xff]
+            ^ table[10][(word1 >> 8) & 0xff]
+            ^ table[9][(word1 >> 16) & 0xff]
+            ^ table[8][word1 >> 24]
+            ^ table[7][word2 & 0xff]
+            ^ table[6][(word2 >> 8) & 0xff]
+            ^ table[5][(word2 >> 16) & 0xff]
+            ^ table[4][word2 >> 24]
+            ^ table[3][word3 & 0xff]
+            ^ table[2][(word3 >> 8) & 0xff]
+            ^ table[1][(word3 >> 16) & 0xff]
+            ^ table[0][word3 >> 24];
+
+        bytes += slice_count;
+        size -= slice_count;
+    }
 
-    if (data.size() < alignment)
-        return { data, {} };
+    for (; size > 0; ++bytes, --size)
+        state = single_byte_crc(state, *bytes);
 
-    return { data.trim(offset), data.slice(offset) };
+    return state;
 }
 
-static constexpr u32 single_byte_crc(u32 crc, u8 byte)
+#        ifdef CRC32_HAS_PCLMULQDQ_IMPLEMENTATION
+// Folds 16-byte blocks with carry-less multiplication and finishes with a Barrett reduction, as described in
+// Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" white paper. The constants
+// are x^n mod P(x) for the bit-reflected polynomial, for the distances we fold over.
+static constexpr u64 fold_by_4_constants[2] { 0x154442bd4, 0x1c6e41596 };
+static constexpr u64 fold_by_1_constants[2] { 0x1751997d0, 0x0ccaa009e };
+static constexpr u64 fold_64_to_32_constant = 0x163cd6124;
+static constexpr u64 barrett_constants[2] { 0x1db710641, 0x1f7011641 };
+
+static constexpr size_t pclmulqdq_minimum_length = 64;
+
+[[gnu::target("pclmul")]] ALWAYS_INLINE static __m128i fold(__m128i accumulator, __m128i constants, __m128i data)
 {
-    return (crc >> 8) ^ table[0][(crc & 0xff) ^ byte];
+    auto low = _mm_clmulepi64_si128(accumulator, constants, 0x00);
+    auto high = _mm_clmulepi64_si128(accumulator, constants, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(low, high), data);
 }
 
+// Returns the CRC state after consuming `data`, whose size must be a multiple of 16 and at least 64.
+[[gnu::target("pclmul")]] static u32 update_with_pclmulqdq(u32 state, u8 const* data, size_t size)
+{
+    auto load = [](u8 const* block) { return _mm_loadu_si128(reinterpret_cast<__m128i const*>(block)); };
+
+    auto x0 = _mm_xor_si128(load(data), _mm_cvtsi32_si128(static_cast<int>(state)));
+    auto x1 = load(data + 16);
+    auto x2 = load(data + 32);
+    auto x3 = load(data + 48);
+    data += 64;
+    size -= 64;
+
+    auto constants = _mm_set_epi64x(fold_by_4_constants[1], fold_by_4_constants[0]);
+    while (size >= 64) {
+        x0 = fold(x0, constants, load(data));
+        x1 = fold(x1, constants, load(data + 16));
+        x2 = fold(x2, constants, load(data + 32));
+        x3 = fold(x3, constants, load(data + 48));
+        data += 64;
+        size -= 64;
+    }
+
+    constants = _mm_set_epi64x(fold_by_1_constants[1], fold_by_1_constants[0]);
+    x0 = fold(x0, constants, x1);
+    x0 = fold(x0, constants, x2);
+    x0 = fold(x0, constants, x3);
+
+    while (size >= 16) {
+        x0 = fold(x0, constants, load(data));
+        data += 16;
+        size -= 16;
+    }
+
+    // Fold 128 bits down to 64, which also appends the 32 zero bits that the CRC definition calls for.
+    x0 = _mm_xor_si128(_mm_srli_si128(x0, 8), _mm_clmulepi64_si128(constants, x0, 0x01));
+
+    // Fold 64 bits down to 32 + 32.
+    auto const low_32_bits = _mm_set_epi32(0, 0, 0, ~0);
+    x0 = _mm_xor_si128(_mm_srli_si128(x0, 4), _mm_clmulepi64_si128(_mm_and_si128(x0, low_32_bits), _mm_set_epi64x(0, fold_64_to_32_constant), 0x00));
+
+    // Barrett reduction of the remaining 64 bits to the final 32-bit remainder.
+    constants = _mm_set_epi64x(barrett_constants[1], barrett_constants[0]);
+    auto quotient = _mm_clmulepi64_si128(_mm_and_si128(x0, low_32_bits), constants, 0x10);
+    auto product = _mm_clmulepi64_si128(_mm_and_si128(quotient, low_32_bits), constants, 0x00);
+    return static_cast<u32>(_mm_cvtsi128_si32(_mm_srli_si128(_mm_xor_si128(x0, product), 4)));
+}
+#        endif
+
 void CRC32::update(ReadonlyBytes data)
 {
-    // The provided data may not be aligned to a 4-byte boundary, required to reinterpret its address
-    // into a u32 in the loop below. So we split the bytes into two segments: the misaligned bytes
-    // (which undergo the standard 1-byte-at-a-time algorithm) and remaining aligned bytes.
-    auto [misaligned_data, aligned_data] = split_bytes_for_alignment(data, alignof(u32));
-
-    for (auto byte : misaligned_data)
-        m_state = single_byte_crc(m_state, byte);
-
-    while (aligned_data.size() >= 8) {
-        auto const* segment = reinterpret_cast<u32 const*>(aligned_data.data());
-        auto low = *segment ^ m_state;
-        auto high = *(++segment);
-
-        m_state = table[0][(high >> 24) & 0xff]
-            ^ table[1][(high >> 16) & 0xff]
-            ^ table[2][(high >> 8) & 0xff]
-            ^ table[3][high & 0xff]
-            ^ table[4][(low >> 24) & 0xff]
-            ^ table[5][(low >> 16) & 0xff]
-            ^ table[6][(low >> 8) & 0xff]
-            ^ table[7][low & 0xff];
-
-        aligned_data = aligned_data.slice(8);
+#        ifdef CRC32_HAS_PCLMULQDQ_IMPLEMENTATION
+    if (data.size() >= pclmulqdq_minimum_length && cpu_features().has_pclmulqdq) {
+        auto folded_size = data.size() & ~static_cast<size_t>(15);
+        m_state = update_with_pclmulqdq(m_state, data.data(), folded_size);
+        data = data.slice(folded_size);
     }
+#        endif
 
-    for (auto byte : aligned_data)
-        m_state = single_byte_crc(m_state, byte);
+    m_state = update_with_tables(m_state, data);
 }
 
 #    else
 
-// FIXME: Implement the slicing-by-8 algorithm for big endian CPUs.
+// FIXME: Implement the slicing-by-16 algorithm for big endian CPUs.
 static constexpr auto generate_table()
 {
     Array<u32, 256> data {};
@@ -171,4 +261,37 @@ u32 CRC32::digest()
     return ~m_state;
 }
 
+// Multiplies two polynomials modulo the CRC polynomial, in the same bit-reflected representation as the CRC itself.
+static constexpr u32 multiply_modulo_polynomial(u32 a, u32 b)
+{
+    u32 product = 0;
+    for (u32 bit = 1u << 31; bit != 0; bit >>= 1) {
+        if (a & bit)
+            product ^= b;
+        b = (b & 1) ? (b >> 1) ^ ethernet_polynomial : b >> 1;
+    }
+    return product;
+}
+
+// x^(2^n) modulo the CRC polynomial, for n = 0 to 66, which covers shifting by any 64-bit number of bytes.
+static constexpr auto powers_of_x_table = [] {
+    Array<u32, 67> data {};
+    data[0] = 1u << 30; // x^1
+    for (size_t i = 1; i < data.size(); ++i)
+        data[i] = multiply_modulo_polynomial(data[i - 1], data[i - 1]);
+    return data;
+}();
+
+u32 CRC32::combine(u32 first_digest, u32 second_digest, u64 second_length)
+{
+    // Appending n bytes to a message multiplies its CRC by x^(8n) before the new bytes are added in, and the
+    // pre- and post-conditioning of the two CRCs cancels out, as in zlib's crc32_combine().
+    u32 shift = 1u << 31; // x^0
+    for (size_t n = 3; second_length != 0; second_length >>= 1, ++n) {
+        if (second_length & 1)
+            shift = multiply_modulo_polynomial(powers_of_x_table[n], shift);
+    }
+    return multiply_modulo_polynomial(shift, first_digest) ^ second_digest;
+}
+
 }
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <LibCrypto/Checksum/CRC64.h>
+
+namespace Crypto::Checksum {
+
+static constexpr u64 ecma_182_polynomial = 0xC96C5795D7870F42;
+
+// Slicing-by-8, like the table-driven CRC32 fallback.
+static constexpr size_t slice_count = 8;
+
+static constexpr auto generate_table()
+{
+    Array<Array<u64, 256>, slice_count> data {};
+    for (u64 i = 0; i < 256; ++i) {
+        auto value = i;
+        for (size_t j = 0; j < 8; ++j)
+            value = (value >> 1) ^ ((value & 1) * ecma_182_polynomial);
+        data[0][i] = value;
+    }
+
+    for (u64 i = 0; i < 256; ++i) {
+        for (size_t j = 1; j < slice_count; ++j)
+            data[j][i] = (data[j - 1][i] >> 8) ^ data[0][data[j - 1][i] & 0xff];
+    }
+
+    return data;
+}
+
+static constexpr auto table = generate_table();
+
+void CRC64::update(ReadonlyBytes data)
+{
+    auto const* bytes = data.data();
+    auto size = data.size();
+
+    while (size >= slice_count) {
+        u64 word = 0;
+        for (size_t i = 0; i < slice_count; ++i)
+            word |= static_cast<u64>(bytes[i]) << (i * 8);
+        word ^= m_state;
+
+        m_state = table[7][word & 0xff]
+            ^ table[6][(word >> 8) & 0xff]
+            ^ table[5][(word >> 16) & 0xff]
+            ^ table[4][(word >> 24) & 0xff]
+            ^ table[3][(word >> 32) & 0xff]
+            ^ table[2][(word >> 40) & 0xff]
+            ^ table[1][(word >> 48) & 0xff]
+            ^ table[0][word >> 56];
+
+        bytes += slice_count;
+        size -= slice_count;
+    }
+
+    for (; size > 0; ++bytes, --size)
+        m_state = (m_state >> 8) ^ table[0][(m_state & 0xff) ^ *bytes];
+}
+
+u64 CRC64::digest()
+{
+    return ~m_state;
+}
+
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <LibCrypto/Checksum/ChecksumFunction.h>
+
+namespace Crypto::Checksum {
+
+// The 64-bit CRC from ECMA-182, in the bit-reflected form that XZ uses for its Check field.
+class CRC64 : public ChecksumFunction<u64> {
+public:
+    CRC64() = default;
+    CRC64(ReadonlyBytes data)
+    {
+        update(data);
+    }
+
+    CRC64(u64 initial_state, ReadonlyBytes data)
+        : m_state(initial_state)
+    {
+        update(data);
+    }
+
+    virtual void update(ReadonlyBytes data) override;
+    virtual u64 digest() override;
+
+private:
+    u64 m_state { ~0ull };
+};
+
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Endian.h>
+#include <LibCrypto/Checksum/XXHash64.h>
+
+namespace Crypto::Checksum {
+
+static constexpr u64 prime_1 = 0x9E3779B185EBCA87;
+static constexpr u64 prime_2 = 0xC2B2AE3D27D4EB4F;
+static constexpr u64 prime_3 = 0x165667B19E3779F9;
+static constexpr u64 prime_4 = 0x85EBCA77C2B2AE63;
+static constexpr u64 prime_5 = 0x27D4EB2F165667C5;
+
+static ALWAYS_INLINE u64 rotate_left(u64 value, int count)
+{
+    return (value << count) | (value >> (64 - count));
+}
+
+static ALWAYS_INLINE u64 load_u64(u8 const* data)
+{
+    u64 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return AK::convert_between_host_and_little_endian(value);
+}
+
+static ALWAYS_INLINE u32 load_u32(u8 const* data)
+{
+    u32 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return AK::convert_between_host_and_little_endian(value);
+}
+
+static ALWAYS_INLINE u64 round(u64 accumulator, u64 lane)
+{
+    accumulator += lane * prime_2;
+    accumulator = rotate_left(accumulator, 31);
+    return accumulator * prime_1;
+}
+
+static ALWAYS_INLINE u64 merge_accumulator(u64 hash, u64 accumulator)
+{
+    hash ^= round(0, accumulator);
+    return hash * prime_1 + prime_4;
+}
+
+XXHash64::XXHash64(u64 seed)
+    : m_seed(seed)
+    , m_accumulators { seed + prime_1 + prime_2, seed + prime_2, seed, seed - prime_1 }
+{
+}
+
+void XXHash64::update(ReadonlyBytes data)
+{
+    m_total_length += data.size();
+
+    auto const* bytes = data.data();
+    auto size = data.size();
+
+    if (m_buffered_size > 0) {
+        auto count = min(size, stripe_size - m_buffered_size);
+        __builtin_memcpy(m_buffer.data() + m_buffered_size, bytes, count);
+        m_buffered_size += count;
+        bytes += count;
+        size -= count;
+        if (m_buffered_size < stripe_size)
+            return;
+
+        for (size_t i = 0; i < 4; ++i)
+            m_accumulators[i] = round(m_accumulators[i], load_u64(m_buffer.data() + i * 8));
+        m_buffered_size = 0;
+    }
+
+    // Keep the accumulators in locals so that the compiler can interleave the four independent lanes.
+    auto accumulator_1 = m_accumulators[0];
+    auto accumulator_2 = m_accumulators[1];
+    auto accumulator_3 = m_accumulators[2];
+    auto accumulator_4 = m_accumulators[3];
+    for (; size >= stripe_size; bytes += stripe_size, size -= stripe_size) {
+        accumulator_1 = round(accumulator_1, load_u64(bytes));
+        accumulator_2 = round(accumulator_2, load_u64(bytes + 8));
+        accumulator_3 = round(accumulator_3, load_u64(bytes + 16));
+        accumulator_4 = round(accumulator_4, load_u64(bytes + 24));
+    }
+    m_accumulators = { accumulator_1, accumulator_2, accumulator_3, accumulator_4 };
+
+    __builtin_memcpy(m_buffer.data(), bytes, size);
+    m_buffered_size = size;
+}
+
+u64 XXHash64::digest()
+{
+    u64 hash;
+    if (m_total_length >= stripe_size) {
+        hash = rotate_left(m_accumulators[0], 1) + rotate_left(m_accumulators[1], 7) + rotate_left(m_accumulators[2], 12) + rotate_left(m_accumulators[3], 18);
+        for (auto accumulator : m_accumulators)
+            hash = merge_accumulator(hash, accumulator);
+    } else {
+        hash = m_seed + prime_5;
+    }
+
+    hash += m_total_length;
+
+    auto const* bytes = m_buffer.data();
+    auto size = m_buffered_size;
+    for (; size >= 8; bytes += 8, size -= 8) {
+        hash ^= round(0, load_u64(bytes));
+        hash = rotate_left(hash, 27) * prime_1 + prime_4;
+    }
+    if (size >= 4) {
+        hash ^= static_cast<u64>(load_u32(bytes)) * prime_1;
+        hash = rotate_left(hash, 23) * prime_2 + prime_3;
+        bytes += 4;
+        size -= 4;
+    }
+    for (; size > 0; ++bytes, --size) {
+        hash ^= *bytes * prime_5;
+        hash = rotate_left(hash, 11) * prime_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime_2;
+    hash ^= hash >> 29;
+    hash *= prime_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+}
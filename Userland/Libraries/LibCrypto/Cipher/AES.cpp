@@ -8,8 +8,74 @@
 #include <LibCrypto/Cipher/AES.h>
 #include <LibCrypto/Cipher/AESTables.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    define AES_HAS_AESNI_IMPLEMENTATION
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Cipher {
 
+#ifdef AES_HAS_AESNI_IMPLEMENTATION
+namespace {
+
+// The round keys are stored as host-endian words (for the table-based implementation), but AES-NI wants them in byte order.
+[[gnu::target("aes,ssse3")]] ALWAYS_INLINE void load_round_keys(AESCipherKey const& key, __m128i* round_keys)
+{
+    auto const byte_swap_words = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    auto const* words = key.round_keys();
+
+    for (size_t i = 0; i <= key.rounds(); ++i)
+        round_keys[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(words + i * 4)), byte_swap_words);
+}
+
+template<size_t BlockCount>
+[[gnu::target("aes,ssse3")]] ALWAYS_INLINE void aesni_encrypt(__m128i const* round_keys, size_t rounds, u8 const* in, u8* out)
+{
+    __m128i blocks[BlockCount];
+
+    for (size_t i = 0; i < BlockCount; ++i)
+        blocks[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i * 16)), round_keys[0]);
+
+    for (size_t round = 1; round < rounds; ++round) {
+        for (size_t i = 0; i < BlockCount; ++i)
+            blocks[i] = _mm_aesenc_si128(blocks[i], round_keys[round]);
+    }
+
+    for (size_t i = 0; i < BlockCount; ++i)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 16), _mm_aesenclast_si128(blocks[i], round_keys[rounds]));
+}
+
+[[gnu::target("aes,ssse3")]] void aesni_encrypt_blocks(AESCipherKey const& key, u8 const* in, u8* out, size_t block_count)
+{
+    __m128i round_keys[15];
+    load_round_keys(key, round_keys);
+    auto rounds = key.rounds();
+
+    // AESENC has a latency of several cycles but can be issued every cycle, so interleaving independent blocks keeps the unit busy.
+    for (; block_count >= 8; block_count -= 8, in += 8 * 16, out += 8 * 16)
+        aesni_encrypt<8>(round_keys, rounds, in, out);
+
+    for (; block_count > 0; --block_count, in += 16, out += 16)
+        aesni_encrypt<1>(round_keys, rounds, in, out);
+}
+
+[[gnu::target("aes,ssse3")]] void aesni_decrypt_block(AESCipherKey const& key, u8 const* in, u8* out)
+{
+    __m128i round_keys[15];
+    load_round_keys(key, round_keys);
+    auto rounds = key.rounds();
+
+    // The decryption key schedule is already in the "equivalent inverse cipher" form that AESDEC expects.
+    auto block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)), round_keys[0]);
+    for (size_t round = 1; round < rounds; ++round)
+        block = _mm_aesdec_si128(block, round_keys[round]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_aesdeclast_si128(block, round_keys[rounds]));
+}
+
+}
+#endif
+
 template<typename T>
 constexpr u32 get_key(T pt)
 {
@@ -198,6 +264,13 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
 
 void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#ifdef AES_HAS_AESNI_IMPLEMENTATION
+    if (cpu_features().has_aes) {
+        aesni_encrypt_blocks(key(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -287,6 +360,13 @@ void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#ifdef AES_HAS_AESNI_IMPLEMENTATION
+    if (cpu_features().has_aes) {
+        aesni_decrypt_block(key(), in.bytes().data(), out.bytes().data());
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -374,6 +454,26 @@ void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
     // clang-format on
 }
 
+void AESCipher::encrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+    VERIFY(in.size() % block_size() == 0);
+    VERIFY(in.size() <= out.size());
+
+#ifdef AES_HAS_AESNI_IMPLEMENTATION
+    if (cpu_features().has_aes) {
+        aesni_encrypt_blocks(key(), in.data(), out.data(), in.size() / block_size());
+        return;
+    }
+#endif
+
+    AESCipherBlock block;
+    for (size_t offset = 0; offset < in.size(); offset += block_size()) {
+        block.overwrite(in.slice(offset, block_size()));
+        encrypt_block(block, block);
+        block.bytes().copy_to(out.slice(offset));
+    }
+}
+
 void AESCipherBlock::overwrite(ReadonlyBytes bytes)
 {
     auto data = bytes.data();
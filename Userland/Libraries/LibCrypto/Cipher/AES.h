@@ -119,6 +119,10 @@ public:
     virtual void encrypt_block(BlockType const& in, BlockType& out) override;
     virtual void decrypt_block(BlockType const& in, BlockType& out) override;
 
+    // Encrypts a run of independent blocks (as used by counter modes); `in` and `out` may alias.
+    // With AES-NI this keeps several blocks in flight at once instead of encrypting them one after another.
+    void encrypt_blocks(ReadonlyBytes in, Bytes out);
+
 #ifndef KERNEL
     virtual ByteString class_name() const override
     {
@@ -170,6 +170,36 @@ protected:
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
+        if constexpr (requires { cipher.encrypt_blocks(ReadonlyBytes {}, Bytes {}); }) {
+            // OPTIMIZATION: Lay out a batch of counter blocks and let the cipher encrypt them together,
+            //               which allows hardware implementations to process several blocks in parallel.
+            constexpr size_t blocks_per_batch = 8;
+            u8 key_stream[blocks_per_batch * T::block_size()];
+
+            while (length >= block_size) {
+                auto batch_size = min(blocks_per_batch, length / block_size) * block_size;
+
+                for (size_t i = 0; i < batch_size; i += block_size) {
+                    __builtin_memcpy(key_stream + i, iv.data(), block_size);
+                    increment(iv);
+                }
+
+                Bytes key_stream_bytes { key_stream, batch_size };
+                cipher.encrypt_blocks(key_stream_bytes, key_stream_bytes);
+
+                VERIFY(offset + batch_size <= out.size());
+                if (in) {
+                    auto const* input = in->offset(offset);
+                    for (size_t i = 0; i < batch_size; ++i)
+                        key_stream[i] ^= input[i];
+                }
+                __builtin_memcpy(out.offset(offset), key_stream, batch_size);
+
+                length -= batch_size;
+                offset += batch_size;
+            }
+        }
+
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
 
@@ -10,13 +10,174 @@
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA1.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    define SHA1_HAS_SHA_NI_IMPLEMENTATION
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Hash {
 
+#ifdef SHA1_HAS_SHA_NI_IMPLEMENTATION
+namespace {
+
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE __m128i sha1_four_rounds(__m128i abcd, __m128i e, size_t group)
+{
+    // The round function selector has to be an immediate.
+    switch (group / 5) {
+    case 0:
+        return _mm_sha1rnds4_epu32(abcd, e, 0);
+    case 1:
+        return _mm_sha1rnds4_epu32(abcd, e, 1);
+    case 2:
+        return _mm_sha1rnds4_epu32(abcd, e, 2);
+    default:
+        return _mm_sha1rnds4_epu32(abcd, e, 3);
+    }
+}
+
+// Processes whole blocks with the SHA extensions, following the structure of Intel's reference implementation:
+// each group of four rounds consumes one message vector while the schedule for the following groups is computed alongside.
+[[gnu::target("sha,sse4.1")]] void sha1_transform_sha_ni(u32 (&state)[5], u8 const* data, size_t block_count)
+{
+    auto const byte_reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0x1b);
+    __m128i e[2] { _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0), _mm_setzero_si128() };
+
+    for (; block_count > 0; --block_count, data += 64) {
+        auto saved_abcd = abcd;
+        auto saved_e = e[0];
+        __m128i messages[4];
+
+#pragma GCC unroll 20
+        for (size_t group = 0; group < 20; ++group) {
+            auto& message = messages[group % 4];
+            auto& current_e = e[group % 2];
+            auto& next_e = e[(group + 1) % 2];
+
+            if (group < 4)
+                message = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + group * 16)), byte_reverse);
+
+            if (group == 0)
+                current_e = _mm_add_epi32(current_e, message);
+            else
+                current_e = _mm_sha1nexte_epu32(current_e, message);
+
+            next_e = abcd;
+            if (group >= 3 && group <= 18)
+                messages[(group + 1) % 4] = _mm_sha1msg2_epu32(messages[(group + 1) % 4], message);
+            abcd = sha1_four_rounds(abcd, current_e, group);
+            if (group >= 1 && group <= 16)
+                messages[(group + 3) % 4] = _mm_sha1msg1_epu32(messages[(group + 3) % 4], message);
+            if (group >= 2 && group <= 17)
+                messages[(group + 2) % 4] = _mm_xor_si128(messages[(group + 2) % 4], message);
+        }
+
+        e[0] = _mm_sha1nexte_epu32(e[0], saved_e);
+        abcd = _mm_add_epi32(abcd, saved_abcd);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = _mm_extract_epi32(e[0], 3);
+}
+
+}
+#endif
+
 static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
 {
     return (value << bits) | (value >> (32 - bits));
 }
 
+#ifdef SHA1_HAS_SHA_NI_IMPLEMENTATION
+namespace {
+
+// Runs the rounds of one block, with the round constants already added to the message schedule.
+ALWAYS_INLINE void sha1_rounds(u32 (&state)[5], u32 const* schedule)
+{
+    auto a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+#pragma GCC unroll 80
+    for (size_t i = 0; i < 80; ++i) {
+        u32 f;
+        if (i <= 19)
+            f = (b & c) | ((~b) & d);
+        else if (i <= 39)
+            f = b ^ c ^ d;
+        else if (i <= 59)
+            f = (b & c) | (b & d) | (c & d);
+        else
+            f = b ^ c ^ d;
+        auto temp = ROTATE_LEFT(a, 5) + f + e + schedule[i];
+        e = d;
+        d = c;
+        c = ROTATE_LEFT(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+template<int Bits>
+[[gnu::target("avx2")]] ALWAYS_INLINE __m256i sha1_rotate_left(__m256i x)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(x, Bits), _mm256_srli_epi32(x, 32 - Bits));
+}
+
+// Computes the message schedules of two blocks at once, one in each 128-bit half of the vectors, four words at a time.
+// The rounds stay scalar.
+[[gnu::target("avx2")]] void sha1_transform_avx2(u32 (&state)[5], u8 const* data, size_t block_count)
+{
+    auto const byte_reverse = _mm256_set_epi8(
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    u32 schedules[2][80];
+
+    for (; block_count > 0; block_count -= min<size_t>(block_count, 2), data += 128) {
+        // With an odd number of blocks, the last one is scheduled twice and only run once.
+        auto const* second_block = block_count > 1 ? data + 64 : data;
+        __m256i messages[4];
+        for (size_t i = 0; i < 4; ++i) {
+            auto first = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i * 16));
+            auto second = _mm_loadu_si128(reinterpret_cast<__m128i const*>(second_block + i * 16));
+            messages[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1), byte_reverse);
+        }
+
+#pragma GCC unroll 20
+        for (size_t group = 0; group < 20; ++group) {
+            auto& message = messages[group % 4];
+            if (group >= 4) {
+                // w[i] = (w[i-3] xor w[i-8] xor w[i-14] xor w[i-16]) leftrotate 1, where the oldest message vector holds
+                // w[i-16]. The last word depends on the first one, so it is computed without it and fixed up after.
+                auto w3 = _mm256_srli_si256(messages[(group + 3) % 4], 4);
+                auto w14 = _mm256_alignr_epi8(messages[(group + 1) % 4], message, 8);
+                auto mixed = _mm256_xor_si256(_mm256_xor_si256(message, w14), _mm256_xor_si256(messages[(group + 2) % 4], w3));
+                message = _mm256_xor_si256(sha1_rotate_left<1>(mixed), sha1_rotate_left<2>(_mm256_slli_si256(mixed, 12)));
+            }
+
+            auto constant = _mm256_set1_epi32(static_cast<int>(SHA1Constants::RoundConstants[group / 5]));
+            auto scheduled = _mm256_add_epi32(message, constant);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&schedules[0][group * 4]), _mm256_castsi256_si128(scheduled));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&schedules[1][group * 4]), _mm256_extracti128_si256(scheduled, 1));
+        }
+
+        sha1_rounds(state, schedules[0]);
+        if (block_count > 1)
+            sha1_rounds(state, schedules[1]);
+    }
+
+    secure_zero(schedules, sizeof(schedules));
+}
+
+}
+#endif
+
 inline void SHA1::transform(u8 const* data)
 {
     u32 blocks[80];
@@ -67,16 +228,43 @@ inline void SHA1::transform(u8 const* data)
     secure_zero(blocks, 16 * sizeof(u32));
 }
 
+void SHA1::transform_blocks(u8 const* data, size_t block_count)
+{
+#ifdef SHA1_HAS_SHA_NI_IMPLEMENTATION
+    if (cpu_features().has_sha && cpu_features().has_sse41) {
+        sha1_transform_sha_ni(m_state, data, block_count);
+        return;
+    }
+    if (cpu_features().has_avx2) {
+        sha1_transform_avx2(m_state, data, block_count);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < block_count; ++i)
+        transform(data + i * BlockSize);
+}
+
 void SHA1::update(u8 const* message, size_t length)
 {
     while (length > 0) {
+        // OPTIMIZATION: Hash whole blocks straight from the input if nothing is buffered.
+        if (m_data_length == 0 && length >= BlockSize) {
+            auto block_count = length / BlockSize;
+            transform_blocks(message, block_count);
+            m_bit_length += block_count * BlockSize * 8;
+            message += block_count * BlockSize;
+            length -= block_count * BlockSize;
+            continue;
+        }
+
         size_t copy_bytes = AK::min(length, BlockSize - m_data_length);
         __builtin_memcpy(m_data_buffer + m_data_length, message, copy_bytes);
         message += copy_bytes;
         length -= copy_bytes;
         m_data_length += copy_bytes;
         if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
+            transform_blocks(m_data_buffer, 1);
             m_bit_length += BlockSize * 8;
             m_data_length = 0;
         }
@@ -111,7 +299,7 @@ SHA1::DigestType SHA1::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -128,7 +316,7 @@ SHA1::DigestType SHA1::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     for (i = 0; i < 4; ++i) {
         digest.data[i + 0] = (m_state[0] >> (24 - i * 8)) & 0x000000ff;
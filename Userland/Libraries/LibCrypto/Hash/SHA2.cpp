@@ -8,6 +8,21 @@
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA2.h>
 
+#if !defined(KERNEL)
+#    include <AK/Array.h>
+#    include <AK/Endian.h>
+#    include <AK/QuickSort.h>
+#    include <AK/SIMD.h>
+#    include <AK/Vector.h>
+#    include <LibCrypto/CPUFeatures.h>
+#endif
+
+#if ARCH(X86_64) && !defined(KERNEL)
+#    define SHA256_HAS_SHA_NI_IMPLEMENTATION
+#    define SHA2_HAS_AVX2_IMPLEMENTATION
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Hash {
 constexpr static auto ROTRIGHT(u32 a, size_t b) { return (a >> b) | (a << (32 - b)); }
 constexpr static auto CH(u32 x, u32 y, u32 z) { return (x & y) ^ (z & ~x); }
@@ -25,6 +40,145 @@ constexpr static auto EP1(u64 x) { return ROTRIGHT(x, 14) ^ ROTRIGHT(x, 18) ^ RO
 constexpr static auto SIGN0(u64 x) { return ROTRIGHT(x, 1) ^ ROTRIGHT(x, 8) ^ (x >> 7); }
 constexpr static auto SIGN1(u64 x) { return ROTRIGHT(x, 19) ^ ROTRIGHT(x, 61) ^ (x >> 6); }
 
+#ifdef SHA256_HAS_SHA_NI_IMPLEMENTATION
+// Processes whole blocks with the SHA extensions, following the structure of Intel's reference implementation.
+// The state is kept as ABEF/CDGH, each group of four rounds consumes one message vector, and the schedule for
+// the following groups is computed alongside.
+[[gnu::target("sha,sse4.1")]] static void sha256_transform_sha_ni(u32 (&state)[8], u8 const* data, size_t block_count)
+{
+    auto const byte_swap_words = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+
+    auto cdab = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[0])), 0xb1);
+    auto cdgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[4])), 0x1b);
+    auto abef = _mm_alignr_epi8(cdab, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, cdab, 0xf0);
+
+    for (; block_count > 0; --block_count, data += 64) {
+        auto saved_abef = abef;
+        auto saved_cdgh = cdgh;
+        __m128i messages[4];
+
+#    pragma GCC unroll 16
+        for (size_t group = 0; group < 16; ++group) {
+            auto& message = messages[group % 4];
+            if (group < 4)
+                message = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + group * 16)), byte_swap_words);
+
+            auto round_input = _mm_add_epi32(message, _mm_loadu_si128(reinterpret_cast<__m128i const*>(&SHA256Constants::RoundConstants[group * 4])));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, round_input);
+            if (group >= 3 && group <= 14) {
+                auto& next_message = messages[(group + 1) % 4];
+                next_message = _mm_add_epi32(next_message, _mm_alignr_epi8(message, messages[(group + 3) % 4], 4));
+                next_message = _mm_sha256msg2_epu32(next_message, message);
+            }
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(round_input, 0x0e));
+            if (group >= 1 && group <= 12)
+                messages[(group + 3) % 4] = _mm_sha256msg1_epu32(messages[(group + 3) % 4], message);
+        }
+
+        abef = _mm_add_epi32(abef, saved_abef);
+        cdgh = _mm_add_epi32(cdgh, saved_cdgh);
+    }
+
+    auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+#endif
+
+#ifdef SHA2_HAS_AVX2_IMPLEMENTATION
+// Runs the rounds of one block, with the round constants already added to the message schedule.
+static ALWAYS_INLINE void sha256_rounds(u32 (&state)[8], u32 const* schedule)
+{
+    auto a = state[0], b = state[1],
+         c = state[2], d = state[3],
+         e = state[4], f = state[5],
+         g = state[6], h = state[7];
+
+#    pragma GCC unroll 64
+    for (size_t i = 0; i < array_size(SHA256Constants::RoundConstants); ++i) {
+        auto temp0 = h + EP1(e) + CH(e, f, g) + schedule[i];
+        auto temp1 = EP0(a) + MAJ(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp0;
+        d = c;
+        c = b;
+        b = a;
+        a = temp0 + temp1;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+template<int Bits>
+[[gnu::target("avx2")]] static ALWAYS_INLINE __m256i sha256_rotate_right(__m256i x)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, Bits), _mm256_slli_epi32(x, 32 - Bits));
+}
+
+[[gnu::target("avx2")]] static ALWAYS_INLINE __m256i sha256_sign1(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(sha256_rotate_right<17>(x), sha256_rotate_right<19>(x)), _mm256_srli_epi32(x, 10));
+}
+
+// Computes the message schedules of two blocks at once, one in each 128-bit half of the vectors, four words at a time.
+// The rounds themselves have no parallelism to speak of, so they stay scalar.
+[[gnu::target("avx2")]] static void sha256_transform_avx2(u32 (&state)[8], u8 const* data, size_t block_count)
+{
+    auto const byte_swap_words = _mm256_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull, 0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+    auto const zero = _mm256_setzero_si256();
+    u32 schedules[2][64];
+
+    for (; block_count > 0; block_count -= min<size_t>(block_count, 2), data += 128) {
+        // With an odd number of blocks, the last one is scheduled twice and only run once.
+        auto const* second_block = block_count > 1 ? data + 64 : data;
+        __m256i messages[4];
+        for (size_t i = 0; i < 4; ++i) {
+            auto first = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i * 16));
+            auto second = _mm_loadu_si128(reinterpret_cast<__m128i const*>(second_block + i * 16));
+            messages[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1), byte_swap_words);
+        }
+
+#    pragma GCC unroll 16
+        for (size_t group = 0; group < 16; ++group) {
+            auto& message = messages[group % 4];
+            if (group >= 4) {
+                // w[i] = SIGN1(w[i - 2]) + w[i - 7] + SIGN0(w[i - 15]) + w[i - 16], where the oldest message vector holds w[i - 16].
+                auto w15 = _mm256_alignr_epi8(messages[(group + 1) % 4], message, 4);
+                auto w7 = _mm256_alignr_epi8(messages[(group + 3) % 4], messages[(group + 2) % 4], 4);
+                auto sign0 = _mm256_xor_si256(_mm256_xor_si256(sha256_rotate_right<7>(w15), sha256_rotate_right<18>(w15)), _mm256_srli_epi32(w15, 3));
+                auto next = _mm256_add_epi32(_mm256_add_epi32(message, sign0), w7);
+
+                // The last two words depend on the first two, so SIGN1 is done in two halves.
+                auto low_sign1 = sha256_sign1(_mm256_shuffle_epi32(messages[(group + 3) % 4], 0xfe));
+                next = _mm256_add_epi32(next, _mm256_blend_epi32(low_sign1, zero, 0xcc));
+                auto high_sign1 = sha256_sign1(_mm256_shuffle_epi32(next, 0x40));
+                message = _mm256_add_epi32(next, _mm256_blend_epi32(zero, high_sign1, 0xcc));
+            }
+
+            auto constants = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&SHA256Constants::RoundConstants[group * 4])));
+            auto scheduled = _mm256_add_epi32(message, constants);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&schedules[0][group * 4]), _mm256_castsi256_si128(scheduled));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&schedules[1][group * 4]), _mm256_extracti128_si256(scheduled, 1));
+        }
+
+        sha256_rounds(state, schedules[0]);
+        if (block_count > 1)
+            sha256_rounds(state, schedules[1]);
+    }
+}
+#endif
+
 inline void SHA256::transform(u8 const* data)
 {
     u32 m[64];
@@ -66,17 +220,45 @@ inline void SHA256::transform(u8 const* data)
     m_state[7] += h;
 }
 
+void SHA256::transform_blocks(u8 const* data, size_t block_count)
+{
+#ifdef SHA256_HAS_SHA_NI_IMPLEMENTATION
+    if (cpu_features().has_sha && cpu_features().has_sse41) {
+        sha256_transform_sha_ni(m_state, data, block_count);
+        return;
+    }
+#endif
+#ifdef SHA2_HAS_AVX2_IMPLEMENTATION
+    if (cpu_features().has_avx2) {
+        sha256_transform_avx2(m_state, data, block_count);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < block_count; ++i)
+        transform(data + i * BlockSize);
+}
+
 template<size_t BlockSize, typename Callback>
 void update_buffer(u8* buffer, u8 const* input, size_t length, size_t& data_length, Callback callback)
 {
     while (length > 0) {
+        // OPTIMIZATION: Hand whole blocks straight from the input to the callback if nothing is buffered.
+        if (data_length == 0 && length >= BlockSize) {
+            auto block_count = length / BlockSize;
+            callback(input, block_count);
+            input += block_count * BlockSize;
+            length -= block_count * BlockSize;
+            continue;
+        }
+
         size_t copy_bytes = AK::min(length, BlockSize - data_length);
         __builtin_memcpy(buffer + data_length, input, copy_bytes);
         input += copy_bytes;
         length -= copy_bytes;
         data_length += copy_bytes;
         if (data_length == BlockSize) {
-            callback();
+            callback(buffer, 1);
             data_length = 0;
         }
     }
@@ -84,9 +266,9 @@ void update_buffer(u8* buffer, u8 const* input, size_t length, size_t& data_leng
 
 void SHA256::update(u8 const* message, size_t length)
 {
-    update_buffer<BlockSize>(m_data_buffer, message, length, m_data_length, [&]() {
-        transform(m_data_buffer);
-        m_bit_length += BlockSize * 8;
+    update_buffer<BlockSize>(m_data_buffer, message, length, m_data_length, [&](u8 const* blocks, size_t block_count) {
+        transform_blocks(blocks, block_count);
+        m_bit_length += block_count * BlockSize * 8;
     });
 }
 
@@ -99,7 +281,6 @@ SHA256::DigestType SHA256::digest()
 
 SHA256::DigestType SHA256::peek()
 {
-    DigestType digest;
     size_t i = m_data_length;
 
     if (i < FinalBlockDataSize) {
@@ -111,7 +292,7 @@ SHA256::DigestType SHA256::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -128,12 +309,19 @@ SHA256::DigestType SHA256::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
+
+    return digest_from_state();
+}
+
+SHA256::DigestType SHA256::digest_from_state() const
+{
+    DigestType digest;
 
     // SHA uses big-endian and we assume little-endian
     // FIXME: looks like a thing for AK::NetworkOrdered,
     //        but that doesn't support shifting operations
-    for (i = 0; i < 4; ++i) {
+    for (size_t i = 0; i < 4; ++i) {
         digest.data[i + 0] = (m_state[0] >> (24 - i * 8)) & 0x000000ff;
         digest.data[i + 4] = (m_state[1] >> (24 - i * 8)) & 0x000000ff;
         digest.data[i + 8] = (m_state[2] >> (24 - i * 8)) & 0x000000ff;
@@ -146,6 +334,254 @@ SHA256::DigestType SHA256::peek()
     return digest;
 }
 
+#ifndef KERNEL
+using SHA256LaneVector = AK::SIMD::u32x8;
+static constexpr size_t sha256_lane_count = 8;
+
+// Runs the SHA-256 compression function on one block per lane; lane N of every state word belongs to message N.
+// Rotations are spelled out, since helpers that return lane vectors would change the ABI without AVX (-Wpsabi).
+static ALWAYS_INLINE void sha256_transform_lanes_impl(SHA256LaneVector (&state)[8], Array<u8 const*, sha256_lane_count> const& blocks)
+{
+    SHA256LaneVector m[16];
+    for (size_t i = 0; i < 16; ++i) {
+        for (size_t lane = 0; lane < sha256_lane_count; ++lane) {
+            u32 word;
+            __builtin_memcpy(&word, blocks[lane] + i * 4, sizeof(word));
+            m[i][lane] = AK::convert_between_host_and_big_endian(word);
+        }
+    }
+
+    auto a = state[0], b = state[1],
+         c = state[2], d = state[3],
+         e = state[4], f = state[5],
+         g = state[6], h = state[7];
+
+#    pragma GCC unroll 64
+    for (size_t i = 0; i < array_size(SHA256Constants::RoundConstants); ++i) {
+        if (i >= 16) {
+            auto w2 = m[(i - 2) % 16];
+            auto w15 = m[(i - 15) % 16];
+            auto sign1 = (w2 >> 17 | w2 << 15) ^ (w2 >> 19 | w2 << 13) ^ (w2 >> 10);
+            auto sign0 = (w15 >> 7 | w15 << 25) ^ (w15 >> 18 | w15 << 14) ^ (w15 >> 3);
+            m[i % 16] += sign1 + m[(i - 7) % 16] + sign0;
+        }
+        auto ep1 = (e >> 6 | e << 26) ^ (e >> 11 | e << 21) ^ (e >> 25 | e << 7);
+        auto ep0 = (a >> 2 | a << 30) ^ (a >> 13 | a << 19) ^ (a >> 22 | a << 10);
+        auto temp0 = h + ep1 + ((e & f) ^ (g & ~e)) + SHA256Constants::RoundConstants[i] + m[i % 16];
+        auto temp1 = ep0 + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp0;
+        d = c;
+        c = b;
+        b = a;
+        a = temp0 + temp1;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+#    if ARCH(X86_64)
+[[gnu::target("avx2")]] static void sha256_transform_lanes_avx2(SHA256LaneVector (&state)[8], Array<u8 const*, sha256_lane_count> const& blocks)
+{
+    sha256_transform_lanes_impl(state, blocks);
+}
+#    endif
+
+static void sha256_transform_lanes(SHA256LaneVector (&state)[8], Array<u8 const*, sha256_lane_count> const& blocks)
+{
+#    if ARCH(X86_64)
+    if (Crypto::cpu_features().has_avx2) {
+        sha256_transform_lanes_avx2(state, blocks);
+        return;
+    }
+#    endif
+    sha256_transform_lanes_impl(state, blocks);
+}
+
+void SHA256::hash_many(ReadonlySpan<ReadonlyBytes> messages, Span<DigestType> digests)
+{
+    VERIFY(messages.size() == digests.size());
+
+#ifdef SHA256_HAS_SHA_NI_IMPLEMENTATION
+    // A single SHA-NI stream outruns eight general-purpose SIMD lanes, so there is nothing to gain from batching.
+    if (cpu_features().has_sha && cpu_features().has_sse41) {
+        for (size_t i = 0; i < messages.size(); ++i)
+            digests[i] = hash(messages[i].data(), messages[i].size());
+        return;
+    }
+#endif
+
+    // Messages of similar length finish at the same time, so group them into the same batch of lanes.
+    Vector<size_t> order;
+    order.ensure_capacity(messages.size());
+    for (size_t i = 0; i < messages.size(); ++i)
+        order.unchecked_append(i);
+    quick_sort(order, [&](size_t a, size_t b) { return messages[a].size() < messages[b].size(); });
+
+    static constexpr u8 unused_lane_block[BlockSize] {};
+
+    struct Lane {
+        ReadonlyBytes message;
+        size_t full_block_count { 0 };
+        size_t total_block_count { 0 };
+        u8 tail[2 * BlockSize] {};
+
+        u8 const* block(size_t index) const
+        {
+            if (index < full_block_count)
+                return message.data() + index * BlockSize;
+            return tail + (index - full_block_count) * BlockSize;
+        }
+    };
+
+    for (size_t batch_start = 0; batch_start < order.size(); batch_start += sha256_lane_count) {
+        auto lane_count = min(sha256_lane_count, order.size() - batch_start);
+
+        Array<Lane, sha256_lane_count> lanes;
+        size_t common_block_count = NumericLimits<size_t>::max();
+        for (size_t lane_index = 0; lane_index < lane_count; ++lane_index) {
+            auto& lane = lanes[lane_index];
+            lane.message = messages[order[batch_start + lane_index]];
+            lane.full_block_count = lane.message.size() / BlockSize;
+
+            auto remainder = lane.message.size() % BlockSize;
+            __builtin_memcpy(lane.tail, lane.message.data() + lane.full_block_count * BlockSize, remainder);
+            lane.tail[remainder] = 0x80;
+            auto tail_block_count = remainder < FinalBlockDataSize ? 1u : 2u;
+            u64 bit_length = static_cast<u64>(lane.message.size()) * 8;
+            for (size_t i = 0; i < 8; ++i)
+                lane.tail[tail_block_count * BlockSize - 1 - i] = bit_length >> (i * 8);
+
+            lane.total_block_count = lane.full_block_count + tail_block_count;
+            common_block_count = min(common_block_count, lane.total_block_count);
+        }
+
+        SHA256LaneVector state[8];
+        for (size_t i = 0; i < 8; ++i)
+            state[i] = SHA256LaneVector {} + SHA256Constants::InitializationHashes[i];
+
+        Array<u8 const*, sha256_lane_count> blocks;
+        blocks.fill(unused_lane_block);
+        for (size_t block_index = 0; block_index < common_block_count; ++block_index) {
+            for (size_t lane_index = 0; lane_index < lane_count; ++lane_index)
+                blocks[lane_index] = lanes[lane_index].block(block_index);
+            sha256_transform_lanes(state, blocks);
+        }
+
+        // Whatever is left over is finished one message at a time.
+        for (size_t lane_index = 0; lane_index < lane_count; ++lane_index) {
+            auto& lane = lanes[lane_index];
+            SHA256 hasher;
+            for (size_t i = 0; i < 8; ++i)
+                hasher.m_state[i] = state[i][lane_index];
+
+            size_t block_index = common_block_count;
+            if (block_index < lane.full_block_count) {
+                hasher.transform_blocks(lane.block(block_index), lane.full_block_count - block_index);
+                block_index = lane.full_block_count;
+            }
+            if (block_index < lane.total_block_count)
+                hasher.transform_blocks(lane.block(block_index), lane.total_block_count - block_index);
+
+            digests[order[batch_start + lane_index]] = hasher.digest_from_state();
+        }
+    }
+}
+#endif
+
+#ifdef SHA2_HAS_AVX2_IMPLEMENTATION
+// SHA-384 and SHA-512 only differ in their initial state and how much of it ends up in the digest.
+static ALWAYS_INLINE void sha512_rounds(u64 (&state)[8], u64 const* schedule)
+{
+    auto a = state[0], b = state[1],
+         c = state[2], d = state[3],
+         e = state[4], f = state[5],
+         g = state[6], h = state[7];
+
+#    pragma GCC unroll 80
+    for (size_t i = 0; i < array_size(SHA512Constants::RoundConstants); ++i) {
+        auto temp0 = h + EP1(e) + CH(e, f, g) + schedule[i];
+        auto temp1 = EP0(a) + MAJ(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp0;
+        d = c;
+        c = b;
+        b = a;
+        a = temp0 + temp1;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+template<int Bits>
+[[gnu::target("avx2")]] static ALWAYS_INLINE __m256i sha512_rotate_right(__m256i x)
+{
+    return _mm256_or_si256(_mm256_srli_epi64(x, Bits), _mm256_slli_epi64(x, 64 - Bits));
+}
+
+[[gnu::target("avx2")]] static ALWAYS_INLINE __m256i sha512_sign1(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(sha512_rotate_right<19>(x), sha512_rotate_right<61>(x)), _mm256_srli_epi64(x, 6));
+}
+
+// Computes the message schedule four words at a time, the rounds stay scalar.
+[[gnu::target("avx2")]] static void sha512_transform_avx2(u64 (&state)[8], u8 const* data, size_t block_count)
+{
+    auto const byte_swap_words = _mm256_set_epi64x(0x08090a0b0c0d0e0full, 0x0001020304050607ull, 0x08090a0b0c0d0e0full, 0x0001020304050607ull);
+    auto const zero = _mm256_setzero_si256();
+    u64 schedule[80];
+
+    for (; block_count > 0; --block_count, data += 128) {
+        __m256i messages[4];
+        for (size_t i = 0; i < 4; ++i)
+            messages[i] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + i * 32)), byte_swap_words);
+
+#    pragma GCC unroll 20
+        for (size_t group = 0; group < 20; ++group) {
+            auto& message = messages[group % 4];
+            if (group >= 4) {
+                // Same as for SHA-256, except that shifting words across vectors has to go through the 128-bit halves.
+                auto const& w12 = messages[(group + 1) % 4];
+                auto const& w8 = messages[(group + 2) % 4];
+                auto const& w4 = messages[(group + 3) % 4];
+                auto w15 = _mm256_alignr_epi8(_mm256_permute2x128_si256(message, w12, 0x21), message, 8);
+                auto w7 = _mm256_alignr_epi8(_mm256_permute2x128_si256(w8, w4, 0x21), w8, 8);
+                auto sign0 = _mm256_xor_si256(_mm256_xor_si256(sha512_rotate_right<1>(w15), sha512_rotate_right<8>(w15)), _mm256_srli_epi64(w15, 7));
+                auto next = _mm256_add_epi64(_mm256_add_epi64(message, sign0), w7);
+
+                auto low_sign1 = sha512_sign1(_mm256_permute4x64_epi64(w4, 0xfe));
+                next = _mm256_add_epi64(next, _mm256_blend_epi32(low_sign1, zero, 0xf0));
+                auto high_sign1 = sha512_sign1(_mm256_permute4x64_epi64(next, 0x40));
+                message = _mm256_add_epi64(next, _mm256_blend_epi32(zero, high_sign1, 0xf0));
+            }
+
+            auto constants = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(&SHA512Constants::RoundConstants[group * 4]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&schedule[group * 4]), _mm256_add_epi64(message, constants));
+        }
+
+        sha512_rounds(state, schedule);
+    }
+}
+#endif
+
 inline void SHA384::transform(u8 const* data)
 {
     u64 m[80];
@@ -190,9 +626,16 @@ inline void SHA384::transform(u8 const* data)
 
 void SHA384::update(u8 const* message, size_t length)
 {
-    update_buffer<BlockSize>(m_data_buffer, message, length, m_data_length, [&]() {
-        transform(m_data_buffer);
-        m_bit_length += BlockSize * 8;
+    update_buffer<BlockSize>(m_data_buffer, message, length, m_data_length, [&](u8 const* blocks, size_t block_count) {
+        m_bit_length += block_count * BlockSize * 8;
+#ifdef SHA2_HAS_AVX2_IMPLEMENTATION
+        if (cpu_features().has_avx2) {
+            sha512_transform_avx2(m_state, blocks, block_count);
+            return;
+        }
+#endif
+        for (size_t i = 0; i < block_count; ++i)
+            transform(blocks + i * BlockSize);
     });
 }
 
@@ -302,9 +745,16 @@ inline void SHA512::transform(u8 const* data)
 
 void SHA512::update(u8 const* message, size_t length)
 {
-    update_buffer<BlockSize>(m_data_buffer, message, length, m_data_length, [&]() {
-        transform(m_data_buffer);
-        m_bit_length += BlockSize * 8;
+    update_buffer<BlockSize>(m_data_buffer, message, length, m_data_length, [&](u8 const* blocks, size_t block_count) {
+        m_bit_length += block_count * BlockSize * 8;
+#ifdef SHA2_HAS_AVX2_IMPLEMENTATION
+        if (cpu_features().has_avx2) {
+            sha512_transform_avx2(m_state, blocks, block_count);
+            return;
+        }
+#endif
+        for (size_t i = 0; i < block_count; ++i)
+            transform(blocks + i * BlockSize);
     });
 }
 
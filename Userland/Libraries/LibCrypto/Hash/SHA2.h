@@ -100,6 +100,10 @@ public:
     static DigestType hash(StringView buffer) { return hash((u8 const*)buffer.characters_without_null_termination(), buffer.length()); }
 
 #ifndef KERNEL
+    // Hashes several independent messages at once, running each one in its own SIMD lane.
+    // This is considerably faster than hashing them one after another when there are many short-to-medium messages.
+    static void hash_many(ReadonlySpan<ReadonlyBytes> messages, Span<DigestType> digests);
+
     virtual ByteString class_name() const override
     {
         return ByteString::formatted("SHA{}", DigestSize * 8);
@@ -116,6 +120,8 @@ public:
 
 private:
     inline void transform(u8 const*);
+    void transform_blocks(u8 const*, size_t block_count);
+    DigestType digest_from_state() const;
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
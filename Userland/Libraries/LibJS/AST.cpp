@@ -17,6 +17,7 @@
 #include <LibJS/AST.h>
 #include <LibJS/Heap/ConservativeVector.h>
 #include <LibJS/Heap/MarkedVector.h>
+#include <LibJS/Parser.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Accessor.h>
 #include <LibJS/Runtime/Array.h>
@@ -106,7 +107,7 @@ Value FunctionExpression::instantiate_ordinary_function_expression(VM& vm, Depre
 
     auto private_environment = vm.running_execution_context().private_environment;
 
-    auto closure = ECMAScriptFunctionObject::create(realm, used_name, source_text(), body(), parameters(), function_length(), local_variables_names(), environment, private_environment, kind(), is_strict_mode(), might_need_arguments_object(), contains_direct_call_to_eval(), is_arrow_function());
+    auto closure = ECMAScriptFunctionObject::create(realm, used_name, *this, environment, private_environment);
 
     // FIXME: 6. Perform SetFunctionName(closure, name).
     // FIXME: 7. Perform MakeConstructor(closure).
@@ -477,6 +478,11 @@ void ASTNode::dump(int indent) const
     outln("{}", class_name());
 }
 
+BlockStatement::~BlockStatement()
+{
+    source_code().unregister_node(SourceCode::NodeKind::Scope, *this);
+}
+
 void ScopeNode::dump(int indent) const
 {
     ASTNode::dump(indent);
@@ -659,6 +665,11 @@ ThrowCompletionOr<void> ClassDeclaration::for_each_bound_identifier(ThrowComplet
     return callback(*m_class_expression->m_name);
 }
 
+ClassExpression::~ClassExpression()
+{
+    source_code().unregister_node(SourceCode::NodeKind::ClassExpression, *this);
+}
+
 void ClassExpression::dump(int indent) const
 {
     print_indent(indent);
@@ -848,6 +859,12 @@ void BindingPattern::dump(int indent) const
     }
 }
 
+void FunctionNode::finish_parsing() const
+{
+    Parser::finish_parsing_function(*this);
+    VERIFY(!m_preparsed_data);
+}
+
 void FunctionNode::dump(int indent, ByteString const& class_name) const
 {
     print_indent(indent);
@@ -858,11 +875,11 @@ void FunctionNode::dump(int indent, ByteString const& class_name) const
         print_indent(indent + 1);
         outln("\033[31;1m(direct eval)\033[0m");
     }
-    if (!m_parameters.is_empty()) {
+    if (!parameters().is_empty()) {
         print_indent(indent + 1);
         outln("(Parameters)");
 
-        for (auto& parameter : m_parameters) {
+        for (auto& parameter : parameters()) {
             parameter.binding.visit(
                 [&](Identifier const& identifier) {
                     if (parameter.is_rest) {
@@ -897,6 +914,11 @@ ThrowCompletionOr<void> FunctionDeclaration::for_each_bound_identifier(ThrowComp
     return callback(*m_name);
 }
 
+FunctionExpression::~FunctionExpression()
+{
+    source_code().unregister_node(SourceCode::NodeKind::FunctionExpression, *this);
+}
+
 void FunctionExpression::dump(int indent) const
 {
     FunctionNode::dump(indent, class_name());
@@ -1395,6 +1417,11 @@ void ThrowStatement::dump(int indent) const
     argument().dump(indent + 1);
 }
 
+SwitchStatement::~SwitchStatement()
+{
+    source_code().unregister_node(SourceCode::NodeKind::Scope, *this);
+}
+
 void SwitchStatement::dump(int indent) const
 {
     ASTNode::dump(indent);
@@ -1447,6 +1474,22 @@ ThrowCompletionOr<void> ScopeNode::for_each_lexically_scoped_declaration(ThrowCo
     return {};
 }
 
+bool ScopeNode::has_non_local_lexical_declarations() const
+{
+    for (auto const& declaration : m_lexical_declarations) {
+        if (is<FunctionDeclaration>(*declaration))
+            return true;
+        bool has_non_local_identifier = false;
+        MUST(declaration->for_each_bound_identifier([&](auto const& identifier) {
+            if (!identifier.is_local())
+                has_non_local_identifier = true;
+        }));
+        if (has_non_local_identifier)
+            return true;
+    }
+    return false;
+}
+
 ThrowCompletionOr<void> ScopeNode::for_each_lexically_declared_identifier(ThrowCompletionOrVoidCallback<Identifier const&>&& callback) const
 {
     for (auto const& declaration : m_lexical_declarations) {
@@ -1642,7 +1685,7 @@ void ScopeNode::block_declaration_instantiation(VM& vm, Environment* environment
             auto& function_declaration = static_cast<FunctionDeclaration const&>(declaration);
 
             // ii. Let fo be InstantiateFunctionObject of d with arguments env and privateEnv.
-            auto function = ECMAScriptFunctionObject::create(realm, function_declaration.name(), function_declaration.source_text(), function_declaration.body(), function_declaration.parameters(), function_declaration.function_length(), function_declaration.local_variables_names(), environment, private_environment, function_declaration.kind(), function_declaration.is_strict_mode(), function_declaration.might_need_arguments_object(), function_declaration.contains_direct_call_to_eval());
+            auto function = ECMAScriptFunctionObject::create(realm, function_declaration.name(), function_declaration, environment, private_environment);
 
             // iii. Perform ! env.InitializeBinding(fn, fo). NOTE: This step is replaced in section B.3.2.6.
             if (function_declaration.name_identifier()->is_local()) {
@@ -1846,7 +1889,7 @@ ThrowCompletionOr<void> Program::global_declaration_instantiation(VM& vm, Global
     for (auto& declaration : functions_to_initialize.in_reverse()) {
         // a. Let fn be the sole element of the BoundNames of f.
         // b. Let fo be InstantiateFunctionObject of f with arguments env and privateEnv.
-        auto function = ECMAScriptFunctionObject::create(realm, declaration.name(), declaration.source_text(), declaration.body(), declaration.parameters(), declaration.function_length(), declaration.local_variables_names(), &global_environment, private_environment, declaration.kind(), declaration.is_strict_mode(), declaration.might_need_arguments_object(), declaration.contains_direct_call_to_eval());
+        auto function = ECMAScriptFunctionObject::create(realm, declaration.name(), declaration, &global_environment, private_environment);
 
         // c. Perform ? env.CreateGlobalFunctionBinding(fn, fo, false).
         TRY(global_environment.create_global_function_binding(declaration.name(), function, false));
@@ -34,18 +34,31 @@
 
 namespace JS {
 
+class BlockStatement;
 class Declaration;
 class ClassDeclaration;
 class FunctionDeclaration;
+class FunctionExpression;
 class Identifier;
 class MemberExpression;
+class SwitchStatement;
 class VariableDeclaration;
 
 template<class T, class... Args>
 static inline NonnullRefPtr<T>
 create_ast_node(SourceRange range, Args&&... args)
 {
-    return adopt_ref(*new T(move(range), forward<Args>(args)...));
+    auto node = adopt_ref(*new T(move(range), forward<Args>(args)...));
+
+    // Bytecode refers to these nodes, so bytecode loaded from the bytecode cache has to be able to find them again.
+    if constexpr (IsSame<RemoveCV<T>, FunctionExpression>)
+        node->source_code().register_node(SourceCode::NodeKind::FunctionExpression, *node);
+    else if constexpr (IsSame<RemoveCV<T>, ClassExpression>)
+        node->source_code().register_node(SourceCode::NodeKind::ClassExpression, *node);
+    else if constexpr (IsOneOf<RemoveCV<T>, BlockStatement, SwitchStatement>)
+        node->source_code().register_node(SourceCode::NodeKind::Scope, *node);
+
+    return node;
 }
 
 class ASTNode : public RefCounted<ASTNode> {
@@ -306,6 +319,9 @@ public:
     void add_hoisted_function(NonnullRefPtr<FunctionDeclaration const> declaration);
 
     [[nodiscard]] bool has_lexical_declarations() const { return !m_lexical_declarations.is_empty(); }
+    // True if instantiating the lexical declarations would put anything into a new environment, i.e. some of them
+    // bind non-local identifiers or are function declarations.
+    [[nodiscard]] bool has_non_local_lexical_declarations() const;
     [[nodiscard]] bool has_var_declarations() const { return !m_var_declarations.is_empty(); }
 
     [[nodiscard]] size_t var_declaration_count() const { return m_var_declarations.size(); }
@@ -568,6 +584,8 @@ public:
         : ScopeNode(move(source_range))
     {
     }
+
+    virtual ~BlockStatement() override;
 };
 
 class FunctionBody final : public ScopeNode {
@@ -688,23 +706,75 @@ struct FunctionParameter {
     Handle<Bytecode::Executable> bytecode_executable {};
 };
 
+// What a function that has only been checked for syntax errors so far needs to be parsed again once its body is used,
+// see Parser::finish_parsing_function().
+struct PreparsedFunctionData : public RefCounted<PreparsedFunctionData> {
+    // An identifier that is used but not declared inside the function, and what the scopes inside the function found out about it.
+    struct FreeIdentifier {
+        NonnullRefPtr<Identifier const> identifier;
+        bool used_inside_with_statement { false };
+        bool used_inside_scope_with_eval { false };
+        bool might_be_variable_in_lexical_scope_in_named_function_assignment { false };
+    };
+
+    PreparsedFunctionData(NonnullRefPtr<SourceCode const> source_code, ByteString source)
+        : source_code(move(source_code))
+        , source(move(source))
+    {
+    }
+
+    NonnullRefPtr<SourceCode const> source_code;
+    ByteString source;
+    bool is_module { false };
+    bool is_declaration { false };
+    bool starts_in_strict_mode { false };
+    bool starts_in_function_context { false };
+    u16 parse_options { 0 };
+    Optional<Position> function_start;
+    Position start;
+    Position closing_curly;
+    HashMap<DeprecatedFlyString, FreeIdentifier> free_identifiers;
+
+    // Preparsed functions inside this one, by the offset they start at. Parsing this function again reuses them.
+    HashMap<size_t, NonnullRefPtr<ASTNode>> inner_functions;
+};
+
 class FunctionNode {
 public:
     StringView name() const { return m_name ? m_name->string().view() : ""sv; }
     RefPtr<Identifier const> name_identifier() const { return m_name; }
-    ByteString const& source_text() const { return m_source_text; }
-    Statement const& body() const { return *m_body; }
-    Vector<FunctionParameter> const& parameters() const { return m_parameters; }
+    ByteString const& source_text() const
+    {
+        ensure_parsed();
+        return m_source_text;
+    }
+    Statement const& body() const
+    {
+        ensure_parsed();
+        return *m_body;
+    }
+    Vector<FunctionParameter> const& parameters() const
+    {
+        ensure_parsed();
+        return m_parameters;
+    }
     i32 function_length() const { return m_function_length; }
-    Vector<DeprecatedFlyString> const& local_variables_names() const { return m_local_variables_names; }
+    Vector<DeprecatedFlyString> const& local_variables_names() const
+    {
+        ensure_parsed();
+        return m_local_variables_names;
+    }
     bool is_strict_mode() const { return m_is_strict_mode; }
     bool might_need_arguments_object() const { return m_might_need_arguments_object; }
     bool contains_direct_call_to_eval() const { return m_contains_direct_call_to_eval; }
     bool is_arrow_function() const { return m_is_arrow_function; }
     FunctionKind kind() const { return m_kind; }
 
+    // Preparsed functions only get their body, parameters and source text once something asks for them.
+    bool is_preparsed() const { return m_preparsed_data; }
+
 protected:
-    FunctionNode(RefPtr<Identifier const> name, ByteString source_text, NonnullRefPtr<Statement const> body, Vector<FunctionParameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Vector<DeprecatedFlyString> local_variables_names)
+    FunctionNode(RefPtr<Identifier const> name, ByteString source_text, RefPtr<Statement const> body, Vector<FunctionParameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Vector<DeprecatedFlyString> local_variables_names)
         : m_name(move(name))
         , m_source_text(move(source_text))
         , m_body(move(body))
@@ -726,9 +796,19 @@ protected:
     RefPtr<Identifier const> m_name { nullptr };
 
 private:
-    ByteString m_source_text;
-    NonnullRefPtr<Statement const> m_body;
-    Vector<FunctionParameter> const m_parameters;
+    friend class Parser;
+
+    void ensure_parsed() const
+    {
+        if (m_preparsed_data) [[unlikely]]
+            finish_parsing();
+    }
+    void finish_parsing() const;
+
+    mutable ByteString m_source_text;
+    mutable RefPtr<Statement const> m_body;
+    mutable Vector<FunctionParameter> m_parameters;
+    mutable RefPtr<PreparsedFunctionData const> m_preparsed_data;
     i32 const m_function_length;
     FunctionKind m_kind;
     bool m_is_strict_mode : 1 { false };
@@ -736,7 +816,7 @@ private:
     bool m_contains_direct_call_to_eval : 1 { false };
     bool m_is_arrow_function : 1 { false };
 
-    Vector<DeprecatedFlyString> m_local_variables_names;
+    mutable Vector<DeprecatedFlyString> m_local_variables_names;
 };
 
 class FunctionDeclaration final
@@ -745,7 +825,7 @@ class FunctionDeclaration final
 public:
     static bool must_have_name() { return true; }
 
-    FunctionDeclaration(SourceRange source_range, RefPtr<Identifier const> name, ByteString source_text, NonnullRefPtr<Statement const> body, Vector<FunctionParameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval, Vector<DeprecatedFlyString> local_variables_names)
+    FunctionDeclaration(SourceRange source_range, RefPtr<Identifier const> name, ByteString source_text, RefPtr<Statement const> body, Vector<FunctionParameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval, Vector<DeprecatedFlyString> local_variables_names)
         : Declaration(move(source_range))
         , FunctionNode(move(name), move(source_text), move(body), move(parameters), function_length, kind, is_strict_mode, might_need_arguments_object, contains_direct_call_to_eval, false, move(local_variables_names))
     {
@@ -770,12 +850,14 @@ class FunctionExpression final
 public:
     static bool must_have_name() { return false; }
 
-    FunctionExpression(SourceRange source_range, RefPtr<Identifier const> name, ByteString source_text, NonnullRefPtr<Statement const> body, Vector<FunctionParameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval, Vector<DeprecatedFlyString> local_variables_names, bool is_arrow_function = false)
+    FunctionExpression(SourceRange source_range, RefPtr<Identifier const> name, ByteString source_text, RefPtr<Statement const> body, Vector<FunctionParameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval, Vector<DeprecatedFlyString> local_variables_names, bool is_arrow_function = false)
         : Expression(move(source_range))
         , FunctionNode(move(name), move(source_text), move(body), move(parameters), function_length, kind, is_strict_mode, might_need_arguments_object, contains_direct_call_to_eval, is_arrow_function, move(local_variables_names))
     {
     }
 
+    virtual ~FunctionExpression() override;
+
     virtual void dump(int indent) const override;
 
     virtual Bytecode::CodeGenerationErrorOr<Optional<Bytecode::Operand>> generate_bytecode(Bytecode::Generator&, Optional<Bytecode::Operand> preferred_dst = {}) const override;
@@ -1410,6 +1492,8 @@ public:
     {
     }
 
+    virtual ~ClassExpression() override;
+
     StringView name() const { return m_name ? m_name->string().view() : ""sv; }
 
     ByteString const& source_text() const { return m_source_text; }
@@ -2106,6 +2190,8 @@ public:
     {
     }
 
+    virtual ~SwitchStatement() override;
+
     virtual void dump(int indent) const override;
     virtual Bytecode::CodeGenerationErrorOr<Optional<Bytecode::Operand>> generate_bytecode(Bytecode::Generator&, Optional<Bytecode::Operand> preferred_dst = {}) const override;
     virtual Bytecode::CodeGenerationErrorOr<Optional<Bytecode::Operand>> generate_labelled_evaluation(Bytecode::Generator&, Vector<DeprecatedFlyString> const&, Optional<Bytecode::Operand> preferred_dst = {}) const;
@@ -40,7 +40,8 @@ Bytecode::CodeGenerationErrorOr<Optional<Bytecode::Operand>> ScopeNode::generate
     bool did_create_lexical_environment = false;
 
     if (is<BlockStatement>(*this)) {
-        if (has_lexical_declarations()) {
+        // NOTE: Blocks that only declare locals don't need an environment, as locals aren't stored in one.
+        if (has_non_local_lexical_declarations()) {
             generator.block_declaration_instantiation(*this);
             did_create_lexical_environment = true;
         }
@@ -2577,7 +2578,7 @@ Bytecode::CodeGenerationErrorOr<Optional<Bytecode::Operand>> SwitchStatement::ge
     Bytecode::BasicBlock* entry_block_for_default { nullptr };
     Bytecode::BasicBlock* next_test_block = &generator.make_block();
 
-    auto has_lexical_declarations = this->has_lexical_declarations();
+    auto has_lexical_declarations = this->has_non_local_lexical_declarations();
     if (has_lexical_declarations)
         generator.block_declaration_instantiation(*this);
 
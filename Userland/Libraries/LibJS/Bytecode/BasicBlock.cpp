@@ -57,4 +57,23 @@ void BasicBlock::grow(size_t additional_size)
     m_buffer.resize(m_buffer.size() + additional_size);
 }
 
+void BasicBlock::remove_instructions_if(Function<bool(Instruction const&)> const& predicate)
+{
+    size_t new_size = 0;
+    for (size_t offset = 0; offset < m_buffer.size();) {
+        auto& instruction = *reinterpret_cast<Instruction*>(m_buffer.data() + offset);
+        auto length = instruction.length();
+        if (predicate(instruction)) {
+            Instruction::destroy(instruction);
+        } else {
+            // NOTE: Instructions are moved around byte by byte when the buffer grows as well.
+            if (new_size != offset)
+                memmove(m_buffer.data() + new_size, m_buffer.data() + offset, length);
+            new_size += length;
+        }
+        offset += length;
+    }
+    m_buffer.shrink(new_size);
+}
+
 }
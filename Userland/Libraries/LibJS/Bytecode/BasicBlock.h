@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Badge.h>
+#include <AK/Function.h>
 #include <AK/String.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Handle.h>
@@ -34,6 +35,7 @@ public:
     size_t size() const { return m_buffer.size(); }
 
     void grow(size_t additional_size);
+    void remove_instructions_if(Function<bool(Instruction const&)> const&);
 
     void terminate(Badge<Generator>) { m_terminated = true; }
     bool is_terminated() const { return m_terminated; }
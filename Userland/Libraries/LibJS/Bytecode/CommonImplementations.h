@@ -103,6 +103,135 @@ ALWAYS_INLINE ThrowCompletionOr<NonnullGCPtr<Object>> base_object_for_get(VM& vm
     return throw_null_or_undefined_property_access(vm, base_value, base_identifier, property_identifier);
 }
 
+// Reads the property through a cache entry for the shape of the object, if the entry is still valid.
+ALWAYS_INLINE Optional<Value> get_with_cache_entry(VM& vm, Object const& object, PropertyLookupCache::Entry const& entry)
+{
+    if (entry.shape_epoch != 0 && entry.shape_epoch != vm.shape_epoch())
+        return {};
+
+    Value value;
+    switch (entry.type) {
+    case PropertyLookupCache::Entry::Type::OwnProperty:
+        value = object.get_direct(entry.property_offset);
+        break;
+    case PropertyLookupCache::Entry::Type::InPrototypeChain:
+        if (object.may_interfere_with_prototype_chain_caching())
+            return {};
+        value = entry.prototype->get_direct(entry.property_offset);
+        break;
+    case PropertyLookupCache::Entry::Type::AddOwnProperty:
+        return {};
+    }
+
+    // NOTE: A data property can become an accessor without changing its attributes, and thus the shape.
+    if (value.is_accessor())
+        return {};
+    return value;
+}
+
+// Writes the property through a cache entry for the shape of the object, if the entry is still valid.
+ALWAYS_INLINE bool put_with_cache_entry(VM& vm, Object& object, Value value, PropertyLookupCache::Entry const& entry)
+{
+    if (entry.shape_epoch != 0 && entry.shape_epoch != vm.shape_epoch())
+        return false;
+
+    switch (entry.type) {
+    case PropertyLookupCache::Entry::Type::OwnProperty:
+        object.put_direct(entry.property_offset, value);
+        return true;
+    case PropertyLookupCache::Entry::Type::AddOwnProperty:
+        // NOTE: Adding properties to prototypes has to go the slow way, as it invalidates caches.
+        if (object.may_interfere_with_prototype_chain_caching() || object.is_used_as_prototype() || !entry.new_shape)
+            return false;
+        return object.put_direct_with_transition(*entry.new_shape, value);
+    case PropertyLookupCache::Entry::Type::InPrototypeChain:
+        return false;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+enum class PropertyLookupCacheKind {
+    Get,
+    Put,
+};
+
+template<PropertyLookupCacheKind kind>
+ALWAYS_INLINE MegamorphicPropertyLookupCache::Entry& megamorphic_cache_entry(MegamorphicPropertyLookupCache& cache, Shape const& shape, DeprecatedFlyString const& property)
+{
+    if constexpr (kind == PropertyLookupCacheKind::Get)
+        return cache.get_entry(shape, property);
+    else
+        return cache.put_entry(shape, property);
+}
+
+// Finds the cache entry for the shape of the object, in the inline cache of the instruction, or in the megamorphic
+// cache once the instruction has seen too many shapes. The callback decides whether the entry could be used.
+template<PropertyLookupCacheKind kind, typename Callback>
+ALWAYS_INLINE bool use_property_lookup_cache(VM& vm, Object const& object, DeprecatedFlyString const& property, PropertyLookupCache& cache, Callback callback)
+{
+    auto const& shape = object.shape();
+
+    if (!cache.is_megamorphic) [[likely]] {
+        for (auto const& entry : cache.entries) {
+            if (entry.shape.ptr() != &shape)
+                continue;
+            if (!callback(entry))
+                return false;
+            ++cache.hits;
+            return true;
+        }
+        return false;
+    }
+
+    auto& megamorphic_cache = vm.bytecode_interpreter().megamorphic_property_lookup_cache();
+    auto& megamorphic_entry = megamorphic_cache_entry<kind>(megamorphic_cache, shape, property);
+    if (megamorphic_entry.entry.shape.ptr() != &shape || megamorphic_entry.property_name != property || !callback(megamorphic_entry.entry)) {
+        ++megamorphic_cache.misses;
+        return false;
+    }
+    ++megamorphic_cache.hits;
+    ++cache.hits;
+    return true;
+}
+
+template<PropertyLookupCacheKind kind>
+inline void add_property_lookup_cache_entry(VM& vm, DeprecatedFlyString const& property, PropertyLookupCache& cache, PropertyLookupCache::Entry new_entry)
+{
+    auto& shape = *new_entry.shape;
+
+    if (!cache.is_megamorphic) {
+        // NOTE: Entries for shapes that have been garbage collected, or that are no longer valid, are replaced first.
+        for (auto& entry : cache.entries) {
+            if (!entry.shape || entry.shape.ptr() == new_entry.shape.ptr()) {
+                entry = move(new_entry);
+                return;
+            }
+        }
+        cache.is_megamorphic = true;
+        cache.entries = {};
+    }
+
+    auto& megamorphic_cache = vm.bytecode_interpreter().megamorphic_property_lookup_cache();
+    megamorphic_cache_entry<kind>(megamorphic_cache, shape, property) = { property, move(new_entry) };
+}
+
+inline Optional<Value> get_by_id_from_cache(VM& vm, Object const& object, DeprecatedFlyString const& property, PropertyLookupCache& cache)
+{
+    Optional<Value> value;
+    use_property_lookup_cache<PropertyLookupCacheKind::Get>(vm, object, property, cache, [&](auto const& entry) {
+        value = get_with_cache_entry(vm, object, entry);
+        return value.has_value();
+    });
+    return value;
+}
+
+inline bool put_by_id_to_cache(VM& vm, Object& object, DeprecatedFlyString const& property, Value value, PropertyLookupCache& cache)
+{
+    return use_property_lookup_cache<PropertyLookupCacheKind::Put>(vm, object, property, cache, [&](auto const& entry) {
+        return put_with_cache_entry(vm, object, value, entry);
+    });
+}
+
 inline ThrowCompletionOr<Value> get_by_id(VM& vm, Optional<DeprecatedFlyString const&> const& base_identifier, DeprecatedFlyString const& property, Value base_value, Value this_value, PropertyLookupCache& cache)
 {
     if (base_value.is_string()) {
@@ -118,18 +247,43 @@ inline ThrowCompletionOr<Value> get_by_id(VM& vm, Optional<DeprecatedFlyString c
         return Value { base_obj->indexed_properties().array_like_size() };
     }
 
-    // OPTIMIZATION: If the shape of the object hasn't changed, we can use the cached property offset.
-    auto& shape = base_obj->shape();
-    if (&shape == cache.shape) {
-        return base_obj->get_direct(cache.property_offset.value());
-    }
+    // OPTIMIZATION: If we've seen objects with this shape before, we can use the cached property location.
+    if (auto value = get_by_id_from_cache(vm, base_obj, property, cache); value.has_value())
+        return *value;
+    ++cache.misses;
 
+    NonnullGCPtr<Shape> shape = base_obj->shape();
     CacheablePropertyMetadata cacheable_metadata;
     auto value = TRY(base_obj->internal_get(property, this_value, &cacheable_metadata));
 
-    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-        cache.shape = shape;
-        cache.property_offset = cacheable_metadata.property_offset.value();
+    if (&base_obj->shape() != shape.ptr())
+        return value;
+
+    switch (cacheable_metadata.type) {
+    case CacheablePropertyMetadata::Type::OwnProperty:
+        add_property_lookup_cache_entry<PropertyLookupCacheKind::Get>(vm, property, cache,
+            {
+                .shape = *shape,
+                .shape_epoch = shape->is_dictionary() ? vm.shape_epoch() : 0,
+                .property_offset = cacheable_metadata.property_offset.value(),
+                .type = PropertyLookupCache::Entry::Type::OwnProperty,
+            });
+        break;
+    case CacheablePropertyMetadata::Type::InPrototypeChain:
+        // NOTE: Dictionary shapes can gain properties in place, which would shadow the one in the prototype chain.
+        if (shape->is_dictionary() || base_obj->may_interfere_with_prototype_chain_caching())
+            break;
+        add_property_lookup_cache_entry<PropertyLookupCacheKind::Get>(vm, property, cache,
+            {
+                .shape = *shape,
+                .prototype = cacheable_metadata.prototype,
+                .shape_epoch = vm.shape_epoch(),
+                .property_offset = cacheable_metadata.property_offset.value(),
+                .type = PropertyLookupCache::Entry::Type::InPrototypeChain,
+            });
+        break;
+    default:
+        break;
     }
 
     return value;
@@ -144,9 +298,16 @@ inline ThrowCompletionOr<Value> get_by_value(VM& vm, Optional<DeprecatedFlyStrin
 
         auto const* object_storage = object.indexed_properties().storage();
 
+        // For arrays in simple storage, which never holds accessors:
+        if (auto const* simple_storage = object.simple_indexed_property_storage(); simple_storage && index < simple_storage->array_like_size()) {
+            auto value = simple_storage->elements()[index];
+            if (simple_storage->is_packed() || !value.is_empty())
+                return value;
+        }
+
         // For "non-typed arrays":
         if (!object.may_interfere_with_indexed_property_access()
-            && object_storage) {
+            && object_storage && !object_storage->is_simple_storage()) {
             auto maybe_value = object_storage->get(index);
             if (maybe_value.has_value()) {
                 auto value = maybe_value->value;
@@ -280,17 +441,48 @@ inline ThrowCompletionOr<void> put_by_property_key(VM& vm, Value base, Value thi
         break;
     }
     case Op::PropertyKind::KeyValue: {
-        if (cache && cache->shape == &object->shape()) {
-            object->put_direct(*cache->property_offset, value);
+        // NOTE: The cache only knows where the property is in the base object, so it can't be used with another receiver.
+        if (!name.is_string() || !this_value.is_object() || &this_value.as_object() != object.ptr())
+            cache = nullptr;
+
+        if (cache && put_by_id_to_cache(vm, object, name.as_string(), value, *cache))
             return {};
-        }
+        if (cache)
+            ++cache->misses;
 
+        NonnullGCPtr<Shape> old_shape = object->shape();
         CacheablePropertyMetadata cacheable_metadata;
-        bool succeeded = TRY(object->internal_set(name, value, this_value, &cacheable_metadata));
+        bool succeeded = TRY(object->internal_set(name, value, this_value, cache ? &cacheable_metadata : nullptr));
+
+        if (succeeded && cache && cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty && &object->shape() == old_shape.ptr()) {
+            add_property_lookup_cache_entry<PropertyLookupCacheKind::Put>(vm, name.as_string(), *cache,
+                {
+                    .shape = *old_shape,
+                    .shape_epoch = old_shape->is_dictionary() ? vm.shape_epoch() : 0,
+                    .property_offset = cacheable_metadata.property_offset.value(),
+                    .type = PropertyLookupCache::Entry::Type::OwnProperty,
+                });
+        }
 
-        if (succeeded && cache && cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-            cache->shape = object->shape();
-            cache->property_offset = cacheable_metadata.property_offset.value();
+        // NOTE: Only simple put transitions are cached, not ones into (or within) dictionaries. Arrays keep their
+        //       "length" outside of the shape, so it must never be added through a transition cached for an object
+        //       that happened to have the same shape.
+        if (succeeded && cache && cacheable_metadata.type == CacheablePropertyMetadata::Type::AddOwnProperty
+            && !object->may_interfere_with_prototype_chain_caching() && !object->is_used_as_prototype()
+            && name.as_string() != vm.names.length.as_string()) {
+            auto& new_shape = object->shape();
+            auto metadata = new_shape.lookup(name.to_string_or_symbol());
+            if (!old_shape->is_dictionary() && !new_shape.is_dictionary() && new_shape.property_count() == old_shape->property_count() + 1
+                && metadata.has_value() && metadata->offset == old_shape->property_count()) {
+                add_property_lookup_cache_entry<PropertyLookupCacheKind::Put>(vm, name.as_string(), *cache,
+                    {
+                        .shape = *old_shape,
+                        .new_shape = new_shape,
+                        .shape_epoch = vm.shape_epoch(),
+                        .property_offset = metadata->offset,
+                        .type = PropertyLookupCache::Entry::Type::AddOwnProperty,
+                    });
+            }
         }
 
         if (!succeeded && vm.in_strict_mode()) {
@@ -404,7 +596,7 @@ inline Value new_function(VM& vm, FunctionExpression const& function_node, Optio
             name = vm.bytecode_interpreter().current_executable().get_identifier(lhs_name.value());
         value = function_node.instantiate_ordinary_function_expression(vm, name);
     } else {
-        value = ECMAScriptFunctionObject::create(*vm.current_realm(), function_node.name(), function_node.source_text(), function_node.body(), function_node.parameters(), function_node.function_length(), function_node.local_variables_names(), vm.lexical_environment(), vm.running_execution_context().private_environment, function_node.kind(), function_node.is_strict_mode(), function_node.might_need_arguments_object(), function_node.contains_direct_call_to_eval(), function_node.is_arrow_function());
+        value = ECMAScriptFunctionObject::create(*vm.current_realm(), function_node.name(), function_node, vm.lexical_environment(), vm.running_execution_context().private_environment);
     }
 
     if (home_object.has_value()) {
@@ -421,21 +613,14 @@ inline ThrowCompletionOr<void> put_by_value(VM& vm, Value base, Optional<Depreca
     if ((kind == Op::PropertyKind::KeyValue || kind == Op::PropertyKind::DirectKeyValue)
         && base.is_object() && property_key_value.is_int32() && property_key_value.as_i32() >= 0) {
         auto& object = base.as_object();
-        auto* storage = object.indexed_properties().storage();
         auto index = static_cast<u32>(property_key_value.as_i32());
 
-        // For "non-typed arrays":
-        if (storage
-            && storage->is_simple_storage()
-            && !object.may_interfere_with_indexed_property_access()) {
-            auto maybe_value = storage->get(index);
-            if (maybe_value.has_value()) {
-                auto existing_value = maybe_value->value;
-                if (!existing_value.is_accessor()) {
-                    storage->put(index, value);
-                    return {};
-                }
-            }
+        // For "non-typed arrays", overwriting an element that's already there (simple storage has no accessors):
+        if (auto* storage = object.simple_indexed_property_storage();
+            storage && index < storage->array_like_size()
+            && (storage->is_packed() || !storage->elements()[index].is_empty())) {
+            storage->put(index, value);
+            return {};
         }
 
         // For typed arrays:
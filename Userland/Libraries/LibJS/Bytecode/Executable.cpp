@@ -4,9 +4,17 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/MemoryStream.h>
+#include <LibJS/AST.h>
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Op.h>
 #include <LibJS/Bytecode/RegexTable.h>
+#include <LibJS/Heap/DeferGC.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <LibJS/Runtime/BigInt.h>
+#include <LibJS/Runtime/PrimitiveString.h>
+#include <LibJS/Runtime/VM.h>
 #include <LibJS/SourceCode.h>
 
 namespace JS::Bytecode {
@@ -50,6 +58,349 @@ void Executable::dump() const
     warnln("");
 }
 
+// The serialized form is the instruction stream of each block as it is in memory, except that labels hold the index of
+// their block and AST node pointers hold an index into a table of node offsets. That makes it specific to the build,
+// which BytecodeCache makes sure of.
+
+enum class ConstantType : u8 {
+    Primitive,
+    String,
+    BigInt,
+};
+
+static constexpr size_t number_of_instruction_types = 0
+#define __BYTECODE_OP(op) +1
+    ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    ;
+
+template<typename T>
+static constexpr SourceCode::NodeKind node_kind()
+{
+    if constexpr (IsSame<T, FunctionExpression>)
+        return SourceCode::NodeKind::FunctionExpression;
+    else if constexpr (IsSame<T, ClassExpression>)
+        return SourceCode::NodeKind::ClassExpression;
+    else
+        return SourceCode::NodeKind::Scope;
+}
+
+static ErrorOr<void> write_string(Stream& stream, StringView string)
+{
+    TRY(stream.write_value<u32>(string.length()));
+    TRY(stream.write_until_depleted(string.bytes()));
+    return {};
+}
+
+static ErrorOr<ByteString> read_string(FixedMemoryStream& stream)
+{
+    auto length = TRY(stream.read_value<u32>());
+    auto bytes = TRY(stream.read_in_place<u8 const>(length));
+    return ByteString { bytes };
+}
+
+static ErrorOr<void> write_index(Stream& stream, Optional<size_t> index)
+{
+    TRY(stream.write_value<u32>(index.has_value() ? *index + 1 : 0));
+    return {};
+}
+
+static ErrorOr<Optional<size_t>> read_index(FixedMemoryStream& stream, size_t count)
+{
+    auto index = TRY(stream.read_value<u32>());
+    if (index == 0)
+        return Optional<size_t> {};
+    if (index > count)
+        return AK::Error::from_string_literal("Index out of range");
+    return Optional<size_t> { index - 1 };
+}
+
+ErrorOr<ByteBuffer> Executable::serialize() const
+{
+    AllocatingMemoryStream stream;
+
+    TRY(write_string(stream, name));
+    TRY(stream.write_value<u8>(is_strict_mode));
+    TRY(stream.write_value<u32>(number_of_registers));
+    TRY(stream.write_value<u32>(property_lookup_caches.size()));
+    TRY(stream.write_value<u32>(global_variable_caches.size()));
+    TRY(stream.write_value<u32>(environment_variable_caches.size()));
+
+    TRY(stream.write_value<u32>(identifier_table->size()));
+    for (size_t i = 0; i < identifier_table->size(); ++i)
+        TRY(write_string(stream, identifier_table->get(i)));
+
+    TRY(stream.write_value<u32>(string_table->size()));
+    for (size_t i = 0; i < string_table->size(); ++i)
+        TRY(write_string(stream, string_table->get(i)));
+
+    // NOTE: Only the source of the regular expressions is kept, they're compiled again when the bytecode is loaded.
+    TRY(stream.write_value<u32>(regex_table->size()));
+    for (size_t i = 0; i < regex_table->size(); ++i) {
+        auto const& regex = regex_table->get(i);
+        TRY(write_string(stream, regex.pattern));
+        TRY(stream.write_value<u32>(to_underlying(regex.flags.value())));
+    }
+
+    TRY(stream.write_value<u32>(constants.size()));
+    for (auto const& constant : constants) {
+        if (constant.is_string()) {
+            TRY(stream.write_value(ConstantType::String));
+            TRY(write_string(stream, constant.as_string().byte_string()));
+        } else if (constant.is_bigint()) {
+            TRY(stream.write_value(ConstantType::BigInt));
+            TRY(write_string(stream, constant.as_bigint().big_integer().to_base_deprecated(10)));
+        } else if (!constant.is_cell()) {
+            TRY(stream.write_value(ConstantType::Primitive));
+            TRY(stream.write_value<u64>(constant.encoded()));
+        } else {
+            return AK::Error::from_string_literal("Constant can't be serialized");
+        }
+    }
+
+    HashMap<BasicBlock const*, size_t> block_indices;
+    for (size_t i = 0; i < basic_blocks.size(); ++i)
+        block_indices.set(basic_blocks[i].ptr(), i);
+
+    struct NodeReference {
+        SourceCode::NodeKind kind;
+        u32 start_offset { 0 };
+        u32 end_offset { 0 };
+    };
+    Vector<NodeReference> node_references;
+    HashMap<ASTNode const*, size_t> node_indices;
+
+    TRY(stream.write_value<u32>(basic_blocks.size()));
+    for (auto const& block : basic_blocks) {
+        TRY(write_string(stream, block->name()));
+        TRY(write_index(stream, block->handler() ? block_indices.get(block->handler()).value() : Optional<size_t> {}));
+        TRY(write_index(stream, block->finalizer() ? block_indices.get(block->finalizer()).value() : Optional<size_t> {}));
+
+        auto instructions = TRY(ByteBuffer::copy(block->instruction_stream()));
+        for (size_t offset = 0; offset < instructions.size();) {
+            auto& instruction = *reinterpret_cast<Instruction*>(instructions.data() + offset);
+            offset += instruction.length();
+
+            switch (instruction.type()) {
+            case Instruction::Type::Dump:
+                return AK::Error::from_string_literal("Dump can't be serialized");
+            case Instruction::Type::IteratorClose:
+                if (auto const& value = static_cast<Op::IteratorClose const&>(instruction).completion_value(); value.has_value() && value->is_cell())
+                    return AK::Error::from_string_literal("Completion value can't be serialized");
+                break;
+            case Instruction::Type::AsyncIteratorClose:
+                if (auto const& value = static_cast<Op::AsyncIteratorClose const&>(instruction).completion_value(); value.has_value() && value->is_cell())
+                    return AK::Error::from_string_literal("Completion value can't be serialized");
+                break;
+            case Instruction::Type::NewPrimitiveArray:
+                for (auto const& element : static_cast<Op::NewPrimitiveArray const&>(instruction).elements()) {
+                    if (element.is_cell())
+                        return AK::Error::from_string_literal("Array element can't be serialized");
+                }
+                break;
+            default:
+                break;
+            }
+
+            instruction.visit_labels([&](Label& label) {
+                FlatPtr index = block_indices.get(&label.block()).value();
+                static_assert(sizeof(index) == sizeof(label));
+                __builtin_memcpy(static_cast<void*>(&label), &index, sizeof(index));
+            });
+
+            ErrorOr<void> result {};
+            instruction.visit_ast_nodes([&]<typename T>(T const*& node) {
+                auto kind = node_kind<T>();
+                if (source_code->find_node(kind, node->start_offset(), node->end_offset()) != node) {
+                    result = AK::Error::from_string_literal("AST node can't be found by its offsets");
+                    return;
+                }
+                FlatPtr index = node_indices.ensure(node, [&] {
+                    node_references.append({ kind, node->start_offset(), node->end_offset() });
+                    return node_references.size() - 1;
+                });
+                static_assert(sizeof(index) == sizeof(node));
+                __builtin_memcpy(&node, &index, sizeof(index));
+            });
+            TRY(result);
+        }
+
+        TRY(stream.write_value<u32>(instructions.size()));
+        TRY(stream.write_until_depleted(instructions));
+    }
+
+    TRY(stream.write_value<u32>(node_references.size()));
+    for (auto const& node_reference : node_references) {
+        TRY(stream.write_value(node_reference.kind));
+        TRY(stream.write_value(node_reference.start_offset));
+        TRY(stream.write_value(node_reference.end_offset));
+    }
+
+    return stream.read_until_eof();
+}
+
+ErrorOr<NonnullGCPtr<Executable>> Executable::deserialize(VM& vm, ReadonlyBytes bytes, NonnullRefPtr<SourceCode const> source_code, ASTNode const& root)
+{
+    // The constants aren't visible to the GC until the executable is allocated.
+    DeferGC defer_gc(vm.heap());
+
+    FixedMemoryStream stream { bytes };
+
+    auto name = TRY(read_string(stream));
+    auto is_strict_mode = TRY(stream.read_value<u8>()) != 0;
+    auto number_of_registers = TRY(stream.read_value<u32>());
+    auto number_of_property_lookup_caches = TRY(stream.read_value<u32>());
+    auto number_of_global_variable_caches = TRY(stream.read_value<u32>());
+    auto number_of_environment_variable_caches = TRY(stream.read_value<u32>());
+
+    auto identifier_table = make<IdentifierTable>();
+    auto number_of_identifiers = TRY(stream.read_value<u32>());
+    for (u32 i = 0; i < number_of_identifiers; ++i)
+        identifier_table->insert(TRY(read_string(stream)));
+
+    auto string_table = make<StringTable>();
+    auto number_of_strings = TRY(stream.read_value<u32>());
+    for (u32 i = 0; i < number_of_strings; ++i)
+        string_table->insert(TRY(read_string(stream)));
+
+    auto regex_table = make<RegexTable>();
+    auto number_of_regexes = TRY(stream.read_value<u32>());
+    for (u32 i = 0; i < number_of_regexes; ++i) {
+        auto pattern = TRY(read_string(stream));
+        regex::RegexOptions<ECMAScriptFlags> flags { static_cast<ECMAScriptFlags>(TRY(stream.read_value<u32>())) };
+        auto regex = Regex<ECMA262>::parse_pattern(pattern, flags);
+        if (regex.error != regex::Error::NoError)
+            return AK::Error::from_string_literal("Regular expression doesn't compile");
+        regex_table->insert({ .regex = move(regex), .pattern = move(pattern), .flags = flags });
+    }
+
+    Vector<Value> constants;
+    auto number_of_constants = TRY(stream.read_value<u32>());
+    TRY(constants.try_ensure_capacity(number_of_constants));
+    for (u32 i = 0; i < number_of_constants; ++i) {
+        switch (TRY(stream.read_value<ConstantType>())) {
+        case ConstantType::Primitive: {
+            auto value = bit_cast<Value>(TRY(stream.read_value<u64>()));
+            if (value.is_cell())
+                return AK::Error::from_string_literal("Constant is a cell");
+            constants.unchecked_append(value);
+            break;
+        }
+        case ConstantType::String:
+            constants.unchecked_append(PrimitiveString::create(vm, TRY(read_string(stream))));
+            break;
+        case ConstantType::BigInt:
+            constants.unchecked_append(BigInt::create(vm, TRY(Crypto::SignedBigInteger::from_base(10, TRY(read_string(stream))))));
+            break;
+        default:
+            return AK::Error::from_string_literal("Unknown constant type");
+        }
+    }
+
+    Vector<NonnullOwnPtr<BasicBlock>> basic_blocks;
+    Vector<Optional<size_t>> handlers;
+    Vector<Optional<size_t>> finalizers;
+    auto number_of_blocks = TRY(stream.read_value<u32>());
+    for (u32 i = 0; i < number_of_blocks; ++i) {
+        auto block = BasicBlock::create(TRY(String::from_byte_string(TRY(read_string(stream)))));
+        handlers.append(TRY(read_index(stream, number_of_blocks)));
+        finalizers.append(TRY(read_index(stream, number_of_blocks)));
+
+        auto size = TRY(stream.read_value<u32>());
+        auto instructions = TRY(stream.read_in_place<u8 const>(size));
+        for (size_t offset = 0; offset < size;) {
+            if (size - offset < sizeof(Instruction))
+                return AK::Error::from_string_literal("Truncated instruction");
+            auto const& instruction = *reinterpret_cast<Instruction const*>(instructions.data() + offset);
+            if (static_cast<size_t>(to_underlying(instruction.type())) >= number_of_instruction_types || instruction.length() < sizeof(Instruction) || instruction.length() % alignof(void*) != 0 || instruction.length() > size - offset)
+                return AK::Error::from_string_literal("Invalid instruction");
+            offset += instruction.length();
+        }
+
+        // NOTE: Destroying an instruction doesn't look at its labels or AST nodes, so it's fine to bail out before they've
+        //       been fixed up below.
+        block->grow(size);
+        __builtin_memcpy(block->data(), instructions.data(), size);
+        basic_blocks.append(move(block));
+    }
+
+    for (size_t i = 0; i < basic_blocks.size(); ++i) {
+        if (handlers[i].has_value())
+            basic_blocks[i]->set_handler(*basic_blocks[*handlers[i]]);
+        if (finalizers[i].has_value())
+            basic_blocks[i]->set_finalizer(*basic_blocks[*finalizers[i]]);
+    }
+
+    struct NodeReference {
+        SourceCode::NodeKind kind;
+        ASTNode const* node { nullptr };
+    };
+    Vector<NodeReference> node_references;
+    Vector<NonnullRefPtr<ASTNode const>> referenced_nodes;
+    auto number_of_nodes = TRY(stream.read_value<u32>());
+    for (u32 i = 0; i < number_of_nodes; ++i) {
+        auto kind = TRY(stream.read_value<SourceCode::NodeKind>());
+        auto start_offset = TRY(stream.read_value<u32>());
+        auto end_offset = TRY(stream.read_value<u32>());
+        auto const* node = source_code->find_node(kind, start_offset, end_offset);
+        if (!node)
+            return AK::Error::from_string_literal("AST node not found");
+        node_references.append({ kind, node });
+
+        // NOTE: The root keeps the executable alive, which mustn't keep the root alive in turn.
+        if (node != &root)
+            referenced_nodes.append(*node);
+    }
+
+    if (!stream.is_eof())
+        return AK::Error::from_string_literal("Trailing data");
+
+    for (auto& block : basic_blocks) {
+        for (size_t offset = 0; offset < block->size();) {
+            auto& instruction = *reinterpret_cast<Instruction*>(block->data() + offset);
+            offset += instruction.length();
+
+            bool is_valid = true;
+            instruction.visit_labels([&](Label& label) {
+                FlatPtr index;
+                __builtin_memcpy(&index, &label, sizeof(index));
+                if (index >= basic_blocks.size()) {
+                    is_valid = false;
+                    return;
+                }
+                label = Label { *basic_blocks[index] };
+            });
+            instruction.visit_ast_nodes([&]<typename T>(T const*& node) {
+                FlatPtr index;
+                __builtin_memcpy(&index, &node, sizeof(index));
+                if (index >= node_references.size() || node_references[index].kind != node_kind<T>()) {
+                    is_valid = false;
+                    return;
+                }
+                node = static_cast<T const*>(node_references[index].node);
+            });
+            if (!is_valid)
+                return AK::Error::from_string_literal("Invalid label or AST node");
+        }
+    }
+
+    auto executable = vm.heap().allocate_without_realm<Executable>(
+        move(identifier_table),
+        move(string_table),
+        move(regex_table),
+        move(constants),
+        move(source_code),
+        number_of_property_lookup_caches,
+        number_of_global_variable_caches,
+        number_of_environment_variable_caches,
+        number_of_registers,
+        move(basic_blocks),
+        is_strict_mode);
+    executable->name = name;
+    executable->referenced_nodes = move(referenced_nodes);
+    return executable;
+}
+
 void Executable::visit_edges(Visitor& visitor)
 {
     Base::visit_edges(visitor);
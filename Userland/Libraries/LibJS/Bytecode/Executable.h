@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/ByteBuffer.h>
 #include <AK/DeprecatedFlyString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
@@ -21,12 +23,73 @@
 
 namespace JS::Bytecode {
 
+// The inline cache of a single GetById or PutById instruction. It remembers up to a few shapes that the instruction
+// has seen, and sites that see more than that share the interpreter's megamorphic cache instead.
 struct PropertyLookupCache {
-    WeakPtr<Shape> shape;
-    Optional<u32> property_offset;
+    static constexpr size_t max_number_of_shapes = 4;
+
+    struct Entry {
+        enum class Type : u8 {
+            // Objects with the shape have the property at the offset.
+            OwnProperty,
+
+            // The prototype has the property at the offset, and is in the prototype chain of objects with the shape.
+            InPrototypeChain,
+
+            // Putting the property into objects with the shape adds it at the offset, which makes their shape new_shape.
+            AddOwnProperty,
+        };
+
+        WeakPtr<Shape> shape {};
+        WeakPtr<Shape> new_shape {};
+
+        // NOTE: This is kept alive by the prototype chain of the shape for as long as the entry is valid.
+        RawGCPtr<Object const> prototype {};
+
+        // If not 0, the entry is only valid while VM::shape_epoch() is the same.
+        u64 shape_epoch { 0 };
+
+        u32 property_offset { 0 };
+        Type type { Type::OwnProperty };
+    };
+
+    AK::Array<Entry, max_number_of_shapes> entries;
+    bool is_megamorphic { false };
+
+    // How often the instruction found the property through the cache, or had to look it up the slow way.
+    u32 hits { 0 };
+    u32 misses { 0 };
 };
 
-struct GlobalVariableCache : public PropertyLookupCache {
+// A direct-mapped cache of property lookups, keyed by shape and property name, that all megamorphic sites share.
+class MegamorphicPropertyLookupCache {
+public:
+    static constexpr size_t number_of_entries = 1024;
+
+    struct Entry {
+        DeprecatedFlyString property_name;
+        PropertyLookupCache::Entry entry;
+    };
+
+    Entry& get_entry(Shape const& shape, DeprecatedFlyString const& property_name) { return m_get_entries[index_of(shape, property_name)]; }
+    Entry& put_entry(Shape const& shape, DeprecatedFlyString const& property_name) { return m_put_entries[index_of(shape, property_name)]; }
+
+    size_t hits { 0 };
+    size_t misses { 0 };
+
+private:
+    static size_t index_of(Shape const& shape, DeprecatedFlyString const& property_name)
+    {
+        return pair_int_hash(ptr_hash(&shape), property_name.hash()) % number_of_entries;
+    }
+
+    AK::Array<Entry, number_of_entries> m_get_entries;
+    AK::Array<Entry, number_of_entries> m_put_entries;
+};
+
+struct GlobalVariableCache {
+    WeakPtr<Shape> shape;
+    Optional<u32> property_offset;
     u64 environment_serial_number { 0 };
 };
 
@@ -71,6 +134,11 @@ public:
     size_t number_of_registers { 0 };
     bool is_strict_mode { false };
 
+    // The number of times the interpreter has entered a block of this executable, which decides when it gets compiled.
+    u32 hotness { 0 };
+    bool did_try_jitting { false };
+    OwnPtr<JIT::NativeExecutable> native_executable;
+
     ByteString const& get_string(StringTableIndex index) const { return string_table->get(index); }
     DeprecatedFlyString const& get_identifier(IdentifierTableIndex index) const { return identifier_table->get(index); }
 
@@ -83,6 +151,15 @@ public:
 
     void dump() const;
 
+    // A serialized form for the bytecode cache. It fails for bytecode that refers to anything other than primitive
+    // constants and the AST nodes that SourceCode::find_node() can find again.
+    ErrorOr<ByteBuffer> serialize() const;
+    static ErrorOr<NonnullGCPtr<Executable>> deserialize(VM&, ReadonlyBytes, NonnullRefPtr<SourceCode const>, ASTNode const& root);
+
+    // For bytecode that was loaded from the bytecode cache, the AST nodes that it refers to. These may come from another
+    // parse of the same source text than the root node, which doesn't keep them alive.
+    Vector<NonnullRefPtr<ASTNode const>> referenced_nodes;
+
 private:
     virtual void visit_edges(Visitor&) override;
 };
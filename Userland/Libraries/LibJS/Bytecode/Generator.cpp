@@ -10,6 +10,7 @@
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Instruction.h>
 #include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/Optimizer.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Runtime/VM.h>
 
@@ -73,6 +74,8 @@ CodeGenerationErrorOr<NonnullGCPtr<Executable>> Generator::generate(VM& vm, ASTN
     else if (is<FunctionExpression>(node))
         is_strict_mode = static_cast<FunctionExpression const&>(node).is_strict_mode();
 
+    auto number_of_registers = Optimizer::optimize(generator.m_root_basic_blocks, generator.m_next_register);
+
     auto executable = vm.heap().allocate_without_realm<Executable>(
         move(generator.m_identifier_table),
         move(generator.m_string_table),
@@ -82,7 +85,7 @@ CodeGenerationErrorOr<NonnullGCPtr<Executable>> Generator::generate(VM& vm, ASTN
         generator.m_next_property_lookup_cache,
         generator.m_next_global_variable_cache,
         generator.m_next_environment_variable_cache,
-        generator.m_next_register,
+        number_of_registers,
         move(generator.m_root_basic_blocks),
         is_strict_mode);
 
@@ -25,6 +25,7 @@ public:
     DeprecatedFlyString const& get(IdentifierTableIndex) const;
     void dump() const;
     bool is_empty() const { return m_identifiers.is_empty(); }
+    size_t size() const { return m_identifiers.size(); }
 
 private:
     Vector<DeprecatedFlyString> m_identifiers;
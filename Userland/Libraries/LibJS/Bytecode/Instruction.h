@@ -122,6 +122,16 @@
 
 namespace JS::Bytecode {
 
+// How an instruction uses one of its operands.
+enum class OperandAccess {
+    Read,
+    Write,
+    ReadWrite,
+
+    // The operand is the first or last of a range of registers that are all read, so they have to stay next to each other.
+    ReadRange,
+};
+
 class alignas(void*) Instruction {
 public:
     constexpr static bool IsTerminator = false;
@@ -139,6 +149,23 @@ public:
     ThrowCompletionOr<void> execute(Bytecode::Interpreter&) const;
     static void destroy(Instruction&);
 
+    // Calls visitor(Operand&, OperandAccess) for every operand of the instruction. Every op declares visit_operands_impl(),
+    // even when it has no operands, so that one can't be left out by accident.
+    template<typename Visitor>
+    void visit_operands(Visitor&&);
+
+    // Calls visitor(Label&) for every block the instruction can go on to, and visitor(T const*&) for every AST node it
+    // refers to. Unlike operands, only the few ops that have them declare these.
+    template<typename Visitor>
+    void visit_labels(Visitor&&);
+    template<typename Visitor>
+    void visit_ast_nodes(Visitor&&);
+
+    template<typename Visitor>
+    void visit_labels_impl(Visitor&&) { }
+    template<typename Visitor>
+    void visit_ast_nodes_impl(Visitor&&) { }
+
     // FIXME: Find a better way to organize this information
     void set_source_record(SourceRecord rec) { m_source_record = rec; }
     SourceRecord source_record() const { return m_source_record; }
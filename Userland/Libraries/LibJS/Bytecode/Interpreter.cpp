@@ -6,6 +6,7 @@
 
 #include <AK/Debug.h>
 #include <AK/HashTable.h>
+#include <AK/QuickSort.h>
 #include <AK/TemporaryChange.h>
 #include <LibJS/AST.h>
 #include <LibJS/Bytecode/BasicBlock.h>
@@ -15,6 +16,9 @@
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Label.h>
 #include <LibJS/Bytecode/Op.h>
+#include <LibJS/BytecodeCache.h>
+#include <LibJS/Heap/HeapBlock.h>
+#include <LibJS/JIT/Compiler.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/BigInt.h>
@@ -228,21 +232,27 @@ ThrowCompletionOr<Value> Interpreter::run(Script& script_record, JS::GCPtr<Envir
 
     // 13. If result.[[Type]] is normal, then
     if (result.type() == Completion::Type::Normal) {
-        auto executable_result = JS::Bytecode::Generator::generate(vm, script, {});
-
-        if (executable_result.is_error()) {
-            if (auto error_string = executable_result.error().to_string(); error_string.is_error())
-                result = vm.template throw_completion<JS::InternalError>(vm.error_message(JS::VM::ErrorMessage::OutOfMemory));
-            else if (error_string = String::formatted("TODO({})", error_string.value()); error_string.is_error())
-                result = vm.template throw_completion<JS::InternalError>(vm.error_message(JS::VM::ErrorMessage::OutOfMemory));
-            else
-                result = JS::throw_completion(JS::InternalError::create(realm(), error_string.release_value()));
-        } else {
-            auto executable = executable_result.release_value();
+        // NOTE: The bytecode is kept on the program, which may be shared by scripts with the same source text (see ProgramCache).
+        GCPtr<Bytecode::Executable> executable = script.bytecode_executable();
+        if (!executable) {
+            auto executable_result = JS::Bytecode::generate_or_load_from_cache(vm, script, {}, FunctionKind::Normal);
+            if (executable_result.is_error()) {
+                if (auto error_string = executable_result.error().to_string(); error_string.is_error())
+                    result = vm.template throw_completion<JS::InternalError>(vm.error_message(JS::VM::ErrorMessage::OutOfMemory));
+                else if (error_string = String::formatted("TODO({})", error_string.value()); error_string.is_error())
+                    result = vm.template throw_completion<JS::InternalError>(vm.error_message(JS::VM::ErrorMessage::OutOfMemory));
+                else
+                    result = JS::throw_completion(JS::InternalError::create(realm(), error_string.release_value()));
+            } else {
+                executable = executable_result.release_value();
+                const_cast<Program&>(script).set_bytecode_executable(executable);
 
-            if (g_dump_bytecode)
-                executable->dump();
+                if (g_dump_bytecode)
+                    executable->dump();
+            }
+        }
 
+        if (executable) {
             // a. Set result to the result of evaluating script.
             auto result_or_error = run_executable(*executable, nullptr);
             if (result_or_error.value.is_error())
@@ -304,13 +314,146 @@ ThrowCompletionOr<Value> Interpreter::run(SourceTextModule& module)
     return js_undefined();
 }
 
+void Interpreter::set_current_instruction(BasicBlock const& block, Instruction const& instruction)
+{
+    m_current_block = &block;
+    *m_pc = InstructionStreamIterator { block.instruction_stream(), m_current_executable, static_cast<size_t>(bit_cast<u8 const*>(&instruction) - block.data()) };
+}
+
+void Interpreter::dump_property_lookup_cache_statistics()
+{
+    struct Site {
+        Executable const* executable { nullptr };
+        Instruction const* instruction { nullptr };
+        PropertyLookupCache const* cache { nullptr };
+    };
+    Vector<Site> sites;
+    size_t total_hits = 0;
+    size_t total_misses = 0;
+    size_t megamorphic_sites = 0;
+
+    vm().heap().for_each_live_cell([&](Cell* cell) {
+        auto* executable = dynamic_cast<Executable const*>(cell);
+        if (!executable)
+            return;
+        for (auto& block : executable->basic_blocks) {
+            InstructionStreamIterator it(block->instruction_stream());
+            for (; !it.at_end(); ++it) {
+                auto const& instruction = *it;
+                Optional<u32> cache_index;
+                switch (instruction.type()) {
+                case Instruction::Type::GetById:
+                    cache_index = static_cast<Op::GetById const&>(instruction).cache_index();
+                    break;
+                case Instruction::Type::GetByIdWithThis:
+                    cache_index = static_cast<Op::GetByIdWithThis const&>(instruction).cache_index();
+                    break;
+                case Instruction::Type::PutById:
+                    cache_index = static_cast<Op::PutById const&>(instruction).cache_index();
+                    break;
+                case Instruction::Type::PutByIdWithThis:
+                    cache_index = static_cast<Op::PutByIdWithThis const&>(instruction).cache_index();
+                    break;
+                default:
+                    break;
+                }
+                if (!cache_index.has_value())
+                    continue;
+
+                auto const& cache = executable->property_lookup_caches[*cache_index];
+                total_hits += cache.hits;
+                total_misses += cache.misses;
+                if (cache.is_megamorphic)
+                    ++megamorphic_sites;
+                if (cache.misses > 0)
+                    sites.append({ executable, &instruction, &cache });
+            }
+        }
+    });
+
+    quick_sort(sites, [](auto const& a, auto const& b) { return a.cache->misses > b.cache->misses; });
+
+    auto const& megamorphic_cache = m_megamorphic_property_lookup_cache;
+    warnln("Inline cache statistics:");
+    warnln("    Property lookups: {} hits, {} misses, {} megamorphic sites", total_hits, total_misses, megamorphic_sites);
+    warnln("    Megamorphic cache: {} hits, {} misses", megamorphic_cache.hits, megamorphic_cache.misses);
+
+    static constexpr size_t max_number_of_sites = 20;
+    if (!sites.is_empty())
+        warnln("    Sites with the most misses:");
+    for (auto const& site : sites.span().trim(max_number_of_sites)) {
+        size_t number_of_shapes = 0;
+        for (auto const& entry : site.cache->entries) {
+            if (entry.shape)
+                ++number_of_shapes;
+        }
+        warnln("        {:>8} misses {:>10} hits  {}  \"{}\": {}",
+            site.cache->misses,
+            site.cache->hits,
+            site.cache->is_megamorphic ? ByteString("megamorphic"sv) : ByteString::formatted("{} shape(s)", number_of_shapes),
+            site.executable->name,
+            site.instruction->to_byte_string(*site.executable));
+    }
+}
+
+bool Interpreter::handle_exception(Value exception)
+{
+    reg(Register::exception()) = exception;
+    m_scheduled_jump = {};
+    auto const* handler = m_current_block->handler();
+    auto const* finalizer = m_current_block->finalizer();
+    if (!handler && !finalizer)
+        return false;
+
+    auto& running_execution_context = vm().running_execution_context();
+    auto& unwind_context = running_execution_context.unwind_contexts.last();
+    VERIFY(unwind_context.executable == m_current_executable);
+
+    if (handler) {
+        m_current_block = handler;
+        return true;
+    }
+    if (finalizer) {
+        m_current_block = finalizer;
+        return true;
+    }
+    // An unwind context with no handler or finalizer? We have nowhere to jump, and continuing on will make us crash on the next `Call` to a non-native function if there's an exception! So let's crash here instead.
+    // If you run into this, you probably forgot to remove the current unwind_context somewhere.
+    VERIFY_NOT_REACHED();
+}
+
+// Note: A `yield` statement will not go through a finally statement,
+//       hence we need to set a flag to not do so,
+//       but we generate a Yield Operation in the case of returns in
+//       generators as well, so we need to check if it will actually
+//       continue or is a `return` in disguise
+static bool suspends_execution(Instruction const& instruction)
+{
+    return (instruction.type() == Instruction::Type::Yield && static_cast<Op::Yield const&>(instruction).continuation().has_value()) || instruction.type() == Instruction::Type::Await;
+}
+
+static JIT::NativeExecutable const* native_executable_if_hot(Executable& executable)
+{
+    if (executable.did_try_jitting || ++executable.hotness < JIT::Compiler::hotness_threshold())
+        return nullptr;
+    executable.did_try_jitting = true;
+    executable.native_executable = JIT::Compiler::compile(executable);
+    return executable.native_executable.ptr();
+}
+
 void Interpreter::run_bytecode()
 {
     auto* locals = vm().running_execution_context().locals.data();
     auto& accumulator = this->accumulator();
+    auto const* native_executable = m_current_executable->native_executable.ptr();
+
+    // Where to continue in the next block, and whether the instruction there has to be interpreted.
+    size_t resume_offset = 0;
+    bool skip_native_code = false;
+
     for (;;) {
     start:
-        auto pc = InstructionStreamIterator { m_current_block->instruction_stream(), m_current_executable };
+        auto pc = InstructionStreamIterator { m_current_block->instruction_stream(), m_current_executable, exchange(resume_offset, 0) };
         TemporaryChange temp_change { m_pc, Optional<InstructionStreamIterator&>(pc) };
 
         bool will_return = false;
@@ -318,6 +461,31 @@ void Interpreter::run_bytecode()
 
         ThrowCompletionOr<void> result;
 
+        if (!native_executable)
+            native_executable = native_executable_if_hot(*m_current_executable);
+
+        if (native_executable && !exchange(skip_native_code, false)) {
+            auto exit = native_executable->run(*this, *m_current_block, pc.offset());
+            m_current_block = exit.block;
+            auto exit_offset = static_cast<size_t>(exit.instruction - m_current_block->data());
+            switch (exit.reason) {
+            case JIT::NativeExecutable::ExitReason::Interpret:
+                resume_offset = exit_offset;
+                skip_native_code = true;
+                goto start;
+            case JIT::NativeExecutable::ExitReason::Throw:
+                if (!handle_exception(reg(Register::exception())))
+                    return;
+                goto start;
+            case JIT::NativeExecutable::ExitReason::Return:
+                pc = InstructionStreamIterator { m_current_block->instruction_stream(), m_current_executable, exit_offset };
+                will_return = true;
+                will_yield = !reg(Register::return_value()).is_empty() && suspends_execution(*pc);
+                goto leave_block;
+            }
+            VERIFY_NOT_REACHED();
+        }
+
         while (!pc.at_end()) {
             auto& instruction = *pc;
 
@@ -390,43 +558,26 @@ void Interpreter::run_bytecode()
             }
 
             if (result.is_error()) [[unlikely]] {
-                reg(Register::exception()) = *result.throw_completion().value();
-                m_scheduled_jump = {};
-                auto const* handler = m_current_block->handler();
-                auto const* finalizer = m_current_block->finalizer();
-                if (!handler && !finalizer)
+                if (!handle_exception(*result.throw_completion().value()))
                     return;
-
-                auto& running_execution_context = vm().running_execution_context();
-                auto& unwind_context = running_execution_context.unwind_contexts.last();
-                VERIFY(unwind_context.executable == m_current_executable);
-
-                if (handler) {
-                    m_current_block = handler;
-                    goto start;
-                }
-                if (finalizer) {
-                    m_current_block = finalizer;
-                    goto start;
-                }
-                // An unwind context with no handler or finalizer? We have nowhere to jump, and continuing on will make us crash on the next `Call` to a non-native function if there's an exception! So let's crash here instead.
-                // If you run into this, you probably forgot to remove the current unwind_context somewhere.
-                VERIFY_NOT_REACHED();
+                goto start;
             }
 
             if (!reg(Register::return_value()).is_empty()) {
                 will_return = true;
-                // Note: A `yield` statement will not go through a finally statement,
-                //       hence we need to set a flag to not do so,
-                //       but we generate a Yield Operation in the case of returns in
-                //       generators as well, so we need to check if it will actually
-                //       continue or is a `return` in disguise
-                will_yield = (instruction.type() == Instruction::Type::Yield && static_cast<Op::Yield const&>(instruction).continuation().has_value()) || instruction.type() == Instruction::Type::Await;
+                will_yield = suspends_execution(instruction);
                 break;
             }
             ++pc;
+
+            // Go back to the machine code once the interpreter has taken care of what it could not do.
+            if (native_executable && !pc.at_end()) {
+                resume_offset = pc.offset();
+                goto start;
+            }
         }
 
+    leave_block:
         if (auto const* finalizer = m_current_block->finalizer(); finalizer && !will_yield) {
             auto& running_execution_context = vm().running_execution_context();
             auto& unwind_context = running_execution_context.unwind_contexts.last();
@@ -548,9 +699,23 @@ void Interpreter::enter_object_environment(Object& object)
     running_execution_context.lexical_environment = new_object_environment(object, true, old_environment);
 }
 
+CodeGenerationErrorOr<NonnullGCPtr<Executable>> generate_or_load_from_cache(VM& vm, ASTNode const& node, ReadonlySpan<FunctionParameter> parameters, FunctionKind kind)
+{
+    auto* bytecode_cache = node.source_code().bytecode_cache();
+    if (bytecode_cache) {
+        if (auto executable = bytecode_cache->get(vm, node, kind))
+            return *executable;
+    }
+
+    auto executable = TRY(Generator::generate(vm, node, parameters, kind));
+    if (bytecode_cache)
+        bytecode_cache->set(node, kind, *executable);
+    return executable;
+}
+
 ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM& vm, ASTNode const& node, ReadonlySpan<FunctionParameter> parameters, FunctionKind kind, DeprecatedFlyString const& name)
 {
-    auto executable_result = Bytecode::Generator::generate(vm, node, parameters, kind);
+    auto executable_result = generate_or_load_from_cache(vm, node, parameters, kind);
     if (executable_result.is_error())
         return vm.throw_completion<InternalError>(ErrorType::NotImplemented, TRY_OR_THROW_OOM(vm, executable_result.error().to_string()));
 
@@ -643,8 +808,8 @@ JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(JS_DEFINE_TO_BYTE_STRING_FOR_COMMO
 ThrowCompletionOr<void> Add::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
-    auto const lhs = interpreter.get(m_lhs);
-    auto const rhs = interpreter.get(m_rhs);
+    auto lhs = interpreter.get(m_lhs);
+    auto rhs = interpreter.get(m_rhs);
 
     if (lhs.is_number() && rhs.is_number()) {
         if (lhs.is_int32() && rhs.is_int32()) {
@@ -657,6 +822,11 @@ ThrowCompletionOr<void> Add::execute_impl(Bytecode::Interpreter& interpreter) co
         return {};
     }
 
+    if (lhs.is_string() && rhs.is_string()) {
+        interpreter.set(m_dst, PrimitiveString::create(vm, lhs.as_string(), rhs.as_string()));
+        return {};
+    }
+
     interpreter.set(m_dst, TRY(add(vm, lhs, rhs)));
     return {};
 }
@@ -690,8 +860,10 @@ ThrowCompletionOr<void> Sub::execute_impl(Bytecode::Interpreter& interpreter) co
 
     if (lhs.is_number() && rhs.is_number()) {
         if (lhs.is_int32() && rhs.is_int32()) {
-            if (!Checked<i32>::addition_would_overflow(lhs.as_i32(), -rhs.as_i32())) {
-                interpreter.set(m_dst, Value(lhs.as_i32() - rhs.as_i32()));
+            Checked<i32> result = lhs.as_i32();
+            result -= rhs.as_i32();
+            if (!result.has_overflow()) {
+                interpreter.set(m_dst, Value(result.value()));
                 return {};
             }
         }
@@ -1296,7 +1468,7 @@ ThrowCompletionOr<void> SuperCallWithArgumentArray::execute_impl(Bytecode::Inter
 ThrowCompletionOr<void> NewFunction::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto& vm = interpreter.vm();
-    interpreter.set(dst(), new_function(vm, m_function_node, m_lhs_name, m_home_object));
+    interpreter.set(dst(), new_function(vm, *m_function_node, m_lhs_name, m_home_object));
     return {};
 }
 
@@ -1607,7 +1779,7 @@ ThrowCompletionOr<void> NewClass::execute_impl(Bytecode::Interpreter& interprete
     Value super_class;
     if (m_super_class.has_value())
         super_class = interpreter.get(m_super_class.value());
-    interpreter.set(dst(), TRY(new_class(interpreter.vm(), super_class, m_class_expression, m_lhs_name)));
+    interpreter.set(dst(), TRY(new_class(interpreter.vm(), super_class, *m_class_expression, m_lhs_name)));
     return {};
 }
 
@@ -1626,7 +1798,7 @@ ThrowCompletionOr<void> BlockDeclarationInstantiation::execute_impl(Bytecode::In
     auto& running_execution_context = vm.running_execution_context();
     running_execution_context.saved_lexical_environments.append(old_environment);
     running_execution_context.lexical_environment = new_declarative_environment(*old_environment);
-    m_scope_node.block_declaration_instantiation(vm, running_execution_context.lexical_environment);
+    m_scope_node->block_declaration_instantiation(vm, running_execution_context.lexical_environment);
     return {};
 }
 
@@ -1966,8 +2138,8 @@ ByteString NewFunction::to_byte_string_impl(Bytecode::Executable const& executab
     StringBuilder builder;
     builder.appendff("NewFunction {}",
         format_operand("dst"sv, m_dst, executable));
-    if (m_function_node.has_name())
-        builder.appendff(" name:{}"sv, m_function_node.name());
+    if (m_function_node->has_name())
+        builder.appendff(" name:{}"sv, m_function_node->name());
     if (m_lhs_name.has_value())
         builder.appendff(" lhs_name:{}"sv, executable.get_identifier(m_lhs_name.value()));
     if (m_home_object.has_value())
@@ -1978,7 +2150,7 @@ ByteString NewFunction::to_byte_string_impl(Bytecode::Executable const& executab
 ByteString NewClass::to_byte_string_impl(Bytecode::Executable const& executable) const
 {
     StringBuilder builder;
-    auto name = m_class_expression.name();
+    auto name = m_class_expression->name();
     builder.appendff("NewClass {}",
         format_operand("dst"sv, m_dst, executable));
     if (m_super_class.has_value())
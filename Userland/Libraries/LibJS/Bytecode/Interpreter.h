@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <LibJS/Bytecode/CodeGenerationError.h>
 #include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Bytecode/Label.h>
 #include <LibJS/Bytecode/Register.h>
@@ -78,11 +79,20 @@ public:
     BasicBlock const& current_block() const { return *m_current_block; }
     Optional<InstructionStreamIterator const&> instruction_stream_iterator() const { return m_pc; }
 
+    // Used by machine code to keep the current position up to date before it runs anything that can observe it.
+    void set_current_instruction(BasicBlock const&, Instruction const&);
+
     Vector<Value>& registers() { return vm().running_execution_context().registers; }
     Vector<Value> const& registers() const { return vm().running_execution_context().registers; }
 
+    MegamorphicPropertyLookupCache& megamorphic_property_lookup_cache() { return m_megamorphic_property_lookup_cache; }
+
+    // Prints the property lookup sites of all live executables that missed their caches the most.
+    void dump_property_lookup_cache_statistics();
+
 private:
     void run_bytecode();
+    bool handle_exception(Value);
 
     VM& m_vm;
     BasicBlock const* m_scheduled_jump { nullptr };
@@ -92,10 +102,13 @@ private:
     GCPtr<Object> m_global_object { nullptr };
     GCPtr<DeclarativeEnvironment> m_global_declarative_environment { nullptr };
     Optional<InstructionStreamIterator&> m_pc {};
+    MegamorphicPropertyLookupCache m_megamorphic_property_lookup_cache;
 };
 
 extern bool g_dump_bytecode;
 
+// Loads the bytecode from the source's BytecodeCache if it has it, and otherwise generates it (and puts it there).
+CodeGenerationErrorOr<NonnullGCPtr<Executable>> generate_or_load_from_cache(VM&, ASTNode const&, ReadonlySpan<FunctionParameter>, FunctionKind);
 ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM&, ASTNode const&, ReadonlySpan<FunctionParameter>, JS::FunctionKind kind, DeprecatedFlyString const& name);
 
 }
@@ -43,6 +43,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand src() const { return m_src; }
 
@@ -91,6 +98,14 @@ private:
         ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const; \
         ByteString to_byte_string_impl(Bytecode::Executable const&) const;  \
                                                                             \
+        template<typename Visitor>                                          \
+        void visit_operands_impl(Visitor&& visitor)                         \
+        {                                                                   \
+            visitor(m_dst, OperandAccess::Write);                           \
+            visitor(m_lhs, OperandAccess::Read);                            \
+            visitor(m_rhs, OperandAccess::Read);                            \
+        }                                                                   \
+                                                                            \
         Operand dst() const { return m_dst; }                               \
         Operand lhs() const { return m_lhs; }                               \
         Operand rhs() const { return m_rhs; }                               \
@@ -125,6 +140,13 @@ JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(JS_DECLARE_COMMON_BINARY_OP)
         ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const; \
         ByteString to_byte_string_impl(Bytecode::Executable const&) const;  \
                                                                             \
+        template<typename Visitor>                                          \
+        void visit_operands_impl(Visitor&& visitor)                         \
+        {                                                                   \
+            visitor(m_dst, OperandAccess::Write);                           \
+            visitor(m_src, OperandAccess::Read);                            \
+        }                                                                   \
+                                                                            \
         Operand dst() const { return m_dst; }                               \
         Operand src() const { return m_src; }                               \
                                                                             \
@@ -147,6 +169,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
 
 private:
@@ -167,6 +195,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
     StringTableIndex source_index() const { return m_source_index; }
     StringTableIndex flags_index() const { return m_flags_index; }
@@ -195,6 +229,12 @@ private:
         ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const; \
         ByteString to_byte_string_impl(Bytecode::Executable const&) const;  \
                                                                             \
+        template<typename Visitor>                                          \
+        void visit_operands_impl(Visitor&& visitor)                         \
+        {                                                                   \
+            visitor(m_dst, OperandAccess::Write);                           \
+        }                                                                   \
+                                                                            \
         Operand dst() const { return m_dst; }                               \
         StringTableIndex error_string() const { return m_error_string; }    \
                                                                             \
@@ -222,6 +262,15 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_from_object, OperandAccess::Read);
+        for (size_t i = 0; i < m_excluded_names_count; ++i)
+            visitor(m_excluded_names[i], OperandAccess::Read);
+    }
+
     size_t length_impl(size_t excluded_names_count) const
     {
         return round_up_to_power_of_two(alignof(void*), sizeof(*this) + sizeof(Operand) * excluded_names_count);
@@ -261,6 +310,16 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        if (m_element_count) {
+            visitor(m_elements[0], OperandAccess::ReadRange);
+            visitor(m_elements[1], OperandAccess::ReadRange);
+        }
+    }
+
     Operand dst() const { return m_dst; }
 
     size_t length_impl(size_t element_count) const
@@ -307,6 +366,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
     ReadonlySpan<Value> elements() const { return { m_elements, m_element_count }; }
 
@@ -329,6 +394,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Read);
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand src() const { return m_src; }
     bool is_spread() const { return m_is_spread; }
@@ -352,6 +424,14 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_specifier, OperandAccess::Read);
+        visitor(m_options, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand specifier() const { return m_specifier; }
     Operand options() const { return m_options; }
@@ -374,6 +454,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_iterator, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand iterator() const { return m_iterator; }
 
@@ -394,6 +481,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::ReadWrite);
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand src() const { return m_src; }
 
@@ -416,6 +510,9 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&&) { }
 };
 
 class EnterObjectEnvironment final : public Instruction {
@@ -429,6 +526,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_object, OperandAccess::Read);
+    }
+
     Operand object() const { return m_object; }
 
 private:
@@ -446,6 +549,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
 
 private:
@@ -461,6 +570,9 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&&) { }
 };
 
 class RestoreScheduledJump final : public Instruction {
@@ -472,6 +584,9 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&&) { }
 };
 
 class CreateVariable final : public Instruction {
@@ -489,6 +604,9 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&&) { }
+
     IdentifierTableIndex identifier() const { return m_identifier; }
     EnvironmentMode mode() const { return m_mode; }
     bool is_immutable() const { return m_is_immutable; }
@@ -522,6 +640,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_src, OperandAccess::Read);
+    }
+
     IdentifierTableIndex identifier() const { return m_identifier; }
     Operand src() const { return m_src; }
     EnvironmentMode mode() const { return m_mode; }
@@ -548,6 +672,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_src, OperandAccess::Read);
+    }
+
     size_t index() const { return m_index; }
     Operand dst() const { return Operand(Operand::Type::Local, m_index); }
     Operand src() const { return m_src; }
@@ -571,6 +701,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_callee, OperandAccess::Write);
+        visitor(m_this_value, OperandAccess::Write);
+    }
+
     IdentifierTableIndex identifier() const { return m_identifier; }
     u32 cache_index() const { return m_cache_index; }
     Operand callee() const { return m_callee; }
@@ -596,6 +733,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
     IdentifierTableIndex identifier() const { return m_identifier; }
     u32 cache_index() const { return m_cache_index; }
@@ -619,6 +762,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
     IdentifierTableIndex identifier() const { return m_identifier; }
     u32 cache_index() const { return m_cache_index; }
@@ -641,6 +790,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
     IdentifierTableIndex identifier() const { return m_identifier; }
 
@@ -664,6 +819,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_base, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand base() const { return m_base; }
     IdentifierTableIndex property() const { return m_property; }
@@ -692,6 +854,14 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_base, OperandAccess::Read);
+        visitor(m_this_value, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand base() const { return m_base; }
     IdentifierTableIndex property() const { return m_property; }
@@ -719,6 +889,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_base, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand base() const { return m_base; }
     IdentifierTableIndex property() const { return m_property; }
@@ -742,6 +919,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_base, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand base() const { return m_base; }
     IdentifierTableIndex property() const { return m_property; }
@@ -777,6 +961,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_base, OperandAccess::Read);
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand base() const { return m_base; }
     IdentifierTableIndex property() const { return m_property; }
     Operand src() const { return m_src; }
@@ -808,6 +999,14 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_base, OperandAccess::Read);
+        visitor(m_this_value, OperandAccess::Read);
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand base() const { return m_base; }
     Operand this_value() const { return m_this_value; }
     IdentifierTableIndex property() const { return m_property; }
@@ -838,6 +1037,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_base, OperandAccess::Read);
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand base() const { return m_base; }
     IdentifierTableIndex property() const { return m_property; }
     Operand src() const { return m_src; }
@@ -862,6 +1068,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_base, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand base() const { return m_base; }
     IdentifierTableIndex property() const { return m_property; }
@@ -886,6 +1099,14 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_base, OperandAccess::Read);
+        visitor(m_this_value, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand base() const { return m_base; }
     Operand this_value() const { return m_this_value; }
@@ -912,6 +1133,14 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_base, OperandAccess::Read);
+        visitor(m_property, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand base() const { return m_base; }
     Operand property() const { return m_property; }
@@ -939,6 +1168,15 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_base, OperandAccess::Read);
+        visitor(m_property, OperandAccess::Read);
+        visitor(m_this_value, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand base() const { return m_base; }
     Operand property() const { return m_property; }
@@ -966,6 +1204,14 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_base, OperandAccess::Read);
+        visitor(m_property, OperandAccess::Read);
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand base() const { return m_base; }
     Operand property() const { return m_property; }
     Operand src() const { return m_src; }
@@ -994,6 +1240,15 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_base, OperandAccess::Read);
+        visitor(m_property, OperandAccess::Read);
+        visitor(m_this_value, OperandAccess::Read);
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand base() const { return m_base; }
     Operand property() const { return m_property; }
     Operand this_value() const { return m_this_value; }
@@ -1021,6 +1276,14 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_base, OperandAccess::Read);
+        visitor(m_property, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand base() const { return m_base; }
     Operand property() const { return m_property; }
@@ -1050,6 +1313,15 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_base, OperandAccess::Read);
+        visitor(m_this_value, OperandAccess::Read);
+        visitor(m_property, OperandAccess::Read);
+    }
+
 private:
     Operand m_dst;
     Operand m_base;
@@ -1085,6 +1357,17 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&&) { }
+
+    template<typename Visitor>
+    void visit_labels_impl(Visitor&& visitor)
+    {
+        visitor(m_true_target.value());
+        if (m_false_target.has_value())
+            visitor(m_false_target.value());
+    }
+
     auto& true_target() const { return m_true_target; }
     auto& false_target() const { return m_false_target; }
 
@@ -1104,6 +1387,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_condition, OperandAccess::Read);
+    }
+
     Operand condition() const { return m_condition; }
 
 private:
@@ -1121,6 +1410,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_condition, OperandAccess::Read);
+    }
+
     Operand condition() const { return m_condition; }
 
 private:
@@ -1138,6 +1433,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_condition, OperandAccess::Read);
+    }
+
     Operand condition() const { return m_condition; }
 
 private:
@@ -1184,6 +1485,16 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_callee, OperandAccess::Read);
+        visitor(m_this_value, OperandAccess::Read);
+        for (size_t i = 0; i < m_argument_count; ++i)
+            visitor(m_arguments[i], OperandAccess::Read);
+    }
+
 private:
     Operand m_dst;
     Operand m_callee;
@@ -1218,6 +1529,15 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_callee, OperandAccess::Read);
+        visitor(m_this_value, OperandAccess::Read);
+        visitor(m_arguments, OperandAccess::Read);
+    }
+
 private:
     Operand m_dst;
     Operand m_callee;
@@ -1240,6 +1560,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_arguments, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand arguments() const { return m_arguments; }
     bool is_synthetic() const { return m_is_synthetic; }
@@ -1256,7 +1583,7 @@ public:
         : Instruction(Type::NewClass, sizeof(*this))
         , m_dst(dst)
         , m_super_class(super_class)
-        , m_class_expression(class_expression)
+        , m_class_expression(&class_expression)
         , m_lhs_name(lhs_name)
     {
     }
@@ -1264,15 +1591,29 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        if (m_super_class.has_value())
+            visitor(m_super_class.value(), OperandAccess::Read);
+    }
+
+    template<typename Visitor>
+    void visit_ast_nodes_impl(Visitor&& visitor)
+    {
+        visitor(m_class_expression);
+    }
+
     Operand dst() const { return m_dst; }
     Optional<Operand> const& super_class() const { return m_super_class; }
-    ClassExpression const& class_expression() const { return m_class_expression; }
+    ClassExpression const& class_expression() const { return *m_class_expression; }
     Optional<IdentifierTableIndex> const& lhs_name() const { return m_lhs_name; }
 
 private:
     Operand m_dst;
     Optional<Operand> m_super_class;
-    ClassExpression const& m_class_expression;
+    ClassExpression const* m_class_expression;
     Optional<IdentifierTableIndex> m_lhs_name;
 };
 
@@ -1281,7 +1622,7 @@ public:
     explicit NewFunction(Operand dst, FunctionExpression const& function_node, Optional<IdentifierTableIndex> lhs_name, Optional<Operand> home_object = {})
         : Instruction(Type::NewFunction, sizeof(*this))
         , m_dst(dst)
-        , m_function_node(function_node)
+        , m_function_node(&function_node)
         , m_lhs_name(lhs_name)
         , m_home_object(move(home_object))
     {
@@ -1290,14 +1631,28 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        if (m_home_object.has_value())
+            visitor(m_home_object.value(), OperandAccess::Read);
+    }
+
+    template<typename Visitor>
+    void visit_ast_nodes_impl(Visitor&& visitor)
+    {
+        visitor(m_function_node);
+    }
+
     Operand dst() const { return m_dst; }
-    FunctionExpression const& function_node() const { return m_function_node; }
+    FunctionExpression const& function_node() const { return *m_function_node; }
     Optional<IdentifierTableIndex> const& lhs_name() const { return m_lhs_name; }
     Optional<Operand> const& home_object() const { return m_home_object; }
 
 private:
     Operand m_dst;
-    FunctionExpression const& m_function_node;
+    FunctionExpression const* m_function_node;
     Optional<IdentifierTableIndex> m_lhs_name;
     Optional<Operand> m_home_object;
 };
@@ -1306,17 +1661,26 @@ class BlockDeclarationInstantiation final : public Instruction {
 public:
     explicit BlockDeclarationInstantiation(ScopeNode const& scope_node)
         : Instruction(Type::BlockDeclarationInstantiation, sizeof(*this))
-        , m_scope_node(scope_node)
+        , m_scope_node(&scope_node)
     {
     }
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
-    ScopeNode const& scope_node() const { return m_scope_node; }
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&&) { }
+
+    template<typename Visitor>
+    void visit_ast_nodes_impl(Visitor&& visitor)
+    {
+        visitor(m_scope_node);
+    }
+
+    ScopeNode const& scope_node() const { return *m_scope_node; }
 
 private:
-    ScopeNode const& m_scope_node;
+    ScopeNode const* m_scope_node;
 };
 
 class Return final : public Instruction {
@@ -1332,6 +1696,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        if (m_value.has_value())
+            visitor(m_value.value(), OperandAccess::Read);
+    }
+
     Optional<Operand> const& value() const { return m_value; }
 
 private:
@@ -1349,6 +1720,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::ReadWrite);
+    }
+
     Operand dst() const { return m_dst; }
 
 private:
@@ -1367,6 +1744,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_src, OperandAccess::ReadWrite);
+    }
+
     Operand dst() const { return m_dst; }
     Operand src() const { return m_src; }
 
@@ -1386,6 +1770,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::ReadWrite);
+    }
+
     Operand dst() const { return m_dst; }
 
 private:
@@ -1404,6 +1794,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_src, OperandAccess::ReadWrite);
+    }
+
     Operand dst() const { return m_dst; }
     Operand src() const { return m_src; }
 
@@ -1425,6 +1822,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand src() const { return m_src; }
 
 private:
@@ -1442,6 +1845,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand src() const { return m_src; }
 
 private:
@@ -1459,6 +1868,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand src() const { return m_src; }
 
 private:
@@ -1476,6 +1891,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_src, OperandAccess::Read);
+    }
+
     Operand src() const { return m_src; }
 
 private:
@@ -1495,6 +1916,15 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&&) { }
+
+    template<typename Visitor>
+    void visit_labels_impl(Visitor&& visitor)
+    {
+        visitor(m_entry_point);
+    }
+
     auto& entry_point() const { return m_entry_point; }
 
 private:
@@ -1525,6 +1955,15 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&&) { }
+
+    template<typename Visitor>
+    void visit_labels_impl(Visitor&& visitor)
+    {
+        visitor(m_target);
+    }
+
 private:
     Label m_target;
 };
@@ -1538,6 +1977,9 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&&) { }
 };
 
 class LeaveUnwindContext final : public Instruction {
@@ -1549,6 +1991,9 @@ public:
 
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
+
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&&) { }
 };
 
 class ContinuePendingUnwind final : public Instruction {
@@ -1564,6 +2009,15 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&&) { }
+
+    template<typename Visitor>
+    void visit_labels_impl(Visitor&& visitor)
+    {
+        visitor(m_resume_target);
+    }
+
     auto& resume_target() const { return m_resume_target; }
 
 private:
@@ -1590,6 +2044,19 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_value, OperandAccess::Read);
+    }
+
+    template<typename Visitor>
+    void visit_labels_impl(Visitor&& visitor)
+    {
+        if (m_continuation_label.has_value())
+            visitor(m_continuation_label.value());
+    }
+
     auto& continuation() const { return m_continuation_label; }
     Operand value() const { return m_value; }
 
@@ -1612,6 +2079,18 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_argument, OperandAccess::Read);
+    }
+
+    template<typename Visitor>
+    void visit_labels_impl(Visitor&& visitor)
+    {
+        visitor(m_continuation_label);
+    }
+
     auto& continuation() const { return m_continuation_label; }
     Operand argument() const { return m_argument; }
 
@@ -1633,6 +2112,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_iterable, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand iterable() const { return m_iterable; }
     IteratorHint hint() const { return m_hint; }
@@ -1655,6 +2141,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_object, OperandAccess::Write);
+        visitor(m_iterator_record, OperandAccess::Read);
+    }
+
     Operand object() const { return m_object; }
     Operand iterator_record() const { return m_iterator_record; }
 
@@ -1675,6 +2168,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_next_method, OperandAccess::Write);
+        visitor(m_iterator_record, OperandAccess::Read);
+    }
+
     Operand next_method() const { return m_next_method; }
     Operand iterator_record() const { return m_iterator_record; }
 
@@ -1696,6 +2196,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_object, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand object() const { return m_object; }
     IdentifierTableIndex property() const { return m_property; }
@@ -1718,6 +2225,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_object, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand object() const { return m_object; }
 
@@ -1739,6 +2253,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_iterator_record, OperandAccess::Read);
+    }
+
     Operand iterator_record() const { return m_iterator_record; }
     Completion::Type completion_type() const { return m_completion_type; }
     Optional<Value> const& completion_value() const { return m_completion_value; }
@@ -1762,6 +2282,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_iterator_record, OperandAccess::Read);
+    }
+
     Operand iterator_record() const { return m_iterator_record; }
     Completion::Type completion_type() const { return m_completion_type; }
     Optional<Value> const& completion_value() const { return m_completion_value; }
@@ -1784,6 +2310,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+        visitor(m_iterator_record, OperandAccess::Read);
+    }
+
     Operand dst() const { return m_dst; }
     Operand iterator_record() const { return m_iterator_record; }
 
@@ -1803,6 +2336,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
 
 private:
@@ -1820,6 +2359,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
 
 private:
@@ -1837,6 +2382,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
 
 private:
@@ -1854,6 +2405,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
 
 private:
@@ -1872,6 +2429,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_dst, OperandAccess::Write);
+    }
+
     Operand dst() const { return m_dst; }
     IdentifierTableIndex identifier() const { return m_identifier; }
 
@@ -1893,6 +2456,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_value, OperandAccess::Read);
+    }
+
     Operand value() const { return m_value; }
 
 private:
@@ -1911,6 +2480,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     ByteString to_byte_string_impl(Bytecode::Executable const&) const;
 
+    template<typename Visitor>
+    void visit_operands_impl(Visitor&& visitor)
+    {
+        visitor(m_value, OperandAccess::Read);
+    }
+
 private:
     StringView m_text;
     Operand m_value;
@@ -1935,4 +2510,55 @@ ALWAYS_INLINE ThrowCompletionOr<void> Instruction::execute(Bytecode::Interpreter
 #undef __BYTECODE_OP
 }
 
+template<typename Visitor>
+ALWAYS_INLINE void Instruction::visit_operands(Visitor&& visitor)
+{
+#define __BYTECODE_OP(op)                                                   \
+    case Instruction::Type::op:                                             \
+        static_cast<Bytecode::Op::op&>(*this).visit_operands_impl(visitor); \
+        return;
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
+template<typename Visitor>
+ALWAYS_INLINE void Instruction::visit_labels(Visitor&& visitor)
+{
+#define __BYTECODE_OP(op)                                                 \
+    case Instruction::Type::op:                                           \
+        static_cast<Bytecode::Op::op&>(*this).visit_labels_impl(visitor); \
+        return;
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
+template<typename Visitor>
+ALWAYS_INLINE void Instruction::visit_ast_nodes(Visitor&& visitor)
+{
+#define __BYTECODE_OP(op)                                                    \
+    case Instruction::Type::op:                                              \
+        static_cast<Bytecode::Op::op&>(*this).visit_ast_nodes_impl(visitor); \
+        return;
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
 }
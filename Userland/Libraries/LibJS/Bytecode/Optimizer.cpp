@@ -0,0 +1,496 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/QuickSort.h>
+#include <AK/Time.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/Optimizer.h>
+#include <LibJS/Bytecode/Register.h>
+#include <stdlib.h>
+
+namespace JS::Bytecode {
+
+static Optional<bool> s_enabled;
+static Optimizer::Statistics s_statistics;
+
+bool Optimizer::is_enabled()
+{
+    if (!s_enabled.has_value()) {
+        auto const* value = getenv("LIBJS_BYTECODE_OPTIMIZER");
+        s_enabled = !value || StringView { value, strlen(value) } != "0"sv;
+    }
+    return *s_enabled;
+}
+
+void Optimizer::set_enabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+Optimizer::Statistics& Optimizer::statistics()
+{
+    return s_statistics;
+}
+
+void Optimizer::dump_statistics()
+{
+    auto const& statistics = s_statistics;
+    warnln("Bytecode optimizer statistics:");
+    warnln("    Optimized executables: {}, in {} ms", statistics.optimized_executables, statistics.time.to_milliseconds());
+    warnln("    Instructions: {} -> {}", statistics.instructions_before, statistics.instructions_after);
+    warnln("    Registers: {} -> {}", statistics.registers_before, statistics.registers_after);
+}
+
+namespace {
+
+class RegisterSet {
+public:
+    explicit RegisterSet(size_t size = 0)
+    {
+        m_words.resize(ceil_div(size, bits_per_word));
+    }
+
+    bool contains(u32 index) const { return m_words[index / bits_per_word] & bit(index); }
+    void add(u32 index) { m_words[index / bits_per_word] |= bit(index); }
+    void remove(u32 index) { m_words[index / bits_per_word] &= ~bit(index); }
+
+    void add_all(RegisterSet const& other)
+    {
+        for (size_t i = 0; i < m_words.size(); ++i)
+            m_words[i] |= other.m_words[i];
+    }
+
+    void remove_all(RegisterSet const& other)
+    {
+        for (size_t i = 0; i < m_words.size(); ++i)
+            m_words[i] &= ~other.m_words[i];
+    }
+
+    template<typename Callback>
+    void for_each(Callback callback) const
+    {
+        for (size_t i = 0; i < m_words.size(); ++i) {
+            for (auto word = m_words[i]; word; word &= word - 1)
+                callback(static_cast<u32>(i * bits_per_word + count_trailing_zeroes(word)));
+        }
+    }
+
+    bool operator==(RegisterSet const&) const = default;
+
+private:
+    static constexpr size_t bits_per_word = 64;
+    static u64 bit(u32 index) { return 1ull << (index % bits_per_word); }
+
+    Vector<u64> m_words;
+};
+
+class ExecutableOptimizer {
+public:
+    ExecutableOptimizer(Vector<NonnullOwnPtr<BasicBlock>>& blocks, u32 number_of_registers)
+        : m_blocks(blocks)
+        , m_number_of_registers(number_of_registers)
+        , m_pinned_registers(number_of_registers)
+    {
+        for (size_t i = 0; i < m_blocks.size(); ++i)
+            m_block_indices.set(m_blocks[i].ptr(), i);
+    }
+
+    u32 optimize()
+    {
+        find_pinned_registers();
+        find_successors();
+        propagate_copies();
+        do {
+            compute_liveness();
+        } while (remove_dead_copies());
+        return allocate_registers();
+    }
+
+private:
+    static Vector<Instruction*> instructions_of(BasicBlock& block)
+    {
+        Vector<Instruction*> instructions;
+        for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it)
+            instructions.append(const_cast<Instruction*>(&*it));
+        return instructions;
+    }
+
+    // Registers the optimizer may move around. The reserved ones are used by the interpreter itself, and the ones in
+    // the ranges of NewArray are read without showing up as operands, so they all stay where they are.
+    bool is_movable(Operand const& operand) const
+    {
+        return operand.is_register() && operand.index() >= Register::reserved_register_count && !m_pinned_registers.contains(operand.index());
+    }
+
+    void find_pinned_registers()
+    {
+        for (auto& block : m_blocks) {
+            for (auto* instruction : instructions_of(*block)) {
+                if (instruction->type() != Instruction::Type::NewArray)
+                    continue;
+                auto const& new_array = static_cast<Op::NewArray const&>(*instruction);
+                if (new_array.element_count() == 0)
+                    continue;
+                VERIFY(new_array.start().index() >= Register::reserved_register_count);
+                for (auto index = new_array.start().index(); index <= new_array.end().index(); ++index)
+                    m_pinned_registers.add(index);
+            }
+        }
+    }
+
+    void find_successors()
+    {
+        m_successors.resize(m_blocks.size());
+        m_exception_successors.resize(m_blocks.size());
+
+        // A finally block goes on to wherever the ScheduleJump before it pointed, which it doesn't know statically.
+        Vector<size_t> scheduled_jump_targets;
+        for (auto& block : m_blocks) {
+            for (auto* instruction : instructions_of(*block)) {
+                if (instruction->type() == Instruction::Type::ScheduleJump)
+                    scheduled_jump_targets.append(index_of(static_cast<Op::ScheduleJump const&>(*instruction).target()));
+            }
+        }
+
+        for (size_t i = 0; i < m_blocks.size(); ++i) {
+            auto& block = *m_blocks[i];
+            auto& successors = m_successors[i];
+
+            // Any instruction in the block can throw and end up in the handler or the finalizer, and leaving the block
+            // in any way goes through the finalizer.
+            if (block.handler())
+                m_exception_successors[i].append(m_block_indices.get(block.handler()).value());
+            if (block.finalizer())
+                m_exception_successors[i].append(m_block_indices.get(block.finalizer()).value());
+
+            for (auto* instruction : instructions_of(block)) {
+                switch (instruction->type()) {
+                case Instruction::Type::Jump:
+                case Instruction::Type::JumpIf:
+                case Instruction::Type::JumpNullish:
+                case Instruction::Type::JumpUndefined: {
+                    auto const& jump = static_cast<Op::Jump const&>(*instruction);
+                    successors.append(index_of(*jump.true_target()));
+                    if (jump.false_target().has_value())
+                        successors.append(index_of(*jump.false_target()));
+                    break;
+                }
+                case Instruction::Type::EnterUnwindContext:
+                    successors.append(index_of(static_cast<Op::EnterUnwindContext const&>(*instruction).entry_point()));
+                    break;
+                case Instruction::Type::ContinuePendingUnwind:
+                    successors.append(index_of(static_cast<Op::ContinuePendingUnwind const&>(*instruction).resume_target()));
+                    successors.extend(scheduled_jump_targets);
+                    break;
+                case Instruction::Type::Yield:
+                    if (auto const& continuation = static_cast<Op::Yield const&>(*instruction).continuation(); continuation.has_value())
+                        successors.append(index_of(*continuation));
+                    break;
+                case Instruction::Type::Await:
+                    successors.append(index_of(static_cast<Op::Await const&>(*instruction).continuation()));
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+    }
+
+    size_t index_of(Label const& label) const
+    {
+        return m_block_indices.get(&label.block()).value();
+    }
+
+    // Within a block, reads of a register that was last set by a Mov read the Mov's source instead, which often leaves
+    // nothing reading the register itself.
+    void propagate_copies()
+    {
+        HashMap<u32, Operand> copies;
+        for (auto& block : m_blocks) {
+            copies.clear();
+            for (auto* instruction : instructions_of(*block)) {
+                instruction->visit_operands([&](Operand& operand, OperandAccess access) {
+                    if (access != OperandAccess::Read || !operand.is_register())
+                        return;
+                    if (auto copy = copies.get(operand.index()); copy.has_value())
+                        operand = *copy;
+                });
+
+                instruction->visit_operands([&](Operand& operand, OperandAccess access) {
+                    if (!operand.is_register() || (access != OperandAccess::Write && access != OperandAccess::ReadWrite))
+                        return;
+                    copies.remove(operand.index());
+                    copies.remove_all_matching([&](auto, Operand const& source) { return source == operand; });
+                });
+
+                if (instruction->type() != Instruction::Type::Mov)
+                    continue;
+                auto const& mov = static_cast<Op::Mov const&>(*instruction);
+                if (!is_movable(mov.dst()) || mov.src() == mov.dst())
+                    continue;
+                if (mov.src().is_constant() || (mov.src().is_register() && mov.src().index() >= Register::reserved_register_count))
+                    copies.set(mov.dst().index(), mov.src());
+            }
+        }
+    }
+
+    void apply_to_live_registers(Instruction& instruction, RegisterSet& live) const
+    {
+        instruction.visit_operands([&](Operand& operand, OperandAccess access) {
+            if (access == OperandAccess::Write && is_movable(operand))
+                live.remove(operand.index());
+        });
+        instruction.visit_operands([&](Operand& operand, OperandAccess access) {
+            if (access != OperandAccess::Write && is_movable(operand))
+                live.add(operand.index());
+        });
+    }
+
+    void compute_liveness()
+    {
+        auto block_count = m_blocks.size();
+        Vector<RegisterSet> uses;
+        Vector<RegisterSet> definitions;
+        uses.ensure_capacity(block_count);
+        definitions.ensure_capacity(block_count);
+        for (auto& block : m_blocks) {
+            RegisterSet block_uses(m_number_of_registers);
+            RegisterSet block_definitions(m_number_of_registers);
+            for (auto* instruction : instructions_of(*block)) {
+                instruction->visit_operands([&](Operand& operand, OperandAccess access) {
+                    if (access != OperandAccess::Write && is_movable(operand) && !block_definitions.contains(operand.index()))
+                        block_uses.add(operand.index());
+                });
+                instruction->visit_operands([&](Operand& operand, OperandAccess access) {
+                    if ((access == OperandAccess::Write || access == OperandAccess::ReadWrite) && is_movable(operand))
+                        block_definitions.add(operand.index());
+                });
+            }
+            uses.unchecked_append(move(block_uses));
+            definitions.unchecked_append(move(block_definitions));
+        }
+
+        m_live_in.clear_with_capacity();
+        m_live_out.clear_with_capacity();
+        m_exception_live.clear_with_capacity();
+        for (size_t i = 0; i < block_count; ++i) {
+            m_live_in.append(uses[i]);
+            m_live_out.empend(m_number_of_registers);
+            m_exception_live.empend(m_number_of_registers);
+        }
+
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (size_t i = block_count; i-- > 0;) {
+                RegisterSet exception_live(m_number_of_registers);
+                for (auto successor : m_exception_successors[i])
+                    exception_live.add_all(m_live_in[successor]);
+
+                RegisterSet live_out = exception_live;
+                for (auto successor : m_successors[i])
+                    live_out.add_all(m_live_in[successor]);
+
+                // Registers the handler or finalizer need are live all through the block, since any instruction might
+                // throw.
+                RegisterSet live_in = live_out;
+                live_in.remove_all(definitions[i]);
+                live_in.add_all(uses[i]);
+                live_in.add_all(exception_live);
+
+                if (live_in != m_live_in[i]) {
+                    m_live_in[i] = move(live_in);
+                    changed = true;
+                }
+                m_live_out[i] = move(live_out);
+                m_exception_live[i] = move(exception_live);
+            }
+        }
+    }
+
+    bool remove_dead_copies()
+    {
+        bool removed_any = false;
+        HashTable<Instruction const*> dead_copies;
+        for (size_t i = 0; i < m_blocks.size(); ++i) {
+            dead_copies.clear();
+            auto live = m_live_out[i];
+            auto instructions = instructions_of(*m_blocks[i]);
+            for (size_t j = instructions.size(); j-- > 0;) {
+                auto& instruction = *instructions[j];
+                if (instruction.type() == Instruction::Type::Mov) {
+                    auto const& mov = static_cast<Op::Mov const&>(instruction);
+                    if (mov.src() == mov.dst() || (is_movable(mov.dst()) && !live.contains(mov.dst().index()))) {
+                        dead_copies.set(&instruction);
+                        continue;
+                    }
+                }
+                apply_to_live_registers(instruction, live);
+                live.add_all(m_exception_live[i]);
+            }
+            if (dead_copies.is_empty())
+                continue;
+            m_blocks[i]->remove_instructions_if([&](Instruction const& instruction) { return dead_copies.contains(&instruction); });
+            removed_any = true;
+        }
+        return removed_any;
+    }
+
+    // Registers are given slots with a linear scan over the blocks in order. Each register is in use from the first to
+    // the last place where it is live, read or written, so two registers whose ranges don't overlap are never needed at
+    // the same time. A Mov between two registers can give the destination the source's slot if that's the last read of
+    // the source, which turns the Mov into one that does nothing.
+    u32 allocate_registers()
+    {
+        struct Range {
+            u32 start { NumericLimits<u32>::max() };
+            u32 end { 0 };
+
+            bool is_empty() const { return start > end; }
+            void extend(u32 position)
+            {
+                start = min(start, position);
+                end = max(end, position);
+            }
+        };
+        Vector<Range> ranges;
+        ranges.resize(m_number_of_registers);
+        HashMap<u32, Op::Mov const*> copies_between_registers;
+
+        u32 position = 0;
+        for (size_t i = 0; i < m_blocks.size(); ++i) {
+            auto instructions = instructions_of(*m_blocks[i]);
+            if (instructions.is_empty())
+                continue;
+            m_live_in[i].for_each([&](u32 index) { ranges[index].extend(position); });
+            for (auto* instruction : instructions) {
+                instruction->visit_operands([&](Operand& operand, OperandAccess) {
+                    if (is_movable(operand))
+                        ranges[operand.index()].extend(position);
+                });
+                if (instruction->type() == Instruction::Type::Mov) {
+                    auto const& mov = static_cast<Op::Mov const&>(*instruction);
+                    if (is_movable(mov.dst()) && is_movable(mov.src()))
+                        copies_between_registers.set(position, &mov);
+                }
+                ++position;
+            }
+            m_live_out[i].for_each([&](u32 index) { ranges[index].extend(position - 1); });
+        }
+
+        Vector<u32> registers_by_start;
+        for (u32 index = 0; index < m_number_of_registers; ++index) {
+            if (!ranges[index].is_empty())
+                registers_by_start.append(index);
+        }
+        quick_sort(registers_by_start, [&](u32 a, u32 b) {
+            if (ranges[a].start != ranges[b].start)
+                return ranges[a].start < ranges[b].start;
+            return ranges[a].end < ranges[b].end;
+        });
+
+        Vector<u32> new_indices;
+        new_indices.resize(m_number_of_registers);
+        for (u32 index = 0; index < Register::reserved_register_count && index < m_number_of_registers; ++index)
+            new_indices[index] = index;
+
+        Vector<u32> active;
+        Vector<u32> free_slots;
+        u32 slot_count = 0;
+        for (auto index : registers_by_start) {
+            auto const& range = ranges[index];
+
+            active.remove_all_matching([&](u32 active_index) {
+                if (ranges[active_index].end >= range.start)
+                    return false;
+                free_slots.append(new_indices[active_index]);
+                return true;
+            });
+
+            Optional<u32> slot;
+            if (auto copy = copies_between_registers.get(range.start); copy.has_value() && (*copy)->dst().index() == index) {
+                auto source = (*copy)->src().index();
+                if (ranges[source].end == range.start && active.contains_slow(source)) {
+                    active.remove_first_matching([&](u32 active_index) { return active_index == source; });
+                    slot = new_indices[source];
+                }
+            }
+            if (!slot.has_value())
+                slot = free_slots.is_empty() ? Register::reserved_register_count + slot_count++ : free_slots.take_last();
+
+            new_indices[index] = *slot;
+            active.append(index);
+        }
+
+        // Ranges of NewArray have to stay in one piece, and since every register inside one is pinned, keeping pinned
+        // registers in order keeps them together.
+        u32 next_index = Register::reserved_register_count + slot_count;
+        m_pinned_registers.for_each([&](u32 index) { new_indices[index] = next_index++; });
+
+        for (auto& block : m_blocks) {
+            for (auto* instruction : instructions_of(*block)) {
+                instruction->visit_operands([&](Operand& operand, OperandAccess) {
+                    if (operand.is_register() && operand.index() >= Register::reserved_register_count)
+                        operand = Operand { Operand::Type::Register, new_indices[operand.index()] };
+                });
+            }
+            block->remove_instructions_if([](Instruction const& instruction) {
+                if (instruction.type() != Instruction::Type::Mov)
+                    return false;
+                auto const& mov = static_cast<Op::Mov const&>(instruction);
+                return mov.src() == mov.dst();
+            });
+        }
+
+        return next_index;
+    }
+
+    Vector<NonnullOwnPtr<BasicBlock>>& m_blocks;
+    u32 m_number_of_registers { 0 };
+    HashMap<BasicBlock const*, size_t> m_block_indices;
+    RegisterSet m_pinned_registers;
+
+    Vector<Vector<size_t>> m_successors;
+    Vector<Vector<size_t>> m_exception_successors;
+
+    Vector<RegisterSet> m_live_in;
+    Vector<RegisterSet> m_live_out;
+    Vector<RegisterSet> m_exception_live;
+};
+
+}
+
+static size_t count_instructions(Vector<NonnullOwnPtr<BasicBlock>> const& blocks)
+{
+    size_t count = 0;
+    for (auto const& block : blocks) {
+        for (InstructionStreamIterator it { block->instruction_stream() }; !it.at_end(); ++it)
+            ++count;
+    }
+    return count;
+}
+
+u32 Optimizer::optimize(Vector<NonnullOwnPtr<BasicBlock>>& blocks, u32 number_of_registers)
+{
+    if (!is_enabled())
+        return number_of_registers;
+
+    auto start = MonotonicTime::now();
+    s_statistics.instructions_before += count_instructions(blocks);
+    s_statistics.registers_before += number_of_registers;
+
+    auto new_number_of_registers = ExecutableOptimizer { blocks, number_of_registers }.optimize();
+
+    ++s_statistics.optimized_executables;
+    s_statistics.instructions_after += count_instructions(blocks);
+    s_statistics.registers_after += new_number_of_registers;
+    s_statistics.time += MonotonicTime::now() - start;
+    return new_number_of_registers;
+}
+
+}
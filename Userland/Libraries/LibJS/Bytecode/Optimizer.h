@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <LibJS/Forward.h>
+
+namespace JS::Bytecode {
+
+// Cleans up the bytecode of an executable before it runs. Copies of registers and constants are read from where they
+// were copied from, copies into registers that are never read again are dropped, and registers that are never needed
+// at the same time share a slot, so every call of the executable needs fewer of them.
+class Optimizer {
+public:
+    // Returns the number of registers the blocks need afterwards.
+    static u32 optimize(Vector<NonnullOwnPtr<BasicBlock>>&, u32 number_of_registers);
+
+    // The optimizer can be turned off with LIBJS_BYTECODE_OPTIMIZER=0 in the environment.
+    static bool is_enabled();
+    static void set_enabled(bool);
+
+    struct Statistics {
+        size_t optimized_executables { 0 };
+        size_t instructions_before { 0 };
+        size_t instructions_after { 0 };
+        size_t registers_before { 0 };
+        size_t registers_after { 0 };
+        Duration time;
+    };
+    static Statistics& statistics();
+    static void dump_statistics();
+};
+
+}
@@ -25,6 +25,7 @@ public:
     ByteString const& get(StringTableIndex) const;
     void dump() const;
     bool is_empty() const { return m_strings.is_empty(); }
+    size_t size() const { return m_strings.size(); }
 
 private:
     Vector<ByteString> m_strings;
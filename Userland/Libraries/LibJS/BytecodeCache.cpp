@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Hex.h>
+#include <AK/MemoryStream.h>
+#include <AK/ScopeGuard.h>
+#include <LibCore/Directory.h>
+#include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/System.h>
+#include <LibCrypto/Checksum/CRC32.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/BytecodeCache.h>
+#include <dlfcn.h>
+
+namespace JS {
+
+static constexpr auto magic = "LibJSBC\n"sv;
+
+// Bumped whenever the format of the files or of serialized executables changes.
+static constexpr u32 format_version = 1;
+
+static Optional<ByteString> s_directory;
+static BytecodeCache::Statistics s_statistics;
+
+// Serialized bytecode is only good for the build that wrote it, as it's the instructions as they are in memory, and
+// another code generator may have generated something else. So the files are tied to the binary that LibJS is in.
+static ErrorOr<ByteString> build_fingerprint()
+{
+    Dl_info info {};
+    if (dladdr(reinterpret_cast<void const*>(&build_fingerprint), &info) == 0 || !info.dli_fname)
+        return AK::Error::from_string_literal("Can't find the binary that LibJS is in");
+    auto path = StringView { info.dli_fname, strlen(info.dli_fname) };
+    auto stat = TRY(Core::System::stat(path));
+
+    StringBuilder builder;
+    builder.appendff("{} {} {} {}", format_version, path, stat.st_size, stat.st_mtime);
+#define __BYTECODE_OP(op) \
+    builder.appendff(" {}", sizeof(Bytecode::Op::op));
+    ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    return builder.to_byte_string();
+}
+
+static ByteString const& fingerprint()
+{
+    static ByteString fingerprint = [] {
+        auto fingerprint = build_fingerprint();
+        if (fingerprint.is_error()) {
+            dbgln("BytecodeCache: Not writing any files, as there's no fingerprint for this build: {}", fingerprint.error());
+            return ByteString {};
+        }
+        return fingerprint.release_value();
+    }();
+    return fingerprint;
+}
+
+// The same source range can be compiled as different things, such as a program and the expression statement that makes
+// it up, so the key of a record is more than the offsets of its root.
+static u8 record_tag(ASTNode const& root, FunctionKind kind)
+{
+    u8 tag = to_underlying(kind);
+    if (root.is_program())
+        tag |= 1 << 4;
+    if (root.is_scope_node())
+        tag |= 1 << 5;
+    return tag;
+}
+
+static u64 record_key(ASTNode const& root)
+{
+    return (static_cast<u64>(root.start_offset()) << 32) | root.end_offset();
+}
+
+ErrorOr<void> BytecodeCache::enable(ByteString directory)
+{
+    TRY(Core::Directory::create(directory, Core::Directory::CreateDirectories::Yes));
+    s_directory = move(directory);
+    return {};
+}
+
+void BytecodeCache::disable()
+{
+    s_directory.clear();
+}
+
+bool BytecodeCache::is_enabled()
+{
+    return s_directory.has_value();
+}
+
+BytecodeCache::Statistics& BytecodeCache::statistics()
+{
+    return s_statistics;
+}
+
+void BytecodeCache::attach(Program const& program)
+{
+    if (!is_enabled() || program.source_code().bytecode_cache())
+        return;
+    program.source_code().set_bytecode_cache(adopt_ref(*new BytecodeCache(program.type() == Program::Type::Module)));
+}
+
+BytecodeCache::BytecodeCache(bool is_module)
+    : m_is_module(is_module)
+{
+}
+
+BytecodeCache::~BytecodeCache() = default;
+
+void BytecodeCache::open(SourceCode const& source_code)
+{
+    if (m_is_open || !is_enabled())
+        return;
+    m_is_open = true;
+
+    Crypto::Hash::SHA256 sha;
+    sha.update(m_is_module ? "module\n"sv : "script\n"sv);
+    sha.update(source_code.code().bytes());
+    m_path = ByteString::formatted("{}/{}.jsbc", *s_directory, encode_hex(sha.digest().bytes()));
+
+    auto file = Core::MappedFile::map(m_path);
+    if (file.is_error())
+        return;
+    m_file = file.release_value();
+
+    FixedMemoryStream stream { m_file->bytes() };
+    auto header = [&]() -> ErrorOr<bool> {
+        auto file_magic = TRY(stream.read_in_place<u8 const>(magic.length()));
+        if (StringView { file_magic } != magic)
+            return false;
+        auto fingerprint_length = TRY(stream.read_value<u32>());
+        auto file_fingerprint = TRY(stream.read_in_place<u8 const>(fingerprint_length));
+        return !fingerprint().is_empty() && StringView { file_fingerprint } == fingerprint();
+    }();
+    if (header.is_error() || !header.value())
+        return;
+    m_has_valid_file = true;
+
+    // NOTE: A process that crashed while appending a record may have left it cut off, which ends the file here.
+    while (!stream.is_eof()) {
+        auto record = [&]() -> ErrorOr<void> {
+            auto start_offset = TRY(stream.read_value<u32>());
+            auto end_offset = TRY(stream.read_value<u32>());
+            auto tag = TRY(stream.read_value<u8>());
+            auto checksum = TRY(stream.read_value<u32>());
+            auto size = TRY(stream.read_value<u32>());
+            auto payload = TRY(stream.read_in_place<u8 const>(size));
+            m_records.ensure((static_cast<u64>(start_offset) << 32) | end_offset).append({ tag, checksum, payload });
+            return {};
+        }();
+        if (record.is_error())
+            break;
+    }
+}
+
+BytecodeCache::Record const* BytecodeCache::find_record(ASTNode const& root, u8 tag) const
+{
+    auto records = m_records.get(record_key(root));
+    if (!records.has_value())
+        return nullptr;
+    for (auto const& record : *records) {
+        if (record.tag == tag)
+            return &record;
+    }
+    return nullptr;
+}
+
+GCPtr<Bytecode::Executable> BytecodeCache::get(VM& vm, ASTNode const& root, FunctionKind kind)
+{
+    open(root.source_code());
+
+    auto const* record = find_record(root, record_tag(root, kind));
+    if (!record) {
+        ++s_statistics.misses;
+        return nullptr;
+    }
+
+    if (Crypto::Checksum::CRC32 { record->payload }.digest() != record->checksum) {
+        dbgln_if(JS_BYTECODE_DEBUG, "BytecodeCache: Record for {}-{} in {} is corrupted", root.start_offset(), root.end_offset(), m_path);
+        ++s_statistics.misses;
+        return nullptr;
+    }
+
+    auto executable = Bytecode::Executable::deserialize(vm, record->payload, root.source_code(), root);
+    if (executable.is_error()) {
+        dbgln_if(JS_BYTECODE_DEBUG, "BytecodeCache: Can't load {}-{} from {}: {}", root.start_offset(), root.end_offset(), m_path, executable.error());
+        ++s_statistics.misses;
+        return nullptr;
+    }
+
+    ++s_statistics.hits;
+    return executable.release_value();
+}
+
+void BytecodeCache::set(ASTNode const& root, FunctionKind kind, Bytecode::Executable const& executable)
+{
+    open(root.source_code());
+    if (m_path.is_empty() || fingerprint().is_empty())
+        return;
+
+    auto tag = record_tag(root, kind);
+    auto& written_tags = m_written_tags.ensure(record_key(root));
+    if (find_record(root, tag) || written_tags.contains_slow(tag))
+        return;
+    written_tags.append(tag);
+
+    auto payload = executable.serialize();
+    if (payload.is_error()) {
+        dbgln_if(JS_BYTECODE_DEBUG, "BytecodeCache: Can't save {}-{}: {}", root.start_offset(), root.end_offset(), payload.error());
+        return;
+    }
+
+    if (auto result = append_record(root, tag, payload.value()); result.is_error()) {
+        dbgln_if(JS_BYTECODE_DEBUG, "BytecodeCache: Can't write to {}: {}", m_path, result.error());
+        return;
+    }
+    ++s_statistics.records_written;
+}
+
+ErrorOr<void> BytecodeCache::append_record(ASTNode const& root, u8 tag, ReadonlyBytes payload)
+{
+    // A file that's missing or from another build is replaced, so that other processes never see it half-written.
+    if (!m_has_valid_file) {
+        auto temporary_path_template = ByteString::formatted("{}.XXXXXX", m_path);
+        auto temporary_path = TRY(ByteBuffer::copy(temporary_path_template.bytes()));
+        TRY(temporary_path.try_append('\0'));
+        auto file = TRY(Core::File::adopt_fd(TRY(Core::System::mkstemp(Span<char> { reinterpret_cast<char*>(temporary_path.data()), temporary_path.size() })), Core::File::OpenMode::Write));
+        auto temporary_path_view = StringView { temporary_path.bytes().trim(temporary_path.size() - 1) };
+        ArmedScopeGuard remove_temporary_file = [&] { (void)Core::System::unlink(temporary_path_view); };
+        TRY(file->write_until_depleted(magic.bytes()));
+        TRY(file->write_value<u32>(fingerprint().length()));
+        TRY(file->write_until_depleted(fingerprint().bytes()));
+        file->close();
+        TRY(Core::System::rename(temporary_path_view, m_path));
+        remove_temporary_file.disarm();
+        m_has_valid_file = true;
+    }
+
+    AllocatingMemoryStream record;
+    TRY(record.write_value<u32>(root.start_offset()));
+    TRY(record.write_value<u32>(root.end_offset()));
+    TRY(record.write_value<u8>(tag));
+    TRY(record.write_value<u32>(Crypto::Checksum::CRC32 { payload }.digest()));
+    TRY(record.write_value<u32>(payload.size()));
+    TRY(record.write_until_depleted(payload));
+
+    // NOTE: The record is written all at once, so that records appended by other processes don't end up in the middle.
+    auto bytes = TRY(record.read_until_eof());
+    auto file = TRY(Core::File::open(m_path, Core::File::OpenMode::Write | Core::File::OpenMode::Append | Core::File::OpenMode::DontCreate));
+    TRY(file->write_until_depleted(bytes));
+    return {};
+}
+
+}
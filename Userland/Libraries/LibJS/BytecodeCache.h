@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <AK/RefCounted.h>
+#include <LibCore/Forward.h>
+#include <LibJS/Forward.h>
+#include <LibJS/Heap/GCPtr.h>
+#include <LibJS/Runtime/FunctionKind.h>
+
+namespace JS {
+
+// Keeps the bytecode of scripts and modules on disk, so that the next process that runs the same source text (like the
+// same framework bundle on the next page load) loads it instead of generating it again. Each source text has a file,
+// named after its hash, and a record is appended to it for each executable as it's generated. Opening the file only
+// indexes the records, and each one is deserialized when its function is first called.
+// NOTE: The source text is still parsed, as the bytecode refers to the AST for functions, classes and scopes.
+class BytecodeCache : public RefCounted<BytecodeCache> {
+public:
+    struct Statistics {
+        size_t hits { 0 };
+        size_t misses { 0 };
+        size_t records_written { 0 };
+    };
+
+    // The cache is off until it has a directory, which has to be set before parsing anything that should use it.
+    static ErrorOr<void> enable(ByteString directory);
+    static void disable();
+    static bool is_enabled();
+    static Statistics& statistics();
+
+    // Makes the bytecode of the program and of its functions go through the cache.
+    static void attach(Program const&);
+
+    ~BytecodeCache();
+
+    GCPtr<Bytecode::Executable> get(VM&, ASTNode const& root, FunctionKind);
+    void set(ASTNode const& root, FunctionKind, Bytecode::Executable const&);
+
+private:
+    explicit BytecodeCache(bool is_module);
+
+    struct Record {
+        u8 tag { 0 };
+        u32 checksum { 0 };
+        ReadonlyBytes payload;
+    };
+
+    void open(SourceCode const&);
+    Record const* find_record(ASTNode const& root, u8 tag) const;
+    ErrorOr<void> append_record(ASTNode const& root, u8 tag, ReadonlyBytes payload);
+
+    bool m_is_module { false };
+    bool m_is_open { false };
+    bool m_has_valid_file { false };
+    ByteString m_path;
+    OwnPtr<Core::MappedFile> m_file;
+
+    // Keyed by the start and end offset of the root node.
+    HashMap<u64, Vector<Record, 1>> m_records;
+    HashMap<u64, Vector<u8, 1>> m_written_tags;
+};
+
+}
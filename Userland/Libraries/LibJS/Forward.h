@@ -156,6 +156,7 @@ class Accessor;
 struct AsyncGeneratorRequest;
 class BigInt;
 class BoundFunction;
+class BytecodeCache;
 class Cell;
 class CellAllocator;
 class ClassExpression;
@@ -324,4 +325,8 @@ class RegexTable;
 class Register;
 }
 
+namespace JIT {
+class NativeExecutable;
+}
+
 }
@@ -27,6 +27,14 @@ public:                                            \
     }                                              \
     friend class JS::Heap;
 
+// Declares that every store of a reference to another cell into an existing class_ (including into the members of its
+// base classes) is followed by a call to Cell::write_barrier(). Cells of classes that don't declare this are scanned
+// again by every minor collection and at the end of incremental marking, as they could have changed at any time.
+// NOTE: This only applies to cells of exactly this class. Subclasses have to declare it for themselves.
+#define JS_CELL_HAS_WRITE_BARRIERS(class_) \
+public:                                     \
+    using CellClassWithWriteBarriers = class_;
+
 class Cell {
     AK_MAKE_NONCOPYABLE(Cell);
     AK_MAKE_NONMOVABLE(Cell);
@@ -38,14 +46,31 @@ public:
     bool is_marked() const { return m_mark; }
     void set_marked(bool b) { m_mark = b; }
 
-    enum class State : bool {
+    enum class State : u8 {
         Live,
         Dead,
+
+        // The cell didn't survive garbage collection, but its CellAllocator sweeps lazily, so it will only be
+        // destroyed once the allocator needs its block again.
+        Unswept,
     };
 
     State state() const { return m_state; }
     void set_state(State state) { m_state = state; }
 
+    // Cells that survive a collection become old, and are only collected by major collections from then on.
+    bool is_old() const { return m_is_old; }
+    bool has_write_barriers() const { return m_has_write_barriers; }
+
+    // Has to be called after storing a reference to another cell into this one, unless it's still being constructed.
+    // An old cell could otherwise point to a young cell without minor collections knowing, and a cell that incremental
+    // marking already visited could point to one that it hasn't without the end of marking knowing.
+    ALWAYS_INLINE void write_barrier()
+    {
+        if (m_has_write_barriers && (m_is_old || m_mark) && !m_is_remembered)
+            remember();
+    }
+
     virtual StringView class_name() const = 0;
 
     class Visitor {
@@ -168,9 +193,16 @@ protected:
     void set_overrides_must_survive_garbage_collection(bool b) { m_overrides_must_survive_garbage_collection = b; }
 
 private:
+    friend class Heap;
+
+    void remember();
+
     bool m_mark : 1 { false };
     bool m_overrides_must_survive_garbage_collection : 1 { false };
-    State m_state : 1 { State::Live };
+    State m_state : 2 { State::Live };
+    bool m_is_old : 1 { false };
+    bool m_is_remembered : 1 { false };
+    bool m_has_write_barriers : 1 { false };
 };
 
 }
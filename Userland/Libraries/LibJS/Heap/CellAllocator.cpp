@@ -12,9 +12,10 @@
 
 namespace JS {
 
-CellAllocator::CellAllocator(size_t cell_size, char const* class_name)
+CellAllocator::CellAllocator(size_t cell_size, char const* class_name, SweepMode sweep_mode)
     : m_class_name(class_name)
     , m_cell_size(cell_size)
+    , m_sweep_mode(sweep_mode)
 {
 }
 
@@ -23,6 +24,13 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
     if (!m_list_node.is_in_list())
         heap.register_cell_allocator({}, *this);
 
+    if (m_usable_blocks.is_empty() && !m_unswept_blocks.is_empty()) {
+        auto& block = *m_unswept_blocks.first();
+        sweep_block(block);
+        block.m_list_node.remove();
+        m_usable_blocks.append(block);
+    }
+
     if (m_usable_blocks.is_empty()) {
         auto block = HeapBlock::create_with_cell_size(heap, *this, m_cell_size, m_class_name);
         auto block_ptr = reinterpret_cast<FlatPtr>(block.ptr());
@@ -55,4 +63,40 @@ void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
     m_usable_blocks.append(block);
 }
 
+void CellAllocator::block_did_become_unswept(Badge<Heap>, HeapBlock& block)
+{
+    VERIFY(sweeps_lazily());
+    block.m_list_node.remove();
+    m_unswept_blocks.append(block);
+}
+
+void CellAllocator::sweep_unswept_blocks(Badge<Heap>)
+{
+    Vector<HeapBlock*, 32> empty_blocks;
+    while (!m_unswept_blocks.is_empty()) {
+        auto& block = *m_unswept_blocks.take_first();
+        if (sweep_block(block))
+            m_usable_blocks.append(block);
+        else
+            empty_blocks.append(&block);
+    }
+
+    for (auto* block : empty_blocks) {
+        block->~HeapBlock();
+        m_block_allocator.deallocate_block(block);
+    }
+}
+
+bool CellAllocator::sweep_block(HeapBlock& block)
+{
+    bool block_has_live_cells = false;
+    block.for_each_cell([&](Cell* cell) {
+        if (cell->state() == Cell::State::Unswept)
+            block.deallocate(cell);
+        else if (cell->state() == Cell::State::Live)
+            block_has_live_cells = true;
+    });
+    return block_has_live_cells;
+}
+
 }
@@ -19,14 +19,26 @@
 #define JS_DEFINE_ALLOCATOR(ClassName) \
     JS::TypeIsolatingCellAllocator<ClassName> ClassName::cell_allocator { #ClassName }
 
+// Cells from a lazily swept allocator are destroyed when their block is next needed for allocation, instead of during
+// garbage collection. Only use this for classes whose destructor has no effects beyond the cell itself, and that aren't
+// Weakable, since anything that can still find the cell after it died would see it before it's destroyed.
+#define JS_DEFINE_LAZILY_SWEPT_ALLOCATOR(ClassName) \
+    JS::TypeIsolatingCellAllocator<ClassName> ClassName::cell_allocator { #ClassName, JS::CellAllocator::SweepMode::Lazy }
+
 namespace JS {
 
 class CellAllocator {
 public:
-    CellAllocator(size_t cell_size, char const* class_name = nullptr);
+    enum class SweepMode {
+        Eager,
+        Lazy,
+    };
+
+    CellAllocator(size_t cell_size, char const* class_name = nullptr, SweepMode = SweepMode::Eager);
     ~CellAllocator() = default;
 
     size_t cell_size() const { return m_cell_size; }
+    bool sweeps_lazily() const { return m_sweep_mode == SweepMode::Lazy; }
 
     Cell* allocate_cell(Heap&);
 
@@ -41,11 +53,19 @@ public:
             if (callback(block) == IterationDecision::Break)
                 return IterationDecision::Break;
         }
+        for (auto& block : m_unswept_blocks) {
+            if (callback(block) == IterationDecision::Break)
+                return IterationDecision::Break;
+        }
         return IterationDecision::Continue;
     }
 
     void block_did_become_empty(Badge<Heap>, HeapBlock&);
     void block_did_become_usable(Badge<Heap>, HeapBlock&);
+    void block_did_become_unswept(Badge<Heap>, HeapBlock&);
+
+    // Destroys all remaining unswept cells, and gives blocks that are left empty back to the BlockAllocator.
+    void sweep_unswept_blocks(Badge<Heap>);
 
     IntrusiveListNode<CellAllocator> m_list_node;
     using List = IntrusiveList<&CellAllocator::m_list_node>;
@@ -55,14 +75,18 @@ public:
     FlatPtr max_block_address() const { return m_max_block_address; }
 
 private:
+    bool sweep_block(HeapBlock&);
+
     char const* const m_class_name { nullptr };
     size_t const m_cell_size;
+    SweepMode const m_sweep_mode;
 
     BlockAllocator m_block_allocator;
 
     using BlockList = IntrusiveList<&HeapBlock::m_list_node>;
     BlockList m_full_blocks;
     BlockList m_usable_blocks;
+    BlockList m_unswept_blocks;
     FlatPtr m_min_block_address { explode_byte(0xff) };
     FlatPtr m_max_block_address { 0 };
 };
@@ -72,8 +96,8 @@ class TypeIsolatingCellAllocator {
 public:
     using CellType = T;
 
-    TypeIsolatingCellAllocator(char const* class_name)
-        : allocator(sizeof(T), class_name)
+    TypeIsolatingCellAllocator(char const* class_name, CellAllocator::SweepMode sweep_mode = CellAllocator::SweepMode::Eager)
+        : allocator(sizeof(T), class_name, sweep_mode)
     {
     }
 
@@ -36,6 +36,7 @@ namespace JS {
 
 #ifdef AK_OS_SERENITY
 static int gc_perf_string_id;
+static int gc_pause_perf_string_id;
 #endif
 
 // NOTE: We keep a per-thread list of custom ranges. This hinges on the assumption that there is one JS VM per thread.
@@ -48,6 +49,8 @@ Heap::Heap(VM& vm)
 #ifdef AK_OS_SERENITY
     auto gc_signpost_string = "Garbage collection"sv;
     gc_perf_string_id = perf_register_string(gc_signpost_string.characters_without_null_termination(), gc_signpost_string.length());
+    auto gc_pause_signpost_string = "Garbage collection pause (us)"sv;
+    gc_pause_perf_string_id = perf_register_string(gc_pause_signpost_string.characters_without_null_termination(), gc_pause_signpost_string.length());
 #endif
 
     if constexpr (HeapBlock::min_possible_cell_size <= 16) {
@@ -73,15 +76,30 @@ Heap::~Heap()
 
 void Heap::will_allocate(size_t size)
 {
+    // NOTE: Young cells can only be collected once marking is done, so while it's underway, the nursery gets to grow as
+    //       much as the heap would have before a full collection. That gives the steps time to get through the old cells.
+    auto nursery_bytes = m_is_marking_incrementally ? max(GC_NURSERY_BYTES, m_gc_bytes_threshold) : GC_NURSERY_BYTES;
+
     if (should_collect_on_every_allocation()) {
         m_allocated_bytes_since_last_gc = 0;
         collect_garbage();
-    } else if (m_allocated_bytes_since_last_gc + size > m_gc_bytes_threshold) {
-        m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
+    } else if (m_allocated_bytes_since_last_gc + size > nursery_bytes) {
+        collect_garbage_after_allocation();
+    } else if (m_is_marking_incrementally && m_allocated_bytes_since_last_marking_step + size > GC_INCREMENTAL_MARKING_STEP_BYTES) {
+        perform_incremental_marking_step(GC_INCREMENTAL_MARKING_STEP_BUDGET);
     }
 
     m_allocated_bytes_since_last_gc += size;
+    m_allocated_bytes_since_last_marking_step += size;
+}
+
+void Heap::collect_garbage_after_allocation()
+{
+    collect_young_garbage();
+
+    // Like the threshold of full collections, this lets the heap double in size before the old cells are collected.
+    if (m_promoted_bytes_since_last_major_gc > m_gc_bytes_threshold)
+        start_incremental_marking();
 }
 
 static void add_possible_value(HashMap<FlatPtr, HeapRoot>& possible_pointers, FlatPtr data, HeapRoot origin, FlatPtr min_block_address, FlatPtr max_block_address)
@@ -263,31 +281,23 @@ AK::JsonObject Heap::dump_graph()
     return visitor.dump();
 }
 
-void Heap::collect_garbage(CollectionType collection_type, bool print_report)
+void Heap::sweep_unswept_cells()
 {
-    VERIFY(!m_collecting_garbage);
-    TemporaryChange change(m_collecting_garbage, true);
+    if (m_collecting_garbage)
+        return;
+    for (auto& allocator : m_all_cell_allocators)
+        allocator.sweep_unswept_blocks({});
+}
 
+void Heap::did_pause_for_garbage_collection(Duration pause)
+{
 #ifdef AK_OS_SERENITY
-    static size_t global_gc_counter = 0;
-    perf_event(PERF_EVENT_SIGNPOST, gc_perf_string_id, global_gc_counter++);
+    perf_event(PERF_EVENT_SIGNPOST, gc_pause_perf_string_id, pause.to_microseconds());
 #endif
 
-    Core::ElapsedTimer collection_measurement_timer;
-    if (print_report)
-        collection_measurement_timer.start();
-
-    if (collection_type == CollectionType::CollectGarbage) {
-        if (m_gc_deferrals) {
-            m_should_gc_when_deferral_ends = true;
-            return;
-        }
-        HashMap<Cell*, HeapRoot> roots;
-        gather_roots(roots);
-        mark_live_cells(roots);
-    }
-    finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    m_statistics.last_pause = pause;
+    m_statistics.max_pause = max(m_statistics.max_pause, pause);
+    m_statistics.total_pause += pause;
 }
 
 void Heap::gather_roots(HashMap<Cell*, HeapRoot>& roots)
@@ -393,23 +403,22 @@ NO_SANITIZE_ADDRESS void Heap::gather_conservative_roots(HashMap<Cell*, HeapRoot
 
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots)
+    MarkingVisitor(Heap& heap, Vector<NonnullGCPtr<Cell>>& work_queue, Heap::Generation generation)
         : m_heap(heap)
+        , m_work_queue(work_queue)
+        , m_generation(generation)
     {
-        m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
-        m_heap.for_each_block([&](auto& block) {
-            m_all_live_heap_blocks.set(&block);
-            return IterationDecision::Continue;
-        });
+    }
 
-        for (auto* root : roots.keys()) {
+    void mark_roots(HashMap<Cell*, HeapRoot> const& roots)
+    {
+        for (auto* root : roots.keys())
             visit(root);
-        }
     }
 
     virtual void visit_impl(Cell& cell) override
     {
-        if (cell.is_marked())
+        if (cell.is_marked() || !should_mark(cell))
             return;
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
@@ -419,6 +428,16 @@ public:
 
     virtual void visit_possible_values(ReadonlyBytes bytes) override
     {
+        // NOTE: Incremental marking creates a visitor for each step, most of which won't need to know the blocks.
+        if (!m_has_gathered_blocks) {
+            m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
+            m_heap.for_each_block([&](auto& block) {
+                m_all_live_heap_blocks.set(&block);
+                return IterationDecision::Continue;
+            });
+            m_has_gathered_blocks = true;
+        }
+
         HashMap<FlatPtr, HeapRoot> possible_pointers;
 
         auto* raw_pointer_sized_values = reinterpret_cast<FlatPtr const*>(bytes.data());
@@ -426,7 +445,7 @@ public:
             add_possible_value(possible_pointers, raw_pointer_sized_values[i], HeapRoot { .type = HeapRoot::Type::HeapFunctionCapturedPointer }, m_min_block_address, m_max_block_address);
 
         for_each_cell_among_possible_pointers(m_all_live_heap_blocks, possible_pointers, [&](Cell* cell, FlatPtr) {
-            if (cell->is_marked())
+            if (cell->is_marked() || !should_mark(*cell))
                 return;
             if (cell->state() != Cell::State::Live)
                 return;
@@ -442,26 +461,326 @@ public:
         }
     }
 
+    // Returns whether all live cells have been marked.
+    bool mark_live_cells_until(Core::ElapsedTimer const& timer, Duration budget)
+    {
+        while (!m_work_queue.is_empty()) {
+            for (size_t i = 0; i < 256 && !m_work_queue.is_empty(); ++i)
+                m_work_queue.take_last()->visit_edges(*this);
+            if (timer.elapsed_time() >= budget)
+                break;
+        }
+        return m_work_queue.is_empty();
+    }
+
 private:
+    // Minor collections consider every old cell live, so they don't need to mark them or look at their edges.
+    bool should_mark(Cell const& cell) const
+    {
+        return m_generation == Heap::Generation::All || !cell.is_old();
+    }
+
     Heap& m_heap;
-    Vector<NonnullGCPtr<Cell>> m_work_queue;
+    Vector<NonnullGCPtr<Cell>>& m_work_queue;
+    Heap::Generation m_generation;
+    bool m_has_gathered_blocks { false };
     HashTable<HeapBlock*> m_all_live_heap_blocks;
-    FlatPtr m_min_block_address;
-    FlatPtr m_max_block_address;
+    FlatPtr m_min_block_address { 0 };
+    FlatPtr m_max_block_address { 0 };
 };
 
 void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots)
 {
     dbgln_if(HEAP_DEBUG, "mark_live_cells:");
 
-    MarkingVisitor visitor(*this, roots);
+    MarkingVisitor visitor(*this, m_marking_work_queue, Generation::All);
+    visitor.mark_roots(roots);
+    visitor.mark_all_live_cells();
+}
+
+void Heap::mark_live_young_cells(HashMap<Cell*, HeapRoot> const& roots)
+{
+    dbgln_if(HEAP_DEBUG, "mark_live_young_cells:");
+
+    MarkingVisitor visitor(*this, m_marking_work_queue, Generation::Young);
+    visitor.mark_roots(roots);
+
+    // Old cells can only point to young cells if they were written to since the last collection, which their write
+    // barrier remembers, or if they don't have write barriers.
+    for (auto& cell : m_remembered_cells)
+        cell->visit_edges(visitor);
+    for_each_block([&](auto& block) {
+        if (!block.has_cells_without_write_barriers())
+            return IterationDecision::Continue;
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (cell->is_old() && !cell->has_write_barriers())
+                cell->visit_edges(visitor);
+        });
+        return IterationDecision::Continue;
+    });
 
     visitor.mark_all_live_cells();
+}
+
+void Heap::clear_uprooted_cells(Generation generation)
+{
+    // NOTE: Old cells are only collected by major collections, so they stay uprooted until the next one.
+    m_uprooted_cells.remove_all_matching([&](auto& cell) {
+        if (generation == Generation::Young && cell->is_old())
+            return false;
+        cell->set_marked(false);
+        return true;
+    });
+}
+
+void Heap::forget_remembered_cells()
+{
+    for (auto& cell : m_remembered_cells)
+        cell->m_is_remembered = false;
+    m_remembered_cells.clear();
+}
+
+class ReachabilityVerifyingVisitor final : public Cell::Visitor {
+public:
+    ReachabilityVerifyingVisitor(Cell& cell, Heap::Generation generation)
+        : m_cell(cell)
+        , m_generation(generation)
+    {
+    }
+
+    virtual void visit_impl(Cell& cell) override
+    {
+        if (cell.state() != Cell::State::Live || cell.is_marked())
+            return;
+        if (m_generation == Heap::Generation::Young && cell.is_old())
+            return;
+        dbgln("{} points to {}, which wasn't marked. Is a write barrier missing?", &m_cell, &cell);
+        VERIFY_NOT_REACHED();
+    }
 
-    for (auto& inverse_root : m_uprooted_cells)
-        inverse_root->set_marked(false);
+    virtual void visit_possible_values(ReadonlyBytes) override
+    {
+    }
 
-    m_uprooted_cells.clear();
+private:
+    Cell& m_cell;
+    Heap::Generation m_generation;
+};
+
+void Heap::verify_no_unmarked_cells_are_reachable_from_marked_cells(Generation generation)
+{
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            // NOTE: For minor collections, old cells count as marked.
+            if (!cell->is_marked() && !(generation == Generation::Young && cell->is_old()))
+                return;
+            ReachabilityVerifyingVisitor visitor(*cell, generation);
+            cell->visit_edges(visitor);
+        });
+        return IterationDecision::Continue;
+    });
+}
+
+void Heap::collect_garbage(CollectionType collection_type, bool print_report)
+{
+    VERIFY(!m_collecting_garbage);
+    TemporaryChange change(m_collecting_garbage, true);
+
+#ifdef AK_OS_SERENITY
+    static size_t global_gc_counter = 0;
+    perf_event(PERF_EVENT_SIGNPOST, gc_perf_string_id, global_gc_counter++);
+#endif
+
+    Core::ElapsedTimer collection_measurement_timer;
+    collection_measurement_timer.start();
+
+    if (collection_type == CollectionType::CollectGarbage && m_gc_deferrals) {
+        m_should_gc_when_deferral_ends = true;
+        return;
+    }
+
+    // NOTE: Marking everything at once is quicker than finishing incremental marking, which would have to look at the
+    //       remembered cells again anyway, so what it has marked so far is thrown away.
+    abandon_incremental_marking();
+
+    // NOTE: Cells left over from the last collection have to be destroyed before this one decides what's dead.
+    for (auto& allocator : m_all_cell_allocators)
+        allocator.sweep_unswept_blocks({});
+
+    if (collection_type == CollectionType::CollectGarbage) {
+        HashMap<Cell*, HeapRoot> roots;
+        gather_roots(roots);
+        mark_live_cells(roots);
+        if constexpr (HEAP_DEBUG)
+            verify_no_unmarked_cells_are_reachable_from_marked_cells(Generation::All);
+    }
+    clear_uprooted_cells(Generation::All);
+    forget_remembered_cells();
+    finalize_unmarked_cells(Generation::All);
+    sweep_dead_cells(collection_type, Generation::All, print_report, collection_measurement_timer);
+
+    ++m_statistics.collections;
+    did_pause_for_garbage_collection(collection_measurement_timer.elapsed_time());
+}
+
+void Heap::collect_young_garbage()
+{
+    VERIFY(!m_collecting_garbage);
+
+    if (m_gc_deferrals) {
+        m_should_gc_when_deferral_ends = true;
+        return;
+    }
+
+    // NOTE: Minor collections promote every young cell that they find, including those that marking hasn't visited,
+    //       so they can't happen in the middle of it.
+    if (m_is_marking_incrementally) {
+        finish_incremental_marking();
+        return;
+    }
+
+    TemporaryChange change(m_collecting_garbage, true);
+
+#ifdef AK_OS_SERENITY
+    static size_t global_minor_gc_counter = 0;
+    perf_event(PERF_EVENT_SIGNPOST, gc_perf_string_id, global_minor_gc_counter++);
+#endif
+
+    Core::ElapsedTimer collection_measurement_timer;
+    collection_measurement_timer.start();
+
+    for (auto& allocator : m_all_cell_allocators)
+        allocator.sweep_unswept_blocks({});
+
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    mark_live_young_cells(roots);
+    if constexpr (HEAP_DEBUG)
+        verify_no_unmarked_cells_are_reachable_from_marked_cells(Generation::Young);
+
+    clear_uprooted_cells(Generation::Young);
+    forget_remembered_cells();
+    finalize_unmarked_cells(Generation::Young);
+    sweep_dead_cells(CollectionType::CollectGarbage, Generation::Young, false, collection_measurement_timer);
+
+    ++m_statistics.minor_collections;
+    did_pause_for_garbage_collection(collection_measurement_timer.elapsed_time());
+}
+
+void Heap::start_incremental_marking()
+{
+    if (m_is_marking_incrementally || m_collecting_garbage || m_gc_deferrals)
+        return;
+    TemporaryChange change(m_collecting_garbage, true);
+
+    Core::ElapsedTimer measurement_timer;
+    measurement_timer.start();
+
+    // NOTE: From here on, the remembered cells are the ones that were written to after marking started, which may
+    //       have to be marked again.
+    forget_remembered_cells();
+    m_is_marking_incrementally = true;
+    m_allocated_bytes_since_last_marking_step = 0;
+
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    MarkingVisitor visitor(*this, m_marking_work_queue, Generation::All);
+    visitor.mark_roots(roots);
+
+    did_pause_for_garbage_collection(measurement_timer.elapsed_time());
+}
+
+void Heap::perform_incremental_marking_step(Duration budget)
+{
+    if (!m_is_marking_incrementally || m_collecting_garbage || m_gc_deferrals)
+        return;
+
+    Core::ElapsedTimer measurement_timer;
+    measurement_timer.start();
+
+    bool is_done = false;
+    {
+        TemporaryChange change(m_collecting_garbage, true);
+        MarkingVisitor visitor(*this, m_marking_work_queue, Generation::All);
+        is_done = visitor.mark_live_cells_until(measurement_timer, budget);
+    }
+    m_allocated_bytes_since_last_marking_step = 0;
+    ++m_statistics.incremental_marking_steps;
+    did_pause_for_garbage_collection(measurement_timer.elapsed_time());
+
+    if (is_done)
+        finish_incremental_marking();
+}
+
+void Heap::finish_incremental_marking()
+{
+    VERIFY(m_is_marking_incrementally);
+    VERIFY(!m_collecting_garbage);
+
+    if (m_gc_deferrals) {
+        m_should_gc_when_deferral_ends = true;
+        return;
+    }
+
+    TemporaryChange change(m_collecting_garbage, true);
+
+#ifdef AK_OS_SERENITY
+    static size_t global_incremental_gc_counter = 0;
+    perf_event(PERF_EVENT_SIGNPOST, gc_perf_string_id, global_incremental_gc_counter++);
+#endif
+
+    Core::ElapsedTimer collection_measurement_timer;
+    collection_measurement_timer.start();
+
+    for (auto& allocator : m_all_cell_allocators)
+        allocator.sweep_unswept_blocks({});
+
+    // The roots may have changed since marking started, and so may the cells that were marked already. Those that
+    // have write barriers were remembered, and the ones that don't have to be looked at again.
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    MarkingVisitor visitor(*this, m_marking_work_queue, Generation::All);
+    visitor.mark_roots(roots);
+    for (auto& cell : m_remembered_cells) {
+        if (cell->is_marked())
+            cell->visit_edges(visitor);
+    }
+    for_each_block([&](auto& block) {
+        if (!block.has_cells_without_write_barriers())
+            return IterationDecision::Continue;
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (cell->is_marked() && !cell->has_write_barriers())
+                cell->visit_edges(visitor);
+        });
+        return IterationDecision::Continue;
+    });
+    visitor.mark_all_live_cells();
+    m_is_marking_incrementally = false;
+
+    if constexpr (HEAP_DEBUG)
+        verify_no_unmarked_cells_are_reachable_from_marked_cells(Generation::All);
+
+    clear_uprooted_cells(Generation::All);
+    forget_remembered_cells();
+    finalize_unmarked_cells(Generation::All);
+    sweep_dead_cells(CollectionType::CollectGarbage, Generation::All, false, collection_measurement_timer);
+
+    ++m_statistics.collections;
+    did_pause_for_garbage_collection(collection_measurement_timer.elapsed_time());
+}
+
+void Heap::abandon_incremental_marking()
+{
+    if (!m_is_marking_incrementally)
+        return;
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+            cell->set_marked(false);
+        });
+        return IterationDecision::Continue;
+    });
+    m_marking_work_queue.clear();
+    m_is_marking_incrementally = false;
 }
 
 bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
@@ -471,10 +790,14 @@ bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
     return cell.must_survive_garbage_collection();
 }
 
-void Heap::finalize_unmarked_cells()
+void Heap::finalize_unmarked_cells(Generation generation)
 {
     for_each_block([&](auto& block) {
-        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+        if (generation == Generation::Young && !block.has_young_cells())
+            return IterationDecision::Continue;
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (generation == Generation::Young && cell->is_old())
+                return;
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
                 cell->finalize();
         });
@@ -482,11 +805,12 @@ void Heap::finalize_unmarked_cells()
     });
 }
 
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+void Heap::sweep_dead_cells(CollectionType collection_type, Generation generation, bool print_report, Core::ElapsedTimer const& measurement_timer)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
     Vector<HeapBlock*, 32> empty_blocks;
     Vector<HeapBlock*, 32> full_blocks_that_became_usable;
+    Vector<HeapBlock*, 32> blocks_that_became_unswept;
 
     size_t collected_cells = 0;
     size_t live_cells = 0;
@@ -494,22 +818,47 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
     size_t live_cell_bytes = 0;
 
     for_each_block([&](auto& block) {
+        if (generation == Generation::Young && !block.has_young_cells())
+            return IterationDecision::Continue;
         bool block_has_live_cells = false;
+        bool block_has_unswept_cells = false;
+        bool block_has_cells_without_write_barriers = false;
         bool block_was_full = block.is_full();
+        bool sweep_lazily = collection_type == CollectionType::CollectGarbage && block.cell_allocator().sweeps_lazily();
         block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (generation == Generation::Young && cell->is_old()) {
+                block_has_live_cells = true;
+                block_has_cells_without_write_barriers |= !cell->has_write_barriers();
+                return;
+            }
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
                 dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
-                block.deallocate(cell);
+                if (sweep_lazily) {
+                    cell->set_state(Cell::State::Unswept);
+                    block_has_unswept_cells = true;
+                } else {
+                    block.deallocate(cell);
+                }
                 ++collected_cells;
                 collected_cell_bytes += block.cell_size();
             } else {
                 cell->set_marked(false);
+                if (!cell->is_old()) {
+                    cell->m_is_old = true;
+                    if (generation == Generation::Young)
+                        m_promoted_bytes_since_last_major_gc += block.cell_size();
+                }
                 block_has_live_cells = true;
+                block_has_cells_without_write_barriers |= !cell->has_write_barriers();
                 ++live_cells;
                 live_cell_bytes += block.cell_size();
             }
         });
-        if (!block_has_live_cells)
+        block.set_has_young_cells(false);
+        block.set_has_cells_without_write_barriers(block_has_cells_without_write_barriers);
+        if (block_has_unswept_cells)
+            blocks_that_became_unswept.append(&block);
+        else if (!block_has_live_cells)
             empty_blocks.append(&block);
         else if (block_was_full != block.is_full())
             full_blocks_that_became_usable.append(&block);
@@ -529,6 +878,11 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         block->cell_allocator().block_did_become_usable({}, *block);
     }
 
+    for (auto* block : blocks_that_became_unswept) {
+        dbgln_if(HEAP_DEBUG, " - HeapBlock left unswept @ {}: cell_size={}", block, block->cell_size());
+        block->cell_allocator().block_did_become_unswept({}, *block);
+    }
+
     if constexpr (HEAP_DEBUG) {
         for_each_block([&](auto& block) {
             dbgln(" > Live HeapBlock @ {}: cell_size={}", &block, block.cell_size());
@@ -536,7 +890,11 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         });
     }
 
-    m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+    m_allocated_bytes_since_last_gc = 0;
+    if (generation == Generation::All) {
+        m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+        m_promoted_bytes_since_last_major_gc = 0;
+    }
 
     if (print_report) {
         Duration const time_spent = measurement_timer.elapsed_time();
@@ -546,7 +904,7 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
             return IterationDecision::Continue;
         });
 
-        dbgln("Garbage collection report");
+        dbgln("{} report", generation == Generation::Young ? "Minor garbage collection"sv : "Garbage collection"sv);
         dbgln("=============================================");
         dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
         dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
@@ -569,7 +927,7 @@ void Heap::undefer_gc()
 
     if (!m_gc_deferrals) {
         if (m_should_gc_when_deferral_ends)
-            collect_garbage();
+            collect_garbage_after_allocation();
         m_should_gc_when_deferral_ends = false;
     }
 }
@@ -11,6 +11,7 @@
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -19,6 +20,7 @@
 #include <LibJS/Heap/CellAllocator.h>
 #include <LibJS/Heap/ConservativeVector.h>
 #include <LibJS/Heap/Handle.h>
+#include <LibJS/Heap/HeapBlock.h>
 #include <LibJS/Heap/HeapRoot.h>
 #include <LibJS/Heap/Internals.h>
 #include <LibJS/Heap/MarkedVector.h>
@@ -42,6 +44,7 @@ public:
         auto* memory = allocate_cell<T>();
         defer_gc();
         new (memory) T(forward<Args>(args)...);
+        did_construct_cell<T>(*memory);
         undefer_gc();
         return *static_cast<T*>(memory);
     }
@@ -52,6 +55,7 @@ public:
         auto* memory = allocate_cell<T>();
         defer_gc();
         new (memory) T(forward<Args>(args)...);
+        did_construct_cell<T>(*memory);
         undefer_gc();
         auto* cell = static_cast<T*>(memory);
         memory->initialize(realm);
@@ -63,9 +67,35 @@ public:
         CollectEverything,
     };
 
+    // Marks and sweeps the whole heap at once, finishing any incremental marking that's in progress first.
     void collect_garbage(CollectionType = CollectionType::CollectGarbage, bool print_report = false);
     AK::JsonObject dump_graph();
 
+    // Only collects the cells that were allocated since the last collection. Old cells are assumed to be live, and the
+    // only old cells that are scanned are the ones that were written to since then, or that don't have write barriers.
+    void collect_young_garbage();
+
+    // Major collections of the old cells mark incrementally, in steps that the mutator runs in between. Steps are run
+    // as cells are allocated, and an event loop can run more of them while it has nothing else to do.
+    bool is_marking_incrementally() const { return m_is_marking_incrementally; }
+    void start_incremental_marking();
+    void perform_incremental_marking_step(Duration budget);
+
+    // Destroys the dead cells that lazily swept allocators haven't gotten to yet, so that neither allocations nor the
+    // next collection have to.
+    void sweep_unswept_cells();
+
+    struct Statistics {
+        // Collections of the whole heap, whether they marked it all at once or incrementally.
+        size_t collections { 0 };
+        size_t minor_collections { 0 };
+        size_t incremental_marking_steps { 0 };
+        Duration last_pause;
+        Duration max_pause;
+        Duration total_pause;
+    };
+    Statistics const& statistics() const { return m_statistics; }
+
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
     void set_should_collect_on_every_allocation(bool b) { m_should_collect_on_every_allocation = b; }
 
@@ -86,10 +116,23 @@ public:
 
     void register_cell_allocator(Badge<CellAllocator>, CellAllocator&);
 
+    void remember_cell(Badge<Cell>, Cell&);
+
     void uproot_cell(Cell* cell);
 
+    // Calls the callback with every cell that the last collection did not find dead.
+    template<typename Callback>
+    void for_each_live_cell(Callback callback)
+    {
+        for_each_block([&](auto& block) {
+            block.template for_each_cell_in_state<Cell::State::Live>(callback);
+            return IterationDecision::Continue;
+        });
+    }
+
 private:
     friend class MarkingVisitor;
+    friend class ReachabilityVerifyingVisitor;
     friend class GraphConstructorVisitor;
     friend class DeferGC;
 
@@ -98,6 +141,23 @@ private:
 
     static bool cell_must_survive_garbage_collection(Cell const&);
 
+    template<typename T>
+    static constexpr bool has_write_barriers()
+    {
+        if constexpr (requires { typename T::CellClassWithWriteBarriers; })
+            return IsSame<typename T::CellClassWithWriteBarriers, T>;
+        return false;
+    }
+
+    template<typename T>
+    ALWAYS_INLINE void did_construct_cell(Cell& cell)
+    {
+        if constexpr (has_write_barriers<T>())
+            cell.m_has_write_barriers = true;
+        else
+            HeapBlock::from_cell(&cell)->set_has_cells_without_write_barriers(true);
+    }
+
     template<typename T>
     Cell* allocate_cell()
     {
@@ -112,13 +172,27 @@ private:
 
     void will_allocate(size_t);
 
+    enum class Generation {
+        Young,
+        All,
+    };
+
+    void collect_garbage_after_allocation();
+    void finish_incremental_marking();
+    void abandon_incremental_marking();
+
     void find_min_and_max_block_addresses(FlatPtr& min_address, FlatPtr& max_address);
     void gather_roots(HashMap<Cell*, HeapRoot>&);
     void gather_conservative_roots(HashMap<Cell*, HeapRoot>&);
     void gather_asan_fake_stack_roots(HashMap<FlatPtr, HeapRoot>&, FlatPtr, FlatPtr min_block_address, FlatPtr max_block_address);
     void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells);
-    void finalize_unmarked_cells();
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void mark_live_young_cells(HashMap<Cell*, HeapRoot> const& live_cells);
+    void clear_uprooted_cells(Generation);
+    void forget_remembered_cells();
+    void finalize_unmarked_cells(Generation);
+    void sweep_dead_cells(CollectionType, Generation, bool print_report, Core::ElapsedTimer const&);
+    void did_pause_for_garbage_collection(Duration);
+    void verify_no_unmarked_cells_are_reachable_from_marked_cells(Generation);
 
     ALWAYS_INLINE CellAllocator& allocator_for_size(size_t cell_size)
     {
@@ -142,8 +216,22 @@ private:
 
     static constexpr size_t GC_MIN_BYTES_THRESHOLD { 4 * 1024 * 1024 };
     size_t m_gc_bytes_threshold { GC_MIN_BYTES_THRESHOLD };
+
+    // Bytes allocated since the last collection, all of which are in young cells.
+    static constexpr size_t GC_NURSERY_BYTES { 2 * 1024 * 1024 };
     size_t m_allocated_bytes_since_last_gc { 0 };
 
+    // Bytes of cells that minor collections made old since the last major collection.
+    size_t m_promoted_bytes_since_last_major_gc { 0 };
+
+    static constexpr size_t GC_INCREMENTAL_MARKING_STEP_BYTES { 128 * 1024 };
+    static constexpr Duration GC_INCREMENTAL_MARKING_STEP_BUDGET = Duration::from_milliseconds(1);
+    size_t m_allocated_bytes_since_last_marking_step { 0 };
+    bool m_is_marking_incrementally { false };
+    Vector<NonnullGCPtr<Cell>> m_marking_work_queue;
+
+    Vector<NonnullGCPtr<Cell>> m_remembered_cells;
+
     bool m_should_collect_on_every_allocation { false };
 
     Vector<NonnullOwnPtr<CellAllocator>> m_size_based_cell_allocators;
@@ -160,6 +248,8 @@ private:
     bool m_should_gc_when_deferral_ends { false };
 
     bool m_collecting_garbage { false };
+
+    Statistics m_statistics;
 };
 
 inline void Heap::did_create_handle(Badge<HandleImpl>, HandleImpl& impl)
@@ -215,4 +305,13 @@ inline void Heap::register_cell_allocator(Badge<CellAllocator>, CellAllocator& a
     m_all_cell_allocators.append(allocator);
 }
 
+inline void Heap::remember_cell(Badge<Cell>, Cell& cell)
+{
+    // NOTE: Every cell that survives a collection is old, so it doesn't matter what's written during one.
+    if (m_collecting_garbage)
+        return;
+    cell.m_is_remembered = true;
+    m_remembered_cells.append(cell);
+}
+
 }
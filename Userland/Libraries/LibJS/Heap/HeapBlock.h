@@ -44,6 +44,7 @@ public:
 
         if (allocated_cell) {
             ASAN_UNPOISON_MEMORY_REGION(allocated_cell, m_cell_size);
+            m_has_young_cells = true;
         }
         return allocated_cell;
     }
@@ -92,6 +93,14 @@ public:
 
     CellAllocator& cell_allocator() { return m_cell_allocator; }
 
+    // Whether cells were allocated in this block since the last collection, so minor collections only sweep these.
+    bool has_young_cells() const { return m_has_young_cells; }
+    void set_has_young_cells(bool b) { m_has_young_cells = b; }
+
+    // Whether this block has cells without write barriers, which minor collections have to scan even when they're old.
+    bool has_cells_without_write_barriers() const { return m_has_cells_without_write_barriers; }
+    void set_has_cells_without_write_barriers(bool b) { m_has_cells_without_write_barriers = b; }
+
 private:
     HeapBlock(Heap&, CellAllocator&, size_t cell_size);
 
@@ -112,6 +121,8 @@ private:
     size_t m_cell_size { 0 };
     size_t m_next_lazy_freelist_index { 0 };
     GCPtr<FreelistEntry> m_freelist;
+    bool m_has_young_cells { false };
+    bool m_has_cells_without_write_barriers { false };
     alignas(__BIGGEST_ALIGNMENT__) u8 m_storage[];
 
 public:
@@ -0,0 +1,728 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Format.h>
+#include <AK/HashMap.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <LibJIT/Assembler.h>
+#include <LibJIT/GDB.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/CommonImplementations.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/Runtime/Object.h>
+#include <LibJS/Runtime/Shape.h>
+#include <LibJS/Runtime/ValueInlines.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+namespace JS::JIT {
+
+static constexpr u32 default_hotness_threshold = 1000;
+
+static Optional<bool> s_enabled;
+static Optional<u32> s_hotness_threshold;
+static Compiler::Statistics s_statistics;
+
+bool Compiler::is_enabled()
+{
+#ifdef JIT_ARCH_SUPPORTED
+    if (!s_enabled.has_value()) {
+        auto const* value = getenv("LIBJS_JIT");
+#    ifdef AK_OS_SERENITY
+        // Making memory executable needs the prot_exec promise, which most programs don't pledge.
+        s_enabled = value && StringView { value, strlen(value) } == "1"sv;
+#    else
+        s_enabled = !value || StringView { value, strlen(value) } != "0"sv;
+#    endif
+    }
+    return *s_enabled;
+#else
+    return false;
+#endif
+}
+
+void Compiler::set_enabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+u32 Compiler::hotness_threshold()
+{
+    if (!s_hotness_threshold.has_value()) {
+        auto const* value = getenv("LIBJS_JIT_THRESHOLD");
+        s_hotness_threshold = value ? StringView { value, strlen(value) }.to_number<u32>().value_or(default_hotness_threshold) : default_hotness_threshold;
+    }
+    return *s_hotness_threshold;
+}
+
+Compiler::Statistics& Compiler::statistics()
+{
+    return s_statistics;
+}
+
+void Compiler::dump_statistics()
+{
+    auto const& statistics = s_statistics;
+    warnln("JIT statistics:");
+    warnln("    Compiled executables: {} ({} refused)", statistics.compiled_executables, statistics.failed_executables);
+    warnln("    Machine code: {} bytes, compiled in {} ms", statistics.code_size, statistics.compile_time.to_milliseconds());
+    warnln("    Entries into machine code: {}", statistics.native_entries);
+    warnln("    Exits: {} to the interpreter, {} for exceptions, {} for returns", statistics.exits_to_interpreter, statistics.exits_for_exception, statistics.exits_for_return);
+}
+
+#ifdef JIT_ARCH_SUPPORTED
+
+using Assembler = ::JIT::Assembler;
+using ExitReason = NativeExecutable::ExitReason;
+
+namespace {
+
+// Machine code keeps these in callee-saved registers, so that they survive calls into C++.
+constexpr auto INTERPRETER = Assembler::Reg::R12;
+constexpr auto REGISTERS = Assembler::Reg::RBX;
+constexpr auto LOCALS = Assembler::Reg::R14;
+constexpr auto EXIT = Assembler::Reg::R15;
+
+constexpr auto ARG0 = Assembler::Reg::RDI;
+constexpr auto ARG1 = Assembler::Reg::RSI;
+constexpr auto ARG2 = Assembler::Reg::RDX;
+constexpr auto ARG3 = Assembler::Reg::RCX;
+constexpr auto ARG4 = Assembler::Reg::R8;
+constexpr auto RET = Assembler::Reg::RAX;
+
+constexpr auto GPR0 = Assembler::Reg::RAX;
+constexpr auto GPR1 = Assembler::Reg::RCX;
+constexpr auto GPR2 = Assembler::Reg::RDX;
+constexpr auto GPR3 = Assembler::Reg::RSI;
+
+// Runs an instruction the way the interpreter does. Returns 0 if the machine code can carry on with the next
+// instruction, or the reason for leaving it.
+template<typename OpType>
+u64 cxx_execute(Bytecode::Interpreter& interpreter, Bytecode::BasicBlock const& block, OpType const& instruction)
+{
+    interpreter.set_current_instruction(block, instruction);
+    auto result = instruction.execute_impl(interpreter);
+    if (result.is_error()) [[unlikely]] {
+        interpreter.reg(Bytecode::Register::exception()) = *result.throw_completion().value();
+        return to_underlying(ExitReason::Throw);
+    }
+    if (!interpreter.reg(Bytecode::Register::return_value()).is_empty()) [[unlikely]]
+        return to_underlying(ExitReason::Return);
+    return 0;
+}
+
+FlatPtr cxx_execute_for(Bytecode::Instruction::Type type)
+{
+#define __BYTECODE_OP(op)                \
+    case Bytecode::Instruction::Type::op: \
+        return bit_cast<FlatPtr>(&cxx_execute<Bytecode::Op::op>);
+
+    switch (type) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
+bool is_terminator(Bytecode::Instruction::Type type)
+{
+#define __BYTECODE_OP(op)                \
+    case Bytecode::Instruction::Type::op: \
+        return Bytecode::Op::op::IsTerminator;
+
+    switch (type) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
+u64 cxx_to_boolean(u64 encoded_value)
+{
+    return bit_cast<Value>(encoded_value).to_boolean();
+}
+
+// The cached halves of GetById and PutById. Both expect an object, and report a cache miss with an empty value or
+// false respectively, after which the machine code falls back to the whole instruction.
+u64 cxx_get_by_id_cached(u64 encoded_base, Bytecode::PropertyLookupCache& cache, DeprecatedFlyString const& property)
+{
+    auto& object = bit_cast<Value>(encoded_base).as_object();
+    return Bytecode::get_by_id_from_cache(object.vm(), object, property, cache).value_or(Value()).encoded();
+}
+
+u64 cxx_put_by_id_cached(u64 encoded_base, u64 encoded_value, Bytecode::PropertyLookupCache& cache, DeprecatedFlyString const& property)
+{
+    auto& object = bit_cast<Value>(encoded_base).as_object();
+    return Bytecode::put_by_id_to_cache(object.vm(), object, property, bit_cast<Value>(encoded_value), cache);
+}
+
+// Instructions that have a compile_<name>() function below, everything else calls into the interpreter.
+#define JS_ENUMERATE_OPS_WITH_NATIVE_CODE(O) \
+    O(Mov)                                   \
+    O(SetLocal)                              \
+    O(Jump)                                  \
+    O(JumpIf)                                \
+    O(JumpNullish)                           \
+    O(JumpUndefined)                         \
+    O(Return)                                \
+    O(Add)                                   \
+    O(Sub)                                   \
+    O(Mul)                                   \
+    O(BitwiseAnd)                            \
+    O(BitwiseOr)                             \
+    O(BitwiseXor)                            \
+    O(LessThan)                              \
+    O(LessThanEquals)                        \
+    O(GreaterThan)                           \
+    O(GreaterThanEquals)                     \
+    O(StrictlyEquals)                        \
+    O(StrictlyInequals)                      \
+    O(LooselyEquals)                         \
+    O(LooselyInequals)                       \
+    O(Increment)                             \
+    O(Decrement)                             \
+    O(Not)                                   \
+    O(GetById)                               \
+    O(PutById)
+
+class NativeCodeGenerator {
+public:
+    explicit NativeCodeGenerator(Bytecode::Executable& executable)
+        : m_executable(executable)
+    {
+        m_block_labels.resize(executable.basic_blocks.size());
+        for (size_t i = 0; i < executable.basic_blocks.size(); ++i)
+            m_block_indices.set(executable.basic_blocks[i].ptr(), i);
+    }
+
+    void generate()
+    {
+        // The entry point takes the interpreter, the registers, the locals, the exit record and the address to
+        // continue at, and keeps the first four in callee-saved registers.
+        m_assembler.enter();
+        m_assembler.mov(reg(INTERPRETER), reg(ARG0));
+        m_assembler.mov(reg(REGISTERS), reg(ARG1));
+        m_assembler.mov(reg(LOCALS), reg(ARG2));
+        m_assembler.mov(reg(EXIT), reg(ARG3));
+        m_assembler.jump(reg(ARG4));
+
+        for (size_t i = 0; i < m_executable.basic_blocks.size(); ++i) {
+            auto const& block = *m_executable.basic_blocks[i];
+            m_block_labels[i].link(m_assembler);
+            m_current_block = &block;
+
+            Bytecode::InstructionStreamIterator it(block.instruction_stream());
+            while (!it.at_end()) {
+                auto const& instruction = *it;
+                m_current_instruction = &instruction;
+                m_entry_points.set(bit_cast<FlatPtr>(&instruction), m_output.size());
+                compile_instruction(instruction);
+                ++it;
+            }
+        }
+
+        for (auto& exit : m_exits) {
+            exit.label.link(m_assembler);
+            m_assembler.mov(reg(GPR1), imm(bit_cast<FlatPtr>(exit.block)));
+            m_assembler.mov(mem(EXIT, __builtin_offsetof(NativeExecutable::Exit, block)), reg(GPR1));
+            m_assembler.mov(reg(GPR1), imm(bit_cast<FlatPtr>(exit.instruction)));
+            m_assembler.mov(mem(EXIT, __builtin_offsetof(NativeExecutable::Exit, instruction)), reg(GPR1));
+            if (exit.reason.has_value())
+                m_assembler.mov(reg(RET), imm(to_underlying(*exit.reason)));
+            m_assembler.mov(mem(EXIT, __builtin_offsetof(NativeExecutable::Exit, reason)), reg(RET));
+            m_assembler.jump(m_epilogue);
+        }
+
+        m_epilogue.link(m_assembler);
+        m_assembler.exit();
+    }
+
+    Vector<u8>& output() { return m_output; }
+    HashMap<FlatPtr, size_t>& entry_points() { return m_entry_points; }
+
+private:
+    struct PendingExit {
+        Assembler::Label label;
+        Bytecode::BasicBlock const* block { nullptr };
+        Bytecode::Instruction const* instruction { nullptr };
+
+        // Exits without a reason take it from the return value of a runtime call.
+        Optional<ExitReason> reason;
+    };
+
+    static Assembler::Operand reg(Assembler::Reg reg) { return Assembler::Operand::Register(reg); }
+    static Assembler::Operand imm(u64 value) { return Assembler::Operand::Imm(value); }
+    static Assembler::Operand mem(Assembler::Reg base, u64 offset) { return Assembler::Operand::Mem64BaseAndOffset(base, offset); }
+
+    Assembler::Label& block_label(Bytecode::Label const& label)
+    {
+        return m_block_labels[m_block_indices.get(&label.block()).value()];
+    }
+
+    Assembler::Label& exit_label(Optional<ExitReason> reason)
+    {
+        m_exits.append({ {}, m_current_block, m_current_instruction, reason });
+        return m_exits.last().label;
+    }
+
+    void load(Assembler::Reg dst, Bytecode::Operand operand)
+    {
+        switch (operand.type()) {
+        case Bytecode::Operand::Type::Register:
+            m_assembler.mov(reg(dst), mem(REGISTERS, operand.index() * sizeof(Value)));
+            return;
+        case Bytecode::Operand::Type::Local:
+            m_assembler.mov(reg(dst), mem(LOCALS, operand.index() * sizeof(Value)));
+            return;
+        case Bytecode::Operand::Type::Constant:
+            m_assembler.mov(reg(dst), imm(m_executable.constants[operand.index()].encoded()));
+            return;
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    void store(Bytecode::Operand operand, Assembler::Reg src)
+    {
+        switch (operand.type()) {
+        case Bytecode::Operand::Type::Register:
+            m_assembler.mov(mem(REGISTERS, operand.index() * sizeof(Value)), reg(src));
+            return;
+        case Bytecode::Operand::Type::Local:
+            m_assembler.mov(mem(LOCALS, operand.index() * sizeof(Value)), reg(src));
+            return;
+        case Bytecode::Operand::Type::Constant:
+            VERIFY_NOT_REACHED();
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    // Leaves the tag of the value in `value` in `tag`.
+    void extract_tag(Assembler::Reg tag, Assembler::Reg value)
+    {
+        m_assembler.mov(reg(tag), reg(value));
+        m_assembler.shift_right(reg(tag), imm(TAG_SHIFT));
+    }
+
+    void jump_if_not_tagged(Assembler::Reg value, u64 tag, Assembler::Reg scratch, Assembler::Label& label)
+    {
+        extract_tag(scratch, value);
+        m_assembler.jump_if(reg(scratch), Assembler::Condition::NotEqualTo, imm(tag), label);
+    }
+
+    void call(FlatPtr callee)
+    {
+        m_assembler.native_call(callee);
+    }
+
+    // Runs the current instruction through the interpreter's implementation, and leaves the machine code if it threw
+    // or returned.
+    void call_interpreter()
+    {
+        m_assembler.mov(reg(ARG0), reg(INTERPRETER));
+        m_assembler.mov(reg(ARG1), imm(bit_cast<FlatPtr>(m_current_block)));
+        m_assembler.mov(reg(ARG2), imm(bit_cast<FlatPtr>(m_current_instruction)));
+        call(cxx_execute_for(m_current_instruction->type()));
+
+        if (is_terminator(m_current_instruction->type())) {
+            // There is nothing to carry on with, so this always leaves the block as if the instruction returned.
+            m_assembler.mov(reg(GPR1), imm(to_underlying(ExitReason::Return)));
+            m_assembler.test(reg(RET), reg(RET));
+            m_assembler.mov_if(Assembler::Condition::EqualTo, reg(RET), reg(GPR1));
+            m_assembler.jump(exit_label({}));
+            return;
+        }
+
+        m_assembler.test(reg(RET), reg(RET));
+        m_assembler.jump_if(Assembler::Condition::NotEqualTo, exit_label({}));
+    }
+
+    // Emits the fast path, and the call into the interpreter for when the fast path jumps to the slow path label.
+    template<typename Callback>
+    void with_slow_path(Callback fast_path)
+    {
+        Assembler::Label slow_path {};
+        Assembler::Label done {};
+        fast_path(slow_path);
+        m_assembler.jump(done);
+        slow_path.link(m_assembler);
+        call_interpreter();
+        done.link(m_assembler);
+    }
+
+    void compile_instruction(Bytecode::Instruction const& instruction)
+    {
+#define __CASE(op)                                                       \
+    case Bytecode::Instruction::Type::op:                                \
+        compile_##op(static_cast<Bytecode::Op::op const&>(instruction)); \
+        return;
+
+        switch (instruction.type()) {
+            JS_ENUMERATE_OPS_WITH_NATIVE_CODE(__CASE)
+        case Bytecode::Instruction::Type::End:
+        case Bytecode::Instruction::Type::EnterUnwindContext:
+        case Bytecode::Instruction::Type::ContinuePendingUnwind:
+        case Bytecode::Instruction::Type::ScheduleJump:
+            // These change the unwind state that the interpreter keeps, so the interpreter runs them.
+            m_assembler.jump(exit_label(ExitReason::Interpret));
+            return;
+        default:
+            call_interpreter();
+            return;
+        }
+
+#undef __CASE
+    }
+
+    void compile_Mov(Bytecode::Op::Mov const& op)
+    {
+        load(GPR0, op.src());
+        store(op.dst(), GPR0);
+    }
+
+    void compile_SetLocal(Bytecode::Op::SetLocal const& op)
+    {
+        load(GPR0, op.src());
+        store(op.dst(), GPR0);
+    }
+
+    void compile_Jump(Bytecode::Op::Jump const& op)
+    {
+        m_assembler.jump(block_label(*op.true_target()));
+    }
+
+    void compile_JumpIf(Bytecode::Op::JumpIf const& op)
+    {
+        Assembler::Label not_boolean {};
+        Assembler::Label not_int32 {};
+
+        load(GPR0, op.condition());
+        extract_tag(GPR1, GPR0);
+
+        m_assembler.jump_if(reg(GPR1), Assembler::Condition::NotEqualTo, imm(BOOLEAN_TAG), not_boolean);
+        m_assembler.test(reg(GPR0), imm(1));
+        m_assembler.jump_if(Assembler::Condition::NotEqualTo, block_label(*op.true_target()));
+        m_assembler.jump(block_label(*op.false_target()));
+
+        not_boolean.link(m_assembler);
+        m_assembler.jump_if(reg(GPR1), Assembler::Condition::NotEqualTo, imm(INT32_TAG), not_int32);
+        m_assembler.mov32(reg(GPR0), reg(GPR0));
+        m_assembler.test(reg(GPR0), reg(GPR0));
+        m_assembler.jump_if(Assembler::Condition::NotEqualTo, block_label(*op.true_target()));
+        m_assembler.jump(block_label(*op.false_target()));
+
+        not_int32.link(m_assembler);
+        m_assembler.mov(reg(ARG0), reg(GPR0));
+        call(bit_cast<FlatPtr>(&cxx_to_boolean));
+        m_assembler.test(reg(RET), reg(RET));
+        m_assembler.jump_if(Assembler::Condition::NotEqualTo, block_label(*op.true_target()));
+        m_assembler.jump(block_label(*op.false_target()));
+    }
+
+    void compile_JumpNullish(Bytecode::Op::JumpNullish const& op)
+    {
+        load(GPR0, op.condition());
+        extract_tag(GPR0, GPR0);
+        m_assembler.bitwise_and(reg(GPR0), imm(IS_NULLISH_EXTRACT_PATTERN));
+        m_assembler.jump_if(reg(GPR0), Assembler::Condition::EqualTo, imm(IS_NULLISH_PATTERN), block_label(*op.true_target()));
+        m_assembler.jump(block_label(*op.false_target()));
+    }
+
+    void compile_JumpUndefined(Bytecode::Op::JumpUndefined const& op)
+    {
+        load(GPR0, op.condition());
+        extract_tag(GPR0, GPR0);
+        m_assembler.jump_if(reg(GPR0), Assembler::Condition::EqualTo, imm(UNDEFINED_TAG), block_label(*op.true_target()));
+        m_assembler.jump(block_label(*op.false_target()));
+    }
+
+    void compile_Return(Bytecode::Op::Return const& op)
+    {
+        if (op.value().has_value())
+            load(GPR0, *op.value());
+        else
+            m_assembler.mov(reg(GPR0), imm(js_undefined().encoded()));
+        store(Bytecode::Operand(Bytecode::Register::return_value()), GPR0);
+        m_assembler.mov(reg(GPR0), imm(Value().encoded()));
+        store(Bytecode::Operand(Bytecode::Register::exception()), GPR0);
+        m_assembler.jump(exit_label(ExitReason::Return));
+    }
+
+    // Loads both operands of a binary instruction into GPR0 and GPR1, and jumps to the slow path unless both are Int32.
+    template<typename OpType>
+    void load_int32_operands(OpType const& op, Assembler::Label& slow_path)
+    {
+        load(GPR0, op.lhs());
+        load(GPR1, op.rhs());
+        jump_if_not_tagged(GPR0, INT32_TAG, GPR2, slow_path);
+        jump_if_not_tagged(GPR1, INT32_TAG, GPR2, slow_path);
+    }
+
+    void store_int32(Bytecode::Operand dst, Assembler::Reg value)
+    {
+        // 32-bit operations clear the upper half of the register, so the tag only has to be put back.
+        m_assembler.mov(reg(GPR2), imm(SHIFTED_INT32_TAG));
+        m_assembler.bitwise_or(reg(value), reg(GPR2));
+        store(dst, value);
+    }
+
+    void store_boolean_if(Assembler::Condition condition, Bytecode::Operand dst)
+    {
+        // Moving the tag leaves the flags alone, and its lowest byte is zero.
+        m_assembler.mov(reg(GPR0), imm(SHIFTED_BOOLEAN_TAG));
+        m_assembler.set_if(condition, reg(GPR0));
+        store(dst, GPR0);
+    }
+
+    void compile_Add(Bytecode::Op::Add const& op)
+    {
+        with_slow_path([&](auto& slow_path) {
+            load_int32_operands(op, slow_path);
+            m_assembler.add32(reg(GPR0), reg(GPR1), slow_path);
+            store_int32(op.dst(), GPR0);
+        });
+    }
+
+    void compile_Sub(Bytecode::Op::Sub const& op)
+    {
+        with_slow_path([&](auto& slow_path) {
+            load_int32_operands(op, slow_path);
+            m_assembler.sub32(reg(GPR0), reg(GPR1), slow_path);
+            store_int32(op.dst(), GPR0);
+        });
+    }
+
+    void compile_Mul(Bytecode::Op::Mul const& op)
+    {
+        with_slow_path([&](auto& slow_path) {
+            load_int32_operands(op, slow_path);
+            m_assembler.mul32(reg(GPR0), reg(GPR1), slow_path);
+            store_int32(op.dst(), GPR0);
+        });
+    }
+
+    void compile_BitwiseAnd(Bytecode::Op::BitwiseAnd const& op)
+    {
+        // Both tags are the same, so they survive the operation.
+        with_slow_path([&](auto& slow_path) {
+            load_int32_operands(op, slow_path);
+            m_assembler.bitwise_and(reg(GPR0), reg(GPR1));
+            store(op.dst(), GPR0);
+        });
+    }
+
+    void compile_BitwiseOr(Bytecode::Op::BitwiseOr const& op)
+    {
+        with_slow_path([&](auto& slow_path) {
+            load_int32_operands(op, slow_path);
+            m_assembler.bitwise_or(reg(GPR0), reg(GPR1));
+            store(op.dst(), GPR0);
+        });
+    }
+
+    void compile_BitwiseXor(Bytecode::Op::BitwiseXor const& op)
+    {
+        with_slow_path([&](auto& slow_path) {
+            load_int32_operands(op, slow_path);
+            m_assembler.bitwise_xor32(reg(GPR0), reg(GPR1));
+            store_int32(op.dst(), GPR0);
+        });
+    }
+
+    template<typename OpType>
+    void compile_int32_comparison(OpType const& op, Assembler::Condition condition)
+    {
+        with_slow_path([&](auto& slow_path) {
+            load_int32_operands(op, slow_path);
+            m_assembler.sign_extend_32_to_64_bits(GPR0);
+            m_assembler.sign_extend_32_to_64_bits(GPR1);
+            m_assembler.cmp(reg(GPR0), reg(GPR1));
+            store_boolean_if(condition, op.dst());
+        });
+    }
+
+    void compile_LessThan(Bytecode::Op::LessThan const& op) { compile_int32_comparison(op, Assembler::Condition::SignedLessThan); }
+    void compile_LessThanEquals(Bytecode::Op::LessThanEquals const& op) { compile_int32_comparison(op, Assembler::Condition::SignedLessThanOrEqualTo); }
+    void compile_GreaterThan(Bytecode::Op::GreaterThan const& op) { compile_int32_comparison(op, Assembler::Condition::SignedGreaterThan); }
+    void compile_GreaterThanEquals(Bytecode::Op::GreaterThanEquals const& op) { compile_int32_comparison(op, Assembler::Condition::SignedGreaterThanOrEqualTo); }
+
+    // For Int32, Boolean and Object values of the same type, strict and loose equality both come down to comparing
+    // the encoded values.
+    template<typename OpType>
+    void compile_equality(OpType const& op, Assembler::Condition condition)
+    {
+        with_slow_path([&](auto& slow_path) {
+            Assembler::Label same_type_with_identity {};
+
+            load(GPR0, op.lhs());
+            load(GPR1, op.rhs());
+            extract_tag(GPR2, GPR0);
+            extract_tag(GPR3, GPR1);
+            m_assembler.jump_if(reg(GPR2), Assembler::Condition::NotEqualTo, reg(GPR3), slow_path);
+            m_assembler.jump_if(reg(GPR2), Assembler::Condition::EqualTo, imm(INT32_TAG), same_type_with_identity);
+            m_assembler.jump_if(reg(GPR2), Assembler::Condition::EqualTo, imm(BOOLEAN_TAG), same_type_with_identity);
+            m_assembler.jump_if(reg(GPR2), Assembler::Condition::NotEqualTo, imm(OBJECT_TAG), slow_path);
+
+            same_type_with_identity.link(m_assembler);
+            m_assembler.cmp(reg(GPR0), reg(GPR1));
+            store_boolean_if(condition, op.dst());
+        });
+    }
+
+    void compile_StrictlyEquals(Bytecode::Op::StrictlyEquals const& op) { compile_equality(op, Assembler::Condition::EqualTo); }
+    void compile_StrictlyInequals(Bytecode::Op::StrictlyInequals const& op) { compile_equality(op, Assembler::Condition::NotEqualTo); }
+    void compile_LooselyEquals(Bytecode::Op::LooselyEquals const& op) { compile_equality(op, Assembler::Condition::EqualTo); }
+    void compile_LooselyInequals(Bytecode::Op::LooselyInequals const& op) { compile_equality(op, Assembler::Condition::NotEqualTo); }
+
+    void compile_Increment(Bytecode::Op::Increment const& op)
+    {
+        with_slow_path([&](auto& slow_path) {
+            load(GPR0, op.dst());
+            jump_if_not_tagged(GPR0, INT32_TAG, GPR1, slow_path);
+            m_assembler.add32(reg(GPR0), imm(1), slow_path);
+            store_int32(op.dst(), GPR0);
+        });
+    }
+
+    void compile_Decrement(Bytecode::Op::Decrement const& op)
+    {
+        with_slow_path([&](auto& slow_path) {
+            load(GPR0, op.dst());
+            jump_if_not_tagged(GPR0, INT32_TAG, GPR1, slow_path);
+            m_assembler.sub32(reg(GPR0), imm(1), slow_path);
+            store_int32(op.dst(), GPR0);
+        });
+    }
+
+    void compile_Not(Bytecode::Op::Not const& op)
+    {
+        with_slow_path([&](auto& slow_path) {
+            load(GPR0, op.src());
+            jump_if_not_tagged(GPR0, BOOLEAN_TAG, GPR1, slow_path);
+            m_assembler.bitwise_xor32(reg(GPR0), imm(1));
+            m_assembler.mov(reg(GPR1), imm(SHIFTED_BOOLEAN_TAG));
+            m_assembler.bitwise_or(reg(GPR0), reg(GPR1));
+            store(op.dst(), GPR0);
+        });
+    }
+
+    void compile_GetById(Bytecode::Op::GetById const& op)
+    {
+        // Arrays answer "length" without looking at their shape, so the interpreter has to take care of it.
+        if (m_executable.get_identifier(op.property()) == "length"sv) {
+            call_interpreter();
+            return;
+        }
+
+        with_slow_path([&](auto& slow_path) {
+            load(ARG0, op.base());
+            jump_if_not_tagged(ARG0, OBJECT_TAG, GPR1, slow_path);
+            m_assembler.mov(reg(ARG1), imm(bit_cast<FlatPtr>(&m_executable.property_lookup_caches[op.cache_index()])));
+            m_assembler.mov(reg(ARG2), imm(bit_cast<FlatPtr>(&m_executable.get_identifier(op.property()))));
+            call(bit_cast<FlatPtr>(&cxx_get_by_id_cached));
+            m_assembler.mov(reg(GPR1), imm(Value().encoded()));
+            m_assembler.jump_if(reg(RET), Assembler::Condition::EqualTo, reg(GPR1), slow_path);
+            store(op.dst(), RET);
+        });
+    }
+
+    void compile_PutById(Bytecode::Op::PutById const& op)
+    {
+        if (op.kind() != Bytecode::Op::PropertyKind::KeyValue) {
+            call_interpreter();
+            return;
+        }
+
+        with_slow_path([&](auto& slow_path) {
+            load(ARG0, op.base());
+            jump_if_not_tagged(ARG0, OBJECT_TAG, GPR1, slow_path);
+            load(ARG1, op.src());
+            m_assembler.mov(reg(ARG2), imm(bit_cast<FlatPtr>(&m_executable.property_lookup_caches[op.cache_index()])));
+            m_assembler.mov(reg(ARG3), imm(bit_cast<FlatPtr>(&m_executable.get_identifier(op.property()))));
+            call(bit_cast<FlatPtr>(&cxx_put_by_id_cached));
+            m_assembler.test(reg(RET), reg(RET));
+            m_assembler.jump_if(Assembler::Condition::EqualTo, slow_path);
+        });
+    }
+
+    Bytecode::Executable& m_executable;
+    Vector<u8> m_output;
+    Assembler m_assembler { m_output };
+
+    Vector<Assembler::Label> m_block_labels;
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_indices;
+    HashMap<FlatPtr, size_t> m_entry_points;
+    Vector<PendingExit> m_exits;
+    Assembler::Label m_epilogue {};
+
+    Bytecode::BasicBlock const* m_current_block { nullptr };
+    Bytecode::Instruction const* m_current_instruction { nullptr };
+};
+
+}
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable& executable)
+{
+    if (!is_enabled())
+        return nullptr;
+
+    // The code generator relies on every block ending in a jump, return or other terminator.
+    for (auto const& block : executable.basic_blocks) {
+        if (!block->is_terminated()) {
+            ++s_statistics.failed_executables;
+            return nullptr;
+        }
+    }
+
+    auto compile_start = MonotonicTime::now();
+
+    NativeCodeGenerator generator { executable };
+    generator.generate();
+    auto& output = generator.output();
+
+    auto* code = mmap(nullptr, output.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        dbgln_if(JIT_DEBUG, "JIT: Failed to mmap {} bytes of code: {}", output.size(), strerror(errno));
+        ++s_statistics.failed_executables;
+        return nullptr;
+    }
+    memcpy(code, output.data(), output.size());
+    if (mprotect(code, output.size(), PROT_READ | PROT_EXEC) < 0) {
+        dbgln_if(JIT_DEBUG, "JIT: Failed to make code executable: {}", strerror(errno));
+        munmap(code, output.size());
+        ++s_statistics.failed_executables;
+        return nullptr;
+    }
+
+    auto gdb_object = ::JIT::GDB::build_gdb_image({ code, output.size() }, "LibJS JIT"sv, executable.name.view());
+    auto native_executable = make<NativeExecutable>(code, output.size(), move(generator.entry_points()), move(gdb_object));
+
+    ++s_statistics.compiled_executables;
+    s_statistics.code_size += output.size();
+    s_statistics.compile_time += MonotonicTime::now() - compile_start;
+    return native_executable;
+}
+
+#else
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable&)
+{
+    return nullptr;
+}
+
+#endif
+
+}
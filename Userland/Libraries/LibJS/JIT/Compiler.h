@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/OwnPtr.h>
+#include <AK/Time.h>
+#include <LibJS/Forward.h>
+#include <LibJS/JIT/NativeExecutable.h>
+
+namespace JS::JIT {
+
+// Translates bytecode executables into machine code, one instruction at a time. Common cases of the simplest
+// instructions are done inline, and everything else calls the same code the interpreter would run.
+class Compiler {
+public:
+    static OwnPtr<NativeExecutable> compile(Bytecode::Executable&);
+
+    // The JIT can be turned off with LIBJS_JIT=0 in the environment (or on with LIBJS_JIT=1 on SerenityOS), and the
+    // number of times the interpreter enters a block of an executable before it gets compiled can be set with
+    // LIBJS_JIT_THRESHOLD.
+    static bool is_enabled();
+    static void set_enabled(bool);
+    static u32 hotness_threshold();
+
+    struct Statistics {
+        size_t compiled_executables { 0 };
+        size_t failed_executables { 0 };
+        size_t code_size { 0 };
+        Duration compile_time;
+        size_t native_entries { 0 };
+        size_t exits_to_interpreter { 0 };
+        size_t exits_for_exception { 0 };
+        size_t exits_for_return { 0 };
+    };
+    static Statistics& statistics();
+    static void dump_statistics();
+};
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJIT/GDB.h>
+#include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <sys/mman.h>
+
+namespace JS::JIT {
+
+NativeExecutable::NativeExecutable(void* code, size_t size, HashMap<FlatPtr, size_t> entry_points, Optional<FixedArray<u8>> gdb_object)
+    : m_code(code)
+    , m_size(size)
+    , m_entry_points(move(entry_points))
+    , m_gdb_object(move(gdb_object))
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::register_into_gdb(m_gdb_object.value().span());
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::unregister_from_gdb(m_gdb_object.value().span());
+    munmap(m_code, m_size);
+}
+
+NativeExecutable::Exit NativeExecutable::run(Bytecode::Interpreter& interpreter, Bytecode::BasicBlock const& block, size_t offset) const
+{
+    using EntryFunction = void (*)(Bytecode::Interpreter*, Value* registers, Value* locals, Exit*, u8 const* entry);
+
+    auto entry_offset = m_entry_points.get(bit_cast<FlatPtr>(block.data() + offset));
+    VERIFY(entry_offset.has_value());
+
+    auto& context = interpreter.vm().running_execution_context();
+    Exit exit;
+    bit_cast<EntryFunction>(m_code)(&interpreter, context.registers.data(), context.locals.data(), &exit, static_cast<u8 const*>(m_code) + *entry_offset);
+
+    auto& statistics = Compiler::statistics();
+    ++statistics.native_entries;
+    switch (exit.reason) {
+    case ExitReason::Throw:
+        ++statistics.exits_for_exception;
+        break;
+    case ExitReason::Return:
+        ++statistics.exits_for_return;
+        break;
+    case ExitReason::Interpret:
+        ++statistics.exits_to_interpreter;
+        break;
+    }
+    return exit;
+}
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/FixedArray.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/Types.h>
+#include <LibJS/Forward.h>
+
+namespace JS::JIT {
+
+// Machine code for a Bytecode::Executable. It can be entered at any instruction and runs until it reaches something
+// that only the interpreter can do, which it then hands back to the interpreter.
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    // Native code returns 0 from runtime calls to keep going, or one of these to leave.
+    enum class ExitReason : u64 {
+        // The instruction threw, and the exception is in the exception register.
+        Throw = 1,
+
+        // The instruction set the return value (or yielded), so the interpreter has to leave the block.
+        Return,
+
+        // The instruction has not run yet, and has to be run by the interpreter.
+        Interpret,
+    };
+
+    struct Exit {
+        Bytecode::BasicBlock const* block { nullptr };
+        u8 const* instruction { nullptr };
+        ExitReason reason { ExitReason::Interpret };
+    };
+
+    NativeExecutable(void* code, size_t size, HashMap<FlatPtr, size_t> entry_points, Optional<FixedArray<u8>> gdb_object);
+    ~NativeExecutable();
+
+    // Runs the native code from the instruction at the given offset into the block.
+    Exit run(Bytecode::Interpreter&, Bytecode::BasicBlock const&, size_t offset) const;
+
+    size_t size() const { return m_size; }
+
+private:
+    void* m_code { nullptr };
+    size_t m_size { 0 };
+
+    // The offset into the code for every instruction, keyed by the instruction's address.
+    HashMap<FlatPtr, size_t> m_entry_points;
+
+    Optional<FixedArray<u8>> m_gdb_object;
+};
+
+}
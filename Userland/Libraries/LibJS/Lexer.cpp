@@ -16,7 +16,55 @@
 
 namespace JS {
 
-HashMap<DeprecatedFlyString, TokenType> Lexer::s_keywords;
+// NOTE: This is a function-local static so that lexers running on different threads initialize it only once.
+static HashMap<DeprecatedFlyString, TokenType> const& keywords()
+{
+    static auto const keywords = [] {
+        HashMap<DeprecatedFlyString, TokenType> keywords;
+        keywords.set("async", TokenType::Async);
+        keywords.set("await", TokenType::Await);
+        keywords.set("break", TokenType::Break);
+        keywords.set("case", TokenType::Case);
+        keywords.set("catch", TokenType::Catch);
+        keywords.set("class", TokenType::Class);
+        keywords.set("const", TokenType::Const);
+        keywords.set("continue", TokenType::Continue);
+        keywords.set("debugger", TokenType::Debugger);
+        keywords.set("default", TokenType::Default);
+        keywords.set("delete", TokenType::Delete);
+        keywords.set("do", TokenType::Do);
+        keywords.set("else", TokenType::Else);
+        keywords.set("enum", TokenType::Enum);
+        keywords.set("export", TokenType::Export);
+        keywords.set("extends", TokenType::Extends);
+        keywords.set("false", TokenType::BoolLiteral);
+        keywords.set("finally", TokenType::Finally);
+        keywords.set("for", TokenType::For);
+        keywords.set("function", TokenType::Function);
+        keywords.set("if", TokenType::If);
+        keywords.set("import", TokenType::Import);
+        keywords.set("in", TokenType::In);
+        keywords.set("instanceof", TokenType::Instanceof);
+        keywords.set("let", TokenType::Let);
+        keywords.set("new", TokenType::New);
+        keywords.set("null", TokenType::NullLiteral);
+        keywords.set("return", TokenType::Return);
+        keywords.set("super", TokenType::Super);
+        keywords.set("switch", TokenType::Switch);
+        keywords.set("this", TokenType::This);
+        keywords.set("throw", TokenType::Throw);
+        keywords.set("true", TokenType::BoolLiteral);
+        keywords.set("try", TokenType::Try);
+        keywords.set("typeof", TokenType::Typeof);
+        keywords.set("var", TokenType::Var);
+        keywords.set("void", TokenType::Void);
+        keywords.set("while", TokenType::While);
+        keywords.set("with", TokenType::With);
+        keywords.set("yield", TokenType::Yield);
+        return keywords;
+    }();
+    return keywords;
+}
 
 static constexpr TokenType parse_two_char_token(StringView view)
 {
@@ -133,52 +181,34 @@ Lexer::Lexer(StringView source, StringView filename, size_t line_number, size_t
     , m_line_column(line_column)
     , m_parsed_identifiers(adopt_ref(*new ParsedIdentifiers))
 {
-    if (s_keywords.is_empty()) {
-        s_keywords.set("async", TokenType::Async);
-        s_keywords.set("await", TokenType::Await);
-        s_keywords.set("break", TokenType::Break);
-        s_keywords.set("case", TokenType::Case);
-        s_keywords.set("catch", TokenType::Catch);
-        s_keywords.set("class", TokenType::Class);
-        s_keywords.set("const", TokenType::Const);
-        s_keywords.set("continue", TokenType::Continue);
-        s_keywords.set("debugger", TokenType::Debugger);
-        s_keywords.set("default", TokenType::Default);
-        s_keywords.set("delete", TokenType::Delete);
-        s_keywords.set("do", TokenType::Do);
-        s_keywords.set("else", TokenType::Else);
-        s_keywords.set("enum", TokenType::Enum);
-        s_keywords.set("export", TokenType::Export);
-        s_keywords.set("extends", TokenType::Extends);
-        s_keywords.set("false", TokenType::BoolLiteral);
-        s_keywords.set("finally", TokenType::Finally);
-        s_keywords.set("for", TokenType::For);
-        s_keywords.set("function", TokenType::Function);
-        s_keywords.set("if", TokenType::If);
-        s_keywords.set("import", TokenType::Import);
-        s_keywords.set("in", TokenType::In);
-        s_keywords.set("instanceof", TokenType::Instanceof);
-        s_keywords.set("let", TokenType::Let);
-        s_keywords.set("new", TokenType::New);
-        s_keywords.set("null", TokenType::NullLiteral);
-        s_keywords.set("return", TokenType::Return);
-        s_keywords.set("super", TokenType::Super);
-        s_keywords.set("switch", TokenType::Switch);
-        s_keywords.set("this", TokenType::This);
-        s_keywords.set("throw", TokenType::Throw);
-        s_keywords.set("true", TokenType::BoolLiteral);
-        s_keywords.set("try", TokenType::Try);
-        s_keywords.set("typeof", TokenType::Typeof);
-        s_keywords.set("var", TokenType::Var);
-        s_keywords.set("void", TokenType::Void);
-        s_keywords.set("while", TokenType::While);
-        s_keywords.set("with", TokenType::With);
-        s_keywords.set("yield", TokenType::Yield);
-    }
+    consume();
+}
 
+Lexer::Lexer(ByteString source, StringView filename, Position start)
+    : Lexer(StringView {}, filename)
+{
+    m_source = move(source);
+    seek(start);
+}
+
+void Lexer::seek(Position position)
+{
+    VERIFY(position.offset <= m_source.length());
+    m_eof = false;
+    m_position = position.offset;
+    m_line_number = position.line;
+    m_line_column = position.column - 1;
+    m_current_char = 0;
     consume();
 }
 
+void Lexer::skip_past_closing_curly(Position position)
+{
+    VERIFY(m_source[position.offset] == '}');
+    m_current_token = Token(TokenType::CurlyClose, {}, {}, m_source.substring_view(position.offset, 1), m_filename, position.line, position.column, position.offset);
+    seek({ position.line, position.column + 1, position.offset + 1 });
+}
+
 void Lexer::consume()
 {
     auto did_reach_eof = [this] {
@@ -702,8 +732,8 @@ Token Lexer::next()
         identifier = builder.string_view();
         m_parsed_identifiers->identifiers.set(*identifier);
 
-        auto it = s_keywords.find(identifier->hash(), [&](auto& entry) { return entry.key == identifier; });
-        if (it == s_keywords.end())
+        auto it = keywords().find(identifier->hash(), [&](auto& entry) { return entry.key == identifier; });
+        if (it == keywords().end())
             token_type = TokenType::Identifier;
         else
             token_type = has_escaped_character ? TokenType::EscapedKeyword : it->value;
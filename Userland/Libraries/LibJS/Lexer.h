@@ -12,6 +12,7 @@
 #include <AK/HashMap.h>
 #include <AK/String.h>
 #include <AK/StringView.h>
+#include <LibJS/Position.h>
 
 namespace JS {
 
@@ -19,6 +20,9 @@ class Lexer {
 public:
     explicit Lexer(StringView source, StringView filename = "(unknown)"sv, size_t line_number = 1, size_t line_column = 0);
 
+    // Starts lexing at the given position in the source, which has to be where a token starts.
+    Lexer(ByteString source, StringView filename, Position start);
+
     Token next();
 
     ByteString const& source() const { return m_source; }
@@ -28,7 +32,12 @@ public:
 
     Token force_slash_as_regex();
 
+    // Continues right after the '}' at the given position, as if everything up to and including it had been lexed.
+    // There have to be as many '{' as '}' in between, like in the rest of a function after its name.
+    void skip_past_closing_curly(Position);
+
 private:
+    void seek(Position);
     void consume();
     bool consume_exponent();
     bool consume_octal_number();
@@ -80,8 +89,6 @@ private:
 
     Optional<size_t> m_hit_invalid_unicode;
 
-    static HashMap<DeprecatedFlyString, TokenType> s_keywords;
-
     struct ParsedIdentifiers : public RefCounted<ParsedIdentifiers> {
         // Resolved identifiers must be kept alive for the duration of the parsing stage, otherwise
         // the only references to these strings are deleted by the Token destructor.
@@ -46,6 +46,7 @@ public:
         ClassStaticInit,
         ClassField,
         ClassDeclaration,
+        PreparsedFunctionParent,
     };
 
 private:
@@ -55,7 +56,7 @@ private:
         , m_type(type)
     {
         m_parent_scope = exchange(m_parser.m_state.current_scope_pusher, this);
-        if (type != ScopeType::Function) {
+        if (type != ScopeType::Function && type != ScopeType::PreparsedFunctionParent) {
             VERIFY(node || (m_parent_scope && scope_level == ScopeLevel::NotTopLevel));
             if (!node)
                 m_node = m_parent_scope->m_node;
@@ -75,12 +76,22 @@ private:
     }
 
 public:
-    static ScopePusher function_scope(Parser& parser, RefPtr<Identifier const> function_name = nullptr)
+    static ScopePusher function_scope(Parser& parser, RefPtr<Identifier const> function_name = nullptr, PreparsedFunctionData* preparsed_function = nullptr)
     {
         ScopePusher scope_pusher(parser, nullptr, ScopeLevel::FunctionTopLevel, ScopeType::Function);
         if (function_name) {
             scope_pusher.m_bound_names.set(function_name->string());
         }
+        scope_pusher.m_preparsed_function = preparsed_function;
+        return scope_pusher;
+    }
+
+    // Stands in for the scopes around a preparsed function while parsing it again, so that the identifiers which are not
+    // declared inside of it end up the way parsing the whole program left them.
+    static ScopePusher preparsed_function_parent_scope(Parser& parser, PreparsedFunctionData const& preparsed_function)
+    {
+        ScopePusher scope_pusher(parser, nullptr, ScopeLevel::FunctionTopLevel, ScopeType::PreparsedFunctionParent);
+        scope_pusher.m_function_parsed_again = &preparsed_function;
         return scope_pusher;
     }
 
@@ -270,6 +281,18 @@ public:
     {
         VERIFY(is_top_level() || m_parent_scope);
 
+        if (m_type == ScopeType::PreparsedFunctionParent) {
+            for (auto& it : m_identifier_groups) {
+                auto free_identifier = m_function_parsed_again->free_identifiers.get(it.key);
+                if (!free_identifier.has_value() || !free_identifier->identifier->is_global())
+                    continue;
+                for (auto& identifier : it.value.identifiers)
+                    identifier->set_is_global();
+            }
+            m_parser.m_state.current_scope_pusher = m_parent_scope;
+            return;
+        }
+
         if (m_parent_scope && !m_function_parameters.has_value()) {
             m_parent_scope->m_contains_access_to_arguments_object |= m_contains_access_to_arguments_object;
             m_parent_scope->m_contains_direct_call_to_eval |= m_contains_direct_call_to_eval;
@@ -374,21 +397,18 @@ public:
                 if (m_contains_direct_call_to_eval)
                     identifier_group.used_inside_scope_with_eval = true;
 
-                if (m_parent_scope) {
-                    if (auto maybe_parent_scope_identifier_group = m_parent_scope->m_identifier_groups.get(identifier_group_name); maybe_parent_scope_identifier_group.has_value()) {
-                        maybe_parent_scope_identifier_group.value().identifiers.extend(identifier_group.identifiers);
-                        if (identifier_group.captured_by_nested_function)
-                            maybe_parent_scope_identifier_group.value().captured_by_nested_function = true;
-                        if (identifier_group.used_inside_with_statement)
-                            maybe_parent_scope_identifier_group.value().used_inside_with_statement = true;
-                        if (identifier_group.might_be_variable_in_lexical_scope_in_named_function_assignment)
-                            maybe_parent_scope_identifier_group.value().might_be_variable_in_lexical_scope_in_named_function_assignment = true;
-                        if (identifier_group.used_inside_scope_with_eval)
-                            maybe_parent_scope_identifier_group.value().used_inside_scope_with_eval = true;
-                    } else {
-                        m_parent_scope->m_identifier_groups.set(identifier_group_name, identifier_group);
-                    }
+                if (m_preparsed_function) {
+                    m_preparsed_function->free_identifiers.set(identifier_group_name,
+                        PreparsedFunctionData::FreeIdentifier {
+                            .identifier = identifier_group.identifiers.first(),
+                            .used_inside_with_statement = identifier_group.used_inside_with_statement,
+                            .used_inside_scope_with_eval = identifier_group.used_inside_scope_with_eval,
+                            .might_be_variable_in_lexical_scope_in_named_function_assignment = identifier_group.might_be_variable_in_lexical_scope_in_named_function_assignment,
+                        });
                 }
+
+                if (m_parent_scope)
+                    m_parent_scope->add_identifier_group(identifier_group_name, identifier_group);
             }
         }
 
@@ -435,6 +455,27 @@ public:
         }
     }
 
+    // Does to this scope what parsing the given preparsed function in it did, without parsing the function again.
+    void register_preparsed_function(FunctionNode const& function, PreparsedFunctionData const& preparsed_function)
+    {
+        if (auto name = function.name_identifier())
+            register_identifier(const_cast<Identifier&>(*name));
+
+        for (auto const& it : preparsed_function.free_identifiers) {
+            add_identifier_group(it.key,
+                IdentifierGroup {
+                    .captured_by_nested_function = true,
+                    .used_inside_with_statement = it.value.used_inside_with_statement,
+                    .used_inside_scope_with_eval = it.value.used_inside_scope_with_eval,
+                    .might_be_variable_in_lexical_scope_in_named_function_assignment = it.value.might_be_variable_in_lexical_scope_in_named_function_assignment,
+                    .identifiers = { const_cast<Identifier&>(*it.value.identifier) },
+                });
+        }
+
+        if (function.contains_direct_call_to_eval())
+            m_screwed_by_eval_in_scope_chain = true;
+    }
+
 private:
     void throw_identifier_declared(DeprecatedFlyString const& name, NonnullRefPtr<Declaration const> const& declaration)
     {
@@ -469,12 +510,32 @@ private:
     };
     HashMap<DeprecatedFlyString, IdentifierGroup> m_identifier_groups;
 
+    void add_identifier_group(DeprecatedFlyString const& name, IdentifierGroup const& identifier_group)
+    {
+        if (auto maybe_identifier_group = m_identifier_groups.get(name); maybe_identifier_group.has_value()) {
+            maybe_identifier_group.value().identifiers.extend(identifier_group.identifiers);
+            if (identifier_group.captured_by_nested_function)
+                maybe_identifier_group.value().captured_by_nested_function = true;
+            if (identifier_group.used_inside_with_statement)
+                maybe_identifier_group.value().used_inside_with_statement = true;
+            if (identifier_group.might_be_variable_in_lexical_scope_in_named_function_assignment)
+                maybe_identifier_group.value().might_be_variable_in_lexical_scope_in_named_function_assignment = true;
+            if (identifier_group.used_inside_scope_with_eval)
+                maybe_identifier_group.value().used_inside_scope_with_eval = true;
+        } else {
+            m_identifier_groups.set(name, identifier_group);
+        }
+    }
+
     Optional<Vector<FunctionParameter>> m_function_parameters;
 
     bool m_contains_access_to_arguments_object { false };
     bool m_contains_direct_call_to_eval { false };
     bool m_contains_await_expression { false };
     bool m_screwed_by_eval_in_scope_chain { false };
+
+    PreparsedFunctionData* m_preparsed_function { nullptr };
+    PreparsedFunctionData const* m_function_parsed_again { nullptr };
 };
 
 class OperatorPrecedenceTable {
@@ -625,6 +686,13 @@ Parser::Parser(Lexer lexer, Program::Type program_type, Optional<EvalInitialStat
     }
 }
 
+Parser::Parser(Lexer lexer, Program::Type program_type, NonnullRefPtr<SourceCode const> source_code)
+    : m_source_code(move(source_code))
+    , m_state(move(lexer), program_type)
+    , m_program_type(program_type)
+{
+}
+
 Associativity Parser::operator_associativity(TokenType type) const
 {
     switch (type) {
@@ -2807,9 +2875,42 @@ NonnullRefPtr<BlockStatement const> Parser::parse_block_statement()
     return block;
 }
 
+// Functions shorter than this (in bytes of source, up to their closing curly) are kept parsed. What is kept of a preparsed
+// function takes about as much memory as the AST of a one-line function, and parsing it again once it runs costs time.
+// NOTE: This is kept small on purpose. A function that is parsed again also parses every function in it that has been
+//       kept, whether or not those ever run.
+static constexpr size_t minimum_preparsed_function_length = 128;
+
 template<typename FunctionNodeType>
 NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, Optional<Position> const& function_start)
 {
+    if (m_preparsed_functions_to_reuse) {
+        auto it = m_preparsed_functions_to_reuse->find(position().offset);
+        if (it != m_preparsed_functions_to_reuse->end() && is<FunctionNodeType>(*it->value)) {
+            auto function_node = static_ptr_cast<FunctionNodeType>(it->value);
+            auto const& preparsed_function = *function_node->m_preparsed_data;
+            m_state.current_scope_pusher->register_preparsed_function(*function_node, preparsed_function);
+            m_state.lexer.skip_past_closing_curly(preparsed_function.closing_curly);
+            m_state.current_token = m_state.lexer.next();
+            m_state.previous_token_was_period = false;
+            return function_node;
+        }
+    }
+
+    RefPtr<PreparsedFunctionData> preparsed_function;
+    if (can_preparse_function()) {
+        preparsed_function = adopt_ref(*new PreparsedFunctionData(m_source_code, m_state.lexer.source()));
+        preparsed_function->is_module = m_program_type == Program::Type::Module;
+        preparsed_function->is_declaration = IsSame<FunctionNodeType, FunctionDeclaration>;
+        preparsed_function->starts_in_strict_mode = m_state.strict_mode;
+        preparsed_function->starts_in_function_context = m_state.in_function_context;
+        preparsed_function->parse_options = parse_options;
+        preparsed_function->function_start = function_start;
+        preparsed_function->start = position();
+    }
+    auto* enclosing_preparsed_function = m_enclosing_preparsed_function;
+    TemporaryChange enclosing_preparsed_function_rollback(m_enclosing_preparsed_function, preparsed_function ? preparsed_function.ptr() : enclosing_preparsed_function);
+
     auto rule_start = function_start.has_value()
         ? RulePosition { *this, *function_start }
         : push_start();
@@ -2878,7 +2979,7 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
     Vector<FunctionParameter> parameters;
     bool contains_direct_call_to_eval = false;
     auto body = [&] {
-        ScopePusher function_scope = ScopePusher::function_scope(*this, name);
+        ScopePusher function_scope = ScopePusher::function_scope(*this, name, preparsed_function);
 
         consume(TokenType::ParenOpen);
         parameters = parse_formal_parameters(function_length, parse_options);
@@ -2901,6 +3002,7 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
     }();
 
     auto local_variables_names = body->local_variables_names();
+    auto closing_curly = position();
     consume(TokenType::CurlyClose);
 
     auto has_strict_directive = body->in_strict_mode();
@@ -2908,6 +3010,22 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
     if (has_strict_directive && name)
         check_identifier_name_for_assignment_validity(name->string(), true);
 
+    if (preparsed_function && closing_curly.offset - preparsed_function->start.offset >= minimum_preparsed_function_length) {
+        // NOTE: The body is parsed again once it is needed, see finish_parsing_function(). Until then, this only keeps
+        //       what is needed to do that, and what the code around the function needs to know about it.
+        preparsed_function->closing_curly = closing_curly;
+        auto function = create_ast_node<FunctionNodeType>(
+            { m_source_code, rule_start.position(), position() },
+            name, ByteString {}, nullptr, Vector<FunctionParameter> {}, function_length,
+            function_kind, has_strict_directive, m_state.function_might_need_arguments_object,
+            contains_direct_call_to_eval,
+            Vector<DeprecatedFlyString> {});
+        function->m_preparsed_data = preparsed_function;
+        if (enclosing_preparsed_function)
+            enclosing_preparsed_function->inner_functions.set(preparsed_function->start.offset, function);
+        return function;
+    }
+
     auto function_start_offset = rule_start.position().offset;
     auto function_end_offset = position().offset - m_state.current_token.trivia().length();
     auto source_text = ByteString { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
@@ -4429,6 +4547,10 @@ bool Parser::try_parse_arrow_function_expression_failed_at_position(Position con
 
 void Parser::set_try_parse_arrow_function_expression_failed_at_position(Position const& position, bool failed)
 {
+    // NOTE: A position only gets parsed again after going back to a saved state, so there's nothing to remember otherwise.
+    //       This keeps the memoizations from growing with every identifier in large scripts.
+    if (m_saved_state.is_empty())
+        return;
     m_token_memoizations.set(position, { failed });
 }
 
@@ -5092,6 +5214,59 @@ Parser::ForbiddenTokens Parser::ForbiddenTokens::forbid(std::initializer_list<To
 template NonnullRefPtr<FunctionExpression> Parser::parse_function_node(u16, Optional<Position> const&);
 template NonnullRefPtr<FunctionDeclaration> Parser::parse_function_node(u16, Optional<Position> const&);
 
+bool Parser::can_preparse_function() const
+{
+    // NOTE: Functions get parsed again on their own, which only knows whether the code around them is strict, so functions
+    //       whose parsing depends on more than that are parsed right away: class members (and everything else inside a
+    //       class body), functions in parameter lists and catch parameters, and eval code. Arrow functions don't come
+    //       through parse_function_node() and are always parsed right away. Functions shorter than
+    //       minimum_preparsed_function_length are kept parsed once parse_function_node() sees how long they are.
+    return m_preparse_functions
+        && m_state.current_scope_pusher
+        && !m_state.referenced_private_names
+        && !m_state.in_formal_parameter_context
+        && !m_state.in_catch_parameter_context
+        && !m_state.in_class_field_initializer
+        && !m_state.in_class_static_init_block;
+}
+
+void Parser::finish_parsing_function(FunctionNode const& function)
+{
+    NonnullRefPtr preparsed_function = *function.m_preparsed_data;
+
+    auto program_type = preparsed_function->is_module ? Program::Type::Module : Program::Type::Script;
+    Parser parser(Lexer(preparsed_function->source, preparsed_function->source_code->filename(), preparsed_function->start), program_type, preparsed_function->source_code);
+    parser.m_state.strict_mode = preparsed_function->starts_in_strict_mode;
+    parser.m_state.in_function_context = preparsed_function->starts_in_function_context;
+    parser.m_preparsed_functions_to_reuse = &preparsed_function->inner_functions;
+
+    RefPtr<ASTNode const> node;
+    FunctionNode const* parsed_function = nullptr;
+    {
+        auto parent_scope = ScopePusher::preparsed_function_parent_scope(parser, preparsed_function);
+        if (preparsed_function->is_declaration) {
+            auto declaration = parser.parse_function_node<FunctionDeclaration>(preparsed_function->parse_options, preparsed_function->function_start);
+            parsed_function = declaration.ptr();
+            node = move(declaration);
+        } else {
+            auto expression = parser.parse_function_node<FunctionExpression>(preparsed_function->parse_options, preparsed_function->function_start);
+            parsed_function = expression.ptr();
+            node = move(expression);
+        }
+    }
+
+    // NOTE: This is the same source text that has been checked for syntax errors before.
+    VERIFY(!parser.has_errors());
+    VERIFY(parsed_function->name() == function.name());
+    VERIFY(parsed_function->function_length() == function.function_length());
+
+    function.m_source_text = move(parsed_function->m_source_text);
+    function.m_body = move(parsed_function->m_body);
+    function.m_parameters = move(parsed_function->m_parameters);
+    function.m_local_variables_names = move(parsed_function->m_local_variables_names);
+    function.m_preparsed_data = nullptr;
+}
+
 NonnullRefPtr<Identifier const> Parser::create_identifier_and_register_in_current_scope(SourceRange range, DeprecatedFlyString string)
 {
     auto id = create_ast_node<Identifier const>(range, string);
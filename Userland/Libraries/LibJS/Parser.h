@@ -57,6 +57,13 @@ public:
 
     NonnullRefPtr<Program> parse_program(bool starts_in_strict_mode = false);
 
+    // Drops the parameters and bodies of most functions once they have been checked for syntax errors, and parses them
+    // again once they are first called. This still runs the full parser over every function, as there is no AST-free
+    // preparser, so functions that never run save memory and a little time, while functions that do run are parsed
+    // twice. See can_preparse_function() for which functions it skips.
+    void enable_function_preparsing() { m_preparse_functions = true; }
+    static void finish_parsing_function(FunctionNode const&);
+
     template<typename FunctionNodeType>
     NonnullRefPtr<FunctionNodeType> parse_function_node(u16 parse_options = FunctionNodeParseOptions::CheckForFunctionAndName, Optional<Position> const& function_start = {});
     Vector<FunctionParameter> parse_formal_parameters(int& function_length, u16 parse_options = 0);
@@ -216,6 +223,10 @@ public:
 private:
     friend class ScopePusher;
 
+    Parser(Lexer, Program::Type, NonnullRefPtr<SourceCode const>);
+
+    bool can_preparse_function() const;
+
     void parse_script(Program& program, bool starts_in_strict_mode);
     void parse_module(Program& program);
 
@@ -356,5 +367,9 @@ private:
     Vector<ParserState> m_saved_state;
     HashMap<Position, TokenMemoization, PositionKeyTraits> m_token_memoizations;
     Program::Type m_program_type;
+
+    bool m_preparse_functions { false };
+    PreparsedFunctionData* m_enclosing_preparsed_function { nullptr };
+    HashMap<size_t, NonnullRefPtr<ASTNode>> const* m_preparsed_functions_to_reuse { nullptr };
 };
 }
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/AST.h>
+#include <LibJS/ProgramCache.h>
+
+namespace JS {
+
+// The cached programs keep their bytecode alive, so don't let them grow without bounds.
+static constexpr size_t max_number_of_programs = 64;
+static constexpr size_t max_total_source_length = 32 * MiB;
+
+ProgramCache::ProgramCache() = default;
+ProgramCache::~ProgramCache() = default;
+
+RefPtr<Program> ProgramCache::get(StringView source_text, StringView filename, size_t line_number_offset, Goal goal)
+{
+    auto source_hash = source_text.hash();
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        auto const& entry = m_entries[i];
+        if (entry.source_hash != source_hash || entry.line_number_offset != line_number_offset || entry.goal != goal)
+            continue;
+        auto const& source_code = entry.program->source_code();
+        if (source_code.code().bytes() != source_text.bytes() || source_code.filename().bytes() != filename.bytes())
+            continue;
+
+        auto program = entry.program;
+        if (i != 0)
+            m_entries.prepend(m_entries.take(i));
+        return program;
+    }
+    return {};
+}
+
+void ProgramCache::set(size_t line_number_offset, Goal goal, NonnullRefPtr<Program> program)
+{
+    auto source_text = program->source_code().code().bytes_as_string_view();
+    if (source_text.length() > max_total_source_length)
+        return;
+
+    m_total_source_length += source_text.length();
+    m_entries.prepend({
+        .source_hash = source_text.hash(),
+        .line_number_offset = line_number_offset,
+        .goal = goal,
+        .program = move(program),
+    });
+
+    while (m_entries.size() > max_number_of_programs || m_total_source_length > max_total_source_length) {
+        auto evicted = m_entries.take_last();
+        m_total_source_length -= evicted.program->source_code().code().bytes_as_string_view().length();
+    }
+}
+
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/RefPtr.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+#include <LibJS/Forward.h>
+
+namespace JS {
+
+// Remembers the programs parsed for scripts and modules, so that evaluating the same source text again (like the same
+// framework bundle on the next page load) doesn't lex, parse and generate bytecode all over again. The bytecode of a
+// program, and of each of its functions once it's first called, is kept on its AST nodes. Programs don't change once
+// they're parsed, and nothing in them or their bytecode depends on the realm they're evaluated in.
+// NOTE: The cache only lives as long as the VM. BytecodeCache is what keeps bytecode around for the next process.
+class ProgramCache {
+public:
+    enum class Goal {
+        Script,
+        Module,
+    };
+
+    ProgramCache();
+    ~ProgramCache();
+
+    RefPtr<Program> get(StringView source_text, StringView filename, size_t line_number_offset, Goal);
+    void set(size_t line_number_offset, Goal, NonnullRefPtr<Program>);
+
+private:
+    struct Entry {
+        u32 source_hash { 0 };
+        size_t line_number_offset { 0 };
+        Goal goal { Goal::Script };
+        NonnullRefPtr<Program> program;
+    };
+
+    // Most recently used first.
+    Vector<Entry> m_entries;
+    size_t m_total_source_length { 0 };
+};
+
+}
@@ -8,6 +8,6 @@
 
 namespace JS {
 
-JS_DEFINE_ALLOCATOR(Accessor);
+JS_DEFINE_LAZILY_SWEPT_ALLOCATOR(Accessor);
 
 }
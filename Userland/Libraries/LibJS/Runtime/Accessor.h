@@ -15,6 +15,7 @@ namespace JS {
 
 class Accessor final : public Cell {
     JS_CELL(Accessor, Cell);
+    JS_CELL_HAS_WRITE_BARRIERS(Accessor);
     JS_DECLARE_ALLOCATOR(Accessor);
 
 public:
@@ -24,10 +25,18 @@ public:
     }
 
     FunctionObject* getter() const { return m_getter; }
-    void set_getter(FunctionObject* getter) { m_getter = getter; }
+    void set_getter(FunctionObject* getter)
+    {
+        m_getter = getter;
+        write_barrier();
+    }
 
     FunctionObject* setter() const { return m_setter; }
-    void set_setter(FunctionObject* setter) { m_setter = setter; }
+    void set_setter(FunctionObject* setter)
+    {
+        m_setter = setter;
+        write_barrier();
+    }
 
     void visit_edges(Cell::Visitor& visitor) override
     {
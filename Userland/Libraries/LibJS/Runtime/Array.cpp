@@ -17,7 +17,7 @@
 
 namespace JS {
 
-JS_DEFINE_ALLOCATOR(Array);
+JS_DEFINE_LAZILY_SWEPT_ALLOCATOR(Array);
 
 // 10.4.2.2 ArrayCreate ( length [ , proto ] ), https://tc39.es/ecma262/#sec-arraycreate
 ThrowCompletionOr<NonnullGCPtr<Array>> Array::create(Realm& realm, u64 length, Object* prototype)
@@ -81,12 +81,34 @@ NonnullGCPtr<Array> Array::create_from(Realm& realm, ReadonlySpan<Value> const&
     return array;
 }
 
-Array::Array(Object& prototype)
-    : Object(ConstructWithPrototypeTag::Tag, prototype)
+Array::Array(Object& prototype, MayInterfereWithIndexedPropertyAccess may_interfere_with_indexed_property_access)
+    : Object(ConstructWithPrototypeTag::Tag, prototype, may_interfere_with_indexed_property_access)
 {
     m_has_magical_length_property = true;
 }
 
+bool Array::can_append_elements_directly() const
+{
+    if (!m_is_extensible || !m_length_writable || !simple_indexed_property_storage())
+        return false;
+    for (auto const* object = prototype(); object; object = object->prototype()) {
+        if (object->may_interfere_with_prototype_chain_caching() || !object->indexed_properties().is_empty())
+            return false;
+    }
+    return true;
+}
+
+bool Array::create_element_directly(size_t index, Value value)
+{
+    auto* storage = simple_indexed_property_storage();
+    if (!storage || !m_is_extensible || index > storage->array_like_size())
+        return false;
+    if (index == storage->array_like_size() && (!m_length_writable || index >= NumericLimits<i32>::max()))
+        return false;
+    storage->put(index, value);
+    return true;
+}
+
 // 10.4.2.4 ArraySetLength ( A, Desc ), https://tc39.es/ecma262/#sec-arraysetlength
 ThrowCompletionOr<bool> Array::set_length(PropertyDescriptor const& property_descriptor)
 {
@@ -185,8 +207,17 @@ ThrowCompletionOr<MarkedVector<Value>> sort_indexed_properties(VM& vm, Object co
     auto items = MarkedVector<Value> { vm.heap() };
 
     // 2. Let k be 0.
+    size_t k = 0;
+
+    // OPTIMIZATION: Packed elements are all present, and can be read without running any code.
+    if (auto const* storage = object.simple_indexed_property_storage(); storage && storage->is_packed() && length <= storage->array_like_size()) {
+        items.ensure_capacity(length);
+        for (; k < length; ++k)
+            items.unchecked_append(storage->elements()[k]);
+    }
+
     // 3. Repeat, while k < len,
-    for (size_t k = 0; k < length; ++k) {
+    for (; k < length; ++k) {
         // a. Let Pk be ! ToString(𝔽(k)).
         auto property_key = PropertyKey { k };
 
@@ -231,6 +262,19 @@ ThrowCompletionOr<MarkedVector<Value>> sort_indexed_properties(VM& vm, Object co
     return items;
 }
 
+static StringView int32_to_string(i32 value, AK::Array<char, 11>& buffer)
+{
+    auto magnitude = value < 0 ? -static_cast<u32>(value) : static_cast<u32>(value);
+    size_t position = buffer.size();
+    do {
+        buffer[--position] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0)
+        buffer[--position] = '-';
+    return { buffer.data() + position, buffer.size() - position };
+}
+
 // 23.1.3.30.2 CompareArrayElements ( x, y, comparefn ), https://tc39.es/ecma262/#sec-comparearrayelements
 ThrowCompletionOr<double> compare_array_elements(VM& vm, Value x, Value y, FunctionObject* comparefn)
 {
@@ -260,6 +304,15 @@ ThrowCompletionOr<double> compare_array_elements(VM& vm, Value x, Value y, Funct
         return value_number.as_double();
     }
 
+    // OPTIMIZATION: Int32s (as found in arrays of the PackedInt32 kind) can be compared as strings without creating any,
+    //               which is what steps 5 to 11 do for them, as IsLessThan compares strings of ASCII digits byte by byte.
+    if (x.is_int32() && y.is_int32()) {
+        AK::Array<char, 11> x_buffer;
+        AK::Array<char, 11> y_buffer;
+        auto result = int32_to_string(x.as_i32(), x_buffer).compare(int32_to_string(y.as_i32(), y_buffer));
+        return result < 0 ? -1 : (result > 0 ? 1 : 0);
+    }
+
     // 5. Let xString be ? ToString(x).
     auto x_string = PrimitiveString::create(vm, TRY(x.to_byte_string(vm)));
 
@@ -21,6 +21,7 @@ namespace JS {
 
 class Array : public Object {
     JS_OBJECT(Array, Object);
+    JS_CELL_HAS_WRITE_BARRIERS(Array);
     JS_DECLARE_ALLOCATOR(Array);
 
 public:
@@ -49,8 +50,17 @@ public:
 
     [[nodiscard]] bool length_is_writable() const { return m_length_writable; }
 
+    // Whether elements can be appended by putting them into the simple storage directly, which nothing could tell apart
+    // from [[Set]]: the array is extensible with a writable length, and nothing in its prototype chain has (or could
+    // intercept) indexed properties.
+    [[nodiscard]] bool can_append_elements_directly() const;
+
+    // Creates an element like CreateDataProperty would, by putting it into the simple storage directly if nothing could
+    // tell the difference. Returns false if the caller has to go the slow way instead.
+    [[nodiscard]] bool create_element_directly(size_t index, Value);
+
 protected:
-    explicit Array(Object& prototype);
+    explicit Array(Object& prototype, MayInterfereWithIndexedPropertyAccess = MayInterfereWithIndexedPropertyAccess::No);
 
 private:
     ThrowCompletionOr<bool> set_length(PropertyDescriptor const&);
@@ -9,7 +9,7 @@
 
 namespace JS {
 
-JS_DEFINE_ALLOCATOR(ArrayIterator);
+JS_DEFINE_LAZILY_SWEPT_ALLOCATOR(ArrayIterator);
 
 NonnullGCPtr<ArrayIterator> ArrayIterator::create(Realm& realm, Value array, Object::PropertyKind iteration_kind)
 {
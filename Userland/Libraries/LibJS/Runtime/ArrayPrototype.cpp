@@ -109,6 +109,16 @@ void ArrayPrototype::initialize(Realm& realm)
     define_direct_property(vm.well_known_symbol_unscopables(), unscopable_list, Attribute::Configurable);
 }
 
+// Reads an element straight out of simple storage, where it's known to be present and reading it can't run any code, so
+// that HasProperty and Get can be skipped. Returns an empty value for holes and anything else that has to go the slow way.
+static Value get_element_directly(Object const& object, size_t index)
+{
+    auto const* storage = object.simple_indexed_property_storage();
+    if (!storage || index >= storage->array_like_size())
+        return {};
+    return storage->elements()[index];
+}
+
 // 10.4.2.3 ArraySpeciesCreate ( originalArray, length ), https://tc39.es/ecma262/#sec-arrayspeciescreate
 static ThrowCompletionOr<Object*> array_species_create(VM& vm, Object& original_array, size_t length)
 {
@@ -795,6 +805,38 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
         k = max(length + n, 0);
     }
 
+    // OPTIMIZATION: Search packed elements directly, as none of the steps below can run any code for them. If they are all
+    //               numbers, only a number can be strictly equal to one of them, and that comparison is numeric.
+    if (auto const* storage = object->simple_indexed_property_storage(); storage && storage->is_packed() && length <= storage->array_like_size()) {
+        auto elements = storage->elements().span();
+        switch (storage->element_kind()) {
+        case ElementKind::PackedInt32:
+        case ElementKind::PackedNumber: {
+            if (!search_element.is_number())
+                return Value(-1);
+            auto search_number = search_element.as_double();
+            if (storage->element_kind() == ElementKind::PackedInt32) {
+                for (; k < length; ++k) {
+                    if (elements[k].as_i32() == search_number)
+                        return Value(k);
+                }
+            } else {
+                for (; k < length; ++k) {
+                    if (elements[k].as_double() == search_number)
+                        return Value(k);
+                }
+            }
+            return Value(-1);
+        }
+        default:
+            for (; k < length; ++k) {
+                if (is_strictly_equal(search_element, elements[k]))
+                    return Value(k);
+            }
+            return Value(-1);
+        }
+    }
+
     // 10. Repeat, while k < len,
     for (; k < length; ++k) {
         auto property_key = PropertyKey { k };
@@ -958,24 +1000,33 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::map)
         // a. Let Pk be ! ToString(𝔽(k)).
         auto property_key = PropertyKey { k };
 
+        // NOTE: The callback can change O in any way, so this has to be checked again for every element.
+        auto k_value = get_element_directly(*object, k);
+
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = TRY(object->has_property(property_key));
+        auto k_present = !k_value.is_empty() || TRY(object->has_property(property_key));
 
         // c. If kPresent is true, then
         if (k_present) {
             // i. Let kValue be ? Get(O, Pk).
-            auto k_value = TRY(object->get(property_key));
+            if (k_value.is_empty())
+                k_value = TRY(object->get(property_key));
 
             // ii. Let mappedValue be ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
             auto mapped_value = TRY(call(vm, callback_function.as_function(), this_arg, k_value, Value(k), object));
 
             // iii. Perform ? CreateDataPropertyOrThrow(A, Pk, mappedValue).
-            TRY(array->create_data_property_or_throw(property_key, mapped_value));
+            if (!is<Array>(*array) || !static_cast<Array&>(*array).create_element_directly(k, mapped_value))
+                TRY(array->create_data_property_or_throw(property_key, mapped_value));
         }
 
         // d. Set k to k + 1.
     }
 
+    // NOTE: A was created with len holes, which are usually all filled in by now.
+    if (auto* storage = array->simple_indexed_property_storage())
+        storage->refine_element_kind();
+
     // 7. Return A.
     return array;
 }
@@ -1000,8 +1051,20 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::pop)
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::push)
 {
     auto this_object = TRY(vm.this_value().to_object(vm));
-    auto length = TRY(length_of_array_like(vm, this_object));
     auto argument_count = vm.argument_count();
+
+    // OPTIMIZATION: Append to the simple storage of arrays directly, if nothing could tell that apart from the steps below.
+    if (is<Array>(*this_object) && static_cast<Array&>(*this_object).can_append_elements_directly()) {
+        auto& storage = *this_object->simple_indexed_property_storage();
+        auto length = storage.array_like_size();
+        if (length + argument_count < NumericLimits<i32>::max()) {
+            for (size_t i = 0; i < argument_count; ++i)
+                storage.put(length + i, vm.argument(i));
+            return Value(storage.array_like_size());
+        }
+    }
+
+    auto length = TRY(length_of_array_like(vm, this_object));
     auto new_length = length + argument_count;
     if (new_length > MAX_ARRAY_LIKE_INDEX)
         return vm.throw_completion<TypeError>(ErrorType::ArrayMaxSize);
@@ -1426,6 +1489,13 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
 
     // 8. Repeat, while j < itemCount,
     for (; j < item_count; ++j) {
+        // OPTIMIZATION: Overwrite elements in simple storage directly, like Set would. This has to be checked again for
+        //               every element, as the comparison function may have changed obj.
+        if (auto* storage = object->simple_indexed_property_storage(); storage && !get_element_directly(*object, j).is_empty()) {
+            storage->put(j, sorted_list[j]);
+            continue;
+        }
+
         // a. Perform ? Set(obj, ! ToString(𝔽(j)), sortedList[j], true).
         TRY(object->set(j, sorted_list[j], Object::ShouldThrowExceptions::Yes));
         // b. Set j to j + 1.
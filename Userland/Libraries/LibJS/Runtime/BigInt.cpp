@@ -11,7 +11,7 @@
 
 namespace JS {
 
-JS_DEFINE_ALLOCATOR(BigInt);
+JS_DEFINE_LAZILY_SWEPT_ALLOCATOR(BigInt);
 
 NonnullGCPtr<BigInt> BigInt::create(VM& vm, Crypto::SignedBigInteger big_integer)
 {
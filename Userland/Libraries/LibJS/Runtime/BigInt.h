@@ -17,6 +17,7 @@ namespace JS {
 
 class BigInt final : public Cell {
     JS_CELL(BigInt, Cell);
+    JS_CELL_HAS_WRITE_BARRIERS(BigInt);
     JS_DECLARE_ALLOCATOR(BigInt);
 
 public:
@@ -31,26 +31,27 @@
 
 namespace JS {
 
-JS_DEFINE_ALLOCATOR(ECMAScriptFunctionObject);
+JS_DEFINE_LAZILY_SWEPT_ALLOCATOR(ECMAScriptFunctionObject);
 
-NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create(Realm& realm, DeprecatedFlyString name, ByteString source_text, Statement const& ecmascript_code, Vector<FunctionParameter> parameters, i32 m_function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, FunctionKind kind, bool is_strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name)
+static Object& function_prototype_for_kind(Realm& realm, FunctionKind kind)
 {
-    Object* prototype = nullptr;
     switch (kind) {
     case FunctionKind::Normal:
-        prototype = realm.intrinsics().function_prototype();
-        break;
+        return *realm.intrinsics().function_prototype();
     case FunctionKind::Generator:
-        prototype = realm.intrinsics().generator_function_prototype();
-        break;
+        return *realm.intrinsics().generator_function_prototype();
     case FunctionKind::Async:
-        prototype = realm.intrinsics().async_function_prototype();
-        break;
+        return *realm.intrinsics().async_function_prototype();
     case FunctionKind::AsyncGenerator:
-        prototype = realm.intrinsics().async_generator_function_prototype();
-        break;
+        return *realm.intrinsics().async_generator_function_prototype();
     }
-    return realm.heap().allocate<ECMAScriptFunctionObject>(realm, move(name), move(source_text), ecmascript_code, move(parameters), m_function_length, move(local_variables_names), parent_environment, private_environment, *prototype, kind, is_strict, might_need_arguments_object, contains_direct_call_to_eval, is_arrow_function, move(class_field_initializer_name));
+    VERIFY_NOT_REACHED();
+}
+
+NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create(Realm& realm, DeprecatedFlyString name, ByteString source_text, Statement const& ecmascript_code, Vector<FunctionParameter> parameters, i32 m_function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, FunctionKind kind, bool is_strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name)
+{
+    auto& prototype = function_prototype_for_kind(realm, kind);
+    return realm.heap().allocate<ECMAScriptFunctionObject>(realm, move(name), move(source_text), ecmascript_code, move(parameters), m_function_length, move(local_variables_names), parent_environment, private_environment, prototype, kind, is_strict, might_need_arguments_object, contains_direct_call_to_eval, is_arrow_function, move(class_field_initializer_name));
 }
 
 NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create(Realm& realm, DeprecatedFlyString name, Object& prototype, ByteString source_text, Statement const& ecmascript_code, Vector<FunctionParameter> parameters, i32 m_function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, FunctionKind kind, bool is_strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name)
@@ -58,6 +59,25 @@ NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create(Realm& r
     return realm.heap().allocate<ECMAScriptFunctionObject>(realm, move(name), move(source_text), ecmascript_code, move(parameters), m_function_length, move(local_variables_names), parent_environment, private_environment, prototype, kind, is_strict, might_need_arguments_object, contains_direct_call_to_eval, is_arrow_function, move(class_field_initializer_name));
 }
 
+NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create(Realm& realm, DeprecatedFlyString name, FunctionDeclaration const& function_declaration, Environment* parent_environment, PrivateEnvironment* private_environment)
+{
+    return create_from_function_node(realm, move(name), function_declaration, parent_environment, private_environment);
+}
+
+NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create(Realm& realm, DeprecatedFlyString name, FunctionExpression const& function_expression, Environment* parent_environment, PrivateEnvironment* private_environment)
+{
+    return create_from_function_node(realm, move(name), function_expression, parent_environment, private_environment);
+}
+
+template<typename FunctionNodeType>
+NonnullGCPtr<ECMAScriptFunctionObject> ECMAScriptFunctionObject::create_from_function_node(Realm& realm, DeprecatedFlyString name, FunctionNodeType const& function_node, Environment* parent_environment, PrivateEnvironment* private_environment)
+{
+    auto& prototype = function_prototype_for_kind(realm, function_node.kind());
+    if (function_node.is_preparsed())
+        return realm.heap().allocate<ECMAScriptFunctionObject>(realm, move(name), function_node, function_node, parent_environment, private_environment, prototype);
+    return realm.heap().allocate<ECMAScriptFunctionObject>(realm, move(name), function_node.source_text(), function_node.body(), function_node.parameters(), function_node.function_length(), function_node.local_variables_names(), parent_environment, private_environment, prototype, function_node.kind(), function_node.is_strict_mode(), function_node.might_need_arguments_object(), function_node.contains_direct_call_to_eval(), function_node.is_arrow_function(), Empty {});
+}
+
 ECMAScriptFunctionObject::ECMAScriptFunctionObject(DeprecatedFlyString name, ByteString source_text, Statement const& ecmascript_code, Vector<FunctionParameter> formal_parameters, i32 function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, Object& prototype, FunctionKind kind, bool strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name)
     : FunctionObject(prototype)
     , m_name(move(name))
@@ -91,6 +111,51 @@ ECMAScriptFunctionObject::ECMAScriptFunctionObject(DeprecatedFlyString name, Byt
     // 15. Set F.[[ScriptOrModule]] to GetActiveScriptOrModule().
     m_script_or_module = vm().get_active_script_or_module();
 
+    prepare_function_declaration_instantiation();
+}
+
+ECMAScriptFunctionObject::ECMAScriptFunctionObject(DeprecatedFlyString name, NonnullRefPtr<ASTNode const> preparsed_function_node, FunctionNode const& preparsed_function, Environment* parent_environment, PrivateEnvironment* private_environment, Object& prototype)
+    : FunctionObject(prototype)
+    , m_name(move(name))
+    , m_function_length(preparsed_function.function_length())
+    , m_environment(parent_environment)
+    , m_private_environment(private_environment)
+    , m_realm(&prototype.shape().realm())
+    , m_strict(preparsed_function.is_strict_mode())
+    , m_might_need_arguments_object(preparsed_function.might_need_arguments_object())
+    , m_contains_direct_call_to_eval(preparsed_function.contains_direct_call_to_eval())
+    , m_is_arrow_function(preparsed_function.is_arrow_function())
+    , m_kind(preparsed_function.kind())
+    , m_preparsed_function_node(move(preparsed_function_node))
+    , m_preparsed_function(&preparsed_function)
+{
+    // NOTE: These are the steps of OrdinaryFunctionCreate that don't need the function's code, see the constructor above.
+    if (m_is_arrow_function)
+        m_this_mode = ThisMode::Lexical;
+    else if (m_strict)
+        m_this_mode = ThisMode::Strict;
+    else
+        m_this_mode = ThisMode::Global;
+
+    m_script_or_module = vm().get_active_script_or_module();
+}
+
+void ECMAScriptFunctionObject::finish_parsing()
+{
+    auto const& function = *m_preparsed_function;
+    m_source_text = function.source_text();
+    m_ecmascript_code = function.body();
+    m_formal_parameters = function.parameters();
+    m_local_variables_names = function.local_variables_names();
+
+    m_preparsed_function = nullptr;
+    m_preparsed_function_node = nullptr;
+
+    prepare_function_declaration_instantiation();
+}
+
+void ECMAScriptFunctionObject::prepare_function_declaration_instantiation()
+{
     // 15.1.3 Static Semantics: IsSimpleParameterList, https://tc39.es/ecma262/#sec-static-semantics-issimpleparameterlist
     m_has_simple_parameter_list = all_of(m_formal_parameters, [&](auto& parameter) {
         if (parameter.is_rest)
@@ -373,6 +438,8 @@ ThrowCompletionOr<Value> ECMAScriptFunctionObject::internal_call(Value this_argu
 {
     auto& vm = this->vm();
 
+    ensure_parsed();
+
     // 1. Let callerContext be the running execution context.
     // NOTE: No-op, kept by the VM in its execution context stack.
 
@@ -432,6 +499,8 @@ ThrowCompletionOr<NonnullGCPtr<Object>> ECMAScriptFunctionObject::internal_const
 {
     auto& vm = this->vm();
 
+    ensure_parsed();
+
     // 1. Let callerContext be the running execution context.
     // NOTE: No-op, kept by the VM in its execution context stack.
 
@@ -929,7 +998,7 @@ ThrowCompletionOr<void> ECMAScriptFunctionObject::function_declaration_instantia
     for (auto& declaration : m_functions_to_initialize) {
         // a. Let fn be the sole element of the BoundNames of f.
         // b. Let fo be InstantiateFunctionObject of f with arguments lexEnv and privateEnv.
-        auto function = ECMAScriptFunctionObject::create(realm, declaration.name(), declaration.source_text(), declaration.body(), declaration.parameters(), declaration.function_length(), declaration.local_variables_names(), lex_environment, private_environment, declaration.kind(), declaration.is_strict_mode(), declaration.might_need_arguments_object(), declaration.contains_direct_call_to_eval());
+        auto function = ECMAScriptFunctionObject::create(realm, declaration.name(), declaration, lex_environment, private_environment);
 
         // c. Perform ! varEnv.SetMutableBinding(fn, fo, false).
         if (declaration.name_identifier()->is_local()) {
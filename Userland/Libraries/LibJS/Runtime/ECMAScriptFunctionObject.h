@@ -41,6 +41,10 @@ public:
     static NonnullGCPtr<ECMAScriptFunctionObject> create(Realm&, DeprecatedFlyString name, ByteString source_text, Statement const& ecmascript_code, Vector<FunctionParameter> parameters, i32 m_function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, FunctionKind, bool is_strict, bool might_need_arguments_object = true, bool contains_direct_call_to_eval = true, bool is_arrow_function = false, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name = {});
     static NonnullGCPtr<ECMAScriptFunctionObject> create(Realm&, DeprecatedFlyString name, Object& prototype, ByteString source_text, Statement const& ecmascript_code, Vector<FunctionParameter> parameters, i32 m_function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, FunctionKind, bool is_strict, bool might_need_arguments_object = true, bool contains_direct_call_to_eval = true, bool is_arrow_function = false, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name = {});
 
+    // These don't parse a preparsed function yet, that only happens once it is called or its code is looked at.
+    static NonnullGCPtr<ECMAScriptFunctionObject> create(Realm&, DeprecatedFlyString name, FunctionDeclaration const&, Environment* parent_environment, PrivateEnvironment* private_environment);
+    static NonnullGCPtr<ECMAScriptFunctionObject> create(Realm&, DeprecatedFlyString name, FunctionExpression const&, Environment* parent_environment, PrivateEnvironment* private_environment);
+
     virtual void initialize(Realm&) override;
     virtual ~ECMAScriptFunctionObject() override = default;
 
@@ -52,8 +56,16 @@ public:
     [[nodiscard]] bool is_module_wrapper() const { return m_is_module_wrapper; }
     void set_is_module_wrapper(bool b) { m_is_module_wrapper = b; }
 
-    Statement const& ecmascript_code() const { return m_ecmascript_code; }
-    Vector<FunctionParameter> const& formal_parameters() const { return m_formal_parameters; }
+    Statement const& ecmascript_code() const
+    {
+        ensure_parsed();
+        return *m_ecmascript_code;
+    }
+    Vector<FunctionParameter> const& formal_parameters() const
+    {
+        ensure_parsed();
+        return m_formal_parameters;
+    }
 
     virtual DeprecatedFlyString const& name() const override { return m_name; }
     void set_name(DeprecatedFlyString const& name);
@@ -73,7 +85,11 @@ public:
     Object* home_object() const { return m_home_object; }
     void set_home_object(Object* home_object) { m_home_object = home_object; }
 
-    ByteString const& source_text() const { return m_source_text; }
+    ByteString const& source_text() const
+    {
+        ensure_parsed();
+        return m_source_text;
+    }
     void set_source_text(ByteString source_text) { m_source_text = move(source_text); }
 
     Vector<ClassFieldDefinition> const& fields() const { return m_fields; }
@@ -83,12 +99,20 @@ public:
     void add_private_method(PrivateElement method) { m_private_methods.append(move(method)); }
 
     // This is for IsSimpleParameterList (static semantics)
-    bool has_simple_parameter_list() const { return m_has_simple_parameter_list; }
+    bool has_simple_parameter_list() const
+    {
+        ensure_parsed();
+        return m_has_simple_parameter_list;
+    }
 
     // Equivalent to absence of [[Construct]]
     virtual bool has_constructor() const override { return m_kind == FunctionKind::Normal && !m_is_arrow_function; }
 
-    virtual Vector<DeprecatedFlyString> const& local_variables_names() const override { return m_local_variables_names; }
+    virtual Vector<DeprecatedFlyString> const& local_variables_names() const override
+    {
+        ensure_parsed();
+        return m_local_variables_names;
+    }
 
     FunctionKind kind() const { return m_kind; }
 
@@ -105,6 +129,18 @@ protected:
 
 private:
     ECMAScriptFunctionObject(DeprecatedFlyString name, ByteString source_text, Statement const& ecmascript_code, Vector<FunctionParameter> parameters, i32 m_function_length, Vector<DeprecatedFlyString> local_variables_names, Environment* parent_environment, PrivateEnvironment* private_environment, Object& prototype, FunctionKind, bool is_strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function, Variant<PropertyKey, PrivateName, Empty> class_field_initializer_name);
+    ECMAScriptFunctionObject(DeprecatedFlyString name, NonnullRefPtr<ASTNode const> preparsed_function_node, FunctionNode const& preparsed_function, Environment* parent_environment, PrivateEnvironment* private_environment, Object& prototype);
+
+    template<typename FunctionNodeType>
+    static NonnullGCPtr<ECMAScriptFunctionObject> create_from_function_node(Realm&, DeprecatedFlyString name, FunctionNodeType const&, Environment* parent_environment, PrivateEnvironment* private_environment);
+
+    void ensure_parsed() const
+    {
+        if (m_preparsed_function) [[unlikely]]
+            const_cast<ECMAScriptFunctionObject&>(*this).finish_parsing();
+    }
+    void finish_parsing();
+    void prepare_function_declaration_instantiation();
 
     virtual bool is_ecmascript_function_object() const override { return true; }
     virtual void visit_edges(Visitor&) override;
@@ -125,8 +161,8 @@ private:
     // Internal Slots of ECMAScript Function Objects, https://tc39.es/ecma262/#table-internal-slots-of-ecmascript-function-objects
     GCPtr<Environment> m_environment;                                        // [[Environment]]
     GCPtr<PrivateEnvironment> m_private_environment;                         // [[PrivateEnvironment]]
-    Vector<FunctionParameter> const m_formal_parameters;                     // [[FormalParameters]]
-    NonnullRefPtr<Statement const> m_ecmascript_code;                        // [[ECMAScriptCode]]
+    Vector<FunctionParameter> m_formal_parameters;                           // [[FormalParameters]]
+    RefPtr<Statement const> m_ecmascript_code;                               // [[ECMAScriptCode]]
     GCPtr<Realm> m_realm;                                                    // [[Realm]]
     ScriptOrModule m_script_or_module;                                       // [[ScriptOrModule]]
     GCPtr<Object> m_home_object;                                             // [[HomeObject]]
@@ -167,6 +203,10 @@ private:
     size_t m_function_environment_bindings_count { 0 };
     size_t m_var_environment_bindings_count { 0 };
     size_t m_lex_environment_bindings_count { 0 };
+
+    // The function this was created from while it has only been preparsed, see finish_parsing().
+    RefPtr<ASTNode const> m_preparsed_function_node;
+    FunctionNode const* m_preparsed_function { nullptr };
 };
 
 template<>
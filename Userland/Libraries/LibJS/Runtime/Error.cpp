@@ -15,7 +15,7 @@
 
 namespace JS {
 
-JS_DEFINE_ALLOCATOR(Error);
+JS_DEFINE_LAZILY_SWEPT_ALLOCATOR(Error);
 
 SourceRange const& TracebackFrame::source_range() const
 {
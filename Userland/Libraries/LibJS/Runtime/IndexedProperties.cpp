@@ -18,6 +18,19 @@ SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initi
     , m_array_size(initial_values.size())
     , m_packed_elements(move(initial_values))
 {
+    refine_element_kind();
+}
+
+void SimpleIndexedPropertyStorage::refine_element_kind()
+{
+    m_element_kind = ElementKind::PackedInt32;
+    for (size_t i = 0; i < m_array_size; ++i) {
+        if (m_packed_elements[i].is_empty()) {
+            m_element_kind = ElementKind::Holey;
+            return;
+        }
+        generalize_element_kind_for(m_packed_elements[i]);
+    }
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
@@ -50,27 +63,40 @@ void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttribute
     VERIFY(attributes == default_attributes);
 
     if (index >= m_array_size) {
+        // Writing past the end leaves holes behind, unless it's an append.
+        if (index > m_array_size)
+            m_element_kind = ElementKind::Holey;
         m_array_size = index + 1;
         grow_storage_if_needed();
     }
     m_packed_elements[index] = value;
+
+    if (value.is_empty())
+        m_element_kind = ElementKind::Holey;
+    else
+        generalize_element_kind_for(value);
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
     VERIFY(index < m_array_size);
     m_packed_elements[index] = {};
+    m_element_kind = ElementKind::Holey;
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
 {
     m_array_size--;
+    if (m_array_size == 0)
+        m_element_kind = ElementKind::PackedInt32;
     return { m_packed_elements.take_first(), default_attributes };
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 {
     m_array_size--;
+    if (m_array_size == 0)
+        m_element_kind = ElementKind::PackedInt32;
     auto last_element = m_packed_elements[m_array_size];
     m_packed_elements[m_array_size] = {};
     return { last_element, default_attributes };
@@ -78,6 +104,11 @@ ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 
 bool SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    // Growing only adds holes, and an empty array can start over with the most specific kind.
+    if (new_size > m_array_size)
+        m_element_kind = ElementKind::Holey;
+    else if (new_size == 0)
+        m_element_kind = ElementKind::PackedInt32;
     m_array_size = new_size;
     m_packed_elements.resize_and_keep_capacity(new_size);
     return true;
@@ -54,6 +54,17 @@ private:
     bool m_is_simple_storage { false };
 };
 
+// What is known about all the elements of a SimpleIndexedPropertyStorage, from the most to the least specific. Values are
+// NaN-boxed, so this doesn't change how elements are stored, but it lets code working on the elements skip checks for
+// holes or for the types of the values. Storage only moves towards less specific kinds on its own, in place as elements
+// are added or removed, so knowing the kind stays cheap. (GenericIndexedPropertyStorage is the kind below Holey.)
+enum class ElementKind : u8 {
+    PackedInt32,  // No holes, and every element is an Int32.
+    PackedNumber, // No holes, and every element is a Number.
+    Packed,       // No holes.
+    Holey,
+};
+
 class SimpleIndexedPropertyStorage final : public IndexedPropertyStorage {
 public:
     SimpleIndexedPropertyStorage()
@@ -74,13 +85,27 @@ public:
 
     Vector<Value> const& elements() const { return m_packed_elements; }
 
+    ElementKind element_kind() const { return m_element_kind; }
+    bool is_packed() const { return m_element_kind != ElementKind::Holey; }
+
+    // Looks at all elements to find the most specific kind that fits them, for callers that have just filled in holes.
+    void refine_element_kind();
+
 private:
     friend GenericIndexedPropertyStorage;
 
     void grow_storage_if_needed();
 
+    void generalize_element_kind_for(Value value)
+    {
+        if (m_element_kind >= ElementKind::Packed || value.is_int32())
+            return;
+        m_element_kind = value.is_number() ? ElementKind::PackedNumber : ElementKind::Packed;
+    }
+
     size_t m_array_size { 0 };
     Vector<Value> m_packed_elements;
+    ElementKind m_element_kind { ElementKind::PackedInt32 };
 };
 
 class GenericIndexedPropertyStorage final : public IndexedPropertyStorage {
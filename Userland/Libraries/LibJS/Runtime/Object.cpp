@@ -23,7 +23,7 @@
 
 namespace JS {
 
-JS_DEFINE_ALLOCATOR(Object);
+JS_DEFINE_LAZILY_SWEPT_ALLOCATOR(Object);
 
 static HashMap<GCPtr<Object const>, HashMap<DeprecatedFlyString, Object::IntrinsicAccessor>> s_intrinsics;
 
@@ -79,8 +79,13 @@ Object::Object(Shape& shape, MayInterfereWithIndexedPropertyAccess may_interfere
     m_storage.resize(shape.property_count());
 }
 
-Object::~Object()
+Object::~Object() = default;
+
+void Object::finalize()
 {
+    Base::finalize();
+
+    // NOTE: Objects are swept lazily, so this can't wait for the destructor.
     if (m_has_intrinsic_accessors)
         s_intrinsics.remove(this);
 }
@@ -544,6 +549,7 @@ ThrowCompletionOr<void> Object::private_field_add(PrivateName const& name, Value
 
     // 4. Append PrivateElement { [[Key]]: P, [[Kind]]: field, [[Value]]: value } to O.[[PrivateElements]].
     m_private_elements->empend(name, PrivateElement::Kind::Field, value);
+    write_barrier();
 
     // 5. Return unused.
     return {};
@@ -572,6 +578,7 @@ ThrowCompletionOr<void> Object::private_method_or_accessor_add(PrivateElement el
 
     // 5. Append method to O.[[PrivateElements]].
     m_private_elements->append(move(element));
+    write_barrier();
 
     // 6. Return unused.
     return {};
@@ -627,6 +634,7 @@ ThrowCompletionOr<void> Object::private_set(PrivateName const& name, Value value
     if (entry->kind == PrivateElement::Kind::Field) {
         // a. Set entry.[[Value]] to value.
         entry->value = value;
+        write_barrier();
         return {};
     }
     // 4. Else if entry.[[Kind]] is method, then
@@ -892,6 +900,17 @@ ThrowCompletionOr<Value> Object::internal_get(PropertyKey const& property_key, V
         if (!parent)
             return js_undefined();
 
+        // Non-standard: Properties found in the prototype chain can be cached too, as long as every object on the way
+        //               looks its properties up in the ordinary way.
+        if (cacheable_metadata && !parent->may_interfere_with_prototype_chain_caching()) {
+            auto value = TRY(parent->internal_get(property_key, receiver, cacheable_metadata));
+            if (cacheable_metadata->type == CacheablePropertyMetadata::Type::OwnProperty) {
+                cacheable_metadata->type = CacheablePropertyMetadata::Type::InPrototypeChain;
+                cacheable_metadata->prototype = parent;
+            }
+            return value;
+        }
+
         // c. Return ? parent.[[Get]](P, Receiver).
         return parent->internal_get(property_key, receiver);
     }
@@ -953,7 +972,10 @@ ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey con
         // b. If parent is not null, then
         if (parent) {
             // i. Return ? parent.[[Set]](P, V, Receiver).
-            return TRY(parent->internal_set(property_key, value, receiver));
+            // Non-standard: Pass the cacheable metadata along, so that adding the property to the receiver can be cached.
+            if (parent->may_interfere_with_prototype_chain_caching())
+                cacheable_metadata = nullptr;
+            return TRY(parent->internal_set(property_key, value, receiver, cacheable_metadata));
         }
         // c. Else,
         else {
@@ -993,7 +1015,7 @@ ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey con
             // iii. Let valueDesc be the PropertyDescriptor { [[Value]]: V }.
             auto value_descriptor = PropertyDescriptor { .value = value };
 
-            if (cacheable_metadata && own_descriptor.has_value() && own_descriptor->property_offset.has_value() && shape().is_cacheable()) {
+            if (cacheable_metadata && &receiver.as_object() == this && own_descriptor->property_offset.has_value() && shape().is_cacheable()) {
                 *cacheable_metadata = CacheablePropertyMetadata {
                     .type = CacheablePropertyMetadata::Type::OwnProperty,
                     .property_offset = own_descriptor->property_offset.value(),
@@ -1008,6 +1030,10 @@ ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey con
             // i. Assert: Receiver does not currently have a property P.
             VERIFY(!receiver.as_object().storage_has(property_key));
 
+            // Non-standard: Nothing in the prototype chain got in the way, so the caller can cache the transition.
+            if (cacheable_metadata)
+                cacheable_metadata->type = CacheablePropertyMetadata::Type::AddOwnProperty;
+
             // ii. Return ? CreateDataProperty(Receiver, P, V).
             return TRY(receiver.as_object().create_data_property(property_key, value));
         }
@@ -1141,8 +1167,10 @@ Optional<ValueAndAttributes> Object::storage_get(PropertyKey const& property_key
             return {};
 
         if (m_has_intrinsic_accessors) {
-            if (auto accessor = find_intrinsic_accessor(this, property_key); accessor.has_value())
+            if (auto accessor = find_intrinsic_accessor(this, property_key); accessor.has_value()) {
                 const_cast<Object&>(*this).m_storage[metadata->offset] = (*accessor)(shape().realm());
+                const_cast<Object&>(*this).write_barrier();
+            }
         }
 
         value = m_storage[metadata->offset];
@@ -1166,6 +1194,7 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
     VERIFY(property_key.is_valid());
 
     auto [value, attributes, _] = value_and_attributes;
+    write_barrier();
 
     if (property_key.is_number()) {
         auto index = property_key.as_number();
@@ -1182,6 +1211,9 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
     auto metadata = shape().lookup(property_key_string_or_symbol);
 
     if (!metadata.has_value()) {
+        if (m_is_used_as_prototype)
+            vm().bump_shape_epoch();
+
         static constexpr size_t max_transitions_before_converting_to_dictionary = 64;
         if (!m_shape->is_dictionary() && m_shape->property_count() >= max_transitions_before_converting_to_dictionary)
             set_shape(m_shape->create_cacheable_dictionary_transition());
@@ -1195,10 +1227,17 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
     }
 
     if (attributes != metadata->attributes) {
+        // NOTE: Inline caches for dictionary shapes can't tell that the shape changed in place, so they check the epoch.
+        if (m_is_used_as_prototype || m_shape->is_dictionary())
+            vm().bump_shape_epoch();
+
         if (m_shape->is_dictionary())
             m_shape->set_property_attributes_without_transition(property_key_string_or_symbol, attributes);
         else
             set_shape(*m_shape->create_configure_transition(property_key_string_or_symbol, attributes));
+    } else if (m_is_used_as_prototype && (value.is_accessor() || m_storage[metadata->offset].is_accessor())) {
+        // NOTE: Turning a data property into an accessor (or back) doesn't necessarily change its attributes.
+        vm().bump_shape_epoch();
     }
 
     m_storage[metadata->offset] = value;
@@ -1220,15 +1259,20 @@ void Object::storage_delete(PropertyKey const& property_key)
     auto metadata = shape().lookup(property_key.to_string_or_symbol());
     VERIFY(metadata.has_value());
 
+    if (m_is_used_as_prototype)
+        vm().bump_shape_epoch();
+
     if (m_shape->is_cacheable_dictionary()) {
-        m_shape = m_shape->create_uncacheable_dictionary_transition();
+        set_shape(*m_shape->create_uncacheable_dictionary_transition());
     }
     if (m_shape->is_uncacheable_dictionary()) {
+        // NOTE: This moves the properties after it, which inline caches for the shape can't tell otherwise.
+        vm().bump_shape_epoch();
         m_shape->remove_property_without_transition(property_key.to_string_or_symbol(), metadata->offset);
         m_storage.remove(metadata->offset);
         return;
     }
-    m_shape = m_shape->create_delete_transition(property_key.to_string_or_symbol());
+    set_shape(*m_shape->create_delete_transition(property_key.to_string_or_symbol()));
     m_storage.remove(metadata->offset);
 }
 
@@ -1236,7 +1280,9 @@ void Object::set_prototype(Object* new_prototype)
 {
     if (prototype() == new_prototype)
         return;
-    m_shape = shape().create_prototype_transition(new_prototype);
+    if (m_is_used_as_prototype)
+        vm().bump_shape_epoch();
+    set_shape(*shape().create_prototype_transition(new_prototype));
 }
 
 void Object::define_native_accessor(Realm& realm, PropertyKey const& property_key, Function<ThrowCompletionOr<Value>(VM&)> getter, Function<ThrowCompletionOr<Value>(VM&)> setter, PropertyAttributes attribute)
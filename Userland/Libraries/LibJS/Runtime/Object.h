@@ -46,13 +46,19 @@ struct CacheablePropertyMetadata {
     enum class Type {
         NotCacheable,
         OwnProperty,
+        InPrototypeChain,
+        AddOwnProperty,
     };
     Type type { Type::NotCacheable };
     Optional<u32> property_offset;
+
+    // The object in the prototype chain that has the property, for InPrototypeChain.
+    GCPtr<Object const> prototype {};
 };
 
 class Object : public Cell {
     JS_CELL(Object, Cell);
+    JS_CELL_HAS_WRITE_BARRIERS(Object);
     JS_DECLARE_ALLOCATOR(Object);
 
 public:
@@ -149,6 +155,16 @@ public:
     //       might not hold when property access behaves differently.
     bool may_interfere_with_indexed_property_access() const { return m_may_interfere_with_indexed_property_access; }
 
+    // NOTE: Inline caches for properties found in the prototype chain, or added to the object itself, are shared by all
+    //       objects with the same shape. Any subclass of Object that has named properties which are not in its shape,
+    //       or customizes how they are set, has to return true for this, as an ordinary object can have its shape.
+    bool may_interfere_with_prototype_chain_caching() const { return m_may_interfere_with_indexed_property_access || m_may_interfere_with_prototype_chain_caching; }
+
+    // Whether the object is (or was) the prototype of a shape. Changes to the shape of such objects invalidate the
+    // prototype chain caches, see VM::shape_epoch().
+    bool is_used_as_prototype() const { return m_is_used_as_prototype; }
+    void set_is_used_as_prototype(Badge<Shape>) { m_is_used_as_prototype = true; }
+
     ThrowCompletionOr<bool> ordinary_set_with_own_descriptor(PropertyKey const&, Value, Value, Optional<PropertyDescriptor>, CacheablePropertyMetadata* = nullptr);
 
     // 10.4.7 Immutable Prototype Exotic Objects, https://tc39.es/ecma262/#sec-immutable-prototype-exotic-objects
@@ -200,13 +216,57 @@ public:
     void set_has_parameter_map() { m_has_parameter_map = true; }
 
     virtual void visit_edges(Cell::Visitor&) override;
+    virtual void finalize() override;
 
     Value get_direct(size_t index) const { return m_storage[index]; }
-    void put_direct(size_t index, Value value) { m_storage[index] = value; }
+    void put_direct(size_t index, Value value)
+    {
+        m_storage[index] = value;
+        write_barrier();
+    }
+
+    // Adds the property that a put transition from the current shape to the given one added, for inline caches that
+    // have seen the same transition before. Returns false if the object is not extensible.
+    [[nodiscard]] bool put_direct_with_transition(Shape& new_shape, Value value)
+    {
+        if (!m_is_extensible)
+            return false;
+        set_shape(new_shape);
+        m_storage.append(value);
+        write_barrier();
+        return true;
+    }
 
     IndexedProperties const& indexed_properties() const { return m_indexed_properties; }
-    IndexedProperties& indexed_properties() { return m_indexed_properties; }
-    void set_indexed_property_elements(Vector<Value>&& values) { m_indexed_properties = IndexedProperties(move(values)); }
+    // NOTE: Anything could be stored through the returned reference, so it's assumed that something will be.
+    IndexedProperties& indexed_properties()
+    {
+        write_barrier();
+        return m_indexed_properties;
+    }
+
+    // The simple storage of this object's indexed properties, if existing elements can be read and overwritten there
+    // directly instead of through the internal methods. Holes still have to go the slow way, as they could be filled in
+    // by the prototype chain.
+    SimpleIndexedPropertyStorage const* simple_indexed_property_storage() const
+    {
+        auto const* storage = m_indexed_properties.storage();
+        if (!storage || !storage->is_simple_storage() || m_may_interfere_with_indexed_property_access)
+            return nullptr;
+        return static_cast<SimpleIndexedPropertyStorage const*>(storage);
+    }
+    SimpleIndexedPropertyStorage* simple_indexed_property_storage()
+    {
+        auto const* storage = const_cast<Object const&>(*this).simple_indexed_property_storage();
+        if (storage)
+            write_barrier();
+        return const_cast<SimpleIndexedPropertyStorage*>(storage);
+    }
+    void set_indexed_property_elements(Vector<Value>&& values)
+    {
+        m_indexed_properties = IndexedProperties(move(values));
+        write_barrier();
+    }
 
     Shape& shape() { return *m_shape; }
     Shape const& shape() const { return *m_shape; }
@@ -244,12 +304,20 @@ protected:
 
     bool m_is_typed_array { false };
 
+    void set_may_interfere_with_prototype_chain_caching() { m_may_interfere_with_prototype_chain_caching = true; }
+
 private:
-    void set_shape(Shape& shape) { m_shape = &shape; }
+    void set_shape(Shape& shape)
+    {
+        m_shape = &shape;
+        write_barrier();
+    }
 
     Object* prototype() { return shape().prototype(); }
 
     bool m_may_interfere_with_indexed_property_access { false };
+    bool m_may_interfere_with_prototype_chain_caching { false };
+    bool m_is_used_as_prototype { false };
 
     // True if this object has lazily allocated intrinsic properties.
     bool m_has_intrinsic_accessors { false };
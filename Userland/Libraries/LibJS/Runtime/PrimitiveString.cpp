@@ -19,7 +19,7 @@
 
 namespace JS {
 
-JS_DEFINE_ALLOCATOR(PrimitiveString);
+JS_DEFINE_LAZILY_SWEPT_ALLOCATOR(PrimitiveString);
 
 PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
     : m_is_rope(true)
@@ -43,7 +43,10 @@ PrimitiveString::PrimitiveString(Utf16String string)
 {
 }
 
-PrimitiveString::~PrimitiveString()
+PrimitiveString::~PrimitiveString() = default;
+
+// NOTE: This is done when the string dies rather than when it's destroyed, as that may happen much later.
+void PrimitiveString::finalize()
 {
     if (has_utf8_string())
         vm().string_cache().remove(*m_utf8_string);
@@ -54,7 +57,7 @@ PrimitiveString::~PrimitiveString()
 void PrimitiveString::visit_edges(Cell::Visitor& visitor)
 {
     Base::visit_edges(visitor);
-    if (m_is_rope) {
+    if (m_is_rope || m_is_prefix) {
         visitor.visit(m_lhs);
         visitor.visit(m_rhs);
     }
@@ -62,8 +65,8 @@ void PrimitiveString::visit_edges(Cell::Visitor& visitor)
 
 bool PrimitiveString::is_empty() const
 {
-    if (m_is_rope) {
-        // NOTE: We never make an empty rope string.
+    if (m_is_rope || m_is_prefix) {
+        // NOTE: We never make an empty rope string, and only pieces of ropes become prefixes.
         return false;
     }
 
@@ -246,8 +249,25 @@ NonnullGCPtr<PrimitiveString> PrimitiveString::create(VM& vm, PrimitiveString& l
     return vm.heap().allocate_without_realm<PrimitiveString>(lhs, rhs);
 }
 
+void PrimitiveString::resolve_prefix() const
+{
+    // The string that took over our code units may have handed them on to yet another string since.
+    auto const* owner = m_lhs.ptr();
+    while (owner->m_is_prefix)
+        owner = owner->m_lhs.ptr();
+
+    m_utf16_string = Utf16String::create(owner->utf16_string_view().substring_view(0, m_prefix_length));
+    m_is_prefix = false;
+    m_lhs = nullptr;
+}
+
 void PrimitiveString::resolve_rope_if_needed(EncodingPreference preference) const
 {
+    if (m_is_prefix) {
+        resolve_prefix();
+        return;
+    }
+
     if (!m_is_rope)
         return;
 
@@ -274,11 +294,41 @@ void PrimitiveString::resolve_rope_if_needed(EncodingPreference preference) cons
         // The caller wants a UTF-16 string, so we can simply concatenate all the pieces
         // into a UTF-16 code unit buffer and create a Utf16String from it.
 
-        Utf16Data code_units;
-        for (auto const* current : pieces)
-            code_units.extend(current->utf16_string().string());
+        Vector<Utf16View> views;
+        views.ensure_capacity(pieces.size());
+        size_t length_in_code_units = 0;
+        for (auto const* current : pieces) {
+            views.unchecked_append(current->utf16_string_view());
+            length_in_code_units += views.last().length_in_code_units();
+        }
+
+        // OPTIMIZATION: Strings are often built by appending to them in a loop. If they are looked at in between, the
+        //               string that was resolved last time is the first piece of this rope, and we can usually take over
+        //               its code units and append the rest to them in place. That makes such loops take amortized linear
+        //               rather than quadratic time.
+        auto const* first = pieces.first();
+        auto first_length = views.first().length_in_code_units();
+        bool first_appears_again = pieces.span().slice(1).contains_slow(first);
+        if (auto* first_code_units = first->m_utf16_string->string_for_appending(length_in_code_units - first_length); first_code_units && !first_appears_again) {
+            for (auto view : views.span().slice(1))
+                first_code_units->unchecked_append(view.data(), view.length_in_code_units());
+
+            m_utf16_string = first->m_utf16_string.release_value();
+            if (!first->has_utf8_string() && !first->has_byte_string()) {
+                first->m_is_prefix = true;
+                first->m_prefix_length = first_length;
+                first->m_lhs = const_cast<PrimitiveString*>(this);
+                const_cast<PrimitiveString*>(first)->write_barrier();
+            }
+        } else {
+            // Leave some room at the end, so that the next rope starting with this string can append to it in place.
+            Utf16Data code_units;
+            code_units.ensure_capacity(length_in_code_units + length_in_code_units / 4);
+            for (auto view : views)
+                code_units.unchecked_append(view.data(), view.length_in_code_units());
+            m_utf16_string = Utf16String::create(move(code_units));
+        }
 
-        m_utf16_string = Utf16String::create(move(code_units));
         m_is_rope = false;
         m_lhs = nullptr;
         m_rhs = nullptr;
@@ -22,6 +22,7 @@ namespace JS {
 
 class PrimitiveString final : public Cell {
     JS_CELL(PrimitiveString, Cell);
+    JS_CELL_HAS_WRITE_BARRIERS(PrimitiveString);
     JS_DECLARE_ALLOCATOR(PrimitiveString);
 
 public:
@@ -60,15 +61,22 @@ private:
     explicit PrimitiveString(Utf16String);
 
     virtual void visit_edges(Cell::Visitor&) override;
+    virtual void finalize() override;
 
     enum class EncodingPreference {
         UTF8,
         UTF16,
     };
     void resolve_rope_if_needed(EncodingPreference) const;
+    void resolve_prefix() const;
 
     mutable bool m_is_rope { false };
 
+    // When a rope is resolved, it may take over the UTF-16 code units of its first piece to append the other pieces to
+    // them in place. If that piece has no other representation, it's then the first m_prefix_length code units of m_lhs.
+    mutable bool m_is_prefix { false };
+    mutable size_t m_prefix_length { 0 };
+
     mutable GCPtr<PrimitiveString> m_lhs;
     mutable GCPtr<PrimitiveString> m_rhs;
 
@@ -5,6 +5,7 @@
  */
 
 #include <LibJS/Heap/DeferGC.h>
+#include <LibJS/Runtime/Object.h>
 #include <LibJS/Runtime/Shape.h>
 #include <LibJS/Runtime/VM.h>
 
@@ -18,6 +19,7 @@ NonnullGCPtr<Shape> Shape::create_cacheable_dictionary_transition()
     new_shape->m_dictionary = true;
     new_shape->m_cacheable = true;
     new_shape->m_prototype = m_prototype;
+    new_shape->write_barrier();
     ensure_property_table();
     new_shape->ensure_property_table();
     (*new_shape->m_property_table) = *m_property_table;
@@ -31,6 +33,7 @@ NonnullGCPtr<Shape> Shape::create_uncacheable_dictionary_transition()
     new_shape->m_dictionary = true;
     new_shape->m_cacheable = true;
     new_shape->m_prototype = m_prototype;
+    new_shape->write_barrier();
     ensure_property_table();
     new_shape->ensure_property_table();
     (*new_shape->m_property_table) = *m_property_table;
@@ -92,6 +95,7 @@ Shape* Shape::create_put_transition(StringOrSymbol const& property_key, Property
     if (!m_forward_transitions)
         m_forward_transitions = make<HashMap<TransitionKey, WeakPtr<Shape>>>();
     m_forward_transitions->set(key, new_shape.ptr());
+    write_barrier();
     return new_shape;
 }
 
@@ -104,6 +108,7 @@ Shape* Shape::create_configure_transition(StringOrSymbol const& property_key, Pr
     if (!m_forward_transitions)
         m_forward_transitions = make<HashMap<TransitionKey, WeakPtr<Shape>>>();
     m_forward_transitions->set(key, new_shape.ptr());
+    write_barrier();
     return new_shape;
 }
 
@@ -152,6 +157,16 @@ Shape::Shape(Shape& previous_shape, Object* new_prototype)
     , m_property_count(previous_shape.m_property_count)
     , m_transition_type(TransitionType::Prototype)
 {
+    if (m_prototype)
+        m_prototype->set_is_used_as_prototype({});
+}
+
+void Shape::set_prototype_without_transition(Object* new_prototype)
+{
+    m_prototype = new_prototype;
+    write_barrier();
+    if (m_prototype)
+        m_prototype->set_is_used_as_prototype({});
 }
 
 void Shape::visit_edges(Cell::Visitor& visitor)
@@ -248,6 +263,7 @@ NonnullGCPtr<Shape> Shape::create_delete_transition(StringOrSymbol const& proper
     if (!m_delete_transitions)
         m_delete_transitions = make<HashMap<StringOrSymbol, WeakPtr<Shape>>>();
     m_delete_transitions->set(property_key, new_shape.ptr());
+    write_barrier();
     return new_shape;
 }
 
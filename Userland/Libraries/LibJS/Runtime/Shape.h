@@ -38,6 +38,7 @@ class Shape final
     : public Cell
     , public Weakable<Shape> {
     JS_CELL(Shape, Cell);
+    JS_CELL_HAS_WRITE_BARRIERS(Shape);
     JS_DECLARE_ALLOCATOR(Shape);
 
 public:
@@ -85,7 +86,7 @@ public:
         PropertyMetadata value;
     };
 
-    void set_prototype_without_transition(Object* new_prototype) { m_prototype = new_prototype; }
+    void set_prototype_without_transition(Object* new_prototype);
 
 private:
     explicit Shape(Realm&);
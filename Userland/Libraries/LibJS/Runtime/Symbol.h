@@ -14,6 +14,7 @@ namespace JS {
 
 class Symbol final : public Cell {
     JS_CELL(Symbol, Cell);
+    JS_CELL_HAS_WRITE_BARRIERS(Symbol);
     JS_DECLARE_ALLOCATOR(Symbol);
 
 public:
@@ -127,4 +127,12 @@ bool Utf16String::is_empty() const
     return view().is_empty();
 }
 
+Utf16Data* Utf16String::string_for_appending(size_t code_units)
+{
+    auto& string = m_string->mutable_string();
+    if (m_string->ref_count() != 1 || string.capacity() - string.size() < code_units)
+        return nullptr;
+    return &string;
+}
+
 }
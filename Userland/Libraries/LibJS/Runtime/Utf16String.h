@@ -27,6 +27,7 @@ public:
     [[nodiscard]] static NonnullRefPtr<Utf16StringImpl> create(Utf16View const&);
 
     Utf16Data const& string() const;
+    Utf16Data& mutable_string() { return m_string; }
     Utf16View view() const;
 
 private:
@@ -57,6 +58,10 @@ public:
     size_t length_in_code_units() const;
     bool is_empty() const;
 
+    // The code units of this string, to append to in place, if nothing else refers to them and there's room for the given
+    // number of code units. Appending must not reallocate them, as there might still be views of the string.
+    Utf16Data* string_for_appending(size_t code_units);
+
 private:
     explicit Utf16String(NonnullRefPtr<Detail::Utf16StringImpl>);
 
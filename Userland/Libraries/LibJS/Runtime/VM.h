@@ -19,6 +19,7 @@
 #include <LibJS/Heap/Heap.h>
 #include <LibJS/Heap/MarkedVector.h>
 #include <LibJS/ModuleLoading.h>
+#include <LibJS/ProgramCache.h>
 #include <LibJS/Runtime/CommonPropertyNames.h>
 #include <LibJS/Runtime/Completion.h>
 #include <LibJS/Runtime/Error.h>
@@ -75,6 +76,8 @@ public:
         return m_byte_string_cache;
     }
 
+    ProgramCache& program_cache() { return m_program_cache; }
+
     PrimitiveString& empty_string() { return *m_empty_string; }
 
     PrimitiveString& single_ascii_character_string(u8 character)
@@ -182,6 +185,11 @@ public:
     u32 execution_generation() const { return m_execution_generation; }
     void finish_execution_generation() { ++m_execution_generation; }
 
+    // Bumped whenever an object that is used as a prototype changes its shape (or a dictionary shape changes in place),
+    // which invalidates every inline cache entry that was made with an older epoch.
+    u64 shape_epoch() const { return m_shape_epoch; }
+    void bump_shape_epoch() { ++m_shape_epoch; }
+
     ThrowCompletionOr<Reference> resolve_binding(DeprecatedFlyString const&, Environment* = nullptr);
     ThrowCompletionOr<Reference> get_identifier_reference(Environment*, DeprecatedFlyString, bool strict, size_t hops = 0);
 
@@ -320,10 +328,16 @@ private:
 
     Vector<StoredModule> m_loaded_modules;
 
+    // NOTE: This has to be destroyed before the heap, as the cached programs hold handles to their bytecode.
+    ProgramCache m_program_cache;
+
     WellKnownSymbols m_well_known_symbols;
 
     u32 m_execution_generation { 0 };
 
+    // Starts at 1, as cache entries with an epoch of 0 don't depend on it.
+    u64 m_shape_epoch { 1 };
+
     OwnPtr<CustomData> m_custom_data;
 
     OwnPtr<Bytecode::Interpreter> m_bytecode_interpreter;
@@ -5,6 +5,7 @@
  */
 
 #include <LibJS/AST.h>
+#include <LibJS/BytecodeCache.h>
 #include <LibJS/Lexer.h>
 #include <LibJS/Parser.h>
 #include <LibJS/Runtime/VM.h>
@@ -17,15 +18,37 @@ JS_DEFINE_ALLOCATOR(Script);
 // 16.1.5 ParseScript ( sourceText, realm, hostDefined ), https://tc39.es/ecma262/#sec-parse-script
 Result<NonnullGCPtr<Script>, Vector<ParserError>> Script::parse(StringView source_text, Realm& realm, StringView filename, HostDefined* host_defined, size_t line_number_offset)
 {
+    // OPTIMIZATION: Reuse the program (and its bytecode) if we've parsed the same source text before.
+    auto& program_cache = realm.vm().program_cache();
+    if (auto script = program_cache.get(source_text, filename, line_number_offset, ProgramCache::Goal::Script))
+        return create(realm, filename, script.release_nonnull(), host_defined);
+
     // 1. Let script be ParseText(sourceText, Script).
-    auto parser = Parser(Lexer(source_text, filename, line_number_offset));
-    auto script = parser.parse_program();
+    auto script = parse_program(source_text, filename, line_number_offset);
 
     // 2. If script is a List of errors, return body.
+    if (script.is_error())
+        return script.release_error();
+
+    program_cache.set(line_number_offset, ProgramCache::Goal::Script, script.value());
+
+    // 3. Return Script Record { [[Realm]]: realm, [[ECMAScriptCode]]: script, [[HostDefined]]: hostDefined }.
+    return create(realm, filename, script.release_value(), host_defined);
+}
+
+Result<NonnullRefPtr<Program>, Vector<ParserError>> Script::parse_program(StringView source_text, StringView filename, size_t line_number_offset)
+{
+    auto parser = Parser(Lexer(source_text, filename, line_number_offset));
+    parser.enable_function_preparsing();
+    auto script = parser.parse_program();
     if (parser.has_errors())
         return parser.errors();
+    BytecodeCache::attach(script);
+    return script;
+}
 
-    // 3. Return Script Record { [[Realm]]: realm, [[ECMAScriptCode]]: script, [[HostDefined]]: hostDefined }.
+NonnullGCPtr<Script> Script::create(Realm& realm, StringView filename, NonnullRefPtr<Program> script, HostDefined* host_defined)
+{
     return realm.heap().allocate_without_realm<Script>(realm, filename, move(script), host_defined);
 }
 
@@ -29,6 +29,12 @@ public:
     virtual ~Script() override;
     static Result<NonnullGCPtr<Script>, Vector<ParserError>> parse(StringView source_text, Realm&, StringView filename = {}, HostDefined* = nullptr, size_t line_number_offset = 1);
 
+    // Parsing doesn't touch the VM or its heap, so parse_program() can be called ahead of time and on any thread
+    // (e.g. on a background thread while the rest of a document is still loading). create() and running the
+    // program must happen on the thread that owns the realm.
+    static Result<NonnullRefPtr<Program>, Vector<ParserError>> parse_program(StringView source_text, StringView filename = {}, size_t line_number_offset = 1);
+    static NonnullGCPtr<Script> create(Realm&, StringView filename, NonnullRefPtr<Program>, HostDefined* = nullptr);
+
     Realm& realm() { return *m_realm; }
     Program const& parse_node() const { return *m_parse_node; }
     Vector<ModuleWithSpecifier>& loaded_modules() { return m_loaded_modules; }
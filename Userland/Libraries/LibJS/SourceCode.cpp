@@ -6,6 +6,8 @@
 
 #include <AK/BinarySearch.h>
 #include <AK/Utf8View.h>
+#include <LibJS/AST.h>
+#include <LibJS/BytecodeCache.h>
 #include <LibJS/SourceCode.h>
 #include <LibJS/SourceRange.h>
 #include <LibJS/Token.h>
@@ -23,6 +25,49 @@ SourceCode::SourceCode(String filename, String code)
 {
 }
 
+SourceCode::~SourceCode() = default;
+
+static u64 node_key(SourceCode::NodeKind kind, u32 start_offset)
+{
+    return (static_cast<u64>(kind) << 32) | start_offset;
+}
+
+void SourceCode::register_node(NodeKind kind, ASTNode const& node) const
+{
+    if (!BytecodeCache::is_enabled())
+        return;
+    m_nodes.ensure(node_key(kind, node.start_offset())).append(&node);
+}
+
+void SourceCode::unregister_node(NodeKind kind, ASTNode const& node) const
+{
+    if (m_nodes.is_empty())
+        return;
+    auto it = m_nodes.find(node_key(kind, node.start_offset()));
+    if (it == m_nodes.end())
+        return;
+    it->value.remove_first_matching([&](auto const* registered_node) { return registered_node == &node; });
+    if (it->value.is_empty())
+        m_nodes.remove(it);
+}
+
+ASTNode const* SourceCode::find_node(NodeKind kind, u32 start_offset, u32 end_offset) const
+{
+    auto it = m_nodes.find(node_key(kind, start_offset));
+    if (it == m_nodes.end())
+        return nullptr;
+    for (size_t i = it->value.size(); i > 0; --i) {
+        if (it->value[i - 1]->end_offset() == end_offset)
+            return it->value[i - 1];
+    }
+    return nullptr;
+}
+
+void SourceCode::set_bytecode_cache(NonnullRefPtr<BytecodeCache> bytecode_cache) const
+{
+    m_bytecode_cache = move(bytecode_cache);
+}
+
 String const& SourceCode::filename() const
 {
     return m_filename;
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <LibJS/Forward.h>
@@ -16,18 +17,38 @@ namespace JS {
 class SourceCode : public RefCounted<SourceCode> {
 public:
     static NonnullRefPtr<SourceCode const> create(String filename, String code);
+    ~SourceCode();
 
     String const& filename() const;
     String const& code() const;
 
     SourceRange range_from_offsets(u32 start_offset, u32 end_offset) const;
 
+    // The AST nodes that bytecode refers to. Bytecode loaded from the bytecode cache finds them by their offsets.
+    enum class NodeKind : u8 {
+        FunctionExpression,
+        ClassExpression,
+        Scope,
+    };
+    void register_node(NodeKind, ASTNode const&) const;
+    void unregister_node(NodeKind, ASTNode const&) const;
+    ASTNode const* find_node(NodeKind, u32 start_offset, u32 end_offset) const;
+
+    // Only the source code of scripts and modules has a bytecode cache, see BytecodeCache::attach().
+    BytecodeCache* bytecode_cache() const { return m_bytecode_cache.ptr(); }
+    void set_bytecode_cache(NonnullRefPtr<BytecodeCache>) const;
+
 private:
     SourceCode(String filename, String code);
 
     String m_filename;
     String m_code;
 
+    // Keyed by the kind and the start offset, as the end offset of a node is only known once it's been parsed. When the
+    // same function is parsed again (see Parser::finish_parsing_function()), the node that was registered last comes last.
+    HashMap<u64, Vector<ASTNode const*, 1>> mutable m_nodes;
+    RefPtr<BytecodeCache> mutable m_bytecode_cache;
+
     // For fast mapping of offsets to line/column numbers, we build a list of
     // starting points (with byte offsets into the source string) and which
     // line:column they map to. This can then be binary-searched.
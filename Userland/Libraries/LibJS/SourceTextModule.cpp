@@ -8,6 +8,7 @@
 #include <AK/Debug.h>
 #include <AK/QuickSort.h>
 #include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/BytecodeCache.h>
 #include <LibJS/Parser.h>
 #include <LibJS/Runtime/AsyncFunctionDriverWrapper.h>
 #include <LibJS/Runtime/ECMAScriptFunctionObject.h>
@@ -124,15 +125,40 @@ void SourceTextModule::visit_edges(Cell::Visitor& visitor)
 }
 
 // 16.2.1.6.1 ParseModule ( sourceText, realm, hostDefined ), https://tc39.es/ecma262/#sec-parsemodule
-Result<NonnullGCPtr<SourceTextModule>, Vector<ParserError>> SourceTextModule::parse(StringView source_text, Realm& realm, StringView filename, Script::HostDefined* host_defined)
+Result<NonnullGCPtr<SourceTextModule>, Vector<ParserError>> SourceTextModule::parse(StringView source_text, Realm& realm, StringView filename, Script::HostDefined* host_defined, size_t line_number_offset)
 {
-    // 1. Let body be ParseText(sourceText, Module).
-    auto parser = Parser(Lexer(source_text, filename), Program::Type::Module);
-    auto body = parser.parse_program();
+    // OPTIMIZATION: Reuse the program (and its bytecode) if we've parsed the same source text before.
+    auto& program_cache = realm.vm().program_cache();
+    auto body = program_cache.get(source_text, filename, line_number_offset, ProgramCache::Goal::Module);
+    if (!body) {
+        // 1. Let body be ParseText(sourceText, Module).
+        auto parsed_body = parse_program(source_text, filename, line_number_offset);
+
+        // 2. If body is a List of errors, return body.
+        if (parsed_body.is_error())
+            return parsed_body.release_error();
+
+        body = parsed_body.release_value();
+        program_cache.set(line_number_offset, ProgramCache::Goal::Module, *body);
+    }
 
-    // 2. If body is a List of errors, return body.
+    return create(realm, filename, body.release_nonnull(), host_defined);
+}
+
+Result<NonnullRefPtr<Program>, Vector<ParserError>> SourceTextModule::parse_program(StringView source_text, StringView filename, size_t line_number_offset)
+{
+    auto parser = Parser(Lexer(source_text, filename, line_number_offset), Program::Type::Module);
+    parser.enable_function_preparsing();
+    auto body = parser.parse_program();
     if (parser.has_errors())
         return parser.errors();
+    BytecodeCache::attach(body);
+    return body;
+}
+
+NonnullGCPtr<SourceTextModule> SourceTextModule::create(Realm& realm, StringView filename, NonnullRefPtr<Program> body, Script::HostDefined* host_defined)
+{
+    VERIFY(body->type() == Program::Type::Module);
 
     // 3. Let requestedModules be the ModuleRequests of body.
     auto requested_modules = module_requests(*body);
@@ -498,7 +524,7 @@ ThrowCompletionOr<void> SourceTextModule::initialize_environment(VM& vm)
                 DeprecatedFlyString function_name = function_declaration.name();
                 if (function_name == ExportStatement::local_name_for_default)
                     function_name = "default"sv;
-                auto function = ECMAScriptFunctionObject::create(realm(), function_name, function_declaration.source_text(), function_declaration.body(), function_declaration.parameters(), function_declaration.function_length(), function_declaration.local_variables_names(), environment, private_environment, function_declaration.kind(), function_declaration.is_strict_mode(), function_declaration.might_need_arguments_object(), function_declaration.contains_direct_call_to_eval());
+                auto function = ECMAScriptFunctionObject::create(realm(), function_name, function_declaration, environment, private_environment);
 
                 // 2. Perform ! env.InitializeBinding(dn, fo, normal).
                 MUST(environment->initialize_binding(vm, name, function, Environment::InitializeBindingHint::Normal));
@@ -711,7 +737,14 @@ ThrowCompletionOr<void> SourceTextModule::execute_module(VM& vm, GCPtr<PromiseCa
         // c. Let result be the result of evaluating module.[[ECMAScriptCode]].
         Completion result;
 
-        auto maybe_executable = Bytecode::compile(vm, m_ecmascript_code, {}, FunctionKind::Normal, "ShadowRealmEval"sv);
+        // NOTE: The bytecode is kept on the module body, which may be shared by modules with the same source text (see ProgramCache).
+        ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> maybe_executable = [&]() -> ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> {
+            if (auto* executable = m_ecmascript_code->bytecode_executable())
+                return NonnullGCPtr { *executable };
+            auto executable = TRY(Bytecode::compile(vm, m_ecmascript_code, {}, FunctionKind::Normal, "ShadowRealmEval"sv));
+            m_ecmascript_code->set_bytecode_executable(executable);
+            return executable;
+        }();
         if (maybe_executable.is_error())
             result = maybe_executable.release_error();
         else {
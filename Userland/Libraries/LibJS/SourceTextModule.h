@@ -19,7 +19,11 @@ class SourceTextModule final : public CyclicModule {
     JS_DECLARE_ALLOCATOR(SourceTextModule);
 
 public:
-    static Result<NonnullGCPtr<SourceTextModule>, Vector<ParserError>> parse(StringView source_text, Realm&, StringView filename = {}, Script::HostDefined* host_defined = nullptr);
+    static Result<NonnullGCPtr<SourceTextModule>, Vector<ParserError>> parse(StringView source_text, Realm&, StringView filename = {}, Script::HostDefined* host_defined = nullptr, size_t line_number_offset = 1);
+
+    // Like Script::parse_program(), these split parsing (which can happen on any thread) from creating the module record.
+    static Result<NonnullRefPtr<Program>, Vector<ParserError>> parse_program(StringView source_text, StringView filename = {}, size_t line_number_offset = 1);
+    static NonnullGCPtr<SourceTextModule> create(Realm&, StringView filename, NonnullRefPtr<Program> body, Script::HostDefined* host_defined = nullptr);
 
     Program const& parse_node() const { return *m_ecmascript_code; }
 
@@ -0,0 +1,108 @@
+// Arrays keep track of what kind of elements they have (all int32s, all numbers, no holes), and some code takes shortcuts
+// based on that, so these change the kind of arrays in between operations that look at it.
+
+test("Element kinds change with the elements", () => {
+    const array = [1, 2, 3];
+    expect(array.indexOf(2)).toBe(1);
+    expect(array.indexOf(2.5)).toBe(-1);
+    expect(array.indexOf("2")).toBe(-1);
+
+    array[1] = 2.5;
+    expect(array.indexOf(2.5)).toBe(1);
+    expect(array.indexOf(3)).toBe(2);
+    expect(array.indexOf(-0)).toBe(-1);
+
+    array.push("3");
+    expect(array.indexOf("3")).toBe(3);
+    expect(array.indexOf(3)).toBe(2);
+
+    delete array[0];
+    expect(array.indexOf(undefined)).toBe(-1);
+    Array.prototype[0] = "from prototype";
+    expect(array.indexOf("from prototype")).toBe(0);
+    expect(array[0]).toBe("from prototype");
+    expect(array.map(value => value)).toEqual(["from prototype", 2.5, 3, "3"]);
+    delete Array.prototype[0];
+
+    array.length = 0;
+    array.push(0);
+    expect(array.indexOf(-0)).toBe(0);
+    expect(array.indexOf(NaN)).toBe(-1);
+});
+
+test("Pushing elements", () => {
+    const array = [];
+    for (let i = 0; i < 100; ++i) expect(array.push(i, i + 0.5)).toBe(2 * (i + 1));
+    expect(array[199]).toBe(99.5);
+
+    const nonExtensible = [1];
+    Object.preventExtensions(nonExtensible);
+    expect(() => nonExtensible.push(2)).toThrow(TypeError);
+
+    const fixedLength = [1];
+    Object.defineProperty(fixedLength, "length", { writable: false });
+    expect(() => fixedLength.push(2)).toThrow(TypeError);
+    expect(fixedLength).toEqual([1]);
+
+    let setterValue;
+    Object.defineProperty(Array.prototype, 1, {
+        set(value) {
+            setterValue = value;
+        },
+        configurable: true,
+    });
+    const intercepted = [1];
+    intercepted.push(2);
+    expect(setterValue).toBe(2);
+    expect(Object.hasOwn(intercepted, 1)).toBeFalse();
+    delete Array.prototype[1];
+});
+
+test("Mapping arrays that change underneath", () => {
+    const array = [1, 2, 3, 4];
+    const mapped = array.map((value, index) => {
+        if (index === 0) array[2] = "changed";
+        if (index === 1) array.length = 3;
+        return value * 2;
+    });
+    expect(mapped).toEqual([2, 4, NaN, undefined]);
+    expect(3 in mapped).toBeFalse();
+    expect(mapped.length).toBe(4);
+
+    const holey = [1, , 3];
+    expect(holey.map(value => value)).toEqual([1, undefined, 3]);
+    expect(1 in holey.map(value => value)).toBeFalse();
+});
+
+test("Sorting", () => {
+    const numbers = [10, 9, 1, -1, -10, 100, -2147483648, 2147483647, 0, -0, 2];
+    expect(numbers.slice().sort()).toEqual([-1, -10, -2147483648, 0, -0, 1, 10, 100, 2, 2147483647, 9]);
+    expect(numbers.slice().sort((a, b) => a - b)).toEqual([-2147483648, -10, -1, 0, -0, 1, 2, 9, 10, 100, 2147483647]);
+    expect([3, 2.5, "10", 1].sort()).toEqual([1, "10", 2.5, 3]);
+
+    const array = [3, 1, 2];
+    expect(() =>
+        array.sort((a, b) => {
+            Object.freeze(array);
+            return a - b;
+        })
+    ).toThrow(TypeError);
+    expect(array).toEqual([3, 1, 2]);
+});
+
+test("Assignments by index", () => {
+    const array = [1, 2, 3];
+    for (let i = 0; i < 3; ++i) array[i] = array[i] * 1.5;
+    expect(array).toEqual([1.5, 3, 4.5]);
+    array[5] = "far";
+    expect(array[4]).toBeUndefined();
+    expect(array[5]).toBe("far");
+
+    const frozen = Object.freeze([1, 2, 3]);
+    const assign = (array, index, value) => {
+        array[index] = value;
+    };
+    assign(array, 0, 0);
+    assign(frozen, 0, 0);
+    expect(frozen[0]).toBe(1);
+});
@@ -0,0 +1,110 @@
+// The bytecode optimizer reads copies from their source and lets registers share slots, which must not change what
+// values are observed across loops, exception handlers, finalizers, and suspension points.
+
+test("Copies are not read after their source was overwritten", () => {
+    let a = 1;
+    let b = a;
+    a = 2;
+    expect(b).toBe(1);
+
+    let x = 0;
+    let y = x++;
+    expect(x).toBe(1);
+    expect(y).toBe(0);
+
+    let values = [];
+    for (let i = 0; i < 3; ++i) {
+        let copy = i;
+        values.push(() => copy);
+    }
+    expect(values.map(f => f())).toEqual([0, 1, 2]);
+});
+
+test("Values stay alive across exception handlers and finalizers", () => {
+    function f(n) {
+        const seen = [];
+        for (let i = 0; i < n; ++i) {
+            const before = i * 10;
+            try {
+                if (i === 1) continue;
+                if (i === 2) throw before + 1;
+                if (i === 3) break;
+                seen.push(before);
+            } catch (e) {
+                seen.push(e, before);
+            } finally {
+                seen.push(`finally ${before}`);
+            }
+        }
+        return seen;
+    }
+    expect(f(5)).toEqual([0, "finally 0", "finally 10", 21, 20, "finally 20", "finally 30"]);
+
+    function g() {
+        const value = "kept";
+        try {
+            return value;
+        } finally {
+            value + "dropped";
+        }
+    }
+    expect(g()).toBe("kept");
+});
+
+test("Values stay alive across yield and await", async () => {
+    function* generator() {
+        const a = 1;
+        const b = yield a;
+        const c = a + b;
+        yield c;
+        return a + b + c;
+    }
+    const iterator = generator();
+    expect(iterator.next().value).toBe(1);
+    expect(iterator.next(2).value).toBe(3);
+    expect(iterator.next().value).toBe(6);
+
+    async function f() {
+        const a = 5;
+        const b = await a;
+        return a + b;
+    }
+    let result;
+    f().then(value => {
+        result = value;
+    });
+    runQueuedPromiseJobs();
+    expect(result).toBe(10);
+});
+
+test("Array literals with many elements and spreads", () => {
+    const a = 1;
+    const b = [2, 3];
+    expect([a, ...b, a + 3, ...b, a]).toEqual([1, 2, 3, 4, 2, 3, 1]);
+    expect([a, a, a, a, a, a, a, a].length).toBe(8);
+});
+
+test("Blocks that only declare locals", () => {
+    function f() {
+        let result = 0;
+        {
+            let a = 1;
+            const b = 2;
+            result = a + b;
+        }
+        switch (result) {
+            case 3:
+                let c = result * 2;
+                result = c;
+        }
+        return result;
+    }
+    expect(f()).toBe(6);
+
+    expect(() => {
+        {
+            use;
+            let use = 1;
+        }
+    }).toThrow(ReferenceError);
+});
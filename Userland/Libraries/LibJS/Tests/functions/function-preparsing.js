@@ -0,0 +1,172 @@
+// Functions in scripts are only checked for syntax errors at first, and parsed again the first time they are needed.
+// Parsing one again must give the same results as parsing it together with everything around it.
+
+var globalValue = "global";
+
+function outer(value) {
+    var captured = value;
+    function inner(extra) {
+        function innermost() {
+            return captured + extra + globalValue;
+        }
+        return innermost;
+    }
+    return inner;
+}
+
+test("Closures and globals", () => {
+    expect(outer("a")("b")()).toBe("abglobal");
+    globalValue = "changed";
+    expect(outer("c")("d")()).toBe("cdchanged");
+    globalValue = "global";
+});
+
+test("Source text", () => {
+    function withComments(/* a */ a, b = `${a}}`) {
+        // }
+        return "}" + a + b;
+    }
+    expect(withComments.toString()).toBe(`function withComments(/* a */ a, b = \`\${a}}\`) {
+        // }
+        return "}" + a + b;
+    }`);
+    expect(withComments(1)).toBe("}11}");
+
+    const object = {
+        method() {
+            return function () {};
+        },
+        async *generator() {},
+    };
+    expect(object.method.toString()).toBe("method() {\n            return function () {};\n        }");
+    expect(object.method().toString()).toBe("function () {}");
+    expect(object.generator.toString()).toBe("async *generator() {}");
+});
+
+test("Functions followed by things that depend on the token before them", () => {
+    const divided = function () {
+        return 10;
+    } / 2;
+    expect(divided).toBeNaN();
+
+    const inTemplate = `${(function () {
+        return `${"{"}nested${"}"}`;
+    })()}!`;
+    expect(inTemplate).toBe("{nested}!");
+});
+
+test("With statements and eval around functions", () => {
+    const object = { property: "from object" };
+    let property = "from scope";
+    with (object) {
+        var getProperty = function () {
+            return property;
+        };
+    }
+    expect(getProperty()).toBe("from object");
+
+    function declaresWithEval() {
+        eval("var injected = 'injected'");
+        return function () {
+            return injected;
+        };
+    }
+    expect(declaresWithEval()()).toBe("injected");
+
+    function shadowsGlobalWithEval() {
+        eval("var globalValue = 'shadowed'");
+        return (function () {
+            return function () {
+                return globalValue;
+            };
+        })()();
+    }
+    expect(shadowsGlobalWithEval()).toBe("shadowed");
+});
+
+test("Strict mode is inherited", () => {
+    function strict() {
+        "use strict";
+        return function () {
+            return this;
+        };
+    }
+    expect(strict()()).toBeUndefined();
+
+    function sloppy() {
+        return function () {
+            return this;
+        };
+    }
+    expect(sloppy()()).toBe(globalThis);
+});
+
+test("Arguments, parameters and names", () => {
+    function withArguments(a, b) {
+        return function (c) {
+            return arguments.length + a + b + c;
+        };
+    }
+    expect(withArguments(1, 2)(3, 4)).toBe(8);
+
+    const named = function recursive(n) {
+        return n === 0 ? recursive.name : recursive(n - 1);
+    };
+    expect(named(3)).toBe("recursive");
+    expect(named.length).toBe(1);
+
+    function defaults(a, { b } = { b: 2 }, ...rest) {
+        return function () {
+            return a + b + rest.length;
+        };
+    }
+    expect(defaults(1)()).toBe(3);
+});
+
+test("Error positions", () => {
+    function throwsLater() {
+        return function () {
+            throw new Error();
+        };
+    }
+    let stack;
+    try {
+        throwsLater()();
+    } catch (e) {
+        stack = e.stack;
+    }
+    expect(stack.includes("function-preparsing.js:129:19")).toBeTrue();
+});
+
+test("Closures are only parsed once they are called", () => {
+    // NOTE: Functions shorter than 128 bytes are parsed right away, the comments make sure these ones are preparsed.
+    function makeClosures(prefix) {
+        // This comment is only here to make the function long enough to be preparsed.
+        return {
+            sum: function sum(a, b, c = 3) {
+                // This comment is only here to make the function long enough to be preparsed.
+                return prefix + (a + b + c);
+            },
+            constructed: function constructed(value) {
+                // This comment is only here to make the function long enough to be preparsed.
+                this.value = prefix + value;
+            },
+            generator: function* generator() {
+                // This comment is only here to make the function long enough to be preparsed.
+                yield prefix;
+            },
+        };
+    }
+
+    const closures = makeClosures("x");
+    expect(closures.sum.name).toBe("sum");
+    expect(closures.sum.length).toBe(2);
+    expect(closures.sum.toString().startsWith("function sum(a, b, c = 3) {")).toBeTrue();
+    expect(closures.sum(1, 2)).toBe("x6");
+
+    const object = new closures.constructed("y");
+    expect(object.value).toBe("xy");
+    expect(object).toBeInstanceOf(closures.constructed);
+
+    expect(Array.from(closures.generator())).toEqual(["x"]);
+});
@@ -0,0 +1,126 @@
+// These loops run long enough for their functions to be compiled to machine code partway through, so the results
+// have to be the same before and after.
+
+test("Int32 arithmetic overflows into doubles", () => {
+    let sum = 0;
+    let product = 1;
+    for (let i = 0; i < 5000; ++i) {
+        sum += 1000000;
+        if (i < 40) product *= 3;
+    }
+    expect(sum).toBe(5000000000);
+    expect(product).toBe(3 ** 40);
+
+    let counter = 2147483647 - 2500;
+    for (let i = 0; i < 5000; ++i) counter++;
+    expect(counter).toBe(2147483647 + 2500);
+
+    let down = -2147483648 + 2500;
+    for (let i = 0; i < 5000; ++i) down--;
+    expect(down).toBe(-2147483648 - 2500);
+});
+
+test("Comparisons and equality of mixed types", () => {
+    const values = [0, -0, 1, 1.5, "1", NaN, null, undefined, true, false, {}, [], 2147483647];
+    const counts = { less: 0, strict: 0, loose: 0, not: 0 };
+    for (let round = 0; round < 200; ++round) {
+        for (const a of values) {
+            for (const b of values) {
+                if (a < b) counts.less++;
+                if (a === b) counts.strict++;
+                if (a == b) counts.loose++;
+                if (!a) counts.not++;
+            }
+        }
+    }
+    expect(counts.less / 200).toBe(34);
+    expect(counts.strict / 200).toBe(14);
+    expect(counts.loose / 200).toBe(32);
+    expect(counts.not / 200).toBe(78);
+});
+
+test("Bitwise operations", () => {
+    let value = 0;
+    for (let i = 0; i < 5000; ++i) value = ((value ^ i) | (i << 3)) & 0x7fffffff;
+    expect(value).toBe(65528);
+    let negative = -1;
+    for (let i = 0; i < 5000; ++i) negative = negative & ~(1 << (i % 31));
+    expect(negative).toBe(-2147483648);
+});
+
+test("Property access through changing shapes", () => {
+    function Point(x, y) {
+        this.x = x;
+        this.y = y;
+    }
+    const points = [];
+    for (let i = 0; i < 3000; ++i) points.push(new Point(i, -i));
+    points.push({ y: 1, x: 2 });
+    points.push({ get x() { return 10; }, y: 0 });
+    points.push([1, 2, 3]);
+
+    let sum = 0;
+    for (let round = 0; round < 2; ++round) {
+        for (const point of points) {
+            sum += point.x ?? point.length;
+            point.y = point.x;
+        }
+    }
+    expect(sum).toBe(2 * (4498500 + 2 + 10 + 3));
+    expect(points[2999].y).toBe(2999);
+    expect(points[3000].y).toBe(2);
+});
+
+test("Exceptions and finally blocks in hot code", () => {
+    let caught = 0;
+    let finalized = 0;
+    function maybeThrow(i) {
+        if (i % 7 === 0) throw new Error(`error ${i}`);
+        return i;
+    }
+    for (let i = 0; i < 5000; ++i) {
+        try {
+            maybeThrow(i);
+        } catch (e) {
+            caught++;
+        } finally {
+            finalized++;
+        }
+    }
+    expect(caught).toBe(715);
+    expect(finalized).toBe(5000);
+
+    function returnsFromFinally(i) {
+        try {
+            if (i % 2) return "try";
+        } finally {
+            if (i % 3 === 0) return "finally";
+        }
+        return "end";
+    }
+    const results = { try: 0, finally: 0, end: 0 };
+    for (let i = 0; i < 3000; ++i) results[returnsFromFinally(i)]++;
+    expect(results).toEqual({ try: 1000, finally: 1000, end: 1000 });
+
+    expect(() => {
+        for (let i = 0; i < 5000; ++i) {
+            if (i === 4999) null.foo;
+        }
+    }).toThrowWithMessage(TypeError, 'Cannot access property "foo" on null object');
+});
+
+test("Generators and calls", () => {
+    function* counter(limit) {
+        for (let i = 0; i < limit; ++i) yield i;
+    }
+    let sum = 0;
+    for (const i of counter(5000)) sum += i;
+    expect(sum).toBe(12497500);
+
+    function add(a, b) {
+        return a + b;
+    }
+    let total = 0;
+    for (let i = 0; i < 5000; ++i) total = add(total, i);
+    expect(total).toBe(12497500);
+});
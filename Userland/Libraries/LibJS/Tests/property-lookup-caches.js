@@ -0,0 +1,139 @@
+// Property lookups and assignments remember what they found for objects of a given shape, so these run the same code
+// with objects that share shapes, and then change them (or their prototypes) behind the caches' back.
+
+function getX(object) {
+    return object.x;
+}
+
+function setX(object, value) {
+    object.x = value;
+}
+
+test("Sites that see many shapes", () => {
+    const objects = [];
+    for (let i = 0; i < 10; ++i) {
+        const object = {};
+        object[`padding${i}`] = i;
+        object.x = i;
+        objects.push(object);
+    }
+    for (let round = 0; round < 3; ++round) {
+        for (let i = 0; i < objects.length; ++i) {
+            expect(getX(objects[i])).toBe(i + round * 100);
+            setX(objects[i], i + (round + 1) * 100);
+        }
+    }
+});
+
+test("Properties in the prototype chain", () => {
+    const base = { x: "base" };
+    const middle = Object.create(base);
+    const object = Object.create(middle);
+    for (let i = 0; i < 3; ++i) expect(getX(object)).toBe("base");
+
+    middle.x = "middle";
+    expect(getX(object)).toBe("middle");
+
+    delete middle.x;
+    expect(getX(object)).toBe("base");
+
+    base.x = "changed";
+    expect(getX(object)).toBe("changed");
+
+    Object.setPrototypeOf(middle, { x: "other" });
+    expect(getX(object)).toBe("other");
+
+    Object.defineProperty(Object.getPrototypeOf(middle), "x", { get: () => "getter" });
+    expect(getX(object)).toBe("getter");
+});
+
+test("Methods of class instances", () => {
+    class A {
+        method() {
+            return "A";
+        }
+    }
+    class B extends A {}
+    const call = object => object.method();
+    const b = new B();
+    for (let i = 0; i < 3; ++i) expect(call(b)).toBe("A");
+
+    B.prototype.method = () => "B";
+    expect(call(b)).toBe("B");
+
+    b.method = () => "own";
+    expect(call(b)).toBe("own");
+});
+
+test("Adding properties", () => {
+    function make() {
+        const object = {};
+        setX(object, 1);
+        return object;
+    }
+    const objects = [make(), make(), make()];
+    for (const object of objects) expect(Object.keys(object)).toEqual(["x"]);
+
+    const frozen = {};
+    Object.preventExtensions(frozen);
+    setX(frozen, 1);
+    expect(frozen.x).toBeUndefined();
+
+    let setterValue;
+    Object.defineProperty(Object.prototype, "x", {
+        set(value) {
+            setterValue = value;
+        },
+        configurable: true,
+    });
+    const object = {};
+    setX(object, 2);
+    expect(setterValue).toBe(2);
+    expect(Object.hasOwn(object, "x")).toBeFalse();
+    delete Object.prototype.x;
+
+    Object.defineProperty(Object.prototype, "x", { value: 3, writable: false, configurable: true });
+    const another = {};
+    setX(another, 4);
+    expect(Object.hasOwn(another, "x")).toBeFalse();
+    delete Object.prototype.x;
+});
+
+test("Assignments to frozen objects with many properties", () => {
+    const object = {};
+    for (let i = 0; i < 100; ++i) object[`property${i}`] = i;
+    object.x = 1;
+    setX(object, 2);
+    setX(object, 3);
+    Object.freeze(object);
+    setX(object, 4);
+    expect(object.x).toBe(3);
+});
+
+test("Exotic objects with the same shape as ordinary ones", () => {
+    const object = {};
+    expect(object.toString()).toBe("[object Object]");
+    const proxy = new Proxy(
+        {},
+        {
+            get(target, property) {
+                return `trapped ${property}`;
+            },
+        }
+    );
+    const getToString = object => object.toString;
+    getToString(object);
+    getToString(object);
+    expect(getToString(proxy)).toBe("trapped toString");
+
+    const arrayLike = Object.create(Array.prototype);
+    const setLength = (object, value) => {
+        object.length = value;
+    };
+    setLength(arrayLike, 5);
+    setLength(arrayLike, 5);
+    const array = [1, 2, 3];
+    setLength(array, 1);
+    expect(array).toEqual([1]);
+    expect(Object.getOwnPropertyNames(array)).toEqual(["0", "length"]);
+});
@@ -158,9 +158,9 @@ static bool restore_string_position(MatchInput const& input, MatchState& state)
     return true;
 }
 
-OwnPtr<OpCode> ByteCode::s_opcodes[(size_t)OpCodeId::Last + 1];
-bool ByteCode::s_opcodes_initialized { false };
-size_t ByteCode::s_next_checkpoint_serial_id { 0 };
+thread_local OwnPtr<OpCode> ByteCode::s_opcodes[(size_t)OpCodeId::Last + 1];
+thread_local bool ByteCode::s_opcodes_initialized { false };
+thread_local size_t ByteCode::s_next_checkpoint_serial_id { 0 };
 
 void ByteCode::ensure_opcodes_initialized()
 {
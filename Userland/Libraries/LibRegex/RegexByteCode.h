@@ -532,9 +532,10 @@ private:
 
     void ensure_opcodes_initialized();
     ALWAYS_INLINE OpCode& get_opcode_by_id(OpCodeId id) const;
-    static OwnPtr<OpCode> s_opcodes[(size_t)OpCodeId::Last + 1];
-    static bool s_opcodes_initialized;
-    static size_t s_next_checkpoint_serial_id;
+    // NOTE: These are per thread, as regexes may be compiled and run on several threads (e.g. while a script is parsed off the main thread).
+    static thread_local OwnPtr<OpCode> s_opcodes[(size_t)OpCodeId::Last + 1];
+    static thread_local bool s_opcodes_initialized;
+    static thread_local size_t s_next_checkpoint_serial_id;
 };
 
 #define ENUMERATE_EXECUTION_RESULTS                          \
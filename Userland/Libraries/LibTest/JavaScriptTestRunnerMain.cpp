@@ -8,6 +8,8 @@
 
 #include <LibCore/ArgsParser.h>
 #include <LibFileSystem/FileSystem.h>
+#include <LibJS/Bytecode/Optimizer.h>
+#include <LibJS/JIT/Compiler.h>
 #include <LibTest/JavaScriptTestRunner.h>
 #include <signal.h>
 #include <stdio.h>
@@ -92,6 +94,10 @@ int main(int argc, char** argv)
 #endif
     bool print_json = false;
     bool per_file = false;
+    bool disable_jit = false;
+    bool print_jit_statistics = false;
+    bool disable_bytecode_optimizer = false;
+    bool print_bytecode_optimizer_statistics = false;
     StringView specified_test_root;
     ByteString common_path;
     ByteString test_glob;
@@ -118,6 +124,10 @@ int main(int argc, char** argv)
     args_parser.add_option(per_file, "Show detailed per-file results as JSON (implies -j)", "per-file");
     args_parser.add_option(g_collect_on_every_allocation, "Collect garbage after every allocation", "collect-often", 'g');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(disable_jit, "Disable the JIT compiler", "disable-jit");
+    args_parser.add_option(print_jit_statistics, "Print JIT statistics after running the tests", "jit-statistics");
+    args_parser.add_option(disable_bytecode_optimizer, "Disable the bytecode optimizer", "disable-bytecode-optimizer");
+    args_parser.add_option(print_bytecode_optimizer_statistics, "Print bytecode optimizer statistics after running the tests", "bytecode-optimizer-statistics");
     args_parser.add_option(test_glob, "Only run tests matching the given glob", "filter", 'f', "glob");
     for (auto& entry : g_extra_args)
         args_parser.add_option(*entry.key, entry.value.get<0>().characters(), entry.value.get<1>().characters(), entry.value.get<2>());
@@ -128,6 +138,11 @@ int main(int argc, char** argv)
     if (per_file)
         print_json = true;
 
+    if (disable_jit)
+        JS::JIT::Compiler::set_enabled(false);
+    if (disable_bytecode_optimizer)
+        JS::Bytecode::Optimizer::set_enabled(false);
+
     test_glob = ByteString::formatted("*{}*", test_glob);
 
     if (getenv("DISABLE_DBG_OUTPUT")) {
@@ -200,6 +215,11 @@ int main(int argc, char** argv)
     Test::JS::TestRunner test_runner(test_root, common_path, print_times, print_progress, print_json, per_file);
     test_runner.run(test_glob);
 
+    if (print_jit_statistics)
+        JS::JIT::Compiler::dump_statistics();
+    if (print_bytecode_optimizer_statistics)
+        JS::Bytecode::Optimizer::dump_statistics();
+
     g_vm = nullptr;
 
     return test_runner.counts().tests_failed > 0 ? 1 : 0;
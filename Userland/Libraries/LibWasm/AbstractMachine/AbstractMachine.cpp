@@ -9,10 +9,15 @@
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Interpreter.h>
 #include <LibWasm/AbstractMachine/Validator.h>
+#include <LibWasm/JIT/Compiler.h>
 #include <LibWasm/Types.h>
+#include <sys/mman.h>
 
 namespace Wasm {
 
+Store::Store() = default;
+Store::~Store() = default;
+
 Optional<FunctionAddress> Store::allocate(ModuleInstance& module, Module::Function const& function)
 {
     FunctionAddress address { m_functions.size() };
@@ -112,6 +117,85 @@ ElementInstance* Store::get(ElementAddress address)
     return &m_elements[value];
 }
 
+void Store::add_native_module(NonnullOwnPtr<JIT::NativeModule> native_module)
+{
+    m_native_modules.append(move(native_module));
+}
+
+ErrorOr<MemoryInstance> MemoryInstance::create(MemoryType const& type)
+{
+    MemoryInstance instance { type };
+
+#ifdef AK_ARCH_64_BIT
+    // Only the pages the memory grows into are ever made accessible, the rest of the reservation just takes up address
+    // space. If that's too much to ask for, the memory lives in an ordinary buffer instead.
+    auto* reservation = mmap(nullptr, Constants::guarded_memory_reservation_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reservation != MAP_FAILED) {
+        instance.m_reservation = reservation;
+        instance.m_data = ByteBuffer::create_with_external_storage({ reservation, Constants::max_memory_size });
+    }
+#endif
+
+    if (!instance.grow(type.limits().min() * Constants::page_size))
+        return Error::from_string_literal("Failed to grow to requested size");
+
+    return { move(instance) };
+}
+
+MemoryInstance::MemoryInstance(MemoryInstance&& other)
+    : successful_grow_hook(move(other.successful_grow_hook))
+    , m_type(other.m_type)
+    , m_size(exchange(other.m_size, 0))
+    , m_data(move(other.m_data))
+    , m_reservation(exchange(other.m_reservation, nullptr))
+{
+}
+
+MemoryInstance::~MemoryInstance()
+{
+    if (m_reservation)
+        munmap(m_reservation, Constants::guarded_memory_reservation_size);
+}
+
+bool MemoryInstance::grow(size_t size_to_grow, InhibitGrowCallback inhibit_callback)
+{
+    if (size_to_grow == 0)
+        return true;
+    u64 new_size = m_data.size() + size_to_grow;
+    // Can't grow past 2^16 pages.
+    if (new_size >= Constants::page_size * 65536)
+        return false;
+    if (auto max = m_type.limits().max(); max.has_value()) {
+        if (max.value() * Constants::page_size < new_size)
+            return false;
+    }
+    auto previous_size = m_size;
+    if (m_reservation) {
+        // Growing only makes more of the reservation accessible, so the data stays where it is.
+        auto committed_size = round_up_to_power_of_two(previous_size, Constants::page_size);
+        auto new_committed_size = round_up_to_power_of_two(new_size, Constants::page_size);
+        if (new_committed_size > committed_size && mprotect(static_cast<u8*>(m_reservation) + committed_size, new_committed_size - committed_size, PROT_READ | PROT_WRITE) < 0)
+            return false;
+        m_data.resize(new_size);
+        m_size = new_size;
+        // Pages that just became accessible are zeroed already, only what's left of the last page may not be.
+        __builtin_memset(m_data.offset_pointer(previous_size), 0, min<u64>(new_size, committed_size) - previous_size);
+    } else {
+        if (m_data.try_resize(new_size).is_error())
+            return false;
+        m_size = new_size;
+        // The spec requires that we zero out everything on grow
+        __builtin_memset(m_data.offset_pointer(previous_size), 0, size_to_grow);
+    }
+
+    // NOTE: This exists because wasm-js-api wants to execute code after a successful grow,
+    //       See [this issue](https://github.com/WebAssembly/spec/issues/1635) for more details.
+    if (inhibit_callback == InhibitGrowCallback::No && successful_grow_hook)
+        successful_grow_hook();
+
+    return true;
+}
+
 DataInstance* Store::get(DataAddress address)
 {
     auto value = address.value();
@@ -380,6 +464,17 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
         }
     });
 
+    if (!instantiation_result.has_value()) {
+        if (auto native_module = JIT::Compiler::compile(m_store, main_module_instance, m_should_limit_instruction_count)) {
+            auto& functions = main_module_instance.functions();
+            for (size_t i = 0; i < functions.size(); ++i) {
+                if (native_module->has_code_for(i))
+                    m_store.get(functions[i])->get<WasmFunction>().set_native_code(*native_module, i);
+            }
+            m_store.add_native_module(native_module.release_nonnull());
+        }
+    }
+
     module.for_each_section_of_type<StartSection>([&](StartSection const& section) {
         auto& functions = main_module_instance.functions();
         auto index = section.function().index();
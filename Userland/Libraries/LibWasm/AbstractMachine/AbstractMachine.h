@@ -23,6 +23,10 @@ namespace Wasm {
 class Configuration;
 struct Interpreter;
 
+namespace JIT {
+class NativeModule;
+}
+
 struct InstantiationError {
     ByteString error { "Unknown error" };
 };
@@ -344,10 +348,21 @@ public:
     auto& module() const { return m_module; }
     auto& code() const { return m_code; }
 
+    // The machine code for this function, if it was compiled.
+    auto* native_module() const { return m_native_module; }
+    auto native_function_index() const { return m_native_function_index; }
+    void set_native_code(JIT::NativeModule const& native_module, size_t function_index)
+    {
+        m_native_module = &native_module;
+        m_native_function_index = function_index;
+    }
+
 private:
     FunctionType m_type;
     ModuleInstance const& m_module;
     Module::Function const& m_code;
+    JIT::NativeModule const* m_native_module { nullptr };
+    size_t m_native_function_index { 0 };
 };
 
 class HostFunction {
@@ -403,53 +418,29 @@ private:
 };
 
 class MemoryInstance {
-public:
-    static ErrorOr<MemoryInstance> create(MemoryType const& type)
-    {
-        MemoryInstance instance { type };
+    AK_MAKE_NONCOPYABLE(MemoryInstance);
 
-        if (!instance.grow(type.limits().min() * Constants::page_size))
-            return Error::from_string_literal("Failed to grow to requested size");
+public:
+    static ErrorOr<MemoryInstance> create(MemoryType const& type);
 
-        return { move(instance) };
-    }
+    MemoryInstance(MemoryInstance&&);
+    ~MemoryInstance();
 
     auto& type() const { return m_type; }
     auto size() const { return m_size; }
     auto& data() const { return m_data; }
     auto& data() { return m_data; }
 
+    // Whether the memory lives at the start of a reservation of Constants::guarded_memory_reservation_size bytes, where
+    // everything past its size faults when accessed. Such a memory never moves when it grows.
+    bool has_guard_pages() const { return m_reservation != nullptr; }
+
     enum class InhibitGrowCallback {
         No,
         Yes,
     };
 
-    bool grow(size_t size_to_grow, InhibitGrowCallback inhibit_callback = InhibitGrowCallback::No)
-    {
-        if (size_to_grow == 0)
-            return true;
-        u64 new_size = m_data.size() + size_to_grow;
-        // Can't grow past 2^16 pages.
-        if (new_size >= Constants::page_size * 65536)
-            return false;
-        if (auto max = m_type.limits().max(); max.has_value()) {
-            if (max.value() * Constants::page_size < new_size)
-                return false;
-        }
-        auto previous_size = m_size;
-        if (m_data.try_resize(new_size).is_error())
-            return false;
-        m_size = new_size;
-        // The spec requires that we zero out everything on grow
-        __builtin_memset(m_data.offset_pointer(previous_size), 0, size_to_grow);
-
-        // NOTE: This exists because wasm-js-api wants to execute code after a successful grow,
-        //       See [this issue](https://github.com/WebAssembly/spec/issues/1635) for more details.
-        if (inhibit_callback == InhibitGrowCallback::No && successful_grow_hook)
-            successful_grow_hook();
-
-        return true;
-    }
+    bool grow(size_t size_to_grow, InhibitGrowCallback inhibit_callback = InhibitGrowCallback::No);
 
     Function<void()> successful_grow_hook;
 
@@ -462,6 +453,7 @@ private:
     MemoryType m_type;
     size_t m_size { 0 };
     ByteBuffer m_data;
+    void* m_reservation { nullptr };
 };
 
 class GlobalInstance {
@@ -520,7 +512,8 @@ private:
 
 class Store {
 public:
-    Store() = default;
+    Store();
+    ~Store();
 
     Optional<FunctionAddress> allocate(ModuleInstance& module, Module::Function const& function);
     Optional<FunctionAddress> allocate(HostFunction&&);
@@ -537,6 +530,8 @@ public:
     DataInstance* get(DataAddress);
     ElementInstance* get(ElementAddress);
 
+    void add_native_module(NonnullOwnPtr<JIT::NativeModule>);
+
 private:
     Vector<FunctionInstance> m_functions;
     Vector<TableInstance> m_tables;
@@ -544,6 +539,7 @@ private:
     Vector<GlobalInstance> m_globals;
     Vector<ElementInstance> m_elements;
     Vector<DataInstance> m_datas;
+    Vector<NonnullOwnPtr<JIT::NativeModule>> m_native_modules;
 };
 
 class Label {
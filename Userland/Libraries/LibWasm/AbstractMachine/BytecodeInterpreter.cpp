@@ -668,6 +668,10 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         TRAP_IF_NOT(element.has_value());
         TRAP_IF_NOT(element->ref().has<Reference::Func>());
         auto address = element->ref().get<Reference::Func>().address;
+        auto const& type_actual = configuration.store().get(address)->visit([](auto& function) -> FunctionType const& { return function.type(); });
+        auto const& type_expected = configuration.frame().module().types()[args.type.value()];
+        TRAP_IF_NOT(type_actual.parameters() == type_expected.parameters());
+        TRAP_IF_NOT(type_actual.results() == type_expected.results());
         dbgln_if(WASM_TRACE_DEBUG, "call_indirect({} -> {})", index.value(), address.value());
         call_address(configuration, address);
         return;
@@ -787,7 +791,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         };
 
         for (auto i = 0; i < count; ++i) {
-            store_to_memory(configuration, synthetic_store_instruction, { &value, sizeof(value) }, destination_offset);
+            store_to_memory(configuration, synthetic_store_instruction, { &value, sizeof(value) }, destination_offset + i);
         }
         return;
     }
@@ -99,6 +99,9 @@ struct DebuggerBytecodeInterpreter : public BytecodeInterpreter {
     }
     virtual ~DebuggerBytecodeInterpreter() override = default;
 
+    // Hooks have to see every instruction, so nothing can run as machine code while there are any.
+    virtual bool can_run_native_code() const override { return !pre_interpret_hook && !post_interpret_hook; }
+
     Function<bool(Configuration&, InstructionPointer&, Instruction const&)> pre_interpret_hook;
     Function<bool(Configuration&, InstructionPointer&, Instruction const&, Interpreter const&)> post_interpret_hook;
 
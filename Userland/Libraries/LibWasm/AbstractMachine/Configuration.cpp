@@ -7,6 +7,7 @@
 #include <AK/MemoryStream.h>
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Interpreter.h>
+#include <LibWasm/JIT/NativeModule.h>
 #include <LibWasm/Printer/Printer.h>
 
 namespace Wasm {
@@ -43,6 +44,9 @@ Result Configuration::call(Interpreter& interpreter, FunctionAddress address, Ve
     if (!function)
         return Trap {};
     if (auto* wasm_function = function->get_pointer<WasmFunction>()) {
+        if (auto* native_module = wasm_function->native_module(); native_module && interpreter.can_run_native_code())
+            return native_module->call(*this, interpreter, wasm_function->native_function_index(), wasm_function->type(), move(arguments));
+
         Vector<Value> locals = move(arguments);
         locals.ensure_capacity(locals.size() + wasm_function->code().locals().size());
         for (auto& type : wasm_function->code().locals())
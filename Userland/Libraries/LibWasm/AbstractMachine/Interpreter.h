@@ -16,6 +16,9 @@ struct Interpreter {
     virtual bool did_trap() const = 0;
     virtual ByteString trap_reason() const = 0;
     virtual void clear_trap() = 0;
+
+    // Whether functions that were compiled to machine code may run as such, instead of being interpreted.
+    virtual bool can_run_native_code() const { return true; }
 };
 
 }
@@ -37,6 +37,13 @@ static constexpr auto extern_global_tag = 0x03;
 
 static constexpr auto page_size = 64 * KiB;
 
+// Memories can't grow to 2^16 pages, and this is past their end.
+static constexpr u64 max_memory_size = 4 * GiB;
+
+// How much address space a memory reserves, so that any 32-bit address plus 32-bit offset lands either in the memory or
+// on pages that fault when accessed.
+static constexpr u64 guarded_memory_reservation_size = 8 * GiB + page_size;
+
 // Implementation-defined limits
 // These are not concretely defined by the spec, so the values are only defined by us.
 static constexpr auto minimum_stack_space_to_keep_free = 256 * KiB; // Note: Value is arbitrary and chosen by testing with ASAN
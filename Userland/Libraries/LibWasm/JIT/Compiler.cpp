@@ -0,0 +1,1630 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Debug.h>
+#include <AK/Format.h>
+#include <AK/SIMDExtras.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <LibJIT/Assembler.h>
+#include <LibJIT/GDB.h>
+#include <LibWasm/AbstractMachine/Configuration.h>
+#include <LibWasm/AbstractMachine/Interpreter.h>
+#include <LibWasm/AbstractMachine/Operators.h>
+#include <LibWasm/JIT/Compiler.h>
+#include <LibWasm/JIT/NativeModule.h>
+#include <LibWasm/Opcode.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+namespace Wasm::JIT {
+
+static Optional<bool> s_enabled;
+static Compiler::Statistics s_statistics;
+
+bool Compiler::is_enabled()
+{
+#ifdef JIT_ARCH_SUPPORTED
+    if (!s_enabled.has_value()) {
+        auto const* value = getenv("LIBWASM_JIT");
+#    ifdef AK_OS_SERENITY
+        // Making memory executable needs the prot_exec promise, which most programs don't pledge.
+        s_enabled = value && StringView { value, strlen(value) } == "1"sv;
+#    else
+        s_enabled = !value || StringView { value, strlen(value) } != "0"sv;
+#    endif
+    }
+    return *s_enabled;
+#else
+    return false;
+#endif
+}
+
+void Compiler::set_enabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+Compiler::Statistics& Compiler::statistics()
+{
+    return s_statistics;
+}
+
+void Compiler::dump_statistics()
+{
+    auto const& statistics = s_statistics;
+    warnln("Wasm JIT statistics:");
+    warnln("    Compiled functions: {} in {} modules ({} refused)", statistics.compiled_functions, statistics.compiled_modules, statistics.refused_functions);
+    warnln("    Machine code: {} bytes, compiled in {} ms", statistics.code_size, statistics.compile_time.to_milliseconds());
+    warnln("    Calls into machine code: {}, calls out of it: {}", statistics.native_calls, statistics.calls_out_of_native_code);
+}
+
+#ifdef JIT_ARCH_SUPPORTED
+
+using Assembler = ::JIT::Assembler;
+using Context = NativeModule::Context;
+using Status = NativeModule::Status;
+
+namespace {
+
+// Machine code keeps these in callee-saved registers, so that they survive calls into C++.
+constexpr auto CONTEXT = Assembler::Reg::RBX;
+constexpr auto FRAME = Assembler::Reg::R14;
+constexpr auto MEMORY_BASE = Assembler::Reg::R15;
+constexpr auto MEMORY_SIZE = Assembler::Reg::R12;
+
+constexpr auto ARG0 = Assembler::Reg::RDI;
+constexpr auto ARG1 = Assembler::Reg::RSI;
+constexpr auto ARG2 = Assembler::Reg::RDX;
+constexpr auto ARG3 = Assembler::Reg::RCX;
+constexpr auto ARG4 = Assembler::Reg::R8;
+constexpr auto RET = Assembler::Reg::RAX;
+
+// Scratch registers that don't outlive a single instruction. Variable shift counts have to be in GPR1.
+constexpr auto GPR0 = Assembler::Reg::RAX;
+constexpr auto GPR1 = Assembler::Reg::RCX;
+
+// Values at the top of the operand stack live in these. They're all caller-saved, so every value goes back to its slot
+// before anything is called.
+constexpr Array stack_registers {
+    Assembler::Reg::RSI,
+    Assembler::Reg::RDI,
+    Assembler::Reg::RDX,
+    Assembler::Reg::R8,
+    Assembler::Reg::R9,
+    Assembler::Reg::R10,
+    Assembler::Reg::R11,
+};
+
+template<typename T>
+T from_slot(u64 slot)
+{
+    if constexpr (IsSame<T, float>)
+        return bit_cast<float>(static_cast<u32>(slot));
+    else if constexpr (IsSame<T, double>)
+        return bit_cast<double>(slot);
+    else
+        return static_cast<T>(slot);
+}
+
+template<typename T>
+u64 to_slot(T value)
+{
+    if constexpr (IsSame<T, float>)
+        return bit_cast<u32>(value);
+    else if constexpr (IsSame<T, double>)
+        return bit_cast<u64>(value);
+    else if constexpr (sizeof(T) <= sizeof(u32))
+        return static_cast<u32>(value);
+    else
+        return static_cast<u64>(value);
+}
+
+u64 trap(Context& context, StringView reason)
+{
+    *context.trap = Result { Trap { reason } };
+    return to_underlying(Status::Trapped);
+}
+
+// Operations that can't trap return their result, the others return a status like compiled functions do and leave
+// their result in the context.
+template<typename PopT, typename PushT, typename Operator>
+u64 cxx_unary_operation(u64 value)
+{
+    PushT result = Operator {}(from_slot<PopT>(value));
+    return to_slot(result);
+}
+
+template<typename PopT, typename PushT, typename Operator>
+u64 cxx_checked_unary_operation(Context& context, u64 value)
+{
+    auto result = Operator {}(from_slot<PopT>(value));
+    if (result.is_error())
+        return trap(context, result.error());
+    PushT pushed = result.release_value();
+    context.result = to_slot(pushed);
+    return 0;
+}
+
+template<typename PopT, typename PushT, typename Operator>
+u64 cxx_binary_operation(u64 lhs, u64 rhs)
+{
+    PushT result = Operator {}(from_slot<PopT>(lhs), from_slot<PopT>(rhs));
+    return to_slot(result);
+}
+
+template<typename PopT, typename PushT, typename Operator>
+u64 cxx_checked_binary_operation(Context& context, u64 lhs, u64 rhs)
+{
+    auto result = Operator {}(from_slot<PopT>(lhs), from_slot<PopT>(rhs));
+    if (result.is_error())
+        return trap(context, result.error());
+    PushT pushed = result.release_value();
+    context.result = to_slot(pushed);
+    return 0;
+}
+
+// Calls any function the way the interpreter does, with the arguments in slots, and leaves the results in their place.
+u64 call_through_configuration(Context& context, FunctionAddress address, u64* arguments)
+{
+    auto& configuration = *context.configuration;
+    auto* function = configuration.store().get(address);
+    if (!function)
+        return trap(context, "Call to a function that doesn't exist"sv);
+
+    FunctionType const* type { nullptr };
+    function->visit([&](auto const& function) { type = &function.type(); });
+
+    Vector<Value> values;
+    values.ensure_capacity(type->parameters().size());
+    for (size_t i = 0; i < type->parameters().size(); ++i)
+        values.unchecked_append(NativeModule::value_from_slot(type->parameters()[i], arguments[i]));
+
+    // Machine code that runs from here on puts its frames above the caller's.
+    auto& value_stack = NativeModule::value_stack();
+    auto* previous_top = value_stack.top;
+    value_stack.top = arguments;
+
+    ++s_statistics.calls_out_of_native_code;
+    Result result { Trap { ""sv } };
+    {
+        Configuration::CallFrameHandle handle { configuration };
+        result = configuration.call(*context.interpreter, address, move(values));
+    }
+    value_stack.top = previous_top;
+
+    // The callee may have grown the memory.
+    context.module->refresh_memory(context);
+
+    if (result.is_trap() || result.is_completion()) {
+        *context.trap = move(result);
+        return to_underlying(Status::Trapped);
+    }
+
+    // The results come last first.
+    auto const& results = result.values();
+    for (size_t i = 0; i < results.size(); ++i)
+        arguments[i] = NativeModule::slot_from_value(results[results.size() - i - 1]);
+    return 0;
+}
+
+u64 cxx_call(Context& context, u64 address, u64* arguments)
+{
+    return call_through_configuration(context, FunctionAddress { address }, arguments);
+}
+
+u64 cxx_call_indirect(Context& context, u64 table_address, FunctionType const& type, u64 index, u64* arguments)
+{
+    auto& store = context.configuration->store();
+    auto* table = store.get(TableAddress { table_address });
+    auto element_index = static_cast<u32>(index);
+    if (element_index >= table->elements().size())
+        return trap(context, "Indirect call to an element outside of the table"sv);
+
+    auto const& element = table->elements()[element_index];
+    if (!element.has_value() || !element->ref().has<Reference::Func>())
+        return trap(context, "Indirect call to a null element"sv);
+
+    auto address = element->ref().get<Reference::Func>().address;
+    auto* function = store.get(address);
+    if (!function)
+        return trap(context, "Call to a function that doesn't exist"sv);
+
+    // Frames of compiled functions depend on the callee's type, so unlike the interpreter this can't let a mismatch slide.
+    FunctionType const* callee_type { nullptr };
+    function->visit([&](auto const& function) { callee_type = &function.type(); });
+    if (callee_type->parameters() != type.parameters() || callee_type->results() != type.results())
+        return trap(context, "Indirect call to a function of the wrong type"sv);
+
+    if (auto* wasm_function = function->get_pointer<WasmFunction>(); wasm_function && wasm_function->native_module() == context.module)
+        return context.module->run(context, wasm_function->native_function_index(), arguments);
+    return call_through_configuration(context, address, arguments);
+}
+
+u64 cxx_global_get(Context& context, u64 address)
+{
+    return NativeModule::slot_from_value(context.configuration->store().get(GlobalAddress { address })->value());
+}
+
+void cxx_global_set(Context& context, u64 address, u64 value)
+{
+    auto* global = context.configuration->store().get(GlobalAddress { address });
+    global->set_value(NativeModule::value_from_slot(global->type().type(), value));
+}
+
+u64 cxx_memory_grow(Context& context, u64 pages)
+{
+    auto* memory = context.module->memory(*context.configuration);
+    auto old_pages = static_cast<i32>(memory->size() / Constants::page_size);
+    auto grown = memory->grow(static_cast<u64>(static_cast<u32>(pages)) * Constants::page_size);
+    context.module->refresh_memory(context);
+    return to_slot(grown ? old_pages : -1);
+}
+
+u64 cxx_memory_fill(Context& context, u64 destination, u64 value, u64 count)
+{
+    auto offset = static_cast<u64>(static_cast<u32>(destination));
+    auto size = static_cast<u64>(static_cast<u32>(count));
+    if (offset + size > context.memory_size)
+        return to_underlying(Status::OutOfBoundsMemoryAccess);
+    memset(context.memory_base + offset, static_cast<u8>(value), size);
+    return 0;
+}
+
+u64 cxx_memory_copy(Context& context, u64 destination, u64 source, u64 count)
+{
+    auto destination_offset = static_cast<u64>(static_cast<u32>(destination));
+    auto source_offset = static_cast<u64>(static_cast<u32>(source));
+    auto size = static_cast<u64>(static_cast<u32>(count));
+    if (destination_offset + size > context.memory_size || source_offset + size > context.memory_size)
+        return to_underlying(Status::OutOfBoundsMemoryAccess);
+    memmove(context.memory_base + destination_offset, context.memory_base + source_offset, size);
+    return 0;
+}
+
+// Instructions that call the operators the interpreter uses: name, popped type, pushed type and operator.
+#define WASM_ENUMERATE_UNARY_OPERATIONS_WITH_RUNTIME_CALLS(O)         \
+    O(i32_clz, i32, i32, CountLeadingZeros)                           \
+    O(i32_ctz, i32, i32, CountTrailingZeros)                          \
+    O(i32_popcnt, i32, i32, PopCount)                                 \
+    O(i64_clz, i64, i64, CountLeadingZeros)                           \
+    O(i64_ctz, i64, i64, CountTrailingZeros)                          \
+    O(i64_popcnt, i64, i64, PopCount)                                 \
+    O(f32_abs, float, float, Absolute)                                \
+    O(f32_neg, float, float, Negate)                                  \
+    O(f32_ceil, float, float, Ceil)                                   \
+    O(f32_floor, float, float, Floor)                                 \
+    O(f32_trunc, float, float, Truncate)                              \
+    O(f32_nearest, float, float, NearbyIntegral)                      \
+    O(f32_sqrt, float, float, SquareRoot)                             \
+    O(f64_abs, double, double, Absolute)                              \
+    O(f64_neg, double, double, Negate)                                \
+    O(f64_ceil, double, double, Ceil)                                 \
+    O(f64_floor, double, double, Floor)                               \
+    O(f64_trunc, double, double, Truncate)                            \
+    O(f64_nearest, double, double, NearbyIntegral)                    \
+    O(f64_sqrt, double, double, SquareRoot)                           \
+    O(i32_trunc_sf32, float, i32, CheckedTruncate<i32>)               \
+    O(i32_trunc_uf32, float, i32, CheckedTruncate<u32>)               \
+    O(i32_trunc_sf64, double, i32, CheckedTruncate<i32>)              \
+    O(i32_trunc_uf64, double, i32, CheckedTruncate<u32>)              \
+    O(i64_trunc_sf32, float, i64, CheckedTruncate<i64>)               \
+    O(i64_trunc_uf32, float, i64, CheckedTruncate<u64>)               \
+    O(i64_trunc_sf64, double, i64, CheckedTruncate<i64>)              \
+    O(i64_trunc_uf64, double, i64, CheckedTruncate<u64>)              \
+    O(f32_convert_si32, i32, float, Convert<float>)                   \
+    O(f32_convert_ui32, u32, float, Convert<float>)                   \
+    O(f32_convert_si64, i64, float, Convert<float>)                   \
+    O(f32_convert_ui64, u64, float, Convert<float>)                   \
+    O(f32_demote_f64, double, float, Demote)                          \
+    O(f64_convert_si32, i32, double, Convert<double>)                 \
+    O(f64_convert_ui32, u32, double, Convert<double>)                 \
+    O(f64_convert_si64, i64, double, Convert<double>)                 \
+    O(f64_convert_ui64, u64, double, Convert<double>)                 \
+    O(f64_promote_f32, float, double, Promote)                        \
+    O(i32_extend8_s, i32, i32, SignExtend<i8>)                        \
+    O(i32_extend16_s, i32, i32, SignExtend<i16>)                      \
+    O(i64_extend8_s, i64, i64, SignExtend<i8>)                        \
+    O(i64_extend16_s, i64, i64, SignExtend<i16>)                      \
+    O(i32_trunc_sat_f32_s, float, i32, SaturatingTruncate<i32>)       \
+    O(i32_trunc_sat_f32_u, float, i32, SaturatingTruncate<u32>)       \
+    O(i32_trunc_sat_f64_s, double, i32, SaturatingTruncate<i32>)      \
+    O(i32_trunc_sat_f64_u, double, i32, SaturatingTruncate<u32>)      \
+    O(i64_trunc_sat_f32_s, float, i64, SaturatingTruncate<i64>)       \
+    O(i64_trunc_sat_f32_u, float, i64, SaturatingTruncate<u64>)       \
+    O(i64_trunc_sat_f64_s, double, i64, SaturatingTruncate<i64>)      \
+    O(i64_trunc_sat_f64_u, double, i64, SaturatingTruncate<u64>)
+
+#define WASM_ENUMERATE_BINARY_OPERATIONS_WITH_RUNTIME_CALLS(O) \
+    O(i32_divs, i32, i32, Divide)                              \
+    O(i32_divu, u32, i32, Divide)                              \
+    O(i32_rems, i32, i32, Modulo)                              \
+    O(i32_remu, u32, i32, Modulo)                              \
+    O(i32_rotl, u32, i32, BitRotateLeft)                       \
+    O(i32_rotr, u32, i32, BitRotateRight)                      \
+    O(i64_divs, i64, i64, Divide)                              \
+    O(i64_divu, u64, i64, Divide)                              \
+    O(i64_rems, i64, i64, Modulo)                              \
+    O(i64_remu, u64, i64, Modulo)                              \
+    O(i64_rotl, u64, i64, BitRotateLeft)                       \
+    O(i64_rotr, u64, i64, BitRotateRight)                      \
+    O(f32_eq, float, i32, Equals)                              \
+    O(f32_ne, float, i32, NotEquals)                           \
+    O(f32_lt, float, i32, LessThan)                            \
+    O(f32_gt, float, i32, GreaterThan)                         \
+    O(f32_le, float, i32, LessThanOrEquals)                    \
+    O(f32_ge, float, i32, GreaterThanOrEquals)                 \
+    O(f64_eq, double, i32, Equals)                             \
+    O(f64_ne, double, i32, NotEquals)                          \
+    O(f64_lt, double, i32, LessThan)                           \
+    O(f64_gt, double, i32, GreaterThan)                        \
+    O(f64_le, double, i32, LessThanOrEquals)                   \
+    O(f64_ge, double, i32, GreaterThanOrEquals)                \
+    O(f32_add, float, float, Add)                              \
+    O(f32_sub, float, float, Subtract)                         \
+    O(f32_mul, float, float, Multiply)                         \
+    O(f32_div, float, float, Divide)                           \
+    O(f32_min, float, float, Minimum)                          \
+    O(f32_max, float, float, Maximum)                          \
+    O(f32_copysign, float, float, CopySign)                    \
+    O(f64_add, double, double, Add)                            \
+    O(f64_sub, double, double, Subtract)                       \
+    O(f64_mul, double, double, Multiply)                       \
+    O(f64_div, double, double, Divide)                         \
+    O(f64_min, double, double, Minimum)                        \
+    O(f64_max, double, double, Maximum)                        \
+    O(f64_copysign, double, double, CopySign)
+
+// Instructions that compile_instruction() turns into machine code without looking any further.
+#define WASM_ENUMERATE_INLINE_INSTRUCTIONS(O) \
+    O(unreachable)                            \
+    O(nop)                                    \
+    O(br)                                     \
+    O(br_if)                                  \
+    O(br_table)                               \
+    O(return_)                                \
+    O(drop)                                   \
+    O(select)                                 \
+    O(local_get)                              \
+    O(local_set)                              \
+    O(local_tee)                              \
+    O(i32_const)                              \
+    O(i64_const)                              \
+    O(f32_const)                              \
+    O(f64_const)                              \
+    O(i32_eqz)                                \
+    O(i32_eq)                                 \
+    O(i32_ne)                                 \
+    O(i32_lts)                                \
+    O(i32_ltu)                                \
+    O(i32_gts)                                \
+    O(i32_gtu)                                \
+    O(i32_les)                                \
+    O(i32_leu)                                \
+    O(i32_ges)                                \
+    O(i32_geu)                                \
+    O(i64_eqz)                                \
+    O(i64_eq)                                 \
+    O(i64_ne)                                 \
+    O(i64_lts)                                \
+    O(i64_ltu)                                \
+    O(i64_gts)                                \
+    O(i64_gtu)                                \
+    O(i64_les)                                \
+    O(i64_leu)                                \
+    O(i64_ges)                                \
+    O(i64_geu)                                \
+    O(i32_add)                                \
+    O(i32_sub)                                \
+    O(i32_mul)                                \
+    O(i32_and)                                \
+    O(i32_or)                                 \
+    O(i32_xor)                                \
+    O(i32_shl)                                \
+    O(i32_shrs)                               \
+    O(i32_shru)                               \
+    O(i64_add)                                \
+    O(i64_sub)                                \
+    O(i64_mul)                                \
+    O(i64_and)                                \
+    O(i64_or)                                 \
+    O(i64_xor)                                \
+    O(i64_shl)                                \
+    O(i64_shrs)                               \
+    O(i64_shru)                               \
+    O(i32_wrap_i64)                           \
+    O(i64_extend_si32)                        \
+    O(i64_extend_ui32)                        \
+    O(i64_extend32_s)                         \
+    O(i32_reinterpret_f32)                    \
+    O(i64_reinterpret_f64)                    \
+    O(f32_reinterpret_i32)                    \
+    O(f64_reinterpret_i64)                    \
+    O(structured_else)                        \
+    O(structured_end)
+
+class NativeCodeGenerator {
+public:
+    NativeCodeGenerator(Store& store, ModuleInstance const& module, bool limit_instruction_count)
+        : m_store(store)
+        , m_module(module)
+        , m_limit_instruction_count(limit_instruction_count)
+    {
+        auto function_count = module.functions().size();
+        m_functions.resize(function_count);
+        m_function_labels.resize(function_count);
+        m_entry_points.resize(function_count);
+
+        if (!module.memories().is_empty()) {
+            auto* memory = store.get(module.memories().first());
+            m_memory_has_guard_pages = memory->has_guard_pages() && NativeModule::install_fault_handler();
+        }
+    }
+
+    void generate()
+    {
+        // Which functions get compiled has to be known up front, so that calls between them can be direct.
+        for (size_t i = 0; i < m_module.functions().size(); ++i) {
+            auto* function = m_store.get(m_module.functions()[i])->get_pointer<WasmFunction>();
+            if (!function || &function->module() != &m_module)
+                continue;
+            if (can_compile(*function))
+                m_functions[i] = function;
+            else
+                ++m_refused_functions;
+        }
+
+        for (size_t i = 0; i < m_functions.size(); ++i) {
+            if (m_functions[i]) {
+                compile_function(i, *m_functions[i]);
+                ++m_compiled_functions;
+            }
+        }
+
+        // Every function has the same prologue, so they can all leave through the same epilogue.
+        emit_exit(m_unreachable_label, Status::Unreachable);
+        m_out_of_bounds_handler = m_output.size();
+        emit_exit(m_out_of_bounds_label, Status::OutOfBoundsMemoryAccess);
+        emit_exit(m_stack_overflow_label, Status::StackOverflow);
+        emit_exit(m_fuel_exhausted_label, Status::ExceededInstructionLimit);
+
+        m_return_label.link(m_assembler);
+        m_assembler.mov(reg(RET), imm(to_underlying(Status::Ok)));
+        m_exit_label.link(m_assembler);
+        m_assembler.exit();
+    }
+
+    Vector<u8>& output() { return m_output; }
+    Vector<Optional<size_t>>& entry_points() { return m_entry_points; }
+    size_t compiled_functions() const { return m_compiled_functions; }
+    size_t refused_functions() const { return m_refused_functions; }
+    size_t out_of_bounds_handler() const { return m_out_of_bounds_handler; }
+
+private:
+    struct StackEntry {
+        enum class Kind {
+            // The value is in its slot in the frame.
+            Slot,
+            Register,
+            Constant,
+        };
+
+        Kind kind { Kind::Slot };
+        Assembler::Reg reg { Assembler::Reg::RAX };
+        u64 constant { 0 };
+    };
+
+    struct ControlFrame {
+        enum class Kind {
+            Block,
+            Loop,
+            If,
+            Function,
+        };
+
+        Kind kind { Kind::Block };
+
+        // The height of the operand stack below the block's parameters.
+        size_t height { 0 };
+        size_t parameter_count { 0 };
+        size_t result_count { 0 };
+
+        // The end of the block, or its start for loops.
+        Assembler::Label label {};
+        Assembler::Label else_label {};
+        bool has_else { false };
+
+        size_t branch_arity() const { return kind == Kind::Loop ? parameter_count : result_count; }
+    };
+
+    struct BlockSignature {
+        size_t parameter_count { 0 };
+        size_t result_count { 0 };
+    };
+
+    enum class Width {
+        Bits32,
+        Bits64,
+    };
+
+    static Assembler::Operand reg(Assembler::Reg reg) { return Assembler::Operand::Register(reg); }
+    static Assembler::Operand imm(u64 value) { return Assembler::Operand::Imm(value); }
+    static Assembler::Operand mem(Assembler::Reg base, u64 offset) { return Assembler::Operand::Mem64BaseAndOffset(base, offset); }
+
+    static Assembler::Condition invert(Assembler::Condition condition)
+    {
+        // The condition codes come in pairs that only differ in the lowest bit.
+        return static_cast<Assembler::Condition>(to_underlying(condition) ^ 1);
+    }
+
+    Assembler::Operand local(size_t index) const { return mem(FRAME, index * sizeof(u64)); }
+    Assembler::Operand slot(size_t index) const { return mem(FRAME, (m_local_count + index) * sizeof(u64)); }
+    Assembler::Operand context(size_t offset) const { return mem(CONTEXT, offset); }
+
+    FunctionType const& function_type(FunctionAddress address) const
+    {
+        return m_store.get(address)->visit([](auto const& function) -> FunctionType const& { return function.type(); });
+    }
+
+    BlockSignature signature_of(BlockType const& block_type) const
+    {
+        switch (block_type.kind()) {
+        case BlockType::Empty:
+            return { 0, 0 };
+        case BlockType::Type:
+            return { 0, 1 };
+        case BlockType::Index: {
+            auto const& type = m_module.types()[block_type.type_index().value()];
+            return { type.parameters().size(), type.results().size() };
+        }
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    static bool is_numeric(FunctionType const& type)
+    {
+        return all_of(type.parameters(), [](auto const& type) { return type.is_numeric(); })
+            && all_of(type.results(), [](auto const& type) { return type.is_numeric(); });
+    }
+
+    bool can_compile(WasmFunction const& function) const
+    {
+        if (!is_numeric(function.type()))
+            return false;
+        if (!all_of(function.code().locals(), [](auto const& type) { return type.is_numeric(); }))
+            return false;
+        return all_of(function.code().body().instructions(), [&](auto const& instruction) { return can_compile(instruction); });
+    }
+
+    bool can_compile(Instruction const& instruction) const
+    {
+        auto const& arguments = instruction.arguments();
+        switch (instruction.opcode().value()) {
+        case Instructions::block.value():
+        case Instructions::loop.value():
+        case Instructions::if_.value(): {
+            auto const& block_type = arguments.get<Instruction::StructuredInstructionArgs>().block_type;
+            if (block_type.kind() == BlockType::Type)
+                return block_type.value_type().is_numeric();
+            if (block_type.kind() == BlockType::Index)
+                return is_numeric(m_module.types()[block_type.type_index().value()]);
+            return true;
+        }
+        case Instructions::call.value():
+            return is_numeric(function_type(m_module.functions()[arguments.get<FunctionIndex>().value()]));
+        case Instructions::call_indirect.value():
+            return is_numeric(m_module.types()[arguments.get<Instruction::IndirectCallArgs>().type.value()]);
+        case Instructions::global_get.value():
+        case Instructions::global_set.value():
+            return m_store.get(m_module.globals()[arguments.get<GlobalIndex>().value()])->type().type().is_numeric();
+        case Instructions::select_typed.value():
+            return all_of(arguments.get<Vector<ValueType>>(), [](auto const& type) { return type.is_numeric(); });
+        case Instructions::i32_load.value():
+        case Instructions::i64_load.value():
+        case Instructions::f32_load.value():
+        case Instructions::f64_load.value():
+        case Instructions::i32_load8_s.value():
+        case Instructions::i32_load8_u.value():
+        case Instructions::i32_load16_s.value():
+        case Instructions::i32_load16_u.value():
+        case Instructions::i64_load8_s.value():
+        case Instructions::i64_load8_u.value():
+        case Instructions::i64_load16_s.value():
+        case Instructions::i64_load16_u.value():
+        case Instructions::i64_load32_s.value():
+        case Instructions::i64_load32_u.value():
+        case Instructions::i32_store.value():
+        case Instructions::i64_store.value():
+        case Instructions::f32_store.value():
+        case Instructions::f64_store.value():
+        case Instructions::i32_store8.value():
+        case Instructions::i32_store16.value():
+        case Instructions::i64_store8.value():
+        case Instructions::i64_store16.value():
+        case Instructions::i64_store32.value():
+            return arguments.get<Instruction::MemoryArgument>().memory_index.value() == 0;
+        case Instructions::memory_size.value():
+        case Instructions::memory_grow.value():
+        case Instructions::memory_fill.value():
+            return arguments.get<Instruction::MemoryIndexArgument>().memory_index.value() == 0;
+        case Instructions::memory_copy.value(): {
+            auto const& copy_arguments = arguments.get<Instruction::MemoryCopyArgs>();
+            return copy_arguments.src_index.value() == 0 && copy_arguments.dst_index.value() == 0;
+        }
+
+#    define __CASE(name, ...) case Instructions::name.value():
+            WASM_ENUMERATE_UNARY_OPERATIONS_WITH_RUNTIME_CALLS(__CASE)
+            WASM_ENUMERATE_BINARY_OPERATIONS_WITH_RUNTIME_CALLS(__CASE)
+            WASM_ENUMERATE_INLINE_INSTRUCTIONS(__CASE)
+#    undef __CASE
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    void compile_function(size_t index, WasmFunction const& function)
+    {
+        auto const& type = function.type();
+        m_local_count = type.parameters().size() + function.code().locals().size();
+        m_stack.clear();
+        m_control.clear();
+        m_max_height = 0;
+        m_unreachable = false;
+        m_unreachable_depth = 0;
+
+        m_entry_points[index] = m_output.size();
+        m_function_labels[index].link(m_assembler);
+
+        // The entry point takes the context and the frame, and keeps both in callee-saved registers.
+        m_assembler.enter();
+        m_assembler.mov(reg(CONTEXT), reg(ARG0));
+        m_assembler.mov(reg(FRAME), reg(ARG1));
+
+        // Deep recursion runs out of either the native stack or the value stack first.
+        m_assembler.mov(reg(GPR0), context(__builtin_offsetof(Context, native_stack_limit)));
+        m_assembler.jump_if(reg(Assembler::Reg::RSP), Assembler::Condition::UnsignedLessThan, reg(GPR0), m_stack_overflow_label);
+        m_assembler.mov(reg(GPR0), imm(0), Assembler::Patchable::Yes);
+        auto frame_size_offset = m_output.size() - sizeof(u64);
+        m_assembler.add(reg(GPR0), reg(FRAME));
+        m_assembler.jump_if(context(__builtin_offsetof(Context, value_stack_end)), Assembler::Condition::UnsignedLessThan, reg(GPR0), m_stack_overflow_label);
+
+        if (!function.code().locals().is_empty()) {
+            m_assembler.mov(reg(GPR0), imm(0));
+            for (size_t i = type.parameters().size(); i < m_local_count; ++i)
+                m_assembler.mov(local(i), reg(GPR0));
+        }
+
+        load_memory_registers();
+        consume_fuel();
+
+        m_control.append({ ControlFrame::Kind::Function, 0, type.parameters().size(), type.results().size(), {}, {}, false });
+        for (auto const& instruction : function.code().body().instructions()) {
+            compile_instruction(instruction);
+            m_pinned_registers = 0;
+        }
+
+        // The body doesn't end in an explicit end, falling off of it returns.
+        if (!m_unreachable)
+            branch(m_control.size() - 1);
+
+        auto frame_size = (m_local_count + m_max_height) * sizeof(u64);
+        for (size_t i = 0; i < sizeof(u64); ++i)
+            m_output[frame_size_offset + i] = (frame_size >> (i * 8)) & 0xff;
+    }
+
+    void compile_instruction(Instruction const& instruction)
+    {
+        auto opcode = instruction.opcode().value();
+
+        // Code after an unconditional branch can't run, but the structure around it still matters.
+        if (m_unreachable) {
+            switch (opcode) {
+            case Instructions::block.value():
+            case Instructions::loop.value():
+            case Instructions::if_.value():
+                ++m_unreachable_depth;
+                return;
+            case Instructions::structured_else.value():
+                if (m_unreachable_depth == 0)
+                    compile_else();
+                return;
+            case Instructions::structured_end.value():
+                if (m_unreachable_depth == 0)
+                    compile_end();
+                else
+                    --m_unreachable_depth;
+                return;
+            default:
+                return;
+            }
+        }
+
+        auto const& arguments = instruction.arguments();
+        switch (opcode) {
+        case Instructions::unreachable.value():
+            m_assembler.jump(m_unreachable_label);
+            mark_unreachable();
+            return;
+        case Instructions::nop.value():
+            return;
+
+        case Instructions::block.value():
+        case Instructions::loop.value():
+        case Instructions::if_.value():
+            return compile_block(instruction);
+        case Instructions::structured_else.value():
+            return compile_else();
+        case Instructions::structured_end.value():
+            return compile_end();
+        case Instructions::br.value():
+            return branch(arguments.get<LabelIndex>().value());
+        case Instructions::br_if.value(): {
+            auto condition = pop_to_register();
+            spill_all();
+            m_assembler.test(reg(condition), reg(condition));
+            return branch_if(Assembler::Condition::NotEqualTo, arguments.get<LabelIndex>().value());
+        }
+        case Instructions::br_table.value(): {
+            auto const& table = arguments.get<Instruction::TableBranchArgs>();
+            auto index = pop_to_register();
+            spill_all();
+            for (size_t i = 0; i < table.labels.size(); ++i) {
+                m_assembler.cmp32(reg(index), imm(i));
+                branch_if(Assembler::Condition::EqualTo, table.labels[i].value());
+            }
+            return branch(table.default_.value());
+        }
+        case Instructions::return_.value():
+            return branch(m_control.size() - 1);
+        case Instructions::call.value():
+            return compile_call(arguments.get<FunctionIndex>());
+        case Instructions::call_indirect.value():
+            return compile_call_indirect(arguments.get<Instruction::IndirectCallArgs>());
+
+        case Instructions::drop.value():
+            m_stack.take_last();
+            return;
+        case Instructions::select.value():
+        case Instructions::select_typed.value(): {
+            auto condition = pop_to_register();
+            auto second = pop_to_register();
+            auto first = pop_to_register();
+            m_assembler.test(reg(condition), reg(condition));
+            m_assembler.mov_if(Assembler::Condition::EqualTo, reg(first), reg(second));
+            push_register(first);
+            return;
+        }
+
+        case Instructions::local_get.value(): {
+            auto value = allocate_register();
+            m_assembler.mov(reg(value), local(arguments.get<LocalIndex>().value()));
+            push_register(value);
+            return;
+        }
+        case Instructions::local_set.value():
+            store_top(local(arguments.get<LocalIndex>().value()));
+            m_stack.take_last();
+            return;
+        case Instructions::local_tee.value():
+            store_top(local(arguments.get<LocalIndex>().value()));
+            return;
+        case Instructions::global_get.value(): {
+            spill_all();
+            m_assembler.mov(reg(ARG0), reg(CONTEXT));
+            m_assembler.mov(reg(ARG1), imm(m_module.globals()[arguments.get<GlobalIndex>().value()].value()));
+            call(bit_cast<FlatPtr>(&cxx_global_get));
+            push_from(reg(RET));
+            return;
+        }
+        case Instructions::global_set.value(): {
+            spill_all();
+            m_assembler.mov(reg(ARG0), reg(CONTEXT));
+            m_assembler.mov(reg(ARG1), imm(m_module.globals()[arguments.get<GlobalIndex>().value()].value()));
+            m_assembler.mov(reg(ARG2), slot(m_stack.size() - 1));
+            m_stack.take_last();
+            call(bit_cast<FlatPtr>(&cxx_global_set));
+            return;
+        }
+
+        case Instructions::i32_const.value():
+            return push_constant(static_cast<u32>(arguments.get<i32>()));
+        case Instructions::i64_const.value():
+            return push_constant(static_cast<u64>(arguments.get<i64>()));
+        case Instructions::f32_const.value():
+            return push_constant(bit_cast<u32>(arguments.get<float>()));
+        case Instructions::f64_const.value():
+            return push_constant(bit_cast<u64>(arguments.get<double>()));
+
+        case Instructions::i32_load.value():
+        case Instructions::f32_load.value():
+            return compile_load(arguments.get<Instruction::MemoryArgument>(), 4, [&](auto dst, auto src) { m_assembler.mov32(dst, src); });
+        case Instructions::i64_load.value():
+        case Instructions::f64_load.value():
+            return compile_load(arguments.get<Instruction::MemoryArgument>(), 8, [&](auto dst, auto src) { m_assembler.mov(dst, src); });
+        case Instructions::i32_load8_s.value():
+            return compile_load(arguments.get<Instruction::MemoryArgument>(), 1, [&](auto dst, auto src) { m_assembler.mov8(dst, src, Assembler::Extension::SignExtend); });
+        case Instructions::i32_load8_u.value():
+        case Instructions::i64_load8_u.value():
+            return compile_load(arguments.get<Instruction::MemoryArgument>(), 1, [&](auto dst, auto src) { m_assembler.mov8(dst, src); });
+        case Instructions::i32_load16_s.value():
+            return compile_load(arguments.get<Instruction::MemoryArgument>(), 2, [&](auto dst, auto src) { m_assembler.mov16(dst, src, Assembler::Extension::SignExtend); });
+        case Instructions::i32_load16_u.value():
+        case Instructions::i64_load16_u.value():
+            return compile_load(arguments.get<Instruction::MemoryArgument>(), 2, [&](auto dst, auto src) { m_assembler.mov16(dst, src); });
+        case Instructions::i64_load8_s.value():
+            return compile_load(arguments.get<Instruction::MemoryArgument>(), 1, [&](auto dst, auto src) {
+                m_assembler.mov8(dst, src, Assembler::Extension::SignExtend);
+                m_assembler.sign_extend_32_to_64_bits(dst.reg);
+            });
+        case Instructions::i64_load16_s.value():
+            return compile_load(arguments.get<Instruction::MemoryArgument>(), 2, [&](auto dst, auto src) {
+                m_assembler.mov16(dst, src, Assembler::Extension::SignExtend);
+                m_assembler.sign_extend_32_to_64_bits(dst.reg);
+            });
+        case Instructions::i64_load32_s.value():
+            return compile_load(arguments.get<Instruction::MemoryArgument>(), 4, [&](auto dst, auto src) { m_assembler.mov32(dst, src, Assembler::Extension::SignExtend); });
+        case Instructions::i64_load32_u.value():
+            return compile_load(arguments.get<Instruction::MemoryArgument>(), 4, [&](auto dst, auto src) { m_assembler.mov32(dst, src); });
+        case Instructions::i32_store8.value():
+        case Instructions::i64_store8.value():
+            return compile_store(arguments.get<Instruction::MemoryArgument>(), 1, [&](auto dst, auto src) { m_assembler.mov8(dst, src); });
+        case Instructions::i32_store16.value():
+        case Instructions::i64_store16.value():
+            return compile_store(arguments.get<Instruction::MemoryArgument>(), 2, [&](auto dst, auto src) { m_assembler.mov16(dst, src); });
+        case Instructions::i32_store.value():
+        case Instructions::f32_store.value():
+        case Instructions::i64_store32.value():
+            return compile_store(arguments.get<Instruction::MemoryArgument>(), 4, [&](auto dst, auto src) { m_assembler.mov32(dst, src); });
+        case Instructions::i64_store.value():
+        case Instructions::f64_store.value():
+            return compile_store(arguments.get<Instruction::MemoryArgument>(), 8, [&](auto dst, auto src) { m_assembler.mov(dst, src); });
+
+        case Instructions::memory_size.value(): {
+            static_assert(Constants::page_size == 1 << 16);
+            auto size = allocate_register();
+            m_assembler.mov(reg(size), reg(MEMORY_SIZE));
+            m_assembler.shift_right(reg(size), imm(16));
+            push_register(size);
+            return;
+        }
+        case Instructions::memory_grow.value():
+            spill_all();
+            m_assembler.mov(reg(ARG0), reg(CONTEXT));
+            m_assembler.mov(reg(ARG1), slot(m_stack.size() - 1));
+            m_stack.take_last();
+            call(bit_cast<FlatPtr>(&cxx_memory_grow));
+            load_memory_registers();
+            push_from(reg(RET));
+            return;
+        case Instructions::memory_fill.value():
+            return compile_memory_operation(bit_cast<FlatPtr>(&cxx_memory_fill));
+        case Instructions::memory_copy.value():
+            return compile_memory_operation(bit_cast<FlatPtr>(&cxx_memory_copy));
+
+        case Instructions::i32_eqz.value():
+        case Instructions::i64_eqz.value(): {
+            auto value = pop_to_register();
+            m_assembler.mov(reg(GPR0), imm(0));
+            m_assembler.test(reg(value), reg(value));
+            m_assembler.set_if(Assembler::Condition::EqualTo, reg(GPR0));
+            m_assembler.mov(reg(value), reg(GPR0));
+            push_register(value);
+            return;
+        }
+        case Instructions::i32_eq.value():
+            return compile_comparison(Width::Bits32, Assembler::Condition::EqualTo);
+        case Instructions::i32_ne.value():
+            return compile_comparison(Width::Bits32, Assembler::Condition::NotEqualTo);
+        case Instructions::i32_lts.value():
+            return compile_comparison(Width::Bits32, Assembler::Condition::SignedLessThan);
+        case Instructions::i32_ltu.value():
+            return compile_comparison(Width::Bits32, Assembler::Condition::UnsignedLessThan);
+        case Instructions::i32_gts.value():
+            return compile_comparison(Width::Bits32, Assembler::Condition::SignedGreaterThan);
+        case Instructions::i32_gtu.value():
+            return compile_comparison(Width::Bits32, Assembler::Condition::UnsignedGreaterThan);
+        case Instructions::i32_les.value():
+            return compile_comparison(Width::Bits32, Assembler::Condition::SignedLessThanOrEqualTo);
+        case Instructions::i32_leu.value():
+            return compile_comparison(Width::Bits32, Assembler::Condition::UnsignedLessThanOrEqualTo);
+        case Instructions::i32_ges.value():
+            return compile_comparison(Width::Bits32, Assembler::Condition::SignedGreaterThanOrEqualTo);
+        case Instructions::i32_geu.value():
+            return compile_comparison(Width::Bits32, Assembler::Condition::UnsignedGreaterThanOrEqualTo);
+        case Instructions::i64_eq.value():
+            return compile_comparison(Width::Bits64, Assembler::Condition::EqualTo);
+        case Instructions::i64_ne.value():
+            return compile_comparison(Width::Bits64, Assembler::Condition::NotEqualTo);
+        case Instructions::i64_lts.value():
+            return compile_comparison(Width::Bits64, Assembler::Condition::SignedLessThan);
+        case Instructions::i64_ltu.value():
+            return compile_comparison(Width::Bits64, Assembler::Condition::UnsignedLessThan);
+        case Instructions::i64_gts.value():
+            return compile_comparison(Width::Bits64, Assembler::Condition::SignedGreaterThan);
+        case Instructions::i64_gtu.value():
+            return compile_comparison(Width::Bits64, Assembler::Condition::UnsignedGreaterThan);
+        case Instructions::i64_les.value():
+            return compile_comparison(Width::Bits64, Assembler::Condition::SignedLessThanOrEqualTo);
+        case Instructions::i64_leu.value():
+            return compile_comparison(Width::Bits64, Assembler::Condition::UnsignedLessThanOrEqualTo);
+        case Instructions::i64_ges.value():
+            return compile_comparison(Width::Bits64, Assembler::Condition::SignedGreaterThanOrEqualTo);
+        case Instructions::i64_geu.value():
+            return compile_comparison(Width::Bits64, Assembler::Condition::UnsignedGreaterThanOrEqualTo);
+
+        // 32-bit results are kept zero-extended, which the 32-bit forms of instructions do by themselves. The bitwise
+        // ones can just as well use all 64 bits.
+        case Instructions::i32_add.value():
+            return compile_binary(Width::Bits32, [&](auto lhs, auto rhs) { m_assembler.add32(lhs, rhs, {}); });
+        case Instructions::i32_sub.value():
+            return compile_binary(Width::Bits32, [&](auto lhs, auto rhs) { m_assembler.sub32(lhs, rhs, {}); });
+        case Instructions::i32_mul.value():
+            return compile_binary(Width::Bits32, [&](auto lhs, auto rhs) { m_assembler.mul32(lhs, rhs, {}); });
+        case Instructions::i32_and.value():
+        case Instructions::i64_and.value():
+            return compile_binary(Width::Bits64, [&](auto lhs, auto rhs) { m_assembler.bitwise_and(lhs, rhs); });
+        case Instructions::i32_or.value():
+        case Instructions::i64_or.value():
+            return compile_binary(Width::Bits64, [&](auto lhs, auto rhs) { m_assembler.bitwise_or(lhs, rhs); });
+        case Instructions::i32_xor.value():
+        case Instructions::i64_xor.value():
+            return compile_binary(Width::Bits64, [&](auto lhs, auto rhs) { m_assembler.bitwise_xor(lhs, rhs); });
+        case Instructions::i64_add.value():
+            return compile_binary(Width::Bits64, [&](auto lhs, auto rhs) { m_assembler.add(lhs, rhs); });
+        case Instructions::i64_sub.value():
+            return compile_binary(Width::Bits64, [&](auto lhs, auto rhs) { m_assembler.sub(lhs, rhs); });
+        case Instructions::i64_mul.value(): {
+            auto rhs = pop_to_register();
+            auto lhs = pop_to_register();
+            m_assembler.mul(reg(lhs), reg(rhs));
+            push_register(lhs);
+            return;
+        }
+        case Instructions::i32_shl.value():
+            return compile_shift(31, [&](auto value, auto count) { m_assembler.shift_left32(value, count); });
+        case Instructions::i32_shrs.value():
+            return compile_shift(31, [&](auto value, auto count) { m_assembler.arithmetic_right_shift32(value, count); });
+        case Instructions::i32_shru.value():
+            return compile_shift(31, [&](auto value, auto count) { m_assembler.shift_right32(value, count); });
+        case Instructions::i64_shl.value():
+            return compile_shift(63, [&](auto value, auto count) { m_assembler.shift_left(value, count); });
+        case Instructions::i64_shrs.value():
+            return compile_shift(63, [&](auto value, auto count) { m_assembler.arithmetic_right_shift(value, count); });
+        case Instructions::i64_shru.value():
+            return compile_shift(63, [&](auto value, auto count) { m_assembler.shift_right(value, count); });
+
+        case Instructions::i32_wrap_i64.value(): {
+            auto value = pop_to_register();
+            m_assembler.mov32(reg(value), reg(value));
+            push_register(value);
+            return;
+        }
+        case Instructions::i64_extend_si32.value():
+        case Instructions::i64_extend32_s.value(): {
+            auto value = pop_to_register();
+            m_assembler.sign_extend_32_to_64_bits(value);
+            push_register(value);
+            return;
+        }
+        // Slots hold 32-bit values zero-extended and floats as their bits already.
+        case Instructions::i64_extend_ui32.value():
+        case Instructions::i32_reinterpret_f32.value():
+        case Instructions::i64_reinterpret_f64.value():
+        case Instructions::f32_reinterpret_i32.value():
+        case Instructions::f64_reinterpret_i64.value():
+            return;
+
+#    define __UNARY_OPERATION(name, PopT, PushT, Operator) \
+    case Instructions::name.value():                     \
+        return compile_unary_operation<PopT, PushT, Operators::Operator>();
+            WASM_ENUMERATE_UNARY_OPERATIONS_WITH_RUNTIME_CALLS(__UNARY_OPERATION)
+#    undef __UNARY_OPERATION
+
+#    define __BINARY_OPERATION(name, PopT, PushT, Operator) \
+    case Instructions::name.value():                      \
+        return compile_binary_operation<PopT, PushT, Operators::Operator>();
+            WASM_ENUMERATE_BINARY_OPERATIONS_WITH_RUNTIME_CALLS(__BINARY_OPERATION)
+#    undef __BINARY_OPERATION
+
+        default:
+            VERIFY_NOT_REACHED();
+        }
+    }
+
+    void compile_block(Instruction const& instruction)
+    {
+        auto signature = signature_of(instruction.arguments().get<Instruction::StructuredInstructionArgs>().block_type);
+        Optional<Assembler::Reg> condition;
+        if (instruction.opcode() == Instructions::if_)
+            condition = pop_to_register();
+
+        // Blocks start and end with every value in its slot, so that all paths into them agree on where values are.
+        spill_all();
+        auto kind = ControlFrame::Kind::Block;
+        if (instruction.opcode() == Instructions::loop)
+            kind = ControlFrame::Kind::Loop;
+        else if (instruction.opcode() == Instructions::if_)
+            kind = ControlFrame::Kind::If;
+        m_control.append({ kind, m_stack.size() - signature.parameter_count, signature.parameter_count, signature.result_count, {}, {}, false });
+
+        auto& frame = m_control.last();
+        if (kind == ControlFrame::Kind::Loop) {
+            frame.label.link(m_assembler);
+            consume_fuel();
+        } else if (kind == ControlFrame::Kind::If) {
+            m_assembler.test(reg(*condition), reg(*condition));
+            m_assembler.jump_if(Assembler::Condition::EqualTo, frame.else_label);
+        }
+    }
+
+    void compile_else()
+    {
+        auto& frame = m_control.last();
+        VERIFY(frame.kind == ControlFrame::Kind::If);
+        if (!m_unreachable) {
+            spill_all();
+            m_assembler.jump(frame.label);
+        }
+        frame.else_label.link(m_assembler);
+        frame.has_else = true;
+        reset_stack(frame.height, frame.parameter_count);
+        m_unreachable = false;
+    }
+
+    void compile_end()
+    {
+        auto frame = m_control.take_last();
+        if (!m_unreachable)
+            spill_all();
+        if (frame.kind == ControlFrame::Kind::If && !frame.has_else)
+            frame.else_label.link(m_assembler);
+        if (frame.kind != ControlFrame::Kind::Loop)
+            frame.label.link(m_assembler);
+        reset_stack(frame.height, frame.result_count);
+        m_unreachable = false;
+    }
+
+    void compile_call(FunctionIndex index)
+    {
+        auto address = m_module.functions()[index.value()];
+        auto const& type = function_type(address);
+        spill_all();
+
+        // The arguments on top of the stack become the start of the callee's frame.
+        m_assembler.mov(reg(ARG0), reg(CONTEXT));
+        load_arguments_pointer(ARG1, type);
+        if (m_functions[index.value()]) {
+            m_assembler.call(m_function_labels[index.value()]);
+        } else {
+            m_assembler.mov(reg(ARG2), reg(ARG1));
+            m_assembler.mov(reg(ARG1), imm(address.value()));
+            call(bit_cast<FlatPtr>(&cxx_call));
+        }
+        finish_call(type);
+    }
+
+    void compile_call_indirect(Instruction::IndirectCallArgs const& arguments)
+    {
+        auto const& type = m_module.types()[arguments.type.value()];
+        spill_all();
+        auto index = slot(m_stack.size() - 1);
+        m_stack.take_last();
+
+        m_assembler.mov(reg(ARG0), reg(CONTEXT));
+        m_assembler.mov(reg(ARG1), imm(m_module.tables()[arguments.table.value()].value()));
+        m_assembler.mov(reg(ARG2), imm(bit_cast<FlatPtr>(&type)));
+        m_assembler.mov(reg(ARG3), index);
+        load_arguments_pointer(ARG4, type);
+        call(bit_cast<FlatPtr>(&cxx_call_indirect));
+        finish_call(type);
+    }
+
+    void load_arguments_pointer(Assembler::Reg dst, FunctionType const& type)
+    {
+        m_assembler.mov(reg(dst), reg(FRAME));
+        auto offset = (m_local_count + m_stack.size() - type.parameters().size()) * sizeof(u64);
+        if (offset != 0)
+            m_assembler.add(reg(dst), imm(offset));
+    }
+
+    // Leaves the function if the callee trapped, and replaces the arguments with the results it left in their place.
+    void finish_call(FunctionType const& type)
+    {
+        exit_if_status_set();
+        load_memory_registers();
+        m_stack.shrink(m_stack.size() - type.parameters().size());
+        for (size_t i = 0; i < type.results().size(); ++i)
+            push_slot();
+    }
+
+    void compile_memory_operation(FlatPtr callee)
+    {
+        spill_all();
+        m_assembler.mov(reg(ARG0), reg(CONTEXT));
+        m_assembler.mov(reg(ARG1), slot(m_stack.size() - 3));
+        m_assembler.mov(reg(ARG2), slot(m_stack.size() - 2));
+        m_assembler.mov(reg(ARG3), slot(m_stack.size() - 1));
+        m_stack.shrink(m_stack.size() - 3);
+        call(callee);
+        exit_if_status_set();
+    }
+
+    // Pops an address and leaves the address of `size` bytes at it plus `offset` in GPR0, or traps if any of them are
+    // outside of the memory. Returns the register the address was in, which is free to use after that.
+    Assembler::Reg compile_effective_address(Instruction::MemoryArgument const& argument, size_t size)
+    {
+        auto address = pop_to_register();
+        m_assembler.mov(reg(GPR0), reg(address));
+        if (m_memory_has_guard_pages) {
+            // Whatever address and offset there are, the access stays within the reservation, where everything past the
+            // end of the memory faults.
+            m_assembler.add(reg(GPR0), reg(MEMORY_BASE));
+            add_offset(argument.offset);
+            return address;
+        }
+        add_offset(argument.offset);
+        m_assembler.mov(reg(GPR1), reg(GPR0));
+        m_assembler.add(reg(GPR1), imm(size));
+        m_assembler.jump_if(reg(GPR1), Assembler::Condition::UnsignedGreaterThan, reg(MEMORY_SIZE), m_out_of_bounds_label);
+        m_assembler.add(reg(GPR0), reg(MEMORY_BASE));
+        return address;
+    }
+
+    void add_offset(u64 offset)
+    {
+        if (offset != 0) {
+            if (imm(offset).fits_in_i32()) {
+                m_assembler.add(reg(GPR0), imm(offset));
+            } else {
+                m_assembler.mov(reg(GPR1), imm(offset));
+                m_assembler.add(reg(GPR0), reg(GPR1));
+            }
+        }
+    }
+
+    template<typename Load>
+    void compile_load(Instruction::MemoryArgument const& argument, size_t size, Load load)
+    {
+        auto value = compile_effective_address(argument, size);
+        load(reg(value), mem(GPR0, 0));
+        push_register(value);
+    }
+
+    template<typename Store>
+    void compile_store(Instruction::MemoryArgument const& argument, size_t size, Store store)
+    {
+        Optional<Assembler::Reg> value;
+        Optional<u64> constant;
+        if (m_stack.last().kind == StackEntry::Kind::Constant)
+            constant = m_stack.take_last().constant;
+        else
+            value = pop_to_register();
+
+        compile_effective_address(argument, size);
+        if (constant.has_value()) {
+            m_assembler.mov(reg(GPR1), imm(*constant));
+            value = GPR1;
+        }
+        store(mem(GPR0, 0), reg(*value));
+    }
+
+    template<typename Emit>
+    void compile_binary(Width width, Emit emit)
+    {
+        auto rhs = pop_to_operand(width);
+        auto lhs = pop_to_register();
+        emit(reg(lhs), rhs);
+        push_register(lhs);
+    }
+
+    void compile_comparison(Width width, Assembler::Condition condition)
+    {
+        auto rhs = pop_to_operand(width);
+        auto lhs = pop_to_register();
+        // Zeroing clears the flags too, so it has to happen before the comparison.
+        m_assembler.mov(reg(GPR0), imm(0));
+        if (width == Width::Bits32)
+            m_assembler.cmp32(reg(lhs), rhs);
+        else
+            m_assembler.cmp(reg(lhs), rhs);
+        m_assembler.set_if(condition, reg(GPR0));
+        m_assembler.mov(reg(lhs), reg(GPR0));
+        push_register(lhs);
+    }
+
+    template<typename Emit>
+    void compile_shift(u64 mask, Emit emit)
+    {
+        if (m_stack.last().kind == StackEntry::Kind::Constant) {
+            auto count = m_stack.take_last().constant & mask;
+            auto value = pop_to_register();
+            emit(reg(value), Optional<Assembler::Operand> { imm(count) });
+            push_register(value);
+            return;
+        }
+        auto count = pop_to_register();
+        auto value = pop_to_register();
+        m_assembler.mov(reg(GPR1), reg(count));
+        emit(reg(value), Optional<Assembler::Operand> {});
+        push_register(value);
+    }
+
+    template<typename PopT, typename PushT, typename Operator>
+    void compile_unary_operation()
+    {
+        spill_all();
+        auto operand = slot(m_stack.size() - 1);
+        m_stack.take_last();
+        if constexpr (IsSpecializationOf<decltype(Operator {}(PopT {})), AK::ErrorOr>) {
+            m_assembler.mov(reg(ARG0), reg(CONTEXT));
+            m_assembler.mov(reg(ARG1), operand);
+            call(bit_cast<FlatPtr>(&cxx_checked_unary_operation<PopT, PushT, Operator>));
+            exit_if_status_set();
+            push_from(context(__builtin_offsetof(Context, result)));
+        } else {
+            m_assembler.mov(reg(ARG0), operand);
+            call(bit_cast<FlatPtr>(&cxx_unary_operation<PopT, PushT, Operator>));
+            push_from(reg(RET));
+        }
+    }
+
+    template<typename PopT, typename PushT, typename Operator>
+    void compile_binary_operation()
+    {
+        spill_all();
+        auto lhs = slot(m_stack.size() - 2);
+        auto rhs = slot(m_stack.size() - 1);
+        m_stack.shrink(m_stack.size() - 2);
+        if constexpr (IsSpecializationOf<decltype(Operator {}(PopT {}, PopT {})), AK::ErrorOr>) {
+            m_assembler.mov(reg(ARG0), reg(CONTEXT));
+            m_assembler.mov(reg(ARG1), lhs);
+            m_assembler.mov(reg(ARG2), rhs);
+            call(bit_cast<FlatPtr>(&cxx_checked_binary_operation<PopT, PushT, Operator>));
+            exit_if_status_set();
+            push_from(context(__builtin_offsetof(Context, result)));
+        } else {
+            m_assembler.mov(reg(ARG0), lhs);
+            m_assembler.mov(reg(ARG1), rhs);
+            call(bit_cast<FlatPtr>(&cxx_binary_operation<PopT, PushT, Operator>));
+            push_from(reg(RET));
+        }
+    }
+
+    // Branches to the block `depth` levels out, which leaves the rest of the current block unreachable.
+    void branch(size_t depth)
+    {
+        spill_all();
+        auto& frame = m_control[m_control.size() - depth - 1];
+        move_branch_values(frame);
+        m_assembler.jump(branch_target(frame));
+        mark_unreachable();
+    }
+
+    // Branches if the condition holds on the flags, with every value already in its slot.
+    void branch_if(Assembler::Condition condition, size_t depth)
+    {
+        auto& frame = m_control[m_control.size() - depth - 1];
+        if (!needs_to_move_branch_values(frame)) {
+            m_assembler.jump_if(condition, branch_target(frame));
+            return;
+        }
+        Assembler::Label skip {};
+        m_assembler.jump_if(invert(condition), skip);
+        move_branch_values(frame);
+        m_assembler.jump(branch_target(frame));
+        skip.link(m_assembler);
+    }
+
+    Assembler::Label& branch_target(ControlFrame& frame)
+    {
+        return frame.kind == ControlFrame::Kind::Function ? m_return_label : frame.label;
+    }
+
+    // Where the values a branch carries go, in slots from the start of the frame. Results of the function go to the
+    // very start of it.
+    size_t branch_destination(ControlFrame const& frame) const
+    {
+        return frame.kind == ControlFrame::Kind::Function ? 0 : m_local_count + frame.height;
+    }
+
+    size_t branch_source(ControlFrame const& frame) const
+    {
+        return m_local_count + m_stack.size() - frame.branch_arity();
+    }
+
+    bool needs_to_move_branch_values(ControlFrame const& frame) const
+    {
+        return frame.branch_arity() != 0 && branch_source(frame) != branch_destination(frame);
+    }
+
+    void move_branch_values(ControlFrame const& frame)
+    {
+        if (!needs_to_move_branch_values(frame))
+            return;
+        // The destination is never above the source, so copying upwards doesn't overwrite anything still to be copied.
+        auto source = branch_source(frame);
+        auto destination = branch_destination(frame);
+        for (size_t i = 0; i < frame.branch_arity(); ++i) {
+            m_assembler.mov(reg(GPR0), mem(FRAME, (source + i) * sizeof(u64)));
+            m_assembler.mov(mem(FRAME, (destination + i) * sizeof(u64)), reg(GPR0));
+        }
+    }
+
+    void mark_unreachable()
+    {
+        m_unreachable = true;
+        m_unreachable_depth = 0;
+    }
+
+    void reset_stack(size_t height, size_t slot_count)
+    {
+        VERIFY(m_stack.size() >= height);
+        m_stack.shrink(height);
+        for (size_t i = 0; i < slot_count; ++i)
+            push_slot();
+    }
+
+    bool is_register_free(Assembler::Reg candidate) const
+    {
+        if (m_pinned_registers & (1u << to_underlying(candidate)))
+            return false;
+        return !any_of(m_stack, [&](auto const& entry) { return entry.kind == StackEntry::Kind::Register && entry.reg == candidate; });
+    }
+
+    // Registers handed out while compiling an instruction stay reserved until the next one, even once they're off the
+    // stack.
+    Assembler::Reg allocate_register()
+    {
+        for (auto candidate : stack_registers) {
+            if (is_register_free(candidate)) {
+                m_pinned_registers |= 1u << to_underlying(candidate);
+                return candidate;
+            }
+        }
+
+        // Everything is taken, so the value deepest in the stack goes back to its slot.
+        for (size_t i = 0; i < m_stack.size(); ++i) {
+            auto& entry = m_stack[i];
+            if (entry.kind != StackEntry::Kind::Register)
+                continue;
+            m_assembler.mov(slot(i), reg(entry.reg));
+            entry.kind = StackEntry::Kind::Slot;
+            m_pinned_registers |= 1u << to_underlying(entry.reg);
+            return entry.reg;
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    Assembler::Reg pop_to_register()
+    {
+        auto entry = m_stack.take_last();
+        switch (entry.kind) {
+        case StackEntry::Kind::Register:
+            m_pinned_registers |= 1u << to_underlying(entry.reg);
+            return entry.reg;
+        case StackEntry::Kind::Slot: {
+            auto value = allocate_register();
+            m_assembler.mov(reg(value), slot(m_stack.size()));
+            return value;
+        }
+        case StackEntry::Kind::Constant: {
+            auto value = allocate_register();
+            m_assembler.mov(reg(value), imm(entry.constant));
+            return value;
+        }
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    // Constants that fit in an instruction stay immediates. 32-bit instructions only look at the low half, so any
+    // 32-bit value does, 64-bit ones sign-extend the immediate.
+    Assembler::Operand pop_to_operand(Width width)
+    {
+        auto const& entry = m_stack.last();
+        if (entry.kind == StackEntry::Kind::Constant) {
+            auto value = entry.constant;
+            if (width == Width::Bits32)
+                value = static_cast<u64>(static_cast<i64>(static_cast<i32>(value)));
+            if (imm(value).fits_in_i32()) {
+                m_stack.take_last();
+                return imm(value);
+            }
+        }
+        return reg(pop_to_register());
+    }
+
+    void push_register(Assembler::Reg value)
+    {
+        push({ StackEntry::Kind::Register, value, 0 });
+    }
+
+    void push_constant(u64 value)
+    {
+        push({ StackEntry::Kind::Constant, Assembler::Reg::RAX, value });
+    }
+
+    void push_slot()
+    {
+        push({ StackEntry::Kind::Slot, Assembler::Reg::RAX, 0 });
+    }
+
+    void push_from(Assembler::Operand source)
+    {
+        auto value = allocate_register();
+        m_assembler.mov(reg(value), source);
+        push_register(value);
+    }
+
+    void push(StackEntry entry)
+    {
+        m_stack.append(entry);
+        m_max_height = max(m_max_height, m_stack.size());
+    }
+
+    // Writes the value on top of the stack to `dst` without popping it.
+    void store_top(Assembler::Operand dst)
+    {
+        auto const& entry = m_stack.last();
+        switch (entry.kind) {
+        case StackEntry::Kind::Register:
+            m_assembler.mov(dst, reg(entry.reg));
+            return;
+        case StackEntry::Kind::Constant:
+            store_constant(dst, entry.constant);
+            return;
+        case StackEntry::Kind::Slot:
+            m_assembler.mov(reg(GPR0), slot(m_stack.size() - 1));
+            m_assembler.mov(dst, reg(GPR0));
+            return;
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    void store_constant(Assembler::Operand dst, u64 value)
+    {
+        if (imm(value).fits_in_i32()) {
+            m_assembler.mov(dst, imm(value));
+            return;
+        }
+        m_assembler.mov(reg(GPR0), imm(value));
+        m_assembler.mov(dst, reg(GPR0));
+    }
+
+    void spill_all()
+    {
+        for (size_t i = 0; i < m_stack.size(); ++i) {
+            auto& entry = m_stack[i];
+            if (entry.kind == StackEntry::Kind::Register)
+                m_assembler.mov(slot(i), reg(entry.reg));
+            else if (entry.kind == StackEntry::Kind::Constant)
+                store_constant(slot(i), entry.constant);
+            entry.kind = StackEntry::Kind::Slot;
+        }
+    }
+
+    void load_memory_registers()
+    {
+        if (m_module.memories().is_empty())
+            return;
+        m_assembler.mov(reg(MEMORY_BASE), context(__builtin_offsetof(Context, memory_base)));
+        m_assembler.mov(reg(MEMORY_SIZE), context(__builtin_offsetof(Context, memory_size)));
+    }
+
+    // Calls and loop iterations are what's counted towards the instruction limit.
+    void consume_fuel()
+    {
+        if (!m_limit_instruction_count)
+            return;
+        m_assembler.sub(context(__builtin_offsetof(Context, fuel)), imm(1));
+        m_assembler.jump_if(Assembler::Condition::UnsignedLessThan, m_fuel_exhausted_label);
+    }
+
+    void call(FlatPtr callee)
+    {
+        m_assembler.native_call(callee);
+    }
+
+    // Leaves the function with the status a call returned, unless it's Status::Ok.
+    void exit_if_status_set()
+    {
+        m_assembler.test(reg(RET), reg(RET));
+        m_assembler.jump_if(Assembler::Condition::NotEqualTo, m_exit_label);
+    }
+
+    void emit_exit(Assembler::Label& label, Status status)
+    {
+        label.link(m_assembler);
+        m_assembler.mov(reg(RET), imm(to_underlying(status)));
+        m_assembler.jump(m_exit_label);
+    }
+
+    Store& m_store;
+    ModuleInstance const& m_module;
+    bool m_limit_instruction_count { false };
+
+    // Loads and stores leave the bounds checks to the guard pages of the memory.
+    bool m_memory_has_guard_pages { false };
+
+    Vector<u8> m_output;
+    Assembler m_assembler { m_output };
+
+    // The functions that get compiled, by function index.
+    Vector<WasmFunction const*> m_functions;
+    Vector<Assembler::Label> m_function_labels;
+    Vector<Optional<size_t>> m_entry_points;
+    size_t m_compiled_functions { 0 };
+    size_t m_refused_functions { 0 };
+
+    Assembler::Label m_return_label {};
+    Assembler::Label m_exit_label {};
+    Assembler::Label m_unreachable_label {};
+    Assembler::Label m_out_of_bounds_label {};
+    size_t m_out_of_bounds_handler { 0 };
+    Assembler::Label m_stack_overflow_label {};
+    Assembler::Label m_fuel_exhausted_label {};
+
+    // The state of the function being compiled.
+    size_t m_local_count { 0 };
+    Vector<StackEntry> m_stack;
+    size_t m_max_height { 0 };
+    Vector<ControlFrame> m_control;
+    bool m_unreachable { false };
+    size_t m_unreachable_depth { 0 };
+    u32 m_pinned_registers { 0 };
+};
+
+}
+
+OwnPtr<NativeModule> Compiler::compile(Store& store, ModuleInstance const& module, bool limit_instruction_count)
+{
+    if (!is_enabled())
+        return nullptr;
+
+    auto compile_start = MonotonicTime::now();
+
+    NativeCodeGenerator generator { store, module, limit_instruction_count };
+    generator.generate();
+    s_statistics.refused_functions += generator.refused_functions();
+    if (generator.compiled_functions() == 0)
+        return nullptr;
+
+    auto& output = generator.output();
+    auto* code = mmap(nullptr, output.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        dbgln_if(JIT_DEBUG, "JIT: Failed to mmap {} bytes of code: {}", output.size(), strerror(errno));
+        return nullptr;
+    }
+    memcpy(code, output.data(), output.size());
+    if (mprotect(code, output.size(), PROT_READ | PROT_EXEC) < 0) {
+        dbgln_if(JIT_DEBUG, "JIT: Failed to make code executable: {}", strerror(errno));
+        munmap(code, output.size());
+        return nullptr;
+    }
+
+    auto gdb_object = ::JIT::GDB::build_gdb_image({ code, output.size() }, "LibWasm JIT"sv, "wasm"sv);
+    auto native_module = make<NativeModule>(module, code, output.size(), move(generator.entry_points()), generator.out_of_bounds_handler(), move(gdb_object));
+
+    ++s_statistics.compiled_modules;
+    s_statistics.compiled_functions += generator.compiled_functions();
+    s_statistics.code_size += output.size();
+    s_statistics.compile_time += MonotonicTime::now() - compile_start;
+    return native_module;
+}
+
+#else
+
+OwnPtr<NativeModule> Compiler::compile(Store&, ModuleInstance const&, bool)
+{
+    return nullptr;
+}
+
+#endif
+
+}
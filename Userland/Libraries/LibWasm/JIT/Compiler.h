@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/OwnPtr.h>
+#include <AK/Time.h>
+#include <LibWasm/JIT/NativeModule.h>
+
+namespace Wasm::JIT {
+
+// Translates the functions of a module instance into machine code, in a single pass over each function that keeps the
+// top of the operand stack in registers. Integer arithmetic, locals, memory accesses, calls and control flow are done
+// inline, and everything else calls the same operators the interpreter uses. Functions that use anything else (like
+// references or vectors) are left to the interpreter.
+class Compiler {
+public:
+    static OwnPtr<NativeModule> compile(Store&, ModuleInstance const&, bool limit_instruction_count);
+
+    // The compiler can be turned off with LIBWASM_JIT=0 in the environment (or on with LIBWASM_JIT=1 on SerenityOS).
+    static bool is_enabled();
+    static void set_enabled(bool);
+
+    struct Statistics {
+        size_t compiled_modules { 0 };
+        size_t compiled_functions { 0 };
+        size_t refused_functions { 0 };
+        size_t code_size { 0 };
+        Duration compile_time;
+        size_t native_calls { 0 };
+        size_t calls_out_of_native_code { 0 };
+    };
+    static Statistics& statistics();
+    static void dump_statistics();
+};
+
+}
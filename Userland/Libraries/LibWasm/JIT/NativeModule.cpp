@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StackInfo.h>
+#include <AK/TemporaryChange.h>
+#include <LibJIT/GDB.h>
+#include <LibWasm/AbstractMachine/Configuration.h>
+#include <LibWasm/AbstractMachine/Interpreter.h>
+#include <LibWasm/JIT/Compiler.h>
+#include <LibWasm/JIT/NativeModule.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+
+namespace Wasm::JIT {
+
+// In slots, which is 8 MiB.
+static constexpr size_t value_stack_size = 1 * MiB;
+
+// The innermost call into machine code on this thread, which is the only one that can be running.
+static thread_local NativeModule::Context* s_running_context { nullptr };
+
+NativeModule::NativeModule(ModuleInstance const& module, void* code, size_t size, Vector<Optional<size_t>> entry_points, size_t out_of_bounds_handler, Optional<FixedArray<u8>> gdb_object)
+    : m_module(module)
+    , m_code(code)
+    , m_size(size)
+    , m_entry_points(move(entry_points))
+    , m_out_of_bounds_handler(out_of_bounds_handler)
+    , m_gdb_object(move(gdb_object))
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::register_into_gdb(m_gdb_object.value().span());
+}
+
+NativeModule::~NativeModule()
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::unregister_from_gdb(m_gdb_object.value().span());
+    munmap(m_code, m_size);
+}
+
+#if ARCH(X86_64) && (defined(AK_OS_SERENITY) || defined(AK_OS_LINUX))
+static FlatPtr instruction_pointer(ucontext_t const& context)
+{
+#    ifdef AK_OS_SERENITY
+    return context.uc_mcontext.rip;
+#    else
+    return context.uc_mcontext.gregs[REG_RIP];
+#    endif
+}
+
+static void set_instruction_pointer(ucontext_t& context, FlatPtr value)
+{
+#    ifdef AK_OS_SERENITY
+    context.uc_mcontext.rip = value;
+#    else
+    context.uc_mcontext.gregs[REG_RIP] = static_cast<greg_t>(value);
+#    endif
+}
+
+static struct sigaction s_previous_fault_action;
+
+static void handle_fault(int signal, siginfo_t* info, void* ucontext)
+{
+    // Machine code only touches memory past the end of a wasm memory when a bounds check was left out, so a fault on a
+    // guard page in the code of the running module means the access was out of bounds.
+    if (auto* context = s_running_context) {
+        auto& machine_context = *static_cast<ucontext_t*>(ucontext);
+        auto address = bit_cast<FlatPtr>(info->si_addr);
+        auto memory = bit_cast<FlatPtr>(context->memory_base);
+        if (context->module->contains(instruction_pointer(machine_context)) && memory && address >= memory && address < memory + Constants::guarded_memory_reservation_size) {
+            set_instruction_pointer(machine_context, context->module->out_of_bounds_handler());
+            return;
+        }
+    }
+
+    // Anything else isn't ours, so pass it on to whatever handled faults before us. Our handler has to stay installed,
+    // as the modules compiled so far rely on it to catch their out of bounds accesses.
+    if (s_previous_fault_action.sa_flags & SA_SIGINFO) {
+        s_previous_fault_action.sa_sigaction(signal, info, ucontext);
+        return;
+    }
+    if (s_previous_fault_action.sa_handler != SIG_DFL && s_previous_fault_action.sa_handler != SIG_IGN) {
+        s_previous_fault_action.sa_handler(signal);
+        return;
+    }
+
+    // Nothing handled faults before, so this is a crash. Let the instruction fault again with the default action.
+    struct sigaction default_action {};
+    default_action.sa_handler = SIG_DFL;
+    sigemptyset(&default_action.sa_mask);
+    sigaction(signal, &default_action, nullptr);
+}
+
+bool NativeModule::install_fault_handler()
+{
+    static bool s_installed = [] {
+        struct sigaction action {};
+        action.sa_sigaction = handle_fault;
+        action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+        sigemptyset(&action.sa_mask);
+        return sigaction(SIGSEGV, &action, &s_previous_fault_action) == 0;
+    }();
+    return s_installed;
+}
+#else
+bool NativeModule::install_fault_handler()
+{
+    return false;
+}
+#endif
+
+NativeModule::ValueStack& NativeModule::value_stack()
+{
+    static thread_local ValueStack s_value_stack;
+    if (s_value_stack.slots.is_empty()) {
+        s_value_stack.slots = MUST(FixedArray<u64>::create(value_stack_size));
+        s_value_stack.top = s_value_stack.slots.data();
+    }
+    return s_value_stack;
+}
+
+u64 NativeModule::slot_from_value(Value const& value)
+{
+    return value.value().visit(
+        [](i32 value) -> u64 { return static_cast<u32>(value); },
+        [](i64 value) -> u64 { return static_cast<u64>(value); },
+        [](float value) -> u64 { return bit_cast<u32>(value); },
+        [](double value) -> u64 { return bit_cast<u64>(value); },
+        [](auto const&) -> u64 { VERIFY_NOT_REACHED(); });
+}
+
+Value NativeModule::value_from_slot(ValueType type, u64 slot)
+{
+    switch (type.kind()) {
+    case ValueType::I32:
+        return Value { static_cast<i32>(static_cast<u32>(slot)) };
+    case ValueType::I64:
+        return Value { static_cast<i64>(slot) };
+    case ValueType::F32:
+        return Value { bit_cast<float>(static_cast<u32>(slot)) };
+    case ValueType::F64:
+        return Value { bit_cast<double>(slot) };
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+MemoryInstance* NativeModule::memory(Configuration& configuration) const
+{
+    if (m_module.memories().is_empty())
+        return nullptr;
+    return configuration.store().get(m_module.memories().first());
+}
+
+void NativeModule::refresh_memory(Context& context) const
+{
+    auto* memory = this->memory(*context.configuration);
+    if (!memory)
+        return;
+    context.memory_base = memory->data().data();
+    context.memory_size = memory->size();
+}
+
+u64 NativeModule::run(Context& context, size_t function_index, u64* frame) const
+{
+    using EntryFunction = u64 (*)(Context*, u64* frame);
+    auto entry_point = m_entry_points[function_index];
+    VERIFY(entry_point.has_value());
+    return bit_cast<EntryFunction>(static_cast<u8 const*>(m_code) + *entry_point)(&context, frame);
+}
+
+Result NativeModule::call(Configuration& configuration, Interpreter& interpreter, size_t function_index, FunctionType const& type, Vector<Value> arguments) const
+{
+    static thread_local StackInfo s_stack_info;
+
+    auto& stack = value_stack();
+    auto const* stack_end = stack.slots.data() + stack.slots.size();
+    auto* frame = stack.top;
+    if (frame + max(type.parameters().size(), type.results().size()) > stack_end)
+        return Trap { "Call stack exhausted" };
+    for (size_t i = 0; i < arguments.size(); ++i)
+        frame[i] = slot_from_value(arguments[i]);
+
+    Optional<Result> trap;
+    Context context;
+    context.value_stack_end = stack_end;
+    context.native_stack_limit = s_stack_info.base() + Constants::minimum_stack_space_to_keep_free;
+    context.fuel = configuration.should_limit_instruction_count() ? Constants::max_allowed_executed_instructions_per_call : NumericLimits<u64>::max();
+    context.module = this;
+    context.configuration = &configuration;
+    context.interpreter = &interpreter;
+    context.trap = &trap;
+    refresh_memory(context);
+
+    ++Compiler::statistics().native_calls;
+    TemporaryChange running_context { s_running_context, &context };
+    switch (static_cast<Status>(run(context, function_index, frame))) {
+    case Status::Ok:
+        break;
+    case Status::Trapped:
+        return trap.release_value();
+    case Status::Unreachable:
+        return Trap { "Unreachable" };
+    case Status::OutOfBoundsMemoryAccess:
+        return Trap { "Memory access out of bounds" };
+    case Status::StackOverflow:
+        return Trap { "Call stack exhausted" };
+    case Status::ExceededInstructionLimit:
+        return Trap { "Exceeded maximum allowed number of instructions" };
+    }
+
+    // Like Configuration::execute(), this returns the last result first.
+    Vector<Value> results;
+    results.ensure_capacity(type.results().size());
+    for (size_t i = type.results().size(); i > 0; --i)
+        results.unchecked_append(value_from_slot(type.results()[i - 1], frame[i - 1]));
+    return Result { move(results) };
+}
+
+}
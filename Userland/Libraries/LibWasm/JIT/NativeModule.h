@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/FixedArray.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+
+namespace Wasm::JIT {
+
+// Machine code for the functions of a module instance. Compiled functions call each other directly, and call
+// everything else (imports and functions the compiler refused) through the Configuration like the interpreter does.
+//
+// A compiled function is called with the context and a pointer to its frame on the value stack. The frame holds the
+// parameters, then the other locals, then the operand stack, with every value in a 64-bit slot: integers are
+// zero-extended, floats are stored as their bits. A caller leaves the arguments at the top of its own operand stack, so
+// they already are the start of the callee's frame, and the callee leaves its results at the start of its frame.
+class NativeModule {
+    AK_MAKE_NONCOPYABLE(NativeModule);
+    AK_MAKE_NONMOVABLE(NativeModule);
+
+public:
+    // What compiled functions return, 0 means they returned normally.
+    enum class Status : u64 {
+        Ok = 0,
+
+        // A runtime call trapped, and the reason is in the context.
+        Trapped,
+
+        Unreachable,
+        OutOfBoundsMemoryAccess,
+        StackOverflow,
+        ExceededInstructionLimit,
+    };
+
+    struct Context {
+        // The module's memory, as of the last time machine code could have seen it change.
+        u8* memory_base { nullptr };
+        u64 memory_size { 0 };
+
+        u64 const* value_stack_end { nullptr };
+        FlatPtr native_stack_limit { 0 };
+
+        // Counts down on every call and loop iteration, if the module was compiled with an instruction limit.
+        u64 fuel { 0 };
+
+        // Where runtime calls that can trap leave their result.
+        u64 result { 0 };
+
+        NativeModule const* module { nullptr };
+        Configuration* configuration { nullptr };
+        Interpreter* interpreter { nullptr };
+        Optional<Result>* trap { nullptr };
+    };
+
+    NativeModule(ModuleInstance const&, void* code, size_t size, Vector<Optional<size_t>> entry_points, size_t out_of_bounds_handler, Optional<FixedArray<u8>> gdb_object);
+    ~NativeModule();
+
+    bool has_code_for(size_t function_index) const { return m_entry_points[function_index].has_value(); }
+
+    // Calls a compiled function with arguments from C++.
+    Result call(Configuration&, Interpreter&, size_t function_index, FunctionType const&, Vector<Value> arguments) const;
+
+    // Runs a compiled function on a frame that already holds its arguments, and returns its status.
+    u64 run(Context&, size_t function_index, u64* frame) const;
+
+    MemoryInstance* memory(Configuration&) const;
+    void refresh_memory(Context&) const;
+
+    // Makes accesses past the end of memories with guard pages trap when they come from machine code, instead of
+    // crashing. Compiled code may only leave out bounds checks if this succeeded.
+    static bool install_fault_handler();
+
+    static u64 slot_from_value(Value const&);
+    static Value value_from_slot(ValueType, u64 slot);
+
+    // The value stack frames are on, it's shared by all modules on a thread.
+    struct ValueStack {
+        FixedArray<u64> slots;
+        u64* top { nullptr };
+    };
+    static ValueStack& value_stack();
+
+    size_t size() const { return m_size; }
+    bool contains(FlatPtr address) const { return address >= bit_cast<FlatPtr>(m_code) && address < bit_cast<FlatPtr>(m_code) + m_size; }
+    FlatPtr out_of_bounds_handler() const { return bit_cast<FlatPtr>(m_code) + m_out_of_bounds_handler; }
+
+private:
+    ModuleInstance const& m_module;
+    void* m_code { nullptr };
+    size_t m_size { 0 };
+
+    // The offset into the code for every function of the module, or nothing if it wasn't compiled.
+    Vector<Optional<size_t>> m_entry_points;
+
+    // Where functions continue after faulting on a guard page, which makes them return Status::OutOfBoundsMemoryAccess.
+    size_t m_out_of_bounds_handler { 0 };
+
+    Optional<FixedArray<u8>> m_gdb_object;
+};
+
+}
@@ -0,0 +1,541 @@
+// These modules are compiled to machine code unless LIBWASM_JIT=0 is set, and must behave the same either way.
+
+const i32 = 0x7f;
+const i64 = 0x7e;
+const f32 = 0x7d;
+const f64 = 0x7c;
+
+function uleb(value) {
+    const bytes = [];
+    do {
+        let byte = value & 0x7f;
+        value = Math.floor(value / 128);
+        if (value !== 0) byte |= 0x80;
+        bytes.push(byte);
+    } while (value !== 0);
+    return bytes;
+}
+
+function sleb(value) {
+    value = BigInt(value);
+    const bytes = [];
+    while (true) {
+        const byte = Number(value & 0x7fn);
+        value >>= 7n;
+        if ((value === 0n && (byte & 0x40) === 0) || (value === -1n && (byte & 0x40) !== 0)) {
+            bytes.push(byte);
+            return bytes;
+        }
+        bytes.push(byte | 0x80);
+    }
+}
+
+function vector(items) {
+    return [...uleb(items.length), ...items.flat()];
+}
+
+function string(text) {
+    return vector([...text].map(c => c.charCodeAt(0)));
+}
+
+function section(id, contents) {
+    return [id, ...uleb(contents.length), ...contents];
+}
+
+// Builds a module out of functions like { name, params, results, locals, body }, where the body doesn't have the final
+// end. Imported functions come first in the index space, as usual.
+function buildModule({ imports = [], functions, memory, table, types = [] }) {
+    const signatures = [...types];
+    const typeIndex = (params, results) => {
+        const key = `${params}:${results}`;
+        let index = signatures.findIndex(s => `${s.params}:${s.results}` === key);
+        if (index === -1) {
+            signatures.push({ params, results });
+            index = signatures.length - 1;
+        }
+        return index;
+    };
+    const importTypes = imports.map(i => typeIndex(i.params, i.results));
+    const functionTypes = functions.map(f => typeIndex(f.params ?? [], f.results ?? []));
+
+    const bytes = [0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00];
+    bytes.push(...section(1, vector(signatures.map(s => [0x60, ...vector(s.params), ...vector(s.results)]))));
+    if (imports.length !== 0)
+        bytes.push(
+            ...section(2, vector(imports.map((i, index) => [...string(i.module), ...string(i.name), 0x00, ...uleb(importTypes[index])])))
+        );
+    bytes.push(...section(3, vector(functionTypes.map(uleb))));
+    if (table !== undefined) bytes.push(...section(4, vector([[0x70, 0x00, ...uleb(table.length)]])));
+    if (memory !== undefined) bytes.push(...section(5, vector([[0x00, ...uleb(memory)]])));
+
+    const exports = [];
+    functions.forEach((f, index) => {
+        if (f.name !== undefined) exports.push([...string(f.name), 0x00, ...uleb(imports.length + index)]);
+    });
+    bytes.push(...section(7, vector(exports)));
+    if (table !== undefined) bytes.push(...section(9, vector([[0x00, 0x41, 0x00, 0x0b, ...vector(table.map(uleb))]])));
+
+    const code = functions.map(f => {
+        const body = [...vector((f.locals ?? []).map(type => [0x01, type])), ...f.body, 0x0b];
+        return [...uleb(body.length), ...body];
+    });
+    bytes.push(...section(10, vector(code)));
+    return new Uint8Array(bytes);
+}
+
+function instantiate(description) {
+    const module = parseWebAssemblyModule(buildModule(description));
+    return new Proxy(
+        {},
+        {
+            get(_, name) {
+                const address = module.getExport(name);
+                return (...args) => module.invoke(address, ...args);
+            },
+        }
+    );
+}
+
+const op = {
+    unreachable: 0x00,
+    block: 0x02,
+    loop: 0x03,
+    if: 0x04,
+    else: 0x05,
+    end: 0x0b,
+    br: 0x0c,
+    br_if: 0x0d,
+    br_table: 0x0e,
+    return: 0x0f,
+    call: 0x10,
+    call_indirect: 0x11,
+    drop: 0x1a,
+    select: 0x1b,
+    local_get: 0x20,
+    local_set: 0x21,
+    local_tee: 0x22,
+    i32_load: 0x28,
+    i64_load: 0x29,
+    i32_load8_s: 0x2c,
+    i32_load8_u: 0x2d,
+    i32_load16_s: 0x2e,
+    i64_load32_s: 0x34,
+    i32_store: 0x36,
+    i64_store: 0x37,
+    i32_store8: 0x3a,
+    i32_store16: 0x3b,
+    memory_size: 0x3f,
+    memory_grow: 0x40,
+    i32_const: 0x41,
+    i64_const: 0x42,
+    i32_eqz: 0x45,
+    i32_eq: 0x46,
+    i32_lt_s: 0x48,
+    i32_lt_u: 0x49,
+    i32_gt_s: 0x4a,
+    i32_ge_u: 0x4f,
+    i64_eq: 0x51,
+    i64_lt_s: 0x53,
+    f64_lt: 0x63,
+    i32_clz: 0x67,
+    i32_popcnt: 0x69,
+    i32_add: 0x6a,
+    i32_sub: 0x6b,
+    i32_mul: 0x6c,
+    i32_div_s: 0x6d,
+    i32_div_u: 0x6e,
+    i32_rem_s: 0x6f,
+    i32_and: 0x71,
+    i32_or: 0x72,
+    i32_xor: 0x73,
+    i32_shl: 0x74,
+    i32_shr_s: 0x75,
+    i32_shr_u: 0x76,
+    i32_rotl: 0x77,
+    i64_add: 0x7c,
+    i64_sub: 0x7d,
+    i64_mul: 0x7e,
+    i64_shl: 0x86,
+    i64_shr_u: 0x88,
+    f64_sqrt: 0x9f,
+    f64_add: 0xa0,
+    f64_mul: 0xa2,
+    i32_wrap_i64: 0xa7,
+    i32_trunc_f64_s: 0xaa,
+    i64_extend_i32_s: 0xac,
+    i64_extend_i32_u: 0xad,
+    f64_convert_i32_s: 0xb7,
+    i32_extend8_s: 0xc0,
+};
+
+const block = (type = 0x40) => [op.block, type];
+const loop = (type = 0x40) => [op.loop, type];
+const if_ = (type = 0x40) => [op.if, type];
+const get = index => [op.local_get, index];
+const set = index => [op.local_set, index];
+const tee = index => [op.local_tee, index];
+const i32Const = value => [op.i32_const, ...sleb(value)];
+const i64Const = value => [op.i64_const, ...sleb(value)];
+const memarg = (align, offset = 0) => [align, ...uleb(offset)];
+
+test("Integer arithmetic", () => {
+    const binary = (name, opcode, type = i32) => ({
+        name,
+        params: [type, type],
+        results: [type],
+        body: [...get(0), ...get(1), opcode],
+    });
+    const m = instantiate({
+        functions: [
+            binary("add", op.i32_add),
+            binary("sub", op.i32_sub),
+            binary("mul", op.i32_mul),
+            binary("div_s", op.i32_div_s),
+            binary("div_u", op.i32_div_u),
+            binary("rem_s", op.i32_rem_s),
+            binary("shl", op.i32_shl),
+            binary("shr_s", op.i32_shr_s),
+            binary("shr_u", op.i32_shr_u),
+            binary("rotl", op.i32_rotl),
+            binary("lt_s", op.i32_lt_s),
+            binary("lt_u", op.i32_lt_u),
+            binary("add64", op.i64_add, i64),
+            binary("mul64", op.i64_mul, i64),
+            binary("shl64", op.i64_shl, i64),
+            binary("shr_u64", op.i64_shr_u, i64),
+            {
+                name: "constants",
+                params: [i32],
+                results: [i32],
+                body: [
+                    ...get(0), ...i32Const(-7), op.i32_add,
+                    ...i32Const(0x7fffffff), op.i32_xor,
+                    ...i32Const(3), op.i32_shr_u,
+                    ...i32Const(0x12345), op.i32_mul,
+                    ...i32Const(-1), op.i32_and,
+                ],
+            },
+            {
+                name: "unary",
+                params: [i32],
+                results: [i32],
+                body: [...get(0), op.i32_clz, ...get(0), op.i32_popcnt, op.i32_add, ...get(0), op.i32_extend8_s, op.i32_add, ...get(0), op.i32_eqz, op.i32_add],
+            },
+            {
+                name: "widen",
+                params: [i32],
+                results: [i64],
+                body: [...get(0), op.i64_extend_i32_s, ...get(0), op.i64_extend_i32_u, ...i64Const(32), op.i64_shl, op.i64_add],
+            },
+            {
+                name: "narrow",
+                params: [i64],
+                results: [i32],
+                body: [...get(0), op.i32_wrap_i64, ...i32Const(1), op.i32_add],
+            },
+        ],
+    });
+
+    expect(m.add(0x7fffffff, 1)).toBe(-0x80000000);
+    expect(m.sub(5, 7)).toBe(-2);
+    expect(m.mul(0x10001, 0x10001)).toBe(Math.imul(0x10001, 0x10001));
+    expect(m.div_s(-7, 2)).toBe(-3);
+    expect(m.div_u(-7, 2)).toBe(0x7ffffffc);
+    expect(m.rem_s(-7, 2)).toBe(-1);
+    expect(() => m.div_s(1, 0)).toThrowWithMessage(TypeError, "Execution trapped");
+    expect(() => m.div_s(-0x80000000, -1)).toThrowWithMessage(TypeError, "Execution trapped");
+    expect(m.shl(1, 33)).toBe(2);
+    expect(m.shr_s(-16, 2)).toBe(-4);
+    expect(m.shr_u(-16, 2)).toBe(0x3ffffffc);
+    expect(m.rotl(0x80000001, 1)).toBe(3);
+    expect(m.lt_s(-1, 1)).toBe(1);
+    expect(m.lt_u(-1, 1)).toBe(0);
+    expect(m.add64(0xffffffffn, 1n)).toBe(0x100000000n);
+    expect(m.mul64(0x100000000n, 0x100000000n)).toBe(0n);
+    expect(m.mul64(-3n, 0x123456789n)).toBe(-3n * 0x123456789n);
+    expect(m.shl64(1n, 63n)).toBe(-0x8000000000000000n);
+    expect(m.shr_u64(-1n, 60n)).toBe(15n);
+
+    for (const x of [0, 1, -1, 12345, -0x80000000, 0x7fffffff]) {
+        const expected = Math.imul((((x - 7) | 0) ^ 0x7fffffff) >>> 3, 0x12345) | 0;
+        expect(m.constants(x)).toBe(expected);
+    }
+    expect(m.unary(0)).toBe(32 + 0 + 0 + 1);
+    expect(m.unary(0xff)).toBe(24 + 8 - 1 + 0);
+    expect(m.widen(-1)).toBe(-0x100000001n);
+    expect(m.widen(5)).toBe(0x500000005n);
+    expect(m.narrow(0x1ffffffffn)).toBe(0);
+});
+
+test("Values that don't fit in registers", () => {
+    // Sums (local + i) for i up to 11, with every value on the stack at once.
+    const body = [];
+    for (let i = 0; i < 12; ++i) body.push(...get(0), ...i32Const(i), op.i32_add);
+    for (let i = 0; i < 11; ++i) body.push(op.i32_add);
+    const m = instantiate({ functions: [{ name: "sum", params: [i32], results: [i32], body }] });
+    expect(m.sum(100)).toBe(1200 + 66);
+});
+
+test("Control flow", () => {
+    const m = instantiate({
+        functions: [
+            {
+                // Sums the numbers up to n.
+                name: "triangle",
+                params: [i32],
+                results: [i32],
+                locals: [i32],
+                body: [
+                    ...block(), ...loop(),
+                    ...get(0), op.i32_eqz, op.br_if, 1,
+                    ...get(1), ...get(0), op.i32_add, ...set(1),
+                    ...get(0), ...i32Const(1), op.i32_sub, ...set(0),
+                    op.br, 0,
+                    op.end, op.end,
+                    ...get(1),
+                ],
+            },
+            {
+                name: "switch",
+                params: [i32],
+                results: [i32],
+                body: [
+                    ...block(), ...block(), ...block(),
+                    ...get(0), op.br_table, ...vector([[0], [1]]), 2,
+                    op.end, ...i32Const(10), op.return,
+                    op.end, ...i32Const(20), op.return,
+                    op.end, ...i32Const(30),
+                ],
+            },
+            {
+                name: "choose",
+                params: [i32, i32, i32],
+                results: [i32],
+                body: [
+                    ...get(0), ...if_(i32), ...get(1), op.else, ...get(2), op.end,
+                    ...get(1), ...get(2), ...get(0), op.select,
+                    op.i32_add,
+                ],
+            },
+            {
+                // Branches out of a nested block with a value, leaving other values behind on the stack.
+                name: "early",
+                params: [i32],
+                results: [i32],
+                body: [
+                    ...i32Const(1000),
+                    ...block(i32),
+                    ...i32Const(1), ...i32Const(2),
+                    ...block(i32), ...i32Const(7), ...get(0), op.br_if, 1, op.drop, ...i32Const(8), op.end,
+                    op.i32_add, op.i32_add,
+                    op.end,
+                    op.i32_add,
+                ],
+            },
+            {
+                name: "trap",
+                params: [i32],
+                results: [i32],
+                body: [...get(0), ...if_(), op.unreachable, op.end, ...i32Const(5)],
+            },
+        ],
+    });
+
+    expect(m.triangle(0)).toBe(0);
+    expect(m.triangle(100)).toBe(5050);
+    expect(m.switch(0)).toBe(10);
+    expect(m.switch(1)).toBe(20);
+    expect(m.switch(2)).toBe(30);
+    expect(m.switch(-1)).toBe(30);
+    expect(m.choose(1, 3, 4)).toBe(6);
+    expect(m.choose(0, 3, 4)).toBe(8);
+    expect(m.early(1)).toBe(1007);
+    expect(m.early(0)).toBe(1011);
+    expect(m.trap(0)).toBe(5);
+    expect(() => m.trap(1)).toThrowWithMessage(TypeError, "Execution trapped: Unreachable");
+});
+
+test("Calls", () => {
+    const m = instantiate({
+        imports: [{ module: "spectest", name: "print_i32", params: [i32], results: [] }],
+        table: [4, 2],
+        functions: [
+            {
+                name: "fib",
+                params: [i32],
+                results: [i32],
+                body: [
+                    ...get(0), ...i32Const(2), op.i32_lt_s,
+                    ...if_(i32),
+                    ...get(0),
+                    op.else,
+                    ...get(0), ...i32Const(1), op.i32_sub, op.call, 1,
+                    ...get(0), ...i32Const(2), op.i32_sub, op.call, 1,
+                    op.i32_add,
+                    op.end,
+                ],
+            },
+            {
+                name: "factorial",
+                params: [i64],
+                results: [i64],
+                body: [
+                    ...get(0), ...i64Const(2), op.i64_lt_s,
+                    ...if_(i64), ...i64Const(1),
+                    op.else, ...get(0), ...get(0), ...i64Const(1), op.i64_sub, op.call, 2, op.i64_mul,
+                    op.end,
+                ],
+            },
+            {
+                name: "indirect",
+                params: [i32, i32],
+                results: [i32],
+                body: [...i32Const(100), ...get(1), ...get(0), op.call_indirect, 1, 0x00, op.i32_add],
+            },
+            {
+                name: "imported",
+                params: [i32],
+                results: [i32],
+                body: [...get(0), op.call, 0, ...i32Const(7), ...get(0), op.i32_mul],
+            },
+            {
+                name: "recurse",
+                params: [],
+                results: [],
+                body: [op.call, 5],
+            },
+        ],
+    });
+
+    expect(m.fib(20)).toBe(6765);
+    expect(m.factorial(20n)).toBe(2432902008176640000n);
+    expect(m.indirect(0, 10)).toBe(170);
+    expect(() => m.indirect(1, 10)).toThrowWithMessage(TypeError, "Execution trapped");
+    expect(() => m.indirect(2, 10)).toThrowWithMessage(TypeError, "Execution trapped");
+    expect(m.imported(6)).toBe(42);
+    expect(() => m.recurse()).toThrowWithMessage(TypeError, "Execution trapped");
+    // Running out of stack doesn't leave anything behind.
+    expect(m.fib(10)).toBe(55);
+});
+
+test("Memory", () => {
+    const m = instantiate({
+        memory: 1,
+        functions: [
+            {
+                name: "store",
+                params: [i32, i32],
+                results: [],
+                body: [...get(0), ...get(1), op.i32_store, ...memarg(2)],
+            },
+            {
+                name: "load",
+                params: [i32],
+                results: [i32],
+                body: [...get(0), op.i32_load, ...memarg(2)],
+            },
+            {
+                name: "narrow",
+                params: [i32],
+                results: [i32],
+                body: [
+                    ...get(0), ...i32Const(0x1234abcd), op.i32_store, ...memarg(2, 16),
+                    ...get(0), ...i32Const(0x99), op.i32_store8, ...memarg(0, 20),
+                    ...get(0), ...i32Const(-2), op.i32_store16, ...memarg(1, 22),
+                    ...get(0), op.i32_load8_u, ...memarg(0, 16),
+                    ...get(0), op.i32_load8_s, ...memarg(0, 20), op.i32_add,
+                    ...get(0), op.i32_load16_s, ...memarg(1, 22), op.i32_add,
+                ],
+            },
+            {
+                name: "wide",
+                params: [i32, i64],
+                results: [i64],
+                body: [
+                    ...get(0), ...get(1), op.i64_store, ...memarg(3),
+                    ...get(0), op.i64_load32_s, ...memarg(2, 4),
+                    ...get(0), op.i64_load, ...memarg(3), op.i64_add,
+                ],
+            },
+            {
+                name: "grow",
+                params: [i32],
+                results: [i32],
+                body: [...get(0), op.memory_grow, 0x00, op.drop, ...i32Const(-4), op.memory_size, 0x00, op.i32_add],
+            },
+            {
+                name: "far",
+                params: [i32],
+                results: [i32],
+                body: [...get(0), op.i32_load, ...memarg(2, 0xfffffff0)],
+            },
+            {
+                name: "fill",
+                params: [i32, i32, i32],
+                results: [],
+                body: [...get(0), ...get(1), ...get(2), 0xfc, 0x0b, 0x00],
+            },
+        ],
+    });
+
+    m.store(8, 0x11223344);
+    expect(m.load(8)).toBe(0x11223344);
+    expect(m.load(9)).toBe(0x00112233);
+    m.store(65532, -1);
+    expect(m.load(65532)).toBe(-1);
+    expect(() => m.load(65533)).toThrowWithMessage(TypeError, "Execution trapped");
+    expect(() => m.load(-1)).toThrowWithMessage(TypeError, "Execution trapped");
+    expect(() => m.store(65536, 1)).toThrowWithMessage(TypeError, "Execution trapped");
+    expect(() => m.far(0)).toThrowWithMessage(TypeError, "Execution trapped");
+    expect(() => m.far(-1)).toThrowWithMessage(TypeError, "Execution trapped");
+
+    // Stores that are partially out of bounds don't write anything.
+    expect(() => m.store(65534, 0x12345678)).toThrowWithMessage(TypeError, "Execution trapped");
+    expect(m.load(65532)).toBe(-1);
+
+    expect(m.narrow(0)).toBe(0xcd + -0x67 + -2);
+    expect(m.wide(0, -0x100000000n)).toBe(-0x100000000n + -1n);
+
+    m.fill(100, 0xab, 4);
+    expect(m.load(100)).toBe(-0x54545455);
+    expect(() => m.fill(65535, 0, 2)).toThrowWithMessage(TypeError, "Execution trapped");
+
+    // Growing makes the new pages usable right away, in the same call and in later ones.
+    expect(m.grow(1)).toBe(-2);
+    m.store(65536, 42);
+    expect(m.load(65536)).toBe(42);
+    expect(m.load(8)).toBe(0x11223344);
+    expect(m.grow(0x10000)).toBe(-2);
+});
+
+test("Floating point", () => {
+    const m = instantiate({
+        functions: [
+            {
+                name: "hypot",
+                params: [f64, f64],
+                results: [f64],
+                body: [...get(0), ...get(0), op.f64_mul, ...get(1), ...get(1), op.f64_mul, op.f64_add, op.f64_sqrt],
+            },
+            {
+                name: "less",
+                params: [i32, f64],
+                results: [i32],
+                body: [...get(0), op.f64_convert_i32_s, ...get(1), op.f64_lt],
+            },
+            {
+                name: "truncate",
+                params: [f64],
+                results: [i32],
+                body: [...get(0), op.i32_trunc_f64_s],
+            },
+        ],
+    });
+
+    expect(m.hypot(3, 4)).toBe(5);
+    expect(m.less(-3, -2.5)).toBe(1);
+    expect(m.less(3, 2.5)).toBe(0);
+    expect(m.truncate(-7.9)).toBe(-7);
+    expect(() => m.truncate(NaN)).toThrowWithMessage(TypeError, "Execution trapped");
+    expect(() => m.truncate(1e10)).toThrowWithMessage(TypeError, "Execution trapped");
+});
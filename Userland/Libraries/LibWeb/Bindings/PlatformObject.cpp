@@ -25,6 +25,15 @@ PlatformObject::PlatformObject(JS::Object& prototype, MayInterfereWithIndexedPro
 
 PlatformObject::~PlatformObject() = default;
 
+void PlatformObject::initialize(JS::Realm& realm)
+{
+    Base::initialize(realm);
+
+    // NOTE: Named properties are not in the shape, so objects that have them must not use prototype chain caches.
+    if (m_legacy_platform_object_flags.has_value() && m_legacy_platform_object_flags->supports_named_properties)
+        set_may_interfere_with_prototype_chain_caching();
+}
+
 JS::Realm& PlatformObject::realm() const
 {
     return shape().realm();
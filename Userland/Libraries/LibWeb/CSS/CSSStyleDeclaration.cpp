@@ -23,6 +23,8 @@ JS_DEFINE_ALLOCATOR(ElementInlineCSSStyleDeclaration);
 CSSStyleDeclaration::CSSStyleDeclaration(JS::Realm& realm)
     : PlatformObject(realm)
 {
+    // NOTE: CSS properties are not in the shape, see internal_get() and internal_set().
+    set_may_interfere_with_prototype_chain_caching();
 }
 
 void CSSStyleDeclaration::initialize(JS::Realm& realm)
@@ -348,6 +348,16 @@ void EventLoop::process()
         //    perform the start an idle period algorithm for win with computeDeadline. [REQUESTIDLECALLBACK]
         for (auto& win : same_loop_windows())
             win->start_an_idle_period();
+
+        // NOTE: Destroy the cells that were left behind by lazy sweeping now, rather than in a later task.
+        heap().sweep_unswept_cells();
+
+        // NOTE: Likewise, get on with marking the heap if a major collection is underway, for as long as the idle period lasts.
+        if (heap().is_marking_incrementally()) {
+            auto remaining_milliseconds = compute_deadline() - HighResolutionTime::unsafe_shared_current_time();
+            if (remaining_milliseconds > 0)
+                heap().perform_incremental_marking_step(Duration::from_microseconds(static_cast<i64>(remaining_milliseconds * 1000)));
+        }
     }
 
     // FIXME: 14. If this is a worker event loop, then:
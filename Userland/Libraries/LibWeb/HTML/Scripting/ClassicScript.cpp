@@ -6,8 +6,13 @@
 
 #include <AK/Debug.h>
 #include <LibCore/ElapsedTimer.h>
+#include <LibCore/EventLoop.h>
 #include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/ProgramCache.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibThreading/Thread.h>
 #include <LibWeb/Bindings/ExceptionOrUtils.h>
+#include <LibWeb/HTML/EventLoop/EventLoop.h>
 #include <LibWeb/HTML/Scripting/ClassicScript.h>
 #include <LibWeb/HTML/Scripting/Environments.h>
 #include <LibWeb/HTML/Scripting/ExceptionReporter.h>
@@ -17,21 +22,103 @@ namespace Web::HTML {
 
 JS_DEFINE_ALLOCATOR(ClassicScript);
 
+// Scripts that are being parsed off the main thread, only ever touched on the main thread.
+static HashMap<u64, NonnullRefPtr<Threading::Thread>> s_parsing_threads;
+static u64 s_next_parsing_thread_id { 0 };
+
 // https://html.spec.whatwg.org/multipage/webappapis.html#creating-a-classic-script
 JS::NonnullGCPtr<ClassicScript> ClassicScript::create(ByteString filename, StringView source, EnvironmentSettingsObject& environment_settings_object, URL::URL base_url, size_t source_line_number, MutedErrors muted_errors)
+{
+    // 1. If muted errors was not provided, let it be false. (NOTE: This is taken care of by the default argument.)
+
+    // 3. If scripting is disabled for settings, then set source to the empty string.
+    if (environment_settings_object.is_scripting_disabled())
+        source = ""sv;
+
+    // NOTE: Steps 2 and 4 to 9 don't depend on source.
+    auto script = create_without_record(move(filename), environment_settings_object, move(base_url), muted_errors);
+
+    // 10. Let result be ParseScript(source, settings's Realm, script).
+    auto parse_timer = Core::ElapsedTimer::start_new();
+    auto result = JS::Script::parse(source, environment_settings_object.realm(), script->filename(), script, source_line_number);
+    dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Parsed {} in {}ms", script->filename(), parse_timer.elapsed());
+
+    // 11. and 12.
+    script->set_parse_result(move(result));
+
+    // 13. Return script.
+    return script;
+}
+
+// https://html.spec.whatwg.org/multipage/webappapis.html#creating-a-classic-script
+void ClassicScript::create_off_the_main_thread(ByteString filename, String const& source, EnvironmentSettingsObject& environment_settings_object, URL::URL base_url, MutedErrors muted_errors, OnCreated on_complete)
 {
     auto& vm = environment_settings_object.realm().vm();
 
-    // 1. If muted errors was not provided, let it be false. (NOTE: This is taken care of by the default argument.)
+    // NOTE: Handing a script to another thread only pays off if parsing it takes a while, and scripts that are already
+    //       in the program cache don't have to be parsed at all.
+    if (environment_settings_object.is_scripting_disabled()
+        || source.bytes().size() < minimum_source_length_to_parse_off_the_main_thread
+        || vm.program_cache().get(source, filename, 1, JS::ProgramCache::Goal::Script)) {
+        on_complete->function()(create(move(filename), source, environment_settings_object, move(base_url), 1, muted_errors));
+        return;
+    }
+
+    // NOTE: The parsing thread only gets ByteStrings, which are safe to share between threads. Everything else is only
+    //       touched here, and once parsing is done and we're back on this thread.
+    auto on_parsed = [&vm, filename, settings_handle = JS::make_handle(environment_settings_object), base_url = move(base_url), muted_errors, on_complete_handle = JS::make_handle(on_complete)](ParseResult result) mutable {
+        JS::NonnullGCPtr<EnvironmentSettingsObject> settings = *settings_handle;
+        OnCreated on_complete = *on_complete_handle;
+        settings_handle = {};
+        on_complete_handle = {};
+
+        if (!result.is_error())
+            vm.program_cache().set(1, JS::ProgramCache::Goal::Script, result.value());
+
+        queue_global_task(Task::Source::Networking, settings->global_object(), JS::create_heap_function(vm.heap(), [settings, filename = move(filename), base_url = move(base_url), muted_errors, on_complete, result = move(result)]() mutable {
+            auto script = create_without_record(move(filename), *settings, move(base_url), muted_errors);
+
+            // 10. Let result be ParseScript(source, settings's Realm, script).
+            if (result.is_error())
+                script->set_parse_result(result.release_error());
+            else
+                script->set_parse_result(JS::Script::create(settings->realm(), script->filename(), result.release_value(), script));
+
+            // 13. Return script.
+            on_complete->function()(script);
+        }));
+    };
+
+    auto id = s_next_parsing_thread_id++;
+    auto& origin_event_loop = Core::EventLoop::current();
+    auto thread = Threading::Thread::construct([id, &origin_event_loop, source = source.to_byte_string(), filename, on_parsed = move(on_parsed)]() mutable -> intptr_t {
+        auto parse_timer = Core::ElapsedTimer::start_new();
+        auto result = JS::Script::parse_program(source, filename);
+        dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Parsed {} off the main thread in {}ms", filename, parse_timer.elapsed());
+
+        origin_event_loop.deferred_invoke([id, result = move(result), on_parsed = move(on_parsed)]() mutable {
+            // NOTE: The thread is done with everything but exiting by now.
+            auto thread = s_parsing_threads.take(id).release_value();
+            (void)thread->join();
+
+            on_parsed(move(result));
+        });
+        origin_event_loop.wake();
+        return 0;
+    },
+        "ScriptParser"sv);
+    s_parsing_threads.set(id, thread);
+    thread->start();
+}
+
+JS::NonnullGCPtr<ClassicScript> ClassicScript::create_without_record(ByteString filename, EnvironmentSettingsObject& environment_settings_object, URL::URL base_url, MutedErrors muted_errors)
+{
+    auto& vm = environment_settings_object.realm().vm();
 
     // 2. If muted errors is true, then set baseURL to about:blank.
     if (muted_errors == MutedErrors::Yes)
         base_url = "about:blank"sv;
 
-    // 3. If scripting is disabled for settings, then set source to the empty string.
-    if (environment_settings_object.is_scripting_disabled())
-        source = ""sv;
-
     // 4. Let script be a new classic script that this algorithm will subsequently initialize.
     auto script = vm.heap().allocate_without_realm<ClassicScript>(move(base_url), move(filename), environment_settings_object);
 
@@ -48,29 +135,26 @@ JS::NonnullGCPtr<ClassicScript> ClassicScript::create(ByteString filename, Strin
     script->set_parse_error(JS::js_null());
     script->set_error_to_rethrow(JS::js_null());
 
-    // 10. Let result be ParseScript(source, settings's Realm, script).
-    auto parse_timer = Core::ElapsedTimer::start_new();
-    auto result = JS::Script::parse(source, environment_settings_object.realm(), script->filename(), script, source_line_number);
-    dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Parsed {} in {}ms", script->filename(), parse_timer.elapsed());
+    return script;
+}
 
+void ClassicScript::set_parse_result(Result<JS::NonnullGCPtr<JS::Script>, Vector<JS::ParserError>> result)
+{
     // 11. If result is a list of errors, then:
     if (result.is_error()) {
-        auto& parse_error = result.error().first();
-        dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Failed to parse: {}", parse_error.to_string());
+        auto& error = result.error().first();
+        dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Failed to parse: {}", error.to_string());
 
         // 1. Set script's parse error and its error to rethrow to result[0].
-        script->set_parse_error(JS::SyntaxError::create(environment_settings_object.realm(), parse_error.to_string()));
-        script->set_error_to_rethrow(script->parse_error());
+        set_parse_error(JS::SyntaxError::create(settings_object().realm(), error.to_string()));
+        set_error_to_rethrow(parse_error());
 
         // 2. Return script.
-        return script;
+        return;
     }
 
     // 12. Set script's record to result.
-    script->m_script_record = *result.release_value();
-
-    // 13. Return script.
-    return script;
+    m_script_record = *result.release_value();
 }
 
 // https://html.spec.whatwg.org/multipage/webappapis.html#run-a-classic-script
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <LibJS/Heap/HeapFunction.h>
 #include <LibJS/Script.h>
 #include <LibWeb/Forward.h>
 #include <LibWeb/HTML/Scripting/Script.h>
@@ -26,6 +27,12 @@ public:
     };
     static JS::NonnullGCPtr<ClassicScript> create(ByteString filename, StringView source, EnvironmentSettingsObject&, URL::URL base_url, size_t source_line_number = 1, MutedErrors = MutedErrors::No);
 
+    // Like create(), but parses big scripts on a background thread, so the main thread can keep going in the meantime.
+    // on_complete is then run in a networking task. Scripts that are small or already in the program cache are created
+    // right away instead.
+    using OnCreated = JS::NonnullGCPtr<JS::HeapFunction<void(JS::NonnullGCPtr<ClassicScript>)>>;
+    static void create_off_the_main_thread(ByteString filename, String const& source, EnvironmentSettingsObject&, URL::URL base_url, MutedErrors, OnCreated on_complete);
+
     JS::Script* script_record() { return m_script_record; }
     JS::Script const* script_record() const { return m_script_record; }
 
@@ -40,6 +47,12 @@ public:
 private:
     ClassicScript(URL::URL base_url, ByteString filename, EnvironmentSettingsObject& environment_settings_object);
 
+    static constexpr size_t minimum_source_length_to_parse_off_the_main_thread = 64 * KiB;
+
+    using ParseResult = Result<NonnullRefPtr<JS::Program>, Vector<JS::ParserError>>;
+    static JS::NonnullGCPtr<ClassicScript> create_without_record(ByteString filename, EnvironmentSettingsObject&, URL::URL base_url, MutedErrors);
+    void set_parse_result(Result<JS::NonnullGCPtr<JS::Script>, Vector<JS::ParserError>>);
+
     virtual void visit_edges(Cell::Visitor&) override;
 
     JS::GCPtr<JS::Script> m_script_record;
@@ -332,11 +332,12 @@ WebIDL::ExceptionOr<void> fetch_classic_script(JS::NonnullGCPtr<HTMLScriptElemen
         // 7. Let script be the result of creating a classic script given source text, settings object, response's URL,
         //    options, and muted errors.
         // FIXME: Pass options.
+        // OPTIMIZATION: Big scripts are parsed on a background thread, so this one can keep going in the meantime.
         auto response_url = response->url().value_or({});
-        auto script = ClassicScript::create(response_url.to_byte_string(), source_text, settings_object, response_url, 1, muted_errors);
-
-        // 8. Run onComplete given script.
-        on_complete->function()(script);
+        ClassicScript::create_off_the_main_thread(response_url.to_byte_string(), source_text, settings_object, response_url, muted_errors, JS::create_heap_function(settings_object.heap(), [on_complete](JS::NonnullGCPtr<ClassicScript> script) {
+            // 8. Run onComplete given script.
+            on_complete->function()(script);
+        }));
     };
 
     TRY(Fetch::Fetching::fetch(element->realm(), request, Fetch::Infrastructure::FetchAlgorithms::create(vm, move(fetch_algorithms_input))));
@@ -737,13 +738,13 @@ void fetch_external_module_script_graph(JS::Realm& realm, URL::URL const& url, E
 }
 
 // https://html.spec.whatwg.org/multipage/webappapis.html#fetch-an-inline-module-script-graph
-void fetch_inline_module_script_graph(JS::Realm& realm, ByteString const& filename, ByteString const& source_text, URL::URL const& base_url, EnvironmentSettingsObject& settings_object, OnFetchScriptComplete on_complete)
+void fetch_inline_module_script_graph(JS::Realm& realm, ByteString const& filename, ByteString const& source_text, URL::URL const& base_url, size_t source_line_number, EnvironmentSettingsObject& settings_object, OnFetchScriptComplete on_complete)
 {
     // 1. Disallow further import maps given settingsObject.
     settings_object.disallow_further_import_maps();
 
     // 2. Let script be the result of creating a JavaScript module script using sourceText, settingsObject, baseURL, and options.
-    auto script = JavaScriptModuleScript::create(filename, source_text.view(), settings_object, base_url).release_value_but_fixme_should_propagate_errors();
+    auto script = JavaScriptModuleScript::create(filename, source_text.view(), settings_object, base_url, source_line_number).release_value_but_fixme_should_propagate_errors();
 
     // 3. If script is null, run onComplete given null, and return.
     if (!script) {
@@ -30,7 +30,7 @@ JavaScriptModuleScript::JavaScriptModuleScript(URL::URL base_url, ByteString fil
 }
 
 // https://html.spec.whatwg.org/multipage/webappapis.html#creating-a-javascript-module-script
-WebIDL::ExceptionOr<JS::GCPtr<JavaScriptModuleScript>> JavaScriptModuleScript::create(ByteString const& filename, StringView source, EnvironmentSettingsObject& settings_object, URL::URL base_url)
+WebIDL::ExceptionOr<JS::GCPtr<JavaScriptModuleScript>> JavaScriptModuleScript::create(ByteString const& filename, StringView source, EnvironmentSettingsObject& settings_object, URL::URL base_url, size_t source_line_number)
 {
     // 1. If scripting is disabled for settings, then set source to the empty string.
     if (settings_object.is_scripting_disabled())
@@ -54,7 +54,7 @@ WebIDL::ExceptionOr<JS::GCPtr<JavaScriptModuleScript>> JavaScriptModuleScript::c
     script->set_error_to_rethrow(JS::js_null());
 
     // 7. Let result be ParseModule(source, settings's Realm, script).
-    auto result = JS::SourceTextModule::parse(source, settings_object.realm(), filename.view(), script);
+    auto result = JS::SourceTextModule::parse(source, settings_object.realm(), filename.view(), script, source_line_number);
 
     // 8. If result is a list of errors, then:
     if (result.is_error()) {
@@ -386,7 +386,7 @@ void ResourceLoader::load(LoadRequest& request, SuccessCallback success_callback
 
         HashMap<ByteString, ByteString> headers;
         headers.set("User-Agent", m_user_agent.to_byte_string());
-        headers.set("Accept-Encoding", "gzip, deflate, br");
+        headers.set("Accept-Encoding", "gzip, deflate, br, zstd");
 
         for (auto& it : request.headers()) {
             headers.set(it.key, it.value);
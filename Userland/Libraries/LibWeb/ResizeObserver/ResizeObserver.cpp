@@ -51,6 +51,7 @@ void ResizeObserver::visit_edges(JS::Cell::Visitor& visitor)
 
 void ResizeObserver::finalize()
 {
+    Base::finalize();
     if (m_document)
         m_document->unregister_resize_observer({}, *this);
 }
@@ -18,7 +18,7 @@ JS::NonnullGCPtr<ObservableArray> ObservableArray::create(JS::Realm& realm)
 }
 
 ObservableArray::ObservableArray(Object& prototype)
-    : JS::Array(prototype)
+    : JS::Array(prototype, MayInterfereWithIndexedPropertyAccess::Yes)
 {
 }
 
@@ -12,6 +12,7 @@
 #include <LibCore/System.h>
 #include <LibFileSystem/FileSystem.h>
 #include <LibIPC/SingleServer.h>
+#include <LibJS/BytecodeCache.h>
 #include <LibMain/Main.h>
 #include <LibWeb/Bindings/MainThreadVM.h>
 #include <LibWeb/Loader/ResourceLoader.h>
@@ -27,7 +28,7 @@
 ErrorOr<int> serenity_main(Main::Arguments)
 {
     Core::EventLoop event_loop;
-    TRY(Core::System::pledge("stdio recvfd sendfd accept unix rpath thread proc map_fixed"));
+    TRY(Core::System::pledge("stdio recvfd sendfd accept unix rpath wpath cpath thread proc map_fixed"));
 
     // This must be first; we can't check if /tmp/webdriver exists once we've unveiled other paths.
     auto webdriver_socket_path = ByteString::formatted("{}/webdriver", TRY(Core::StandardPaths::runtime_directory()));
@@ -40,6 +41,12 @@ ErrorOr<int> serenity_main(Main::Arguments)
     TRY(Core::System::unveil("/tmp/session/%sid/portal/audio", "rw"));
     TRY(Core::System::unveil("/tmp/session/%sid/portal/request", "rw"));
     TRY(Core::System::unveil("/tmp/session/%sid/portal/image", "rw"));
+
+    auto bytecode_cache_path = ByteString::formatted("{}/WebContent/bytecode-cache", Core::StandardPaths::data_directory());
+    if (auto result = JS::BytecodeCache::enable(bytecode_cache_path); result.is_error())
+        dbgln("Failed to enable the bytecode cache: {}", result.error());
+    else
+        TRY(Core::System::unveil(bytecode_cache_path, "rwc"sv));
     TRY(Core::System::unveil(nullptr, nullptr));
 
     Web::Platform::EventLoopPlugin::install(*new Web::Platform::EventLoopPluginSerenity);
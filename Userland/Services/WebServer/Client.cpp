@@ -97,6 +97,26 @@ ErrorOr<void, Client::WrappedError> Client::on_ready_to_read()
     return {};
 }
 
+static bool accepts_encoding(HTTP::HttpRequest const& request, StringView encoding)
+{
+    for (auto const& header : request.headers()) {
+        if (!header.name.equals_ignoring_ascii_case("Accept-Encoding"sv))
+            continue;
+        for (auto coding : header.value.split_view(',')) {
+            auto parameters = coding.split_view(';');
+            if (parameters.is_empty() || !parameters[0].trim_whitespace().equals_ignoring_ascii_case(encoding))
+                continue;
+            // A quality value of zero means that the client doesn't want this encoding after all.
+            auto is_refused = any_of(parameters.span().slice(1), [](StringView parameter) {
+                auto value = parameter.trim_whitespace();
+                return value.starts_with("q="sv, CaseSensitivity::CaseInsensitive) && value.substring_view(2).to_number<double>().value_or(1) == 0;
+            });
+            return !is_refused;
+        }
+    }
+    return false;
+}
+
 ErrorOr<bool> Client::handle_request(HTTP::HttpRequest const& request)
 {
     auto resource_decoded = URL::percent_decode(request.resource());
@@ -166,11 +186,23 @@ ErrorOr<bool> Client::handle_request(HTTP::HttpRequest const& request)
         return false;
     }
 
-    auto stream = TRY(Core::File::open(real_path.bytes_as_string_view(), Core::File::OpenMode::Read));
+    // Serve a precompressed sibling (see `brotli --precompress`) instead of the file itself to clients that accept it.
+    auto content_path = real_path;
+    Optional<StringView> encoding;
+    auto compressed_path = TRY(String::formatted("{}.br", real_path));
+    auto has_compressed_sibling = FileSystem::exists(compressed_path.bytes_as_string_view()) && !Core::System::access(compressed_path.bytes_as_string_view(), R_OK).is_error();
+    if (has_compressed_sibling && accepts_encoding(request, "br"sv)) {
+        content_path = compressed_path;
+        encoding = "br"sv;
+    }
+
+    auto stream = TRY(Core::File::open(content_path.bytes_as_string_view(), Core::File::OpenMode::Read));
 
     auto const info = ContentInfo {
         .type = TRY(String::from_utf8(Core::guess_mime_type_based_on_filename(real_path.bytes_as_string_view()))),
-        .length = static_cast<u64>(TRY(FileSystem::size_from_stat(real_path.bytes_as_string_view())))
+        .length = static_cast<u64>(TRY(FileSystem::size_from_stat(content_path.bytes_as_string_view()))),
+        .encoding = encoding,
+        .varies_by_encoding = has_compressed_sibling,
     };
     TRY(send_response(*stream, request, move(info)));
     return true;
@@ -189,6 +221,10 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
     else
         TRY(builder.try_appendff("Content-Type: {}\r\n", content_info.type));
     TRY(builder.try_appendff("Content-Length: {}\r\n", content_info.length));
+    if (content_info.encoding.has_value())
+        TRY(builder.try_appendff("Content-Encoding: {}\r\n", *content_info.encoding));
+    if (content_info.varies_by_encoding)
+        TRY(builder.try_append("Vary: Accept-Encoding\r\n"sv));
     TRY(builder.try_append("\r\n"sv));
 
     auto builder_contents = TRY(builder.to_byte_buffer());
@@ -29,6 +29,8 @@ private:
     struct ContentInfo {
         String type;
         u64 length {};
+        Optional<StringView> encoding {};
+        bool varies_by_encoding { false };
     };
 
     ErrorOr<void, WrappedError> on_ready_to_read();
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCompress/Brotli.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <unistd.h>
+
+static ErrorOr<void> decompress_file(StringView input_filename, NonnullOwnPtr<Core::File> output_stream)
+{
+    auto input_file = TRY(Core::File::open(input_filename, Core::File::OpenMode::Read));
+    auto input_stream = TRY(Core::InputBufferedFile::create(move(input_file)));
+    auto brotli_stream = Compress::BrotliDecompressionStream { MaybeOwned<Stream>(*input_stream) };
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(64 * KiB));
+    while (!brotli_stream.is_eof()) {
+        auto span = TRY(brotli_stream.read_some(buffer));
+        TRY(output_stream->write_until_depleted(span));
+    }
+    return {};
+}
+
+static ErrorOr<ByteBuffer> compress_file(StringView input_filename, u8 quality)
+{
+    // Mapping a zero-length file fails, but there's nothing to read anyway.
+    if (TRY(Core::System::stat(input_filename)).st_size == 0)
+        return Compress::BrotliCompressor::compress_all({}, quality);
+
+    auto file = TRY(Core::MappedFile::map(input_filename));
+    return Compress::BrotliCompressor::compress_all(file->bytes(), quality);
+}
+
+// Writes a compressed `.br` sibling next to every file in the given directory tree, for web servers to send to clients
+// that accept Brotli. Siblings that are already up to date are left alone, and files that don't get any smaller don't
+// get one at all.
+static ErrorOr<void> precompress_path(ByteString const& path, u8 quality)
+{
+    auto stat = TRY(Core::System::stat(path));
+    if (S_ISDIR(stat.st_mode)) {
+        Core::DirIterator iterator(path, Core::DirIterator::Flags::SkipParentAndBaseDir);
+        while (iterator.has_next()) {
+            if (auto result = precompress_path(iterator.next_full_path(), quality); result.is_error())
+                warnln("{}", result.error());
+        }
+        return {};
+    }
+
+    if (!S_ISREG(stat.st_mode) || path.ends_with(".br"sv))
+        return {};
+
+    auto output_filename = ByteString::formatted("{}.br", path);
+    if (auto output_stat = Core::System::stat(output_filename); !output_stat.is_error() && output_stat.value().st_mtime >= stat.st_mtime)
+        return {};
+
+    auto compressed = TRY(compress_file(path, quality));
+    if (compressed.size() >= static_cast<size_t>(stat.st_size)) {
+        // A sibling for an older version of the file would be served instead of the current one.
+        if (!Core::System::access(output_filename, F_OK).is_error())
+            TRY(Core::System::unlink(output_filename));
+        return {};
+    }
+
+    auto output_stream = TRY(Core::File::open(output_filename, Core::File::OpenMode::Write));
+    TRY(output_stream->write_until_depleted(compressed));
+    outln("{}: {} -> {} bytes", path, stat.st_size, compressed.size());
+    return {};
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    Vector<StringView> filenames;
+    bool keep_input_files { false };
+    bool write_to_stdout { false };
+    bool decompress { false };
+    bool precompress { false };
+    u8 quality { Compress::BrotliCompressor::default_quality };
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
+    args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
+    args_parser.add_option(decompress, "Decompress", "decompress", 'd');
+    args_parser.add_option(quality, "Compression quality, from 0 (fastest) to 11 (smallest)", "quality", 'q', "level");
+    args_parser.add_option(precompress, "Write a compressed .br file next to every file in the given directories, keeping the originals", "precompress", 0);
+    args_parser.add_positional_argument(filenames, "Files", "FILES");
+    args_parser.parse(arguments);
+
+    if (quality > Compress::BrotliCompressor::max_quality) {
+        warnln("quality must be between {} and {}", Compress::BrotliCompressor::min_quality, Compress::BrotliCompressor::max_quality);
+        return 1;
+    }
+
+    if (precompress) {
+        for (auto const& path : filenames)
+            TRY(precompress_path(path, quality));
+        return 0;
+    }
+
+    if (write_to_stdout)
+        keep_input_files = true;
+
+    for (auto const& input_filename : filenames) {
+        ByteString output_filename;
+        if (decompress) {
+            if (!input_filename.ends_with(".br"sv)) {
+                warnln("unknown suffix for: {}, skipping", input_filename);
+                continue;
+            }
+            output_filename = input_filename.substring_view(0, input_filename.length() - ".br"sv.length());
+        } else {
+            output_filename = ByteString::formatted("{}.br", input_filename);
+        }
+
+        auto output_stream = write_to_stdout ? TRY(Core::File::standard_output()) : TRY(Core::File::open(output_filename, Core::File::OpenMode::Write));
+
+        if (decompress)
+            TRY(decompress_file(input_filename, move(output_stream)));
+        else
+            TRY(output_stream->write_until_depleted(TRY(compress_file(input_filename, quality))));
+
+        if (!keep_input_files) {
+            TRY(Core::System::unlink(input_filename));
+        }
+    }
+
+    return 0;
+}
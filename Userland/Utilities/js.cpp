@@ -7,6 +7,7 @@
  */
 
 #include <AK/JsonValue.h>
+#include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/ConfigFile.h>
@@ -15,8 +16,11 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/Optimizer.h>
+#include <LibJS/BytecodeCache.h>
 #include <LibJS/Console.h>
 #include <LibJS/Contrib/Test262/GlobalObject.h>
+#include <LibJS/JIT/Compiler.h>
 #include <LibJS/Parser.h>
 #include <LibJS/Print.h>
 #include <LibJS/Runtime/ConsoleObject.h>
@@ -531,12 +535,18 @@ private:
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction map_fixed"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction map_fixed prot_exec"));
 
     bool gc_on_every_allocation = false;
     bool disable_syntax_highlight = false;
     bool disable_debug_printing = false;
     bool use_test262_global = false;
+    bool disable_jit = false;
+    bool print_jit_statistics = false;
+    bool disable_bytecode_optimizer = false;
+    bool print_bytecode_optimizer_statistics = false;
+    bool print_inline_cache_statistics = false;
+    bool use_bytecode_cache = false;
     StringView evaluate_script;
     Vector<StringView> script_paths;
 
@@ -553,17 +563,44 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(disable_debug_printing, "Disable debug output", "disable-debug-output", {});
     args_parser.add_option(evaluate_script, "Evaluate argument as a script", "evaluate", 'c', "script");
     args_parser.add_option(use_test262_global, "Use test262 global ($262)", "use-test262-global", {});
+    args_parser.add_option(disable_jit, "Disable the JIT compiler", "disable-jit", {});
+    args_parser.add_option(print_jit_statistics, "Print JIT statistics on exit", "jit-statistics", {});
+    args_parser.add_option(disable_bytecode_optimizer, "Disable the bytecode optimizer", "disable-bytecode-optimizer", {});
+    args_parser.add_option(print_bytecode_optimizer_statistics, "Print bytecode optimizer statistics on exit", "bytecode-optimizer-statistics", {});
+    args_parser.add_option(print_inline_cache_statistics, "Print inline cache statistics on exit", "inline-cache-statistics", {});
+    args_parser.add_option(use_bytecode_cache, "Keep the bytecode of scripts in an on-disk cache", "bytecode-cache", {});
     args_parser.add_positional_argument(script_paths, "Path to script files", "scripts", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
     bool syntax_highlight = !disable_syntax_highlight;
 
+    if (disable_jit)
+        JS::JIT::Compiler::set_enabled(false);
+    ScopeGuard dump_jit_statistics = [&] {
+        if (print_jit_statistics)
+            JS::JIT::Compiler::dump_statistics();
+    };
+    if (disable_bytecode_optimizer)
+        JS::Bytecode::Optimizer::set_enabled(false);
+    ScopeGuard dump_bytecode_optimizer_statistics = [&] {
+        if (print_bytecode_optimizer_statistics)
+            JS::Bytecode::Optimizer::dump_statistics();
+    };
+
+    if (use_bytecode_cache)
+        TRY(JS::BytecodeCache::enable(ByteString::formatted("{}/js/bytecode-cache", Core::StandardPaths::data_directory())));
+
     AK::set_debug_enabled(!disable_debug_printing);
     s_history_path = TRY(String::formatted("{}/.js-history", Core::StandardPaths::home_directory()));
 
     g_vm = TRY(JS::VM::create());
     g_vm->set_dynamic_imports_allowed(true);
 
+    ScopeGuard dump_inline_cache_statistics = [&] {
+        if (print_inline_cache_statistics)
+            g_vm->bytecode_interpreter().dump_property_lookup_cache_statistics();
+    };
+
     if (!disable_debug_printing) {
         // NOTE: These will print out both warnings when using something like Promise.reject().catch(...) -
         // which is, as far as I can tell, correct - a promise is created, rejected without handler, and a
@@ -4,19 +4,23 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <AK/Assertions.h>
 #include <AK/ByteString.h>
 #include <AK/HashMap.h>
 #include <AK/LexicalPath.h>
 #include <AK/Span.h>
 #include <AK/Vector.h>
+#include <LibArchive/TarIndex.h>
 #include <LibArchive/TarStream.h>
 #include <LibCompress/Gzip.h>
 #include <LibCompress/Lzma.h>
 #include <LibCompress/Xz.h>
+#include <LibCompress/Zstd.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/Directory.h>
+#include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibFileSystem/FileSystem.h>
 #include <LibMain/Main.h>
@@ -36,9 +40,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool gzip = false;
     bool lzma = false;
     bool xz = false;
+    bool zstd = false;
     bool no_auto_compress = false;
     StringView archive_file;
     bool dereference = false;
+    size_t thread_count = 1;
+    u8 preset = Compress::LzmaCompressorOptions::default_preset;
+    StringView index_file;
     StringView directory;
     Vector<ByteString> paths;
 
@@ -50,10 +58,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(gzip, "Compress or decompress file using gzip", "gzip", 'z');
     args_parser.add_option(lzma, "Compress or decompress file using lzma", "lzma");
     args_parser.add_option(xz, "Compress or decompress file using xz", "xz", 'J');
+    args_parser.add_option(zstd, "Compress or decompress file using zstd", "zstd");
     args_parser.add_option(no_auto_compress, "Do not use the archive suffix to select the compression algorithm", "no-auto-compress");
     args_parser.add_option(directory, "Directory to extract to/create from", "directory", 'C', "DIRECTORY");
     args_parser.add_option(archive_file, "Archive file", "file", 'f', "FILE");
     args_parser.add_option(dereference, "Follow symlinks", "dereference", 'h');
+    args_parser.add_option(thread_count, "Number of threads to compress or decompress xz archives with", "jobs", 0, "count");
+    args_parser.add_option(preset, "Compression preset for lzma and xz archives, from 0 (fastest) to 9 (smallest)", "preset", 0, "level");
+    args_parser.add_option(index_file, "Index of member offsets to write when creating, or to find members with when listing or extracting", "index", 0, "FILE");
     args_parser.add_positional_argument(paths, "Paths", "PATHS", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -62,6 +74,11 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 1;
     }
 
+    if (preset > Compress::LzmaCompressorOptions::max_preset) {
+        warnln("preset must be between {} and {}", Compress::LzmaCompressorOptions::min_preset, Compress::LzmaCompressorOptions::max_preset);
+        return 1;
+    }
+
     if (!no_auto_compress && !archive_file.is_empty()) {
         if (archive_file.ends_with(".gz"sv) || archive_file.ends_with(".tgz"sv))
             gzip = true;
@@ -69,23 +86,64 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             lzma = true;
         if (archive_file.ends_with(".xz"sv))
             xz = true;
+        if (archive_file.ends_with(".zst"sv) || archive_file.ends_with(".tzst"sv))
+            zstd = true;
     }
 
+    // Selects members by the paths given on the command line, including everything below selected directories.
+    auto is_selected = [&](StringView member_path) {
+        if (paths.is_empty())
+            return true;
+        return any_of(paths, [&](auto const& selected_path) {
+            auto canonicalized_path = LexicalPath::canonicalized_path(selected_path);
+            return member_path == canonicalized_path || (member_path.starts_with(canonicalized_path) && member_path[canonicalized_path.length()] == '/');
+        });
+    };
+
     if (list || extract) {
+        Optional<Archive::TarIndex> index;
+        if (!index_file.is_empty()) {
+            auto file = TRY(Core::File::open(index_file, Core::File::OpenMode::Read));
+            index = TRY(Archive::TarIndex::read_from_stream(*file));
+        }
+
+        // With an index, listing doesn't have to look at the archive at all.
+        if (list && index.has_value()) {
+            for (auto const& entry : index->entries()) {
+                if (is_selected(entry.path))
+                    outln("{}", entry.path);
+            }
+            return 0;
+        }
+
+        // Blocks of an xz archive can only be located up front when the whole file is available, so only regular files
+        // are decompressed in parallel or seekable. The mapping has to outlive the decompressor, which borrows its bytes.
+        OwnPtr<Core::MappedFile> mapped_archive;
+        if (xz && (thread_count > 1 || index.has_value()) && !archive_file.is_empty() && archive_file != "-"sv) {
+            auto stat = TRY(Core::System::stat(archive_file));
+            if (S_ISREG(stat.st_mode) && stat.st_size > 0)
+                mapped_archive = TRY(Core::MappedFile::map(archive_file));
+        }
+
+        NonnullOwnPtr<Stream> input_stream = mapped_archive
+            ? NonnullOwnPtr<Stream> { TRY(Compress::XzParallelDecompressor::create(mapped_archive->bytes(), thread_count)) }
+            : NonnullOwnPtr<Stream> { TRY(Core::InputBufferedFile::create(TRY(Core::File::open_file_or_standard_stream(archive_file, Core::File::OpenMode::Read)))) };
+
         if (!directory.is_empty())
             TRY(Core::System::chdir(directory));
 
-        NonnullOwnPtr<Stream> input_stream = TRY(Core::InputBufferedFile::create(TRY(Core::File::open_file_or_standard_stream(archive_file, Core::File::OpenMode::Read))));
-
         if (gzip)
             input_stream = make<Compress::GzipDecompressor>(move(input_stream));
 
         if (lzma)
             input_stream = TRY(Compress::LzmaDecompressor::create_from_container(move(input_stream)));
 
-        if (xz)
+        if (xz && !mapped_archive)
             input_stream = TRY(Compress::XzDecompressor::create(move(input_stream)));
 
+        if (zstd)
+            input_stream = TRY(Compress::ZstdDecompressor::create(move(input_stream)));
+
         auto tar_stream = TRY(Archive::TarInputStream::construct(move(input_stream)));
 
         HashMap<ByteString, ByteString> global_overrides;
@@ -105,115 +163,143 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             return {};
         };
 
-        while (!tar_stream->finished()) {
-            Archive::TarFileHeader const& header = tar_stream->header();
+        // Processes members until the end of the archive, or only the one at the current position if `single_member` is set.
+        auto process_members = [&](bool single_member) -> ErrorOr<void> {
+            while (!tar_stream->finished()) {
+                Archive::TarFileHeader const& header = tar_stream->header();
+
+                // Handle meta-entries earlier to avoid consuming the file content stream.
+                if (header.content_is_like_extended_header()) {
+                    switch (header.type_flag()) {
+                    case Archive::TarFileType::GlobalExtendedHeader: {
+                        TRY(tar_stream->for_each_extended_header([&](StringView key, StringView value) {
+                            if (value.length() == 0)
+                                global_overrides.remove(key);
+                            else
+                                global_overrides.set(key, value);
+                        }));
+                        break;
+                    }
+                    case Archive::TarFileType::ExtendedHeader: {
+                        TRY(tar_stream->for_each_extended_header([&](StringView key, StringView value) {
+                            local_overrides.set(key, value);
+                        }));
+                        break;
+                    }
+                    default:
+                        warnln("Unknown extended header type '{}' of {}", (char)header.type_flag(), header.filename());
+                        VERIFY_NOT_REACHED();
+                    }
 
-            // Handle meta-entries earlier to avoid consuming the file content stream.
-            if (header.content_is_like_extended_header()) {
-                switch (header.type_flag()) {
-                case Archive::TarFileType::GlobalExtendedHeader: {
-                    TRY(tar_stream->for_each_extended_header([&](StringView key, StringView value) {
-                        if (value.length() == 0)
-                            global_overrides.remove(key);
-                        else
-                            global_overrides.set(key, value);
-                    }));
-                    break;
-                }
-                case Archive::TarFileType::ExtendedHeader: {
-                    TRY(tar_stream->for_each_extended_header([&](StringView key, StringView value) {
-                        local_overrides.set(key, value);
-                    }));
-                    break;
-                }
-                default:
-                    warnln("Unknown extended header type '{}' of {}", (char)header.type_flag(), header.filename());
-                    VERIFY_NOT_REACHED();
+                    TRY(tar_stream->advance());
+                    continue;
                 }
 
-                TRY(tar_stream->advance());
-                continue;
-            }
+                Archive::TarFileStream file_stream = tar_stream->file_contents();
+
+                // Handle other header types that don't just have an effect on extraction.
+                switch (header.type_flag()) {
+                case Archive::TarFileType::LongName: {
+                    StringBuilder long_name;
 
-            Archive::TarFileStream file_stream = tar_stream->file_contents();
+                    Array<u8, buffer_size> buffer;
 
-            // Handle other header types that don't just have an effect on extraction.
-            switch (header.type_flag()) {
-            case Archive::TarFileType::LongName: {
-                StringBuilder long_name;
+                    while (!file_stream.is_eof()) {
+                        auto slice = TRY(file_stream.read_some(buffer));
+                        long_name.append(reinterpret_cast<char*>(slice.data()), slice.size());
+                    }
 
-                Array<u8, buffer_size> buffer;
+                    local_overrides.set("path", long_name.to_byte_string());
+                    TRY(tar_stream->advance());
+                    continue;
+                }
+                default:
+                    // None of the relevant headers, so continue as normal.
+                    break;
+                }
 
-                while (!file_stream.is_eof()) {
-                    auto slice = TRY(file_stream.read_some(buffer));
-                    long_name.append(reinterpret_cast<char*>(slice.data()), slice.size());
+                LexicalPath path = LexicalPath(header.filename());
+                if (!header.prefix().is_empty())
+                    path = path.prepend(header.prefix());
+                ByteString filename = get_override("path"sv).value_or(path.string());
+
+                if (!is_selected(filename)) {
+                    local_overrides.clear();
+                    if (single_member)
+                        return {};
+                    TRY(tar_stream->advance());
+                    continue;
                 }
 
-                local_overrides.set("path", long_name.to_byte_string());
-                TRY(tar_stream->advance());
-                continue;
-            }
-            default:
-                // None of the relevant headers, so continue as normal.
-                break;
-            }
+                if (list || verbose)
+                    outln("{}", filename);
 
-            LexicalPath path = LexicalPath(header.filename());
-            if (!header.prefix().is_empty())
-                path = path.prepend(header.prefix());
-            ByteString filename = get_override("path"sv).value_or(path.string());
+                if (extract) {
+                    auto absolute_path = TRY(FileSystem::absolute_path(filename));
+                    auto parent_path = LexicalPath(absolute_path).parent();
+                    auto header_mode = TRY(header.mode());
 
-            if (list || verbose)
-                outln("{}", filename);
+                    switch (header.type_flag()) {
+                    case Archive::TarFileType::NormalFile:
+                    case Archive::TarFileType::AlternateNormalFile: {
+                        MUST(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
 
-            if (extract) {
-                auto absolute_path = TRY(FileSystem::absolute_path(filename));
-                auto parent_path = LexicalPath(absolute_path).parent();
-                auto header_mode = TRY(header.mode());
+                        int fd = TRY(Core::System::open(absolute_path, O_CREAT | O_WRONLY, header_mode));
 
-                switch (header.type_flag()) {
-                case Archive::TarFileType::NormalFile:
-                case Archive::TarFileType::AlternateNormalFile: {
-                    MUST(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
+                        Array<u8, buffer_size> buffer;
+                        while (!file_stream.is_eof()) {
+                            auto slice = TRY(file_stream.read_some(buffer));
+                            TRY(Core::System::write(fd, slice));
+                        }
 
-                    int fd = TRY(Core::System::open(absolute_path, O_CREAT | O_WRONLY, header_mode));
+                        TRY(Core::System::close(fd));
+                        break;
+                    }
+                    case Archive::TarFileType::SymLink: {
+                        MUST(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
 
-                    Array<u8, buffer_size> buffer;
-                    while (!file_stream.is_eof()) {
-                        auto slice = TRY(file_stream.read_some(buffer));
-                        TRY(Core::System::write(fd, slice));
+                        TRY(Core::System::symlink(header.link_name(), absolute_path));
+                        break;
                     }
+                    case Archive::TarFileType::Directory: {
+                        MUST(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
 
-                    TRY(Core::System::close(fd));
-                    break;
+                        auto result_or_error = Core::System::mkdir(absolute_path, header_mode);
+                        if (result_or_error.is_error() && result_or_error.error().code() != EEXIST)
+                            return result_or_error.release_error();
+                        break;
+                    }
+                    default:
+                        // FIXME: Implement other file types
+                        warnln("file type '{}' of {} is not yet supported", (char)header.type_flag(), header.filename());
+                        VERIFY_NOT_REACHED();
+                    }
                 }
-                case Archive::TarFileType::SymLink: {
-                    MUST(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
 
-                    TRY(Core::System::symlink(header.link_name(), absolute_path));
-                    break;
-                }
-                case Archive::TarFileType::Directory: {
-                    MUST(Core::Directory::create(parent_path, Core::Directory::CreateDirectories::Yes));
+                // Non-global headers should be cleared after every file.
+                local_overrides.clear();
 
-                    auto result_or_error = Core::System::mkdir(absolute_path, header_mode);
-                    if (result_or_error.is_error() && result_or_error.error().code() != EEXIST)
-                        return result_or_error.release_error();
-                    break;
-                }
-                default:
-                    // FIXME: Implement other file types
-                    warnln("file type '{}' of {} is not yet supported", (char)header.type_flag(), header.filename());
-                    VERIFY_NOT_REACHED();
-                }
-            }
+                if (single_member)
+                    return {};
 
-            // Non-global headers should be cleared after every file.
-            local_overrides.clear();
+                TRY(tar_stream->advance());
+            }
+            return {};
+        };
 
-            TRY(tar_stream->advance());
+        // Seek directly to the selected members if we know where they are, instead of reading everything in front of them.
+        // Note that global extended headers are only picked up if they come right before a selected member.
+        if (index.has_value() && tar_stream->is_seekable()) {
+            for (auto const& entry : index->entries()) {
+                if (!is_selected(entry.path))
+                    continue;
+                TRY(tar_stream->seek_to_header(entry.header_offset));
+                TRY(process_members(true));
+            }
+            return 0;
         }
 
+        TRY(process_members(false));
         return 0;
     }
 
@@ -228,6 +314,11 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         if (!archive_file.is_empty())
             output_stream = TRY(Core::File::open(archive_file, Core::File::OpenMode::Write));
 
+        OwnPtr<Core::File> index_stream;
+        if (!index_file.is_empty())
+            index_stream = TRY(Core::File::open(index_file, Core::File::OpenMode::Write));
+        Archive::TarIndex index;
+
         if (!directory.is_empty())
             TRY(Core::System::chdir(directory));
 
@@ -235,13 +326,30 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             output_stream = TRY(try_make<Compress::GzipCompressor>(move(output_stream)));
 
         if (lzma)
-            output_stream = TRY(Compress::LzmaCompressor::create_container(move(output_stream), {}));
+            output_stream = TRY(Compress::LzmaCompressor::create_container(move(output_stream), Compress::LzmaCompressorOptions::for_preset(preset)));
+
+        if (xz) {
+            Compress::XzCompressorOptions options;
+            options.thread_count = thread_count;
+            options.preset = preset;
+            // Members can only be read individually if the block they are in can be decompressed on its own, so trade a bit
+            // of compression for smaller blocks when writing an index.
+            if (!index_file.is_empty())
+                options.block_size = 1 * MiB;
+            output_stream = TRY(Compress::XzCompressor::create(move(output_stream), options));
+        }
 
-        if (xz)
-            TODO();
+        if (zstd)
+            output_stream = TRY(Compress::ZstdCompressor::construct(move(output_stream)));
 
         Archive::TarOutputStream tar_stream(move(output_stream));
 
+        auto add_to_index = [&](ByteString const& path) -> ErrorOr<void> {
+            if (index_stream)
+                TRY(index.add(path, tar_stream.offset()));
+            return {};
+        };
+
         auto add_file = [&](ByteString path) -> ErrorOr<void> {
             auto file_or_error = Core::File::open(path, Core::File::OpenMode::Read);
             if (file_or_error.is_error()) {
@@ -254,6 +362,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             auto canonicalized_path = LexicalPath::canonicalized_path(path);
             // FIXME: We should stream instead of reading the entire file in one go, but TarOutputStream does not have any interface to do so.
             auto file_content = TRY(file->read_until_eof());
+            TRY(add_to_index(canonicalized_path));
             TRY(tar_stream.add_file(canonicalized_path, statbuf.st_mode, file_content));
             if (verbose)
                 outln("{}", canonicalized_path);
@@ -265,6 +374,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             auto statbuf = TRY(Core::System::lstat(path));
 
             auto canonicalized_path = LexicalPath::canonicalized_path(path);
+            TRY(add_to_index(canonicalized_path));
             TRY(tar_stream.add_link(canonicalized_path, statbuf.st_mode, TRY(Core::System::readlink(path))));
             if (verbose)
                 outln("{}", canonicalized_path);
@@ -276,6 +386,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             auto statbuf = TRY(Core::System::lstat(path));
 
             auto canonicalized_path = LexicalPath::canonicalized_path(path);
+            TRY(add_to_index(canonicalized_path));
             TRY(tar_stream.add_directory(canonicalized_path, statbuf.st_mode));
             if (verbose)
                 outln("{}", canonicalized_path);
@@ -305,6 +416,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
         TRY(tar_stream.finish());
 
+        if (index_stream)
+            TRY(index.write_to_stream(*index_stream));
+
         return 0;
     }
 
@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
 #include <AK/Assertions.h>
+#include <AK/Atomic.h>
 #include <AK/DOSPackedTime.h>
 #include <AK/NumberFormat.h>
 #include <AK/StringUtils.h>
@@ -18,6 +20,7 @@
 #include <LibCore/System.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibFileSystem/FileSystem.h>
+#include <LibThreading/Thread.h>
 #include <sys/stat.h>
 
 static ErrorOr<void> adjust_modification_time(Archive::ZipMember const& zip_member)
@@ -32,18 +35,9 @@ static ErrorOr<void> adjust_modification_time(Archive::ZipMember const& zip_memb
     return Core::System::utime(zip_member.name, buf);
 }
 
-static bool unpack_zip_member(Archive::ZipMember zip_member, bool quiet)
+// Writes out the contents of a file member, whose parent directory has to exist already.
+static bool unpack_zip_file(Archive::ZipMember const& zip_member)
 {
-    if (zip_member.is_directory) {
-        if (auto maybe_error = Core::System::mkdir(zip_member.name, 0755); maybe_error.is_error()) {
-            warnln("Failed to create directory '{}': {}", zip_member.name, maybe_error.error());
-            return false;
-        }
-        if (!quiet)
-            outln(" extracting: {}", zip_member.name);
-        return true;
-    }
-    MUST(Core::Directory::create(LexicalPath(zip_member.name.to_byte_string()).parent(), Core::Directory::CreateDirectories::Yes));
     auto new_file_or_error = Core::File::open(zip_member.name.to_byte_string(), Core::File::OpenMode::Write);
     if (new_file_or_error.is_error()) {
         warnln("Can't write file {}: {}", zip_member.name, new_file_or_error.release_error());
@@ -51,9 +45,6 @@ static bool unpack_zip_member(Archive::ZipMember zip_member, bool quiet)
     }
     auto new_file = new_file_or_error.release_value();
 
-    if (!quiet)
-        outln(" extracting: {}", zip_member.name);
-
     Crypto::Checksum::CRC32 checksum;
     switch (zip_member.compression_method) {
     case Archive::ZipCompressionMethod::Store: {
@@ -101,6 +92,69 @@ static bool unpack_zip_member(Archive::ZipMember zip_member, bool quiet)
     return true;
 }
 
+static bool unpack_zip_member(Archive::ZipMember const& zip_member, bool quiet)
+{
+    if (zip_member.is_directory) {
+        if (auto maybe_error = Core::System::mkdir(zip_member.name, 0755); maybe_error.is_error()) {
+            warnln("Failed to create directory '{}': {}", zip_member.name, maybe_error.error());
+            return false;
+        }
+        if (!quiet)
+            outln(" extracting: {}", zip_member.name);
+        return true;
+    }
+    MUST(Core::Directory::create(LexicalPath(zip_member.name.to_byte_string()).parent(), Core::Directory::CreateDirectories::Yes));
+
+    if (!quiet)
+        outln(" extracting: {}", zip_member.name);
+
+    return unpack_zip_file(zip_member);
+}
+
+// Directories are created up front, in archive order, after which the file members are inflated and written out
+// concurrently. Archives with many small members spend most of their time on per-file overhead, which this overlaps.
+static bool unpack_zip_members_in_parallel(Vector<Archive::ZipMember> const& zip_members, size_t thread_count, bool quiet)
+{
+    Vector<Archive::ZipMember const&> file_members;
+    for (auto const& zip_member : zip_members) {
+        if (zip_member.is_directory) {
+            if (!unpack_zip_member(zip_member, quiet))
+                return false;
+            continue;
+        }
+        MUST(Core::Directory::create(LexicalPath(zip_member.name.to_byte_string()).parent(), Core::Directory::CreateDirectories::Yes));
+        if (!quiet)
+            outln(" extracting: {}", zip_member.name);
+        file_members.append(zip_member);
+    }
+
+    Atomic<size_t> next_member_index { 0 };
+    Atomic<bool> success { true };
+    auto unpack_remaining_members = [&]() -> intptr_t {
+        for (auto index = next_member_index.fetch_add(1); index < file_members.size(); index = next_member_index.fetch_add(1)) {
+            if (!unpack_zip_file(file_members[index]))
+                success = false;
+        }
+        return 0;
+    };
+
+    // The main thread takes part in the work as well, and simply does more of it if we fail to create a thread.
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    for (size_t i = 1; i < min(thread_count, file_members.size()); ++i) {
+        auto thread_or_error = Threading::Thread::try_create([&] { return unpack_remaining_members(); }, "unzip"sv);
+        if (thread_or_error.is_error())
+            break;
+        threads.append(thread_or_error.release_value());
+        threads.last()->start();
+    }
+
+    unpack_remaining_members();
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    return success;
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     StringView zip_file_path;
@@ -108,11 +162,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool list_files { false };
     StringView output_directory_path;
     Vector<StringView> file_filters;
+    size_t thread_count { 1 };
 
     Core::ArgsParser args_parser;
     args_parser.add_option(list_files, "Only list files in the archive", "list", 'l');
     args_parser.add_option(output_directory_path, "Directory to receive the archive content", "output-directory", 'd', "path");
     args_parser.add_option(quiet, "Be less verbose", "quiet", 'q');
+    args_parser.add_option(thread_count, "Number of threads to extract files with", "jobs", 'j', "count");
     args_parser.add_positional_argument(zip_file_path, "File to unzip", "path", Core::ArgsParser::Required::Yes);
     args_parser.add_positional_argument(file_filters, "Files or filters in the archive to extract", "files", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
@@ -161,32 +217,52 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     }
 
     Vector<Archive::ZipMember> zip_directories;
+    Vector<Archive::ZipMember> zip_members_to_unpack;
+
+    auto keep_member = [&](Archive::ZipMember const& zip_member) {
+        if (thread_count > 1)
+            zip_members_to_unpack.append(zip_member);
+        else if (!unpack_zip_member(zip_member, quiet))
+            return IterationDecision::Break;
+        if (zip_member.is_directory)
+            zip_directories.append(zip_member);
+        return IterationDecision::Continue;
+    };
 
-    auto success = TRY(zip_file->for_each_member([&](auto zip_member) {
-        bool keep_file = false;
+    // Filters without wildcards name a member directly, so they can be looked up instead of matched against every member.
+    auto is_plain_path = [](StringView filter) {
+        return !filter.contains('*') && !filter.contains('?') && !filter.contains('_');
+    };
+
+    bool success = true;
+    if (!file_filters.is_empty() && all_of(file_filters, is_plain_path)) {
+        for (auto& filter : file_filters) {
+            auto zip_member = TRY(zip_file->find_member(filter));
+            if (!zip_member.has_value())
+                continue;
+            if (keep_member(*zip_member) == IterationDecision::Break) {
+                success = false;
+                break;
+            }
+        }
+    } else {
+        success = TRY(zip_file->for_each_member([&](auto zip_member) {
+            if (file_filters.is_empty())
+                return keep_member(zip_member);
 
-        if (!file_filters.is_empty()) {
             for (auto& filter : file_filters) {
                 // Convert underscore wildcards (usual unzip convention) to question marks (as used by StringUtils)
                 auto string_filter = filter.replace("_"sv, "?"sv, ReplaceMode::All);
-                if (zip_member.name.bytes_as_string_view().matches(string_filter, CaseSensitivity::CaseSensitive)) {
-                    keep_file = true;
-                    break;
-                }
+                if (zip_member.name.bytes_as_string_view().matches(string_filter, CaseSensitivity::CaseSensitive))
+                    return keep_member(zip_member);
             }
-        } else {
-            keep_file = true;
-        }
 
-        if (keep_file) {
-            if (!unpack_zip_member(zip_member, quiet))
-                return IterationDecision::Break;
-            if (zip_member.is_directory)
-                zip_directories.append(zip_member);
-        }
+            return IterationDecision::Continue;
+        }));
+    }
 
-        return IterationDecision::Continue;
-    }));
+    if (success && thread_count > 1)
+        success = unpack_zip_members_in_parallel(zip_members_to_unpack, thread_count, quiet);
 
     if (!success) {
         return 1;
@@ -8,6 +8,7 @@
 #include <AK/GenericLexer.h>
 #include <AK/Hex.h>
 #include <AK/MemoryStream.h>
+#include <AK/ScopeGuard.h>
 #include <AK/StackInfo.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
@@ -17,6 +18,7 @@
 #include <LibMain/Main.h>
 #include <LibWasm/AbstractMachine/AbstractMachine.h>
 #include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
+#include <LibWasm/JIT/Compiler.h>
 #include <LibWasm/Printer/Printer.h>
 #include <LibWasm/Types.h>
 #include <LibWasm/Wasi.h>
@@ -491,6 +493,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool export_all_imports = false;
     bool shell_mode = false;
     bool wasi = false;
+    bool disable_jit = false;
+    bool dump_jit_statistics = false;
     ByteString exported_function_to_execute;
     Vector<Wasm::Value> values_to_push;
     Vector<ByteString> modules_to_link_in;
@@ -506,6 +510,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     parser.add_option(export_all_imports, "Export noop functions corresponding to imports", "export-noop");
     parser.add_option(shell_mode, "Launch a REPL in the module's context (implies -i)", "shell", 's');
     parser.add_option(wasi, "Enable WASI", "wasi", 'w');
+    parser.add_option(disable_jit, "Only interpret functions, don't compile them to machine code", "no-jit");
+    parser.add_option(dump_jit_statistics, "Print statistics about compiled code on exit", "jit-statistics");
     parser.add_option(Core::ArgsParser::Option {
         .argument_mode = Core::ArgsParser::OptionArgumentMode::Required,
         .help_string = "Directory mappings to expose via WASI",
@@ -558,6 +564,15 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         attempt_instantiate = true;
     }
 
+    // The debugger steps through instructions, which machine code doesn't have.
+    if (disable_jit || debug)
+        Wasm::JIT::Compiler::set_enabled(false);
+
+    ScopeGuard dump_statistics = [&] {
+        if (dump_jit_statistics)
+            Wasm::JIT::Compiler::dump_statistics();
+    };
+
     if (!shell_mode && debug && exported_function_to_execute.is_empty()) {
         warnln("Debug what? (pass -e fn)");
         return 1;
@@ -7,23 +7,40 @@
 #include <LibCompress/Xz.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <sys/stat.h>
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("rpath stdio"));
+    TRY(Core::System::pledge("rpath stdio thread"));
 
     StringView filename;
+    size_t thread_count { 1 };
 
     Core::ArgsParser args_parser;
     args_parser.set_general_help("Decompress and print an XZ archive");
+    args_parser.add_option(thread_count, "Number of threads to decompress with", "jobs", 'j', "count");
     args_parser.add_positional_argument(filename, "File to decompress", "file");
     args_parser.parse(arguments);
 
-    auto file = TRY(Core::File::open_file_or_standard_stream(filename, Core::File::OpenMode::Read));
-    auto buffered_file = TRY(Core::InputBufferedFile::create(move(file)));
-    auto stream = TRY(Compress::XzDecompressor::create(move(buffered_file)));
+    // Blocks can only be located up front when the whole file is available, so only regular files are decompressed in parallel.
+    OwnPtr<Core::MappedFile> mapped_file;
+    OwnPtr<Stream> stream;
+    if (thread_count > 1 && !filename.is_empty() && filename != "-"sv) {
+        auto stat = TRY(Core::System::stat(filename));
+        if (S_ISREG(stat.st_mode) && stat.st_size > 0) {
+            mapped_file = TRY(Core::MappedFile::map(filename));
+            stream = TRY(Compress::XzParallelDecompressor::create(mapped_file->bytes(), thread_count));
+        }
+    }
+
+    if (!stream) {
+        auto file = TRY(Core::File::open_file_or_standard_stream(filename, Core::File::OpenMode::Read));
+        auto buffered_file = TRY(Core::InputBufferedFile::create(move(file)));
+        stream = TRY(Compress::XzDecompressor::create(move(buffered_file)));
+    }
 
     // Arbitrarily chosen buffer size.
     Array<u8, 4096> buffer;
@@ -19,15 +19,17 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Vector<StringView> source_paths;
     bool recurse = false;
     bool force = false;
+    size_t thread_count = 1;
 
     Core::ArgsParser args_parser;
     args_parser.add_positional_argument(zip_path, "Zip file path", "zipfile", Core::ArgsParser::Required::Yes);
     args_parser.add_positional_argument(source_paths, "Input files to be archived", "files", Core::ArgsParser::Required::Yes);
     args_parser.add_option(recurse, "Travel the directory structure recursively", "recurse-paths", 'r');
     args_parser.add_option(force, "Overwrite existing zip file", "force", 'f');
+    args_parser.add_option(thread_count, "Number of threads to compress each file with", "jobs", 'j', "count");
     args_parser.parse(arguments);
 
-    TRY(Core::System::pledge("stdio rpath wpath cpath"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath thread"));
 
     auto cwd = TRY(Core::System::getcwd());
     TRY(Core::System::unveil(LexicalPath::absolute_path(cwd, zip_path), "wc"sv));
@@ -56,7 +58,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         auto stat = TRY(Core::System::fstat(file->fd()));
         auto date = Core::DateTime::from_timestamp(stat.st_mtim.tv_sec);
 
-        auto information = TRY(zip_stream.add_member_from_stream(canonicalized_path, *file, date));
+        auto information = TRY(zip_stream.add_member_from_stream(canonicalized_path, *file, date, thread_count));
         if (information.compression_ratio < 1.f) {
             outln("  adding: {} (deflated {}%)", canonicalized_path, (int)(information.compression_ratio * 100));
         } else {
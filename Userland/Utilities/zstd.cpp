@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCompress/Zstd.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <unistd.h>
+
+static ErrorOr<ByteBuffer> read_dictionary(StringView dictionary_filename)
+{
+    if (dictionary_filename.is_empty())
+        return ByteBuffer {};
+    auto file = TRY(Core::File::open(dictionary_filename, Core::File::OpenMode::Read));
+    return file->read_until_eof();
+}
+
+static ErrorOr<void> decompress_file(StringView input_filename, ReadonlyBytes dictionary, NonnullOwnPtr<Core::File> output_stream)
+{
+    auto input_file = TRY(Core::File::open(input_filename, Core::File::OpenMode::Read));
+    auto input_stream = TRY(Core::InputBufferedFile::create(move(input_file)));
+    auto zstd_stream = TRY(Compress::ZstdDecompressor::create(MaybeOwned<Stream>(*input_stream), dictionary));
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(64 * KiB));
+    while (!zstd_stream->is_eof()) {
+        auto span = TRY(zstd_stream->read_some(buffer));
+        TRY(output_stream->write_until_depleted(span));
+    }
+    return {};
+}
+
+static ErrorOr<ByteBuffer> compress_file(StringView input_filename, u8 level)
+{
+    // Mapping a zero-length file fails, but there's nothing to read anyway.
+    if (TRY(Core::System::stat(input_filename)).st_size == 0)
+        return Compress::ZstdCompressor::compress_all({}, level);
+
+    auto file = TRY(Core::MappedFile::map(input_filename));
+    return Compress::ZstdCompressor::compress_all(file->bytes(), level);
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    Vector<StringView> filenames;
+    bool keep_input_files { false };
+    bool write_to_stdout { false };
+    bool decompress { false };
+    u8 level { Compress::ZstdCompressor::default_level };
+    StringView dictionary_filename;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
+    args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
+    args_parser.add_option(decompress, "Decompress", "decompress", 'd');
+    args_parser.add_option(level, "Compression level, from 1 (fastest) to 19 (smallest)", "level", 'l', "level");
+    args_parser.add_option(dictionary_filename, "Decompress with the given dictionary", "dictionary", 'D', "file");
+    args_parser.add_positional_argument(filenames, "Files", "FILES");
+    args_parser.parse(arguments);
+
+    if (level < Compress::ZstdCompressor::min_level || level > Compress::ZstdCompressor::max_level) {
+        warnln("level must be between {} and {}", Compress::ZstdCompressor::min_level, Compress::ZstdCompressor::max_level);
+        return 1;
+    }
+
+    if (!dictionary_filename.is_empty() && !decompress) {
+        warnln("dictionaries are only supported for decompression");
+        return 1;
+    }
+
+    auto dictionary = TRY(read_dictionary(dictionary_filename));
+
+    if (write_to_stdout)
+        keep_input_files = true;
+
+    for (auto const& input_filename : filenames) {
+        ByteString output_filename;
+        if (decompress) {
+            if (!input_filename.ends_with(".zst"sv)) {
+                warnln("unknown suffix for: {}, skipping", input_filename);
+                continue;
+            }
+            output_filename = input_filename.substring_view(0, input_filename.length() - ".zst"sv.length());
+        } else {
+            output_filename = ByteString::formatted("{}.zst", input_filename);
+        }
+
+        auto output_stream = write_to_stdout ? TRY(Core::File::standard_output()) : TRY(Core::File::open(output_filename, Core::File::OpenMode::Write));
+
+        if (decompress)
+            TRY(decompress_file(input_filename, dictionary, move(output_stream)));
+        else
+            TRY(output_stream->write_until_depleted(TRY(compress_file(input_filename, level))));
+
+        if (!keep_input_files) {
+            TRY(Core::System::unlink(input_filename));
+        }
+    }
+
+    return 0;
+}